@@ -36,7 +36,7 @@ scene::Node::Ptr
 createPointLight(Vector3::Ptr color, Vector3::Ptr position, file::AssetLibrary::Ptr assets)
 {
 	auto pointLight = scene::Node::create("pointLight")
-		->addComponent(PointLight::create(10.f))
+		->addComponent(PointLight::create(10.f, 1.f, 6.f, 0.f, 0.f))
 		->addComponent(Transform::create(Matrix4x4::create()->appendTranslation(position)))
 		->addComponent(Surface::create(
 			assets->geometry("quad"),
@@ -66,7 +66,7 @@ int main(int argc, char** argv)
 		->diffuseColor(Vector4::create(1.f, 1.f, 1.f, 1.f));
 	auto lights				= scene::Node::create("lights");
 
-	std::cout << "Press [SPACE]\tto toogle normal mapping\nPress [A]\tto add random light\nPress [R]\tto remove random light" << std::endl;
+	std::cout << "Press [SPACE]\tto toogle normal mapping\nPress [A]\tto add random light\nPress [R]\tto remove random light\nPress [C]\tto toggle clustered lighting\nPress [D]\tto toggle the depth pre-pass" << std::endl;
 
 	sphereGeometry->computeTangentSpace(false);
 
@@ -121,7 +121,10 @@ int main(int argc, char** argv)
 		{
 			if (k->keyIsDown(input::Keyboard::KeyCode::a))
 			{
-				const auto MAX_NUM_LIGHTS = 40;
+				// clustered lighting does not recompile shaders when lights are added: add them 32 by 32
+				const auto clustered		= camera->hasComponent<ClusteredLighting>();
+				const auto MAX_NUM_LIGHTS	= clustered ? 256 : 40;
+				const auto numNewLights		= clustered ? 32 : 1;
 
 				if (lights->children().size() == MAX_NUM_LIGHTS)
 				{
@@ -129,19 +132,44 @@ int main(int argc, char** argv)
 					return;
 				}
 
-				auto r = rand() / (float)RAND_MAX;
-				auto theta = 2.0f * (float)PI *  r;
-				auto color = Color::hslaToRgba(r, 1.f, .5f);
-				auto pos = Vector3::create(
-					cosf(theta) * 5.f + rand() / ((float)RAND_MAX * 3.f),
-					2.5f + rand() / (float)RAND_MAX,
-					sinf(theta) * 5.f + rand() / ((float)RAND_MAX * 3.f)
-				);
-
-				lights->addChild(createPointLight(color, pos, sceneManager->assets()));
+				for (auto i = 0; i < numNewLights && lights->children().size() < MAX_NUM_LIGHTS; ++i)
+				{
+					auto r = rand() / (float)RAND_MAX;
+					auto theta = 2.0f * (float)PI *  r;
+					auto distance = clustered ? 5.f + rand() / (float)RAND_MAX * 15.f : 5.f;
+					auto color = Color::hslaToRgba(r, 1.f, .5f);
+					auto pos = Vector3::create(
+						cosf(theta) * distance + rand() / ((float)RAND_MAX * 3.f),
+						2.5f + rand() / (float)RAND_MAX,
+						sinf(theta) * distance + rand() / ((float)RAND_MAX * 3.f)
+					);
+
+					lights->addChild(createPointLight(color, pos, sceneManager->assets()));
+				}
 
 				std::cout << lights->children().size() << " lights" << std::endl;
 			}
+			if (k->keyIsDown(input::Keyboard::KeyCode::c))
+			{
+				if (camera->hasComponent<ClusteredLighting>())
+				{
+					camera->removeComponent(camera->component<ClusteredLighting>());
+
+					while (lights->children().size() > 40)
+						lights->removeChild(lights->children().back());
+				}
+				else
+					camera->addComponent(ClusteredLighting::create(sceneManager->assets()->context()));
+
+				std::cout << "clustered lighting " << (camera->hasComponent<ClusteredLighting>() ? "enabled" : "disabled") << std::endl;
+			}
+			if (k->keyIsDown(input::Keyboard::KeyCode::d))
+			{
+				auto renderer = camera->component<Renderer>();
+
+				renderer->depthPrePass(!renderer->depthPrePass());
+				std::cout << "depth pre-pass " << (renderer->depthPrePass() ? "enabled" : "disabled") << std::endl;
+			}
 			if (k->keyIsDown(input::Keyboard::KeyCode::r))
 			{
 				if (lights->children().size() == 0)
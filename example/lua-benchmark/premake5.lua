@@ -0,0 +1,16 @@
+PROJECT_NAME = path.getname(os.getcwd())
+
+minko.project.application("minko-example-" .. PROJECT_NAME)
+
+	language "c++"
+	kind "ConsoleApp"
+
+	files {
+		"src/**.cpp",
+		"src/**.hpp"
+	}
+	
+	includedirs { "src" }
+
+	-- plugins
+	minko.plugin.enable("lua")
@@ -0,0 +1,183 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/Minko.hpp"
+#include "minko/MinkoLua.hpp"
+
+using namespace minko;
+using namespace minko::component;
+
+static const unsigned int	NUM_NODES		= 10000;
+static const unsigned int	NUM_MATH_NODES	= 1000;
+static const unsigned int	NUM_FRAMES		= 300;
+
+static const std::string	SCRIPT			=
+	"numUpdates = 0\n"
+	"function bench:update(node)\n"
+	"    numUpdates = numUpdates + 1\n"
+	"end\n";
+
+// per-frame math written with temporaries, as most scripts do
+static const std::string	MATH_SCRIPT		=
+	"numUpdates = 0\n"
+	"local provider = Provider.create()\n"
+	"local matrix = Matrix4x4.create()\n"
+	"local target = Vector3.create(0, 0, 0)\n"
+	"function bench:update(node)\n"
+	"    numUpdates = numUpdates + 1\n"
+	"    local t = numUpdates * 0.001\n"
+	"    local position = Vector3.create(math.cos(t), 1, math.sin(t))\n"
+	"    local velocity = Vector3.create(0, -9.81, 0):scaleBy(1 / 60)\n"
+	"    local moved = matrix:transform(velocity)\n"
+	"    position:setTo(position.x + moved.x, position.y + moved.y, position.z + moved.z):normalize()\n"
+	"    matrix:identity():appendRotationY(t):appendTranslation(position.x, position.y, position.z)\n"
+	"    matrix:lookAt(target, position, Vector3.up())\n"
+	"    provider:setVector3(\"position\", position)\n"
+	"end\n";
+
+// the same math with preallocated values and in-place operations
+static const std::string	IN_PLACE_SCRIPT	=
+	"numUpdates = 0\n"
+	"local provider = Provider.create()\n"
+	"local matrix = Matrix4x4.create()\n"
+	"local target = Vector3.create(0, 0, 0)\n"
+	"local up = Vector3.up()\n"
+	"local position = Vector3.create()\n"
+	"local velocity = Vector3.create()\n"
+	"local moved = Vector3.create()\n"
+	"function bench:update(node)\n"
+	"    numUpdates = numUpdates + 1\n"
+	"    local t = numUpdates * 0.001\n"
+	"    position:setTo(math.cos(t), 1, math.sin(t))\n"
+	"    velocity:setTo(0, -9.81, 0):scaleBy(1 / 60)\n"
+	"    position:add(matrix:transform(velocity, moved)):normalize()\n"
+	"    matrix:identity():appendRotationY(t):appendTranslation(position)\n"
+	"    matrix:lookAt(target, position, up)\n"
+	"    provider:setVector3(\"position\", position)\n"
+	"end\n";
+
+struct Result
+{
+	double			duration;
+	double			allocations;
+	double			luaAllocations;
+};
+
+static std::atomic<unsigned long>	numAllocations(0);
+static unsigned long				numLuaAllocations = 0;
+static lua_Alloc					luaAllocator;
+
+void*
+operator new(std::size_t size)
+{
+	++numAllocations;
+
+	if (auto ptr = std::malloc(size ? size : 1))
+		return ptr;
+
+	throw std::bad_alloc();
+}
+
+void
+operator delete(void* ptr) throw()
+{
+	std::free(ptr);
+}
+
+void*
+countLuaAllocations(void* ud, void* ptr, size_t osize, size_t nsize)
+{
+	if (nsize != 0 && (ptr == nullptr || nsize > osize))
+		++numLuaAllocations;
+
+	return luaAllocator(ud, ptr, osize, nsize);
+}
+
+Result
+run(const std::string& code, unsigned int numNodes, bool batchUpdates)
+{
+	auto sceneManager	= SceneManager::create(nullptr);
+	auto root			= scene::Node::create("root")->addComponent(sceneManager);
+	auto scriptManager	= LuaScriptManager::create();
+	auto script			= LuaScript::create("bench", code);
+	auto state			= scriptManager->state()->state();
+	void* allocatorData	= nullptr;
+
+	luaAllocator = lua_getallocf(state, &allocatorData);
+	lua_setallocf(state, &countLuaAllocations, allocatorData);
+
+	root->addComponent(scriptManager);
+	script->batchUpdates(batchUpdates);
+
+	for (unsigned int i = 0; i < numNodes; ++i)
+	{
+		auto node = scene::Node::create();
+
+		root->addChild(node);
+		node->addComponent(script);
+	}
+
+	// starts the scripts
+	sceneManager->nextFrame(0.f, 0.f);
+
+	auto allocations	= numAllocations.load();
+	auto luaAllocations	= numLuaAllocations;
+	auto start			= std::chrono::high_resolution_clock::now();
+
+	for (unsigned int frame = 1; frame <= NUM_FRAMES; ++frame)
+		sceneManager->nextFrame(frame / 60.f, 1.f / 60.f);
+
+	auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::high_resolution_clock::now() - start
+	).count() / 1000.;
+
+	Result result = {
+		duration / NUM_FRAMES,
+		(numAllocations.load() - allocations) / (double)NUM_FRAMES,
+		(numLuaAllocations - luaAllocations) / (double)NUM_FRAMES
+	};
+
+	lua_getglobal(state, "numUpdates");
+	if (lua_tonumber(state, -1) != numNodes * (NUM_FRAMES + 1.))
+		std::cerr << "error: " << lua_tonumber(state, -1) << " updates" << std::endl;
+	lua_pop(state, 1);
+
+	return result;
+}
+
+void
+print(const std::string& name, const Result& result)
+{
+	std::cout << name << ": " << result.duration << "ms/frame, "
+		<< result.allocations << " C++ allocations/frame, "
+		<< result.luaAllocations << " Lua allocations/frame" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << NUM_NODES << " scripted nodes, " << NUM_FRAMES << " frames" << std::endl;
+	print("batched updates", run(SCRIPT, NUM_NODES, true));
+	print("one update per node", run(SCRIPT, NUM_NODES, false));
+
+	std::cout << NUM_MATH_NODES << " scripted nodes doing math, " << NUM_FRAMES << " frames" << std::endl;
+	print("temporaries", run(MATH_SCRIPT, NUM_MATH_NODES, true));
+	print("in-place", run(IN_PLACE_SCRIPT, NUM_MATH_NODES, true));
+
+	return 0;
+}
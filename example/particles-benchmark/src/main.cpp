@@ -0,0 +1,112 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/Minko.hpp"
+#include "minko/MinkoParticles.hpp"
+
+using namespace minko;
+using namespace minko::particle;
+
+static const unsigned int	NUM_PARTICLES	= 100000;
+static const unsigned int	NUM_FRAMES		= 500;
+static const float			TIME_STEP		= 1.f / 60.f;
+
+void
+spawnParticles(ParticleStore& particles)
+{
+	ParticleData particle;
+
+	particles.clear();
+	while (particles.liveCount() < particles.capacity())
+	{
+		particle.x = particle.y = particle.z = 0.f;
+		particle.startvx	= (float)rand() / RAND_MAX - .5f;
+		particle.startvy	= (float)rand() / RAND_MAX;
+		particle.startvz	= (float)rand() / RAND_MAX - .5f;
+		particle.startfx	= particle.startfy = particle.startfz = 0.f;
+		particle.rotation	= 0.f;
+		particle.startAngularVelocity = 1.f;
+		particle.lifetime	= 1e6f;
+		particle.timeLived	= 0.f;
+
+		particles.set(particles.spawn(), particle);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	ParticleStore particles;
+
+	particles.resize(NUM_PARTICLES);
+
+	auto force = modifier::ForceOverTime::create(
+		sampler::Constant<float>::create(0.f),
+		sampler::Constant<float>::create(-9.81f),
+		sampler::Constant<float>::create(0.f)
+	);
+	auto velocity = modifier::VelocityOverTime::create(
+		sampler::LinearlyInterpolatedValue<float>::create(0.f, 1.f),
+		sampler::Constant<float>::create(0.f),
+		sampler::RandomValue<float>::create(-.1f, .1f)
+	);
+
+	std::list<modifier::IParticleUpdater::Ptr> updaters = { force, velocity };
+
+	spawnParticles(particles);
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for (unsigned int frame = 0; frame < NUM_FRAMES; ++frame)
+	{
+		unsigned int		liveCount	= particles.liveCount();
+		float*				x			= particles.stream(ParticleStore::X);
+		float*				y			= particles.stream(ParticleStore::Y);
+		float*				z			= particles.stream(ParticleStore::Z);
+		float*				vx			= particles.stream(ParticleStore::START_VX);
+		float*				vy			= particles.stream(ParticleStore::START_VY);
+		float*				vz			= particles.stream(ParticleStore::START_VZ);
+		float*				timeLived	= particles.stream(ParticleStore::TIME_LIVED);
+
+		for (unsigned int i = 0; i < liveCount; ++i)
+			timeLived[i] += TIME_STEP;
+
+		particles.killExpired();
+		liveCount = particles.liveCount();
+
+		for (auto& updater : updaters)
+			updater->update(particles, TIME_STEP);
+
+		for (unsigned int i = 0; i < liveCount; ++i)
+		{
+			x[i] += vx[i] * TIME_STEP;
+			y[i] += vy[i] * TIME_STEP;
+			z[i] += vz[i] * TIME_STEP;
+		}
+	}
+
+	auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::high_resolution_clock::now() - start
+	).count() / 1000.;
+
+	std::cout << NUM_PARTICLES << " particles, " << NUM_FRAMES << " frames in " << duration << "ms" << std::endl;
+	std::cout << (NUM_PARTICLES * (double)NUM_FRAMES / duration) << " particles/ms" << std::endl;
+
+	return 0;
+}
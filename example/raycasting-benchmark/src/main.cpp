@@ -0,0 +1,209 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/Minko.hpp"
+
+using namespace minko;
+using namespace minko::geometry;
+
+static const unsigned int	NUM_SEGMENTS			= 180;
+static const unsigned int	IMAGE_SIZE				= 256;
+static const unsigned int	PACKET_SIZE				= 8;
+static const unsigned int	NUM_BRUTE_FORCE_RAYS	= 256;
+
+void
+createSphere(std::vector<float>& xyz, std::vector<unsigned short>& indices)
+{
+	for (unsigned int j = 0; j <= NUM_SEGMENTS; ++j)
+	{
+		float theta = (float)M_PI * j / NUM_SEGMENTS;
+
+		for (unsigned int i = 0; i <= NUM_SEGMENTS; ++i)
+		{
+			float phi = 2.f * (float)M_PI * i / NUM_SEGMENTS;
+
+			xyz.push_back(sinf(theta) * cosf(phi));
+			xyz.push_back(cosf(theta));
+			xyz.push_back(sinf(theta) * sinf(phi));
+		}
+	}
+
+	for (unsigned int j = 0; j < NUM_SEGMENTS; ++j)
+	{
+		for (unsigned int i = 0; i < NUM_SEGMENTS; ++i)
+		{
+			unsigned short a = j * (NUM_SEGMENTS + 1) + i;
+			unsigned short b = a + NUM_SEGMENTS + 1;
+
+			indices.insert(indices.end(), { a, b, (unsigned short)(a + 1), b, (unsigned short)(b + 1), (unsigned short)(a + 1) });
+		}
+	}
+}
+
+// primary rays of a IMAGE_SIZE x IMAGE_SIZE pinhole camera looking at the sphere, stored tile by tile
+void
+createRays(std::vector<float>& origins, std::vector<float>& directions)
+{
+	for (unsigned int tileY = 0; tileY < IMAGE_SIZE; tileY += PACKET_SIZE)
+		for (unsigned int tileX = 0; tileX < IMAGE_SIZE; tileX += PACKET_SIZE)
+			for (unsigned int y = tileY; y < tileY + PACKET_SIZE; ++y)
+				for (unsigned int x = tileX; x < tileX + PACKET_SIZE; ++x)
+				{
+					origins.insert(origins.end(), { 0.f, 0.f, 3.f });
+					directions.insert(directions.end(), {
+						((float)x / IMAGE_SIZE - .5f) * .8f, ((float)y / IMAGE_SIZE - .5f) * .8f, -1.f
+					});
+				}
+}
+
+// linear scan over every triangle, as Geometry::cast did before the BVH
+bool
+bruteForceCast(const std::vector<float>&			xyz,
+			   const std::vector<unsigned short>&	indices,
+			   const float*							origin,
+			   const float*							direction,
+			   float&								distance)
+{
+	auto hit = false;
+	auto rayOrigin = math::Vector3::create(origin[0], origin[1], origin[2]);
+	auto rayDirection = math::Vector3::create(direction[0], direction[1], direction[2]);
+	auto v0 = math::Vector3::create();
+	auto v1 = math::Vector3::create();
+	auto v2 = math::Vector3::create();
+	auto edge1 = math::Vector3::create();
+	auto edge2 = math::Vector3::create();
+	auto pvec = math::Vector3::create();
+	auto tvec = math::Vector3::create();
+	auto qvec = math::Vector3::create();
+
+	for (unsigned int i = 0; i < indices.size(); i += 3)
+	{
+		v0->copyFrom(const_cast<float*>(&xyz[indices[i] * 3]));
+		v1->copyFrom(const_cast<float*>(&xyz[indices[i + 1] * 3]));
+		v2->copyFrom(const_cast<float*>(&xyz[indices[i + 2] * 3]));
+
+		edge1->copyFrom(v1)->subtract(v0);
+		edge2->copyFrom(v2)->subtract(v0);
+		pvec->copyFrom(rayDirection)->cross(edge2);
+
+		auto dot = edge1->dot(pvec);
+
+		if (dot > -0.00001f && dot < 0.00001f)
+			continue;
+
+		tvec->copyFrom(rayOrigin)->subtract(v0);
+
+		auto u = tvec->dot(pvec) / dot;
+
+		if (u < 0.f || u > 1.f)
+			continue;
+
+		qvec->copyFrom(tvec)->cross(edge1);
+
+		auto v = rayDirection->dot(qvec) / dot;
+
+		if (v < 0.f || u + v > 1.f)
+			continue;
+
+		auto t = edge2->dot(qvec) / dot;
+
+		if (t >= 0.f && (!hit || t < distance))
+		{
+			distance = t;
+			hit = true;
+		}
+	}
+
+	return hit;
+}
+
+double
+elapsed(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::high_resolution_clock::now() - start
+	).count() / 1000.;
+}
+
+void
+printResult(const std::string& name, unsigned int numRays, unsigned int numHits, double duration)
+{
+	std::cout << name << ": " << numRays << " rays, " << numHits << " hits in " << duration << "ms, "
+		<< (unsigned int)(numRays / (duration / 1000.)) << " rays/s" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<float>			xyz;
+	std::vector<unsigned short>	indices;
+	std::vector<float>			origins;
+	std::vector<float>			directions;
+
+	createSphere(xyz, indices);
+	createRays(origins, directions);
+
+	const unsigned int numRays = origins.size() / 3;
+
+	std::cout << (indices.size() / 3) << " triangles" << std::endl;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	auto bvh = BVH::create(xyz, 3, 0, indices);
+
+	std::cout << "BVH build: " << bvh->numNodes() << " nodes in " << elapsed(start) << "ms" << std::endl;
+
+	auto numHits = 0u;
+	auto distance = 0.f;
+
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < NUM_BRUTE_FORCE_RAYS; ++i)
+	{
+		unsigned int ray = (i * numRays / NUM_BRUTE_FORCE_RAYS) * 3;
+
+		if (bruteForceCast(xyz, indices, &origins[ray], &directions[ray], distance))
+			++numHits;
+	}
+	printResult("linear scan", NUM_BRUTE_FORCE_RAYS, numHits, elapsed(start));
+
+	BVH::Hit hit;
+
+	numHits = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < numRays; ++i)
+		if (bvh->cast(&origins[i * 3], &directions[i * 3], hit))
+			++numHits;
+	printResult("BVH closest hit", numRays, numHits, elapsed(start));
+
+	numHits = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < numRays; ++i)
+		if (bvh->castAny(&origins[i * 3], &directions[i * 3]))
+			++numHits;
+	printResult("BVH any hit", numRays, numHits, elapsed(start));
+
+	std::vector<BVH::Hit> hits(PACKET_SIZE * PACKET_SIZE);
+
+	numHits = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < numRays; i += hits.size())
+		numHits += bvh->castPacket(hits.size(), &origins[i * 3], &directions[i * 3], &hits[0]);
+	printResult("BVH packets", numRays, numHits, elapsed(start));
+
+	return 0;
+}
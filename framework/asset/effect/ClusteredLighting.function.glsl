@@ -0,0 +1,78 @@
+#ifdef CLUSTERED_LIGHTING
+
+uniform sampler2D	clusteredLights;
+uniform sampler2D	clusteredGrid;
+uniform sampler2D	clusteredIndices;
+uniform vec3		clusteredDimensions;
+uniform vec2		clusteredDepthParams;
+uniform vec3		clusteredTextureSizes; // grid size, indices size, lights texture height
+uniform mat4		clusteredWorldToScreenMatrix;
+
+// see encodeFloat() in ClusteredLighting.cpp
+float
+clusteredLighting_decodeFloat(vec4 texel)
+{
+	vec4	bytes		= floor(texel * 255.0 + 0.5);
+	float	mantissa	= dot(bytes.rgb, vec3(65536.0, 256.0, 1.0)) / 16777215.0;
+
+	return (mantissa * 2.0 - 1.0) * exp2(bytes.a - 128.0);
+}
+
+vec4
+clusteredLighting_fetch(sampler2D map, float index, float size)
+{
+	vec2 uv = (vec2(mod(index, size), floor(index / size)) + 0.5) / size;
+
+	return floor(texture2D(map, uv) * 255.0 + 0.5);
+}
+
+float
+clusteredLighting_lightValue(float light, float texel)
+{
+	vec2 uv = vec2((texel + 0.5) / 32.0, (light + 0.5) / clusteredTextureSizes.z);
+
+	return clusteredLighting_decodeFloat(texture2D(clusteredLights, uv));
+}
+
+vec3
+clusteredLighting_lightVector(float light, float texel)
+{
+	return vec3(
+		clusteredLighting_lightValue(light, texel),
+		clusteredLighting_lightValue(light, texel + 1.0),
+		clusteredLighting_lightValue(light, texel + 2.0)
+	);
+}
+
+// offset (x) and number (y) of the lights of the cluster containing a world-space position
+vec2
+clusteredLighting_getCluster(vec3 position)
+{
+	vec4	clipPosition	= clusteredWorldToScreenMatrix * vec4(position, 1.0);
+	vec2	tile			= clamp(
+		floor((clipPosition.xy / clipPosition.w * 0.5 + 0.5) * clusteredDimensions.xy),
+		vec2(0.0),
+		clusteredDimensions.xy - 1.0
+	);
+	float	slice			= clamp(
+		floor(log(max(clipPosition.w, 0.000001)) * clusteredDepthParams.x + clusteredDepthParams.y),
+		0.0,
+		clusteredDimensions.z - 1.0
+	);
+	float	cluster			= tile.x + clusteredDimensions.x * (tile.y + clusteredDimensions.y * slice);
+	vec4	texel			= clusteredLighting_fetch(clusteredGrid, cluster, clusteredTextureSizes.x);
+
+	return vec2(dot(texel.rgb, vec3(65536.0, 256.0, 1.0)), texel.a);
+}
+
+// light index stored at a given offset (two 16 bits indices per texel)
+float
+clusteredLighting_getLight(float offset)
+{
+	vec4 texel	= clusteredLighting_fetch(clusteredIndices, floor(offset * 0.5), clusteredTextureSizes.y);
+	vec2 bytes	= mod(offset, 2.0) < 0.5 ? texel.rg : texel.ba;
+
+	return bytes.x + bytes.y * 256.0;
+}
+
+#endif // CLUSTERED_LIGHTING
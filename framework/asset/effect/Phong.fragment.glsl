@@ -1,12 +1,17 @@
 #ifdef FRAGMENT_SHADER
 
 #ifdef GL_ES
-	precision mediump float;
+	#if defined(CLUSTERED_LIGHTING) && defined(GL_FRAGMENT_PRECISION_HIGH)
+		precision highp float; // light indices and positions need more than 10 bits
+	#else
+		precision mediump float;
+	#endif
 #endif
 
 #pragma include("Phong.function.glsl")
 #pragma include("Envmap.function.glsl")
 #pragma include("Fog.function.glsl")
+#pragma include("ClusteredLighting.function.glsl")
 
 #ifdef PRECOMPUTED_AMBIENT
 	uniform vec3 sumAmbients;
@@ -67,6 +72,15 @@
 	
 #endif // MINKO_NO_GLSL_STRUCT
 	
+#ifdef SURFACE_LIGHTS
+	uniform int		surfaceLightsCount;
+	uniform vec4	surfaceLightsPosition[SURFACE_LIGHTS];		// xyz: position, w: range (< 0 if infinite)
+	uniform vec4	surfaceLightsColor[SURFACE_LIGHTS];			// rgb: color, a: diffuse
+	uniform vec4	surfaceLightsAttenuation[SURFACE_LIGHTS];	// xyz: coefficients, w: specular
+	uniform vec3	surfaceLightsDirection[SURFACE_LIGHTS];
+	uniform vec2	surfaceLightsCone[SURFACE_LIGHTS];			// x: cos. inner angle, y: cos. outer angle
+#endif // SURFACE_LIGHTS
+
 // diffuse
 uniform vec4 		diffuseColor;
 uniform sampler2D 	diffuseMap;
@@ -146,13 +160,13 @@ void main(void)
 	#endif // PRECOMPUTED_AMBIENT
 	
 
-	#if defined NUM_DIRECTIONAL_LIGHTS || defined NUM_POINT_LIGHTS || defined NUM_SPOT_LIGHTS || defined ENVIRONMENT_MAP_2D || defined ENVIRONMENT_CUBE_MAP
+	#if defined NUM_DIRECTIONAL_LIGHTS || defined NUM_POINT_LIGHTS || defined NUM_SPOT_LIGHTS || defined CLUSTERED_LIGHTING || defined SURFACE_LIGHTS || defined ENVIRONMENT_MAP_2D || defined ENVIRONMENT_CUBE_MAP
 
 	vec3 eyeVector	= normalize(cameraPosition - vertexPosition); // always in world-space
 
-	#endif // NUM_DIRECTIONAL_LIGHTS || NUM_POINT_LIGHTS || NUM_SPOT_LIGHTS || ENVIRONMENT_MAP_2D || ENVIRONMENT_CUBE_MAP
+	#endif // NUM_DIRECTIONAL_LIGHTS || NUM_POINT_LIGHTS || NUM_SPOT_LIGHTS || CLUSTERED_LIGHTING || SURFACE_LIGHTS || ENVIRONMENT_MAP_2D || ENVIRONMENT_CUBE_MAP
 
-	#if defined NUM_DIRECTIONAL_LIGHTS || defined NUM_POINT_LIGHTS || defined NUM_SPOT_LIGHTS
+	#if defined NUM_DIRECTIONAL_LIGHTS || defined NUM_POINT_LIGHTS || defined NUM_SPOT_LIGHTS || defined CLUSTERED_LIGHTING || defined SURFACE_LIGHTS
 		
 		vec3	lightColor				= vec3(0.0);
 		vec3 	lightDirection			= vec3(0.0);
@@ -305,8 +319,68 @@ void main(void)
 			}
 		}
 		#endif // NUM_SPOT_LIGHTS
+
+		#ifdef CLUSTERED_LIGHTING
+		//-----------------------
+		vec2 cluster = clusteredLighting_getCluster(vertexPosition);
+
+		for (int i = 0; i < CLUSTERED_LIGHTING; ++i)
+		{
+			if (float(i) >= cluster.y)
+				break;
+
+			float light	= clusteredLighting_getLight(cluster.x + float(i));
+
+			phong_accumulateListedLight(
+				clusteredLighting_lightVector(light, 0.0),	// position
+				clusteredLighting_lightVector(light, 6.0),	// color
+				clusteredLighting_lightValue(light, 9.0),	// diffuse
+				clusteredLighting_lightValue(light, 10.0),	// specular
+				clusteredLighting_lightVector(light, 3.0),	// attenuation coefficients
+				clusteredLighting_lightVector(light, 11.0),	// direction
+				clusteredLighting_lightValue(light, 14.0),	// cos. inner cone angle
+				clusteredLighting_lightValue(light, 15.0),	// cos. outer cone angle
+				clusteredLighting_lightValue(light, 16.0),	// range
+				vertexPosition,
+				normalVector,
+				eyeVector,
+				specular.rgb,
+				shininessCoeff,
+				diffuseAccum,
+				specularAccum
+			);
+		}
+		#endif // CLUSTERED_LIGHTING
+
+		#ifdef SURFACE_LIGHTS
+		//-------------------
+		for (int i = 0; i < SURFACE_LIGHTS; ++i)
+		{
+			if (i >= surfaceLightsCount)
+				break;
+
+			phong_accumulateListedLight(
+				surfaceLightsPosition[i].xyz,
+				surfaceLightsColor[i].rgb,
+				surfaceLightsColor[i].a,
+				surfaceLightsAttenuation[i].w,
+				surfaceLightsAttenuation[i].xyz,
+				surfaceLightsDirection[i],
+				surfaceLightsCone[i].x,
+				surfaceLightsCone[i].y,
+				surfaceLightsPosition[i].w,
+				vertexPosition,
+				normalVector,
+				eyeVector,
+				specular.rgb,
+				shininessCoeff,
+				diffuseAccum,
+				specularAccum
+			);
+		}
+		#endif // SURFACE_LIGHTS
 		
-	#endif // defined NUM_DIRECTIONAL_LIGHTS || defined NUM_POINT_LIGHTS || defined NUM_SPOT_LIGHTS
+	#endif // defined NUM_DIRECTIONAL_LIGHTS || defined NUM_POINT_LIGHTS || defined NUM_SPOT_LIGHTS || defined CLUSTERED_LIGHTING || defined SURFACE_LIGHTS
 
 	#if defined(ENVIRONMENT_MAP_2D) || defined(ENVIRONMENT_CUBE_MAP)
 
@@ -29,6 +29,56 @@ vec3 phong_fresnel(vec3 specularColor, vec3 lightDirection, vec3 eyeVector)
 	return specularColor + (vec3(1.0) - specularColor) * kk * kk * k;
 }
 
+// contribution of a point or spot light from a light list (clustered or per surface): point lights
+// are stored with a cone wider than any direction, and a negative range means an infinite one
+void phong_accumulateListedLight(vec3		lightPosition,
+								 vec3		lightColor,
+								 float		lightDiffuseCoeff,
+								 float		lightSpecularCoeff,
+								 vec3		lightAttenuationCoeffs,
+								 vec3		lightSpotDirection,
+								 float		lightCosInnerAng,
+								 float		lightCosOuterAng,
+								 float		lightRange,
+								 vec3		vertexPosition,
+								 vec3		normalVector,
+								 vec3		eyeVector,
+								 vec3		specularColor,
+								 float		shininess,
+								 inout vec3	diffuseAccum,
+								 inout vec3	specularAccum)
+{
+	vec3	lightDirection	= lightPosition - vertexPosition;
+	float	distanceToLight	= length(lightDirection);
+
+	lightDirection /= distanceToLight;
+
+	float	cosSpot			= dot(-lightDirection, normalize(-lightSpotDirection));
+
+	if (lightCosOuterAng < cosSpot && (lightRange < 0.0 || distanceToLight < lightRange))
+	{
+		vec3	distVec 	= vec3(1.0, distanceToLight, distanceToLight * distanceToLight);
+		float 	attenuation = any(lessThan(lightAttenuationCoeffs, vec3(0.0)))
+			? 1.0
+			: max(0.0, 1.0 - distanceToLight / dot(lightAttenuationCoeffs, distVec)); 
+
+		float cutoff	= cosSpot < lightCosInnerAng && lightCosOuterAng < lightCosInnerAng 
+			? (cosSpot - lightCosOuterAng) / (lightCosInnerAng - lightCosOuterAng) 
+			: 1.0;
+
+		diffuseAccum		+= phong_diffuseReflection(normalVector, lightDirection)
+			* lightColor
+			* (lightDiffuseCoeff * attenuation * cutoff);
+
+		#ifdef SHININESS
+			specularAccum	+= 
+				phong_specularReflection(normalVector, lightDirection, eyeVector, shininess) 
+				* phong_fresnel(specularColor, lightDirection, eyeVector)
+				* lightColor
+				* (lightSpecularCoeff * attenuation * cutoff);
+		#endif // SHININESS
+	}
+}
 
 // compute the world space to tangent space matrix using the model's normal and tangent
 // @precondition worldNormal is expected to be normalized.
@@ -45,6 +45,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include <cfloat>
 #include <climits>
 #include <future>
+#include <mutex>
 #include <thread>
 #include <chrono>
 
@@ -92,6 +93,10 @@ namespace minko
 		class VertexFormat;
 		class VertexBuffer;
 		class IndexBuffer;
+		class LightClusters;
+		class RenderTargetPool;
+		class RenderGraph;
+		class OcclusionBuffer;
 
 		enum class TextureType
 		{
@@ -109,8 +114,17 @@ namespace minko
 		enum class TextureFormat
 		{
 			RGB,
-			RGBA
+			RGBA,
+			RGB_DXT1,
+			RGBA_DXT5,
+			RGB_ETC1,
+			RGB_PVRTC1_4BPP,
+			RGBA_PVRTC1_4BPP
 		};
+
+		class TextureCompression;
+		class MipMapChain;
+		class PixelBufferPool;
 		class AbstractTexture;
 		class Texture;
 		class CubeTexture;
@@ -162,6 +176,11 @@ namespace minko
         class DirectionalLight;
 		class SpotLight;
 		class PointLight;
+		class ClusteredLighting;
+		class LightCulling;
+		class OcclusionCulling;
+		class LevelOfDetail;
+		class StaticBatching;
 
 		class BoundingBox;
 
@@ -173,6 +192,8 @@ namespace minko
 		class AbstractAnimation;
 		class MasterAnimation;
 		class Animation;
+		class AnimationBlender;
+		class TextureStreamer;
 		class Skinning;
 	}
 
@@ -230,6 +251,7 @@ namespace minko
 	namespace geometry
 	{
 		class Geometry;
+		class BVH;
 		class CubeGeometry;
 		class SphereGeometry;
         class QuadGeometry;
@@ -240,6 +262,7 @@ namespace minko
 	{
 		class AbstractTimeline;
 		class Matrix4x4Timeline;
+		class Pose;
 	}
 
 	namespace math
@@ -310,9 +333,26 @@ namespace minko
 		class Loader;
 		class AbstractLoader;
 		class AbstractParser;
+		class AbstractImageParser;
 		class EffectParser;
+		class KTXParser;
+		class KTXWriter;
         class AssetLibrary;
 
+		/*
+		** Encoding of the vertex attributes written by the serializer and decoded back to floats
+		** when parsed: QUANTIZED stores 16 bits per component normalized within the bounds of the
+		** attribute, OCTAHEDRAL stores unit 3D vectors (normals, tangents) as 2 x 16 bits and
+		** HALF_FLOAT stores IEEE 754 half precision floats (texture coordinates).
+		*/
+		enum class AttributeEncoding
+		{
+			RAW			= 0,
+			QUANTIZED	= 1,
+			OCTAHEDRAL	= 2,
+			HALF_FLOAT	= 3
+		};
+
         class ParserError : public std::runtime_error
         {
         public:
@@ -407,5 +447,17 @@ namespace std
 		std::hash<T> hasher;
 		seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 	}
+
+#ifndef _WIN32
+	// Hash function to allow TextureFormat to be an index in a map.
+	template <>
+	struct hash<minko::render::TextureFormat>
+	{
+		size_t operator()(const minko::render::TextureFormat& v) const
+		{
+			return hash<unsigned int>()(static_cast<unsigned int>(v));
+		}
+	};
+#endif
 }
 //using namespace minko;
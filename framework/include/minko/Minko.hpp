@@ -62,6 +62,11 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/component/DirectionalLight.hpp"
 #include "minko/component/SpotLight.hpp"
 #include "minko/component/PointLight.hpp"
+#include "minko/component/ClusteredLighting.hpp"
+#include "minko/component/LightCulling.hpp"
+#include "minko/component/OcclusionCulling.hpp"
+#include "minko/component/LevelOfDetail.hpp"
+#include "minko/component/StaticBatching.hpp"
 #include "minko/component/BoundingBox.hpp"
 #include "minko/component/MousePicking.hpp"
 #include "minko/component/MouseManager.hpp"
@@ -71,8 +76,11 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/component/AbstractAnimation.hpp"
 #include "minko/component/MasterAnimation.hpp"
 #include "minko/component/Animation.hpp"
+#include "minko/component/AnimationBlender.hpp"
+#include "minko/component/TextureStreamer.hpp"
 #include "minko/animation/AbstractTimeline.hpp"
 #include "minko/animation/Matrix4x4Timeline.hpp"
+#include "minko/animation/Pose.hpp"
 #include "minko/component/JobManager.hpp"
 #include "minko/render/AbstractResource.hpp"
 #include "minko/render/Program.hpp"
@@ -81,8 +89,16 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/render/AbstractTexture.hpp"
 #include "minko/render/Texture.hpp"
 #include "minko/render/CubeTexture.hpp"
+#include "minko/render/TextureCompression.hpp"
+#include "minko/render/MipMapChain.hpp"
+#include "minko/render/PixelBufferPool.hpp"
 #include "minko/render/Priority.hpp"
+#include "minko/render/LightClusters.hpp"
+#include "minko/render/RenderTargetPool.hpp"
+#include "minko/render/RenderGraph.hpp"
+#include "minko/render/OcclusionBuffer.hpp"
 #include "minko/geometry/Geometry.hpp"
+#include "minko/geometry/BVH.hpp"
 #include "minko/geometry/CubeGeometry.hpp"
 #include "minko/geometry/SphereGeometry.hpp"
 #include "minko/geometry/QuadGeometry.hpp"
@@ -92,7 +108,10 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/file/AbstractLoader.hpp"
 #include "minko/file/FileLoader.hpp"
 #include "minko/file/AbstractParser.hpp"
+#include "minko/file/AbstractImageParser.hpp"
 #include "minko/file/EffectParser.hpp"
+#include "minko/file/KTXParser.hpp"
+#include "minko/file/KTXWriter.hpp"
 #include "minko/file/AssetLibrary.hpp"
 #include "minko/material/Material.hpp"
 #include "minko/material/BasicMaterial.hpp"
@@ -85,6 +85,18 @@ namespace minko
 			void
 			update(uint time, UpdateTargetPtr, bool skipPropertyNameFormatting = true) = 0;
 
+			/**
+			 * Writes the local transform driven by the timeline at the specified time into 'channel'
+			 * (see animation::Pose for the layout). Returns false when the timeline does not drive a
+			 * transform. Must not modify the timeline so that it can be called from worker threads.
+			 */
+			virtual
+			bool
+			evaluate(uint time, float* channel) const
+			{
+				return false;
+			}
+
 		protected:
 			AbstractTimeline(const std::string& propertyName, uint duration);
 		};
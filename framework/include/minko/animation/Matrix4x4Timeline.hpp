@@ -36,8 +36,9 @@ namespace minko
 			typedef std::shared_ptr<math::Matrix4x4>			Matrix4x4Ptr;
 			typedef std::vector<std::pair<uint, Matrix4x4Ptr>>	MatrixTimetable;
 		private:
-			MatrixTimetable	_matrices;
-			bool			_interpolate;
+			MatrixTimetable		_matrices;
+			std::vector<float>	_keyChannels; // decomposed keys, Pose::CHANNEL_SIZE floats per key
+			bool				_interpolate;
 
 		public:
 			inline static
@@ -67,6 +68,9 @@ namespace minko
             Matrix4x4Ptr
             interpolate(uint time, Matrix4x4Ptr output = nullptr) const;
 
+			bool
+			evaluate(uint time, float* channel) const;
+
 		private:
 			Matrix4x4Timeline(const std::string&,
 							  uint,
@@ -0,0 +1,123 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+	namespace animation
+	{
+		/**
+		 * A local pose buffer: one decomposed transform per channel, stored contiguously as
+		 * translation (3 floats), rotation quaternion (4 floats) and scale (3 floats).
+		 * Poses never touch the scene and can be evaluated and blended on any thread.
+		 */
+		class Pose
+		{
+		public:
+			typedef std::shared_ptr<Pose>	Ptr;
+
+			static const uint CHANNEL_SIZE = 10;
+
+		private:
+			std::vector<float>	_data;
+
+		public:
+			inline static
+			Ptr
+			create(uint numChannels = 0)
+			{
+				auto pose = std::shared_ptr<Pose>(new Pose());
+
+				pose->numChannels(numChannels);
+
+				return pose;
+			}
+
+			inline
+			uint
+			numChannels() const
+			{
+				return _data.size() / CHANNEL_SIZE;
+			}
+
+			void
+			numChannels(uint value);
+
+			inline
+			float*
+			channel(uint channelId)
+			{
+				return &_data[channelId * CHANNEL_SIZE];
+			}
+
+			inline
+			const float*
+			channel(uint channelId) const
+			{
+				return &_data[channelId * CHANNEL_SIZE];
+			}
+
+			inline
+			std::vector<float>&
+			data()
+			{
+				return _data;
+			}
+
+			void
+			identity();
+
+			void
+			copyFrom(const Pose& source);
+
+			/**
+			 * Blends 'source' over this pose: each channel moves toward the source channel
+			 * by weight * mask[channelId] (mask is optional and defaults to 1 for all channels).
+			 */
+			void
+			blend(const Pose& source, float weight, const std::vector<float>* mask = nullptr);
+
+			/**
+			 * Adds the difference between 'source' and 'reference' on top of this pose,
+			 * scaled by weight * mask[channelId].
+			 */
+			void
+			add(const Pose& source, const Pose& reference, float weight, const std::vector<float>* mask = nullptr);
+
+			static
+			void
+			decompose(const float* matrix, float* channel);
+
+			static
+			void
+			compose(const float* channel, float* matrix);
+
+			static
+			void
+			interpolate(const float* from, const float* to, float ratio, float* output);
+
+		private:
+			Pose();
+		};
+	}
+}
@@ -0,0 +1,103 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#if !defined(EMSCRIPTEN)
+#include "minko/async/Worker.hpp"
+
+namespace minko
+{
+	namespace async
+	{
+		/**
+		 * Decodes an image file to RGBA, resized to the GPU dimensions when asked to, away from the
+		 * rendering thread. The workers do not have a thread of their own: they run on a fixed set of
+		 * hardware_concurrency() threads so that queued files are not all decoded, hence do not all
+		 * hold their buffers, at the same time.
+		 *
+		 * The decoded image is handed over through rgba() rather than through the output message, so
+		 * that the buffer taken from the PixelBufferPool ends up in the texture without any copy. It
+		 * is empty when the file could not be decoded.
+		 */
+		class ImageDecoderWorker : public Worker
+		{
+		public:
+			typedef std::shared_ptr<std::vector<unsigned char>>	FilePtr;
+			typedef std::function<bool(const unsigned char*, std::size_t, uint&, uint&, std::vector<unsigned char>&)>
+																DecodeFunction;
+
+		private:
+			DecodeFunction				_decode;
+			FilePtr						_file;
+			bool						_resize;
+			bool						_resizeSmoothly;
+			uint						_width;
+			uint						_height;
+			std::vector<unsigned char>	_rgba;
+
+		public:
+			static
+			Ptr
+			create()
+			{
+				return std::shared_ptr<ImageDecoderWorker>(new ImageDecoderWorker());
+			}
+
+			/**
+			 * Sets the file to decode, before the worker is started. The file is released once
+			 * decoded.
+			 */
+			void
+			decode(DecodeFunction decode, FilePtr file, bool resize, bool resizeSmoothly);
+
+			inline
+			uint
+			width() const
+			{
+				return _width;
+			}
+
+			inline
+			uint
+			height() const
+			{
+				return _height;
+			}
+
+			inline
+			std::vector<unsigned char>&
+			rgba()
+			{
+				return _rgba;
+			}
+
+			void
+			start();
+
+			void
+			run(); // Must be defined in .cpp with the MINKO_WORKER macro.
+
+		private:
+			ImageDecoderWorker();
+		};
+	}
+}
+#endif
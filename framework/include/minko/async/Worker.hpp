@@ -62,6 +62,7 @@ namespace minko
 #endif
 
 		public:
+			virtual
 			void
 			start();
 
@@ -67,6 +67,24 @@ namespace minko
 				return std::static_pointer_cast<AbstractDiscreteLight>(shared_from_this());
 			}
 
+			/**
+			 * Distance beyond which the light has no effect, negative if its influence is unbounded.
+			 */
+			virtual
+			float
+			influenceRadius() const
+			{
+				return -1.f;
+			}
+
+			/**
+			 * Distance at which the attenuation max(0, 1 - d / (c + l * d + q * d^2)) first reaches 0,
+			 * or -1 if it never does (including when attenuation is disabled).
+			 */
+			static
+			float
+			attenuationRange(float constant, float linear, float quadratic);
+
 		protected:
 			AbstractDiscreteLight(const std::string&	arrayName, 
 								  float					diffuse		= 1.0f, 
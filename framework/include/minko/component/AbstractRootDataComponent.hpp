@@ -49,6 +49,34 @@ namespace minko
             Signal<NodePtr, NodePtr, NodePtr>::Slot         _addedSlot;
             Signal<NodePtr, NodePtr, NodePtr>::Slot         _removedSlot;
 
+        public:
+            inline
+            bool
+            enabled() const
+            {
+                return _enabled;
+            }
+
+            /**
+             * A disabled component keeps its data but does not publish it in the root of the scene.
+             */
+            void
+            enabled(bool value)
+            {
+                if (value == _enabled)
+                    return;
+
+                _enabled = value;
+
+                if (_root)
+                {
+                    if (_enabled)
+                        _root->data()->addProvider(_data);
+                    else
+                        _root->data()->removeProvider(_data);
+                }
+            }
+
 	    protected:
             inline
             std::shared_ptr<ProviderClass>
@@ -131,12 +159,12 @@ namespace minko
                 if (root == _root)
                     return;
 
-                if (_root)
+                if (_root && _enabled)
                     _root->data()->removeProvider(_data);
                 
                 _root = root;
 
-                if (_root)
+                if (_root && _enabled)
                     _root->data()->addProvider(_data);
             }
 	    };
@@ -41,6 +41,7 @@ namespace minko
 
 		private:
 			std::unordered_map<NodePtr, bool>				                _started;
+			std::vector<NodePtr>							                _runningTargets;
 
 			Signal<AbsCmpPtr, NodePtr>::Slot				                _targetAddedSlot;
 			Signal<AbsCmpPtr, NodePtr>::Slot				                _targetRemovedSlot;
@@ -66,6 +67,20 @@ namespace minko
 				// nothing
 			}
 
+			/**
+			 * Called once per frame with all the running targets, after the targets that became
+			 * ready have been started. Calls update() for each of them by default: scripts for
+			 * which a call is expensive, such as the ones running in a virtual machine, dispatch
+			 * the whole batch at once instead.
+			 */
+			virtual
+			void
+			updateAll(const std::vector<NodePtr>& targets)
+			{
+				for (auto& target : targets)
+					update(target);
+			}
+
 			virtual
 			void
 			end(NodePtr target)
@@ -0,0 +1,242 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/component/AbstractScript.hpp"
+#include "minko/animation/Pose.hpp"
+
+namespace minko
+{
+	namespace component
+	{
+		/**
+		 * Blends several animation layers into a single local pose per frame.
+		 *
+		 * Each layer is made of existing Animation components (typically one per bone). Instead of
+		 * letting those animations write into their targets, the blender evaluates their timelines into
+		 * pose buffers, blends the layers (override cross-fades, additive layers, per-bone masks) and
+		 * writes the resulting matrices to the Transform components in one batch.
+		 *
+		 * Override layers are averaged according to their weights and fall back to the rest pose when
+		 * their total weight is below 1. Additive layers are then applied on top, in order.
+		 *
+		 * The evaluation step only touches the blender's own buffers: evaluate() can run on a worker
+		 * thread, and updateAll() evaluates many characters concurrently before applying them.
+		 */
+		class AnimationBlender :
+			public AbstractScript
+		{
+		public:
+			typedef std::shared_ptr<AnimationBlender>				Ptr;
+
+			enum class BlendMode
+			{
+				OVERRIDE,
+				ADDITIVE
+			};
+
+		private:
+			typedef std::shared_ptr<scene::Node>					NodePtr;
+			typedef std::shared_ptr<AbstractComponent>				AbsCmpPtr;
+			typedef std::shared_ptr<Animation>						AnimationPtr;
+			typedef std::shared_ptr<animation::AbstractTimeline>	AbsTimelinePtr;
+			typedef std::shared_ptr<math::Matrix4x4>				Matrix4x4Ptr;
+
+			struct Layer
+			{
+				std::vector<std::pair<uint, AbsTimelinePtr>>	tracks;
+				std::vector<bool>								tracked;
+				std::vector<float>								mask;
+				animation::Pose::Ptr							pose;
+				animation::Pose::Ptr							reference;
+				BlendMode										mode;
+				float											weight;
+				float											targetWeight;
+				float											fadeSpeed; // weight units per millisecond
+				float											time;
+				float											speed;
+				uint											duration;
+				bool											isPlaying;
+			};
+
+		private:
+			std::vector<NodePtr>						_channelNodes;
+			std::vector<Matrix4x4Ptr>					_channelMatrices;
+			std::vector<float>							_channelMatrixData;
+			std::unordered_map<NodePtr, uint>			_nodeToChannel;
+			std::vector<Layer>							_layers;
+			animation::Pose::Ptr						_restPose;
+			animation::Pose::Ptr						_overridePose;
+			animation::Pose::Ptr						_pose;
+			std::vector<float>							_overrideWeights;
+			std::vector<float>							_blendRatios;
+			bool										_autoUpdate;
+			float										_previousTime;
+
+		public:
+			inline static
+			Ptr
+			create()
+			{
+				Ptr ptr = std::shared_ptr<AnimationBlender>(new AnimationBlender());
+
+				ptr->initialize();
+
+				return ptr;
+			}
+
+			/**
+			 * Adds a layer on top of the existing ones and returns its index. The animations
+			 * must already be attached to their target nodes; they are stopped so that only the
+			 * blender drives those nodes from now on.
+			 */
+			uint
+			addLayer(const std::vector<AnimationPtr>&	animations,
+					 BlendMode							mode	= BlendMode::OVERRIDE,
+					 float								weight	= 1.f);
+
+			inline
+			uint
+			numLayers() const
+			{
+				return _layers.size();
+			}
+
+			inline
+			float
+			layerWeight(uint layerId) const
+			{
+				return _layers[layerId].weight;
+			}
+
+			Ptr
+			layerWeight(uint layerId, float weight);
+
+			inline
+			float
+			layerSpeed(uint layerId) const
+			{
+				return _layers[layerId].speed;
+			}
+
+			Ptr
+			layerSpeed(uint layerId, float speed);
+
+			inline
+			uint
+			layerTime(uint layerId) const
+			{
+				return (uint)_layers[layerId].time;
+			}
+
+			Ptr
+			layerTime(uint layerId, uint time);
+
+			Ptr
+			playLayer(uint layerId);
+
+			Ptr
+			stopLayer(uint layerId);
+
+			/**
+			 * Restricts a layer to 'node' (and its descendants if 'recursive' is true) with the
+			 * specified weight. The mask is multiplied with the layer weight for each bone.
+			 */
+			Ptr
+			layerMask(uint layerId, NodePtr node, float weight = 1.f, bool recursive = true);
+
+			Ptr
+			clearLayerMask(uint layerId);
+
+			Ptr
+			fadeLayer(uint layerId, float weight, uint duration);
+
+			/**
+			 * Fades the specified layer in and all the other override layers out over 'duration' ms.
+			 */
+			Ptr
+			crossFade(uint layerId, uint duration);
+
+			inline
+			bool
+			autoUpdate() const
+			{
+				return _autoUpdate;
+			}
+
+			inline
+			void
+			autoUpdate(bool value)
+			{
+				_autoUpdate = value;
+			}
+
+			inline
+			animation::Pose::Ptr
+			pose() const
+			{
+				return _pose;
+			}
+
+			inline
+			const std::vector<NodePtr>&
+			channels() const
+			{
+				return _channelNodes;
+			}
+
+			void
+			evaluate(float deltaTime);
+
+			void
+			apply();
+
+			/**
+			 * Evaluates all the blenders on up to 'numThreads' threads (0 means one per core)
+			 * and then applies their poses on the calling thread.
+			 */
+			static
+			void
+			updateAll(const std::vector<Ptr>& blenders, float deltaTime, uint numThreads = 0);
+
+		protected:
+			void
+			targetAddedHandler(AbsCmpPtr cmp, NodePtr target);
+
+			void
+			update(NodePtr target);
+
+			void
+			stop(NodePtr target);
+
+		private:
+			AnimationBlender();
+
+			uint
+			getChannel(NodePtr node);
+
+			void
+			evaluateLayer(Layer& layer, float time, animation::Pose::Ptr output);
+		};
+	}
+}
@@ -0,0 +1,206 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/Signal.hpp"
+#include "minko/component/AbstractComponent.hpp"
+
+namespace minko
+{
+	namespace component
+	{
+		/**
+		 * Clustered forward lighting for the point and spot lights of a scene.
+		 *
+		 * Each frame, before the camera's Renderer draws, the lights are binned into a view-space
+		 * cluster grid (see render::LightClusters) and the lights' data, the grid and the
+		 * per-cluster light lists are uploaded into data textures. The Phong effect then only
+		 * iterates over the lights of the fragment's cluster, and its shaders do not depend on the
+		 * number of lights anymore: adding or removing a light never triggers a recompilation.
+		 *
+		 * The component must be added to a camera node (with a PerspectiveCamera and a Renderer).
+		 * The point and spot lights it manages, up to maxLights(), are disabled (see
+		 * AbstractRootDataComponent::enabled()) so that they leave the "pointLights" and
+		 * "spotLights" arrays of the root; they are enabled again when the component is removed.
+		 * Lights are cut off at their influence radius (see AbstractDiscreteLight::influenceRadius()).
+		 */
+		class ClusteredLighting :
+			public AbstractComponent,
+			public std::enable_shared_from_this<ClusteredLighting>
+		{
+		public:
+			typedef std::shared_ptr<ClusteredLighting>	Ptr;
+
+		private:
+			typedef std::shared_ptr<AbstractComponent>			AbsCtrlPtr;
+			typedef std::shared_ptr<scene::Node>				NodePtr;
+			typedef std::shared_ptr<Renderer>					RendererPtr;
+			typedef std::shared_ptr<AbstractDiscreteLight>		LightPtr;
+			typedef std::shared_ptr<render::Texture>			TexturePtr;
+			typedef std::shared_ptr<render::AbstractContext>	ContextPtr;
+
+		public:
+			// number of texels used to store each light
+			static const uint							LIGHT_SIZE;
+			static const uint							INDICES_TEXTURE_SIZE;
+
+		private:
+			ContextPtr									_context;
+			const uint									_maxLights;
+			uint										_numJobs;
+
+			std::shared_ptr<render::LightClusters>		_clusters;
+			std::shared_ptr<data::StructureProvider>	_data;
+			TexturePtr									_lightsTexture;
+			TexturePtr									_gridTexture;
+			TexturePtr									_indicesTexture;
+			std::shared_ptr<math::Vector2>				_depthParams;
+
+			NodePtr										_root;
+			std::vector<LightPtr>						_lights;
+			std::vector<float>							_spheres;
+			uint										_numLightIndices;
+
+			Signal<AbsCtrlPtr, NodePtr>::Slot			_targetAddedSlot;
+			Signal<AbsCtrlPtr, NodePtr>::Slot			_targetRemovedSlot;
+			Signal<NodePtr, NodePtr, NodePtr>::Slot		_addedSlot;
+			Signal<NodePtr, NodePtr, NodePtr>::Slot		_removedSlot;
+			Signal<NodePtr, NodePtr, NodePtr>::Slot		_rootDescendantAddedSlot;
+			Signal<NodePtr, NodePtr, NodePtr>::Slot		_rootDescendantRemovedSlot;
+			Signal<NodePtr, NodePtr, AbsCtrlPtr>::Slot	_componentAddedSlot;
+			Signal<NodePtr, NodePtr, AbsCtrlPtr>::Slot	_componentRemovedSlot;
+			Signal<RendererPtr>::Slot					_renderingBeginSlot;
+
+		public:
+			inline static
+			Ptr
+			create(ContextPtr	context,
+				   uint			maxLights				= 256,
+				   uint			maxLightsPerCluster		= 64)
+			{
+				auto lighting = std::shared_ptr<ClusteredLighting>(new ClusteredLighting(
+					context,
+					maxLights,
+					maxLightsPerCluster
+				));
+
+				lighting->initialize();
+
+				return lighting;
+			}
+
+			inline
+			uint
+			maxLights() const
+			{
+				return _maxLights;
+			}
+
+			/**
+			 * Number of threads used to bin the lights, defaults to the number of hardware threads.
+			 */
+			inline
+			uint
+			numJobs() const
+			{
+				return _numJobs;
+			}
+
+			inline
+			void
+			numJobs(uint value)
+			{
+				_numJobs = value;
+			}
+
+			inline
+			std::shared_ptr<render::LightClusters>
+			clusters() const
+			{
+				return _clusters;
+			}
+
+			inline
+			uint
+			numLights() const
+			{
+				return _lights.size();
+			}
+
+			/**
+			 * Total number of (cluster, light) pairs uploaded for the last frame.
+			 */
+			inline
+			uint
+			numLightIndices() const
+			{
+				return _numLightIndices;
+			}
+
+		private:
+			ClusteredLighting(ContextPtr context, uint maxLights, uint maxLightsPerCluster);
+
+			void
+			initialize();
+
+			void
+			targetAddedHandler(AbsCtrlPtr ctrl, NodePtr target);
+
+			void
+			targetRemovedHandler(AbsCtrlPtr ctrl, NodePtr target);
+
+			void
+			addedOrRemovedHandler(NodePtr node, NodePtr target, NodePtr parent);
+
+			void
+			rootDescendantAddedHandler(NodePtr node, NodePtr target, NodePtr parent);
+
+			void
+			rootDescendantRemovedHandler(NodePtr node, NodePtr target, NodePtr parent);
+
+			void
+			componentAddedHandler(NodePtr node, NodePtr target, AbsCtrlPtr ctrl);
+
+			void
+			componentRemovedHandler(NodePtr node, NodePtr target, AbsCtrlPtr ctrl);
+
+			void
+			renderingBeginHandler(RendererPtr renderer);
+
+			void
+			setRoot(NodePtr root);
+
+			void
+			addLight(AbsCtrlPtr ctrl);
+
+			void
+			removeLight(AbsCtrlPtr ctrl);
+
+			void
+			updateLightsTexture();
+
+			void
+			updateClustersTextures();
+		};
+	}
+}
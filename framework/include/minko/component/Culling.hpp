@@ -48,9 +48,13 @@ namespace minko
 			Signal<NodePtr, NodePtr, NodePtr>::Slot								_addedToSceneSlot;
 			Signal<NodePtr, NodePtr>::Slot										_layoutChangedSlot;
 			Signal<std::shared_ptr<data::Container>, const std::string&>::Slot	_viewMatrixChangedSlot;
+			Signal<std::shared_ptr<SceneManager>>::Slot							_cullingBeginSlot;
 
 			std::string		_bindProperty;
 
+			// visible surfaces and their screen ratio, sent to the TextureStreamer every frame
+			std::vector<std::pair<std::weak_ptr<Surface>, float>>				_textureRequests;
+
 		public:
 			inline static
 			Ptr
@@ -86,6 +90,13 @@ namespace minko
 			void
 			targetAddedToScene(NodePtr node, NodePtr target, NodePtr ancestor);
 
+			void
+			cullingBeginHandler(std::shared_ptr<SceneManager> sceneManager);
+
+			static
+			float
+			screenRatio(std::shared_ptr<math::Box> box, std::shared_ptr<math::Matrix4x4> worldToScreen);
+
 			Culling(ShapePtr shape, std::string bindProperty);
 		};
 	}
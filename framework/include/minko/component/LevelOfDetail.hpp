@@ -0,0 +1,206 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/Signal.hpp"
+#include "minko/component/AbstractComponent.hpp"
+
+namespace minko
+{
+	namespace component
+	{
+		/**
+		 * Switches the surfaces of a node between several geometries depending on their size on screen.
+		 *
+		 * Each surface added with addLevels() gets one extra Surface per simplified geometry (sharing
+		 * its material, effect and technique). Each frame, once the transforms are up to date and
+		 * before the renderers draw, the world-space BoundingBox of the target is projected for every
+		 * camera (a node with a PerspectiveCamera and a Renderer) of the scene and the level whose
+		 * screen size range contains it is selected. Only the surface of that level is made visible
+		 * for the camera's Renderer (see Surface::visible()), so two cameras can draw two different
+		 * levels of the same node.
+		 *
+		 * The screen size is the diameter of the bounding sphere divided by the height of the view
+		 * frustum at its distance: 1 when the node fills the viewport vertically. A level is only left
+		 * once the screen size crosses its threshold by more than hysteresis() (relative), to avoid
+		 * popping back and forth around a threshold.
+		 *
+		 * The target must have a BoundingBox: until then, level 0 is drawn.
+		 */
+		class LevelOfDetail :
+			public AbstractComponent,
+			public std::enable_shared_from_this<LevelOfDetail>
+		{
+		public:
+			typedef std::shared_ptr<LevelOfDetail>	Ptr;
+
+		private:
+			typedef std::shared_ptr<AbstractComponent>			AbsCtrlPtr;
+			typedef std::shared_ptr<scene::Node>				NodePtr;
+			typedef std::shared_ptr<Surface>					SurfacePtr;
+			typedef std::shared_ptr<Renderer>					RendererPtr;
+			typedef std::shared_ptr<geometry::Geometry>			GeometryPtr;
+			typedef std::shared_ptr<SceneManager>				SceneManagerPtr;
+			typedef std::shared_ptr<render::AbstractTexture>	AbsTexturePtr;
+
+		private:
+			static const float										DEFAULT_SCREEN_SIZE;
+
+			std::vector<std::vector<SurfacePtr>>					_surfaces;
+			std::vector<float>										_screenSizes;
+			float													_hysteresis;
+
+			NodePtr													_root;
+			std::set<NodePtr>										_cameras;
+			std::unordered_map<RendererPtr, uint>					_rendererToLevel;
+
+			Signal<AbsCtrlPtr, NodePtr>::Slot						_targetAddedSlot;
+			Signal<AbsCtrlPtr, NodePtr>::Slot						_targetRemovedSlot;
+			Signal<NodePtr, NodePtr, NodePtr>::Slot					_addedSlot;
+			Signal<NodePtr, NodePtr, NodePtr>::Slot					_removedSlot;
+			Signal<NodePtr, NodePtr, NodePtr>::Slot					_rootDescendantAddedSlot;
+			Signal<NodePtr, NodePtr, NodePtr>::Slot					_rootDescendantRemovedSlot;
+			Signal<NodePtr, NodePtr, AbsCtrlPtr>::Slot				_componentAddedSlot;
+			Signal<NodePtr, NodePtr, AbsCtrlPtr>::Slot				_componentRemovedSlot;
+			Signal<SceneManagerPtr, uint, AbsTexturePtr>::Slot		_renderingBeginSlot;
+
+		public:
+			inline static
+			Ptr
+			create(float hysteresis = .1f)
+			{
+				auto lod = std::shared_ptr<LevelOfDetail>(new LevelOfDetail(hysteresis));
+
+				lod->initialize();
+
+				return lod;
+			}
+
+			/**
+			 * Registers the simplified geometries of a surface of the target, from the finest to the
+			 * coarsest: geometries[0] is level 1, the surface itself being level 0.
+			 */
+			void
+			addLevels(SurfacePtr surface, const std::vector<GeometryPtr>& geometries);
+
+			void
+			removeLevels(SurfacePtr surface);
+
+			/**
+			 * Number of levels, including level 0, of the surface with the most levels.
+			 */
+			uint
+			numLevels() const;
+
+			/**
+			 * Surface drawn for the given level: the last one available when the surface has fewer levels.
+			 */
+			SurfacePtr
+			surface(SurfacePtr surface, uint level) const;
+
+			/**
+			 * Screen size below which the given level (> 0) is used.
+			 * Defaults to 0.25 for level 1 and is halved for each following level.
+			 */
+			float
+			screenSize(uint level) const;
+
+			/**
+			 * Sets the screen size thresholds of the levels 1, 2... in decreasing order.
+			 */
+			void
+			screenSizes(const std::vector<float>& value);
+
+			inline
+			float
+			hysteresis() const
+			{
+				return _hysteresis;
+			}
+
+			inline
+			void
+			hysteresis(float value)
+			{
+				_hysteresis = value;
+			}
+
+			/**
+			 * Level currently drawn by the given renderer.
+			 */
+			uint
+			level(RendererPtr renderer) const;
+
+			/**
+			 * Level to draw at the given screen size when currentLevel was drawn so far.
+			 */
+			uint
+			selectLevel(uint currentLevel, float screenSize) const;
+
+		private:
+			LevelOfDetail(float hysteresis);
+
+			void
+			initialize();
+
+			void
+			targetAddedHandler(AbsCtrlPtr ctrl, NodePtr target);
+
+			void
+			targetRemovedHandler(AbsCtrlPtr ctrl, NodePtr target);
+
+			void
+			addedOrRemovedHandler(NodePtr node, NodePtr target, NodePtr parent);
+
+			void
+			setRoot(NodePtr root);
+
+			void
+			rootDescendantAddedHandler(NodePtr node, NodePtr target, NodePtr parent);
+
+			void
+			rootDescendantRemovedHandler(NodePtr node, NodePtr target, NodePtr parent);
+
+			void
+			componentAddedHandler(NodePtr node, NodePtr target, AbsCtrlPtr ctrl);
+
+			void
+			componentRemovedHandler(NodePtr node, NodePtr target, AbsCtrlPtr ctrl);
+
+			void
+			setSceneManager(SceneManagerPtr sceneManager);
+
+			void
+			renderingBeginHandler(SceneManagerPtr sceneManager, uint frameId, AbsTexturePtr renderTarget);
+
+			float
+			computeScreenSize(NodePtr camera) const;
+
+			void
+			applyLevel(RendererPtr renderer, uint level);
+
+			void
+			resetLevels(RendererPtr renderer);
+		};
+	}
+}
@@ -0,0 +1,188 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/Signal.hpp"
+#include "minko/component/AbstractScript.hpp"
+
+namespace minko
+{
+	namespace component
+	{
+		/**
+		 * Binds to each surface only the point and spot lights that can reach it.
+		 *
+		 * Every frame, once the transforms are up to date and before the renderers draw (see
+		 * SceneManager::renderingBegin()), the influence sphere of each light (see AbstractDiscreteLight::influenceRadius())
+		 * is intersected with the world-space box of each node holding a Surface (see BoundingBox,
+		 * nodes without one are treated as a point at their origin). The maxLightsPerSurface() lights
+		 * with the strongest attenuated contribution at the box are stored in a "surfaceLights"
+		 * provider added to the node, which the Phong effect reads through fixed-size uniform arrays
+		 * (SURFACE_LIGHTS macro): shaders only depend on maxLightsPerSurface(), not on the number of
+		 * lights in the scene.
+		 *
+		 * The managed lights are disabled (see AbstractRootDataComponent::enabled()) so that they leave
+		 * the "pointLights" and "spotLights" arrays of the root. The culling must be added to the root
+		 * of the scene and cannot be combined with ClusteredLighting.
+		 */
+		class LightCulling :
+			public AbstractScript
+		{
+		public:
+			typedef std::shared_ptr<LightCulling>	Ptr;
+
+		private:
+			typedef std::shared_ptr<scene::Node>				NodePtr;
+			typedef std::shared_ptr<AbstractComponent>			AbsCtrlPtr;
+			typedef std::shared_ptr<AbstractDiscreteLight>		LightPtr;
+			typedef std::shared_ptr<SceneManager>				SceneManagerPtr;
+			typedef std::shared_ptr<render::AbstractTexture>	AbsTexturePtr;
+
+			struct SurfaceLights
+			{
+				std::shared_ptr<data::StructureProvider>	provider;
+				std::vector<float>							positions;		// xyz, influence radius
+				std::vector<float>							colors;			// rgb, diffuse
+				std::vector<float>							attenuations;	// coefficients, specular
+				std::vector<float>							directions;
+				std::vector<float>							cones;			// cos. of the inner and outer angles
+				int											numLights;
+			};
+
+		public:
+			static const uint							MAX_LIGHTS_PER_SURFACE;
+
+		private:
+			const uint									_maxLightsPerSurface;
+
+			NodePtr										_root;
+			std::vector<LightPtr>						_lights;
+			std::unordered_map<NodePtr, SurfaceLights>	_surfaceNodes;
+
+			std::vector<float>							_spheres;		// xyz, influence radius
+			std::vector<std::pair<float, uint>>			_candidates;
+			uint										_numBoundLights;
+
+			Signal<NodePtr, NodePtr, NodePtr>::Slot		_rootDescendantAddedSlot;
+			Signal<NodePtr, NodePtr, NodePtr>::Slot		_rootDescendantRemovedSlot;
+			Signal<NodePtr, NodePtr, AbsCtrlPtr>::Slot	_rootComponentAddedSlot;
+			Signal<NodePtr, NodePtr, AbsCtrlPtr>::Slot	_rootComponentRemovedSlot;
+			Signal<SceneManagerPtr, uint, AbsTexturePtr>::Slot	_renderingBeginSlot;
+
+		public:
+			inline static
+			Ptr
+			create(uint maxLightsPerSurface = 8)
+			{
+				if (maxLightsPerSurface == 0 || maxLightsPerSurface > MAX_LIGHTS_PER_SURFACE)
+					throw std::invalid_argument("maxLightsPerSurface");
+
+				Ptr culling = std::shared_ptr<LightCulling>(new LightCulling(maxLightsPerSurface));
+
+				culling->initialize();
+
+				return culling;
+			}
+
+			inline
+			uint
+			maxLightsPerSurface() const
+			{
+				return _maxLightsPerSurface;
+			}
+
+			inline
+			uint
+			numLights() const
+			{
+				return _lights.size();
+			}
+
+			inline
+			uint
+			numSurfaceNodes() const
+			{
+				return _surfaceNodes.size();
+			}
+
+			/**
+			 * Number of lights bound to the node's surfaces during the last update.
+			 */
+			uint
+			numLights(NodePtr surfaceNode) const;
+
+			/**
+			 * Total number of (surface node, light) pairs bound during the last update.
+			 */
+			inline
+			uint
+			numBoundLights() const
+			{
+				return _numBoundLights;
+			}
+
+		protected:
+			void
+			start(NodePtr target);
+
+			void
+			stop(NodePtr target);
+
+			void
+			targetRemovedHandler(AbsCtrlPtr ctrl, NodePtr target);
+
+		private:
+			LightCulling(uint maxLightsPerSurface);
+
+			void
+			rootDescendantAddedHandler(NodePtr node, NodePtr target, NodePtr parent);
+
+			void
+			rootDescendantRemovedHandler(NodePtr node, NodePtr target, NodePtr parent);
+
+			void
+			rootComponentAddedHandler(NodePtr node, NodePtr target, AbsCtrlPtr ctrl);
+
+			void
+			rootComponentRemovedHandler(NodePtr node, NodePtr target, AbsCtrlPtr ctrl);
+
+			void
+			renderingBeginHandler(SceneManagerPtr sceneManager, uint frameId, AbsTexturePtr renderTarget);
+
+			void
+			addLight(LightPtr light);
+
+			void
+			removeLight(LightPtr light);
+
+			void
+			addSurfaceNode(NodePtr node);
+
+			void
+			removeSurfaceNode(NodePtr node);
+
+			void
+			updateSurfaceNode(NodePtr node, SurfaceLights& surfaceLights);
+		};
+	}
+}
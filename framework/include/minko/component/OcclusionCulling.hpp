@@ -0,0 +1,227 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/Signal.hpp"
+#include "minko/component/AbstractComponent.hpp"
+
+namespace minko
+{
+	namespace component
+	{
+		/**
+		 * Hides the surfaces that are outside the camera frustum or behind designated occluders.
+		 *
+		 * Each frame, once the transforms are up to date and before the renderers draw (see
+		 * SceneManager::renderingBegin()), the triangles of the occluder nodes (see addOccluder())
+		 * are rasterized on the CPU into a low-resolution depth hierarchy (see
+		 * render::OcclusionBuffer). The world-space box of every node holding a Surface and a
+		 * BoundingBox is then projected and tested against it, and the result is written into
+		 * Surface::computedVisibility() for the camera's Renderer. No GPU query is involved.
+		 *
+		 * The component must be added to a camera node (with a PerspectiveCamera and a Renderer).
+		 * It performs its own frustum test and must not be combined with Culling on the same camera.
+		 */
+		class OcclusionCulling :
+			public AbstractComponent,
+			public std::enable_shared_from_this<OcclusionCulling>
+		{
+		public:
+			typedef std::shared_ptr<OcclusionCulling>	Ptr;
+
+		private:
+			typedef std::shared_ptr<AbstractComponent>			AbsCtrlPtr;
+			typedef std::shared_ptr<scene::Node>				NodePtr;
+			typedef std::shared_ptr<SceneManager>				SceneManagerPtr;
+			typedef std::shared_ptr<render::AbstractTexture>	AbsTexturePtr;
+
+		private:
+			std::shared_ptr<render::OcclusionBuffer>				_buffer;
+			uint													_numJobs;
+
+			NodePtr													_root;
+			std::set<NodePtr>										_occluders;
+			std::set<NodePtr>										_surfaceNodes;
+			std::shared_ptr<math::Matrix4x4>						_modelToScreen;
+
+			uint													_numTestedSurfaceNodes;
+			uint													_numFrustumCulled;
+			uint													_numOccluded;
+			float													_cpuTime;
+
+			Signal<AbsCtrlPtr, NodePtr>::Slot						_targetAddedSlot;
+			Signal<AbsCtrlPtr, NodePtr>::Slot						_targetRemovedSlot;
+			Signal<NodePtr, NodePtr, NodePtr>::Slot					_addedSlot;
+			Signal<NodePtr, NodePtr, NodePtr>::Slot					_removedSlot;
+			Signal<NodePtr, NodePtr, NodePtr>::Slot					_rootDescendantAddedSlot;
+			Signal<NodePtr, NodePtr, NodePtr>::Slot					_rootDescendantRemovedSlot;
+			Signal<NodePtr, NodePtr, AbsCtrlPtr>::Slot				_componentAddedSlot;
+			Signal<NodePtr, NodePtr, AbsCtrlPtr>::Slot				_componentRemovedSlot;
+			Signal<SceneManagerPtr, uint, AbsTexturePtr>::Slot		_renderingBeginSlot;
+
+		public:
+			inline static
+			Ptr
+			create(uint width = 256, uint height = 128)
+			{
+				auto culling = std::shared_ptr<OcclusionCulling>(new OcclusionCulling(width, height));
+
+				culling->initialize();
+
+				return culling;
+			}
+
+			inline
+			std::shared_ptr<render::OcclusionBuffer>
+			buffer() const
+			{
+				return _buffer;
+			}
+
+			/**
+			 * Number of threads used to rasterize the occluders, defaults to the number of hardware threads.
+			 */
+			inline
+			uint
+			numJobs() const
+			{
+				return _numJobs;
+			}
+
+			inline
+			void
+			numJobs(uint value)
+			{
+				_numJobs = value;
+			}
+
+			/**
+			 * Rasterizes the surfaces of the node (and not of its descendants) into the depth hierarchy.
+			 * Occluders should be large, simple and opaque: walls, buildings, terrain. They are only
+			 * frustum tested themselves.
+			 */
+			void
+			addOccluder(NodePtr node);
+
+			void
+			removeOccluder(NodePtr node);
+
+			inline
+			uint
+			numOccluders() const
+			{
+				return _occluders.size();
+			}
+
+			/**
+			 * Number of surface nodes tested during the last frame.
+			 */
+			inline
+			uint
+			numTestedSurfaceNodes() const
+			{
+				return _numTestedSurfaceNodes;
+			}
+
+			inline
+			uint
+			numFrustumCulled() const
+			{
+				return _numFrustumCulled;
+			}
+
+			inline
+			uint
+			numOccluded() const
+			{
+				return _numOccluded;
+			}
+
+			/**
+			 * Ratio of the tested surface nodes hidden by the occluders during the last frame.
+			 */
+			inline
+			float
+			occludedRatio() const
+			{
+				return _numTestedSurfaceNodes == 0 ? 0.f : (float)_numOccluded / (float)_numTestedSurfaceNodes;
+			}
+
+			/**
+			 * Time spent rasterizing and testing during the last frame, in milliseconds.
+			 */
+			inline
+			float
+			cpuTime() const
+			{
+				return _cpuTime;
+			}
+
+		private:
+			OcclusionCulling(uint width, uint height);
+
+			void
+			initialize();
+
+			void
+			targetAddedHandler(AbsCtrlPtr ctrl, NodePtr target);
+
+			void
+			targetRemovedHandler(AbsCtrlPtr ctrl, NodePtr target);
+
+			void
+			addedOrRemovedHandler(NodePtr node, NodePtr target, NodePtr parent);
+
+			void
+			setRoot(NodePtr root);
+
+			void
+			rootDescendantAddedHandler(NodePtr node, NodePtr target, NodePtr parent);
+
+			void
+			rootDescendantRemovedHandler(NodePtr node, NodePtr target, NodePtr parent);
+
+			void
+			componentAddedHandler(NodePtr node, NodePtr target, AbsCtrlPtr ctrl);
+
+			void
+			componentRemovedHandler(NodePtr node, NodePtr target, AbsCtrlPtr ctrl);
+
+			void
+			setSceneManager(SceneManagerPtr sceneManager);
+
+			void
+			renderingBeginHandler(SceneManagerPtr sceneManager, uint frameId, AbsTexturePtr renderTarget);
+
+			void
+			rasterizeOccluders(std::shared_ptr<math::Matrix4x4> worldToScreen);
+
+			bool
+			visible(NodePtr								surfaceNode,
+					std::shared_ptr<math::Matrix4x4>	worldToScreen,
+					bool								testOcclusion,
+					bool&								occluded);
+		};
+	}
+}
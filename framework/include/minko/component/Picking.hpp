@@ -46,9 +46,19 @@ namespace minko
 			typedef std::shared_ptr<data::ArrayProvider>		ArrayProviderPtr;
 			typedef std::shared_ptr<data::StructureProvider>	StructureProviderPtr;
 			typedef std::shared_ptr<AbstractCanvas>				AbstractCanvasPtr;
+			typedef Signal<Ptr, const std::vector<SurfacePtr>&>	AreaPickedSignal;
+
+		private:
+			struct Query
+			{
+				int		x;
+				int		y;
+				uint	width;
+				uint	height;
+				bool	area;
+			};
 
 		private:
-			TexturePtr									_renderTarget;
 			RendererPtr									_renderer;
 			SceneManagerPtr								_sceneManager;
 			MousePtr									_mouse;
@@ -65,7 +75,7 @@ namespace minko
 			Signal<AbsCtrlPtr, NodePtr>::Slot			_targetRemovedSlot;
 			Signal<NodePtr, NodePtr, NodePtr>::Slot		_addedSlot;
 			Signal<NodePtr, NodePtr, NodePtr>::Slot		_removedSlot;
-			Signal<RendererPtr>::Slot					_renderingBeginSlot;
+			Signal<SceneManagerPtr, float, float>::Slot	_frameBeginSlot;
 			Signal<RendererPtr>::Slot					_renderingEndSlot;
 			Signal<NodePtr, NodePtr, AbsCtrlPtr>::Slot	_componentAddedSlot;
 			Signal<NodePtr, NodePtr, AbsCtrlPtr>::Slot	_componentRemovedSlot;
@@ -75,8 +85,16 @@ namespace minko
 			Signal<NodePtr>::Ptr						_mouseLeftClick;
 			Signal<NodePtr>::Ptr						_mouseOut;
 			Signal<NodePtr>::Ptr						_mouseMove;
-
-			unsigned char								_lastColor[4];
+			AreaPickedSignal::Ptr						_areaPicked;
+
+			bool										_continuous;
+			std::list<Query>							_queries;
+			Query										_renderedQuery;
+			std::list<std::pair<Query, uint>>			_readRequests;
+			std::vector<unsigned char>					_pixels;
+			std::set<SurfacePtr>						_candidates;
+			std::shared_ptr<math::Frustum>				_frustum;
+			MatrixPtr									_worldToRegion;
 			SurfacePtr									_lastPickedSurface;
 
 			Signal<MousePtr, int, int>::Slot			_mouseMoveSlot;
@@ -130,6 +148,13 @@ namespace minko
 				return _mouseMove;
 			}
 
+			inline
+			AreaPickedSignal::Ptr
+			areaPicked()
+			{
+				return _areaPicked;
+			}
+
 			inline
 			SurfacePtr
 			pickedSurface()
@@ -137,6 +162,33 @@ namespace minko
 				return _lastPickedSurface;
 			}
 
+			/*
+			** When false (default), the picking pass only runs when a query is pending: the
+			** mouse moved or pickArea() was called. When true, the surface under the cursor is
+			** re-evaluated every frame, e.g. to follow animated objects under a still cursor.
+			*/
+			inline
+			bool
+			continuous() const
+			{
+				return _continuous;
+			}
+
+			inline
+			void
+			continuous(bool value)
+			{
+				_continuous = value;
+			}
+
+			/*
+			** Queues the rendering of a rectangle of the viewport (in pixels, from the top left
+			** corner). The surfaces it contains are sent through areaPicked() once the pixels are
+			** read back, one frame later.
+			*/
+			void
+			pickArea(int x, int y, uint width, uint height);
+
 		private:
 
 			void
@@ -167,11 +219,20 @@ namespace minko
 			removeSurface(SurfacePtr surface);
 
 			void
-			renderingBegin(RendererPtr renderer);
+			frameBeginHandler(SceneManagerPtr sceneManager, float time, float deltaTime);
 
 			void
 			renderingEnd(RendererPtr renderer);
 
+			void
+			queuePointQuery();
+
+			void
+			prepareQuery(const Query& query);
+
+			void
+			readQueryResult(const Query& query, uint request);
+
 			Picking(SceneManagerPtr sceneManager, AbstractCanvasPtr canvas, NodePtr camera);
 
 			void
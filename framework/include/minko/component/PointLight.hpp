@@ -75,6 +75,16 @@ namespace minko
 			Ptr
 			attenuationCoefficients(std::shared_ptr<math::Vector3>);
 
+			float
+			influenceRadius() const;
+
+			inline
+			std::shared_ptr<math::Vector3>
+			worldPosition() const
+			{
+				return _worldPosition;
+			}
+
 		protected:
 			void
             updateModelToWorldMatrix(std::shared_ptr<math::Matrix4x4> modelToWorld);
@@ -45,6 +45,7 @@ namespace minko
 			typedef std::shared_ptr<render::Effect>						EffectPtr;
 			typedef std::shared_ptr<render::DrawCallPool>				DrawCallFactoryPtr;
 			typedef Signal<SurfacePtr, const std::string&, bool>::Slot	SurfaceTechniqueChangedSlot;
+			typedef std::function<bool(SurfacePtr)>						SurfaceFilter;
 
 		private:
 			DrawCallList												_drawCalls;
@@ -60,6 +61,15 @@ namespace minko
 			std::set<std::shared_ptr<Surface>>							_toCollect;
 			EffectPtr													_effect;
 			float														_priority;
+			bool														_enabled;
+			SurfaceFilter												_surfaceFilter;
+			bool														_depthPrePass;
+			std::shared_ptr<render::Program>							_depthProgram;
+			std::vector<DrawCallPtr>									_visibleDrawCalls;
+			std::unordered_set<DrawCallPtr>								_filteredDrawCalls;
+			std::vector<std::pair<float, DrawCallPtr>>					_depthSortedDrawCalls;
+			std::vector<std::pair<bool, DrawCallPtr>>					_mainPassDrawCalls;
+			std::shared_ptr<math::Vector3>								_eyePosition;
 
 
 			Signal<AbsCtrlPtr, NodePtr>::Slot							_targetAddedSlot;
@@ -122,6 +132,13 @@ namespace minko
 				return _drawCalls.size();
 			}
 
+			inline
+			const DrawCallList&
+			drawCalls() const
+			{
+				return _drawCalls;
+			}
+
 			inline
 			unsigned int
 			backgroundColor()
@@ -154,6 +171,52 @@ namespace minko
 			render(std::shared_ptr<render::AbstractContext> context,
 				   AbsTexturePtr 		renderTarget = nullptr);
 
+			inline
+			bool
+			enabled() const
+			{
+				return _enabled;
+			}
+
+			inline
+			void
+			enabled(bool value)
+			{
+				_enabled = value;
+			}
+
+			/*
+			** When set, only the draw calls of the surfaces accepted by the filter are rendered, in the
+			** usual sorted order.
+			** Draw calls are still collected for every surface, so changing the filter is cheap.
+			*/
+			inline
+			void
+			surfaceFilter(SurfaceFilter filter)
+			{
+				_surfaceFilter = filter;
+			}
+
+			inline
+			bool
+			depthPrePass() const
+			{
+				return _depthPrePass;
+			}
+
+			/*
+			** When enabled, the depth of the opaque draw calls (see DrawCall::depthPrePassCompatible())
+			** is first written front-to-back with a depth-only program and color writes disabled. The
+			** main pass then only shades the visible fragments (CompareMode::EQUAL) and draws the opaque
+			** draw calls grouped by program and textures to minimize state changes.
+			*/
+			inline
+			void
+			depthPrePass(bool value)
+			{
+				_depthPrePass = value;
+			}
+
 			inline
 			Signal<Ptr>::Ptr
 			renderingBegin()
@@ -224,6 +287,12 @@ namespace minko
 											  uint							frameId,
 											  AbsTexturePtr					renderTarget);
 
+			void
+			collectVisibleDrawCalls();
+
+			void
+			renderWithDepthPrePass(std::shared_ptr<render::AbstractContext> context, AbsTexturePtr renderTarget);
+
 			void
 			findSceneManager();
 
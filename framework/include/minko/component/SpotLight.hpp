@@ -98,6 +98,23 @@ namespace minko
 			Ptr
 			attenuationCoefficients(std::shared_ptr<math::Vector3>);
 
+			float
+			influenceRadius() const;
+
+			inline
+			std::shared_ptr<math::Vector3>
+			worldPosition() const
+			{
+				return _worldPosition;
+			}
+
+			inline
+			std::shared_ptr<math::Vector3>
+			worldDirection() const
+			{
+				return _worldDirection;
+			}
+
 		protected:
 			void
             updateModelToWorldMatrix(std::shared_ptr<math::Matrix4x4> modelToWorld);
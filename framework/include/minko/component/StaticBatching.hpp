@@ -0,0 +1,196 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/Signal.hpp"
+#include "minko/component/AbstractComponent.hpp"
+
+namespace minko
+{
+	namespace component
+	{
+		/**
+		 * Merges the static surfaces of a sub-tree into a few large pre-transformed geometries.
+		 *
+		 * batch() groups the surfaces of the target and of its descendants by material, effect,
+		 * technique, vertex layout and spatial cell (see cellSize()), bakes their transforms (relative
+		 * to the target) into copies of their vertices and adds one child node per group to the
+		 * target, holding an identity Transform, a single Surface and a BoundingBox: the batches
+		 * follow the world transform of the target. The original surfaces are removed from
+		 * their nodes, which stay in the scene: subRanges() and node() map the triangles of a merged
+		 * surface back to them, for picking or editing. unbatch() restores the original surfaces.
+		 *
+		 * Only the nodes that never move should be in the sub-tree, and their geometries must still
+		 * have their vertex and index data on the CPU. A group is split whenever it exceeds the 65536
+		 * vertices addressable by 16 bit indices.
+		 *
+		 * batch() can be called right after loading, or before a scene is written by the serializer
+		 * when given the AssetLibrary to register the merged geometries in.
+		 */
+		class StaticBatching :
+			public AbstractComponent,
+			public std::enable_shared_from_this<StaticBatching>
+		{
+		public:
+			typedef std::shared_ptr<StaticBatching>	Ptr;
+
+			struct SubRange
+			{
+				std::shared_ptr<scene::Node>	node;
+				std::shared_ptr<Surface>		surface;
+				uint							firstIndex;
+				uint							numIndices;
+			};
+
+		private:
+			typedef std::shared_ptr<AbstractComponent>			AbsCtrlPtr;
+			typedef std::shared_ptr<scene::Node>				NodePtr;
+			typedef std::shared_ptr<Surface>					SurfacePtr;
+			typedef std::shared_ptr<file::AssetLibrary>			AssetLibraryPtr;
+
+			struct Chunk;
+
+		private:
+			static const uint										MAX_NUM_VERTICES;
+
+			float													_cellSize;
+
+			std::vector<NodePtr>									_batchNodes;
+			std::unordered_map<SurfacePtr, std::vector<SubRange>>	_subRanges;
+			std::vector<std::pair<NodePtr, SurfacePtr>>				_removedSurfaces;
+
+			uint													_numSourceSurfaces;
+			float													_batchingTime;
+
+			Signal<AbsCtrlPtr, NodePtr>::Slot						_targetAddedSlot;
+			Signal<AbsCtrlPtr, NodePtr>::Slot						_targetRemovedSlot;
+
+		public:
+			inline static
+			Ptr
+			create(float cellSize = 0.f)
+			{
+				auto batching = std::shared_ptr<StaticBatching>(new StaticBatching(cellSize));
+
+				batching->initialize();
+
+				return batching;
+			}
+
+			/**
+			 * Size of the cubic cells surfaces are grouped by, so that each merged surface remains
+			 * small enough to be culled. 0 merges a whole group regardless of where its surfaces are.
+			 */
+			inline
+			float
+			cellSize() const
+			{
+				return _cellSize;
+			}
+
+			inline
+			void
+			cellSize(float value)
+			{
+				_cellSize = value;
+			}
+
+			void
+			batch(AssetLibraryPtr assets = nullptr);
+
+			void
+			unbatch();
+
+			inline
+			const std::vector<NodePtr>&
+			batchNodes() const
+			{
+				return _batchNodes;
+			}
+
+			/**
+			 * Index ranges of a merged surface, one per original surface, in increasing order.
+			 */
+			const std::vector<SubRange>&
+			subRanges(SurfacePtr batchSurface) const;
+
+			/**
+			 * Original node of the given triangle of a merged surface.
+			 */
+			NodePtr
+			node(SurfacePtr batchSurface, uint triangle) const;
+
+			/**
+			 * Number of surfaces, hence of draw calls, merged by the last call to batch().
+			 */
+			inline
+			uint
+			numSourceSurfaces() const
+			{
+				return _numSourceSurfaces;
+			}
+
+			inline
+			uint
+			numBatches() const
+			{
+				return _batchNodes.size();
+			}
+
+			/**
+			 * Draw calls no longer submitted each frame, along with their state and uniform changes.
+			 */
+			inline
+			uint
+			numSavedDrawCalls() const
+			{
+				return _numSourceSurfaces - numBatches();
+			}
+
+			/**
+			 * Time spent by the last call to batch(), in milliseconds.
+			 */
+			inline
+			float
+			batchingTime() const
+			{
+				return _batchingTime;
+			}
+
+		private:
+			StaticBatching(float cellSize);
+
+			void
+			initialize();
+
+			void
+			targetAddedHandler(AbsCtrlPtr ctrl, NodePtr target);
+
+			void
+			targetRemovedHandler(AbsCtrlPtr ctrl, NodePtr target);
+
+			void
+			flush(Chunk& chunk, AssetLibraryPtr assets);
+		};
+	}
+}
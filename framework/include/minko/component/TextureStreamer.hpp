@@ -0,0 +1,229 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/component/AbstractScript.hpp"
+
+namespace minko
+{
+	namespace component
+	{
+		/**
+		 * Keeps the mip levels of streamed textures (see render::Texture::streamed()) resident
+		 * within a GPU memory budget.
+		 *
+		 * Each texture has a required mip level, set from screen-space size estimates by Culling
+		 * (or manually with request()). Every frame, the textures that are coarser than required
+		 * get one finer level uploaded, worst first and at most maxUploadsPerFrame() of them. When
+		 * an upload does not fit in the budget, levels finer than required are evicted from other
+		 * textures to make room. If nothing can be evicted, the upload waits.
+		 *
+		 * Textures are tracked until they are destroyed or remove()d, the streamer does not keep
+		 * them alive. Once a texture reached its required level, its CPU data is released when
+		 * it has a data source (see render::Texture::dataSource()).
+		 *
+		 * The streamer must be added to the root of the scene.
+		 */
+		class TextureStreamer :
+			public AbstractScript
+		{
+		public:
+			typedef std::shared_ptr<TextureStreamer>	Ptr;
+
+		private:
+			typedef std::shared_ptr<scene::Node>		NodePtr;
+			typedef std::shared_ptr<render::Texture>	TexturePtr;
+			typedef std::shared_ptr<Surface>			SurfacePtr;
+
+			struct Entry
+			{
+				std::weak_ptr<render::Texture>	texture;
+				render::Texture*				key;
+				uint							requiredMipLevel;
+				uint							requestId;
+			};
+
+		private:
+			uint								_budget;
+			uint								_maxUploadsPerFrame;
+			uint								_viewportSize;
+			float								_lodBias;
+
+			std::vector<Entry>							_entries;
+			std::unordered_map<render::Texture*, uint>	_textureToEntry;
+			std::vector<TexturePtr>						_textures;
+			uint										_requestId;
+
+			uint								_residentMemory;
+			uint								_numUploads;
+			uint								_numEvictions;
+
+		public:
+			inline static
+			Ptr
+			create(uint budget)
+			{
+				Ptr streamer = std::shared_ptr<TextureStreamer>(new TextureStreamer(budget));
+
+				streamer->initialize();
+
+				return streamer;
+			}
+
+			/**
+			 * GPU memory budget for the streamed textures, in bytes.
+			 */
+			inline
+			uint
+			budget() const
+			{
+				return _budget;
+			}
+
+			inline
+			void
+			budget(uint value)
+			{
+				_budget = value;
+			}
+
+			inline
+			uint
+			maxUploadsPerFrame() const
+			{
+				return _maxUploadsPerFrame;
+			}
+
+			inline
+			void
+			maxUploadsPerFrame(uint value)
+			{
+				_maxUploadsPerFrame = value;
+			}
+
+			/**
+			 * Size in pixels of the largest viewport dimension, used to turn screen ratios into
+			 * mip levels. 0 (default) uses the size of the default canvas.
+			 */
+			inline
+			void
+			viewportSize(uint value)
+			{
+				_viewportSize = value;
+			}
+
+			/**
+			 * Added to every required mip level computed from a screen ratio. Positive values
+			 * favor memory, negative ones favor quality.
+			 */
+			inline
+			void
+			lodBias(float value)
+			{
+				_lodBias = value;
+			}
+
+			/**
+			 * Marks every texture as not required until the next requests. Requests only last one
+			 * frame anyway: each update() works with the requests made since the previous one, so
+			 * every Culling re-sends its own requests once per frame.
+			 */
+			void
+			clearRequests();
+
+			/**
+			 * Requests the streamed textures of a surface's material for a surface covering
+			 * screenRatio of the viewport (1 meaning the whole viewport).
+			 */
+			void
+			request(SurfacePtr surface, float screenRatio);
+
+			void
+			request(TexturePtr texture, uint mipLevel);
+
+			void
+			remove(TexturePtr texture);
+
+			// stats
+
+			inline
+			uint
+			numTextures() const
+			{
+				return _entries.size();
+			}
+
+			/**
+			 * GPU memory currently used by the streamed textures, in bytes.
+			 */
+			inline
+			uint
+			residentMemory() const
+			{
+				return _residentMemory;
+			}
+
+			/**
+			 * GPU memory needed to make every texture resident at its required level, in bytes.
+			 */
+			uint
+			requiredMemory() const;
+
+			/**
+			 * Number of textures still coarser than required.
+			 */
+			uint
+			numPendingTextures() const;
+
+			inline
+			uint
+			numUploads() const
+			{
+				return _numUploads;
+			}
+
+			inline
+			uint
+			numEvictions() const
+			{
+				return _numEvictions;
+			}
+
+		protected:
+			void
+			update(NodePtr target);
+
+		private:
+			TextureStreamer(uint budget);
+
+			uint
+			requiredMipLevel(TexturePtr texture, float screenRatio) const;
+
+			void
+			removeEntry(uint index);
+
+			bool
+			makeRoom(uint size, uint exclude);
+		};
+	}
+}
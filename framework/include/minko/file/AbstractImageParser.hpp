@@ -0,0 +1,86 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/Any.hpp"
+#include "minko/file/AbstractParser.hpp"
+
+namespace minko
+{
+	namespace file
+	{
+		/**
+		 * Creates textures from image files decoded to RGBA by the decode function of the actual
+		 * parser. When Options::loadAsynchronously() is set and a canvas is available, the file is
+		 * decoded and resized to the GPU dimensions by an async::ImageDecoderWorker and only the
+		 * upload happens on the rendering thread: decoding failures are then reported by error().
+		 */
+		class AbstractImageParser :
+			public AbstractParser
+		{
+		public:
+			typedef std::shared_ptr<AbstractImageParser> Ptr;
+			typedef std::function<bool(const unsigned char*, std::size_t, uint&, uint&, std::vector<unsigned char>&)>
+				DecodeFunction;
+
+		private:
+			typedef std::shared_ptr<std::vector<unsigned char>> SourcePtr;
+
+		private:
+			std::string		_format;
+			DecodeFunction	_decode;
+			std::list<Any>	_workerSlots;
+
+		public:
+			void
+			parse(const std::string&				filename,
+				  const std::string&                resolvedFilename,
+				  std::shared_ptr<Options>          options,
+				  const std::vector<unsigned char>&	data,
+				  std::shared_ptr<AssetLibrary>		assetLibrary);
+
+		protected:
+			/**
+			 * The decode function must be thread-safe and take its RGBA buffer from the
+			 * PixelBufferPool.
+			 */
+			AbstractImageParser(const std::string& format, DecodeFunction decode);
+
+		private:
+			void
+			parseAsynchronously(const std::string&					filename,
+								std::shared_ptr<Options>			options,
+								const std::vector<unsigned char>&	data,
+								std::shared_ptr<AssetLibrary>		assetLibrary);
+
+			void
+			createTexture(const std::string&				filename,
+						  std::shared_ptr<Options>			options,
+						  uint								width,
+						  uint								height,
+						  std::vector<unsigned char>		rgba,
+						  SourcePtr							source,
+						  std::shared_ptr<AssetLibrary>		assetLibrary);
+		};
+	}
+}
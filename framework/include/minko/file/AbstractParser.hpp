@@ -32,7 +32,8 @@ namespace minko
 		public:
 			typedef std::shared_ptr<AbstractParser>				Ptr;
 
-			std::shared_ptr<Signal<Ptr>>	_complete;
+			std::shared_ptr<Signal<Ptr>>						_complete;
+			std::shared_ptr<Signal<Ptr, const ParserError&>>	_error;
 
 		public:
 			inline
@@ -42,6 +43,17 @@ namespace minko
 				return _complete;
 			}
 
+			/**
+			 * Executed instead of complete() when a file parsed asynchronously turns out to be
+			 * invalid. Synchronous failures throw a ParserError instead.
+			 */
+			inline
+			std::shared_ptr<Signal<Ptr, const ParserError&>>
+			error()
+			{
+				return _error;
+			}
+
 			virtual
 			void
 			parse(const std::string&				filename,
@@ -52,7 +64,8 @@ namespace minko
 
 		protected:
 			AbstractParser() :
-				_complete(Signal<Ptr>::create())
+				_complete(Signal<Ptr>::create()),
+				_error(Signal<Ptr, const ParserError&>::create())
 			{
 
 			}
@@ -72,6 +72,7 @@ namespace minko
 
 			std::vector<Signal<std::shared_ptr<file::AbstractLoader>>::Slot>		_loaderSlots;
 			std::vector<Signal<std::shared_ptr<file::AbstractParser>>::Slot>	_parserSlots;
+			std::vector<Signal<std::shared_ptr<file::AbstractParser>, const file::ParserError&>::Slot>	_parserErrorSlots;
 
             Signal<Ptr>::Ptr											            _complete;
             Signal<Ptr, std::shared_ptr<AbstractParser>>::Ptr                       _parserError;
@@ -280,6 +281,9 @@ namespace minko
 			void
 			loaderCompleteHandler(std::shared_ptr<file::AbstractLoader> loader);
 
+			void
+			parserErrorHandler(std::shared_ptr<file::AbstractParser> parser, const file::ParserError& parserError);
+
 			void
 			finalize(const std::string& filename);
 		};
@@ -0,0 +1,87 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/file/AbstractParser.hpp"
+
+namespace minko
+{
+	namespace file
+	{
+		/**
+		 * Parses KTX 1.1 textures: block compressed (DXT1, DXT5, ETC1, PVRTC 4bpp) or RGB/RGBA
+		 * with unsigned bytes. Compressed mip levels are uploaded as is when the context supports
+		 * their format and transcoded to RGBA otherwise (see render::Texture::compressedData()).
+		 * Uncompressed files with several mip levels are uploaded level by level instead of
+		 * generating the mipmaps at runtime (see render::Texture::mipLevelsData()).
+		 * Cube maps and texture arrays are not supported.
+		 */
+		class KTXParser :
+			public AbstractParser
+		{
+		public:
+			typedef std::shared_ptr<KTXParser> Ptr;
+
+		public:
+			inline static
+			Ptr
+			create()
+			{
+				return std::shared_ptr<KTXParser>(new KTXParser());
+			}
+
+			void
+			parse(const std::string&				filename,
+				  const std::string&                resolvedFilename,
+                  std::shared_ptr<Options>          options,
+				  const std::vector<unsigned char>&	data,
+				  std::shared_ptr<AssetLibrary>		assetLibrary);
+
+			/**
+			 * Reads the dimensions and the mip levels, finest first, of a KTX file. RGB levels are
+			 * returned without the row padding of the file. Returns false if the data is not a valid
+			 * or supported KTX file.
+			 */
+			static
+			bool
+			read(const std::vector<unsigned char>&			data,
+				 render::TextureFormat&						format,
+				 uint&										width,
+				 uint&										height,
+				 std::vector<std::vector<unsigned char>>&	levels);
+
+			static
+			uint
+			glInternalFormat(render::TextureFormat format);
+
+			static
+			bool
+			textureFormat(uint glInternalFormat, render::TextureFormat& format);
+
+		private:
+			KTXParser()
+			{
+			}
+		};
+	}
+}
@@ -0,0 +1,68 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+	namespace file
+	{
+		class KTXWriter :
+			public std::enable_shared_from_this<KTXWriter>
+		{
+		public:
+			typedef std::shared_ptr<KTXWriter> Ptr;
+
+		public:
+			inline static
+			Ptr
+			create()
+			{
+				return std::shared_ptr<KTXWriter>(new KTXWriter());
+			}
+
+			/**
+			 * Writes a KTX 1.1 file with the given mip levels, finest first. The format must be
+			 * RGBA or one of the block compressed formats.
+			 */
+			void
+			write(const std::string&							filename,
+				  render::TextureFormat							format,
+				  uint											width,
+				  uint											height,
+				  const std::vector<std::vector<unsigned char>>&	levels);
+
+			static
+			void
+			write(std::vector<unsigned char>&						out,
+				  render::TextureFormat							format,
+				  uint											width,
+				  uint											height,
+				  const std::vector<std::vector<unsigned char>>&	levels);
+
+		private:
+			KTXWriter()
+			{
+			}
+		};
+	}
+}
@@ -56,9 +56,15 @@ namespace minko
 
             bool                                        _generateMipMaps;
 			bool										_resizeSmoothly;
+			bool										_streamTextures;
 			bool										_isCubeTexture;
 			bool										_startAnimation;
 			bool										_loadAsynchronously;
+			bool										_optimizeGeometry;
+			std::unordered_map<std::string, AttributeEncoding>	_attributeEncodings;
+			bool										_compressIndices;
+			unsigned int								_numParsingJobs;
+			render::TextureFormat						_textureFormat;
 			unsigned int								_skinningFramerate;
 			component::SkinningMethod					_skinningMethod;
             std::shared_ptr<render::Effect>             _effect;
@@ -87,6 +93,7 @@ namespace minko
 				opt->_includePaths				= options->_includePaths;
                 opt->_generateMipMaps			= options->_generateMipMaps;
 				opt->_resizeSmoothly			= options->_resizeSmoothly;
+				opt->_streamTextures			= options->_streamTextures;
 				opt->_isCubeTexture				= options->_isCubeTexture;
 				opt->_startAnimation			= options->_startAnimation;
 				opt->_skinningFramerate			= options->_skinningFramerate;
@@ -98,6 +105,11 @@ namespace minko
 				opt->_uriFunction				= options->_uriFunction;
 				opt->_nodeFunction				= options->_nodeFunction;
 				opt->_loadAsynchronously		= options->_loadAsynchronously;
+				opt->_optimizeGeometry			= options->_optimizeGeometry;
+				opt->_attributeEncodings		= options->_attributeEncodings;
+				opt->_compressIndices			= options->_compressIndices;
+				opt->_numParsingJobs			= options->_numParsingJobs;
+				opt->_textureFormat				= options->_textureFormat;
 
 				return opt;
 			}
@@ -194,6 +206,132 @@ namespace minko
 				return shared_from_this();
 			}
 
+			/**
+			 * Whether imported or written geometries are reordered for the post-transform vertex
+			 * cache, overdraw and vertex fetches (see geometry::Geometry::optimize()).
+			 */
+			inline
+			bool
+			optimizeGeometry() const
+			{
+				return _optimizeGeometry;
+			}
+
+			inline
+			Ptr
+			optimizeGeometry(bool value)
+			{
+				_optimizeGeometry = value;
+
+				return shared_from_this();
+			}
+
+			/**
+			 * Lossy encoding used to write the given vertex attribute ("position", "normal", "uv"...),
+			 * RAW by default. Encodings that do not apply to an attribute (OCTAHEDRAL for anything
+			 * but 3 components vectors) fall back to RAW.
+			 */
+			inline
+			AttributeEncoding
+			attributeEncoding(const std::string& attributeName) const
+			{
+				auto encodingIt = _attributeEncodings.find(attributeName);
+
+				return encodingIt != _attributeEncodings.end() ? encodingIt->second : AttributeEncoding::RAW;
+			}
+
+			inline
+			Ptr
+			attributeEncoding(const std::string& attributeName, AttributeEncoding encoding)
+			{
+				_attributeEncodings[attributeName] = encoding;
+
+				return shared_from_this();
+			}
+
+			/**
+			 * Whether the written index streams are delta and variable length encoded (lossless).
+			 */
+			inline
+			bool
+			compressIndices() const
+			{
+				return _compressIndices;
+			}
+
+			inline
+			Ptr
+			compressIndices(bool value)
+			{
+				_compressIndices = value;
+
+				return shared_from_this();
+			}
+
+			/**
+			 * Format of the written textures. With a block compressed format, the textures that
+			 * still have their data on the CPU are written as KTX files with their mip chain instead
+			 * of copying their source file. Defaults to RGBA.
+			 */
+			inline
+			render::TextureFormat
+			textureFormat() const
+			{
+				return _textureFormat;
+			}
+
+			inline
+			Ptr
+			textureFormat(render::TextureFormat value)
+			{
+				_textureFormat = value;
+
+				return shared_from_this();
+			}
+
+			/**
+			 * Number of threads reading the dependencies of serialized files and decoding their
+			 * geometries, defaults to the number of hardware threads. With 1, everything is done
+			 * on the parsing thread.
+			 */
+			inline
+			unsigned int
+			numParsingJobs() const
+			{
+				return _numParsingJobs;
+			}
+
+			inline
+			Ptr
+			numParsingJobs(unsigned int value)
+			{
+				if (value == 0)
+					throw std::invalid_argument("value");
+
+				_numParsingJobs = value;
+
+				return shared_from_this();
+			}
+
+			/**
+			 * Whether 2D textures are created as streamed textures (see render::Texture::streamed()).
+			 */
+			inline
+			bool
+			streamTextures() const
+			{
+				return _streamTextures;
+			}
+
+			inline
+			Ptr
+			streamTextures(bool value)
+			{
+				_streamTextures = value;
+
+				return shared_from_this();
+			}
+
 			inline
 			bool
 			isCubeTexture() const
@@ -0,0 +1,163 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+	namespace geometry
+	{
+		/*
+		** Flattened bounding volume hierarchy over the triangles of an indexed mesh, built with
+		** a binned surface area heuristic. Nodes are stored depth-first: the left child of an
+		** inner node immediately follows it and its right child is stored at "offset".
+		** Triangles are copied as (v0, edge1, edge2) in leaf order so that ray queries never
+		** touch the source vertex/index data.
+		*/
+		class BVH
+		{
+		public:
+			typedef std::shared_ptr<BVH>	Ptr;
+
+			struct Node
+			{
+				float			min[3];
+				uint			offset;	// right child (inner node) or first triangle (leaf)
+				float			max[3];
+				unsigned short	count;	// number of triangles, 0 for inner nodes
+				unsigned short	axis;	// split axis of inner nodes
+			};
+
+			struct Hit
+			{
+				float	distance;
+				uint	triangle;	// offset of the triangle's first index in the index buffer
+				float	u;
+				float	v;
+			};
+
+			static const uint	MAX_LEAF_SIZE	= 4;
+			static const uint	NUM_BINS		= 12;
+			static const uint	NO_HIT			= 0xffffffff;
+
+		private:
+			std::vector<Node>	_nodes;
+			std::vector<float>	_triangles;
+			std::vector<uint>	_triangleIds;
+
+		public:
+			inline static
+			Ptr
+			create(const std::vector<float>&			xyzData,
+				   uint									vertexSize,
+				   uint									xyzOffset,
+				   const std::vector<unsigned short>&	indices)
+			{
+				auto bvh = std::shared_ptr<BVH>(new BVH());
+
+				if (!xyzData.empty() && !indices.empty())
+					bvh->build(&xyzData[0], vertexSize, xyzOffset, &indices[0], indices.size());
+
+				return bvh;
+			}
+
+			inline static
+			Ptr
+			create(const float*				xyzData,
+				   uint						vertexSize,
+				   uint						xyzOffset,
+				   const unsigned short*	indices,
+				   uint						numIndices)
+			{
+				auto bvh = std::shared_ptr<BVH>(new BVH());
+
+				bvh->build(xyzData, vertexSize, xyzOffset, indices, numIndices);
+
+				return bvh;
+			}
+
+			inline
+			const std::vector<Node>&
+			nodes() const
+			{
+				return _nodes;
+			}
+
+			inline
+			uint
+			numNodes() const
+			{
+				return _nodes.size();
+			}
+
+			inline
+			uint
+			numTriangles() const
+			{
+				return _triangleIds.size();
+			}
+
+			bool
+			cast(const float*	origin,
+				 const float*	direction,
+				 Hit&			hit,
+				 float			maxDistance = std::numeric_limits<float>::max()) const;
+
+			bool
+			castAny(const float*	origin,
+					const float*	direction,
+					float			maxDistance = std::numeric_limits<float>::max()) const;
+
+			uint
+			castPacket(uint			numRays,
+					   const float*	origins,
+					   const float*	directions,
+					   Hit*			hits,
+					   float		maxDistance = std::numeric_limits<float>::max()) const;
+
+		private:
+			BVH() = default;
+
+			void
+			build(const float*			xyzData,
+				  uint					vertexSize,
+				  uint					xyzOffset,
+				  const unsigned short*	indices,
+				  uint					numIndices);
+
+			bool
+			intersectTriangle(uint			triangle,
+							  const float*	origin,
+							  const float*	direction,
+							  float&		t,
+							  float&		u,
+							  float&		v) const;
+
+			static
+			bool
+			intersectNode(const Node&	node,
+						  const float*	origin,
+						  const float*	invDirection,
+						  float			maxDistance);
+		};
+	}
+}
@@ -22,6 +22,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/Common.hpp"
 #include "minko/data/ArrayProvider.hpp"
 #include "minko/render/VertexBuffer.hpp"
+#include "minko/geometry/BVH.hpp"
 
 namespace minko
 {
@@ -33,6 +34,8 @@ namespace minko
 		public:
 			typedef std::shared_ptr<Geometry> Ptr;
 
+			static const uint DEFAULT_VERTEX_CACHE_SIZE = 16;
+
 		private:
 			typedef std::shared_ptr<render::VertexBuffer> VBPtr;
 			typedef std::shared_ptr<data::ArrayProvider>  ProviderPtr;
@@ -46,6 +49,9 @@ namespace minko
 
 			std::unordered_map<VBPtr, Signal<VBPtr, int>::Slot>	_vbToVertexSizeChangedSlot;
 
+			BVH::Ptr								_bvh;
+			Signal<VBPtr>::Slot						_positionDataChangedSlot;
+
 		public:
 			virtual
 			~Geometry()
@@ -110,6 +116,7 @@ namespace minko
 			{
 				_indexBuffer = indices;
 				_data->set("indices", indices);
+				_bvh = nullptr;
 			}
 
 			inline
@@ -157,6 +164,31 @@ namespace minko
 									 std::vector<std::vector<float>>&	vertices,
 									 uint								numVertices);
 
+			/*
+			** Reorders the triangles for a FIFO post-transform vertex cache of the given size
+			** (Tipsify), optionally sorts the resulting clusters so that the outward-facing ones
+			** are drawn first to reduce overdraw, and optionally renumbers the vertices in their
+			** order of first use to improve the locality of the vertex fetches. All the vertex
+			** buffers are remapped accordingly. Vertices must not be renumbered when the vertex
+			** buffers are shared with another geometry (levels of detail for instance).
+			*/
+			Ptr
+			optimize(uint	cacheSize		= DEFAULT_VERTEX_CACHE_SIZE,
+					 bool	reduceOverdraw	= true,
+					 bool	reorderVertices	= true);
+
+			/*
+			** Average number of vertex shader invocations per triangle (ACMR) with a FIFO
+			** post-transform vertex cache of the given size.
+			*/
+			float
+			averageCacheMissRatio(uint cacheSize = DEFAULT_VERTEX_CACHE_SIZE) const;
+
+			static
+			float
+			averageCacheMissRatio(const std::vector<unsigned short>&	indices,
+								  uint								cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+
 			bool
 			cast(std::shared_ptr<math::Ray>		ray,
 				 float&							distance,
@@ -165,6 +197,18 @@ namespace minko
 				 std::shared_ptr<math::Vector2>	hitUv 		= nullptr,
 				 std::shared_ptr<math::Vector3>	hitNormal 	= nullptr);
 
+			bool
+			castAny(std::shared_ptr<math::Ray>	ray,
+					float						maxDistance = std::numeric_limits<float>::max());
+
+			/*
+			** Triangle hierarchy used by the ray queries. Built on first use and discarded
+			** whenever the positions or the indices change. Null when the positions or the
+			** indices are not available on the CPU.
+			*/
+			BVH::Ptr
+			bvh();
+
 			void
 			upload();
 
@@ -212,6 +256,27 @@ namespace minko
 
 			void
 			getHitNormal(uint triangle, std::shared_ptr<math::Vector3> hitNormal);
+
+			static
+			std::vector<uint>
+			tipsify(const std::vector<unsigned short>&	indices,
+					uint								numVertices,
+					uint								cacheSize,
+					std::vector<uint>&					clusters);
+
+			static
+			void
+			splitClusters(const std::vector<unsigned short>&	indices,
+						  const std::vector<uint>&				triangles,
+						  uint									cacheSize,
+						  std::vector<uint>&					clusters);
+
+			void
+			sortClusters(std::vector<uint>&			triangles,
+						 const std::vector<uint>&	clusters);
+
+			void
+			remapVertices();
 		};
 	}
 }
@@ -93,6 +93,14 @@ namespace minko
 			Ptr
 			initialize(Quaternion::Ptr, Vector3::Ptr);
 
+			/*
+			** Writes 16 consecutive values into each matrix, then notifies the unlocked ones once
+			** all of them are up to date.
+			*/
+			static
+			void
+			initialize(const std::vector<Ptr>& matrices, const float* values);
+
 			inline
 			const std::vector<float>&
 			values() const
@@ -367,6 +375,19 @@ namespace minko
 
 			Matrix4x4(Ptr value);
 
+			Ptr
+			view(float			eyeX,
+				 float			eyeY,
+				 float			eyeZ,
+				 float			lookAtX,
+				 float			lookAtY,
+				 float			lookAtZ,
+				 Vector3::Ptr	upAxis);
+
+			static
+			void
+			normalize(float& x, float& y, float& z);
+
 			inline
 			Ptr
 			append(float m00, float m01, float m02, float m03,
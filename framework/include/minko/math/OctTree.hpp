@@ -90,6 +90,10 @@ namespace minko
 						std::function<void(std::shared_ptr<scene::Node>)>	insideFrustumCallback,
 						std::function<void(std::shared_ptr<scene::Node>)>	outsideFustumCallback);
 
+			void
+			cast(std::shared_ptr<math::Ray>							ray,
+				 std::function<void(std::shared_ptr<scene::Node>)>	callback);
+
 		private:
 
 			bool
@@ -146,6 +146,28 @@ namespace minko
 							    unsigned int 	mipLevel,
 							    void*			data) = 0;
 
+			virtual
+			bool
+			supportsTextureFormat(TextureFormat format) const = 0;
+
+			virtual
+			uint
+			createCompressedTexture(TextureType		type,
+									TextureFormat	format,
+									unsigned int	width,
+									unsigned int	height,
+									bool			mipMapping) = 0;
+
+			virtual
+			void
+			uploadCompressedTexture2dData(uint			texture,
+										  TextureFormat	format,
+										  unsigned int	width,
+										  unsigned int	height,
+										  unsigned int	size,
+										  unsigned int	mipLevel,
+										  void*			data) = 0;
+
 			virtual
 			void
 			uploadCubeTextureData(uint				texture,
@@ -324,6 +346,19 @@ namespace minko
 			void
 			readPixels(unsigned int x, unsigned int y, unsigned int width, unsigned int height, unsigned char* pixels) = 0;
 
+			/*
+			** Starts an asynchronous read of a region of the current render target and returns
+			** a request id to give to endReadPixels(). Where pixel buffer objects are available,
+			** the copy happens on the GPU and does not stall until endReadPixels() is called.
+			*/
+			virtual
+			uint
+			beginReadPixels(unsigned int x, unsigned int y, unsigned int width, unsigned int height) = 0;
+
+			virtual
+			void
+			endReadPixels(uint request, unsigned char* pixels) = 0;
+
             virtual
             void
             setTriangleCulling(TriangleCulling triangleCulling) = 0;
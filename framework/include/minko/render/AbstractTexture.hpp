@@ -102,6 +102,21 @@ namespace minko
 			void
 			disposeData() = 0;
 
+			/**
+			 * Resizes RGBA data, bilinearly if resizeSmoothly is true. The data is swapped into
+			 * newData when the dimensions are the same. Image decoders call it from background
+			 * threads to resize to the GPU dimensions before the texture is even created.
+			 */
+			static
+			void
+			resizeData(unsigned int width, 
+					   unsigned int height, 
+					   std::vector<unsigned char>&	data, 
+			           unsigned int newWidth, 
+					   unsigned int newHeight,
+					   bool resizeSmoothly,
+					   std::vector<unsigned char>&	newData);
+
 		protected:
 			AbstractTexture(TextureType			type,
 							AbstractContextPtr	context,
@@ -116,16 +131,6 @@ namespace minko
 			{
 			}
 
-			static
-			void
-			resizeData(unsigned int width, 
-					   unsigned int height, 
-					   std::vector<unsigned char>&	data, 
-			           unsigned int newWidth, 
-					   unsigned int newHeight,
-					   bool resizeSmoothly,
-					   std::vector<unsigned char>&	newData);
-
 			uint
 			getMipmapWidth(uint level) const;
 
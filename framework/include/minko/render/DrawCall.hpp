@@ -58,6 +58,8 @@ namespace minko
 		private:
 			static const unsigned int									MAX_NUM_TEXTURES;
 			static const unsigned int									MAX_NUM_VERTEXBUFFERS;
+			static const unsigned int									NO_INDEX_BUFFER;
+			static const std::vector<std::string>						DEFORMATION_INPUTS;
 
             static SamplerState                                         _defaultSamplerState;
 
@@ -83,6 +85,7 @@ namespace minko
             std::vector<MipFilter>                                      _textureMipFilters;
 			std::vector<TextureType>									_textureTypes;
             uint                                                        _numIndices;
+			int															_positionVertexBufferIndex;
             uint                                                        _indexBuffer;
             AbsTexturePtr					                            _target;
             render::Blending::Mode                                      _blendMode;
@@ -200,6 +203,20 @@ namespace minko
 				return _priority;
 			}
 
+			inline
+			std::shared_ptr<Program>
+			program() const
+			{
+				return _program;
+			}
+
+			inline
+			const std::vector<int>&
+			textureIds() const
+			{
+				return _textureIds;
+			}
+
 			inline
 			bool
 			zSorted() const
@@ -220,8 +237,32 @@ namespace minko
 					  ContainerPtr              rendererData,
                       ContainerPtr              rootData);
 
+			/**
+			 * Renders the draw call. When it has been drawn by renderDepth() first, the depth buffer
+			 * is left untouched and only the fragments passing a LESS_EQUAL test against it are shaded.
+			 */
+			void
+			render(const std::shared_ptr<AbstractContext>&	context,
+				   AbsTexturePtr							renderTarget,
+				   bool										depthPrePassed = false);
+
+			/**
+			 * True if the draw call is an opaque, depth-writing draw call rendering to the default target,
+			 * without skinning or displacement, whose positions are computed as
+			 * worldToScreenMatrix * (modelToWorldMatrix * position): its depth can be written beforehand
+			 * by renderDepth().
+			 */
+			bool
+			depthPrePassCompatible() const;
+
+			/**
+			 * Writes the depth of the draw call with depthProgram, a minimal program taking the
+			 * "position" attribute and the "modelToWorldMatrix" and "worldToScreenMatrix" uniforms.
+			 */
 			void
-			render(const std::shared_ptr<AbstractContext>& context, AbsTexturePtr renderTarget);
+			renderDepth(const std::shared_ptr<AbstractContext>&	context,
+						AbsTexturePtr							renderTarget,
+						std::shared_ptr<Program>				depthProgram);
 
 			void
 			initialize(ContainerPtr				                    data,
@@ -157,6 +157,13 @@ namespace minko
 			const std::list<std::shared_ptr<DrawCall>>&
 			drawCalls();
 
+			inline
+			const std::unordered_map<SurfacePtr, DrawCallList>&
+			surfaceDrawCalls() const
+			{
+				return _surfaceToDrawCalls;
+			}
+
 			void
 			addSurface(SurfacePtr);
 
@@ -0,0 +1,173 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+	namespace render
+	{
+		/*
+		** Bins light volumes into a view-space cluster grid ("froxels"): the screen is split into
+		** numX() x numY() tiles and the [zNear, zFar] depth range into numZ() logarithmic slices.
+		** Each cluster gets the list of the lights whose bounding sphere may touch it, at most
+		** maxLightsPerCluster() of them.
+		*/
+		class LightClusters
+		{
+		public:
+			typedef std::shared_ptr<LightClusters>	Ptr;
+
+		private:
+			typedef std::shared_ptr<math::Matrix4x4>	Matrix4x4Ptr;
+
+		private:
+			const uint					_numX;
+			const uint					_numY;
+			const uint					_numZ;
+			const uint					_maxLightsPerCluster;
+
+			float						_zNear;
+			float						_depthScale;
+			float						_depthBias;
+			float						_projectionX;
+			float						_projectionY;
+
+			std::vector<float>			_viewSpheres;	// x, y, depth, radius
+			std::vector<int>			_sliceRanges;	// first and last slice of each light
+			std::vector<unsigned short>	_lights;
+			std::vector<uint>			_counts;
+
+		public:
+			inline static
+			Ptr
+			create(uint numX					= 16,
+				   uint numY					= 8,
+				   uint numZ					= 24,
+				   uint maxLightsPerCluster		= 64)
+			{
+				if (numX == 0 || numY == 0 || numZ == 0 || maxLightsPerCluster == 0)
+					throw std::invalid_argument("The cluster grid dimensions and maxLightsPerCluster must be strictly positive.");
+
+				return std::shared_ptr<LightClusters>(new LightClusters(numX, numY, numZ, maxLightsPerCluster));
+			}
+
+			inline
+			uint
+			numX() const
+			{
+				return _numX;
+			}
+
+			inline
+			uint
+			numY() const
+			{
+				return _numY;
+			}
+
+			inline
+			uint
+			numZ() const
+			{
+				return _numZ;
+			}
+
+			inline
+			uint
+			numClusters() const
+			{
+				return _numX * _numY * _numZ;
+			}
+
+			inline
+			uint
+			maxLightsPerCluster() const
+			{
+				return _maxLightsPerCluster;
+			}
+
+			/**
+			 * The depth slice of a view-space depth d is floor(log(d) * depthScale() + depthBias()).
+			 */
+			inline
+			float
+			depthScale() const
+			{
+				return _depthScale;
+			}
+
+			inline
+			float
+			depthBias() const
+			{
+				return _depthBias;
+			}
+
+			inline
+			uint
+			clusterIndex(uint x, uint y, uint z) const
+			{
+				return x + _numX * (y + _numY * z);
+			}
+
+			inline
+			uint
+			numLights(uint cluster) const
+			{
+				return _counts[cluster];
+			}
+
+			inline
+			const unsigned short*
+			lights(uint cluster) const
+			{
+				return &_lights[cluster * _maxLightsPerCluster];
+			}
+
+			/**
+			 * Bins the lights described by "spheres" (world-space x, y, z and radius for each light,
+			 * a negative radius meaning an infinite one) for a symmetric perspective projection.
+			 * The depth slices are split among numJobs worker threads.
+			 */
+			void
+			build(const std::vector<float>&	spheres,
+				  Matrix4x4Ptr				view,
+				  Matrix4x4Ptr				projection,
+				  float						zNear,
+				  float						zFar,
+				  uint						numJobs	= 1);
+
+		private:
+			LightClusters(uint numX, uint numY, uint numZ, uint maxLightsPerCluster);
+
+			int
+			slice(float depth) const;
+
+			float
+			sliceDepth(uint slice) const;
+
+			void
+			binSlices(uint firstSlice, uint lastSlice);
+		};
+	}
+}
@@ -0,0 +1,63 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+	namespace render
+	{
+		/**
+		 * Offline resampling of RGBA images: resize to power of 2 dimensions and mip chain
+		 * generation with a Lanczos filter (3 lobes) widened when minifying. The colors are
+		 * premultiplied by alpha while filtering so that transparent texels do not bleed.
+		 * Noticeably slower but sharper and less aliased than the bilinear resize of
+		 * AbstractTexture and the box filters used at runtime.
+		 */
+		class MipMapChain
+		{
+		public:
+			static
+			void
+			resize(uint							width,
+				   uint							height,
+				   const unsigned char*			rgba,
+				   uint							newWidth,
+				   uint							newHeight,
+				   std::vector<unsigned char>&	out);
+
+			/**
+			 * Builds all the mip levels, finest first, of an image whose dimensions are powers of 2.
+			 * The first level is a copy of the image.
+			 */
+			static
+			void
+			build(uint										width,
+				  uint										height,
+				  const unsigned char*						rgba,
+				  std::vector<std::vector<unsigned char>>&	levels);
+
+		private:
+			MipMapChain();
+		};
+	}
+}
@@ -0,0 +1,155 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+	namespace render
+	{
+		/*
+		** Low-resolution depth buffer rasterized on the CPU from occluder triangles, used to test
+		** whether screen-space rectangles are hidden. Depths are normalized device depths remapped
+		** to [0, 1]; each level of the hierarchy stores the farthest depth of 2x2 texels of the
+		** previous one so that large rectangles are tested against a handful of texels.
+		**
+		** Triangles crossing the near plane are dropped: occluders can only be missed, which keeps
+		** the test conservative.
+		*/
+		class OcclusionBuffer
+		{
+		public:
+			typedef std::shared_ptr<OcclusionBuffer>	Ptr;
+
+		private:
+			const uint								_width;
+			const uint								_height;
+
+			std::vector<float>						_triangles;	// x, y, depth of 3 vertices, in pixels
+			std::vector<float>						_clipVertices;
+			std::vector<std::vector<float>>			_levels;	// farthest depth, finest level first
+
+		public:
+			inline static
+			Ptr
+			create(uint width = 256, uint height = 128)
+			{
+				if (width == 0 || height == 0)
+					throw std::invalid_argument("The occlusion buffer must have a strictly positive size.");
+
+				return std::shared_ptr<OcclusionBuffer>(new OcclusionBuffer(width, height));
+			}
+
+			inline
+			uint
+			width() const
+			{
+				return _width;
+			}
+
+			inline
+			uint
+			height() const
+			{
+				return _height;
+			}
+
+			inline
+			uint
+			numLevels() const
+			{
+				return _levels.size();
+			}
+
+			inline
+			uint
+			numTriangles() const
+			{
+				return _triangles.size() / 9;
+			}
+
+			/**
+			 * Farthest occluder depth of a texel of a level, 1 where there is no occluder.
+			 */
+			inline
+			float
+			depth(uint x, uint y, uint level = 0) const
+			{
+				return _levels[level][y * levelWidth(level) + x];
+			}
+
+			void
+			clear();
+
+			/**
+			 * Queues the triangles of an occluder mesh. modelToScreen is row-major and maps the
+			 * positions to clip space, as the product of "transform.modelToWorldMatrix" and
+			 * "camera.worldToScreenMatrix".
+			 */
+			void
+			addOccluder(const float*			vertices,
+						uint					vertexSize,
+						uint					positionOffset,
+						uint					numVertices,
+						const unsigned short*	indices,
+						uint					numIndices,
+						const float*			modelToScreen);
+
+			/**
+			 * Rasterizes the queued triangles, split into numJobs bands of rows, then builds the hierarchy.
+			 */
+			void
+			rasterize(uint numJobs = 1);
+
+			/**
+			 * True if the rectangle, in normalized device coordinates, lies behind the occluders
+			 * everywhere: minDepth is its nearest depth, in [0, 1].
+			 */
+			bool
+			occluded(float minX, float minY, float maxX, float maxY, float minDepth) const;
+
+		private:
+			OcclusionBuffer(uint width, uint height);
+
+			inline
+			uint
+			levelWidth(uint level) const
+			{
+				return std::max(1u, _width >> level);
+			}
+
+			inline
+			uint
+			levelHeight(uint level) const
+			{
+				return std::max(1u, _height >> level);
+			}
+
+			void
+			rasterizeRows(uint firstRow, uint lastRow);
+
+			void
+			buildHierarchy();
+		};
+	}
+}
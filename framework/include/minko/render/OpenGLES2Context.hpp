@@ -42,11 +42,26 @@ namespace minko
 			typedef std::unordered_map<StencilOperation, unsigned int>	StencilOperationMap;
             typedef std::unordered_map<unsigned int, unsigned int>		TextureToBufferMap;
 			typedef std::pair<uint, uint>								TextureSize;
+			typedef std::unordered_map<TextureFormat, unsigned int>		TextureFormatMap;
+
+			struct PixelBuffer
+			{
+				uint						buffer;
+				uint						size;
+			};
+
+			struct PixelsRequest
+			{
+				PixelBuffer					pixelBuffer;
+				uint						size;
+				std::vector<unsigned char>	pixels;
+			};
 
 		protected:
 	        static BlendFactorsMap					_blendingFactors;
 			static CompareFuncsMap					_compareFuncs;
 			static StencilOperationMap				_stencilOps;
+			static TextureFormatMap					_compressedTextureFormats;
 
 			bool									_errorsEnabled;
 
@@ -56,6 +71,7 @@ namespace minko
 			std::unordered_map<uint, TextureType>   _textureTypes;
 
             std::string                             _driverInfo;
+            std::unordered_set<TextureFormat>       _supportedTextureFormats;
 
 			std::list<unsigned int>	                _vertexBuffers;
 			std::list<unsigned int>	                _indexBuffers;
@@ -95,6 +111,12 @@ namespace minko
 			StencilOperation						_currentStencilZFailOp;
 			StencilOperation						_currentStencilZPassOp;
 
+			std::unordered_map<uint, PixelsRequest>	_pixelsRequests;
+			uint									_nextPixelsRequest;
+			bool									_supportsPixelBuffers;
+			bool									_supportsMapBufferRange;
+			std::list<PixelBuffer>					_freePixelBuffers;
+
 		public:
 			~OpenGLES2Context();
 
@@ -219,6 +241,25 @@ namespace minko
 							    unsigned int 	mipLevel,
 							    void*			data);
 
+			bool
+			supportsTextureFormat(TextureFormat format) const;
+
+			uint
+			createCompressedTexture(TextureType		type,
+									TextureFormat	format,
+									unsigned int	width,
+									unsigned int	height,
+									bool			mipMapping);
+
+			void
+			uploadCompressedTexture2dData(uint			texture,
+										  TextureFormat	format,
+										  unsigned int	width,
+										  unsigned int	height,
+										  unsigned int	size,
+										  unsigned int	mipLevel,
+										  void*			data);
+
 			void
 			uploadCubeTextureData(uint				texture,
 								  CubeTexture::Face face,
@@ -365,6 +406,12 @@ namespace minko
 			void
 			readPixels(unsigned char* pixels);
 
+			uint
+			beginReadPixels(unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+
+			void
+			endReadPixels(uint request, unsigned char* pixels);
+
             void
             setTriangleCulling(TriangleCulling triangleCulling);
 
@@ -410,6 +457,25 @@ namespace minko
 			StencilOperationMap
 			initializeStencilOperationsMap();
 
+			static
+			TextureFormatMap
+			initializeCompressedTextureFormatsMap();
+
+			void
+			initializeSupportedTextureFormats();
+
+			void
+			initializePixelBuffersSupport();
+
+			PixelBuffer
+			acquirePixelBuffer(uint size);
+
+			uint
+			generateTexture(TextureType		type,
+							unsigned int	width,
+							unsigned int	height,
+							bool			mipMapping);
+
             void
             createRTTBuffers(TextureType	type,
 							 uint			texture, 
@@ -0,0 +1,85 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+	namespace render
+	{
+		/**
+		 * Thread-safe pool of the scratch buffers used while decoding and resizing images.
+		 * Released buffers keep their storage and are handed back, smallest fitting one first,
+		 * so that loading many textures does not allocate and free the same large blocks over
+		 * and over. The retained memory is bounded by maxSize(): buffers released beyond it
+		 * are freed.
+		 */
+		class PixelBufferPool
+		{
+		public:
+			static const std::size_t DEFAULT_MAX_SIZE;
+
+		private:
+			static std::mutex								_mutex;
+			static std::list<std::vector<unsigned char>>	_buffers;
+			static std::size_t								_size;
+			static std::size_t								_maxSize;
+
+		public:
+			/**
+			 * Returns a buffer of the given size whose content is unspecified.
+			 */
+			static
+			std::vector<unsigned char>
+			acquire(std::size_t size);
+
+			/**
+			 * Takes the storage of the buffer back, leaving it empty.
+			 */
+			static
+			void
+			release(std::vector<unsigned char>& buffer);
+
+			static
+			void
+			clear();
+
+			/**
+			 * Capacity, in bytes, of the buffers currently retained.
+			 */
+			static
+			std::size_t
+			size();
+
+			static
+			std::size_t
+			maxSize();
+
+			static
+			void
+			maxSize(std::size_t value);
+
+		private:
+			PixelBufferPool();
+		};
+	}
+}
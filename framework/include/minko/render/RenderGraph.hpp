@@ -0,0 +1,189 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+	namespace render
+	{
+		/*
+		** Describes a frame as a list of passes that read and write named render targets.
+		**
+		** Targets are either transient (addTarget(): only described by their size, allocated from a
+		** RenderTargetPool while the graph executes) or imported (importTarget(): an existing texture,
+		** nullptr standing for the back buffer). compile() culls the passes that do not contribute to
+		** the targets marked with output(), then computes the lifetime of each transient target and
+		** aliases the targets whose lifetimes do not overlap on the same texture: the memory used
+		** scales with the peak number of concurrent targets rather than their total number.
+		**
+		** Passes are executed in the order they were added; a pass can only read targets written by
+		** a previous pass or imported.
+		*/
+		class RenderGraph :
+			public std::enable_shared_from_this<RenderGraph>
+		{
+		public:
+			typedef std::shared_ptr<RenderGraph>			Ptr;
+			typedef std::function<void(Ptr graph)>			PassFunction;
+
+		private:
+			typedef std::shared_ptr<AbstractTexture>		AbsTexturePtr;
+			typedef std::shared_ptr<RenderTargetPool>		RenderTargetPoolPtr;
+
+			struct Target
+			{
+				uint			width;
+				uint			height;
+				bool			imported;
+				AbsTexturePtr	texture;
+				int				firstPass;
+				int				lastPass;
+				int				physicalTarget;
+			};
+
+			struct Pass
+			{
+				std::string					name;
+				std::vector<std::string>	inputs;
+				std::vector<std::string>	outputs;
+				PassFunction				function;
+				bool						culled;
+			};
+
+			struct PhysicalTarget
+			{
+				uint			width;
+				uint			height;
+				AbsTexturePtr	texture;
+			};
+
+		private:
+			RenderTargetPoolPtr						_pool;
+			std::unordered_map<std::string, Target>	_targets;
+			std::vector<Pass>						_passes;
+			std::set<std::string>					_outputs;
+
+			bool									_compiled;
+			std::vector<PhysicalTarget>				_physicalTargets;
+
+		public:
+			inline static
+			Ptr
+			create(RenderTargetPoolPtr pool)
+			{
+				return std::shared_ptr<RenderGraph>(new RenderGraph(pool));
+			}
+
+			/**
+			 * Declares a transient target, or resizes it if it already exists.
+			 */
+			Ptr
+			addTarget(const std::string& name, uint width, uint height);
+
+			/**
+			 * Declares a target backed by an existing texture (nullptr for the back buffer).
+			 */
+			Ptr
+			importTarget(const std::string& name, AbsTexturePtr texture);
+
+			Ptr
+			addPass(const std::string&					name,
+					const std::vector<std::string>&		inputs,
+					const std::vector<std::string>&		outputs,
+					PassFunction						function);
+
+			/**
+			 * Marks a target as a result of the graph: passes that do not contribute to any output are culled.
+			 */
+			Ptr
+			output(const std::string& name);
+
+			void
+			compile();
+
+			/**
+			 * Acquires the transient targets from the pool, runs the passes that are not culled and
+			 * releases the targets.
+			 */
+			void
+			execute();
+
+			/**
+			 * Texture of a target: only valid while the graph executes for transient targets.
+			 */
+			AbsTexturePtr
+			target(const std::string& name) const;
+
+			inline
+			uint
+			numPasses() const
+			{
+				return _passes.size();
+			}
+
+			uint
+			numCulledPasses();
+
+			bool
+			culled(const std::string& passName);
+
+			inline
+			uint
+			numTransientTargets() const
+			{
+				uint numTransientTargets = 0;
+
+				for (auto& nameAndTarget : _targets)
+					if (!nameAndTarget.second.imported)
+						++numTransientTargets;
+
+				return numTransientTargets;
+			}
+
+			/**
+			 * Number of textures the transient targets of the passes that are not culled are aliased on.
+			 */
+			uint
+			numPhysicalTargets();
+
+			/**
+			 * GPU memory used by the aliased transient targets, in bytes.
+			 */
+			uint
+			transientMemory();
+
+			/**
+			 * GPU memory the transient targets of the passes that are not culled would use without aliasing.
+			 */
+			uint
+			unaliasedMemory();
+
+		private:
+			RenderGraph(RenderTargetPoolPtr pool);
+
+			Target&
+			getTarget(const std::string& name);
+		};
+	}
+}
@@ -0,0 +1,109 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+	namespace render
+	{
+		/*
+		** Recycles render-to-texture targets: textures released by a pass or a RenderGraph are kept
+		** and handed back to the next acquire() of the same GPU size, so that transient targets are
+		** not re-created (along with their depth/stencil buffers) every frame. Textures that are not
+		** acquired for a while are destroyed by collect().
+		*/
+		class RenderTargetPool
+		{
+		public:
+			typedef std::shared_ptr<RenderTargetPool>	Ptr;
+
+		private:
+			typedef std::shared_ptr<AbstractContext>	AbstractContextPtr;
+			typedef std::shared_ptr<Texture>			TexturePtr;
+
+			struct Entry
+			{
+				TexturePtr	texture;
+				bool		used;
+				uint		lastUsedFrame;
+			};
+
+		private:
+			AbstractContextPtr								_context;
+			std::map<std::pair<uint, uint>, std::list<Entry>>	_entries;
+			uint											_frame;
+
+		public:
+			inline static
+			Ptr
+			create(AbstractContextPtr context)
+			{
+				return std::shared_ptr<RenderTargetPool>(new RenderTargetPool(context));
+			}
+
+			/**
+			 * Returns a free render target whose GPU size is clp2(width) x clp2(height), creating
+			 * and uploading a new one if none is available.
+			 */
+			TexturePtr
+			acquire(uint width, uint height);
+
+			void
+			release(TexturePtr texture);
+
+			/**
+			 * Ends a frame: disposes of the free targets that have not been acquired during the last
+			 * maxUnusedFrames calls.
+			 */
+			void
+			collect(uint maxUnusedFrames = 60);
+
+			void
+			clear();
+
+			uint
+			numTextures() const;
+
+			uint
+			numFreeTextures() const;
+
+			/**
+			 * GPU memory held by the pool, in bytes.
+			 */
+			uint
+			memory() const;
+
+			/**
+			 * GPU memory of a render target: RGBA color and the 32 bits depth/stencil buffer
+			 * allocated along with it.
+			 */
+			static
+			uint
+			memory(uint width, uint height);
+
+		private:
+			RenderTargetPool(AbstractContextPtr context);
+		};
+	}
+}
@@ -32,12 +32,24 @@ namespace minko
 		{
 		public:
 			typedef std::shared_ptr<Texture>			Ptr;
+			typedef std::function<void(Texture&)>		DataSourceFunction;
 
 		private:
 			typedef std::shared_ptr<AbstractContext>	AbstractContextPtr;
 
+		public:
+			// coarsest levels uploaded when a streamed texture is first uploaded
+			static const uint STREAMING_MIN_SIZE;
+
 		private:
-			std::vector<unsigned char>	_data;
+			std::vector<unsigned char>					_data;
+			TextureFormat								_format;
+			std::vector<std::vector<unsigned char>>		_compressedData;
+
+			bool										_streamed;
+			uint										_residentMipLevel;
+			std::vector<std::vector<unsigned char>>		_mipData;
+			DataSourceFunction							_dataSource;
 		
 		public:
 			inline static
@@ -81,6 +93,50 @@ namespace minko
 				 int			widthGPU	= -1,
 				 int			heightGPU	= -1);
 
+			/**
+			 * Takes an RGBA image, either already at the GPU dimensions, in which case it becomes
+			 * the texture data without any copy, or at the texture dimensions to be resized. The
+			 * buffers released in the process go back to the PixelBufferPool.
+			 */
+			void
+			data(std::vector<unsigned char> rgba);
+
+			/**
+			 * Sets RGBA mip levels, finest first, resized and filtered offline (see MipMapChain).
+			 * The dimensions of the texture must be powers of 2. With a complete chain, upload()
+			 * sends each level with uploadMipLevel() instead of generating the mipmaps on the GPU.
+			 */
+			void
+			mipLevelsData(std::vector<std::vector<unsigned char>> levels);
+
+			/**
+			 * GPU storage format: RGBA unless compressed levels were set with compressedData().
+			 */
+			inline
+			TextureFormat
+			format() const
+			{
+				return _format;
+			}
+
+			inline
+			const std::vector<std::vector<unsigned char>>&
+			compressedData() const
+			{
+				return _compressedData;
+			}
+
+			/**
+			 * Sets block compressed mip levels, finest first, to be uploaded as is. The dimensions
+			 * of the texture must be powers of 2. When the context does not support the format, the
+			 * first level is decoded to RGBA instead and the texture behaves as if data() was used.
+			 * Mip mapping is disabled if the chain is incomplete since compressed levels cannot be
+			 * generated by the GPU.
+			 */
+			void
+			compressedData(TextureFormat							format,
+						   std::vector<std::vector<unsigned char>>	levels);
+
 			void
 			dispose();
 
@@ -94,6 +150,83 @@ namespace minko
 			uploadMipLevel(uint				level,
 						   unsigned char*	data);
 
+			/**
+			 * Streamed textures keep their full mip chain on the CPU and only upload part of it:
+			 * upload() starts with the coarsest levels and component::TextureStreamer then calls
+			 * uploadMipLevels() to make finer levels resident or to evict them.
+			 */
+			inline
+			bool
+			streamed() const
+			{
+				return _streamed;
+			}
+
+			inline
+			void
+			streamed(bool value)
+			{
+				_streamed = value;
+			}
+
+			/**
+			 * Restores the CPU data of a streamed texture, with data(), mipLevelsData() or
+			 * compressedData(), after disposeResidentData() released it. Without a source, the
+			 * whole mip chain stays on the CPU.
+			 */
+			inline
+			void
+			dataSource(DataSourceFunction source)
+			{
+				_dataSource = source;
+			}
+
+			/**
+			 * Releases the CPU data of the resident mip level and of the finer ones when the
+			 * texture has a data source. The coarser levels are kept to evict levels without
+			 * reloading anything.
+			 */
+			void
+			disposeResidentData();
+
+			/**
+			 * CPU memory, in bytes, used by the data of every mip level.
+			 */
+			uint
+			dataMemory() const;
+
+			uint
+			numMipLevels() const;
+
+			/**
+			 * Finest mip level currently on the GPU, numMipLevels() if the texture is not uploaded.
+			 */
+			inline
+			uint
+			residentMipLevel() const
+			{
+				return _residentMipLevel;
+			}
+
+			/**
+			 * Makes baseLevel the top level of the GPU texture: levels from baseLevel to the last
+			 * one are (re)uploaded and the finer ones are released.
+			 */
+			void
+			uploadMipLevels(uint baseLevel);
+
+			/**
+			 * RGBA data of a mip level, the coarser levels are computed on first use.
+			 */
+			const unsigned char*
+			mipLevelData(uint level);
+
+			/**
+			 * GPU memory, in bytes, used when baseLevel is the finest resident level.
+			 */
+			uint
+			mipLevelsMemory(uint baseLevel) const;
+
 			~Texture()
 			{
 				dispose();
@@ -107,6 +240,18 @@ namespace minko
                     bool				optimizeForRenderToTexture,
 					bool				resizeSmoothly,
 				    const std::string&	filename);
+
+			void
+			computeMipData();
+
+			bool
+			hasMipData(uint level) const;
+
+			void
+			restoreData();
+
+			const unsigned char*
+			mipData(uint level) const;
 		};
 	}
 }
@@ -0,0 +1,98 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+	namespace render
+	{
+		/**
+		 * Block compressed texture formats: sizes and software codecs.
+		 *
+		 * compress() and decompress() work on RGBA data and support DXT1, DXT5 and ETC1. The encoders
+		 * favor speed over quality (bounding box endpoints for DXT, individual mode only for ETC1) and
+		 * are meant for offline conversion. The decoders are used to transcode textures on load when
+		 * the context does not support their format. PVRTC has no software codec: such textures can
+		 * only be uploaded as is.
+		 */
+		class TextureCompression
+		{
+		public:
+			static
+			bool
+			isCompressed(TextureFormat format);
+
+			static
+			bool
+			hasAlpha(TextureFormat format);
+
+			// size in bytes of a mip level of the given dimensions
+			static
+			uint
+			dataSize(TextureFormat format, uint width, uint height);
+
+			static
+			void
+			compress(TextureFormat					format,
+					 uint							width,
+					 uint							height,
+					 const unsigned char*			rgba,
+					 std::vector<unsigned char>&	out);
+
+			static
+			void
+			decompress(TextureFormat				format,
+					   uint							width,
+					   uint							height,
+					   const unsigned char*			data,
+					   std::vector<unsigned char>&	rgba);
+
+		private:
+			TextureCompression();
+
+			static
+			void
+			compressDXT1Block(const unsigned char* pixels, unsigned char* block);
+
+			static
+			void
+			compressDXT5AlphaBlock(const unsigned char* pixels, unsigned char* block);
+
+			static
+			void
+			compressETC1Block(const unsigned char* pixels, unsigned char* block);
+
+			static
+			void
+			decompressDXTColorBlock(const unsigned char* block, bool opaque, unsigned char* pixels);
+
+			static
+			void
+			decompressDXT5AlphaBlock(const unsigned char* block, unsigned char* pixels);
+
+			static
+			void
+			decompressETC1Block(const unsigned char* block, unsigned char* pixels);
+		};
+	}
+}
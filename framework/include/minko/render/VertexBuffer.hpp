@@ -47,6 +47,7 @@ namespace minko
 			Vector3Ptr							_maxPosition;
 
 			std::shared_ptr<Signal<Ptr, int>>	_vertexSizeChanged;
+			std::shared_ptr<Signal<Ptr>>		_dataChanged;
 
 		public:
 			~VertexBuffer()
@@ -129,6 +130,13 @@ namespace minko
 				return _vertexSizeChanged;
 			}
 
+			inline
+			std::shared_ptr<Signal<Ptr>>
+			dataChanged()
+			{
+				return _dataChanged;
+			}
+
 			inline
 			uint
 			numVertices() const
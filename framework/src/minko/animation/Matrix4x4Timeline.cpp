@@ -18,6 +18,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 */
 
 #include "minko/animation/Matrix4x4Timeline.hpp"
+#include "minko/animation/Pose.hpp"
 #include "minko/data/Container.hpp"
 #include "minko/math/Matrix4x4.hpp"
 #include "timeline_lookup.hpp"
@@ -34,6 +35,7 @@ Matrix4x4Timeline::Matrix4x4Timeline(const std::string& propertyName,
 									 bool interpolate):
 	AbstractTimeline(propertyName, duration),
 	_matrices(),
+	_keyChannels(),
 	_interpolate(interpolate)
 {
 	initializeMatrixTimetable(timetable, matrices);
@@ -61,6 +63,10 @@ Matrix4x4Timeline::initializeMatrixTimetable(const std::vector<uint>& timetable,
 	}
 
 	std::sort(_matrices.begin(), _matrices.end());
+
+	_keyChannels.resize(numKeys * Pose::CHANNEL_SIZE);
+	for (uint keyId = 0; keyId < numKeys; ++keyId)
+		Pose::decompose(&_matrices[keyId].second->data()[0], &_keyChannels[keyId * Pose::CHANNEL_SIZE]);
 }
 
 void
@@ -120,4 +126,32 @@ Matrix4x4Timeline::interpolate(uint             time,
     }
 
     return output;
-}
\ No newline at end of file
+}
+
+bool
+Matrix4x4Timeline::evaluate(uint	time,
+							float*	channel) const
+{
+	if (_isLocked || _duration == 0 || _matrices.empty())
+		return false;
+
+	const uint		t		= getTimeInRange(time, _duration + 1);
+	const uint		keyId	= getIndexForTime(t, _matrices);
+	const float*	key		= &_keyChannels[keyId * Pose::CHANNEL_SIZE];
+
+	if (!_interpolate || t < _matrices.front().first || t >= _matrices.back().first)
+		std::copy(key, key + Pose::CHANNEL_SIZE, channel);
+	else
+	{
+		const auto& current	= _matrices[keyId];
+		const auto& next	= _matrices[keyId + 1];
+
+		const float ratio	= current.first < next.first 
+			? (t - current.first) / (float)(next.first - current.first)
+			: 0.0f;
+
+		Pose::interpolate(key, key + Pose::CHANNEL_SIZE, ratio, channel);
+	}
+
+	return true;
+}
@@ -0,0 +1,325 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/animation/Pose.hpp"
+
+using namespace minko;
+using namespace minko::animation;
+
+namespace
+{
+	inline
+	void
+	normalizeQuaternion(float* q)
+	{
+		const float length = sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+
+		if (length > 0.f)
+		{
+			const float invLength = 1.f / length;
+
+			q[0] *= invLength;
+			q[1] *= invLength;
+			q[2] *= invLength;
+			q[3] *= invLength;
+		}
+	}
+
+	// normalized lerp along the shortest arc, cheap and good enough for blending
+	inline
+	void
+	nlerpQuaternion(const float* from, const float* to, float ratio, float* output)
+	{
+		const float dot		= from[0] * to[0] + from[1] * to[1] + from[2] * to[2] + from[3] * to[3];
+		const float sign	= dot < 0.f ? -1.f : 1.f;
+
+		for (uint i = 0; i < 4; ++i)
+			output[i] = from[i] + (sign * to[i] - from[i]) * ratio;
+
+		normalizeQuaternion(output);
+	}
+
+	inline
+	void
+	slerpQuaternion(const float* from, const float* to, float ratio, float* output)
+	{
+		float		dot		= from[0] * to[0] + from[1] * to[1] + from[2] * to[2] + from[3] * to[3];
+		const float sign	= dot < 0.f ? -1.f : 1.f;
+
+		dot *= sign;
+		if (dot > 0.9995f)
+		{
+			nlerpQuaternion(from, to, ratio, output);
+			return;
+		}
+
+		const float angle		= acosf(dot);
+		const float invSin		= 1.f / sinf(angle);
+		const float fromRatio	= sinf((1.f - ratio) * angle) * invSin;
+		const float toRatio		= sign * sinf(ratio * angle) * invSin;
+
+		for (uint i = 0; i < 4; ++i)
+			output[i] = from[i] * fromRatio + to[i] * toRatio;
+	}
+
+	// q1 * q2, quaternions stored as (x, y, z, w)
+	inline
+	void
+	multiplyQuaternions(const float* q1, const float* q2, float* output)
+	{
+		const float x = q1[3] * q2[0] + q1[0] * q2[3] + q1[1] * q2[2] - q1[2] * q2[1];
+		const float y = q1[3] * q2[1] - q1[0] * q2[2] + q1[1] * q2[3] + q1[2] * q2[0];
+		const float z = q1[3] * q2[2] + q1[0] * q2[1] - q1[1] * q2[0] + q1[2] * q2[3];
+		const float w = q1[3] * q2[3] - q1[0] * q2[0] - q1[1] * q2[1] - q1[2] * q2[2];
+
+		output[0] = x;
+		output[1] = y;
+		output[2] = z;
+		output[3] = w;
+	}
+
+	inline
+	float
+	channelWeight(float weight, const std::vector<float>* mask, uint channelId)
+	{
+		return mask != nullptr && channelId < mask->size()
+			? weight * (*mask)[channelId]
+			: weight;
+	}
+}
+
+Pose::Pose() :
+	_data()
+{
+}
+
+void
+Pose::numChannels(uint value)
+{
+	_data.resize(value * CHANNEL_SIZE);
+	identity();
+}
+
+void
+Pose::identity()
+{
+	const uint numChannels = this->numChannels();
+
+	for (uint channelId = 0; channelId < numChannels; ++channelId)
+	{
+		float* c = channel(channelId);
+
+		c[0] = 0.f;	c[1] = 0.f;	c[2] = 0.f;
+		c[3] = 0.f;	c[4] = 0.f;	c[5] = 0.f;	c[6] = 1.f;
+		c[7] = 1.f;	c[8] = 1.f;	c[9] = 1.f;
+	}
+}
+
+void
+Pose::copyFrom(const Pose& source)
+{
+	_data = source._data;
+}
+
+void
+Pose::blend(const Pose& source, float weight, const std::vector<float>* mask)
+{
+	const uint numChannels = std::min(this->numChannels(), source.numChannels());
+
+	for (uint channelId = 0; channelId < numChannels; ++channelId)
+	{
+		const float w = channelWeight(weight, mask, channelId);
+
+		if (w <= 0.f)
+			continue;
+
+		float*			c = channel(channelId);
+		const float*	s = source.channel(channelId);
+
+		if (w >= 1.f)
+		{
+			std::copy(s, s + CHANNEL_SIZE, c);
+			continue;
+		}
+
+		c[0] += (s[0] - c[0]) * w;
+		c[1] += (s[1] - c[1]) * w;
+		c[2] += (s[2] - c[2]) * w;
+		nlerpQuaternion(c + 3, s + 3, w, c + 3);
+		c[7] += (s[7] - c[7]) * w;
+		c[8] += (s[8] - c[8]) * w;
+		c[9] += (s[9] - c[9]) * w;
+	}
+}
+
+void
+Pose::add(const Pose& source, const Pose& reference, float weight, const std::vector<float>* mask)
+{
+	static const float identityQuaternion[4] = { 0.f, 0.f, 0.f, 1.f };
+
+	const uint numChannels = std::min(
+		this->numChannels(), std::min(source.numChannels(), reference.numChannels())
+	);
+
+	for (uint channelId = 0; channelId < numChannels; ++channelId)
+	{
+		const float w = channelWeight(weight, mask, channelId);
+
+		if (w <= 0.f)
+			continue;
+
+		float*			c = channel(channelId);
+		const float*	s = source.channel(channelId);
+		const float*	r = reference.channel(channelId);
+
+		c[0] += (s[0] - r[0]) * w;
+		c[1] += (s[1] - r[1]) * w;
+		c[2] += (s[2] - r[2]) * w;
+
+		// delta = conjugate(reference) * source, applied on the right of the current rotation
+		const float	inverseReference[4]	= { -r[3], -r[4], -r[5], r[6] };
+		float		delta[4];
+
+		multiplyQuaternions(inverseReference, s + 3, delta);
+		nlerpQuaternion(identityQuaternion, delta, w, delta);
+		multiplyQuaternions(c + 3, delta, c + 3);
+		normalizeQuaternion(c + 3);
+
+		for (uint i = 7; i < CHANNEL_SIZE; ++i)
+			if (r[i] != 0.f)
+				c[i] *= 1.f + (s[i] / r[i] - 1.f) * w;
+	}
+}
+
+void
+Pose::decompose(const float* m, float* channel)
+{
+	float sx = sqrtf(m[0] * m[0] + m[4] * m[4] + m[8] * m[8]);
+	float sy = sqrtf(m[1] * m[1] + m[5] * m[5] + m[9] * m[9]);
+	float sz = sqrtf(m[2] * m[2] + m[6] * m[6] + m[10] * m[10]);
+
+	const float determinant = m[0] * (m[5] * m[10] - m[6] * m[9])
+		- m[1] * (m[4] * m[10] - m[6] * m[8])
+		+ m[2] * (m[4] * m[9] - m[5] * m[8]);
+
+	if (determinant < 0.f)
+		sx = -sx;
+
+	const float ix = sx != 0.f ? 1.f / sx : 0.f;
+	const float iy = sy != 0.f ? 1.f / sy : 0.f;
+	const float iz = sz != 0.f ? 1.f / sz : 0.f;
+
+	const float r00 = m[0] * ix,	r01 = m[1] * iy,	r02 = m[2] * iz;
+	const float r10 = m[4] * ix,	r11 = m[5] * iy,	r12 = m[6] * iz;
+	const float r20 = m[8] * ix,	r21 = m[9] * iy,	r22 = m[10] * iz;
+
+	float*		q		= channel + 3;
+	const float	trace	= r00 + r11 + r22;
+
+	if (trace > 0.f)
+	{
+		const float s = 0.5f / sqrtf(trace + 1.f);
+
+		q[3] = 0.25f / s;
+		q[0] = (r21 - r12) * s;
+		q[1] = (r02 - r20) * s;
+		q[2] = (r10 - r01) * s;
+	}
+	else if (r00 > r11 && r00 > r22)
+	{
+		const float s = 2.f * sqrtf(std::max(0.f, 1.f + r00 - r11 - r22));
+
+		q[3] = (r21 - r12) / s;
+		q[0] = 0.25f * s;
+		q[1] = (r01 + r10) / s;
+		q[2] = (r02 + r20) / s;
+	}
+	else if (r11 > r22)
+	{
+		const float s = 2.f * sqrtf(std::max(0.f, 1.f + r11 - r00 - r22));
+
+		q[3] = (r02 - r20) / s;
+		q[0] = (r01 + r10) / s;
+		q[1] = 0.25f * s;
+		q[2] = (r12 + r21) / s;
+	}
+	else
+	{
+		const float s = 2.f * sqrtf(std::max(0.f, 1.f + r22 - r00 - r11));
+
+		q[3] = (r10 - r01) / s;
+		q[0] = (r02 + r20) / s;
+		q[1] = (r12 + r21) / s;
+		q[2] = 0.25f * s;
+	}
+
+	normalizeQuaternion(q);
+
+	channel[0] = m[3];
+	channel[1] = m[7];
+	channel[2] = m[11];
+	channel[7] = sx;
+	channel[8] = sy;
+	channel[9] = sz;
+}
+
+void
+Pose::compose(const float* channel, float* m)
+{
+	const float x	= channel[3];
+	const float y	= channel[4];
+	const float z	= channel[5];
+	const float w	= channel[6];
+	const float sx	= channel[7];
+	const float sy	= channel[8];
+	const float sz	= channel[9];
+
+	m[0]	= (1.f - 2.f * (y * y + z * z)) * sx;
+	m[1]	= 2.f * (x * y - z * w) * sy;
+	m[2]	= 2.f * (x * z + y * w) * sz;
+	m[3]	= channel[0];
+
+	m[4]	= 2.f * (x * y + z * w) * sx;
+	m[5]	= (1.f - 2.f * (x * x + z * z)) * sy;
+	m[6]	= 2.f * (y * z - x * w) * sz;
+	m[7]	= channel[1];
+
+	m[8]	= 2.f * (x * z - y * w) * sx;
+	m[9]	= 2.f * (y * z + x * w) * sy;
+	m[10]	= (1.f - 2.f * (x * x + y * y)) * sz;
+	m[11]	= channel[2];
+
+	m[12]	= 0.f;
+	m[13]	= 0.f;
+	m[14]	= 0.f;
+	m[15]	= 1.f;
+}
+
+void
+Pose::interpolate(const float* from, const float* to, float ratio, float* output)
+{
+	output[0] = from[0] + (to[0] - from[0]) * ratio;
+	output[1] = from[1] + (to[1] - from[1]) * ratio;
+	output[2] = from[2] + (to[2] - from[2]) * ratio;
+	slerpQuaternion(from + 3, to + 3, ratio, output + 3);
+	output[7] = from[7] + (to[7] - from[7]) * ratio;
+	output[8] = from[8] + (to[8] - from[8]) * ratio;
+	output[9] = from[9] + (to[9] - from[9]) * ratio;
+}
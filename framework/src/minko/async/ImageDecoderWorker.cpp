@@ -0,0 +1,149 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/async/ImageDecoderWorker.hpp"
+
+#if !defined(EMSCRIPTEN)
+#include "minko/render/AbstractTexture.hpp"
+#include "minko/render/PixelBufferPool.hpp"
+
+#include <condition_variable>
+
+using namespace minko;
+using namespace minko::async;
+using namespace minko::render;
+
+namespace
+{
+	struct DecoderQueue
+	{
+		std::mutex				mutex;
+		std::condition_variable	workerQueued;
+		std::queue<Worker::Ptr>	workers;
+	};
+
+	std::once_flag	threadsStarted;
+
+	// never deleted: the detached threads still wait on the queue while the static objects are
+	// destroyed at exit, and destroying a condition variable that has waiters blocks
+	DecoderQueue*	queue = nullptr;
+
+	void
+	runQueuedWorkers()
+	{
+		while (true)
+		{
+			Worker::Ptr worker;
+
+			{
+				std::unique_lock<std::mutex> lock(queue->mutex);
+
+				queue->workerQueued.wait(lock, []() { return !queue->workers.empty(); });
+				worker = queue->workers.front();
+				queue->workers.pop();
+			}
+
+			worker->run();
+		}
+	}
+}
+
+ImageDecoderWorker::ImageDecoderWorker() :
+	Worker("image-decoder"),
+	_decode(nullptr),
+	_file(nullptr),
+	_resize(false),
+	_resizeSmoothly(false),
+	_width(0),
+	_height(0)
+{
+}
+
+void
+ImageDecoderWorker::decode(DecodeFunction decode, FilePtr file, bool resize, bool resizeSmoothly)
+{
+	if (_busy)
+		throw std::logic_error("The worker is already decoding a file.");
+
+	_decode = decode;
+	_file = file;
+	_resize = resize;
+	_resizeSmoothly = resizeSmoothly;
+}
+
+void
+ImageDecoderWorker::start()
+{
+	_busy = true;
+
+	// the threads live as long as the process and are shared by all the decoders
+	std::call_once(threadsStarted, []()
+	{
+		queue = new DecoderQueue();
+
+		for (uint i = 0; i < std::max(1u, std::thread::hardware_concurrency()); ++i)
+			std::thread(runQueuedWorkers).detach();
+	});
+
+	{
+		std::lock_guard<std::mutex> lock(queue->mutex);
+
+		queue->workers.push(shared_from_this());
+	}
+	queue->workerQueued.notify_one();
+}
+
+MINKO_WORKER("image-decoder", minko::async::ImageDecoderWorker,
+{
+	output(std::make_shared<std::vector<char>>());
+
+	auto file = _file;
+
+	// the workers are kept by the canvas: do not hold the encoded file any longer
+	_file = nullptr;
+
+	if (!_decode || !file || file->empty())
+		return;
+
+	std::vector<unsigned char> rgba;
+
+	if (!_decode(&file->front(), file->size(), _width, _height, rgba))
+		return;
+
+	file = nullptr;
+
+	uint widthGPU	= _width;
+	uint heightGPU	= _height;
+
+	if (_resize)
+	{
+		widthGPU	= std::min(math::clp2(_width), AbstractTexture::MAX_SIZE);
+		heightGPU	= std::min(math::clp2(_height), AbstractTexture::MAX_SIZE);
+	}
+
+	if (widthGPU == _width && heightGPU == _height)
+		_rgba.swap(rgba);
+	else
+	{
+		_rgba = PixelBufferPool::acquire(widthGPU * heightGPU * sizeof(int));
+		AbstractTexture::resizeData(_width, _height, rgba, widthGPU, heightGPU, _resizeSmoothly, _rgba);
+		PixelBufferPool::release(rgba);
+	}
+});
+#endif
@@ -66,3 +66,24 @@ AbstractDiscreteLight::modelToWorldMatrixChangedHandler(std::shared_ptr<data::Co
 {
 	updateModelToWorldMatrix(container->get<math::Matrix4x4::Ptr>(propertyName));
 }
+
+/*static*/
+float
+AbstractDiscreteLight::attenuationRange(float constant, float linear, float quadratic)
+{
+	if (constant < 0.f || linear < 0.f || quadratic < 0.f)
+		return -1.f;
+
+	// the attenuation is 0 where quadratic * d^2 + (linear - 1) * d + constant <= 0
+	const float b = linear - 1.f;
+
+	if (quadratic == 0.f)
+		return b < 0.f ? constant / -b : -1.f;
+
+	const float discriminant = b * b - 4.f * quadratic * constant;
+
+	if (discriminant < 0.f || b >= 0.f)
+		return -1.f;
+
+	return (-b - sqrtf(discriminant)) / (2.f * quadratic);
+}
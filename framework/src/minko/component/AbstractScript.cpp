@@ -77,10 +77,8 @@ AbstractScript::targetAddedHandler(AbstractComponent::Ptr cmp, scene::Node::Ptr
 void
 AbstractScript::addedOrRemovedHandler(scene::Node::Ptr node, scene::Node::Ptr target, scene::Node::Ptr parent)
 {
-    if (target->root()->hasComponent<SceneManager>())
-        setSceneManager(target->root()->component<SceneManager>());
-    else
-        setSceneManager(nullptr);
+    // target might be a descendant of the script's target: only the roots of the script's targets matter
+    findSceneManager();
 }
 
 void
@@ -131,10 +129,13 @@ AbstractScript::frameBeginHandler(SceneManager::Ptr sceneManager, float time, fl
 		}
 
 		if (running(target))
-			update(target);
+			_runningTargets.push_back(target);
 		else
 			_started[target] = false;
 	}
+
+	updateAll(_runningTargets);
+	_runningTargets.clear();
 }
 
 void
@@ -0,0 +1,404 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/component/AnimationBlender.hpp"
+
+#include "minko/component/Animation.hpp"
+#include "minko/component/Transform.hpp"
+#include "minko/component/SceneManager.hpp"
+#include "minko/animation/AbstractTimeline.hpp"
+#include "minko/math/Matrix4x4.hpp"
+#include "minko/scene/Node.hpp"
+#include "minko/scene/NodeSet.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::animation;
+
+AnimationBlender::AnimationBlender() :
+	AbstractScript(),
+	_channelNodes(),
+	_channelMatrices(),
+	_channelMatrixData(),
+	_nodeToChannel(),
+	_layers(),
+	_restPose(Pose::create()),
+	_overridePose(Pose::create()),
+	_pose(Pose::create()),
+	_overrideWeights(),
+	_blendRatios(),
+	_autoUpdate(true),
+	_previousTime(-1.f)
+{
+}
+
+void
+AnimationBlender::targetAddedHandler(AbsCmpPtr cmp, NodePtr target)
+{
+	if (targets().size() > 1)
+		throw std::logic_error("AnimationBlender cannot have more than one target.");
+
+	AbstractScript::targetAddedHandler(cmp, target);
+}
+
+uint
+AnimationBlender::getChannel(NodePtr node)
+{
+	auto foundChannelIt = _nodeToChannel.find(node);
+
+	if (foundChannelIt != _nodeToChannel.end())
+		return foundChannelIt->second;
+
+	const uint	channelId	= _channelNodes.size();
+	auto		matrix		= node->component<Transform>()->matrix();
+
+	_nodeToChannel[node] = channelId;
+	_channelNodes.push_back(node);
+	_channelMatrices.push_back(matrix);
+
+	_restPose->data().resize((channelId + 1) * Pose::CHANNEL_SIZE);
+	Pose::decompose(&matrix->data()[0], _restPose->channel(channelId));
+	_overridePose->data().resize(_restPose->data().size());
+	_pose->data().resize(_restPose->data().size());
+	_overrideWeights.push_back(0.f);
+	_blendRatios.push_back(0.f);
+
+	for (auto& layer : _layers)
+	{
+		layer.tracked.push_back(false);
+		layer.mask.push_back(0.f);
+		layer.pose->data().resize(_restPose->data().size());
+		layer.reference->data().resize(_restPose->data().size());
+	}
+
+	return channelId;
+}
+
+uint
+AnimationBlender::addLayer(const std::vector<AnimationPtr>&	animations,
+						   BlendMode						mode,
+						   float							weight)
+{
+	Layer layer;
+
+	layer.mode			= mode;
+	layer.weight		= weight;
+	layer.targetWeight	= weight;
+	layer.fadeSpeed		= 0.f;
+	layer.time			= 0.f;
+	layer.speed			= 1.f;
+	layer.duration		= 0;
+	layer.isPlaying		= true;
+
+	for (auto& animation : animations)
+	{
+		animation->stop();
+
+		for (auto& node : animation->targets())
+		{
+			if (!node->hasComponent<Transform>())
+				continue;
+
+			const auto channelId = getChannel(node);
+
+			for (auto& timeline : animation->timelines())
+			{
+				layer.tracks.push_back(std::make_pair(channelId, timeline));
+				layer.duration = std::max(layer.duration, timeline->duration() + 1);
+			}
+		}
+	}
+
+	const auto numChannels = _channelNodes.size();
+
+	layer.tracked.resize(numChannels, false);
+	layer.mask.resize(numChannels, 0.f);
+	for (auto& track : layer.tracks)
+	{
+		layer.tracked[track.first]	= true;
+		layer.mask[track.first]		= 1.f;
+	}
+
+	layer.pose		= Pose::create();
+	layer.reference	= Pose::create();
+	layer.pose->copyFrom(*_restPose);
+	layer.reference->copyFrom(*_restPose);
+
+	// additive layers are relative to their first frame
+	evaluateLayer(layer, 0.f, layer.reference);
+
+	_layers.push_back(layer);
+
+	return _layers.size() - 1;
+}
+
+AnimationBlender::Ptr
+AnimationBlender::layerWeight(uint layerId, float weight)
+{
+	auto& layer = _layers[layerId];
+
+	layer.weight		= weight;
+	layer.targetWeight	= weight;
+	layer.fadeSpeed		= 0.f;
+
+	return std::static_pointer_cast<AnimationBlender>(shared_from_this());
+}
+
+AnimationBlender::Ptr
+AnimationBlender::layerSpeed(uint layerId, float speed)
+{
+	_layers[layerId].speed = speed;
+
+	return std::static_pointer_cast<AnimationBlender>(shared_from_this());
+}
+
+AnimationBlender::Ptr
+AnimationBlender::layerTime(uint layerId, uint time)
+{
+	_layers[layerId].time = (float)time;
+
+	return std::static_pointer_cast<AnimationBlender>(shared_from_this());
+}
+
+AnimationBlender::Ptr
+AnimationBlender::playLayer(uint layerId)
+{
+	_layers[layerId].isPlaying = true;
+
+	return std::static_pointer_cast<AnimationBlender>(shared_from_this());
+}
+
+AnimationBlender::Ptr
+AnimationBlender::stopLayer(uint layerId)
+{
+	_layers[layerId].isPlaying = false;
+
+	return std::static_pointer_cast<AnimationBlender>(shared_from_this());
+}
+
+AnimationBlender::Ptr
+AnimationBlender::layerMask(uint layerId, NodePtr node, float weight, bool recursive)
+{
+	auto& layer = _layers[layerId];
+	auto nodes	= recursive
+		? scene::NodeSet::create(node)->descendants(true)->nodes()
+		: std::vector<NodePtr>(1, node);
+
+	for (auto& n : nodes)
+	{
+		auto foundChannelIt = _nodeToChannel.find(n);
+
+		if (foundChannelIt != _nodeToChannel.end() && layer.tracked[foundChannelIt->second])
+			layer.mask[foundChannelIt->second] = weight;
+	}
+
+	return std::static_pointer_cast<AnimationBlender>(shared_from_this());
+}
+
+AnimationBlender::Ptr
+AnimationBlender::clearLayerMask(uint layerId)
+{
+	auto& layer = _layers[layerId];
+
+	for (uint channelId = 0; channelId < layer.mask.size(); ++channelId)
+		layer.mask[channelId] = layer.tracked[channelId] ? 1.f : 0.f;
+
+	return std::static_pointer_cast<AnimationBlender>(shared_from_this());
+}
+
+AnimationBlender::Ptr
+AnimationBlender::fadeLayer(uint layerId, float weight, uint duration)
+{
+	auto& layer = _layers[layerId];
+
+	if (duration == 0)
+		return layerWeight(layerId, weight);
+
+	layer.targetWeight	= weight;
+	layer.fadeSpeed		= fabsf(weight - layer.weight) / (float)duration;
+
+	return std::static_pointer_cast<AnimationBlender>(shared_from_this());
+}
+
+AnimationBlender::Ptr
+AnimationBlender::crossFade(uint layerId, uint duration)
+{
+	for (uint i = 0; i < _layers.size(); ++i)
+	{
+		if (i == layerId)
+			fadeLayer(i, 1.f, duration);
+		else if (_layers[i].mode == BlendMode::OVERRIDE)
+			fadeLayer(i, 0.f, duration);
+	}
+
+	return std::static_pointer_cast<AnimationBlender>(shared_from_this());
+}
+
+void
+AnimationBlender::evaluateLayer(Layer& layer, float time, Pose::Ptr output)
+{
+	const uint t = (uint)std::max(0.f, time);
+
+	for (auto& track : layer.tracks)
+		track.second->evaluate(t, output->channel(track.first));
+}
+
+void
+AnimationBlender::evaluate(float deltaTime)
+{
+	const uint numChannels = _channelNodes.size();
+
+	std::fill(_overrideWeights.begin(), _overrideWeights.end(), 0.f);
+
+	for (auto& layer : _layers)
+	{
+		if (layer.weight != layer.targetWeight)
+		{
+			const float step = layer.fadeSpeed * deltaTime;
+
+			if (fabsf(layer.targetWeight - layer.weight) <= step)
+				layer.weight = layer.targetWeight;
+			else
+				layer.weight += layer.weight < layer.targetWeight ? step : -step;
+		}
+
+		if (layer.isPlaying && layer.duration > 0)
+		{
+			layer.time = fmodf(layer.time + deltaTime * layer.speed, (float)layer.duration);
+			if (layer.time < 0.f)
+				layer.time += (float)layer.duration;
+		}
+
+		if (layer.weight <= 0.f || layer.mode != BlendMode::OVERRIDE)
+			continue;
+
+		evaluateLayer(layer, layer.time, layer.pose);
+
+		// running weighted average: each layer moves the result by w / (sum of weights so far)
+		for (uint channelId = 0; channelId < numChannels; ++channelId)
+		{
+			const float w = layer.weight * layer.mask[channelId];
+
+			_overrideWeights[channelId] += w;
+			_blendRatios[channelId] = w > 0.f ? w / _overrideWeights[channelId] : 0.f;
+		}
+
+		_overridePose->blend(*layer.pose, 1.f, &_blendRatios);
+	}
+
+	_pose->copyFrom(*_restPose);
+	_pose->blend(*_overridePose, 1.f, &_overrideWeights);
+
+	for (auto& layer : _layers)
+	{
+		if (layer.weight <= 0.f || layer.mode != BlendMode::ADDITIVE)
+			continue;
+
+		evaluateLayer(layer, layer.time, layer.pose);
+
+		_pose->add(*layer.pose, *layer.reference, layer.weight, &layer.mask);
+	}
+}
+
+void
+AnimationBlender::apply()
+{
+	const uint numChannels = _channelMatrices.size();
+
+	_channelMatrixData.resize(numChannels * 16);
+
+	for (uint channelId = 0; channelId < numChannels; ++channelId)
+		Pose::compose(_pose->channel(channelId), &_channelMatrixData[channelId * 16]);
+
+	// every matrix is written before any is notified so that listeners see a consistent pose
+	if (numChannels > 0)
+		math::Matrix4x4::initialize(_channelMatrices, &_channelMatrixData[0]);
+}
+
+void
+AnimationBlender::update(NodePtr target)
+{
+	auto sceneManager = target->root()->component<SceneManager>();
+
+	if (sceneManager == nullptr)
+		return;
+
+	const float time		= sceneManager->time();
+	const float deltaTime	= _previousTime < 0.f ? 0.f : time - _previousTime;
+
+	_previousTime = time;
+
+	if (!_autoUpdate)
+		return;
+
+	evaluate(deltaTime);
+	apply();
+}
+
+void
+AnimationBlender::stop(NodePtr target)
+{
+	_previousTime = -1.f;
+}
+
+/*static*/
+void
+AnimationBlender::updateAll(const std::vector<Ptr>& blenders, float deltaTime, uint numThreads)
+{
+#if !defined(EMSCRIPTEN)
+	if (numThreads == 0)
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	const uint numBlenders	= blenders.size();
+	const uint numJobs		= std::min(numThreads, numBlenders);
+
+	if (numJobs > 1)
+	{
+		const uint							blendersPerJob	= (numBlenders + numJobs - 1) / numJobs;
+		std::vector<std::future<void>>		jobs;
+
+		for (uint jobId = 1; jobId < numJobs; ++jobId)
+		{
+			const uint begin	= jobId * blendersPerJob;
+			const uint end		= std::min(numBlenders, begin + blendersPerJob);
+
+			jobs.push_back(std::async(std::launch::async, [&blenders, deltaTime, begin, end]()
+			{
+				for (uint i = begin; i < end; ++i)
+					blenders[i]->evaluate(deltaTime);
+			}));
+		}
+
+		for (uint i = 0; i < std::min(numBlenders, blendersPerJob); ++i)
+			blenders[i]->evaluate(deltaTime);
+
+		for (auto& job : jobs)
+			job.get();
+	}
+	else
+#endif
+	{
+		for (auto& blender : blenders)
+			blender->evaluate(deltaTime);
+	}
+
+	for (auto& blender : blenders)
+		blender->apply();
+}
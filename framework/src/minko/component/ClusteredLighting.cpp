@@ -0,0 +1,413 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/component/ClusteredLighting.hpp"
+
+#include "minko/scene/Node.hpp"
+#include "minko/scene/NodeSet.hpp"
+#include "minko/component/Renderer.hpp"
+#include "minko/component/AbstractDiscreteLight.hpp"
+#include "minko/component/LightCulling.hpp"
+#include "minko/component/PerspectiveCamera.hpp"
+#include "minko/component/PointLight.hpp"
+#include "minko/component/SpotLight.hpp"
+#include "minko/data/StructureProvider.hpp"
+#include "minko/math/Vector2.hpp"
+#include "minko/math/Vector3.hpp"
+#include "minko/math/Matrix4x4.hpp"
+#include "minko/render/LightClusters.hpp"
+#include "minko/render/Texture.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::scene;
+using namespace minko::math;
+
+/*static*/ const uint ClusteredLighting::LIGHT_SIZE				= 17;
+/*static*/ const uint ClusteredLighting::INDICES_TEXTURE_SIZE	= 256;
+
+namespace
+{
+	// width of the lights texture, the smallest power of 2 greater than LIGHT_SIZE
+	const uint LIGHTS_TEXTURE_WIDTH = 32;
+
+	// Stores a float in an RGBA8 texel: RGB hold the 24 bits of mantissa * 0.5 + 0.5 and
+	// A holds the exponent + 128 (see clusteredLighting_decodeFloat() in Phong.fragment.glsl).
+	void
+	encodeFloat(float value, unsigned char* texel)
+	{
+		int		exponent	= 0;
+		float	mantissa	= frexpf(value, &exponent);
+
+		if (exponent < -127)
+		{
+			mantissa = 0.f;
+			exponent = 0;
+		}
+		exponent = std::min(exponent, 127);
+
+		const uint bits = (uint)((mantissa * .5f + .5f) * 16777215.f + .5f);
+
+		texel[0] = (bits >> 16) & 0xff;
+		texel[1] = (bits >> 8) & 0xff;
+		texel[2] = bits & 0xff;
+		texel[3] = exponent + 128;
+	}
+
+	void
+	encodeVector3(Vector3::Ptr value, unsigned char* texels)
+	{
+		encodeFloat(value->x(), texels);
+		encodeFloat(value->y(), texels + 4);
+		encodeFloat(value->z(), texels + 8);
+	}
+}
+
+ClusteredLighting::ClusteredLighting(ContextPtr	context,
+									 uint		maxLights,
+									 uint		maxLightsPerCluster) :
+	_context(context),
+	_maxLights(maxLights),
+	_numJobs(std::max(1u, std::thread::hardware_concurrency())),
+	_clusters(render::LightClusters::create(16, 8, 24, maxLightsPerCluster)),
+	_data(data::StructureProvider::create("clusteredLighting")),
+	_lightsTexture(nullptr),
+	_gridTexture(nullptr),
+	_indicesTexture(nullptr),
+	_depthParams(Vector2::create()),
+	_root(nullptr),
+	_lights(),
+	_spheres(),
+	_numLightIndices(0)
+{
+	if (maxLights == 0 || maxLights > USHRT_MAX)
+		throw std::invalid_argument("maxLights");
+	if (maxLightsPerCluster > 255)
+		throw std::invalid_argument("maxLightsPerCluster");
+}
+
+void
+ClusteredLighting::initialize()
+{
+	const uint gridSize = math::clp2((uint)ceilf(sqrtf((float)_clusters->numClusters())));
+
+	_lightsTexture	= render::Texture::create(_context, LIGHTS_TEXTURE_WIDTH, math::clp2(_maxLights));
+	_gridTexture	= render::Texture::create(_context, gridSize, gridSize);
+	_indicesTexture	= render::Texture::create(_context, INDICES_TEXTURE_SIZE, INDICES_TEXTURE_SIZE);
+
+	for (auto& texture : { _lightsTexture, _gridTexture, _indicesTexture })
+	{
+		texture->data().resize(texture->width() * texture->height() * 4, 0);
+		texture->upload();
+	}
+
+	_data
+		->set<render::AbstractTexture::Ptr>("lights",	_lightsTexture)
+		->set<render::AbstractTexture::Ptr>("grid",		_gridTexture)
+		->set<render::AbstractTexture::Ptr>("indices",	_indicesTexture)
+		->set("maxLightsPerCluster",	(int)_clusters->maxLightsPerCluster())
+		->set("dimensions",				Vector3::create((float)_clusters->numX(), (float)_clusters->numY(), (float)_clusters->numZ()))
+		->set("textureSizes",			Vector3::create((float)gridSize, (float)INDICES_TEXTURE_SIZE, (float)_lightsTexture->height()))
+		->set("depthParams",			_depthParams);
+
+	_targetAddedSlot = targetAdded()->connect(std::bind(
+		&ClusteredLighting::targetAddedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2
+	));
+
+	_targetRemovedSlot = targetRemoved()->connect(std::bind(
+		&ClusteredLighting::targetRemovedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2
+	));
+}
+
+void
+ClusteredLighting::targetAddedHandler(AbsCtrlPtr ctrl, NodePtr target)
+{
+	if (targets().size() > 1)
+		throw std::logic_error("ClusteredLighting cannot have more than one target.");
+	if (!target->hasComponent<PerspectiveCamera>() || !target->hasComponent<Renderer>())
+		throw std::logic_error("ClusteredLighting must be added to a node with a PerspectiveCamera and a Renderer.");
+
+	auto cb = std::bind(
+		&ClusteredLighting::addedOrRemovedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	);
+
+	_addedSlot		= target->added()->connect(cb);
+	_removedSlot	= target->removed()->connect(cb);
+
+	_renderingBeginSlot = target->component<Renderer>()->renderingBegin()->connect(std::bind(
+		&ClusteredLighting::renderingBeginHandler,
+		shared_from_this(),
+		std::placeholders::_1
+	));
+
+	target->data()->addProvider(_data);
+
+	setRoot(target->root());
+}
+
+void
+ClusteredLighting::targetRemovedHandler(AbsCtrlPtr ctrl, NodePtr target)
+{
+	_addedSlot			= nullptr;
+	_removedSlot		= nullptr;
+	_renderingBeginSlot	= nullptr;
+
+	target->data()->removeProvider(_data);
+
+	setRoot(nullptr);
+}
+
+void
+ClusteredLighting::addedOrRemovedHandler(NodePtr node, NodePtr target, NodePtr parent)
+{
+	setRoot(targets()[0]->root());
+}
+
+void
+ClusteredLighting::setRoot(NodePtr root)
+{
+	if (root == _root)
+		return;
+	if (root && root->hasComponent<LightCulling>())
+		throw std::logic_error("ClusteredLighting cannot be combined with LightCulling: both manage the point and spot lights.");
+
+	_rootDescendantAddedSlot	= nullptr;
+	_rootDescendantRemovedSlot	= nullptr;
+	_componentAddedSlot			= nullptr;
+	_componentRemovedSlot		= nullptr;
+
+	for (auto& light : _lights)
+		light->enabled(true);
+	_lights.clear();
+
+	_root = root;
+
+	if (!_root)
+		return;
+
+	_rootDescendantAddedSlot = _root->added()->connect(std::bind(
+		&ClusteredLighting::rootDescendantAddedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	_rootDescendantRemovedSlot = _root->removed()->connect(std::bind(
+		&ClusteredLighting::rootDescendantRemovedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	_componentAddedSlot = _root->componentAdded()->connect(std::bind(
+		&ClusteredLighting::componentAddedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	_componentRemovedSlot = _root->componentRemoved()->connect(std::bind(
+		&ClusteredLighting::componentRemovedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	rootDescendantAddedHandler(nullptr, _root, nullptr);
+}
+
+void
+ClusteredLighting::rootDescendantAddedHandler(NodePtr node, NodePtr target, NodePtr parent)
+{
+	auto descendants = NodeSet::create(target)->descendants(true);
+
+	for (auto descendant : descendants->nodes())
+		for (auto light : descendant->components<AbstractDiscreteLight>())
+			addLight(light);
+}
+
+void
+ClusteredLighting::rootDescendantRemovedHandler(NodePtr node, NodePtr target, NodePtr parent)
+{
+	auto descendants = NodeSet::create(target)->descendants(true);
+
+	for (auto descendant : descendants->nodes())
+		for (auto light : descendant->components<AbstractDiscreteLight>())
+			removeLight(light);
+}
+
+void
+ClusteredLighting::componentAddedHandler(NodePtr node, NodePtr target, AbsCtrlPtr ctrl)
+{
+	addLight(ctrl);
+}
+
+void
+ClusteredLighting::componentRemovedHandler(NodePtr node, NodePtr target, AbsCtrlPtr ctrl)
+{
+	removeLight(ctrl);
+}
+
+void
+ClusteredLighting::addLight(AbsCtrlPtr ctrl)
+{
+	if (!std::dynamic_pointer_cast<PointLight>(ctrl) && !std::dynamic_pointer_cast<SpotLight>(ctrl))
+		return;
+
+	auto light = std::static_pointer_cast<AbstractDiscreteLight>(ctrl);
+
+	// lights beyond maxLights() keep going through the regular forward path
+	if (_lights.size() == _maxLights
+		|| std::find(_lights.begin(), _lights.end(), light) != _lights.end())
+		return;
+
+	_lights.push_back(light);
+	light->enabled(false);
+}
+
+void
+ClusteredLighting::removeLight(AbsCtrlPtr ctrl)
+{
+	auto lightIt = std::find(_lights.begin(), _lights.end(), std::dynamic_pointer_cast<AbstractDiscreteLight>(ctrl));
+
+	if (lightIt == _lights.end())
+		return;
+
+	(*lightIt)->enabled(true);
+	_lights.erase(lightIt);
+}
+
+void
+ClusteredLighting::renderingBeginHandler(RendererPtr renderer)
+{
+	auto target = targets()[0];
+	auto camera = target->component<PerspectiveCamera>();
+
+	updateLightsTexture();
+
+	_clusters->build(
+		_spheres,
+		target->data()->get<Matrix4x4::Ptr>("camera.viewMatrix"),
+		target->data()->get<Matrix4x4::Ptr>("camera.projectionMatrix"),
+		camera->zNear(),
+		camera->zFar(),
+		_numJobs
+	);
+
+	_depthParams->setTo(_clusters->depthScale(), _clusters->depthBias());
+
+	updateClustersTextures();
+
+	_lightsTexture->upload();
+	_gridTexture->upload();
+	_indicesTexture->upload();
+}
+
+void
+ClusteredLighting::updateLightsTexture()
+{
+	auto& texels = _lightsTexture->data();
+
+	_spheres.resize(_lights.size() * 4);
+
+	// each light is stored in one row: position (3 texels), attenuation coefficients (3), color (3),
+	// diffuse, specular, spot direction (3), cos. of the inner and outer cone angles and range
+	for (uint i = 0; i < _lights.size(); ++i)
+	{
+		auto			light		= _lights[i];
+		auto			spotLight	= std::dynamic_pointer_cast<SpotLight>(light);
+		auto			pointLight	= std::dynamic_pointer_cast<PointLight>(light);
+		auto			position	= spotLight ? spotLight->worldPosition() : pointLight->worldPosition();
+		auto			attenuation	= spotLight ? spotLight->attenuationCoefficients() : pointLight->attenuationCoefficients();
+		const float		range		= light->influenceRadius();
+		unsigned char*	row			= &texels[i * LIGHTS_TEXTURE_WIDTH * 4];
+
+		encodeVector3(position, row);
+		encodeVector3(attenuation, row + 12);
+		encodeVector3(light->color(), row + 24);
+		encodeFloat(light->diffuse(), row + 36);
+		encodeFloat(light->specular(), row + 40);
+
+		if (spotLight)
+		{
+			encodeVector3(spotLight->worldDirection(), row + 44);
+			encodeFloat(spotLight->cosInnerConeAngle(), row + 56);
+			encodeFloat(spotLight->cosOuterConeAngle(), row + 60);
+		}
+		else
+		{
+			// cones wider than any direction: the spot factor is always 1
+			encodeVector3(Vector3::zAxis(), row + 44);
+			encodeFloat(-1.5f, row + 56);
+			encodeFloat(-2.f, row + 60);
+		}
+		encodeFloat(range, row + 64);
+
+		_spheres[i * 4]		= position->x();
+		_spheres[i * 4 + 1]	= position->y();
+		_spheres[i * 4 + 2]	= position->z();
+		_spheres[i * 4 + 3]	= range;
+	}
+}
+
+void
+ClusteredLighting::updateClustersTextures()
+{
+	auto&		grid		= _gridTexture->data();
+	auto&		indices		= _indicesTexture->data();
+	const uint	capacity	= INDICES_TEXTURE_SIZE * INDICES_TEXTURE_SIZE * 2;
+	uint		offset		= 0;
+
+	// grid texels store the offset of the cluster's light list (RGB) and its size (A), the
+	// indices texture stores two 16 bits light indices per texel
+	for (uint cluster = 0; cluster < _clusters->numClusters(); ++cluster)
+	{
+		const uint				numLights	= std::min(_clusters->numLights(cluster), capacity - offset);
+		const unsigned short*	lights		= _clusters->lights(cluster);
+		unsigned char*			texel		= &grid[cluster * 4];
+
+		texel[0] = (offset >> 16) & 0xff;
+		texel[1] = (offset >> 8) & 0xff;
+		texel[2] = offset & 0xff;
+		texel[3] = numLights;
+
+		for (uint i = 0; i < numLights; ++i, ++offset)
+		{
+			indices[offset * 2]		= lights[i] & 0xff;
+			indices[offset * 2 + 1]	= lights[i] >> 8;
+		}
+	}
+
+	_numLightIndices = offset;
+}
@@ -28,6 +28,10 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/component/SceneManager.hpp"
 #include "minko/component/Surface.hpp"
 #include "minko/component/Renderer.hpp"
+#include "minko/component/BoundingBox.hpp"
+#include "minko/component/TextureStreamer.hpp"
+#include "minko/math/Box.hpp"
+#include "minko/math/Matrix4x4.hpp"
 
 using namespace minko;
 using namespace minko::component;
@@ -88,6 +92,7 @@ Culling::targetRemovedHandler(AbstractComponent::Ptr ctrl, NodePtr target)
 {
 	_addedSlot			= nullptr;
 	_layoutChangedSlot	= nullptr;
+	_cullingBeginSlot	= nullptr;
 }
 
 void
@@ -111,6 +116,12 @@ Culling::targetAddedToScene(NodePtr node, NodePtr target, NodePtr ancestor)
 			std::placeholders::_2,
 			std::placeholders::_3
 		));
+
+		_cullingBeginSlot = target->root()->component<SceneManager>()->cullingBegin()->connect(std::bind(
+			&Culling::cullingBeginHandler,
+			shared_from_this(),
+			std::placeholders::_1
+		));
 	}
 }
 
@@ -138,18 +149,87 @@ Culling::layoutChanged(NodePtr node, NodePtr target)
 void
 Culling::worldToScreenChanged(std::shared_ptr<data::Container> data, const std::string& propertyName)
 {
-	_frustum->updateFromMatrix(data->get<std::shared_ptr<math::Matrix4x4>>(propertyName));
+	auto worldToScreen = data->get<std::shared_ptr<math::Matrix4x4>>(propertyName);
+
+	_frustum->updateFromMatrix(worldToScreen);
 	
-	auto renderer = targets()[0]->component<Renderer>();
+	auto renderer		= targets()[0]->component<Renderer>();
+	auto root			= targets()[0]->root();
+	auto streamTextures	= root->hasComponent<TextureStreamer>();
+
+	_textureRequests.clear();
 
 	_octTree->testFrustum(
 		_frustum, 
 		[&](NodePtr node)
 		{
 			node->component<Surface>()->computedVisibility(renderer, true);
+
+			if (streamTextures && node->hasComponent<BoundingBox>())
+			{
+				const auto ratio = screenRatio(node->component<BoundingBox>()->box(), worldToScreen);
+
+				for (auto& surface : node->components<Surface>())
+					_textureRequests.push_back(std::make_pair(surface, ratio));
+			}
 		},
 		[&](NodePtr node)
 		{
 			node->component<Surface>()->computedVisibility(renderer, false);
 		});
-}
\ No newline at end of file
+}
+
+void
+Culling::cullingBeginHandler(std::shared_ptr<SceneManager> sceneManager)
+{
+	auto root = targets()[0]->root();
+
+	if (!root->hasComponent<TextureStreamer>())
+		return;
+
+	// the streamer only keeps the requests of the current frame
+	auto textureStreamer = root->component<TextureStreamer>();
+
+	for (auto& surfaceAndRatio : _textureRequests)
+	{
+		auto surface = surfaceAndRatio.first.lock();
+
+		if (surface && !surface->targets().empty())
+			textureStreamer->request(surface, surfaceAndRatio.second);
+	}
+}
+
+float
+Culling::screenRatio(std::shared_ptr<math::Box> box, std::shared_ptr<math::Matrix4x4> worldToScreen)
+{
+	const auto&	m		= worldToScreen->data();
+	const auto	min		= box->bottomLeft();
+	const auto	max		= box->topRight();
+	float		minX	= std::numeric_limits<float>::max();
+	float		minY	= std::numeric_limits<float>::max();
+	float		maxX	= -std::numeric_limits<float>::max();
+	float		maxY	= -std::numeric_limits<float>::max();
+
+	for (uint corner = 0; corner < 8; ++corner)
+	{
+		const float x = corner & 1 ? max->x() : min->x();
+		const float y = corner & 2 ? max->y() : min->y();
+		const float z = corner & 4 ? max->z() : min->z();
+		const float w = m[12] * x + m[13] * y + m[14] * z + m[15];
+
+		// the box crosses the near plane: it can cover the whole viewport
+		if (w <= 1e-6f)
+			return 1.f;
+
+		const float screenX = (m[0] * x + m[1] * y + m[2] * z + m[3]) / w;
+		const float screenY = (m[4] * x + m[5] * y + m[6] * z + m[7]) / w;
+
+		minX = std::min(minX, screenX);
+		minY = std::min(minY, screenY);
+		maxX = std::max(maxX, screenX);
+		maxY = std::max(maxY, screenY);
+	}
+
+	// normalized device coordinates span [-1, 1]
+	return std::min(1.f, 0.5f * std::max(maxX - minX, maxY - minY));
+}
@@ -41,16 +41,15 @@ JobManager::Ptr
 JobManager::pushJob(Job::Ptr Job)
 {
 	float JobPriority	= Job->priority();
-	bool inserted		= false;
-	uint i				= 0;
-	
-	for (; i < _jobs.size() && inserted; ++i)
+
+	// jobs are sorted by increasing priority and consumed from the back: a job is inserted
+	// before those of the same priority so that they run in the order they were pushed
+	auto position = std::find_if(_jobs.begin(), _jobs.end(), [&](Job::Ptr job)
 	{
-		if (_jobs[i]->priority() > JobPriority)
-			inserted = true;
-	}
+		return job->priority() >= JobPriority;
+	});
 
-	_jobs.insert(_jobs.begin() + i, Job);
+	_jobs.insert(position, Job);
 
 	return std::dynamic_pointer_cast<JobManager>(shared_from_this());
 }
@@ -87,7 +86,8 @@ JobManager::end(NodePtr target)
 
 		if (currentJob->complete())
 		{
-			_jobs.pop_back();
+			// step() may have pushed jobs: the current one is not necessarily the last anymore
+			_jobs.erase(std::find(_jobs.begin(), _jobs.end(), currentJob));
 			currentJob->afterLastStep();
 			currentJob = nullptr;
 			if (_jobs.size() == 0)
@@ -0,0 +1,420 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/component/LevelOfDetail.hpp"
+
+#include "minko/scene/Node.hpp"
+#include "minko/scene/NodeSet.hpp"
+#include "minko/component/BoundingBox.hpp"
+#include "minko/component/PerspectiveCamera.hpp"
+#include "minko/component/Renderer.hpp"
+#include "minko/component/SceneManager.hpp"
+#include "minko/component/Surface.hpp"
+#include "minko/data/Container.hpp"
+#include "minko/math/Box.hpp"
+#include "minko/math/Vector3.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::scene;
+using namespace minko::math;
+
+const float LevelOfDetail::DEFAULT_SCREEN_SIZE = .25f;
+
+LevelOfDetail::LevelOfDetail(float hysteresis) :
+	_surfaces(),
+	_screenSizes(),
+	_hysteresis(hysteresis),
+	_root(nullptr),
+	_cameras(),
+	_rendererToLevel()
+{
+}
+
+void
+LevelOfDetail::initialize()
+{
+	_targetAddedSlot = targetAdded()->connect(std::bind(
+		&LevelOfDetail::targetAddedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2
+	));
+
+	_targetRemovedSlot = targetRemoved()->connect(std::bind(
+		&LevelOfDetail::targetRemovedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2
+	));
+}
+
+void
+LevelOfDetail::addLevels(SurfacePtr surface, const std::vector<GeometryPtr>& geometries)
+{
+	removeLevels(surface);
+
+	std::vector<SurfacePtr> levels(1, surface);
+
+	for (auto& geometry : geometries)
+	{
+		auto levelSurface = Surface::create(
+			surface->name(),
+			geometry,
+			surface->material(),
+			surface->effect(),
+			surface->technique()
+		);
+
+		// only drawn by the renderers that select it
+		levelSurface->visible(false);
+		levels.push_back(levelSurface);
+	}
+
+	_surfaces.push_back(levels);
+
+	for (auto& rendererAndLevel : _rendererToLevel)
+		applyLevel(rendererAndLevel.first, rendererAndLevel.second);
+
+	if (!targets().empty())
+		for (uint i = 1; i < levels.size(); ++i)
+			targets()[0]->addComponent(levels[i]);
+}
+
+void
+LevelOfDetail::removeLevels(SurfacePtr surface)
+{
+	auto levelsIt = std::find_if(_surfaces.begin(), _surfaces.end(), [&](const std::vector<SurfacePtr>& levels)
+	{
+		return levels[0] == surface;
+	});
+
+	if (levelsIt == _surfaces.end())
+		return;
+
+	auto levels = *levelsIt;
+
+	_surfaces.erase(levelsIt);
+
+	for (auto& rendererAndLevel : _rendererToLevel)
+		surface->visible(rendererAndLevel.first, true);
+
+	if (!targets().empty())
+		for (uint i = 1; i < levels.size(); ++i)
+			if (targets()[0]->hasComponent(levels[i]))
+				targets()[0]->removeComponent(levels[i]);
+}
+
+uint
+LevelOfDetail::numLevels() const
+{
+	uint numLevels = 1;
+
+	for (auto& levels : _surfaces)
+		numLevels = std::max(numLevels, (uint)levels.size());
+
+	return numLevels;
+}
+
+LevelOfDetail::SurfacePtr
+LevelOfDetail::surface(SurfacePtr surface, uint level) const
+{
+	for (auto& levels : _surfaces)
+		if (levels[0] == surface)
+			return levels[std::min(level, (uint)levels.size() - 1)];
+
+	return surface;
+}
+
+float
+LevelOfDetail::screenSize(uint level) const
+{
+	if (level == 0)
+		return std::numeric_limits<float>::max();
+	if (level <= _screenSizes.size())
+		return _screenSizes[level - 1];
+
+	float size = _screenSizes.empty() ? DEFAULT_SCREEN_SIZE * 2.f : _screenSizes.back();
+
+	for (uint i = _screenSizes.size(); i < level; ++i)
+		size *= .5f;
+
+	return size;
+}
+
+void
+LevelOfDetail::screenSizes(const std::vector<float>& value)
+{
+	for (uint i = 1; i < value.size(); ++i)
+		if (value[i] >= value[i - 1])
+			throw std::invalid_argument("value");
+
+	_screenSizes = value;
+}
+
+uint
+LevelOfDetail::level(RendererPtr renderer) const
+{
+	auto levelIt = _rendererToLevel.find(renderer);
+
+	return levelIt == _rendererToLevel.end() ? 0 : levelIt->second;
+}
+
+uint
+LevelOfDetail::selectLevel(uint currentLevel, float screenSize) const
+{
+	const uint	numLevels	= this->numLevels();
+	uint		level		= std::min(currentLevel, numLevels - 1);
+
+	while (level + 1 < numLevels && screenSize < this->screenSize(level + 1) * (1.f - _hysteresis))
+		++level;
+	while (level > 0 && screenSize > this->screenSize(level) * (1.f + _hysteresis))
+		--level;
+
+	return level;
+}
+
+void
+LevelOfDetail::targetAddedHandler(AbsCtrlPtr ctrl, NodePtr target)
+{
+	if (targets().size() > 1)
+		throw std::logic_error("LevelOfDetail cannot have more than one target.");
+
+	for (auto& levels : _surfaces)
+		for (uint i = 1; i < levels.size(); ++i)
+			target->addComponent(levels[i]);
+
+	auto cb = std::bind(
+		&LevelOfDetail::addedOrRemovedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	);
+
+	_addedSlot		= target->added()->connect(cb);
+	_removedSlot	= target->removed()->connect(cb);
+
+	setRoot(target->root());
+}
+
+void
+LevelOfDetail::targetRemovedHandler(AbsCtrlPtr ctrl, NodePtr target)
+{
+	_addedSlot		= nullptr;
+	_removedSlot	= nullptr;
+
+	setRoot(nullptr);
+
+	for (auto& levels : _surfaces)
+		for (uint i = 1; i < levels.size(); ++i)
+			if (target->hasComponent(levels[i]))
+				target->removeComponent(levels[i]);
+}
+
+void
+LevelOfDetail::addedOrRemovedHandler(NodePtr node, NodePtr target, NodePtr parent)
+{
+	setRoot(targets()[0]->root());
+}
+
+void
+LevelOfDetail::setRoot(NodePtr root)
+{
+	if (root == _root)
+		return;
+
+	_rootDescendantAddedSlot	= nullptr;
+	_rootDescendantRemovedSlot	= nullptr;
+	_componentAddedSlot			= nullptr;
+	_componentRemovedSlot		= nullptr;
+
+	if (_root)
+		rootDescendantRemovedHandler(nullptr, _root, nullptr);
+
+	_root = root;
+	setSceneManager(_root ? _root->component<SceneManager>() : nullptr);
+
+	if (!_root)
+		return;
+
+	_rootDescendantAddedSlot = _root->added()->connect(std::bind(
+		&LevelOfDetail::rootDescendantAddedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	_rootDescendantRemovedSlot = _root->removed()->connect(std::bind(
+		&LevelOfDetail::rootDescendantRemovedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	_componentAddedSlot = _root->componentAdded()->connect(std::bind(
+		&LevelOfDetail::componentAddedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	_componentRemovedSlot = _root->componentRemoved()->connect(std::bind(
+		&LevelOfDetail::componentRemovedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	rootDescendantAddedHandler(nullptr, _root, nullptr);
+}
+
+void
+LevelOfDetail::rootDescendantAddedHandler(NodePtr node, NodePtr target, NodePtr parent)
+{
+	auto descendants = NodeSet::create(target)->descendants(true);
+
+	for (auto descendant : descendants->nodes())
+		if (descendant->hasComponent<PerspectiveCamera>())
+			_cameras.insert(descendant);
+}
+
+void
+LevelOfDetail::rootDescendantRemovedHandler(NodePtr node, NodePtr target, NodePtr parent)
+{
+	auto descendants = NodeSet::create(target)->descendants(true);
+
+	for (auto descendant : descendants->nodes())
+		if (_cameras.erase(descendant) != 0 && descendant->hasComponent<Renderer>())
+			resetLevels(descendant->component<Renderer>());
+}
+
+void
+LevelOfDetail::componentAddedHandler(NodePtr node, NodePtr target, AbsCtrlPtr ctrl)
+{
+	if (std::dynamic_pointer_cast<PerspectiveCamera>(ctrl))
+		_cameras.insert(target);
+	else if (target == _root && std::dynamic_pointer_cast<SceneManager>(ctrl))
+		setSceneManager(std::static_pointer_cast<SceneManager>(ctrl));
+}
+
+void
+LevelOfDetail::componentRemovedHandler(NodePtr node, NodePtr target, AbsCtrlPtr ctrl)
+{
+	if (std::dynamic_pointer_cast<Renderer>(ctrl))
+		resetLevels(std::static_pointer_cast<Renderer>(ctrl));
+	else if (std::dynamic_pointer_cast<PerspectiveCamera>(ctrl))
+	{
+		_cameras.erase(target);
+		if (target->hasComponent<Renderer>())
+			resetLevels(target->component<Renderer>());
+	}
+	else if (target == _root && std::dynamic_pointer_cast<SceneManager>(ctrl))
+		setSceneManager(nullptr);
+}
+
+void
+LevelOfDetail::setSceneManager(SceneManagerPtr sceneManager)
+{
+	if (!sceneManager)
+	{
+		_renderingBeginSlot = nullptr;
+
+		return;
+	}
+
+	// after the transforms (priority 1000) and before the renderers
+	_renderingBeginSlot = sceneManager->renderingBegin()->connect(std::bind(
+		&LevelOfDetail::renderingBeginHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	), 500.f);
+}
+
+void
+LevelOfDetail::renderingBeginHandler(SceneManagerPtr sceneManager, uint frameId, AbsTexturePtr renderTarget)
+{
+	if (_surfaces.empty() || !targets()[0]->hasComponent<BoundingBox>())
+		return;
+
+	for (auto& camera : _cameras)
+	{
+		auto renderer = camera->component<Renderer>();
+
+		if (!renderer)
+			continue;
+
+		auto		levelIt		= _rendererToLevel.find(renderer);
+		const uint	level		= selectLevel(levelIt == _rendererToLevel.end() ? 0 : levelIt->second, computeScreenSize(camera));
+
+		if (levelIt == _rendererToLevel.end() || levelIt->second != level)
+		{
+			_rendererToLevel[renderer] = level;
+			applyLevel(renderer, level);
+		}
+	}
+}
+
+float
+LevelOfDetail::computeScreenSize(NodePtr camera) const
+{
+	auto		box			= targets()[0]->component<BoundingBox>()->box();
+	auto		min			= box->bottomLeft();
+	auto		max			= box->topRight();
+	auto		position	= camera->data()->get<Vector3::Ptr>("camera.position");
+	const float	dx			= max->x() - min->x();
+	const float	dy			= max->y() - min->y();
+	const float	dz			= max->z() - min->z();
+	const float	radius		= .5f * sqrtf(dx * dx + dy * dy + dz * dz);
+	const float	cx			= (min->x() + max->x()) * .5f - position->x();
+	const float	cy			= (min->y() + max->y()) * .5f - position->y();
+	const float	cz			= (min->z() + max->z()) * .5f - position->z();
+	const float	distance	= sqrtf(cx * cx + cy * cy + cz * cz);
+
+	if (distance <= radius)
+		return std::numeric_limits<float>::max();
+
+	return radius / (distance * tanf(camera->component<PerspectiveCamera>()->fieldOfView() * .5f));
+}
+
+void
+LevelOfDetail::applyLevel(RendererPtr renderer, uint level)
+{
+	for (auto& levels : _surfaces)
+	{
+		const uint visibleLevel = std::min(level, (uint)levels.size() - 1);
+
+		for (uint i = 0; i < levels.size(); ++i)
+			levels[i]->visible(renderer, i == visibleLevel);
+	}
+}
+
+void
+LevelOfDetail::resetLevels(RendererPtr renderer)
+{
+	if (_rendererToLevel.erase(renderer) != 0)
+		applyLevel(renderer, 0);
+}
@@ -0,0 +1,408 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/component/LightCulling.hpp"
+
+#include "minko/scene/Node.hpp"
+#include "minko/scene/NodeSet.hpp"
+#include "minko/component/BoundingBox.hpp"
+#include "minko/component/ClusteredLighting.hpp"
+#include "minko/component/PointLight.hpp"
+#include "minko/component/SceneManager.hpp"
+#include "minko/component/SpotLight.hpp"
+#include "minko/component/Surface.hpp"
+#include "minko/data/StructureProvider.hpp"
+#include "minko/math/Box.hpp"
+#include "minko/math/Matrix4x4.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::scene;
+using namespace minko::math;
+using namespace minko::data;
+
+/*static*/ const uint LightCulling::MAX_LIGHTS_PER_SURFACE = 16;
+
+LightCulling::LightCulling(uint maxLightsPerSurface) :
+	AbstractScript(),
+	_maxLightsPerSurface(maxLightsPerSurface),
+	_root(nullptr),
+	_lights(),
+	_surfaceNodes(),
+	_spheres(),
+	_candidates(),
+	_numBoundLights(0)
+{
+}
+
+uint
+LightCulling::numLights(NodePtr surfaceNode) const
+{
+	auto surfaceNodeIt = _surfaceNodes.find(surfaceNode);
+
+	return surfaceNodeIt == _surfaceNodes.end() ? 0 : surfaceNodeIt->second.numLights;
+}
+
+void
+LightCulling::start(NodePtr target)
+{
+	if (target != target->root())
+		throw std::logic_error("LightCulling must be added to the root of the scene.");
+
+	auto clusteredLighting = scene::NodeSet::create(target)
+		->descendants(true)
+		->where([](NodePtr descendant) { return descendant->hasComponent<ClusteredLighting>(); });
+
+	if (!clusteredLighting->nodes().empty())
+		throw std::logic_error("LightCulling cannot be combined with ClusteredLighting: both manage the point and spot lights.");
+
+	auto that = std::static_pointer_cast<LightCulling>(shared_from_this());
+
+	_root = target;
+
+	_rootDescendantAddedSlot = target->added()->connect(std::bind(
+		&LightCulling::rootDescendantAddedHandler,
+		that,
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	_rootDescendantRemovedSlot = target->removed()->connect(std::bind(
+		&LightCulling::rootDescendantRemovedHandler,
+		that,
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	_rootComponentAddedSlot = target->componentAdded()->connect(std::bind(
+		&LightCulling::rootComponentAddedHandler,
+		that,
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	_rootComponentRemovedSlot = target->componentRemoved()->connect(std::bind(
+		&LightCulling::rootComponentRemovedHandler,
+		that,
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	// after the transforms (priority 1000) and before the renderers
+	_renderingBeginSlot = target->component<SceneManager>()->renderingBegin()->connect(std::bind(
+		&LightCulling::renderingBeginHandler,
+		that,
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	), 500.f);
+
+	rootDescendantAddedHandler(nullptr, target, nullptr);
+}
+
+void
+LightCulling::stop(NodePtr target)
+{
+	if (!_root)
+		return;
+
+	_rootDescendantAddedSlot	= nullptr;
+	_rootDescendantRemovedSlot	= nullptr;
+	_rootComponentAddedSlot		= nullptr;
+	_rootComponentRemovedSlot	= nullptr;
+	_renderingBeginSlot			= nullptr;
+
+	rootDescendantRemovedHandler(nullptr, _root, nullptr);
+
+	_root = nullptr;
+}
+
+void
+LightCulling::targetRemovedHandler(AbsCtrlPtr ctrl, NodePtr target)
+{
+	AbstractScript::targetRemovedHandler(ctrl, target);
+
+	stop(target);
+}
+
+void
+LightCulling::rootDescendantAddedHandler(NodePtr node, NodePtr target, NodePtr parent)
+{
+	auto descendants = NodeSet::create(target)->descendants(true);
+
+	for (auto descendant : descendants->nodes())
+	{
+		for (auto light : descendant->components<AbstractDiscreteLight>())
+			addLight(light);
+		if (descendant->hasComponent<Surface>())
+			addSurfaceNode(descendant);
+	}
+}
+
+void
+LightCulling::rootDescendantRemovedHandler(NodePtr node, NodePtr target, NodePtr parent)
+{
+	auto descendants = NodeSet::create(target)->descendants(true);
+
+	for (auto descendant : descendants->nodes())
+	{
+		for (auto light : descendant->components<AbstractDiscreteLight>())
+			removeLight(light);
+		removeSurfaceNode(descendant);
+	}
+}
+
+void
+LightCulling::rootComponentAddedHandler(NodePtr node, NodePtr target, AbsCtrlPtr ctrl)
+{
+	if (std::dynamic_pointer_cast<Surface>(ctrl))
+		addSurfaceNode(target);
+	else if (std::dynamic_pointer_cast<AbstractDiscreteLight>(ctrl))
+		addLight(std::static_pointer_cast<AbstractDiscreteLight>(ctrl));
+}
+
+void
+LightCulling::rootComponentRemovedHandler(NodePtr node, NodePtr target, AbsCtrlPtr ctrl)
+{
+	if (std::dynamic_pointer_cast<Surface>(ctrl))
+	{
+		if (!target->hasComponent<Surface>())
+			removeSurfaceNode(target);
+	}
+	else if (std::dynamic_pointer_cast<AbstractDiscreteLight>(ctrl))
+		removeLight(std::static_pointer_cast<AbstractDiscreteLight>(ctrl));
+}
+
+void
+LightCulling::addLight(LightPtr light)
+{
+	if (!std::dynamic_pointer_cast<PointLight>(light) && !std::dynamic_pointer_cast<SpotLight>(light))
+		return;
+	if (std::find(_lights.begin(), _lights.end(), light) != _lights.end())
+		return;
+
+	_lights.push_back(light);
+	light->enabled(false);
+}
+
+void
+LightCulling::removeLight(LightPtr light)
+{
+	auto lightIt = std::find(_lights.begin(), _lights.end(), light);
+
+	if (lightIt == _lights.end())
+		return;
+
+	light->enabled(true);
+	_lights.erase(lightIt);
+}
+
+void
+LightCulling::addSurfaceNode(NodePtr node)
+{
+	if (_surfaceNodes.count(node) != 0)
+		return;
+
+	auto&		surfaceLights	= _surfaceNodes[node];
+	const uint	n				= _maxLightsPerSurface;
+
+	surfaceLights.provider		= StructureProvider::create("surfaceLights");
+	surfaceLights.positions.resize(n * 4, 0.f);
+	surfaceLights.colors.resize(n * 4, 0.f);
+	surfaceLights.attenuations.resize(n * 4, 0.f);
+	surfaceLights.directions.resize(n * 3, 0.f);
+	surfaceLights.cones.resize(n * 2, 0.f);
+	surfaceLights.numLights		= 0;
+
+	// the arrays never grow: the uniform arrays can point to them once and for all
+	surfaceLights.provider
+		->set<int>("maxLights",	n)
+		->set<int>("numLights",	0)
+		->set<UniformArrayPtr<float>>("position",		UniformArrayPtr<float>(new UniformArray<float>(n, &surfaceLights.positions[0])))
+		->set<UniformArrayPtr<float>>("color",			UniformArrayPtr<float>(new UniformArray<float>(n, &surfaceLights.colors[0])))
+		->set<UniformArrayPtr<float>>("attenuation",	UniformArrayPtr<float>(new UniformArray<float>(n, &surfaceLights.attenuations[0])))
+		->set<UniformArrayPtr<float>>("direction",		UniformArrayPtr<float>(new UniformArray<float>(n, &surfaceLights.directions[0])))
+		->set<UniformArrayPtr<float>>("cone",			UniformArrayPtr<float>(new UniformArray<float>(n, &surfaceLights.cones[0])));
+
+	node->data()->addProvider(surfaceLights.provider);
+}
+
+void
+LightCulling::removeSurfaceNode(NodePtr node)
+{
+	auto surfaceNodeIt = _surfaceNodes.find(node);
+
+	if (surfaceNodeIt == _surfaceNodes.end())
+		return;
+
+	node->data()->removeProvider(surfaceNodeIt->second.provider);
+	_surfaceNodes.erase(surfaceNodeIt);
+}
+
+void
+LightCulling::renderingBeginHandler(SceneManagerPtr sceneManager, uint frameId, AbsTexturePtr renderTarget)
+{
+	_spheres.resize(_lights.size() * 4);
+
+	for (uint i = 0; i < _lights.size(); ++i)
+	{
+		auto spotLight	= std::dynamic_pointer_cast<SpotLight>(_lights[i]);
+		auto position	= spotLight
+			? spotLight->worldPosition()
+			: std::static_pointer_cast<PointLight>(_lights[i])->worldPosition();
+
+		_spheres[i * 4]		= position->x();
+		_spheres[i * 4 + 1]	= position->y();
+		_spheres[i * 4 + 2]	= position->z();
+		_spheres[i * 4 + 3]	= _lights[i]->influenceRadius();
+	}
+
+	_numBoundLights = 0;
+	for (auto& nodeAndLights : _surfaceNodes)
+	{
+		updateSurfaceNode(nodeAndLights.first, nodeAndLights.second);
+		_numBoundLights += nodeAndLights.second.numLights;
+	}
+}
+
+void
+LightCulling::updateSurfaceNode(NodePtr node, SurfaceLights& surfaceLights)
+{
+	float min[3] = { 0.f, 0.f, 0.f };
+	float max[3] = { 0.f, 0.f, 0.f };
+
+	if (node->hasComponent<BoundingBox>())
+	{
+		auto box = node->component<BoundingBox>()->box();
+
+		min[0] = box->bottomLeft()->x();
+		min[1] = box->bottomLeft()->y();
+		min[2] = box->bottomLeft()->z();
+		max[0] = box->topRight()->x();
+		max[1] = box->topRight()->y();
+		max[2] = box->topRight()->z();
+	}
+	else if (node->data()->hasProperty("transform.modelToWorldMatrix"))
+	{
+		const auto& m = node->data()->get<Matrix4x4::Ptr>("transform.modelToWorldMatrix")->data();
+
+		min[0] = max[0] = m[3];
+		min[1] = max[1] = m[7];
+		min[2] = max[2] = m[11];
+	}
+
+	_candidates.clear();
+	for (uint i = 0; i < _lights.size(); ++i)
+	{
+		const float*	sphere		= &_spheres[i * 4];
+		float			distance2	= 0.f;
+
+		for (uint j = 0; j < 3; ++j)
+		{
+			const float d = std::max(0.f, std::max(min[j] - sphere[j], sphere[j] - max[j]));
+
+			distance2 += d * d;
+		}
+
+		if (sphere[3] >= 0.f && distance2 >= sphere[3] * sphere[3])
+			continue;
+
+		// the light's contribution at the closest point of the box
+		auto		light			= _lights[i];
+		auto		color			= light->color();
+		auto		spotLight		= std::dynamic_pointer_cast<SpotLight>(light);
+		auto		coeffs			= spotLight
+			? spotLight->attenuationCoefficients()
+			: std::static_pointer_cast<PointLight>(light)->attenuationCoefficients();
+		const float	distance		= sqrtf(distance2);
+		const float	attenuation		= coeffs->x() < 0.f || coeffs->y() < 0.f || coeffs->z() < 0.f
+			? 1.f
+			: std::max(0.f, 1.f - distance / (coeffs->x() + distance * (coeffs->y() + distance * coeffs->z())));
+		const float	intensity		= std::max(color->x(), std::max(color->y(), color->z()))
+			* std::max(light->diffuse(), light->specular());
+
+		if (attenuation * intensity > 0.f)
+			_candidates.push_back(std::pair<float, uint>(attenuation * intensity, i));
+	}
+
+	const uint numLights = std::min<uint>(_candidates.size(), _maxLightsPerSurface);
+
+	std::partial_sort(
+		_candidates.begin(),
+		_candidates.begin() + numLights,
+		_candidates.end(),
+		[](const std::pair<float, uint>& a, const std::pair<float, uint>& b) { return a.first > b.first; }
+	);
+
+	for (uint i = 0; i < numLights; ++i)
+	{
+		const uint		lightId		= _candidates[i].second;
+		auto			light		= _lights[lightId];
+		auto			spotLight	= std::dynamic_pointer_cast<SpotLight>(light);
+		auto			color		= light->color();
+		auto			coeffs		= spotLight
+			? spotLight->attenuationCoefficients()
+			: std::static_pointer_cast<PointLight>(light)->attenuationCoefficients();
+		float*			position	= &surfaceLights.positions[i * 4];
+		float*			rgbDiffuse	= &surfaceLights.colors[i * 4];
+		float*			attenuation	= &surfaceLights.attenuations[i * 4];
+		float*			direction	= &surfaceLights.directions[i * 3];
+		float*			cone		= &surfaceLights.cones[i * 2];
+
+		std::copy(&_spheres[lightId * 4], &_spheres[lightId * 4] + 4, position);
+
+		rgbDiffuse[0]	= color->x();
+		rgbDiffuse[1]	= color->y();
+		rgbDiffuse[2]	= color->z();
+		rgbDiffuse[3]	= light->diffuse();
+		attenuation[0]	= coeffs->x();
+		attenuation[1]	= coeffs->y();
+		attenuation[2]	= coeffs->z();
+		attenuation[3]	= light->specular();
+
+		if (spotLight)
+		{
+			direction[0]	= spotLight->worldDirection()->x();
+			direction[1]	= spotLight->worldDirection()->y();
+			direction[2]	= spotLight->worldDirection()->z();
+			cone[0]			= spotLight->cosInnerConeAngle();
+			cone[1]			= spotLight->cosOuterConeAngle();
+		}
+		else
+		{
+			// cones wider than any direction: the spot factor is always 1
+			direction[0]	= 0.f;
+			direction[1]	= 0.f;
+			direction[2]	= 1.f;
+			cone[0]			= -1.5f;
+			cone[1]			= -2.f;
+		}
+	}
+
+	if (surfaceLights.numLights != (int)numLights)
+	{
+		surfaceLights.numLights = numLights;
+		surfaceLights.provider->set<int>("numLights", numLights);
+	}
+}
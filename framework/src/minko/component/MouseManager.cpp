@@ -86,31 +86,43 @@ MouseManager::pick(std::shared_ptr<math::Ray> ray)
 
 	for (auto& descendant : descendants->nodes())
 	{
-		auto distance = 0.f;
+		auto boxDistance = 0.f;
 
-		if (descendant->component<BoundingBox>()->box()->cast(ray, distance))
+		if (!descendant->component<BoundingBox>()->box()->cast(ray, boxDistance))
+			continue;
+
+		auto surfaces = descendant->components<Surface>();
+
+		if (surfaces.empty())
 		{
-			hits.push_back(Hit(descendant, distance));
+			hits.push_back(Hit(descendant, boxDistance));
+			continue;
+		}
 
-			/*
-			auto transform = descendant->component<Transform>();
-			uint triangleId = 0;
+		// narrow phase: closest triangle of the node's surfaces, using each geometry's BVH
+		auto transform = descendant->component<Transform>();
+		auto closest = std::numeric_limits<float>::max();
+		uint triangleId = 0;
 
-			if (transform)
-			{
-				transform->worldToModel(ray->origin(), localRay->origin());
-				transform->deltaWorldToModel(ray->direction(), localRay->direction());
-			}
+		if (transform)
+		{
+			transform->worldToModel(ray->origin(), localRay->origin());
+			transform->deltaWorldToModel(ray->direction(), localRay->direction());
+		}
 
-			for (auto& surface : descendant->components<Surface>())
-			{
-				if (surface->geometry()->cast(transform ? localRay : ray, distance, triangleId))
-				{
-					hits.push_back(Hit(descendant, distance));
-				}
-			}
-			*/
+		for (auto& surface : surfaces)
+		{
+			auto distance = 0.f;
+
+			// without CPU-side data, a geometry cannot be tested: its bounding box hit is kept
+			if (!surface->geometry()->bvh())
+				closest = std::min(closest, boxDistance);
+			else if (surface->geometry()->cast(transform ? localRay : ray, distance, triangleId) && distance < closest)
+				closest = distance;
 		}
+
+		if (closest < std::numeric_limits<float>::max())
+			hits.push_back(Hit(descendant, closest));
 	}
 
 	hits.sort([&](Hit& a, Hit& b) { return a.second < b.second; });
@@ -0,0 +1,377 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include "minko/component/OcclusionCulling.hpp"
+
+#include "minko/scene/Node.hpp"
+#include "minko/scene/NodeSet.hpp"
+#include "minko/component/BoundingBox.hpp"
+#include "minko/component/PerspectiveCamera.hpp"
+#include "minko/component/Renderer.hpp"
+#include "minko/component/SceneManager.hpp"
+#include "minko/component/Surface.hpp"
+#include "minko/data/Container.hpp"
+#include "minko/geometry/Geometry.hpp"
+#include "minko/math/Box.hpp"
+#include "minko/math/Matrix4x4.hpp"
+#include "minko/render/IndexBuffer.hpp"
+#include "minko/render/OcclusionBuffer.hpp"
+#include "minko/render/VertexBuffer.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::scene;
+using namespace minko::math;
+
+OcclusionCulling::OcclusionCulling(uint width, uint height) :
+	_buffer(render::OcclusionBuffer::create(width, height)),
+	_numJobs(std::max(1u, std::thread::hardware_concurrency())),
+	_root(nullptr),
+	_occluders(),
+	_surfaceNodes(),
+	_modelToScreen(Matrix4x4::create()),
+	_numTestedSurfaceNodes(0),
+	_numFrustumCulled(0),
+	_numOccluded(0),
+	_cpuTime(0.f)
+{
+}
+
+void
+OcclusionCulling::initialize()
+{
+	_targetAddedSlot = targetAdded()->connect(std::bind(
+		&OcclusionCulling::targetAddedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2
+	));
+
+	_targetRemovedSlot = targetRemoved()->connect(std::bind(
+		&OcclusionCulling::targetRemovedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2
+	));
+}
+
+void
+OcclusionCulling::addOccluder(NodePtr node)
+{
+	_occluders.insert(node);
+}
+
+void
+OcclusionCulling::removeOccluder(NodePtr node)
+{
+	_occluders.erase(node);
+}
+
+void
+OcclusionCulling::targetAddedHandler(AbsCtrlPtr ctrl, NodePtr target)
+{
+	if (targets().size() > 1)
+		throw std::logic_error("OcclusionCulling cannot have more than one target.");
+	if (!target->hasComponent<PerspectiveCamera>() || !target->hasComponent<Renderer>())
+		throw std::logic_error("OcclusionCulling must be added to a node with a PerspectiveCamera and a Renderer.");
+
+	auto cb = std::bind(
+		&OcclusionCulling::addedOrRemovedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	);
+
+	_addedSlot		= target->added()->connect(cb);
+	_removedSlot	= target->removed()->connect(cb);
+
+	setRoot(target->root());
+}
+
+void
+OcclusionCulling::targetRemovedHandler(AbsCtrlPtr ctrl, NodePtr target)
+{
+	_addedSlot		= nullptr;
+	_removedSlot	= nullptr;
+
+	setRoot(nullptr);
+}
+
+void
+OcclusionCulling::addedOrRemovedHandler(NodePtr node, NodePtr target, NodePtr parent)
+{
+	setRoot(targets()[0]->root());
+}
+
+void
+OcclusionCulling::setRoot(NodePtr root)
+{
+	if (root == _root)
+		return;
+
+	_rootDescendantAddedSlot	= nullptr;
+	_rootDescendantRemovedSlot	= nullptr;
+	_componentAddedSlot			= nullptr;
+	_componentRemovedSlot		= nullptr;
+
+	if (_root)
+		rootDescendantRemovedHandler(nullptr, _root, nullptr);
+
+	_root = root;
+	setSceneManager(_root ? _root->component<SceneManager>() : nullptr);
+
+	if (!_root)
+		return;
+
+	_rootDescendantAddedSlot = _root->added()->connect(std::bind(
+		&OcclusionCulling::rootDescendantAddedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	_rootDescendantRemovedSlot = _root->removed()->connect(std::bind(
+		&OcclusionCulling::rootDescendantRemovedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	_componentAddedSlot = _root->componentAdded()->connect(std::bind(
+		&OcclusionCulling::componentAddedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	_componentRemovedSlot = _root->componentRemoved()->connect(std::bind(
+		&OcclusionCulling::componentRemovedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	rootDescendantAddedHandler(nullptr, _root, nullptr);
+}
+
+void
+OcclusionCulling::rootDescendantAddedHandler(NodePtr node, NodePtr target, NodePtr parent)
+{
+	auto descendants = NodeSet::create(target)->descendants(true);
+
+	for (auto descendant : descendants->nodes())
+		if (descendant->hasComponent<Surface>())
+			_surfaceNodes.insert(descendant);
+}
+
+void
+OcclusionCulling::rootDescendantRemovedHandler(NodePtr node, NodePtr target, NodePtr parent)
+{
+	auto descendants	= NodeSet::create(target)->descendants(true);
+	auto renderer		= targets().empty() ? nullptr : targets()[0]->component<Renderer>();
+
+	for (auto descendant : descendants->nodes())
+		if (_surfaceNodes.erase(descendant) != 0 && renderer)
+			for (auto surface : descendant->components<Surface>())
+				surface->computedVisibility(renderer, true);
+}
+
+void
+OcclusionCulling::componentAddedHandler(NodePtr node, NodePtr target, AbsCtrlPtr ctrl)
+{
+	if (std::dynamic_pointer_cast<Surface>(ctrl))
+		_surfaceNodes.insert(target);
+	else if (target == _root && std::dynamic_pointer_cast<SceneManager>(ctrl))
+		setSceneManager(std::static_pointer_cast<SceneManager>(ctrl));
+}
+
+void
+OcclusionCulling::componentRemovedHandler(NodePtr node, NodePtr target, AbsCtrlPtr ctrl)
+{
+	if (std::dynamic_pointer_cast<Surface>(ctrl))
+	{
+		if (!targets().empty())
+			std::static_pointer_cast<Surface>(ctrl)->computedVisibility(targets()[0]->component<Renderer>(), true);
+		if (!target->hasComponent<Surface>())
+			_surfaceNodes.erase(target);
+	}
+	else if (target == _root && std::dynamic_pointer_cast<SceneManager>(ctrl))
+		setSceneManager(nullptr);
+}
+
+void
+OcclusionCulling::setSceneManager(SceneManagerPtr sceneManager)
+{
+	if (!sceneManager)
+	{
+		_renderingBeginSlot = nullptr;
+
+		return;
+	}
+
+	// after the transforms (priority 1000) and before the renderers
+	_renderingBeginSlot = sceneManager->renderingBegin()->connect(std::bind(
+		&OcclusionCulling::renderingBeginHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	), 500.f);
+}
+
+void
+OcclusionCulling::renderingBeginHandler(SceneManagerPtr sceneManager, uint frameId, AbsTexturePtr renderTarget)
+{
+	auto startTime		= std::chrono::high_resolution_clock::now();
+	auto camera			= targets()[0];
+	auto renderer		= camera->component<Renderer>();
+	auto worldToScreen	= camera->data()->get<Matrix4x4::Ptr>("camera.worldToScreenMatrix");
+
+	rasterizeOccluders(worldToScreen);
+
+	_numTestedSurfaceNodes	= 0;
+	_numFrustumCulled		= 0;
+	_numOccluded			= 0;
+
+	for (auto& surfaceNode : _surfaceNodes)
+	{
+		if (!surfaceNode->hasComponent<BoundingBox>())
+			continue;
+
+		// occluders are only frustum tested: their rasterized depth matches their own box and could hide them
+		bool occluded		= false;
+		bool isVisible		= visible(surfaceNode, worldToScreen, _occluders.count(surfaceNode) == 0, occluded);
+
+		++_numTestedSurfaceNodes;
+		if (occluded)
+			++_numOccluded;
+		else if (!isVisible)
+			++_numFrustumCulled;
+
+		for (auto surface : surfaceNode->components<Surface>())
+			surface->computedVisibility(renderer, isVisible);
+	}
+
+	_cpuTime = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::high_resolution_clock::now() - startTime
+	).count() / 1000.f;
+}
+
+void
+OcclusionCulling::rasterizeOccluders(Matrix4x4::Ptr worldToScreen)
+{
+	_buffer->clear();
+
+	for (auto& occluder : _occluders)
+	{
+		if (occluder->root() != _root)
+			continue;
+
+		if (occluder->data()->hasProperty("transform.modelToWorldMatrix"))
+			_modelToScreen->copyFrom(occluder->data()->get<Matrix4x4::Ptr>("transform.modelToWorldMatrix"));
+		else
+			_modelToScreen->identity();
+		_modelToScreen->append(worldToScreen);
+
+		for (auto surface : occluder->components<Surface>())
+		{
+			auto geometry		= surface->geometry();
+			auto vertexBuffers	= geometry->vertexBuffers();
+			auto vertexBufferIt	= std::find_if(
+				vertexBuffers.begin(),
+				vertexBuffers.end(),
+				[](render::VertexBuffer::Ptr vertexBuffer) { return vertexBuffer->hasAttribute("position"); }
+			);
+
+			// the CPU copy of the geometry is needed: occluders must not dispose of it after upload
+			if (vertexBufferIt == vertexBuffers.end() || !geometry->indices()
+				|| (*vertexBufferIt)->data().empty() || geometry->indices()->data().empty())
+				continue;
+
+			auto&		vertexBuffer	= *vertexBufferIt;
+			const auto&	vertices		= vertexBuffer->data();
+			const auto&	indices			= geometry->indices()->data();
+
+			_buffer->addOccluder(
+				&vertices[0],
+				vertexBuffer->vertexSize(),
+				std::get<2>(*vertexBuffer->attribute("position")),
+				vertexBuffer->numVertices(),
+				&indices[0],
+				indices.size(),
+				&_modelToScreen->data()[0]
+			);
+		}
+	}
+
+	_buffer->rasterize(_numJobs);
+}
+
+bool
+OcclusionCulling::visible(NodePtr			surfaceNode,
+						  Matrix4x4::Ptr	worldToScreen,
+						  bool				testOcclusion,
+						  bool&				occluded)
+{
+	const auto&	m			= worldToScreen->data();
+	auto		box			= surfaceNode->component<BoundingBox>()->box();
+	const auto	min			= box->bottomLeft();
+	const auto	max			= box->topRight();
+	float		minX		= std::numeric_limits<float>::max();
+	float		minY		= std::numeric_limits<float>::max();
+	float		maxX		= -std::numeric_limits<float>::max();
+	float		maxY		= -std::numeric_limits<float>::max();
+	float		minDepth	= std::numeric_limits<float>::max();
+
+	occluded = false;
+
+	for (uint corner = 0; corner < 8; ++corner)
+	{
+		const float x = corner & 1 ? max->x() : min->x();
+		const float y = corner & 2 ? max->y() : min->y();
+		const float z = corner & 4 ? max->z() : min->z();
+		const float w = m[12] * x + m[13] * y + m[14] * z + m[15];
+
+		// the box crosses the near plane: keep it
+		if (w <= 1e-6f)
+			return true;
+
+		const float invW = 1.f / w;
+
+		minX		= std::min(minX, (m[0] * x + m[1] * y + m[2] * z + m[3]) * invW);
+		maxX		= std::max(maxX, (m[0] * x + m[1] * y + m[2] * z + m[3]) * invW);
+		minY		= std::min(minY, (m[4] * x + m[5] * y + m[6] * z + m[7]) * invW);
+		maxY		= std::max(maxY, (m[4] * x + m[5] * y + m[6] * z + m[7]) * invW);
+		minDepth	= std::min(minDepth, (m[8] * x + m[9] * y + m[10] * z + m[11]) * invW * .5f + .5f);
+	}
+
+	if (maxX < -1.f || minX > 1.f || maxY < -1.f || minY > 1.f || minDepth > 1.f)
+		return false;
+
+	occluded = testOcclusion && _buffer->occluded(minX, minY, maxX, maxY, minDepth);
+
+	return !occluded;
+}
@@ -30,6 +30,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/math/Matrix4x4.hpp"
 #include "minko/component/Surface.hpp"
 #include "minko/math/Vector4.hpp"
+#include "minko/math/Frustum.hpp"
+#include "minko/component/BoundingBox.hpp"
 
 #include "minko/material/BasicMaterial.hpp"
 #include "minko/component/Transform.hpp"
@@ -40,6 +42,17 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 using namespace minko;
 using namespace component;
 
+// x' = scaleX * x + offsetX * w and y' = scaleY * y + offsetY * w, i.e. a scale and offset in NDC
+static
+void
+transformClipSpace(std::vector<float>& m, float scaleX, float offsetX, float scaleY, float offsetY)
+{
+	for (uint i = 0; i < 4; ++i)
+	{
+		m[i]		= scaleX * m[i] + offsetX * m[12 + i];
+		m[4 + i]	= scaleY * m[4 + i] + offsetY * m[12 + i];
+	}
+}
 
 Picking::Picking(SceneManagerPtr	sceneManager,
 				 AbstractCanvasPtr	canvas,
@@ -55,15 +68,30 @@ Picking::Picking(SceneManagerPtr	sceneManager,
 	_mouseLeftClick(Signal<NodePtr>::create()),
 	_mouseRightClick(Signal<NodePtr>::create()),
 	_mouseOut(Signal<NodePtr>::create()),
-	_mouseOver(Signal<NodePtr>::create())
+	_mouseOver(Signal<NodePtr>::create()),
+	_areaPicked(AreaPickedSignal::create()),
+	_continuous(false),
+	_frustum(math::Frustum::create()),
+	_worldToRegion(math::Matrix4x4::create())
 {
 	_renderer	= Renderer::create(0xFFFF00FF, nullptr, sceneManager->assets()->effect("effect/Picking.effect"), 1000.f);
+	_renderer->enabled(false);
 }
 
 void
 Picking::initialize()
 {
 	_pickingProvider->set("projection", _pickingProjection);
+	_pickingProvider->set<bool>("scissorTest", false);
+	_pickingProvider->set<int>("scissorBox.x", 0);
+	_pickingProvider->set<int>("scissorBox.y", 0);
+	_pickingProvider->set<int>("scissorBox.width", -1);
+	_pickingProvider->set<int>("scissorBox.height", -1);
+
+	_renderer->surfaceFilter([&](SurfacePtr surface)
+	{
+		return _candidates.count(surface) != 0;
+	});
 
 	_mouseMoveSlot = _mouse->move()->connect(std::bind(
 		&Picking::mouseMoveHandler,
@@ -154,10 +182,12 @@ Picking::addedHandler(NodePtr node, NodePtr target, NodePtr parent)
 {
 	if (node == target)
 	{
-		_renderingBeginSlot = _renderer->renderingBegin()->connect(std::bind(
-			&Picking::renderingBegin,
+		_frameBeginSlot = _sceneManager->frameBegin()->connect(std::bind(
+			&Picking::frameBeginHandler,
 			shared_from_this(),
-			std::placeholders::_1));
+			std::placeholders::_1,
+			std::placeholders::_2,
+			std::placeholders::_3));
 
 		_renderingEndSlot = _renderer->beforePresent()->connect(std::bind(
 			&Picking::renderingEnd,
@@ -270,54 +300,188 @@ Picking::removeSurface(SurfacePtr surface)
 	_surfaceToPickingId.erase(surface);
 	_surfaceToProvider.erase(surface);
 	_pickingIdToSurface.erase(surfacePickingId);
+	_candidates.erase(surface);
+
+	if (_lastPickedSurface == surface)
+		_lastPickedSurface = nullptr;
 }
 
 void
 Picking::removedHandler(NodePtr node, NodePtr target, NodePtr parent)
 {
-	_renderingBeginSlot = nullptr;
+	_frameBeginSlot		= nullptr;
 	_renderingEndSlot	= nullptr;
 }
 
 void
-Picking::renderingBegin(RendererPtr renderer)
+Picking::pickArea(int x, int y, uint width, uint height)
 {
-	float mouseX = (float)_mouse->x();
-	float mouseY = (float)_mouse->y();
-	
-	auto perspectiveCamera	= _camera->component<component::PerspectiveCamera>();
-	auto projection			= math::Matrix4x4::create()->perspective(perspectiveCamera->fieldOfView(), perspectiveCamera->aspectRatio(), perspectiveCamera->zNear(), perspectiveCamera->zFar());
+	if (width == 0 || height == 0)
+		throw std::invalid_argument("width/height");
 
-	std::vector<float> pickingProjectionData(projection->data());
-	
-	pickingProjectionData[2] = mouseX / _context->viewportWidth() * 2.f;
-	pickingProjectionData[6] = mouseY / _context->viewportHeight() * 2.f;
+	Query query = { x, y, width, height, true };
+
+	_queries.push_back(query);
+}
+
+void
+Picking::queuePointQuery()
+{
+	for (auto& query : _queries)
+		if (!query.area)
+		{
+			query.x = (int)_mouse->x();
+			query.y = (int)_mouse->y();
+
+			return;
+		}
+
+	Query query = { (int)_mouse->x(), (int)_mouse->y(), 1, 1, false };
+
+	_queries.push_back(query);
+}
+
+void
+Picking::frameBeginHandler(SceneManagerPtr sceneManager, float time, float deltaTime)
+{
+	// pixels requested during the previous frame are available by now without stalling
+	for (auto& readRequest : _readRequests)
+		readQueryResult(readRequest.first, readRequest.second);
+	_readRequests.clear();
+
+	if (_continuous)
+		queuePointQuery();
+
+	if (_queries.empty())
+	{
+		_renderer->enabled(false);
 
+		return;
+	}
+
+	_renderedQuery = _queries.front();
+	_queries.pop_front();
+
+	prepareQuery(_renderedQuery);
+	_renderer->enabled(true);
+}
+
+void
+Picking::prepareQuery(const Query& query)
+{
+	const float viewportWidth	= (float)_context->viewportWidth();
+	const float viewportHeight	= (float)_context->viewportHeight();
+	const float regionX			= (float)query.x;
+	const float regionY			= viewportHeight - (float)(query.y + query.height);
+	const auto& projection		= _camera->data()->get<math::Matrix4x4::Ptr>("camera.projectionMatrix")->data();
+	const auto& view			= _camera->data()->get<math::Matrix4x4::Ptr>("camera.viewMatrix");
+
+	// move the lower left corner of the region to the origin of the viewport, where it is
+	// scissored and read back
+	std::vector<float> pickingProjectionData(projection);
+
+	transformClipSpace(
+		pickingProjectionData,
+		1.f, -2.f * regionX / viewportWidth,
+		1.f, -2.f * regionY / viewportHeight
+	);
 	_pickingProjection->initialize(pickingProjectionData);
+
+	_pickingProvider->set<bool>("scissorTest", true);
+	_pickingProvider->set<int>("scissorBox.width", query.width);
+	_pickingProvider->set<int>("scissorBox.height", query.height);
+
+	// stretch the region over the whole clip space to cull the surfaces outside of it
+	std::vector<float> regionProjectionData(projection);
+	const float scaleX = viewportWidth / query.width;
+	const float scaleY = viewportHeight / query.height;
+
+	transformClipSpace(
+		regionProjectionData,
+		scaleX, scaleX - 1.f - 2.f * regionX / query.width,
+		scaleY, scaleY - 1.f - 2.f * regionY / query.height
+	);
+	_worldToRegion->initialize(regionProjectionData)->prepend(view);
+	_frustum->updateFromMatrix(_worldToRegion);
+
+	_candidates.clear();
+	for (auto& surfaceAndId : _surfaceToPickingId)
+	{
+		auto surface	= surfaceAndId.first;
+		auto node		= surface->targets()[0];
+
+		if (node->hasComponent<BoundingBox>())
+		{
+			auto position = _frustum->testBoundingBox(node->component<BoundingBox>()->box());
+
+			if (position != math::ShapePosition::INSIDE && position != math::ShapePosition::AROUND)
+				continue;
+		}
+
+		_candidates.insert(surface);
+	}
 }
 
 void
 Picking::renderingEnd(RendererPtr renderer)
 {
-	_context->readPixels(0, 0, 1, 1, &_lastColor[0]);
+	_readRequests.push_back(std::pair<Query, uint>(
+		_renderedQuery,
+		_context->beginReadPixels(0, 0, _renderedQuery.width, _renderedQuery.height)
+	));
 
-	uint pickedSurfaceId = (_lastColor[0] << 16) + (_lastColor[1] << 8) + _lastColor[2];
+	// do not let the scissor box leak into the next renderers' clear()
+	_context->setScissorTest(false, render::ScissorBox());
+}
+
+void
+Picking::readQueryResult(const Query& query, uint request)
+{
+	_pixels.resize(query.width * query.height * 4);
+	_context->endReadPixels(request, &_pixels[0]);
 
-	if (_lastPickedSurface != _pickingIdToSurface[pickedSurfaceId])
+	if (!query.area)
 	{
-		if (_lastPickedSurface)
-			_mouseOut->execute(_lastPickedSurface->targets()[0]);
+		uint pickedSurfaceId	= (_pixels[0] << 16) + (_pixels[1] << 8) + _pixels[2];
+		auto surfaceIt			= _pickingIdToSurface.find(pickedSurfaceId);
+		auto pickedSurface		= surfaceIt != _pickingIdToSurface.end() ? surfaceIt->second : nullptr;
 
-		_lastPickedSurface = _pickingIdToSurface[pickedSurfaceId];
+		if (_lastPickedSurface != pickedSurface)
+		{
+			if (_lastPickedSurface)
+				_mouseOut->execute(_lastPickedSurface->targets()[0]);
+
+			_lastPickedSurface = pickedSurface;
 
-		if (_lastPickedSurface)
-			_mouseOver->execute(_lastPickedSurface->targets()[0]);
+			if (_lastPickedSurface)
+				_mouseOver->execute(_lastPickedSurface->targets()[0]);
+		}
+
+		return;
 	}
+
+	std::set<uint> pickedSurfaceIds;
+	std::vector<SurfacePtr> pickedSurfaces;
+
+	for (uint i = 0; i < _pixels.size(); i += 4)
+		pickedSurfaceIds.insert((_pixels[i] << 16) + (_pixels[i + 1] << 8) + _pixels[i + 2]);
+
+	for (auto pickedSurfaceId : pickedSurfaceIds)
+	{
+		auto surfaceIt = _pickingIdToSurface.find(pickedSurfaceId);
+
+		if (surfaceIt != _pickingIdToSurface.end())
+			pickedSurfaces.push_back(surfaceIt->second);
+	}
+
+	_areaPicked->execute(shared_from_this(), pickedSurfaces);
 }
 
 void
 Picking::mouseMoveHandler(MousePtr mouse, int dx, int dy)
 {
+	queuePointQuery();
+
 	if (_lastPickedSurface)
 		_mouseMove->execute(_lastPickedSurface->targets()[0]);
 }
@@ -30,12 +30,42 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/component/SceneManager.hpp"
 #include "minko/file/AssetLibrary.hpp"
 #include "minko/render/DrawCallPool.hpp"
+#include "minko/render/Program.hpp"
+#include "minko/render/Shader.hpp"
+#include "minko/render/ProgramInputs.hpp"
+#include "minko/math/Vector3.hpp"
 
 using namespace minko;
 using namespace minko::component;
 using namespace minko::scene;
 using namespace minko::render;
 
+namespace
+{
+	// must compute gl_Position exactly like the effects do for the EQUAL depth test to pass
+	const std::string DEPTH_VERTEX_SHADER =
+		"#ifdef GL_ES\n"
+		"precision highp float;\n"
+		"#endif\n"
+		"attribute vec3 position;\n"
+		"uniform mat4 modelToWorldMatrix;\n"
+		"uniform mat4 worldToScreenMatrix;\n"
+		"void main(void)\n"
+		"{\n"
+		"	vec4 worldPosition = modelToWorldMatrix * vec4(position, 1.0);\n"
+		"	gl_Position = worldToScreenMatrix * worldPosition;\n"
+		"}\n";
+
+	const std::string DEPTH_FRAGMENT_SHADER =
+		"#ifdef GL_ES\n"
+		"precision mediump float;\n"
+		"#endif\n"
+		"void main(void)\n"
+		"{\n"
+		"	gl_FragColor = vec4(0.0);\n"
+		"}\n";
+}
+
 const unsigned int Renderer::NUM_FALLBACK_ATTEMPTS = 32;
 
 
@@ -49,7 +79,16 @@ Renderer::Renderer(std::shared_ptr<render::AbstractTexture> renderTarget,
 	_surfaceDrawCalls(),
 	_surfaceTechniqueChangedSlot(),
 	_effect(effect),
-	_priority(priority)
+	_priority(priority),
+	_enabled(true),
+	_surfaceFilter(nullptr),
+	_depthPrePass(false),
+	_depthProgram(nullptr),
+	_visibleDrawCalls(),
+	_filteredDrawCalls(),
+	_depthSortedDrawCalls(),
+	_mainPassDrawCalls(),
+	_eyePosition(math::Vector3::create())
 {
 	if (renderTarget)
 	{
@@ -249,6 +288,9 @@ void
 Renderer::render(render::AbstractContext::Ptr	context, 
 				 render::AbstractTexture::Ptr	renderTarget)
 {
+	if (!_enabled)
+		return;
+
 	_drawCalls = _drawCallPool->drawCalls();
 	
 	_renderingBegin->execute(shared_from_this());
@@ -263,8 +305,17 @@ Renderer::render(render::AbstractContext::Ptr	context,
 		(_backgroundColor & 0xff) / 255.f
 	);
 
-	for (auto& drawCall : _drawCalls)
-		drawCall->render(context, renderTarget);
+	if (_depthPrePass)
+		renderWithDepthPrePass(context, renderTarget);
+	else if (_surfaceFilter)
+	{
+		collectVisibleDrawCalls();
+		for (auto& drawCall : _visibleDrawCalls)
+			drawCall->render(context, renderTarget);
+	}
+	else
+		for (auto& drawCall : _drawCalls)
+			drawCall->render(context, renderTarget);
 
 	_beforePresent->execute(shared_from_this());
 
@@ -273,6 +324,94 @@ Renderer::render(render::AbstractContext::Ptr	context,
 	_renderingEnd->execute(shared_from_this());
 }
 
+void
+Renderer::collectVisibleDrawCalls()
+{
+	_visibleDrawCalls.clear();
+
+	if (!_surfaceFilter)
+	{
+		_visibleDrawCalls.assign(_drawCalls.begin(), _drawCalls.end());
+
+		return;
+	}
+
+	// the draw calls of the accepted surfaces are picked from the sorted list to keep its order
+	_filteredDrawCalls.clear();
+	for (auto& surfaceAndDrawCalls : _drawCallPool->surfaceDrawCalls())
+		if (_surfaceFilter(surfaceAndDrawCalls.first))
+			_filteredDrawCalls.insert(surfaceAndDrawCalls.second.begin(), surfaceAndDrawCalls.second.end());
+
+	for (auto& drawCall : _drawCalls)
+		if (_filteredDrawCalls.count(drawCall) != 0)
+			_visibleDrawCalls.push_back(drawCall);
+}
+
+void
+Renderer::renderWithDepthPrePass(AbstractContext::Ptr context, AbstractTexture::Ptr renderTarget)
+{
+	if (!_depthProgram)
+	{
+		_depthProgram = Program::create(
+			context,
+			Shader::create(context, Shader::Type::VERTEX_SHADER, DEPTH_VERTEX_SHADER),
+			Shader::create(context, Shader::Type::FRAGMENT_SHADER, DEPTH_FRAGMENT_SHADER)
+		);
+		_depthProgram->vertexShader()->upload();
+		_depthProgram->fragmentShader()->upload();
+		_depthProgram->upload();
+	}
+
+	collectVisibleDrawCalls();
+
+	// compatibility is evaluated once per draw call and frame, not in the sort comparator
+	_mainPassDrawCalls.clear();
+	_depthSortedDrawCalls.clear();
+	for (auto& drawCall : _visibleDrawCalls)
+	{
+		const bool prePassed = drawCall->depthPrePassCompatible();
+
+		_mainPassDrawCalls.push_back(std::pair<bool, DrawCallPtr>(prePassed, drawCall));
+		if (prePassed)
+			_depthSortedDrawCalls.push_back(std::pair<float, DrawCallPtr>(
+				drawCall->getEyeSpacePosition(_eyePosition)->z(),
+				drawCall
+			));
+	}
+
+	// depth pre-pass, front-to-back
+	std::sort(
+		_depthSortedDrawCalls.begin(),
+		_depthSortedDrawCalls.end(),
+		[](const std::pair<float, DrawCallPtr>& a, const std::pair<float, DrawCallPtr>& b) { return a.first < b.first; }
+	);
+
+	for (auto& depthAndDrawCall : _depthSortedDrawCalls)
+		depthAndDrawCall.second->renderDepth(context, renderTarget, _depthProgram);
+
+	// main pass: within a priority, the pre-passed draw calls come first, grouped by program and textures
+	std::stable_sort(
+		_mainPassDrawCalls.begin(),
+		_mainPassDrawCalls.end(),
+		[](const std::pair<bool, DrawCallPtr>& a, const std::pair<bool, DrawCallPtr>& b)
+		{
+			if (a.second->priority() != b.second->priority())
+				return a.second->priority() > b.second->priority();
+			if (a.first != b.first)
+				return a.first;
+			if (!a.first)
+				return false;
+			if (a.second->program()->id() != b.second->program()->id())
+				return a.second->program()->id() < b.second->program()->id();
+
+			return a.second->textureIds() < b.second->textureIds();
+		}
+	);
+
+	for (auto& prePassedAndDrawCall : _mainPassDrawCalls)
+		prePassedAndDrawCall.second->render(context, renderTarget, prePassedAndDrawCall.first);
+}
+
 void
 Renderer::findSceneManager()
 {
@@ -102,4 +102,10 @@ bool
 SpotLight::attenuationEnabled() const
 {
 	return !( _attenuationCoeffs->x() < 0.0f || _attenuationCoeffs->y() < 0.0f || _attenuationCoeffs->z() < 0.0f);
-}
\ No newline at end of file
+}
+
+float
+SpotLight::influenceRadius() const
+{
+	return attenuationRange(_attenuationCoeffs->x(), _attenuationCoeffs->y(), _attenuationCoeffs->z());
+}
@@ -0,0 +1,414 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/component/StaticBatching.hpp"
+
+#include "minko/scene/Node.hpp"
+#include "minko/scene/NodeSet.hpp"
+#include "minko/component/BoundingBox.hpp"
+#include "minko/component/Surface.hpp"
+#include "minko/component/Transform.hpp"
+#include "minko/file/AssetLibrary.hpp"
+#include "minko/geometry/Geometry.hpp"
+#include "minko/math/Matrix4x4.hpp"
+#include "minko/render/IndexBuffer.hpp"
+#include "minko/render/VertexBuffer.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::scene;
+using namespace minko::math;
+
+const uint StaticBatching::MAX_NUM_VERTICES = 65536;
+
+struct StaticBatching::Chunk
+{
+	SurfacePtr								prototype;
+	std::vector<render::VertexBuffer::Ptr>	layout;
+	std::vector<std::vector<float>>			vertexData;
+	std::vector<unsigned short>				indices;
+	std::vector<SubRange>					subRanges;
+	uint									numVertices;
+};
+
+namespace
+{
+	struct Entry
+	{
+		std::shared_ptr<Node>		node;
+		std::shared_ptr<Surface>	surface;
+		Matrix4x4::Ptr				matrix;
+	};
+
+	typedef std::tuple<std::shared_ptr<data::Provider>, std::shared_ptr<render::Effect>, std::string, std::string, int, int, int> GroupKey;
+
+	std::string
+	layoutSignature(geometry::Geometry::Ptr geometry)
+	{
+		std::stringstream signature;
+
+		for (auto& vertexBuffer : geometry->vertexBuffers())
+		{
+			signature << vertexBuffer->vertexSize() << "{";
+			for (auto& attribute : vertexBuffer->attributes())
+				signature << std::get<0>(*attribute) << ":" << std::get<1>(*attribute) << ":" << std::get<2>(*attribute) << ";";
+			signature << "}";
+		}
+
+		return signature.str();
+	}
+
+	bool
+	hasCpuData(geometry::Geometry::Ptr geometry)
+	{
+		if (!geometry->indices() || geometry->indices()->data().empty() || geometry->vertexBuffers().empty())
+			return false;
+
+		for (auto& vertexBuffer : geometry->vertexBuffers())
+			if (vertexBuffer->data().empty())
+				return false;
+
+		return geometry->hasVertexAttribute("position");
+	}
+
+	// transform of the node relative to the ancestor
+	Matrix4x4::Ptr
+	relativeMatrix(std::shared_ptr<Node> node, std::shared_ptr<Node> ancestor)
+	{
+		auto matrix = Matrix4x4::create();
+
+		for (; node != ancestor; node = node->parent())
+			if (node->hasComponent<Transform>())
+				matrix->append(node->component<Transform>()->matrix());
+
+		return matrix;
+	}
+
+	void
+	transformPoint(const std::vector<float>& m, float* v)
+	{
+		const float x = v[0], y = v[1], z = v[2];
+
+		v[0] = m[0] * x + m[1] * y + m[2] * z + m[3];
+		v[1] = m[4] * x + m[5] * y + m[6] * z + m[7];
+		v[2] = m[8] * x + m[9] * y + m[10] * z + m[11];
+	}
+
+	void
+	transformDirection(const std::vector<float>& m, float* v)
+	{
+		const float x = v[0], y = v[1], z = v[2];
+
+		v[0] = m[0] * x + m[1] * y + m[2] * z;
+		v[1] = m[4] * x + m[5] * y + m[6] * z;
+		v[2] = m[8] * x + m[9] * y + m[10] * z;
+
+		const float length = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+
+		if (length != 0.f)
+		{
+			v[0] /= length;
+			v[1] /= length;
+			v[2] /= length;
+		}
+	}
+}
+
+StaticBatching::StaticBatching(float cellSize) :
+	_cellSize(cellSize),
+	_batchNodes(),
+	_subRanges(),
+	_removedSurfaces(),
+	_numSourceSurfaces(0),
+	_batchingTime(0.f)
+{
+}
+
+void
+StaticBatching::initialize()
+{
+	_targetAddedSlot = targetAdded()->connect(std::bind(
+		&StaticBatching::targetAddedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2
+	));
+
+	_targetRemovedSlot = targetRemoved()->connect(std::bind(
+		&StaticBatching::targetRemovedHandler,
+		shared_from_this(),
+		std::placeholders::_1,
+		std::placeholders::_2
+	));
+}
+
+void
+StaticBatching::targetAddedHandler(AbsCtrlPtr ctrl, NodePtr target)
+{
+	if (targets().size() > 1)
+		throw std::logic_error("StaticBatching cannot have more than one target.");
+}
+
+void
+StaticBatching::targetRemovedHandler(AbsCtrlPtr ctrl, NodePtr target)
+{
+	unbatch();
+}
+
+void
+StaticBatching::batch(AssetLibraryPtr assets)
+{
+	if (targets().empty())
+		throw std::logic_error("StaticBatching must be added to a node before batching.");
+
+	unbatch();
+
+	auto									startTime	= std::chrono::high_resolution_clock::now();
+	auto									target		= targets()[0];
+	auto									descendants	= NodeSet::create(target)->descendants(true);
+	std::map<GroupKey, std::vector<Entry>>	groups;
+
+	for (auto& node : descendants->nodes())
+	{
+		if (!node->hasComponent<Surface>())
+			continue;
+
+		auto matrix = relativeMatrix(node, target);
+
+		for (auto& surface : node->components<Surface>())
+		{
+			auto geometry = surface->geometry();
+
+			if (!hasCpuData(geometry))
+				continue;
+
+			int cell[3] = { 0, 0, 0 };
+
+			if (_cellSize > 0.f)
+			{
+				// cell of the center of the transformed local bounding box
+				auto	positions	= geometry->vertexBuffer("position");
+				auto&	data		= positions->data();
+				uint	offset		= std::get<2>(*positions->attribute("position"));
+				float	min[3]		= { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+				float	max[3]		= { -min[0], -min[1], -min[2] };
+
+				for (uint i = offset; i < data.size(); i += positions->vertexSize())
+					for (uint j = 0; j < 3; ++j)
+					{
+						min[j] = std::min(min[j], data[i + j]);
+						max[j] = std::max(max[j], data[i + j]);
+					}
+
+				float center[3] = { (min[0] + max[0]) * .5f, (min[1] + max[1]) * .5f, (min[2] + max[2]) * .5f };
+
+				transformPoint(matrix->data(), center);
+				for (uint j = 0; j < 3; ++j)
+					cell[j] = (int)floorf(center[j] / _cellSize);
+			}
+
+			Entry entry = { node, surface, matrix };
+
+			groups[GroupKey(
+				surface->material(),
+				surface->effect(),
+				surface->technique(),
+				layoutSignature(geometry),
+				cell[0],
+				cell[1],
+				cell[2]
+			)].push_back(entry);
+		}
+	}
+
+	_numSourceSurfaces = 0;
+
+	for (auto& group : groups)
+	{
+		// nothing to save by merging a surface alone
+		if (group.second.size() < 2)
+			continue;
+
+		Chunk chunk;
+
+		chunk.prototype		= group.second.front().surface;
+		chunk.layout.assign(
+			chunk.prototype->geometry()->vertexBuffers().begin(),
+			chunk.prototype->geometry()->vertexBuffers().end()
+		);
+		chunk.vertexData.resize(chunk.layout.size());
+		chunk.numVertices	= 0;
+
+		for (auto& entry : group.second)
+		{
+			auto		geometry	= entry.surface->geometry();
+			const uint	numVertices	= geometry->vertexBuffers().front()->numVertices();
+
+			if (numVertices > MAX_NUM_VERTICES)
+				continue;
+			if (chunk.numVertices + numVertices > MAX_NUM_VERTICES)
+				flush(chunk, assets);
+
+			// the vertices are transformed once and for all, relative to the target
+			auto		normalMatrix	= Matrix4x4::create()->copyFrom(entry.matrix)->invert()->transpose();
+			const auto&	m				= entry.matrix->data();
+			const auto&	n				= normalMatrix->data();
+			uint		vertexBufferId	= 0;
+
+			for (auto& vertexBuffer : geometry->vertexBuffers())
+			{
+				auto&		vertexData	= chunk.vertexData[vertexBufferId++];
+				const uint	vertexSize	= vertexBuffer->vertexSize();
+				const uint	first		= vertexData.size();
+
+				vertexData.insert(vertexData.end(), vertexBuffer->data().begin(), vertexBuffer->data().begin() + numVertices * vertexSize);
+
+				for (auto& attribute : vertexBuffer->attributes())
+				{
+					const auto&	name	= std::get<0>(*attribute);
+					const uint	offset	= std::get<2>(*attribute);
+
+					if (std::get<1>(*attribute) < 3 || (name != "position" && name != "normal" && name != "tangent"))
+						continue;
+
+					for (uint i = first + offset; i < vertexData.size(); i += vertexSize)
+						if (name == "position")
+							transformPoint(m, &vertexData[i]);
+						else
+							transformDirection(name == "normal" ? n : m, &vertexData[i]);
+				}
+			}
+
+			SubRange subRange = { entry.node, entry.surface, (uint)chunk.indices.size(), (uint)geometry->indices()->data().size() };
+
+			for (auto index : geometry->indices()->data())
+				chunk.indices.push_back(chunk.numVertices + index);
+			chunk.numVertices += numVertices;
+			chunk.subRanges.push_back(subRange);
+
+			_removedSurfaces.push_back(std::make_pair(entry.node, entry.surface));
+			++_numSourceSurfaces;
+		}
+
+		flush(chunk, assets);
+	}
+
+	for (auto& nodeAndSurface : _removedSurfaces)
+		nodeAndSurface.first->removeComponent(nodeAndSurface.second);
+
+	_batchingTime = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::high_resolution_clock::now() - startTime
+	).count() / 1000.f;
+}
+
+void
+StaticBatching::flush(Chunk& chunk, AssetLibraryPtr assets)
+{
+	if (chunk.subRanges.empty())
+		return;
+
+	auto geometry	= geometry::Geometry::create();
+	auto context	= chunk.layout.front()->context();
+
+	for (uint i = 0; i < chunk.layout.size(); ++i)
+	{
+		auto vertexBuffer = render::VertexBuffer::create(context, chunk.vertexData[i]);
+
+		for (auto& attribute : chunk.layout[i]->attributes())
+			vertexBuffer->addAttribute(std::get<0>(*attribute), std::get<1>(*attribute), std::get<2>(*attribute));
+		geometry->addVertexBuffer(vertexBuffer);
+	}
+	geometry->indices(render::IndexBuffer::create(context, chunk.indices));
+
+	auto target		= targets()[0];
+	auto name		= target->name() + "_batch" + std::to_string(_batchNodes.size());
+	auto surface	= Surface::create(
+		chunk.prototype->name(),
+		geometry,
+		chunk.prototype->material(),
+		chunk.prototype->effect(),
+		chunk.prototype->technique()
+	);
+	// the vertices are relative to the target: the batch inherits its world transform
+	auto node		= Node::create(name)
+		->addComponent(Transform::create())
+		->addComponent(surface)
+		->addComponent(BoundingBox::create());
+
+	if (assets)
+		assets->geometry(name, geometry);
+
+	target->addChild(node);
+	_batchNodes.push_back(node);
+	_subRanges[surface] = chunk.subRanges;
+
+	for (auto& vertexData : chunk.vertexData)
+		vertexData.clear();
+	chunk.indices.clear();
+	chunk.subRanges.clear();
+	chunk.numVertices = 0;
+}
+
+void
+StaticBatching::unbatch()
+{
+	for (auto& node : _batchNodes)
+		if (node->parent())
+			node->parent()->removeChild(node);
+
+	for (auto& nodeAndSurface : _removedSurfaces)
+		if (!nodeAndSurface.first->hasComponent(nodeAndSurface.second))
+			nodeAndSurface.first->addComponent(nodeAndSurface.second);
+
+	_batchNodes.clear();
+	_subRanges.clear();
+	_removedSurfaces.clear();
+	_numSourceSurfaces = 0;
+}
+
+const std::vector<StaticBatching::SubRange>&
+StaticBatching::subRanges(SurfacePtr batchSurface) const
+{
+	auto subRangesIt = _subRanges.find(batchSurface);
+
+	if (subRangesIt == _subRanges.end())
+		throw std::invalid_argument("batchSurface");
+
+	return subRangesIt->second;
+}
+
+StaticBatching::NodePtr
+StaticBatching::node(SurfacePtr batchSurface, uint triangle) const
+{
+	const auto&	subRanges	= this->subRanges(batchSurface);
+	auto		subRangeIt	= std::upper_bound(
+		subRanges.begin(),
+		subRanges.end(),
+		triangle * 3,
+		[](uint index, const SubRange& subRange) { return index < subRange.firstIndex; }
+	);
+
+	if (subRangeIt == subRanges.begin())
+		return nullptr;
+
+	--subRangeIt;
+
+	return triangle * 3 < subRangeIt->firstIndex + subRangeIt->numIndices ? subRangeIt->node : nullptr;
+}
@@ -0,0 +1,279 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/component/TextureStreamer.hpp"
+
+#include "minko/AbstractCanvas.hpp"
+#include "minko/component/Surface.hpp"
+#include "minko/data/Provider.hpp"
+#include "minko/render/Texture.hpp"
+
+using namespace minko;
+using namespace minko::component;
+
+TextureStreamer::TextureStreamer(uint budget) :
+	AbstractScript(),
+	_budget(budget),
+	_maxUploadsPerFrame(4),
+	_viewportSize(0),
+	_lodBias(0.f),
+	_entries(),
+	_textureToEntry(),
+	_textures(),
+	_requestId(0),
+	_residentMemory(0),
+	_numUploads(0),
+	_numEvictions(0)
+{
+}
+
+void
+TextureStreamer::clearRequests()
+{
+	for (auto& entry : _entries)
+	{
+		auto texture = entry.texture.lock();
+
+		if (texture)
+			entry.requiredMipLevel = texture->numMipLevels();
+	}
+}
+
+void
+TextureStreamer::request(SurfacePtr surface, float screenRatio)
+{
+	for (auto& nameAndValue : surface->material()->values())
+	{
+		auto abstractTexture = Any::cast<render::AbstractTexture::Ptr>(&nameAndValue.second);
+		auto texture = abstractTexture
+			? std::dynamic_pointer_cast<render::Texture>(*abstractTexture)
+			: nullptr;
+
+		if (texture == nullptr)
+		{
+			auto texturePtr = Any::cast<render::Texture::Ptr>(&nameAndValue.second);
+
+			if (texturePtr)
+				texture = *texturePtr;
+		}
+
+		if (texture && texture->streamed())
+			request(texture, requiredMipLevel(texture, screenRatio));
+	}
+}
+
+void
+TextureStreamer::request(TexturePtr texture, uint mipLevel)
+{
+	auto entryIt = _textureToEntry.find(texture.get());
+
+	if (entryIt == _textureToEntry.end())
+	{
+		Entry entry = { texture, texture.get(), mipLevel, _requestId };
+
+		_textureToEntry[texture.get()] = _entries.size();
+		_entries.push_back(entry);
+
+		return;
+	}
+
+	auto& entry = _entries[entryIt->second];
+
+	// the first request of a frame replaces the requirement of the previous one, and a new
+	// texture can be allocated where a destroyed one was
+	if (entry.requestId != _requestId || entry.texture.expired())
+		entry.requiredMipLevel = mipLevel;
+	else
+		entry.requiredMipLevel = std::min(entry.requiredMipLevel, mipLevel);
+
+	entry.texture	= texture;
+	entry.requestId	= _requestId;
+}
+
+void
+TextureStreamer::remove(TexturePtr texture)
+{
+	auto entryIt = _textureToEntry.find(texture.get());
+
+	if (entryIt != _textureToEntry.end())
+		removeEntry(entryIt->second);
+}
+
+void
+TextureStreamer::removeEntry(uint index)
+{
+	_textureToEntry.erase(_entries[index].key);
+	if (index + 1 != _entries.size())
+	{
+		_entries[index] = _entries.back();
+		_textureToEntry[_entries[index].key] = index;
+	}
+	_entries.pop_back();
+}
+
+uint
+TextureStreamer::requiredMipLevel(TexturePtr texture, float screenRatio) const
+{
+	auto		canvas			= AbstractCanvas::defaultCanvas();
+	const uint	viewportSize	= _viewportSize != 0 || canvas == nullptr
+		? _viewportSize
+		: std::max(canvas->width(), canvas->height());
+	const float	numPixels		= std::max(1.f, screenRatio * viewportSize);
+	const float	textureSize		= (float)std::max(texture->width(), texture->height());
+	const int	level			= (int)floorf(log2f(textureSize / numPixels) + _lodBias);
+
+	return (uint)std::max(0, std::min(level, (int)texture->numMipLevels() - 1));
+}
+
+uint
+TextureStreamer::requiredMemory() const
+{
+	uint size = 0;
+
+	for (auto& entry : _entries)
+	{
+		auto texture = entry.texture.lock();
+
+		if (texture && entry.requiredMipLevel < texture->numMipLevels())
+			size += texture->mipLevelsMemory(entry.requiredMipLevel);
+	}
+
+	return size;
+}
+
+uint
+TextureStreamer::numPendingTextures() const
+{
+	uint numPending = 0;
+
+	for (auto& entry : _entries)
+	{
+		auto texture = entry.texture.lock();
+
+		if (texture && texture->residentMipLevel() > entry.requiredMipLevel)
+			++numPending;
+	}
+
+	return numPending;
+}
+
+void
+TextureStreamer::update(NodePtr target)
+{
+	_numUploads		= 0;
+	_numEvictions	= 0;
+
+	for (uint i = 0; i < _entries.size();)
+		if (_entries[i].texture.expired())
+			removeEntry(i);
+		else
+			++i;
+
+	// locked once for the whole frame
+	for (auto& entry : _entries)
+		_textures.push_back(entry.texture.lock());
+
+	// textures not requested since the previous update are not required anymore
+	for (uint i = 0; i < _entries.size(); ++i)
+		if (_entries[i].requestId != _requestId)
+			_entries[i].requiredMipLevel = _textures[i]->numMipLevels();
+	++_requestId;
+
+	// textures can be disposed or re-uploaded behind our back: the resident memory is not cached
+	_residentMemory = 0;
+	for (auto& texture : _textures)
+		if (texture->residentMipLevel() < texture->numMipLevels())
+			_residentMemory += texture->mipLevelsMemory(texture->residentMipLevel());
+
+	std::vector<uint> pending;
+
+	for (uint i = 0; i < _entries.size(); ++i)
+		if (_textures[i]->residentMipLevel() > _entries[i].requiredMipLevel)
+			pending.push_back(i);
+
+	// largest deficit first
+	std::sort(pending.begin(), pending.end(), [&](uint a, uint b)
+	{
+		return _textures[a]->residentMipLevel() - _entries[a].requiredMipLevel
+			> _textures[b]->residentMipLevel() - _entries[b].requiredMipLevel;
+	});
+
+	for (auto index : pending)
+	{
+		if (_numUploads >= _maxUploadsPerFrame)
+			break;
+
+		auto		texture			= _textures[index];
+		const uint	residentLevel	= texture->residentMipLevel();
+		const uint	level			= std::min(residentLevel, texture->numMipLevels()) - 1;
+		const uint	currentSize		= residentLevel < texture->numMipLevels() ? texture->mipLevelsMemory(residentLevel) : 0;
+		const uint	extraSize		= texture->mipLevelsMemory(level) - currentSize;
+
+		if (_residentMemory + extraSize > _budget && !makeRoom(extraSize, index))
+			break;
+
+		texture->uploadMipLevels(level);
+		_residentMemory += extraSize;
+		++_numUploads;
+	}
+
+	// the finer levels of the textures that reached their required level are not needed on the
+	// CPU until they are requested again
+	for (uint i = 0; i < _entries.size(); ++i)
+		if (_textures[i]->residentMipLevel() <= _entries[i].requiredMipLevel)
+			_textures[i]->disposeResidentData();
+
+	_textures.clear();
+}
+
+bool
+TextureStreamer::makeRoom(uint size, uint exclude)
+{
+	// evict from the textures with the most levels beyond their requirement
+	std::vector<uint> candidates;
+
+	for (uint i = 0; i < _entries.size(); ++i)
+		if (i != exclude && _textures[i]->residentMipLevel() < _entries[i].requiredMipLevel
+			&& _textures[i]->residentMipLevel() + 1 < _textures[i]->numMipLevels())
+			candidates.push_back(i);
+
+	std::sort(candidates.begin(), candidates.end(), [&](uint a, uint b)
+	{
+		return _entries[a].requiredMipLevel - _textures[a]->residentMipLevel()
+			> _entries[b].requiredMipLevel - _textures[b]->residentMipLevel();
+	});
+
+	for (auto index : candidates)
+	{
+		if (_residentMemory + size <= _budget)
+			break;
+
+		auto		texture			= _textures[index];
+		const uint	residentLevel	= texture->residentMipLevel();
+		const uint	level			= std::min(_entries[index].requiredMipLevel, texture->numMipLevels() - 1);
+		const uint	freedSize		= texture->mipLevelsMemory(residentLevel) - texture->mipLevelsMemory(level);
+
+		texture->uploadMipLevels(level);
+		_residentMemory -= freedSize;
+		++_numEvictions;
+	}
+
+	return _residentMemory + size <= _budget;
+}
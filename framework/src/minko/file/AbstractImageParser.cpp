@@ -0,0 +1,168 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/file/AbstractImageParser.hpp"
+
+#include "minko/file/Options.hpp"
+#include "minko/file/AssetLibrary.hpp"
+#include "minko/render/Texture.hpp"
+#include "minko/render/CubeTexture.hpp"
+#include "minko/render/PixelBufferPool.hpp"
+#include "minko/AbstractCanvas.hpp"
+#include "minko/async/ImageDecoderWorker.hpp"
+
+using namespace minko;
+using namespace minko::file;
+
+AbstractImageParser::AbstractImageParser(const std::string& format, DecodeFunction decode) :
+	_format(format),
+	_decode(decode)
+{
+}
+
+void
+AbstractImageParser::parse(const std::string&					filename,
+						   const std::string&					resolvedFilename,
+						   std::shared_ptr<Options>				options,
+						   const std::vector<unsigned char>&	data,
+						   std::shared_ptr<AssetLibrary>		assetLibrary)
+{
+#if !defined(EMSCRIPTEN)
+	if (options->loadAsynchronously() && AbstractCanvas::defaultCanvas() != nullptr)
+	{
+		parseAsynchronously(filename, options, data, assetLibrary);
+
+		return;
+	}
+#endif
+
+	std::vector<unsigned char>	rgba;
+	uint						width;
+	uint						height;
+
+	if (!_decode(data.empty() ? nullptr : &data[0], data.size(), width, height, rgba))
+		throw std::invalid_argument("file " + filename + " is not a valid " + _format + " file");
+
+	// copy of the file kept to decode it again, only for streamed textures
+	SourcePtr source = nullptr;
+
+	if (options->streamTextures() && !options->isCubeTexture())
+		source = std::make_shared<std::vector<unsigned char>>(data);
+
+	createTexture(filename, options, width, height, std::move(rgba), source, assetLibrary);
+}
+
+void
+AbstractImageParser::parseAsynchronously(const std::string&					filename,
+										 std::shared_ptr<Options>			options,
+										 const std::vector<unsigned char>&	data,
+										 std::shared_ptr<AssetLibrary>		assetLibrary)
+{
+#if !defined(EMSCRIPTEN)
+	auto canvas = AbstractCanvas::defaultCanvas();
+
+	if (!canvas->isWorkerRegistered("image-decoder"))
+		canvas->registerWorker<async::ImageDecoderWorker>("image-decoder");
+
+	auto worker	= std::static_pointer_cast<async::ImageDecoderWorker>(canvas->getWorker("image-decoder"));
+	auto file	= std::make_shared<std::vector<unsigned char>>(data);
+	auto source	= options->streamTextures() && !options->isCubeTexture() ? file : nullptr;
+
+	worker->decode(_decode, file, !options->isCubeTexture(), options->resizeSmoothly());
+
+	// the worker executes the slot: it must not hold the worker, which would never be released
+	auto decoder = worker.get();
+
+	// the image is decoded and resized by the worker, only the upload happens here
+	_workerSlots.push_back(worker->complete()->connect([=](async::Worker::MessagePtr)
+	{
+		std::vector<unsigned char> rgba;
+
+		rgba.swap(decoder->rgba());
+
+		if (rgba.empty())
+			error()->execute(shared_from_this(), ParserError("file " + filename + " is not a valid " + _format + " file"));
+		else
+			createTexture(filename, options, decoder->width(), decoder->height(), std::move(rgba), source, assetLibrary);
+	}));
+#endif
+}
+
+void
+AbstractImageParser::createTexture(const std::string&				filename,
+								   std::shared_ptr<Options>			options,
+								   uint								width,
+								   uint								height,
+								   std::vector<unsigned char>		rgba,
+								   SourcePtr						source,
+								   std::shared_ptr<AssetLibrary>	assetLibrary)
+{
+	render::AbstractTexture::Ptr texture = nullptr;
+
+	if (!options->isCubeTexture())
+	{
+		auto texture2d = render::Texture::create(
+			options->context(), 
+			width, 
+			height, 
+			options->generateMipmaps(), 
+			false, 
+			options->resizeSmoothly(), 
+			filename
+		);
+		auto decode = _decode;
+
+		texture2d->streamed(options->streamTextures());
+		// the streamer releases the CPU data once resident: the file is decoded again when needed
+		if (source)
+			texture2d->dataSource([=](render::Texture& streamedTexture)
+			{
+				std::vector<unsigned char>	decoded;
+				uint						decodedWidth;
+				uint						decodedHeight;
+
+				if (decode(&source->front(), source->size(), decodedWidth, decodedHeight, decoded))
+					streamedTexture.data(std::move(decoded));
+			});
+		// no copy when the image is already at the GPU dimensions
+		texture2d->data(std::move(rgba));
+		texture = texture2d;
+	}
+	else
+	{
+		texture = render::CubeTexture::create(
+			options->context(), 
+			width, 
+			height, 
+			options->generateMipmaps(), 
+			false, 
+			options->resizeSmoothly(), 
+			filename
+		);
+
+		texture->data(&rgba[0]);
+		render::PixelBufferPool::release(rgba);
+	}
+
+	texture->upload();
+
+	assetLibrary->texture(filename, texture);
+
+	complete()->execute(shared_from_this());
+}
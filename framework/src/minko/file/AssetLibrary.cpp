@@ -25,6 +25,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/file/Options.hpp"
 #include "minko/file/AbstractParser.hpp"
 #include "minko/file/EffectParser.hpp"
+#include "minko/file/KTXParser.hpp"
 #include "minko/render/Texture.hpp"
 #include "minko/render/CubeTexture.hpp"
 #include "minko/render/Effect.hpp"
@@ -42,6 +43,7 @@ AssetLibrary::create(AbsContextPtr context)
 	auto al = std::shared_ptr<AssetLibrary>(new AssetLibrary(context));
 
 	al->registerParser<file::EffectParser>("effect");
+	al->registerParser<file::KTXParser>("ktx");
 	al->registerProtocol<FileLoader>("file");
 
 	return al;
@@ -381,6 +383,9 @@ AssetLibrary::loaderCompleteHandler(std::shared_ptr<file::AbstractLoader> loader
 
 			finalize(filename);
 		}));
+		_parserErrorSlots.push_back(parser->error()->connect(std::bind(
+			&AssetLibrary::parserErrorHandler, shared_from_this(), std::placeholders::_1, std::placeholders::_2
+		)));
 
         try
         {
@@ -394,12 +399,7 @@ AssetLibrary::loaderCompleteHandler(std::shared_ptr<file::AbstractLoader> loader
         }
         catch (ParserError parserError)
         {
-            if (_parserError->numCallbacks() != 0)
-                _parserError->execute(shared_from_this(), parser);
-#ifdef DEBUG
-            else
-                std::cerr << parserError.what() << std::endl;
-#endif
+            parserErrorHandler(parser, parserError);
         }
 	}
 	else
@@ -410,6 +410,17 @@ AssetLibrary::loaderCompleteHandler(std::shared_ptr<file::AbstractLoader> loader
 	}
 }
 
+void
+AssetLibrary::parserErrorHandler(std::shared_ptr<file::AbstractParser> parser, const file::ParserError& parserError)
+{
+	if (_parserError->numCallbacks() != 0)
+		_parserError->execute(shared_from_this(), parser);
+#ifdef DEBUG
+	else
+		std::cerr << parserError.what() << std::endl;
+#endif
+}
+
 void
 AssetLibrary::finalize(const std::string& filename)
 {
@@ -421,6 +432,7 @@ AssetLibrary::finalize(const std::string& filename)
 	{
 		_loaderSlots.clear();
 		_parserSlots.clear();
+		_parserErrorSlots.clear();
 		_filenameToLoader.clear();
 		_filenameToOptions.clear();
 
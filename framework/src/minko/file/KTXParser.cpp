@@ -0,0 +1,244 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/file/KTXParser.hpp"
+
+#include "minko/file/Options.hpp"
+#include "minko/file/AssetLibrary.hpp"
+#include "minko/render/Texture.hpp"
+#include "minko/render/TextureCompression.hpp"
+
+using namespace minko;
+using namespace minko::file;
+
+namespace
+{
+	const unsigned char	KTX_IDENTIFIER[12]	= { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+	const uint			KTX_HEADER_SIZE		= 64;
+	const uint			KTX_ENDIANNESS		= 0x04030201;
+
+	const uint			GL_UNSIGNED_BYTE_	= 0x1401;
+	const uint			GL_RGB_				= 0x1907;
+	const uint			GL_RGBA_			= 0x1908;
+	const uint			GL_RGB8_			= 0x8051;
+	const uint			GL_RGBA8_			= 0x8058;
+
+	inline
+	uint
+	readUInt(const std::vector<unsigned char>& data, uint offset, bool bigEndian)
+	{
+		return bigEndian
+			? (uint)data[offset] << 24 | data[offset + 1] << 16 | data[offset + 2] << 8 | data[offset + 3]
+			: (uint)data[offset + 3] << 24 | data[offset + 2] << 16 | data[offset + 1] << 8 | data[offset];
+	}
+}
+
+void
+KTXParser::parse(const std::string&					filename,
+				 const std::string&					resolvedFilename,
+				 std::shared_ptr<Options>			options,
+				 const std::vector<unsigned char>&	data,
+				 std::shared_ptr<AssetLibrary>		assetLibrary)
+{
+	render::TextureFormat					format;
+	uint									width;
+	uint									height;
+	std::vector<std::vector<unsigned char>>	levels;
+
+	if (!read(data, format, width, height, levels))
+		throw std::invalid_argument("file " + filename + " is not a valid KTX file");
+	if (options->isCubeTexture())
+		throw std::invalid_argument("file " + filename + ": KTX cube textures are not supported");
+
+	auto texture = render::Texture::create(
+		options->context(),
+		width,
+		height,
+		options->generateMipmaps(),
+		false,
+		options->resizeSmoothly(),
+		filename
+	);
+
+	texture->streamed(options->streamTextures());
+
+	if (render::TextureCompression::isCompressed(format))
+		texture->compressedData(format, std::move(levels));
+	else if (levels.size() > 1 && math::isp2(width) && math::isp2(height))
+	{
+		if (format == render::TextureFormat::RGB)
+			for (auto& level : levels)
+			{
+				std::vector<unsigned char> rgba(level.size() / 3 * 4, 255);
+
+				for (uint i = 0, j = 0; i < level.size(); i += 3, j += 4)
+					std::memcpy(&rgba[j], &level[i], 3);
+
+				level.swap(rgba);
+			}
+
+		texture->mipLevelsData(std::move(levels));
+	}
+	else
+		texture->data(&levels[0].front(), format);
+
+	texture->upload();
+
+	assetLibrary->texture(filename, texture);
+
+	complete()->execute(shared_from_this());
+}
+
+bool
+KTXParser::read(const std::vector<unsigned char>&			data,
+				render::TextureFormat&						format,
+				uint&										width,
+				uint&										height,
+				std::vector<std::vector<unsigned char>>&	levels)
+{
+	if (data.size() < KTX_HEADER_SIZE || std::memcmp(&data[0], KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER)) != 0)
+		return false;
+
+	// the endianness field is written by the producer in its own byte order
+	const bool bigEndian = readUInt(data, 12, false) != KTX_ENDIANNESS;
+
+	if (bigEndian && readUInt(data, 12, true) != KTX_ENDIANNESS)
+		return false;
+
+	const uint glType				= readUInt(data, 16, bigEndian);
+	const uint glFormat				= readUInt(data, 24, bigEndian);
+	const uint internalFormat		= readUInt(data, 28, bigEndian);
+	const uint pixelDepth			= readUInt(data, 44, bigEndian);
+	const uint numArrayElements		= readUInt(data, 48, bigEndian);
+	const uint numFaces				= readUInt(data, 52, bigEndian);
+	const uint numMipLevels			= std::max(1u, readUInt(data, 56, bigEndian));
+	const uint bytesOfKeyValueData	= readUInt(data, 60, bigEndian);
+
+	width = readUInt(data, 36, bigEndian);
+	height = readUInt(data, 40, bigEndian);
+
+	if (width == 0 || height == 0 || pixelDepth > 1 || numArrayElements > 0 || numFaces != 1)
+		return false;
+
+	if (glType == 0)
+	{
+		if (!textureFormat(internalFormat, format) || !render::TextureCompression::isCompressed(format))
+			return false;
+	}
+	else if (glType == GL_UNSIGNED_BYTE_ && (glFormat == GL_RGB_ || glFormat == GL_RGBA_))
+		format = glFormat == GL_RGB_ ? render::TextureFormat::RGB : render::TextureFormat::RGBA;
+	else
+		return false;
+
+	uint offset = KTX_HEADER_SIZE + bytesOfKeyValueData;
+
+	levels.resize(numMipLevels);
+
+	for (uint level = 0; level < numMipLevels; ++level)
+	{
+		if (offset + 4 > data.size())
+			return false;
+
+		const uint imageSize	= readUInt(data, offset, bigEndian);
+		const uint levelWidth	= std::max(1u, width >> level);
+		const uint levelHeight	= std::max(1u, height >> level);
+		const uint size			= render::TextureCompression::dataSize(format, levelWidth, levelHeight);
+
+		offset += 4;
+		if (imageSize < size || offset + imageSize > data.size())
+			return false;
+
+		if (format == render::TextureFormat::RGB)
+		{
+			// uncompressed rows are aligned on 4 bytes (GL_UNPACK_ALIGNMENT)
+			const uint rowSize = (levelWidth * 3 + 3) & ~3u;
+
+			if (imageSize < rowSize * levelHeight)
+				return false;
+
+			levels[level].resize(size);
+			for (uint y = 0; y < levelHeight; ++y)
+				std::memcpy(&levels[level][y * levelWidth * 3], &data[offset + y * rowSize], levelWidth * 3);
+		}
+		else
+			levels[level].assign(data.begin() + offset, data.begin() + offset + size);
+
+		offset += (imageSize + 3) & ~3u;
+	}
+
+	return true;
+}
+
+uint
+KTXParser::glInternalFormat(render::TextureFormat format)
+{
+	switch (format)
+	{
+	case render::TextureFormat::RGB:
+		return GL_RGB8_;
+	case render::TextureFormat::RGBA:
+		return GL_RGBA8_;
+	case render::TextureFormat::RGB_DXT1:
+		return 0x83F0;
+	case render::TextureFormat::RGBA_DXT5:
+		return 0x83F3;
+	case render::TextureFormat::RGB_ETC1:
+		return 0x8D64;
+	case render::TextureFormat::RGB_PVRTC1_4BPP:
+		return 0x8C00;
+	case render::TextureFormat::RGBA_PVRTC1_4BPP:
+		return 0x8C02;
+	default:
+		throw std::invalid_argument("format");
+	}
+}
+
+bool
+KTXParser::textureFormat(uint glInternalFormat, render::TextureFormat& format)
+{
+	switch (glInternalFormat)
+	{
+	case GL_RGB_:
+	case GL_RGB8_:
+		format = render::TextureFormat::RGB;
+		return true;
+	case GL_RGBA_:
+	case GL_RGBA8_:
+		format = render::TextureFormat::RGBA;
+		return true;
+	case 0x83F0:
+		format = render::TextureFormat::RGB_DXT1;
+		return true;
+	case 0x83F3:
+		format = render::TextureFormat::RGBA_DXT5;
+		return true;
+	case 0x8D64:
+		format = render::TextureFormat::RGB_ETC1;
+		return true;
+	case 0x8C00:
+		format = render::TextureFormat::RGB_PVRTC1_4BPP;
+		return true;
+	case 0x8C02:
+		format = render::TextureFormat::RGBA_PVRTC1_4BPP;
+		return true;
+	default:
+		return false;
+	}
+}
@@ -0,0 +1,105 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/file/KTXWriter.hpp"
+
+#include "minko/file/KTXParser.hpp"
+#include "minko/render/TextureCompression.hpp"
+
+using namespace minko;
+using namespace minko::file;
+
+namespace
+{
+	const unsigned char	KTX_IDENTIFIER[12]	= { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+	inline
+	void
+	writeUInt(std::vector<unsigned char>& out, uint value)
+	{
+		for (uint i = 0; i < 4; ++i)
+			out.push_back((value >> (i * 8)) & 0xff);
+	}
+}
+
+void
+KTXWriter::write(const std::string&								filename,
+				 render::TextureFormat							format,
+				 uint											width,
+				 uint											height,
+				 const std::vector<std::vector<unsigned char>>&	levels)
+{
+	std::vector<unsigned char> data;
+
+	write(data, format, width, height, levels);
+
+	std::ofstream file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+
+	if (!file.is_open())
+		throw std::runtime_error("KTXWriter::write: cannot open file " + filename);
+
+	file.write(reinterpret_cast<const char*>(&data[0]), data.size());
+}
+
+void
+KTXWriter::write(std::vector<unsigned char>&						out,
+				 render::TextureFormat							format,
+				 uint											width,
+				 uint											height,
+				 const std::vector<std::vector<unsigned char>>&	levels)
+{
+	// RGB levels would need their rows to be aligned on 4 bytes
+	if (format == render::TextureFormat::RGB)
+		throw std::invalid_argument("format");
+	if (levels.empty())
+		throw std::invalid_argument("levels");
+
+	const bool compressed	= render::TextureCompression::isCompressed(format);
+	const bool alpha		= render::TextureCompression::hasAlpha(format);
+
+	out.assign(KTX_IDENTIFIER, KTX_IDENTIFIER + sizeof(KTX_IDENTIFIER));
+	writeUInt(out, 0x04030201);
+	writeUInt(out, compressed ? 0 : 0x1401);		// glType: GL_UNSIGNED_BYTE
+	writeUInt(out, 1);								// glTypeSize
+	writeUInt(out, compressed ? 0 : 0x1908);		// glFormat: GL_RGBA
+	writeUInt(out, KTXParser::glInternalFormat(format));
+	writeUInt(out, alpha ? 0x1908 : 0x1907);		// glBaseInternalFormat: GL_RGBA or GL_RGB
+	writeUInt(out, width);
+	writeUInt(out, height);
+	writeUInt(out, 0);								// pixelDepth
+	writeUInt(out, 0);								// numberOfArrayElements
+	writeUInt(out, 1);								// numberOfFaces
+	writeUInt(out, levels.size());
+	writeUInt(out, 0);								// bytesOfKeyValueData
+
+	for (uint level = 0; level < levels.size(); ++level)
+	{
+		const uint size = render::TextureCompression::dataSize(
+			format, std::max(1u, width >> level), std::max(1u, height >> level)
+		);
+
+		if (levels[level].size() < size)
+			throw std::invalid_argument("levels");
+
+		writeUInt(out, size);
+		out.insert(out.end(), levels[level].begin(), levels[level].begin() + size);
+		out.resize((out.size() + 3) & ~3u, 0);
+	}
+}
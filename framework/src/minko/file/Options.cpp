@@ -23,6 +23,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/file/FileLoader.hpp"
 #include "minko/file/AssetLibrary.hpp"
 
+#include <thread>
+
 #ifdef __APPLE__
 # include "CoreFoundation/CoreFoundation.h"
 #endif
@@ -37,9 +39,15 @@ Options::Options(std::shared_ptr<render::AbstractContext> context) :
 	_userFlags(),
 	_generateMipMaps(false),
 	_resizeSmoothly(false),
+	_streamTextures(false),
 	_isCubeTexture(false),
 	_startAnimation(true),
 	_loadAsynchronously(false),
+	_optimizeGeometry(false),
+	_attributeEncodings(),
+	_compressIndices(false),
+	_numParsingJobs(std::max(1u, std::thread::hardware_concurrency())),
+	_textureFormat(render::TextureFormat::RGBA),
 	_skinningFramerate(30),
 	_skinningMethod(component::SkinningMethod::HARDWARE),
 	_material(nullptr),
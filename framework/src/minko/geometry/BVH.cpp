@@ -0,0 +1,538 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/geometry/BVH.hpp"
+
+using namespace minko;
+using namespace minko::geometry;
+
+const uint BVH::MAX_LEAF_SIZE;
+const uint BVH::NUM_BINS;
+const uint BVH::NO_HIT;
+
+// Below this depth nodes are split at the median: it bounds the traversal stacks.
+static const uint	MAX_SAH_DEPTH	= 40;
+static const uint	STACK_SIZE		= 96;
+static const float	EPSILON			= 1e-12f;
+
+namespace
+{
+	struct Bin
+	{
+		float	min[3];
+		float	max[3];
+		uint	count;
+	};
+
+	struct BuildTask
+	{
+		uint	begin;
+		uint	end;
+		uint	parent;
+		uint	depth;
+	};
+
+	inline
+	void
+	resetBounds(float* min, float* max)
+	{
+		min[0] = min[1] = min[2] = std::numeric_limits<float>::max();
+		max[0] = max[1] = max[2] = -std::numeric_limits<float>::max();
+	}
+
+	inline
+	void
+	growBounds(float* min, float* max, const float* otherMin, const float* otherMax)
+	{
+		for (uint i = 0; i < 3; ++i)
+		{
+			min[i] = std::min(min[i], otherMin[i]);
+			max[i] = std::max(max[i], otherMax[i]);
+		}
+	}
+
+	inline
+	float
+	surfaceArea(const float* min, const float* max)
+	{
+		const float dx = max[0] - min[0];
+		const float dy = max[1] - min[1];
+		const float dz = max[2] - min[2];
+
+		return 2.f * (dx * dy + dy * dz + dz * dx);
+	}
+}
+
+void
+BVH::build(const float*				xyzData,
+		   uint						vertexSize,
+		   uint						xyzOffset,
+		   const unsigned short*	indices,
+		   uint						numIndices)
+{
+	const uint numTriangles = numIndices / 3;
+
+	_nodes.clear();
+	_triangles.clear();
+	_triangleIds.clear();
+
+	if (numTriangles == 0)
+		return;
+
+	std::vector<float>	bounds(numTriangles * 6);
+	std::vector<float>	centroids(numTriangles * 3);
+	std::vector<uint>	order(numTriangles);
+
+	for (uint triangleId = 0; triangleId < numTriangles; ++triangleId)
+	{
+		float* min = &bounds[triangleId * 6];
+		float* max = min + 3;
+
+		resetBounds(min, max);
+		for (uint i = 0; i < 3; ++i)
+		{
+			const float* xyz = xyzData + indices[triangleId * 3 + i] * vertexSize + xyzOffset;
+
+			growBounds(min, max, xyz, xyz);
+		}
+
+		for (uint i = 0; i < 3; ++i)
+			centroids[triangleId * 3 + i] = (min[i] + max[i]) * .5f;
+
+		order[triangleId] = triangleId;
+	}
+
+	std::vector<BuildTask> tasks;
+
+	_nodes.reserve(2 * numTriangles / MAX_LEAF_SIZE + 1);
+	tasks.push_back({ 0, numTriangles, NO_HIT, 0 });
+
+	while (!tasks.empty())
+	{
+		const auto task		= tasks.back();
+		const uint nodeId	= _nodes.size();
+		const uint count	= task.end - task.begin;
+		Node node;
+		float centroidMin[3];
+		float centroidMax[3];
+
+		tasks.pop_back();
+		// left children directly follow their parent, right children are linked explicitly
+		if (task.parent != NO_HIT)
+			_nodes[task.parent].offset = nodeId;
+		_nodes.push_back(node);
+
+		resetBounds(node.min, node.max);
+		resetBounds(centroidMin, centroidMax);
+		for (uint i = task.begin; i < task.end; ++i)
+		{
+			const float* centroid = &centroids[order[i] * 3];
+
+			growBounds(node.min, node.max, &bounds[order[i] * 6], &bounds[order[i] * 6 + 3]);
+			growBounds(centroidMin, centroidMax, centroid, centroid);
+		}
+
+		if (count <= MAX_LEAF_SIZE)
+		{
+			node.offset = task.begin;
+			node.count	= count;
+			node.axis	= 0;
+			_nodes[nodeId] = node;
+
+			continue;
+		}
+
+		int		bestAxis	= -1;
+		uint	bestBin		= 0;
+		float	bestCost	= std::numeric_limits<float>::max();
+
+		for (uint axis = 0; axis < 3 && task.depth < MAX_SAH_DEPTH; ++axis)
+		{
+			const float extent = centroidMax[axis] - centroidMin[axis];
+
+			if (extent <= 0.f)
+				continue;
+
+			const float scale = NUM_BINS / extent;
+			Bin bins[NUM_BINS];
+
+			for (auto& bin : bins)
+			{
+				resetBounds(bin.min, bin.max);
+				bin.count = 0;
+			}
+
+			for (uint i = task.begin; i < task.end; ++i)
+			{
+				const uint triangleId	= order[i];
+				auto& bin				= bins[std::min(
+					NUM_BINS - 1, (uint)((centroids[triangleId * 3 + axis] - centroidMin[axis]) * scale)
+				)];
+
+				growBounds(bin.min, bin.max, &bounds[triangleId * 6], &bounds[triangleId * 6 + 3]);
+				++bin.count;
+			}
+
+			// sweep from the left to get the area/count of every prefix, then from the right
+			float	leftArea[NUM_BINS - 1];
+			uint	leftCount[NUM_BINS - 1];
+			float	min[3];
+			float	max[3];
+			uint	sum = 0;
+
+			resetBounds(min, max);
+			for (uint i = 0; i < NUM_BINS - 1; ++i)
+			{
+				growBounds(min, max, bins[i].min, bins[i].max);
+				sum += bins[i].count;
+				leftCount[i] = sum;
+				leftArea[i] = sum > 0 ? surfaceArea(min, max) : 0.f;
+			}
+
+			resetBounds(min, max);
+			sum = 0;
+			for (uint i = NUM_BINS - 1; i > 0; --i)
+			{
+				growBounds(min, max, bins[i].min, bins[i].max);
+				sum += bins[i].count;
+
+				if (sum == 0 || leftCount[i - 1] == 0)
+					continue;
+
+				const float cost = leftArea[i - 1] * leftCount[i - 1] + surfaceArea(min, max) * sum;
+
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestBin = i - 1;
+				}
+			}
+		}
+
+		uint mid = task.begin + count / 2;
+
+		if (bestAxis >= 0)
+		{
+			const float scale = NUM_BINS / (centroidMax[bestAxis] - centroidMin[bestAxis]);
+
+			mid = std::partition(
+				order.begin() + task.begin,
+				order.begin() + task.end,
+				[&](uint triangleId)
+				{
+					return std::min(
+						NUM_BINS - 1, (uint)((centroids[triangleId * 3 + bestAxis] - centroidMin[bestAxis]) * scale)
+					) <= bestBin;
+				}
+			) - order.begin();
+		}
+		else
+		{
+			// degenerate centroids or maximum SAH depth reached: median split along the largest extent
+			bestAxis = 0;
+			for (uint axis = 1; axis < 3; ++axis)
+				if (centroidMax[axis] - centroidMin[axis] > centroidMax[bestAxis] - centroidMin[bestAxis])
+					bestAxis = axis;
+
+			std::nth_element(
+				order.begin() + task.begin,
+				order.begin() + mid,
+				order.begin() + task.end,
+				[&](uint a, uint b) { return centroids[a * 3 + bestAxis] < centroids[b * 3 + bestAxis]; }
+			);
+		}
+
+		node.offset = 0;
+		node.count	= 0;
+		node.axis	= bestAxis;
+		_nodes[nodeId] = node;
+
+		tasks.push_back({ mid, task.end, nodeId, task.depth + 1 });
+		tasks.push_back({ task.begin, mid, NO_HIT, task.depth + 1 });
+	}
+
+	_triangles.resize(numTriangles * 9);
+	_triangleIds.resize(numTriangles);
+
+	for (uint i = 0; i < numTriangles; ++i)
+	{
+		const uint triangleId	= order[i];
+		const float* v0			= xyzData + indices[triangleId * 3] * vertexSize + xyzOffset;
+		const float* v1			= xyzData + indices[triangleId * 3 + 1] * vertexSize + xyzOffset;
+		const float* v2			= xyzData + indices[triangleId * 3 + 2] * vertexSize + xyzOffset;
+		float* triangle			= &_triangles[i * 9];
+
+		for (uint j = 0; j < 3; ++j)
+		{
+			triangle[j]		= v0[j];
+			triangle[3 + j]	= v1[j] - v0[j];
+			triangle[6 + j]	= v2[j] - v0[j];
+		}
+
+		_triangleIds[i] = triangleId * 3;
+	}
+}
+
+bool
+BVH::intersectNode(const Node&	node,
+				   const float*	origin,
+				   const float*	invDirection,
+				   float		maxDistance)
+{
+	float tmin = 0.f;
+	float tmax = maxDistance;
+
+	for (uint i = 0; i < 3; ++i)
+	{
+		float t0 = (node.min[i] - origin[i]) * invDirection[i];
+		float t1 = (node.max[i] - origin[i]) * invDirection[i];
+
+		if (t0 > t1)
+			std::swap(t0, t1);
+		if (t0 > tmin)
+			tmin = t0;
+		if (t1 < tmax)
+			tmax = t1;
+	}
+
+	return tmin <= tmax;
+}
+
+bool
+BVH::intersectTriangle(uint			triangle,
+					   const float*	origin,
+					   const float*	direction,
+					   float&		t,
+					   float&		u,
+					   float&		v) const
+{
+	const float* v0		= &_triangles[triangle * 9];
+	const float* edge1	= v0 + 3;
+	const float* edge2	= v0 + 6;
+
+	const float pvec[3] = {
+		direction[1] * edge2[2] - direction[2] * edge2[1],
+		direction[2] * edge2[0] - direction[0] * edge2[2],
+		direction[0] * edge2[1] - direction[1] * edge2[0]
+	};
+	const float dot = edge1[0] * pvec[0] + edge1[1] * pvec[1] + edge1[2] * pvec[2];
+
+	if (dot > -EPSILON && dot < EPSILON)
+		return false;
+
+	const float invDot	= 1.f / dot;
+	const float tvec[3]	= { origin[0] - v0[0], origin[1] - v0[1], origin[2] - v0[2] };
+
+	u = (tvec[0] * pvec[0] + tvec[1] * pvec[1] + tvec[2] * pvec[2]) * invDot;
+	if (u < 0.f || u > 1.f)
+		return false;
+
+	const float qvec[3] = {
+		tvec[1] * edge1[2] - tvec[2] * edge1[1],
+		tvec[2] * edge1[0] - tvec[0] * edge1[2],
+		tvec[0] * edge1[1] - tvec[1] * edge1[0]
+	};
+
+	v = (direction[0] * qvec[0] + direction[1] * qvec[1] + direction[2] * qvec[2]) * invDot;
+	if (v < 0.f || u + v > 1.f)
+		return false;
+
+	t = (edge2[0] * qvec[0] + edge2[1] * qvec[1] + edge2[2] * qvec[2]) * invDot;
+
+	return t >= 0.f;
+}
+
+bool
+BVH::cast(const float*	origin,
+		  const float*	direction,
+		  Hit&			hit,
+		  float			maxDistance) const
+{
+	if (_nodes.empty())
+		return false;
+
+	const float invDirection[3] = { 1.f / direction[0], 1.f / direction[1], 1.f / direction[2] };
+	uint stack[STACK_SIZE];
+	uint stackSize = 0;
+	float t, u, v;
+
+	hit.triangle = NO_HIT;
+	stack[stackSize++] = 0;
+
+	while (stackSize)
+	{
+		const uint nodeId	= stack[--stackSize];
+		const Node& node	= _nodes[nodeId];
+
+		if (!intersectNode(node, origin, invDirection, maxDistance))
+			continue;
+
+		if (node.count)
+		{
+			for (uint i = node.offset; i < node.offset + node.count; ++i)
+			{
+				if (intersectTriangle(i, origin, direction, t, u, v) && t < maxDistance)
+				{
+					maxDistance		= t;
+					hit.distance	= t;
+					hit.triangle	= _triangleIds[i];
+					hit.u			= u;
+					hit.v			= v;
+				}
+			}
+		}
+		else if (direction[node.axis] < 0.f)
+		{
+			stack[stackSize++] = nodeId + 1;
+			stack[stackSize++] = node.offset;
+		}
+		else
+		{
+			stack[stackSize++] = node.offset;
+			stack[stackSize++] = nodeId + 1;
+		}
+	}
+
+	return hit.triangle != NO_HIT;
+}
+
+bool
+BVH::castAny(const float*	origin,
+			 const float*	direction,
+			 float			maxDistance) const
+{
+	if (_nodes.empty())
+		return false;
+
+	const float invDirection[3] = { 1.f / direction[0], 1.f / direction[1], 1.f / direction[2] };
+	uint stack[STACK_SIZE];
+	uint stackSize = 0;
+	float t, u, v;
+
+	stack[stackSize++] = 0;
+
+	while (stackSize)
+	{
+		const uint nodeId	= stack[--stackSize];
+		const Node& node	= _nodes[nodeId];
+
+		if (!intersectNode(node, origin, invDirection, maxDistance))
+			continue;
+
+		if (node.count)
+		{
+			for (uint i = node.offset; i < node.offset + node.count; ++i)
+				if (intersectTriangle(i, origin, direction, t, u, v) && t < maxDistance)
+					return true;
+		}
+		else
+		{
+			stack[stackSize++] = node.offset;
+			stack[stackSize++] = nodeId + 1;
+		}
+	}
+
+	return false;
+}
+
+uint
+BVH::castPacket(uint			numRays,
+				const float*	origins,
+				const float*	directions,
+				Hit*			hits,
+				float			maxDistance) const
+{
+	for (uint i = 0; i < numRays; ++i)
+	{
+		hits[i].distance = maxDistance;
+		hits[i].triangle = NO_HIT;
+	}
+
+	if (_nodes.empty() || numRays == 0)
+		return 0;
+
+	// the whole packet walks the tree together: a node is fetched once and tested against the
+	// rays that reached its parent, starting from the first one that did (ranged traversal)
+	std::vector<float>	invDirections(numRays * 3);
+	std::vector<uint>	active(numRays);
+	uint stack[STACK_SIZE * 2];
+	uint stackSize = 0;
+	float t, u, v;
+
+	for (uint i = 0; i < numRays * 3; ++i)
+		invDirections[i] = 1.f / directions[i];
+
+	stack[stackSize++] = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize)
+	{
+		const uint firstRay	= stack[--stackSize];
+		const uint nodeId	= stack[--stackSize];
+		const Node& node	= _nodes[nodeId];
+		uint numActive		= 0;
+
+		for (uint i = firstRay; i < numRays; ++i)
+			if (intersectNode(node, origins + i * 3, &invDirections[i * 3], hits[i].distance))
+				active[numActive++] = i;
+
+		if (numActive == 0)
+			continue;
+
+		if (node.count)
+		{
+			for (uint i = node.offset; i < node.offset + node.count; ++i)
+			{
+				for (uint j = 0; j < numActive; ++j)
+				{
+					const uint rayId	= active[j];
+					auto& hit			= hits[rayId];
+
+					if (intersectTriangle(i, origins + rayId * 3, directions + rayId * 3, t, u, v)
+						&& t < hit.distance)
+					{
+						hit.distance	= t;
+						hit.triangle	= _triangleIds[i];
+						hit.u			= u;
+						hit.v			= v;
+					}
+				}
+			}
+
+			continue;
+		}
+
+		const bool leftFirst = directions[active[0] * 3 + node.axis] >= 0.f;
+
+		stack[stackSize++] = leftFirst ? node.offset : nodeId + 1;
+		stack[stackSize++] = active[0];
+		stack[stackSize++] = leftFirst ? nodeId + 1 : node.offset;
+		stack[stackSize++] = active[0];
+	}
+
+	uint numHits = 0;
+
+	for (uint i = 0; i < numRays; ++i)
+		if (hits[i].triangle != NO_HIT)
+			++numHits;
+
+	return numHits;
+}
@@ -34,7 +34,9 @@ Geometry::Geometry() :
 	_data(data::ArrayProvider::create("geometry")),
 	_vertexSize(0),
 	_numVertices(0),
-	_indexBuffer(nullptr)
+	_indexBuffer(nullptr),
+	_bvh(nullptr),
+	_positionDataChangedSlot(nullptr)
 {
 }
 
@@ -65,6 +67,15 @@ Geometry::addVertexBuffer(render::VertexBuffer::Ptr vertexBuffer)
 		std::placeholders::_1,
 		std::placeholders::_2
 	));
+
+	if (vertexBuffer->hasAttribute("position"))
+	{
+		_bvh = nullptr;
+		_positionDataChangedSlot = vertexBuffer->dataChanged()->connect([&](VertexBuffer::Ptr)
+		{
+			_bvh = nullptr;
+		});
+	}
 }
 
 void
@@ -84,7 +95,13 @@ Geometry::removeVertexBuffer(std::list<render::VertexBuffer::Ptr>::iterator vert
 	if (_vertexBuffers.size() == 0)
 		_numVertices = 0;
 
-	_vbToVertexSizeChangedSlot.erase(vertexBuffer);	
+	_vbToVertexSizeChangedSlot.erase(vertexBuffer);
+
+	if (vertexBuffer->hasAttribute("position"))
+	{
+		_bvh = nullptr;
+		_positionDataChangedSlot = nullptr;
+	}
 }
 
 void
@@ -346,95 +363,73 @@ Geometry::cast(std::shared_ptr<math::Ray>	ray,
 			   std::shared_ptr<Vector2>		hitUv,
 			   std::shared_ptr<Vector3>		hitNormal)
 {
-	static const auto EPSILON = 0.00001f;
+	auto bvh = this->bvh();
 
-	auto hit = false;
-	auto& indicesData = _indexBuffer->data();
-	auto numIndices = indicesData.size();
-
-	auto xyzBuffer = vertexBuffer("position");
-	auto& xyzData = xyzBuffer->data();
-	auto xyzPtr = &xyzData[0];
-	auto xyzVertexSize = xyzBuffer->vertexSize();
-	auto xyzOffset = std::get<2>(*xyzBuffer->attribute("position"));
-
-	auto minDistance = std::numeric_limits<float>::lowest();
-	auto lambda = hitUv ? Vector2::create() : nullptr;
-	auto triangleIndice = -3;
-
-	auto v0 = Vector3::create();
-	auto v1 = Vector3::create();
-	auto v2 = Vector3::create();
-	auto edge1 = Vector3::create();
-	auto edge2 = Vector3::create();
-	auto pvec = Vector3::create();
-	auto tvec = Vector3::create();
-	auto qvec = Vector3::create();
-	auto dot = 0.f;
-	auto invDot = 0.f;
-	auto u = 0.f;
-	auto v = 0.f;
-	auto t = 0.f;
-
-	for (uint i = 0; i < numIndices; i += 3)
-	{
-		v0->copyFrom(xyzPtr + indicesData[i] * xyzVertexSize);
-		v1->copyFrom(xyzPtr + indicesData[i + 1] * xyzVertexSize);
-		v2->copyFrom(xyzPtr + indicesData[i + 2] * xyzVertexSize);
+	if (!bvh)
+		return false;
 
-		edge1->copyFrom(v1)->subtract(v0);
-		edge2->copyFrom(v2)->subtract(v0);
+	const float origin[3] = { ray->origin()->x(), ray->origin()->y(), ray->origin()->z() };
+	const float direction[3] = { ray->direction()->x(), ray->direction()->y(), ray->direction()->z() };
+	BVH::Hit hit;
 
-		pvec->copyFrom(ray->direction())->cross(edge2);
-		dot = edge1->dot(pvec);
+	if (!bvh->cast(origin, direction, hit))
+		return false;
 
-		if (dot > -EPSILON && dot < EPSILON)
-			continue;
+	distance = hit.distance;
+	triangle = hit.triangle;
 
-		invDot = 1.f / dot;
+	if (hitXyz)
+	{
+		hitXyz->setTo(
+			origin[0] + distance * direction[0],
+			origin[1] + distance * direction[1],
+			origin[2] + distance * direction[2]
+		);
+	}
 
-		tvec->copyFrom(ray->origin())->subtract(v0);
-		u = tvec->dot(pvec) * invDot;
-		if (u < 0.f || u > 1.f)
-			continue;
+	if (hitUv)
+		getHitUv(triangle, Vector2::create(hit.u, hit.v), hitUv);
 
-		qvec->copyFrom(tvec)->cross(edge1);
-		v = ray->origin()->dot(qvec) * invDot;
-		if (v < 0.f || u + v > 1.f)
-			continue;
+	if (hitNormal)
+		getHitNormal(triangle, hitNormal);
 
-		t = edge2->dot(qvec) * invDot;
-		if (t < minDistance)
-		{
-			minDistance = t;
-			distance = t;
-			triangle = i;
-			hit = true;
+	return true;
+}
 
-			if (hitUv)
-			{
-				lambda->x(u);
-				lambda->y(v);
-			}
-		}
+bool
+Geometry::castAny(std::shared_ptr<math::Ray> ray, float maxDistance)
+{
+	auto bvh = this->bvh();
 
-		if (hitXyz)
-		{
-			hitXyz->setTo(
-				ray->origin()->x() + minDistance * ray->direction()->x(),
-				ray->origin()->y() + minDistance * ray->direction()->y(),
-				ray->origin()->z() + minDistance * ray->direction()->z()
-			);
-		}
+	if (!bvh)
+		return false;
+
+	const float origin[3] = { ray->origin()->x(), ray->origin()->y(), ray->origin()->z() };
+	const float direction[3] = { ray->direction()->x(), ray->direction()->y(), ray->direction()->z() };
 
-		if (hitUv)
-			getHitUv(triangle, lambda, hitUv);
+	return bvh->castAny(origin, direction, maxDistance);
+}
 
-		if (hitNormal)
-			getHitNormal(triangle, hitNormal);
+BVH::Ptr
+Geometry::bvh()
+{
+	if (!_bvh && _indexBuffer && !_indexBuffer->data().empty() && _data->hasProperty("position"))
+	{
+		auto xyzBuffer = vertexBuffer("position");
+
+		// the data was disposed once uploaded
+		if (xyzBuffer->data().empty())
+			return nullptr;
+
+		_bvh = BVH::create(
+			xyzBuffer->data(),
+			xyzBuffer->vertexSize(),
+			std::get<2>(*xyzBuffer->attribute("position")),
+			_indexBuffer->data()
+		);
 	}
 
-	return hit;
+	return _bvh;
 }
 
 void
@@ -475,8 +470,8 @@ Geometry::getHitNormal(uint triangle, Vector3::Ptr hitNormal)
 	auto& indicesData = _indexBuffer->data();
 
 	auto v0 = Vector3::create(normalPtr + indicesData[triangle] * normalVertexSize + normalOffset);
-	auto v1 = Vector3::create(normalPtr + indicesData[triangle] * normalVertexSize + normalOffset);
-	auto v2 = Vector3::create(normalPtr + indicesData[triangle] * normalVertexSize + normalOffset);
+	auto v1 = Vector3::create(normalPtr + indicesData[triangle + 1] * normalVertexSize + normalOffset);
+	auto v2 = Vector3::create(normalPtr + indicesData[triangle + 2] * normalVertexSize + normalOffset);
 
 	auto edge1 = Vector3::create(v1)->subtract(v0)->normalize();
 	auto edge2 = Vector3::create(v2)->subtract(v0)->normalize();
@@ -492,3 +487,383 @@ Geometry::upload()
 
 	_indexBuffer->upload();
 }
+
+Geometry::Ptr
+Geometry::optimize(uint cacheSize, bool reduceOverdraw, bool reorderVertices)
+{
+	if (cacheSize == 0)
+		throw std::invalid_argument("cacheSize");
+
+	if (_indexBuffer == nullptr || _numVertices == 0)
+		return shared_from_this();
+
+	auto&		indices			= _indexBuffer->data();
+	const uint	numTriangles	= indices.size() / 3;
+
+	if (numTriangles == 0)
+		return shared_from_this();
+
+	std::vector<uint>	clusters;
+	auto				triangles	= tipsify(indices, _numVertices, cacheSize, clusters);
+
+	if (reduceOverdraw && _data->hasProperty("position"))
+	{
+		splitClusters(indices, triangles, cacheSize, clusters);
+		sortClusters(triangles, clusters);
+	}
+
+	std::vector<unsigned short> sortedIndices(indices.size());
+
+	for (uint i = 0; i < numTriangles; ++i)
+		for (uint k = 0; k < 3; ++k)
+			sortedIndices[i * 3 + k] = indices[triangles[i] * 3 + k];
+	indices.swap(sortedIndices);
+
+	if (reorderVertices)
+		remapVertices();
+
+	if (_indexBuffer->isReady())
+		_indexBuffer->upload();
+	_bvh = nullptr;
+
+	return shared_from_this();
+}
+
+float
+Geometry::averageCacheMissRatio(uint cacheSize) const
+{
+	return _indexBuffer != nullptr ? averageCacheMissRatio(_indexBuffer->data(), cacheSize) : 0.f;
+}
+
+float
+Geometry::averageCacheMissRatio(const std::vector<unsigned short>& indices, uint cacheSize)
+{
+	const uint numTriangles = indices.size() / 3;
+
+	if (numTriangles == 0 || cacheSize == 0)
+		return 0.f;
+
+	std::vector<int>	cache(cacheSize, -1);
+	uint				cacheHead	= 0;
+	uint				numMisses	= 0;
+
+	for (uint i = 0; i < numTriangles * 3; ++i)
+	{
+		const int vertex = indices[i];
+
+		if (std::find(cache.begin(), cache.end(), vertex) == cache.end())
+		{
+			cache[cacheHead] = vertex;
+			cacheHead = (cacheHead + 1) % cacheSize;
+			++numMisses;
+		}
+	}
+
+	return float(numMisses) / float(numTriangles);
+}
+
+std::vector<uint>
+Geometry::tipsify(const std::vector<unsigned short>&	indices,
+				  uint									numVertices,
+				  uint									cacheSize,
+				  std::vector<uint>&					clusters)
+{
+	// Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"
+	const uint numTriangles = indices.size() / 3;
+
+	// vertex to triangles adjacency, every triangle is listed once per reference to the vertex
+	std::vector<uint> adjacencyOffsets(numVertices + 1, 0);
+
+	for (uint i = 0; i < numTriangles * 3; ++i)
+		++adjacencyOffsets[indices[i] + 1];
+	for (uint i = 0; i < numVertices; ++i)
+		adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+
+	std::vector<uint> adjacency(numTriangles * 3);
+	std::vector<uint> fillOffsets(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+
+	for (uint i = 0; i < numTriangles * 3; ++i)
+		adjacency[fillOffsets[indices[i]]++] = i / 3;
+
+	std::vector<int>	numLiveTriangles(numVertices);
+	std::vector<int>	timeStamps(numVertices, 0);
+	std::vector<bool>	emitted(numTriangles, false);
+	std::vector<uint>	deadEndStack;
+	std::vector<uint>	candidates;
+	std::vector<uint>	triangles;
+	const int			cacheSizeInt	= cacheSize;
+	int					time			= cacheSizeInt + 1;
+	uint				cursor			= 0;
+
+	for (uint i = 0; i < numVertices; ++i)
+		numLiveTriangles[i] = adjacencyOffsets[i + 1] - adjacencyOffsets[i];
+
+	triangles.reserve(numTriangles);
+
+	auto skipDeadEnd = [&]() -> int
+	{
+		while (!deadEndStack.empty())
+		{
+			const uint vertex = deadEndStack.back();
+
+			deadEndStack.pop_back();
+			if (numLiveTriangles[vertex] > 0)
+				return vertex;
+		}
+
+		for (; cursor < numVertices; ++cursor)
+			if (numLiveTriangles[cursor] > 0)
+				return cursor;
+
+		return -1;
+	};
+
+	clusters.assign(1, 0);
+
+	int fanningVertex = skipDeadEnd();
+
+	while (fanningVertex >= 0)
+	{
+		candidates.clear();
+
+		for (uint i = adjacencyOffsets[fanningVertex]; i < adjacencyOffsets[fanningVertex + 1]; ++i)
+		{
+			const uint triangle = adjacency[i];
+
+			if (emitted[triangle])
+				continue;
+
+			for (uint k = 0; k < 3; ++k)
+			{
+				const uint vertex = indices[triangle * 3 + k];
+
+				deadEndStack.push_back(vertex);
+				candidates.push_back(vertex);
+				--numLiveTriangles[vertex];
+
+				if (time - timeStamps[vertex] > cacheSizeInt)
+					timeStamps[vertex] = time++;
+			}
+
+			emitted[triangle] = true;
+			triangles.push_back(triangle);
+		}
+
+		// prefer the candidates still in the cache and that will remain there while fanned
+		int bestVertex		= -1;
+		int bestPriority	= -1;
+
+		for (auto vertex : candidates)
+		{
+			if (numLiveTriangles[vertex] <= 0)
+				continue;
+
+			int priority = 0;
+
+			if (time - timeStamps[vertex] + 2 * numLiveTriangles[vertex] <= cacheSizeInt)
+				priority = time - timeStamps[vertex];
+
+			if (priority > bestPriority)
+			{
+				bestVertex		= vertex;
+				bestPriority	= priority;
+			}
+		}
+
+		if (bestVertex < 0)
+		{
+			// dead-end: the cache is lost, which makes it a natural cluster boundary
+			bestVertex = skipDeadEnd();
+			if (bestVertex >= 0)
+				clusters.push_back(triangles.size());
+		}
+
+		fanningVertex = bestVertex;
+	}
+
+	return triangles;
+}
+
+void
+Geometry::splitClusters(const std::vector<unsigned short>&	indices,
+						const std::vector<uint>&			triangles,
+						uint								cacheSize,
+						std::vector<uint>&					clusters)
+{
+	// soft boundaries: a cluster is cut as soon as its own ACMR, starting from a cold cache,
+	// is low enough for the extra misses of the cut to be negligible
+	static const float	MAX_CLUSTER_ACMR		= .65f;
+	static const uint	MIN_CLUSTER_TRIANGLES	= 64;
+
+	std::vector<uint>	boundaries;
+	std::vector<int>	cache(cacheSize);
+
+	for (uint clusterId = 0; clusterId < clusters.size(); ++clusterId)
+	{
+		const uint	begin	= clusters[clusterId];
+		const uint	end		= clusterId + 1 < clusters.size() ? clusters[clusterId + 1] : triangles.size();
+		uint		start	= begin;
+		uint		misses	= 0;
+		uint		head	= 0;
+
+		std::fill(cache.begin(), cache.end(), -1);
+		boundaries.push_back(begin);
+
+		for (uint i = begin; i < end; ++i)
+		{
+			for (uint k = 0; k < 3; ++k)
+			{
+				const int vertex = indices[triangles[i] * 3 + k];
+
+				if (std::find(cache.begin(), cache.end(), vertex) == cache.end())
+				{
+					cache[head] = vertex;
+					head = (head + 1) % cacheSize;
+					++misses;
+				}
+			}
+
+			const uint numClusterTriangles = i + 1 - start;
+
+			if (i + 1 < end
+				&& numClusterTriangles >= MIN_CLUSTER_TRIANGLES
+				&& float(misses) < MAX_CLUSTER_ACMR * float(numClusterTriangles))
+			{
+				start	= i + 1;
+				misses	= 0;
+				std::fill(cache.begin(), cache.end(), -1);
+				boundaries.push_back(start);
+			}
+		}
+	}
+
+	clusters.swap(boundaries);
+}
+
+void
+Geometry::sortClusters(std::vector<uint>& triangles, const std::vector<uint>& clusters)
+{
+	auto			xyzBuffer	= vertexBuffer("position");
+	const auto&		xyzData		= xyzBuffer->data();
+	const uint		xyzSize		= xyzBuffer->vertexSize();
+	const uint		xyzOffset	= std::get<2>(*xyzBuffer->attribute("position"));
+	const auto&		indices		= _indexBuffer->data();
+	const uint		numClusters	= clusters.size();
+
+	if (numClusters < 2)
+		return;
+
+	// per cluster: sum of the triangle centroids, number of triangles and sum of the area weighted normals
+	std::vector<float>	centroids(numClusters * 3, 0.f);
+	std::vector<float>	normals(numClusters * 3, 0.f);
+	std::vector<uint>	numTriangles(numClusters, 0);
+	float				meshCentroid[3]	= { 0.f, 0.f, 0.f };
+
+	for (uint clusterId = 0; clusterId < numClusters; ++clusterId)
+	{
+		const uint end = clusterId + 1 < numClusters ? clusters[clusterId + 1] : triangles.size();
+
+		for (uint i = clusters[clusterId]; i < end; ++i)
+		{
+			const float* p[3];
+
+			for (uint k = 0; k < 3; ++k)
+				p[k] = &xyzData[indices[triangles[i] * 3 + k] * xyzSize + xyzOffset];
+
+			const float u[3] = { p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2] };
+			const float v[3] = { p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2] };
+
+			normals[clusterId * 3]		+= u[1] * v[2] - u[2] * v[1];
+			normals[clusterId * 3 + 1]	+= u[2] * v[0] - u[0] * v[2];
+			normals[clusterId * 3 + 2]	+= u[0] * v[1] - u[1] * v[0];
+
+			for (uint c = 0; c < 3; ++c)
+			{
+				const float centroid = (p[0][c] + p[1][c] + p[2][c]) / 3.f;
+
+				centroids[clusterId * 3 + c]	+= centroid;
+				meshCentroid[c]					+= centroid;
+			}
+		}
+
+		numTriangles[clusterId] = end - clusters[clusterId];
+	}
+
+	for (uint c = 0; c < 3; ++c)
+		meshCentroid[c] /= float(triangles.size());
+
+	// the clusters facing away from the center of the mesh are the most likely to occlude the others
+	std::vector<float> scores(numClusters, 0.f);
+
+	for (uint clusterId = 0; clusterId < numClusters; ++clusterId)
+	{
+		const float*	n		= &normals[clusterId * 3];
+		const float		length	= sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+		if (length < 1e-12f || numTriangles[clusterId] == 0)
+			continue;
+
+		for (uint c = 0; c < 3; ++c)
+			scores[clusterId] += (centroids[clusterId * 3 + c] / float(numTriangles[clusterId]) - meshCentroid[c]) * n[c];
+		scores[clusterId] /= length;
+	}
+
+	std::vector<uint> order(numClusters);
+
+	for (uint i = 0; i < numClusters; ++i)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [&](uint a, uint b)
+	{
+		return scores[a] > scores[b];
+	});
+
+	std::vector<uint> sortedTriangles;
+
+	sortedTriangles.reserve(triangles.size());
+	for (auto clusterId : order)
+	{
+		const uint end = clusterId + 1 < numClusters ? clusters[clusterId + 1] : triangles.size();
+
+		sortedTriangles.insert(sortedTriangles.end(), triangles.begin() + clusters[clusterId], triangles.begin() + end);
+	}
+
+	triangles.swap(sortedTriangles);
+}
+
+void
+Geometry::remapVertices()
+{
+	auto&				indices		= _indexBuffer->data();
+	std::vector<int>	remap(_numVertices, -1);
+	int					numRemapped	= 0;
+
+	for (auto& index : indices)
+	{
+		if (remap[index] < 0)
+			remap[index] = numRemapped++;
+		index = remap[index];
+	}
+
+	// unreferenced vertices are kept, after all the others
+	for (auto& newIndex : remap)
+		if (newIndex < 0)
+			newIndex = numRemapped++;
+
+	for (auto& vertexBuffer : _vertexBuffers)
+	{
+		auto&				data		= vertexBuffer->data();
+		const uint			vertexSize	= vertexBuffer->vertexSize();
+		std::vector<float>	remappedData(data.size());
+
+		for (uint i = 0; i < _numVertices; ++i)
+			std::copy(
+				data.begin() + i * vertexSize,
+				data.begin() + (i + 1) * vertexSize,
+				remappedData.begin() + remap[i] * vertexSize
+			);
+		data.swap(remappedData);
+
+		if (vertexBuffer->isReady())
+			vertexBuffer->upload();
+	}
+}
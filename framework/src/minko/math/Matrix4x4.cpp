@@ -120,6 +120,22 @@ Matrix4x4::initialize(Quaternion::Ptr rotation, Vector3::Ptr translation)
 	return copyFrom(rotation->toMatrix())->appendTranslation(translation);
 }
 
+/*static*/
+void
+Matrix4x4::initialize(const std::vector<Ptr>& matrices, const float* values)
+{
+	for (auto& matrix : matrices)
+	{
+		std::copy(values, values + 16, matrix->_m.begin());
+		matrix->_hasChanged = true;
+		values += 16;
+	}
+
+	for (auto& matrix : matrices)
+		if (!matrix->_lock)
+			matrix->changed()->execute(matrix);
+}
+
 Matrix4x4::Ptr
 Matrix4x4::identity()
 {
@@ -452,51 +468,89 @@ Matrix4x4::orthographic(float left, // vertical FOV
 Matrix4x4::Ptr
 Matrix4x4::view(Vector3::Ptr eye, Vector3::Ptr lookAt, Vector3::Ptr upAxis)
 {
-    Vector3::Ptr	zAxis = eye - lookAt;
+	return view(eye->x(), eye->y(), eye->z(), lookAt->x(), lookAt->y(), lookAt->z(), upAxis);
+}
+
+Matrix4x4::Ptr
+Matrix4x4::view(float			eyeX,
+				float			eyeY,
+				float			eyeZ,
+				float			lookAtX,
+				float			lookAtY,
+				float			lookAtZ,
+				Vector3::Ptr	upAxis)
+{
+	float zx = eyeX - lookAtX;
+	float zy = eyeY - lookAtY;
+	float zz = eyeZ - lookAtZ;
 
-	zAxis->normalize();
+	normalize(zx, zy, zz);
 
 	if (upAxis == 0)
 	{
-		if (zAxis->x() == 0. && zAxis->y() != 0. && zAxis->z() == 0.)
+		if (zx == 0. && zy != 0. && zz == 0.)
 			upAxis = Vector3::xAxis();
 		else
 			upAxis = Vector3::yAxis();
 	}
 
-	Vector3::Ptr xAxis = Vector3::create()->copyFrom(upAxis)->cross(zAxis)->normalize();
-	Vector3::Ptr yAxis = Vector3::create()->copyFrom(zAxis)->cross(xAxis)->normalize();
+	float xx = upAxis->y() * zz - upAxis->z() * zy;
+	float xy = upAxis->z() * zx - upAxis->x() * zz;
+	float xz = upAxis->x() * zy - upAxis->y() * zx;
+
+	normalize(xx, xy, xz);
 
-	if ((xAxis->x() == 0.f && xAxis->y() == 0.f && xAxis->z() == 0.f)
-		|| (yAxis->x() == 0.f && yAxis->y() == 0.f && yAxis->z() == 0.f))
+	float yx = zy * xz - zz * xy;
+	float yy = zz * xx - zx * xz;
+	float yz = zx * xy - zy * xx;
+
+	normalize(yx, yy, yz);
+
+	if ((xx == 0.f && xy == 0.f && xz == 0.f)
+		|| (yx == 0.f && yy == 0.f && yz == 0.f))
 	{
 		throw std::invalid_argument(
 			"the eye direction (look at - eye position) and the up vector appear to be the same"
 		);
 	}
 
-	float m41 = -(xAxis->dot(eye));
-	float m42 = -(yAxis->dot(eye));
-	float m43 = -(zAxis->dot(eye));
+	float m41 = -(xx * eyeX + xy * eyeY + xz * eyeZ);
+	float m42 = -(yx * eyeX + yy * eyeY + yz * eyeZ);
+	float m43 = -(zx * eyeX + zy * eyeY + zz * eyeZ);
 	
 	return initialize(
-		xAxis->x(),	xAxis->y(),	xAxis->z(),	m41,
-		yAxis->x(),	yAxis->y(),	yAxis->z(), m42,
-		zAxis->x(),	zAxis->y(),	zAxis->z(),	m43,
-		0.f,		0.f,		0.f,		1.f
+		xx,		xy,		xz,		m41,
+		yx,		yy,		yz,		m42,
+		zx,		zy,		zz,		m43,
+		0.f,	0.f,	0.f,	1.f
 	);
 }
 
 Matrix4x4::Ptr
 Matrix4x4::lookAt(Vector3::Ptr lookAt, Vector3::Ptr	position, Vector3::Ptr up)
 {
-	if (position == 0)
-		position = Vector3::create(_m[3], _m[7], _m[11]);
-
 	if (up == nullptr)
 		up = Vector3::yAxis();
 
-	return view(position, lookAt, up)->invert();
+	if (position == nullptr)
+		view(_m[3], _m[7], _m[11], lookAt->x(), lookAt->y(), lookAt->z(), up);
+	else
+		view(position->x(), position->y(), position->z(), lookAt->x(), lookAt->y(), lookAt->z(), up);
+
+	return invert();
+}
+
+void
+Matrix4x4::normalize(float& x, float& y, float& z)
+{
+	float l = sqrtf(x * x + y * y + z * z);
+
+	if (l != 0.)
+	{
+		x /= l;
+		y /= l;
+		z /= l;
+	}
 }
 
 Matrix4x4::Ptr
@@ -235,6 +235,23 @@ OctTree::testFrustum(std::shared_ptr<math::AbstractShape>				frustum,
 	}
 }
 
+void
+OctTree::cast(std::shared_ptr<math::Ray>							ray,
+			  std::function<void(std::shared_ptr<scene::Node>)>	callback)
+{
+	auto distance = 0.f;
+
+	if (!_octantBox->cast(ray, distance))
+		return;
+
+	for (auto node : _content)
+		callback(node);
+
+	if (_splitted)
+		for (auto octantChild : _children)
+			octantChild->cast(ray, callback);
+}
+
 OctTree::Ptr
 OctTree::remove(std::shared_ptr<scene::Node> node)
 {
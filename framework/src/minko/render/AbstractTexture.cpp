@@ -146,7 +146,7 @@ AbstractTexture::getMipmapWidth(uint level) const
 	assert(math::isp2(_widthGPU));
 
 	const uint p = math::getp2(_widthGPU);
-	return 1 << (p - level);
+	return level < p ? 1 << (p - level) : 1;
 	// return uint(powf(2.0f, (log2f(_widthGPU) - level)))
 }
 
@@ -156,5 +156,5 @@ AbstractTexture::getMipmapHeight(uint level) const
 	assert(math::isp2(_heightGPU));
 
 	const uint p = math::getp2(_heightGPU);
-	return 1 << (p - level);
+	return level < p ? 1 << (p - level) : 1;
 }
@@ -45,6 +45,9 @@ CubeTexture::data(unsigned char*	data,
 				  int				,
 				  int				)
 {
+	if (format != TextureFormat::RGB && format != TextureFormat::RGBA)
+		throw std::invalid_argument("format");
+
 	const unsigned int faceWidth	= _width >> 2;
 	const unsigned int faceHeight	= _height / 3;
 	const unsigned int faceSize		= faceWidth * faceHeight * sizeof(int);
@@ -47,6 +47,10 @@ using namespace minko::render;
 SamplerState DrawCall::_defaultSamplerState = SamplerState(WrapMode::CLAMP, TextureFilter::NEAREST, MipFilter::NONE);
 /*static*/ const unsigned int	DrawCall::MAX_NUM_TEXTURES		= 8;
 /*static*/ const unsigned int	DrawCall::MAX_NUM_VERTEXBUFFERS	= 8;
+/*static*/ const unsigned int	DrawCall::NO_INDEX_BUFFER		= std::numeric_limits<unsigned int>::max();
+/*static*/ const std::vector<std::string>	DrawCall::DEFORMATION_INPUTS	= {
+	"boneIdsA", "boneIdsB", "boneWeightsA", "boneWeightsB", "boneMatrices", "displacementMap"
+};
 
 DrawCall::DrawCall(const data::BindingMap&	attributeBindings,
 				   const data::BindingMap&	uniformBindings,
@@ -67,6 +71,7 @@ DrawCall::DrawCall(const data::BindingMap&	attributeBindings,
     _vertexSizes(MAX_NUM_VERTEXBUFFERS, -1),
     _vertexAttributeSizes(MAX_NUM_VERTEXBUFFERS, -1),
     _vertexAttributeOffsets(MAX_NUM_VERTEXBUFFERS, -1),
+	_positionVertexBufferIndex(-1),
 	_target(nullptr),
 	_referenceChangedSlots(),
 	_zsortNeeded(Signal<Ptr>::create()),
@@ -111,7 +116,7 @@ DrawCall::bindIndexBuffer()
 {
 	const std::string propertyName = "geometry[" + _variablesToValue["geometryId"] + "].indices";
 
-	_indexBuffer	= -1;
+	_indexBuffer	= NO_INDEX_BUFFER;
 	_numIndices		= 0;
 
 
@@ -221,6 +226,9 @@ DrawCall::bindVertexAttribute(const std::string&	inputName,
 			_vertexAttributeSizes	[vertexBufferIndex]	= std::get<1>(*attribute);
 			_vertexSizes			[vertexBufferIndex]	= vertexBuffer->vertexSize();
 			_vertexAttributeOffsets	[vertexBufferIndex]	= std::get<2>(*attribute);
+
+			if (inputName == "position")
+				_positionVertexBufferIndex = vertexBufferIndex;
 		}
 
 
@@ -496,6 +504,7 @@ DrawCall::reset()
 	_vertexSizes			.resize(MAX_NUM_VERTEXBUFFERS, -1);
 	_vertexAttributeSizes	.resize(MAX_NUM_VERTEXBUFFERS, -1);
 	_vertexAttributeOffsets	.resize(MAX_NUM_VERTEXBUFFERS, -1);
+	_positionVertexBufferIndex = -1;
 
 	_referenceChangedSlots.clear();
 	_zSorter->clear();
@@ -526,7 +535,9 @@ DrawCall::bindStates()
 }
 
 void
-DrawCall::render(const AbstractContext::Ptr& context, AbstractTexture::Ptr renderTarget)
+DrawCall::render(const AbstractContext::Ptr&	context,
+				 AbstractTexture::Ptr			renderTarget,
+				 bool							depthPrePassed)
 {
 	if (!renderTarget)
 		renderTarget = _target;
@@ -674,17 +685,102 @@ DrawCall::render(const AbstractContext::Ptr& context, AbstractTexture::Ptr rende
 	
 	context->setColorMask(_colorMask);
 	context->setBlendMode(_blendMode);
-	context->setDepthTest(_depthMask, _depthFunc);
+	// LESS_EQUAL rather than EQUAL: without an invariant gl_Position in both programs,
+	// the main pass positions are not guaranteed to match the pre-pass ones bit for bit
+	if (depthPrePassed)
+		context->setDepthTest(false, CompareMode::LESS_EQUAL);
+	else
+		context->setDepthTest(_depthMask, _depthFunc);
 	context->setStencilTest(_stencilFunc, _stencilRef, _stencilMask, _stencilFailOp, _stencilZFailOp, _stencilZPassOp);
 	context->setScissorTest(_scissorTest, _scissorBox);
     context->setTriangleCulling(_triangleCulling);
 
 	if (_program->indexBuffer() && _program->indexBuffer()->isReady())
 		context->drawTriangles(_program->indexBuffer()->id(), _program->indexBuffer()->data().size() / 3);
-	else if (_indexBuffer != -1)
+	else if (_indexBuffer != NO_INDEX_BUFFER)
 		context->drawTriangles(_indexBuffer, _numIndices / 3);
 }
 
+bool
+DrawCall::depthPrePassCompatible() const
+{
+	if (!_program || !_program->inputs() || _positionVertexBufferIndex < 0
+		|| _vertexBufferIds[_positionVertexBufferIndex] <= 0 || _indexBuffer == NO_INDEX_BUFFER
+		|| _program->indexBuffer() || !_program->vertexBuffers().empty() || _target)
+		return false;
+
+	if (!_colorMask || !_depthMask || (_depthFunc != CompareMode::LESS && _depthFunc != CompareMode::LESS_EQUAL)
+		|| _blendMode != Blending::Mode::DEFAULT || _stencilFunc != CompareMode::ALWAYS || _scissorTest
+		|| zSorted() || _priority < priority::OPAQUE)
+		return false;
+
+	auto inputs = _program->inputs();
+
+	// vertex shaders moving the vertices (skinning, displacement...) cannot be matched by the depth program
+	for (auto& name : DEFORMATION_INPUTS)
+		if (inputs->hasName(name))
+			return false;
+
+	if (!inputs->hasName("worldToScreenMatrix"))
+		return false;
+
+	return _uniformFloat16.count(inputs->location("worldToScreenMatrix")) != 0
+		&& (!inputs->hasName("modelToWorldMatrix") || _uniformFloat16.count(inputs->location("modelToWorldMatrix")) != 0);
+}
+
+void
+DrawCall::renderDepth(const AbstractContext::Ptr&	context,
+					  AbstractTexture::Ptr			renderTarget,
+					  Program::Ptr					depthProgram)
+{
+	static const float identity[] = {
+		1.f, 0.f, 0.f, 0.f,
+		0.f, 1.f, 0.f, 0.f,
+		0.f, 0.f, 1.f, 0.f,
+		0.f, 0.f, 0.f, 1.f
+	};
+
+	if (!renderTarget)
+		renderTarget = _target;
+
+	if (renderTarget)
+	{
+		if (renderTarget->id() != context->renderTarget())
+		{
+			context->setRenderToTexture(renderTarget->id(), true);
+			context->clear();
+		}
+	}
+	else
+		context->setRenderToBackBuffer();
+
+	auto inputs			= _program->inputs();
+	auto depthInputs	= depthProgram->inputs();
+	auto modelToWorld	= inputs->hasName("modelToWorldMatrix")
+		? _uniformFloat16.at(inputs->location("modelToWorldMatrix"))
+		: identity;
+
+	context->setProgram(depthProgram->id());
+	context->setUniform(depthInputs->location("modelToWorldMatrix"), 1, true, modelToWorld);
+	context->setUniform(depthInputs->location("worldToScreenMatrix"), 1, true, _uniformFloat16.at(inputs->location("worldToScreenMatrix")));
+	context->setVertexBufferAt(
+		depthInputs->location("position"),
+		_vertexBufferIds[_positionVertexBufferIndex],
+		_vertexAttributeSizes[_positionVertexBufferIndex],
+		_vertexSizes[_positionVertexBufferIndex],
+		_vertexAttributeOffsets[_positionVertexBufferIndex]
+	);
+
+	context->setColorMask(false);
+	context->setBlendMode(Blending::Mode::DEFAULT);
+	context->setDepthTest(true, CompareMode::LESS);
+	context->setStencilTest(CompareMode::ALWAYS, 0, 0x1, StencilOperation::KEEP, StencilOperation::KEEP, StencilOperation::KEEP);
+	context->setScissorTest(false, _scissorBox);
+	context->setTriangleCulling(_triangleCulling);
+
+	context->drawTriangles(_indexBuffer, _numIndices / 3);
+}
+
 Container::Ptr
 DrawCall::getDataContainer(const data::BindingSource& source) const
 {
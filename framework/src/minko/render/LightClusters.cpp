@@ -0,0 +1,199 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/render/LightClusters.hpp"
+
+#include "minko/math/Matrix4x4.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+namespace
+{
+	// stands for an infinite light radius while keeping the projections finite
+	const float INFINITE_RADIUS		= 1e18f;
+	// below that, spawning a worker costs more than the binning it saves
+	const uint	MIN_LIGHTS_PER_JOB	= 64;
+}
+
+LightClusters::LightClusters(uint numX, uint numY, uint numZ, uint maxLightsPerCluster) :
+	_numX(numX),
+	_numY(numY),
+	_numZ(numZ),
+	_maxLightsPerCluster(maxLightsPerCluster),
+	_zNear(0.f),
+	_depthScale(0.f),
+	_depthBias(0.f),
+	_projectionX(1.f),
+	_projectionY(1.f),
+	_viewSpheres(),
+	_sliceRanges(),
+	_lights(numX * numY * numZ * maxLightsPerCluster, 0),
+	_counts(numX * numY * numZ, 0)
+{
+}
+
+void
+LightClusters::build(const std::vector<float>&	spheres,
+					 Matrix4x4Ptr				view,
+					 Matrix4x4Ptr				projection,
+					 float						zNear,
+					 float						zFar,
+					 uint						numJobs)
+{
+	if (zNear <= 0.f || zFar <= zNear)
+		throw std::invalid_argument("zNear and zFar must verify 0 < zNear < zFar.");
+
+	const auto&	v			= view->data();
+	const uint	numLights	= std::min<uint>(spheres.size() / 4, USHRT_MAX);
+
+	_zNear			= zNear;
+	_depthScale		= _numZ / logf(zFar / zNear);
+	_depthBias		= -logf(zNear) * _depthScale;
+	_projectionX	= projection->data()[0];
+	_projectionY	= projection->data()[5];
+
+	_viewSpheres.resize(numLights * 4);
+	_sliceRanges.resize(numLights * 2);
+
+	for (uint i = 0; i < numLights; ++i)
+	{
+		const float*	sphere	= &spheres[i * 4];
+		const float		x		= v[0] * sphere[0] + v[1] * sphere[1] + v[2] * sphere[2] + v[3];
+		const float		y		= v[4] * sphere[0] + v[5] * sphere[1] + v[6] * sphere[2] + v[7];
+		const float		depth	= -(v[8] * sphere[0] + v[9] * sphere[1] + v[10] * sphere[2] + v[11]);
+		const float		radius	= sphere[3] < 0.f ? INFINITE_RADIUS : sphere[3];
+		float*			viewSphere	= &_viewSpheres[i * 4];
+
+		viewSphere[0] = x;
+		viewSphere[1] = y;
+		viewSphere[2] = depth;
+		viewSphere[3] = radius;
+
+		if (depth + radius < zNear || depth - radius > zFar)
+		{
+			_sliceRanges[i * 2]		= 1;
+			_sliceRanges[i * 2 + 1]	= 0;
+		}
+		else
+		{
+			_sliceRanges[i * 2]		= slice(std::max(depth - radius, zNear));
+			_sliceRanges[i * 2 + 1]	= slice(std::min(depth + radius, zFar));
+		}
+	}
+
+	numJobs = std::max(1u, std::min(std::min(numJobs, _numZ), numLights / MIN_LIGHTS_PER_JOB));
+
+#if !defined(EMSCRIPTEN)
+	if (numJobs > 1)
+	{
+		std::vector<std::future<void>> jobs;
+
+		for (uint job = 1; job < numJobs; ++job)
+		{
+			const uint firstSlice	= job * _numZ / numJobs;
+			const uint lastSlice	= (job + 1) * _numZ / numJobs;
+
+			jobs.push_back(std::async(std::launch::async, [this, firstSlice, lastSlice]()
+			{
+				binSlices(firstSlice, lastSlice);
+			}));
+		}
+
+		binSlices(0, _numZ / numJobs);
+
+		for (auto& job : jobs)
+			job.get();
+
+		return;
+	}
+#endif
+
+	binSlices(0, _numZ);
+}
+
+void
+LightClusters::binSlices(uint firstSlice, uint lastSlice)
+{
+	const uint	numLights	= _viewSpheres.size() / 4;
+	const uint	sliceSize	= _numX * _numY;
+
+	std::fill(_counts.begin() + firstSlice * sliceSize, _counts.begin() + lastSlice * sliceSize, 0);
+
+	for (uint z = firstSlice; z < lastSlice; ++z)
+	{
+		const float sliceNear	= sliceDepth(z);
+		const float sliceFar	= sliceDepth(z + 1);
+
+		for (uint i = 0; i < numLights; ++i)
+		{
+			if ((int)z < _sliceRanges[i * 2] || (int)z > _sliceRanges[i * 2 + 1])
+				continue;
+
+			const float*	sphere	= &_viewSpheres[i * 4];
+			const float		radius	= sphere[3];
+			const float		depth0	= std::max(sphere[2] - radius, sliceNear);
+			const float		depth1	= std::min(sphere[2] + radius, sliceFar);
+
+			// screen-space bounds of the sphere's bounding box clipped to the slice: x / depth is
+			// monotonic along each axis of the box, so its extrema are reached at the corners
+			const float		x0		= (sphere[0] - radius) * _projectionX;
+			const float		x1		= (sphere[0] + radius) * _projectionX;
+			const float		y0		= (sphere[1] - radius) * _projectionY;
+			const float		y1		= (sphere[1] + radius) * _projectionY;
+			const float		minX	= std::min(x0 / depth0, x0 / depth1);
+			const float		maxX	= std::max(x1 / depth0, x1 / depth1);
+			const float		minY	= std::min(y0 / depth0, y0 / depth1);
+			const float		maxY	= std::max(y1 / depth0, y1 / depth1);
+
+			if (maxX < -1.f || minX > 1.f || maxY < -1.f || minY > 1.f)
+				continue;
+
+			const uint		tileX0	= (uint)std::max(0.f, floorf((minX * .5f + .5f) * _numX));
+			const uint		tileX1	= (uint)std::min(_numX - 1.f, floorf((maxX * .5f + .5f) * _numX));
+			const uint		tileY0	= (uint)std::max(0.f, floorf((minY * .5f + .5f) * _numY));
+			const uint		tileY1	= (uint)std::min(_numY - 1.f, floorf((maxY * .5f + .5f) * _numY));
+
+			for (uint y = tileY0; y <= tileY1; ++y)
+				for (uint x = tileX0; x <= tileX1; ++x)
+				{
+					const uint	cluster	= clusterIndex(x, y, z);
+					auto&		count	= _counts[cluster];
+
+					if (count < _maxLightsPerCluster)
+						_lights[cluster * _maxLightsPerCluster + count++] = i;
+				}
+		}
+	}
+}
+
+int
+LightClusters::slice(float depth) const
+{
+	const int z = (int)floorf(logf(depth) * _depthScale + _depthBias);
+
+	return std::max(0, std::min(z, (int)_numZ - 1));
+}
+
+float
+LightClusters::sliceDepth(uint slice) const
+{
+	return _zNear * expf(slice / _depthScale);
+}
@@ -0,0 +1,186 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/render/MipMapChain.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+namespace
+{
+	const float LANCZOS_LOBES = 3.f;
+
+	// source samples, clamped to the image, and normalized weights of a destination sample
+	struct Contribution
+	{
+		uint				first;
+		std::vector<float>	weights;
+	};
+
+	inline
+	float
+	lanczos(float x)
+	{
+		x = std::abs(x);
+
+		if (x < 1e-5f)
+			return 1.f;
+		if (x >= LANCZOS_LOBES)
+			return 0.f;
+
+		const float pix = float(PI) * x;
+
+		return LANCZOS_LOBES * std::sin(pix) * std::sin(pix / LANCZOS_LOBES) / (pix * pix);
+	}
+
+	void
+	computeContributions(uint srcSize, uint dstSize, std::vector<Contribution>& contributions)
+	{
+		const float scale		= (float)srcSize / (float)dstSize;
+		// when minifying, the kernel is stretched to cut the frequencies the destination cannot hold
+		const float filterScale	= std::max(1.f, scale);
+		const float radius		= LANCZOS_LOBES * filterScale;
+
+		contributions.resize(dstSize);
+
+		for (uint i = 0; i < dstSize; ++i)
+		{
+			const float	center	= (i + .5f) * scale;
+			const int	first	= (int)std::floor(center - radius);
+			const int	last	= (int)std::ceil(center + radius);
+			auto&		c		= contributions[i];
+
+			c.first = std::max(0, first);
+			c.weights.assign(std::min(last, (int)srcSize - 1) - (int)c.first + 1, 0.f);
+
+			float sum = 0.f;
+
+			for (int j = first; j <= last; ++j)
+			{
+				const float	weight	= lanczos((j + .5f - center) / filterScale);
+				const int	index	= std::min(std::max(j, 0), (int)srcSize - 1);
+
+				c.weights[index - c.first] += weight;
+				sum += weight;
+			}
+
+			for (auto& weight : c.weights)
+				weight /= sum;
+		}
+	}
+}
+
+void
+MipMapChain::resize(uint						width,
+					uint						height,
+					const unsigned char*		rgba,
+					uint						newWidth,
+					uint						newHeight,
+					std::vector<unsigned char>&	out)
+{
+	if (width == 0 || height == 0 || newWidth == 0 || newHeight == 0)
+		throw std::invalid_argument("size");
+
+	std::vector<Contribution>	horizontal;
+	std::vector<Contribution>	vertical;
+	std::vector<float>			premultiplied(width * height * 4);
+	std::vector<float>			rows(newWidth * height * 4);
+
+	computeContributions(width, newWidth, horizontal);
+	computeContributions(height, newHeight, vertical);
+
+	for (uint i = 0; i < width * height; ++i)
+	{
+		const float alpha = rgba[i * 4 + 3] / 255.f;
+
+		for (uint c = 0; c < 3; ++c)
+			premultiplied[i * 4 + c] = rgba[i * 4 + c] * alpha;
+		premultiplied[i * 4 + 3] = rgba[i * 4 + 3];
+	}
+
+	for (uint y = 0; y < height; ++y)
+		for (uint x = 0; x < newWidth; ++x)
+		{
+			const auto&	contribution	= horizontal[x];
+			float*		dst				= &rows[(y * newWidth + x) * 4];
+
+			for (uint j = 0; j < contribution.weights.size(); ++j)
+			{
+				const float* src = &premultiplied[(y * width + contribution.first + j) * 4];
+
+				for (uint c = 0; c < 4; ++c)
+					dst[c] += src[c] * contribution.weights[j];
+			}
+		}
+
+	out.resize(newWidth * newHeight * 4);
+
+	for (uint y = 0; y < newHeight; ++y)
+		for (uint x = 0; x < newWidth; ++x)
+		{
+			const auto&	contribution	= vertical[y];
+			float		color[4]		= { 0.f, 0.f, 0.f, 0.f };
+
+			for (uint j = 0; j < contribution.weights.size(); ++j)
+			{
+				const float* src = &rows[((contribution.first + j) * newWidth + x) * 4];
+
+				for (uint c = 0; c < 4; ++c)
+					color[c] += src[c] * contribution.weights[j];
+			}
+
+			// the negative lobes can overshoot
+			const float		alpha	= std::min(std::max(color[3], 0.f), 255.f);
+			unsigned char*	dst		= &out[(y * newWidth + x) * 4];
+
+			for (uint c = 0; c < 3; ++c)
+			{
+				const float value = alpha > 0.f ? color[c] * 255.f / alpha : 0.f;
+
+				dst[c] = (unsigned char)(std::min(std::max(value, 0.f), 255.f) + .5f);
+			}
+			dst[3] = (unsigned char)(alpha + .5f);
+		}
+}
+
+void
+MipMapChain::build(uint										width,
+				   uint										height,
+				   const unsigned char*						rgba,
+				   std::vector<std::vector<unsigned char>>&	levels)
+{
+	if (!math::isp2(width) || !math::isp2(height))
+		throw std::invalid_argument("size");
+
+	const uint numLevels = math::getp2(std::max(width, height)) + 1;
+
+	levels.resize(numLevels);
+	levels[0].assign(rgba, rgba + width * height * 4);
+
+	for (uint level = 1; level < numLevels; ++level)
+		resize(
+			std::max(1u, width >> (level - 1)),
+			std::max(1u, height >> (level - 1)),
+			&levels[level - 1].front(),
+			std::max(1u, width >> level),
+			std::max(1u, height >> level),
+			levels[level]
+		);
+}
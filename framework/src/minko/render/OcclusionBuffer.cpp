@@ -0,0 +1,277 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include "minko/render/OcclusionBuffer.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+namespace
+{
+	// below that, spawning a worker costs more than the rasterization it saves
+	const uint	MIN_TRIANGLES_PER_JOB	= 256;
+	// texels tested per axis before moving to a coarser level
+	const uint	MAX_TEST_SPAN			= 4;
+	// fraction of a pixel an edge function may fall short by and still cover the pixel center
+	const float	EDGE_EPSILON			= 1e-3f;
+}
+
+OcclusionBuffer::OcclusionBuffer(uint width, uint height) :
+	_width(width),
+	_height(height),
+	_triangles(),
+	_clipVertices(),
+	_levels()
+{
+	for (uint level = 0; _levels.empty() || levelWidth(level - 1) > 1 || levelHeight(level - 1) > 1; ++level)
+		_levels.push_back(std::vector<float>(levelWidth(level) * levelHeight(level), 1.f));
+}
+
+void
+OcclusionBuffer::clear()
+{
+	_triangles.clear();
+
+	for (auto& level : _levels)
+		std::fill(level.begin(), level.end(), 1.f);
+}
+
+void
+OcclusionBuffer::addOccluder(const float*			vertices,
+							 uint					vertexSize,
+							 uint					positionOffset,
+							 uint					numVertices,
+							 const unsigned short*	indices,
+							 uint					numIndices,
+							 const float*			m)
+{
+	_clipVertices.resize(numVertices * 4);
+
+	for (uint i = 0; i < numVertices; ++i)
+	{
+		const float*	position	= vertices + i * vertexSize + positionOffset;
+		float*			clip		= &_clipVertices[i * 4];
+
+		clip[0] = m[0] * position[0] + m[1] * position[1] + m[2] * position[2] + m[3];
+		clip[1] = m[4] * position[0] + m[5] * position[1] + m[6] * position[2] + m[7];
+		clip[2] = m[8] * position[0] + m[9] * position[1] + m[10] * position[2] + m[11];
+		clip[3] = m[12] * position[0] + m[13] * position[1] + m[14] * position[2] + m[15];
+	}
+
+	for (uint i = 0; i + 2 < numIndices; i += 3)
+	{
+		const float*	clip[3]		= {
+			&_clipVertices[indices[i] * 4],
+			&_clipVertices[indices[i + 1] * 4],
+			&_clipVertices[indices[i + 2] * 4]
+		};
+		float			screen[9];
+		bool			visible		= true;
+
+		for (uint j = 0; j < 3 && visible; ++j)
+		{
+			// the part of the triangle in front of the near plane is clipped by the GPU: drop it all
+			visible = clip[j][2] >= -clip[j][3] && clip[j][3] > 0.f;
+
+			const float invW = 1.f / clip[j][3];
+
+			screen[j * 3]		= (clip[j][0] * invW * .5f + .5f) * _width;
+			screen[j * 3 + 1]	= (clip[j][1] * invW * .5f + .5f) * _height;
+			screen[j * 3 + 2]	= clip[j][2] * invW * .5f + .5f;
+		}
+
+		if (!visible
+			|| (screen[0] < 0.f && screen[3] < 0.f && screen[6] < 0.f)
+			|| (screen[1] < 0.f && screen[4] < 0.f && screen[7] < 0.f)
+			|| (screen[0] > _width && screen[3] > _width && screen[6] > _width)
+			|| (screen[1] > _height && screen[4] > _height && screen[7] > _height)
+			|| (screen[2] > 1.f && screen[5] > 1.f && screen[8] > 1.f))
+			continue;
+
+		_triangles.insert(_triangles.end(), screen, screen + 9);
+	}
+}
+
+void
+OcclusionBuffer::rasterize(uint numJobs)
+{
+	numJobs = std::max(1u, std::min(std::min(numJobs, _height), numTriangles() / MIN_TRIANGLES_PER_JOB));
+
+#if !defined(EMSCRIPTEN)
+	if (numJobs > 1)
+	{
+		std::vector<std::future<void>> jobs;
+
+		for (uint job = 1; job < numJobs; ++job)
+		{
+			const uint firstRow	= job * _height / numJobs;
+			const uint lastRow	= (job + 1) * _height / numJobs;
+
+			jobs.push_back(std::async(std::launch::async, [this, firstRow, lastRow]()
+			{
+				rasterizeRows(firstRow, lastRow);
+			}));
+		}
+
+		rasterizeRows(0, _height / numJobs);
+
+		for (auto& job : jobs)
+			job.get();
+
+		buildHierarchy();
+
+		return;
+	}
+#endif
+
+	rasterizeRows(0, _height);
+	buildHierarchy();
+}
+
+void
+OcclusionBuffer::rasterizeRows(uint firstRow, uint lastRow)
+{
+	auto& depths = _levels[0];
+
+	for (uint i = 0; i < _triangles.size(); i += 9)
+	{
+		const float*	v0		= &_triangles[i];
+		const float*	v1		= &_triangles[i + 3];
+		const float*	v2		= &_triangles[i + 6];
+		float			area	= (v1[0] - v0[0]) * (v2[1] - v0[1]) - (v1[1] - v0[1]) * (v2[0] - v0[0]);
+
+		if (area == 0.f)
+			continue;
+		if (area < 0.f)
+		{
+			std::swap(v1, v2);
+			area = -area;
+		}
+
+		const int minX	= std::max(0, (int)floorf(std::min(v0[0], std::min(v1[0], v2[0]))));
+		const int maxX	= std::min((int)_width - 1, (int)ceilf(std::max(v0[0], std::max(v1[0], v2[0]))));
+		const int minY	= std::max((int)firstRow, (int)floorf(std::min(v0[1], std::min(v1[1], v2[1]))));
+		const int maxY	= std::min((int)lastRow - 1, (int)ceilf(std::max(v0[1], std::max(v1[1], v2[1]))));
+
+		if (minX > maxX || minY > maxY)
+			continue;
+
+		// edge functions and depth are affine in screen space: step them along the rows
+		const float invArea	= 1.f / area;
+		const float a0		= v1[1] - v2[1];
+		const float b0		= v2[0] - v1[0];
+		const float a1		= v2[1] - v0[1];
+		const float b1		= v0[0] - v2[0];
+		const float a2		= v0[1] - v1[1];
+		const float b2		= v1[0] - v0[0];
+		const float dDepthX	= (a0 * v0[2] + a1 * v1[2] + a2 * v2[2]) * invArea;
+		const float e0		= -EDGE_EPSILON * (fabsf(a0) + fabsf(b0));
+		const float e1		= -EDGE_EPSILON * (fabsf(a1) + fabsf(b1));
+		const float e2		= -EDGE_EPSILON * (fabsf(a2) + fabsf(b2));
+		const float x		= minX + .5f;
+
+		for (int py = minY; py <= maxY; ++py)
+		{
+			const float y		= py + .5f;
+			float		w0		= a0 * (x - v1[0]) + b0 * (y - v1[1]);
+			float		w1		= a1 * (x - v2[0]) + b1 * (y - v2[1]);
+			float		w2		= a2 * (x - v0[0]) + b2 * (y - v0[1]);
+			float		depth	= (w0 * v0[2] + w1 * v1[2] + w2 * v2[2]) * invArea;
+			float*		row		= &depths[py * _width];
+
+			for (int px = minX; px <= maxX; ++px)
+			{
+				const bool inside = w0 >= e0 && w1 >= e1 && w2 >= e2;
+
+				row[px] = inside && depth < row[px] ? std::max(depth, 0.f) : row[px];
+
+				w0		+= a0;
+				w1		+= a1;
+				w2		+= a2;
+				depth	+= dDepthX;
+			}
+		}
+	}
+}
+
+void
+OcclusionBuffer::buildHierarchy()
+{
+	for (uint level = 1; level < _levels.size(); ++level)
+	{
+		const auto&	finer		= _levels[level - 1];
+		auto&		coarser		= _levels[level];
+		const uint	finerWidth	= levelWidth(level - 1);
+		const uint	finerHeight	= levelHeight(level - 1);
+		const uint	width		= levelWidth(level);
+		const uint	height		= levelHeight(level);
+
+		for (uint y = 0; y < height; ++y)
+		{
+			// the last texel also covers the remainder of odd sizes
+			const uint y0 = std::min(y * 2, finerHeight - 1);
+			const uint y1 = y == height - 1 ? finerHeight - 1 : y * 2 + 1;
+
+			for (uint x = 0; x < width; ++x)
+			{
+				const uint	x0		= std::min(x * 2, finerWidth - 1);
+				const uint	x1		= x == width - 1 ? finerWidth - 1 : x * 2 + 1;
+				float		depth	= 0.f;
+
+				for (uint fy = y0; fy <= y1; ++fy)
+					for (uint fx = x0; fx <= x1; ++fx)
+						depth = std::max(depth, finer[fy * finerWidth + fx]);
+
+				coarser[y * width + x] = depth;
+			}
+		}
+	}
+}
+
+bool
+OcclusionBuffer::occluded(float minX, float minY, float maxX, float maxY, float minDepth) const
+{
+	if (maxX < -1.f || maxY < -1.f || minX > 1.f || minY > 1.f)
+		return false;
+
+	int x0 = std::max(0, std::min((int)_width - 1, (int)floorf((minX * .5f + .5f) * _width)));
+	int x1 = std::max(0, std::min((int)_width - 1, (int)floorf((maxX * .5f + .5f) * _width)));
+	int y0 = std::max(0, std::min((int)_height - 1, (int)floorf((minY * .5f + .5f) * _height)));
+	int y1 = std::max(0, std::min((int)_height - 1, (int)floorf((maxY * .5f + .5f) * _height)));
+
+	uint level = 0;
+
+	while (level + 1 < _levels.size() && (uint)std::max(x1 - x0, y1 - y0) >= MAX_TEST_SPAN)
+	{
+		++level;
+		x0 = std::min(x0 >> 1, (int)levelWidth(level) - 1);
+		x1 = std::min(x1 >> 1, (int)levelWidth(level) - 1);
+		y0 = std::min(y0 >> 1, (int)levelHeight(level) - 1);
+		y1 = std::min(y1 >> 1, (int)levelHeight(level) - 1);
+	}
+
+	for (int y = y0; y <= y1; ++y)
+		for (int x = x0; x <= x1; ++x)
+			if (depth(x, y, level) >= minDepth)
+				return false;
+
+	return true;
+}
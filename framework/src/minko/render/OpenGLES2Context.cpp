@@ -54,6 +54,39 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 # include <GL/glu.h>
 #endif
 
+// compressed texture formats from GL_EXT_texture_compression_s3tc, GL_OES_compressed_ETC1_RGB8_texture
+// and GL_IMG_texture_compression_pvrtc
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+# define GL_COMPRESSED_RGB_S3TC_DXT1_EXT		0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+# define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT	0x83F3
+#endif
+#ifndef GL_ETC1_RGB8_OES
+# define GL_ETC1_RGB8_OES					0x8D64
+#endif
+#ifndef GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG
+# define GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG	0x8C00
+#endif
+#ifndef GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG
+# define GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG	0x8C02
+#endif
+
+// pixel buffer objects, from OpenGL 2.1 and OpenGL ES 3.0: whether they can be used is only known
+// once the context exists, but reading them back needs one of the mapping functions to be declared
+#ifndef GL_PIXEL_PACK_BUFFER
+# define GL_PIXEL_PACK_BUFFER				0x88EB
+#endif
+#ifndef GL_STREAM_READ
+# define GL_STREAM_READ						0x88E1
+#endif
+#if defined(GL_VERSION_3_0) || defined(GL_ES_VERSION_3_0)
+# define MINKO_GL_MAP_BUFFER_RANGE
+#endif
+#if defined(GL_VERSION_1_5) && !defined(GL_ES_VERSION_2_0)
+# define MINKO_GL_MAP_BUFFER
+#endif
+
 using namespace minko;
 using namespace minko::render;
 
@@ -120,6 +153,21 @@ OpenGLES2Context::initializeStencilOperationsMap()
 	return m;
 }
 
+OpenGLES2Context::TextureFormatMap OpenGLES2Context::_compressedTextureFormats = OpenGLES2Context::initializeCompressedTextureFormatsMap();
+OpenGLES2Context::TextureFormatMap
+OpenGLES2Context::initializeCompressedTextureFormatsMap()
+{
+	TextureFormatMap m;
+
+	m[TextureFormat::RGB_DXT1]			= GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	m[TextureFormat::RGBA_DXT5]			= GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	m[TextureFormat::RGB_ETC1]			= GL_ETC1_RGB8_OES;
+	m[TextureFormat::RGB_PVRTC1_4BPP]	= GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG;
+	m[TextureFormat::RGBA_PVRTC1_4BPP]	= GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG;
+
+	return m;
+}
+
 OpenGLES2Context::OpenGLES2Context() :
 	_errorsEnabled(false),
 	_textures(),
@@ -151,7 +199,11 @@ OpenGLES2Context::OpenGLES2Context() :
 	_currentStencilMask(0x1),
 	_currentStencilFailOp(StencilOperation::UNSET),
 	_currentStencilZFailOp(StencilOperation::UNSET),
-	_currentStencilZPassOp(StencilOperation::UNSET)
+	_currentStencilZPassOp(StencilOperation::UNSET),
+	_nextPixelsRequest(0),
+	_supportsPixelBuffers(false),
+	_supportsMapBufferRange(false),
+	_freePixelBuffers()
 {
 #if defined _WIN32 && !defined MINKO_ANGLE
 	glewInit();
@@ -174,6 +226,9 @@ OpenGLES2Context::OpenGLES2Context() :
 		+ " " + std::string(glRenderer ? glRenderer : "(unknown renderer)")
 		+ " " + std::string(glVersion ? glVersion : "(unknown version)");
 
+	initializeSupportedTextureFormats();
+	initializePixelBuffersSupport();
+
 	// init. viewport x, y, width and height
 	std::vector<int> viewportSettings(4);
 	glGetIntegerv(GL_VIEWPORT, &viewportSettings[0]);
@@ -187,6 +242,88 @@ OpenGLES2Context::OpenGLES2Context() :
 	setStencilTest(CompareMode::ALWAYS, 0, 0x1, StencilOperation::KEEP, StencilOperation::KEEP, StencilOperation::KEEP);
 }
 
+void
+OpenGLES2Context::initializeSupportedTextureFormats()
+{
+	_supportedTextureFormats.insert(TextureFormat::RGB);
+	_supportedTextureFormats.insert(TextureFormat::RGBA);
+
+	const char* glExtensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+
+	if (!glExtensions)
+		return;
+
+	std::stringstream	extensions(glExtensions);
+	std::string			extension;
+
+	while (extensions >> extension)
+	{
+		if (extension == "GL_EXT_texture_compression_s3tc"
+			|| extension == "GL_WEBGL_compressed_texture_s3tc"
+			|| extension == "WEBGL_compressed_texture_s3tc")
+		{
+			_supportedTextureFormats.insert(TextureFormat::RGB_DXT1);
+			_supportedTextureFormats.insert(TextureFormat::RGBA_DXT5);
+		}
+		else if (extension == "GL_OES_compressed_ETC1_RGB8_texture"
+			|| extension == "WEBGL_compressed_texture_etc1")
+			_supportedTextureFormats.insert(TextureFormat::RGB_ETC1);
+		else if (extension == "GL_IMG_texture_compression_pvrtc"
+			|| extension == "WEBGL_compressed_texture_pvrtc")
+		{
+			_supportedTextureFormats.insert(TextureFormat::RGB_PVRTC1_4BPP);
+			_supportedTextureFormats.insert(TextureFormat::RGBA_PVRTC1_4BPP);
+		}
+	}
+}
+
+void
+OpenGLES2Context::initializePixelBuffersSupport()
+{
+	const char* glVersion		= reinterpret_cast<const char*>(glGetString(GL_VERSION));
+	const char* glExtensions	= reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+	const auto	version			= std::string(glVersion ? glVersion : "");
+	const auto	extensions		= " " + std::string(glExtensions ? glExtensions : "") + " ";
+
+	// "4.5.0 NVIDIA ...", "OpenGL ES 3.0 ..." or "WebGL 2.0 ..."
+	const bool	es		= version.find("OpenGL ES") == 0;
+	const bool	webGL	= version.find("WebGL") != std::string::npos;
+	const auto	digit	= version.find_first_of("0123456789");
+	int			major	= 0;
+	int			minor	= 0;
+
+	if (digit != std::string::npos)
+		std::sscanf(version.c_str() + digit, "%d.%d", &major, &minor);
+
+	const int	glVersionNumber	= major * 10 + minor;
+	bool		pixelBuffers	= false;
+	bool		mapBufferRange	= false;
+	bool		mapBuffer		= false;
+
+	// WebGL cannot map buffers at all: reads stay synchronous
+	if (es && !webGL)
+	{
+		pixelBuffers	= glVersionNumber >= 30;
+		mapBufferRange	= glVersionNumber >= 30;
+	}
+	else if (!es && !webGL)
+	{
+		pixelBuffers	= glVersionNumber >= 21 || extensions.find(" GL_ARB_pixel_buffer_object ") != std::string::npos;
+		mapBufferRange	= glVersionNumber >= 30 || extensions.find(" GL_ARB_map_buffer_range ") != std::string::npos;
+		mapBuffer		= true;
+	}
+
+#ifndef MINKO_GL_MAP_BUFFER_RANGE
+	mapBufferRange = false;
+#endif
+#ifndef MINKO_GL_MAP_BUFFER
+	mapBuffer = false;
+#endif
+
+	_supportsMapBufferRange = mapBufferRange;
+	_supportsPixelBuffers	= pixelBuffers && (mapBufferRange || mapBuffer);
+}
+
 OpenGLES2Context::~OpenGLES2Context()
 {
 	for (auto& vertexBuffer : _vertexBuffers)
@@ -206,6 +343,13 @@ OpenGLES2Context::~OpenGLES2Context()
 
 	for (auto& fragmentShader : _fragmentShaders)
 		glDeleteShader(fragmentShader);
+
+	for (auto& request : _pixelsRequests)
+		if (request.second.pixelBuffer.buffer != 0)
+			glDeleteBuffers(1, &request.second.pixelBuffer.buffer);
+
+	for (auto& pixelBuffer : _freePixelBuffers)
+		glDeleteBuffers(1, &pixelBuffer.buffer);
 }
 
 void
@@ -502,54 +646,7 @@ OpenGLES2Context::createTexture(TextureType	type,
 								bool		mipMapping,
 								bool        optimizeForRenderToTexture)
 {
-	uint texture;
-
-	// make sure width is a power of 2
-	if (!((width != 0) && !(width & (width - 1))))
-		throw std::invalid_argument("width");
-
-	// make sure height is a power of 2
-	if (!((height != 0) && !(height & (height - 1))))
-		throw std::invalid_argument("height");
-
-	// http://www.opengl.org/sdk/docs/man/xhtml/glGenTextures.xml
-	//
-	// void glGenTextures(GLsizei n, GLuint* textures)
-	// n Specifies the number of texture names to be generated.
-	// textures Specifies an array in which the generated texture names are stored.
-	//
-	// glGenTextures generate texture names
-	glGenTextures(1, &texture);
-
-	// http://www.opengl.org/sdk/docs/man/xhtml/glBindTexture.xml
-	//
-	// void glBindTexture(GLenum target, GLuint texture);
-	// target Specifies the target to which the texture is bound.
-	// texture Specifies the name of a texture.
-	//
-	// glBindTexture bind a named texture to a texturing target
-	const auto glTarget = type == TextureType::Texture2D 
-		? GL_TEXTURE_2D 
-		: GL_TEXTURE_CUBE_MAP;
-
-	glBindTexture(glTarget, texture);
-
-	_currentBoundTexture = texture;
-
-	// default sampler states
-	glTexParameteri(glTarget, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(glTarget, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(glTarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(glTarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-	_textures.push_back(texture);
-	_textureSizes[texture]			= std::make_pair(width, height);
-	_textureHasMipmaps[texture]		= mipMapping;
-	_textureTypes[texture]			= type;
-
-	_currentWrapMode[texture]		= WrapMode::CLAMP;
-	_currentTextureFilter[texture]	= TextureFilter::NEAREST;
-	_currentMipFilter[texture]		= MipFilter::NONE;
+	const auto texture = generateTexture(type, width, height, mipMapping);
 
 	// http://www.opengl.org/sdk/docs/man/xhtml/glTexImage2D.xml
 	//
@@ -617,6 +714,115 @@ OpenGLES2Context::createTexture(TextureType	type,
 	return texture;
 }
 
+uint
+OpenGLES2Context::generateTexture(TextureType	type,
+								  uint			width,
+								  uint			height,
+								  bool			mipMapping)
+{
+	uint texture;
+
+	// make sure width is a power of 2
+	if (!((width != 0) && !(width & (width - 1))))
+		throw std::invalid_argument("width");
+
+	// make sure height is a power of 2
+	if (!((height != 0) && !(height & (height - 1))))
+		throw std::invalid_argument("height");
+
+	// http://www.opengl.org/sdk/docs/man/xhtml/glGenTextures.xml
+	//
+	// void glGenTextures(GLsizei n, GLuint* textures)
+	// n Specifies the number of texture names to be generated.
+	// textures Specifies an array in which the generated texture names are stored.
+	//
+	// glGenTextures generate texture names
+	glGenTextures(1, &texture);
+
+	// http://www.opengl.org/sdk/docs/man/xhtml/glBindTexture.xml
+	//
+	// void glBindTexture(GLenum target, GLuint texture);
+	// target Specifies the target to which the texture is bound.
+	// texture Specifies the name of a texture.
+	//
+	// glBindTexture bind a named texture to a texturing target
+	const auto glTarget = type == TextureType::Texture2D 
+		? GL_TEXTURE_2D 
+		: GL_TEXTURE_CUBE_MAP;
+
+	glBindTexture(glTarget, texture);
+
+	_currentBoundTexture = texture;
+
+	// default sampler states
+	glTexParameteri(glTarget, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(glTarget, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(glTarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(glTarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	_textures.push_back(texture);
+	_textureSizes[texture]			= std::make_pair(width, height);
+	_textureHasMipmaps[texture]		= mipMapping;
+	_textureTypes[texture]			= type;
+
+	_currentWrapMode[texture]		= WrapMode::CLAMP;
+	_currentTextureFilter[texture]	= TextureFilter::NEAREST;
+	_currentMipFilter[texture]		= MipFilter::NONE;
+
+	return texture;
+}
+
+bool
+OpenGLES2Context::supportsTextureFormat(TextureFormat format) const
+{
+	return _supportedTextureFormats.count(format) != 0;
+}
+
+uint
+OpenGLES2Context::createCompressedTexture(TextureType	type,
+										  TextureFormat	format,
+										  uint			width,
+										  uint			height,
+										  bool			mipMapping)
+{
+	if (type != TextureType::Texture2D)
+		throw std::invalid_argument("type");
+	if (!supportsTextureFormat(format) || !_compressedTextureFormats.count(format))
+		throw std::invalid_argument("format");
+
+	// the storage of each level is specified by uploadCompressedTexture2dData():
+	// unlike glTexImage2D, glCompressedTexImage2D does not accept a null data pointer
+	const auto texture = generateTexture(type, width, height, mipMapping);
+
+	checkForErrors();
+
+	return texture;
+}
+
+void
+OpenGLES2Context::uploadCompressedTexture2dData(uint			texture,
+												TextureFormat	format,
+												uint			width,
+												uint			height,
+												uint			size,
+												uint			mipLevel,
+												void*			data)
+{
+	assert(getTextureType(texture) == TextureType::Texture2D);
+
+	const auto formatIt = _compressedTextureFormats.find(format);
+
+	if (formatIt == _compressedTextureFormats.end())
+		throw std::invalid_argument("format");
+
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glCompressedTexImage2D(GL_TEXTURE_2D, mipLevel, formatIt->second, width, height, 0, size, data);
+
+	_currentBoundTexture = texture;
+
+	checkForErrors();
+}
+
 TextureType
 OpenGLES2Context::getTextureType(uint textureId) const
 {
@@ -1488,6 +1694,112 @@ OpenGLES2Context::readPixels(unsigned int x, unsigned int y, unsigned int width,
 	checkForErrors();
 }
 
+uint
+OpenGLES2Context::beginReadPixels(unsigned int x, unsigned int y, unsigned int width, unsigned int height)
+{
+	auto requestId = _nextPixelsRequest++;
+	auto& request = _pixelsRequests[requestId];
+
+	request.size = width * height * 4;
+
+	if (_supportsPixelBuffers)
+	{
+		// the copy goes to a pixel buffer object and is only waited for by endReadPixels()
+		request.pixelBuffer = acquirePixelBuffer(request.size);
+		glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+	else
+	{
+		request.pixelBuffer.buffer = 0;
+		request.pixelBuffer.size = 0;
+		request.pixels.resize(request.size);
+		glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &request.pixels[0]);
+	}
+
+	checkForErrors();
+
+	return requestId;
+}
+
+OpenGLES2Context::PixelBuffer
+OpenGLES2Context::acquirePixelBuffer(uint size)
+{
+	// buffers go back to the pool once read: picking keeps reusing the same few ones
+	auto pixelBufferIt = std::find_if(_freePixelBuffers.begin(), _freePixelBuffers.end(), [&](const PixelBuffer& pixelBuffer)
+	{
+		return pixelBuffer.size >= size;
+	});
+
+	if (pixelBufferIt == _freePixelBuffers.end() && !_freePixelBuffers.empty())
+		pixelBufferIt = _freePixelBuffers.begin();
+
+	PixelBuffer pixelBuffer = { 0, 0 };
+
+	if (pixelBufferIt != _freePixelBuffers.end())
+	{
+		pixelBuffer = *pixelBufferIt;
+		_freePixelBuffers.erase(pixelBufferIt);
+	}
+	else
+		glGenBuffers(1, &pixelBuffer.buffer);
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer.buffer);
+
+	if (pixelBuffer.size < size)
+	{
+		glBufferData(GL_PIXEL_PACK_BUFFER, size, 0, GL_STREAM_READ);
+		pixelBuffer.size = size;
+	}
+
+	return pixelBuffer;
+}
+
+void
+OpenGLES2Context::endReadPixels(uint requestId, unsigned char* pixels)
+{
+	auto requestIt = _pixelsRequests.find(requestId);
+
+	if (requestIt == _pixelsRequests.end())
+		throw std::invalid_argument("request");
+
+	auto& request = requestIt->second;
+
+	if (request.pixelBuffer.buffer != 0)
+	{
+		void* data = nullptr;
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, request.pixelBuffer.buffer);
+
+#ifdef MINKO_GL_MAP_BUFFER_RANGE
+		// OpenGL ES 3.0 has no glMapBuffer()
+		if (_supportsMapBufferRange)
+			data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, request.size, GL_MAP_READ_BIT);
+#endif
+#ifdef MINKO_GL_MAP_BUFFER
+		if (!_supportsMapBufferRange)
+			data = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+#endif
+
+#if defined(MINKO_GL_MAP_BUFFER_RANGE) || defined(MINKO_GL_MAP_BUFFER)
+		if (data)
+		{
+			std::memcpy(pixels, data, request.size);
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+#endif
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		_freePixelBuffers.push_back(request.pixelBuffer);
+	}
+	else
+		std::memcpy(pixels, &request.pixels[0], request.size);
+
+	_pixelsRequests.erase(requestIt);
+
+	checkForErrors();
+}
+
 void
 OpenGLES2Context::setScissorTest(bool						scissorTest, 
 								 const render::ScissorBox&	scissorBox)
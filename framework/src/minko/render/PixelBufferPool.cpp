@@ -0,0 +1,122 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/render/PixelBufferPool.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+/*static*/ const std::size_t						PixelBufferPool::DEFAULT_MAX_SIZE	= 64 * 1024 * 1024;
+/*static*/ std::mutex								PixelBufferPool::_mutex;
+/*static*/ std::list<std::vector<unsigned char>>	PixelBufferPool::_buffers;
+/*static*/ std::size_t								PixelBufferPool::_size				= 0;
+/*static*/ std::size_t								PixelBufferPool::_maxSize			= PixelBufferPool::DEFAULT_MAX_SIZE;
+
+std::vector<unsigned char>
+PixelBufferPool::acquire(std::size_t size)
+{
+	std::vector<unsigned char> buffer;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		auto bestIt = _buffers.end();
+
+		for (auto it = _buffers.begin(); it != _buffers.end(); ++it)
+			if (it->capacity() >= size && (bestIt == _buffers.end() || it->capacity() < bestIt->capacity()))
+				bestIt = it;
+
+		if (bestIt != _buffers.end())
+		{
+			_size -= bestIt->capacity();
+			buffer.swap(*bestIt);
+			_buffers.erase(bestIt);
+		}
+	}
+
+	buffer.resize(size);
+
+	return buffer;
+}
+
+void
+PixelBufferPool::release(std::vector<unsigned char>& buffer)
+{
+	std::vector<unsigned char> storage;
+
+	storage.swap(buffer);
+
+	const auto capacity = storage.capacity();
+
+	if (capacity == 0)
+		return;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (_size + capacity > _maxSize)
+		return;
+
+	storage.clear();
+	_size += capacity;
+	_buffers.push_back(std::move(storage));
+}
+
+void
+PixelBufferPool::clear()
+{
+	std::list<std::vector<unsigned char>> buffers;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		buffers.swap(_buffers);
+		_size = 0;
+	}
+}
+
+std::size_t
+PixelBufferPool::size()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	return _size;
+}
+
+std::size_t
+PixelBufferPool::maxSize()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	return _maxSize;
+}
+
+void
+PixelBufferPool::maxSize(std::size_t value)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_maxSize = value;
+
+	while (_size > _maxSize && !_buffers.empty())
+	{
+		_size -= _buffers.front().capacity();
+		_buffers.pop_front();
+	}
+}
@@ -0,0 +1,342 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include "minko/render/RenderGraph.hpp"
+
+#include "minko/render/RenderTargetPool.hpp"
+#include "minko/render/Texture.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+RenderGraph::RenderGraph(RenderTargetPoolPtr pool) :
+	_pool(pool),
+	_targets(),
+	_passes(),
+	_outputs(),
+	_compiled(false),
+	_physicalTargets()
+{
+}
+
+RenderGraph::Ptr
+RenderGraph::addTarget(const std::string& name, uint width, uint height)
+{
+	if (width == 0 || height == 0)
+		throw std::invalid_argument("A render target must have a strictly positive size.");
+	if (_targets.count(name) != 0 && _targets[name].imported)
+		throw std::logic_error("The target '" + name + "' is already imported.");
+
+	auto& target = _targets[name];
+
+	target.width		= width;
+	target.height		= height;
+	target.imported		= false;
+	target.texture		= nullptr;
+	_compiled			= false;
+
+	return shared_from_this();
+}
+
+RenderGraph::Ptr
+RenderGraph::importTarget(const std::string& name, AbsTexturePtr texture)
+{
+	if (_targets.count(name) != 0 && !_targets[name].imported)
+		throw std::logic_error("The target '" + name + "' is already a transient target.");
+
+	auto& target = _targets[name];
+
+	target.width		= texture ? texture->width() : 0;
+	target.height		= texture ? texture->height() : 0;
+	target.imported		= true;
+	target.texture		= texture;
+	_compiled			= false;
+
+	return shared_from_this();
+}
+
+RenderGraph::Ptr
+RenderGraph::addPass(const std::string&					name,
+					 const std::vector<std::string>&	inputs,
+					 const std::vector<std::string>&	outputs,
+					 PassFunction						function)
+{
+	Pass pass;
+
+	pass.name		= name;
+	pass.inputs		= inputs;
+	pass.outputs	= outputs;
+	pass.function	= function;
+	pass.culled		= false;
+
+	_passes.push_back(pass);
+	_compiled = false;
+
+	return shared_from_this();
+}
+
+RenderGraph::Ptr
+RenderGraph::output(const std::string& name)
+{
+	_outputs.insert(name);
+	_compiled = false;
+
+	return shared_from_this();
+}
+
+RenderGraph::Target&
+RenderGraph::getTarget(const std::string& name)
+{
+	auto targetIt = _targets.find(name);
+
+	if (targetIt == _targets.end())
+		throw std::logic_error("The target '" + name + "' does not exist.");
+
+	return targetIt->second;
+}
+
+void
+RenderGraph::compile()
+{
+	std::set<std::string> written;
+
+	for (auto& pass : _passes)
+	{
+		for (auto& input : pass.inputs)
+			if (!getTarget(input).imported && written.count(input) == 0)
+				throw std::logic_error("The pass '" + pass.name + "' reads '" + input + "' before it is written.");
+		for (auto& output : pass.outputs)
+			if (!getTarget(output).imported)
+				written.insert(output);
+	}
+
+	// culling: walk the passes backward from the outputs of the graph
+	std::set<std::string> needed(_outputs);
+
+	for (auto& output : _outputs)
+		getTarget(output);
+
+	for (auto passIt = _passes.rbegin(); passIt != _passes.rend(); ++passIt)
+	{
+		passIt->culled = true;
+		for (auto& output : passIt->outputs)
+			if (needed.count(output) != 0)
+				passIt->culled = false;
+
+		if (!passIt->culled)
+			needed.insert(passIt->inputs.begin(), passIt->inputs.end());
+	}
+
+	// lifetimes
+	for (auto& nameAndTarget : _targets)
+	{
+		nameAndTarget.second.firstPass		= -1;
+		nameAndTarget.second.lastPass		= -1;
+		nameAndTarget.second.physicalTarget	= -1;
+	}
+
+	for (uint passId = 0; passId < _passes.size(); ++passId)
+	{
+		auto& pass = _passes[passId];
+
+		if (pass.culled)
+			continue;
+
+		for (auto names : { &pass.inputs, &pass.outputs })
+			for (auto& name : *names)
+			{
+				auto& target = getTarget(name);
+
+				if (target.firstPass < 0)
+					target.firstPass = passId;
+				target.lastPass = passId;
+			}
+	}
+
+	for (auto& output : _outputs)
+		if (_targets[output].firstPass >= 0)
+			_targets[output].lastPass = _passes.size();
+
+	// aliasing: targets of the same GPU size share a texture once the previous one is dead
+	std::vector<std::string>	targetNames;
+	std::vector<bool>			physicalTargetUsed;
+
+	for (auto& nameAndTarget : _targets)
+		if (!nameAndTarget.second.imported && nameAndTarget.second.firstPass >= 0)
+			targetNames.push_back(nameAndTarget.first);
+
+	std::sort(targetNames.begin(), targetNames.end(), [&](const std::string& a, const std::string& b)
+	{
+		return _targets[a].firstPass < _targets[b].firstPass
+			|| (_targets[a].firstPass == _targets[b].firstPass && a < b);
+	});
+
+	_physicalTargets.clear();
+	for (auto& name : targetNames)
+	{
+		auto&		target	= _targets[name];
+		const uint	width	= math::clp2(target.width);
+		const uint	height	= math::clp2(target.height);
+
+		for (uint physicalTargetId = 0; physicalTargetId < _physicalTargets.size(); ++physicalTargetId)
+		{
+			auto& physicalTarget = _physicalTargets[physicalTargetId];
+
+			if (physicalTarget.width != width || physicalTarget.height != height)
+				continue;
+
+			bool free = true;
+
+			for (auto& otherName : targetNames)
+			{
+				auto& other = _targets[otherName];
+
+				if (other.physicalTarget == (int)physicalTargetId
+					&& other.firstPass <= target.lastPass && target.firstPass <= other.lastPass)
+				{
+					free = false;
+					break;
+				}
+			}
+
+			if (free)
+			{
+				target.physicalTarget = physicalTargetId;
+				break;
+			}
+		}
+
+		if (target.physicalTarget < 0)
+		{
+			PhysicalTarget physicalTarget;
+
+			physicalTarget.width	= width;
+			physicalTarget.height	= height;
+			target.physicalTarget	= _physicalTargets.size();
+			_physicalTargets.push_back(physicalTarget);
+		}
+	}
+
+	_compiled = true;
+}
+
+void
+RenderGraph::execute()
+{
+	if (!_compiled)
+		compile();
+
+	for (auto& physicalTarget : _physicalTargets)
+		physicalTarget.texture = _pool->acquire(physicalTarget.width, physicalTarget.height);
+
+	for (auto& nameAndTarget : _targets)
+		if (!nameAndTarget.second.imported)
+			nameAndTarget.second.texture = nameAndTarget.second.physicalTarget >= 0
+				? _physicalTargets[nameAndTarget.second.physicalTarget].texture
+				: nullptr;
+
+	auto that = shared_from_this();
+
+	for (auto& pass : _passes)
+		if (!pass.culled)
+			pass.function(that);
+
+	for (auto& nameAndTarget : _targets)
+		if (!nameAndTarget.second.imported)
+			nameAndTarget.second.texture = nullptr;
+
+	for (auto& physicalTarget : _physicalTargets)
+	{
+		_pool->release(std::static_pointer_cast<Texture>(physicalTarget.texture));
+		physicalTarget.texture = nullptr;
+	}
+}
+
+RenderGraph::AbsTexturePtr
+RenderGraph::target(const std::string& name) const
+{
+	auto targetIt = _targets.find(name);
+
+	if (targetIt == _targets.end())
+		throw std::logic_error("The target '" + name + "' does not exist.");
+
+	return targetIt->second.texture;
+}
+
+uint
+RenderGraph::numCulledPasses()
+{
+	if (!_compiled)
+		compile();
+
+	return std::count_if(_passes.begin(), _passes.end(), [](const Pass& pass) { return pass.culled; });
+}
+
+bool
+RenderGraph::culled(const std::string& passName)
+{
+	if (!_compiled)
+		compile();
+
+	for (auto& pass : _passes)
+		if (pass.name == passName)
+			return pass.culled;
+
+	throw std::logic_error("The pass '" + passName + "' does not exist.");
+}
+
+uint
+RenderGraph::numPhysicalTargets()
+{
+	if (!_compiled)
+		compile();
+
+	return _physicalTargets.size();
+}
+
+uint
+RenderGraph::transientMemory()
+{
+	if (!_compiled)
+		compile();
+
+	uint memory = 0;
+
+	for (auto& physicalTarget : _physicalTargets)
+		memory += RenderTargetPool::memory(physicalTarget.width, physicalTarget.height);
+
+	return memory;
+}
+
+uint
+RenderGraph::unaliasedMemory()
+{
+	if (!_compiled)
+		compile();
+
+	uint memory = 0;
+
+	for (auto& nameAndTarget : _targets)
+		if (!nameAndTarget.second.imported && nameAndTarget.second.firstPass >= 0)
+			memory += RenderTargetPool::memory(nameAndTarget.second.width, nameAndTarget.second.height);
+
+	return memory;
+}
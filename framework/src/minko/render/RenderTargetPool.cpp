@@ -0,0 +1,155 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include "minko/render/RenderTargetPool.hpp"
+
+#include "minko/render/Texture.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+RenderTargetPool::RenderTargetPool(AbstractContextPtr context) :
+	_context(context),
+	_entries(),
+	_frame(0)
+{
+}
+
+RenderTargetPool::TexturePtr
+RenderTargetPool::acquire(uint width, uint height)
+{
+	if (width == 0 || height == 0)
+		throw std::invalid_argument("A render target must have a strictly positive size.");
+
+	auto& entries = _entries[std::pair<uint, uint>(math::clp2(width), math::clp2(height))];
+
+	for (auto& entry : entries)
+		if (!entry.used)
+		{
+			entry.used			= true;
+			entry.lastUsedFrame	= _frame;
+
+			return entry.texture;
+		}
+
+	Entry entry;
+
+	entry.texture		= Texture::create(_context, math::clp2(width), math::clp2(height), false, true);
+	entry.used			= true;
+	entry.lastUsedFrame	= _frame;
+
+	entry.texture->upload();
+	entries.push_back(entry);
+
+	return entry.texture;
+}
+
+void
+RenderTargetPool::release(TexturePtr texture)
+{
+	for (auto& sizeAndEntries : _entries)
+		for (auto& entry : sizeAndEntries.second)
+			if (entry.texture == texture)
+			{
+				entry.used = false;
+
+				return;
+			}
+
+	throw std::invalid_argument("texture");
+}
+
+void
+RenderTargetPool::collect(uint maxUnusedFrames)
+{
+	for (auto entriesIt = _entries.begin(); entriesIt != _entries.end();)
+	{
+		auto& entries = entriesIt->second;
+
+		for (auto entryIt = entries.begin(); entryIt != entries.end();)
+			if (!entryIt->used && _frame - entryIt->lastUsedFrame >= maxUnusedFrames)
+			{
+				entryIt->texture->dispose();
+				entryIt = entries.erase(entryIt);
+			}
+			else
+				++entryIt;
+
+		if (entries.empty())
+			entriesIt = _entries.erase(entriesIt);
+		else
+			++entriesIt;
+	}
+
+	++_frame;
+}
+
+void
+RenderTargetPool::clear()
+{
+	for (auto& sizeAndEntries : _entries)
+		for (auto& entry : sizeAndEntries.second)
+			entry.texture->dispose();
+
+	_entries.clear();
+}
+
+uint
+RenderTargetPool::numTextures() const
+{
+	uint numTextures = 0;
+
+	for (auto& sizeAndEntries : _entries)
+		numTextures += sizeAndEntries.second.size();
+
+	return numTextures;
+}
+
+uint
+RenderTargetPool::numFreeTextures() const
+{
+	uint numFreeTextures = 0;
+
+	for (auto& sizeAndEntries : _entries)
+		for (auto& entry : sizeAndEntries.second)
+			if (!entry.used)
+				++numFreeTextures;
+
+	return numFreeTextures;
+}
+
+uint
+RenderTargetPool::memory() const
+{
+	uint memory = 0;
+
+	for (auto& sizeAndEntries : _entries)
+		memory += sizeAndEntries.second.size() * RenderTargetPool::memory(sizeAndEntries.first.first, sizeAndEntries.first.second);
+
+	return memory;
+}
+
+/*static*/
+uint
+RenderTargetPool::memory(uint width, uint height)
+{
+	return math::clp2(width) * math::clp2(height) * (4 + 4);
+}
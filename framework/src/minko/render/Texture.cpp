@@ -20,10 +20,14 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/render/Texture.hpp"
 
 #include "minko/render/AbstractContext.hpp"
+#include "minko/render/TextureCompression.hpp"
+#include "minko/render/PixelBufferPool.hpp"
 
 using namespace minko;
 using namespace minko::render;
 
+/*static*/ const uint Texture::STREAMING_MIN_SIZE = 32;
+
 Texture::Texture(AbstractContext::Ptr	context,
 				 uint					width,
 				 uint					height,
@@ -32,8 +36,15 @@ Texture::Texture(AbstractContext::Ptr	context,
 				 bool					resizeSmoothly,
 				 const std::string&		filename) :
 	AbstractTexture(TextureType::Texture2D, context, width, height, mipMapping, optimizeForRenderToTexture, resizeSmoothly, filename),
-	_data()
+	_data(),
+	_format(TextureFormat::RGBA),
+	_compressedData(),
+	_streamed(false),
+	_residentMipLevel(0),
+	_mipData(),
+	_dataSource()
 {
+	_residentMipLevel = numMipLevels();
 }
 
 void
@@ -61,7 +72,10 @@ Texture::data(unsigned char*	data,
 
 	const auto size = _width * _height * sizeof(int);
 
-	std::vector<unsigned char> rgba(size, 0);
+	if (format != TextureFormat::RGBA && format != TextureFormat::RGB)
+		throw std::invalid_argument("format");
+
+	auto rgba = PixelBufferPool::acquire(size);
 	
 	if (format == TextureFormat::RGBA)
 	{
@@ -78,13 +92,117 @@ Texture::data(unsigned char*	data,
 		}
 	}
 
+	this->data(std::move(rgba));
+}
+
+void
+Texture::data(std::vector<unsigned char> rgba)
+{
+	const auto size = _width * _height * sizeof(int);
+
 	assert(math::isp2(_widthGPU) && math::isp2(_heightGPU));
-	resizeData(_width, _height, rgba, _widthGPU, _heightGPU, _resizeSmoothly, _data);
+
+	// previous data, if any, or the resized source end up in rgba and are recycled
+	if (rgba.size() == _widthGPU * _heightGPU * sizeof(int))
+		_data.swap(rgba);
+	else if (rgba.size() == size)
+	{
+		PixelBufferPool::release(_data);
+		_data = PixelBufferPool::acquire(_widthGPU * _heightGPU * sizeof(int));
+		resizeData(_width, _height, rgba, _widthGPU, _heightGPU, _resizeSmoothly, _data);
+	}
+	else
+		throw std::invalid_argument("rgba");
+
+	PixelBufferPool::release(rgba);
+
+	_mipData.clear();
+	_format = TextureFormat::RGBA;
+	_compressedData.clear();
+}
+
+void
+Texture::mipLevelsData(std::vector<std::vector<unsigned char>> levels)
+{
+	if (levels.empty())
+		throw std::invalid_argument("levels");
+	if (_width != _widthGPU || _height != _heightGPU)
+		throw std::logic_error("Precomputed mip levels cannot be resized: their dimensions must be powers of 2.");
+
+	const uint numLevels = std::min((uint)levels.size(), numMipLevels());
+
+	for (uint level = 0; level < numLevels; ++level)
+		if (levels[level].size() != getMipmapWidth(level) * getMipmapHeight(level) * sizeof(int))
+			throw std::invalid_argument("levels");
+
+	_format = TextureFormat::RGBA;
+	_compressedData.clear();
+	_data.swap(levels[0]);
+	_mipData.clear();
+
+	// an incomplete chain is generated by the GPU, or computed when streaming
+	if (numLevels == numMipLevels())
+		for (uint level = 1; level < numLevels; ++level)
+			_mipData.push_back(std::move(levels[level]));
+}
+
+void
+Texture::compressedData(TextureFormat							format,
+						std::vector<std::vector<unsigned char>>	levels)
+{
+	if (!TextureCompression::isCompressed(format))
+		throw std::invalid_argument("format");
+	if (levels.empty())
+		throw std::invalid_argument("levels");
+	if (_width != _widthGPU || _height != _heightGPU)
+		throw std::logic_error("Compressed textures cannot be resized: their dimensions must be powers of 2.");
+
+	for (uint level = 0; level < levels.size(); ++level)
+		if (levels[level].size() < TextureCompression::dataSize(format, getMipmapWidth(level), getMipmapHeight(level)))
+			throw std::invalid_argument("levels");
+
+	if (!_context->supportsTextureFormat(format))
+	{
+		std::vector<unsigned char> rgba;
+
+		TextureCompression::decompress(format, _widthGPU, _heightGPU, &levels[0].front(), rgba);
+		data(&rgba.front(), TextureFormat::RGBA);
+
+		return;
+	}
+
+	_data.clear();
+	_mipData.clear();
+	_format = format;
+	_compressedData = std::move(levels);
+
+	if (_mipMapping && _compressedData.size() < numMipLevels())
+		_mipMapping = false;
 }
 
 void
 Texture::upload()
 {
+	if (_streamed)
+	{
+		uint level = 0;
+
+		while (level + 1 < numMipLevels()
+			&& std::max(_widthGPU >> level, _heightGPU >> level) > STREAMING_MIN_SIZE)
+			++level;
+
+		uploadMipLevels(level);
+
+		return;
+	}
+
+	if (!_compressedData.empty())
+	{
+		uploadMipLevels(0);
+
+		return;
+	}
+
     if (_id == -1)
     	_id = _context->createTexture(
 			_type,
@@ -104,11 +222,223 @@ Texture::upload()
 			&_data.front()
 		);
 
-        if (_mipMapping)
-            _context->generateMipmaps(_id);
+		if (_mipMapping)
+		{
+			if (_mipData.empty())
+				_context->generateMipmaps(_id);
+			else
+				for (uint level = 1; level < numMipLevels(); ++level)
+					uploadMipLevel(level, &_mipData[level - 1].front());
+		}
+
+		_residentMipLevel = 0;
     }
 }
 
+uint
+Texture::numMipLevels() const
+{
+	return math::getp2(std::max(_widthGPU, _heightGPU)) + 1;
+}
+
+uint
+Texture::mipLevelsMemory(uint baseLevel) const
+{
+	const uint	lastLevel	= _mipMapping ? numMipLevels() : std::min(baseLevel + 1, numMipLevels());
+	uint		size		= 0;
+
+	for (uint level = baseLevel; level < lastLevel; ++level)
+		size += TextureCompression::dataSize(_format, std::max(1u, _widthGPU >> level), std::max(1u, _heightGPU >> level));
+
+	return size;
+}
+
+void
+Texture::uploadMipLevels(uint baseLevel)
+{
+	const bool compressed = !_compressedData.empty();
+
+	baseLevel = std::min(baseLevel, (compressed ? (uint)_compressedData.size() : numMipLevels()) - 1);
+
+	if (!hasMipData(baseLevel))
+		restoreData();
+	if (!hasMipData(baseLevel))
+		return;
+
+	if (!compressed && baseLevel != 0 && _mipData.empty())
+		computeMipData();
+
+	const uint lastLevel = _mipMapping ? numMipLevels() : baseLevel + 1;
+
+	if (_id == -1)
+		_id = compressed
+			? _context->createCompressedTexture(
+				_type,
+				_format,
+				std::max(1u, _widthGPU >> baseLevel),
+				std::max(1u, _heightGPU >> baseLevel),
+				_mipMapping
+			)
+			: _context->createTexture(
+				_type,
+				std::max(1u, _widthGPU >> baseLevel),
+				std::max(1u, _heightGPU >> baseLevel),
+				_mipMapping,
+				_optimizeForRenderToTexture
+			);
+
+	// redefining level 0 with a smaller size lets the driver release the finer levels
+	for (uint level = baseLevel; level < lastLevel; ++level)
+	{
+		const uint width	= std::max(1u, _widthGPU >> level);
+		const uint height	= std::max(1u, _heightGPU >> level);
+
+		if (compressed)
+			_context->uploadCompressedTexture2dData(
+				_id,
+				_format,
+				width,
+				height,
+				TextureCompression::dataSize(_format, width, height),
+				level - baseLevel,
+				&_compressedData[level].front()
+			);
+		else
+			_context->uploadTexture2dData(
+				_id,
+				width,
+				height,
+				level - baseLevel,
+				const_cast<unsigned char*>(mipData(level))
+			);
+	}
+
+	_residentMipLevel = baseLevel;
+}
+
+void
+Texture::computeMipData()
+{
+	const uint numLevels = numMipLevels();
+
+	_mipData.resize(numLevels - 1);
+
+	for (uint level = 1; level < numLevels; ++level)
+	{
+		const unsigned char*	src			= mipData(level - 1);
+		const uint				srcWidth	= std::max(1u, _widthGPU >> (level - 1));
+		const uint				srcHeight	= std::max(1u, _heightGPU >> (level - 1));
+		const uint				width		= std::max(1u, _widthGPU >> level);
+		const uint				height		= std::max(1u, _heightGPU >> level);
+		auto&					dst			= _mipData[level - 1];
+
+		dst.resize(width * height * sizeof(int));
+
+		// 2x2 box filter, clamped when one dimension already reached 1
+		for (uint y = 0; y < height; ++y)
+		{
+			const uint y0 = std::min(2 * y, srcHeight - 1);
+			const uint y1 = std::min(2 * y + 1, srcHeight - 1);
+
+			for (uint x = 0; x < width; ++x)
+			{
+				const uint x0 = std::min(2 * x, srcWidth - 1);
+				const uint x1 = std::min(2 * x + 1, srcWidth - 1);
+
+				for (uint c = 0; c < 4; ++c)
+					dst[(y * width + x) * 4 + c] = (unsigned char)((
+						src[(y0 * srcWidth + x0) * 4 + c] + src[(y0 * srcWidth + x1) * 4 + c] +
+						src[(y1 * srcWidth + x0) * 4 + c] + src[(y1 * srcWidth + x1) * 4 + c] + 2
+					) >> 2);
+			}
+		}
+	}
+}
+
+bool
+Texture::hasMipData(uint level) const
+{
+	if (!_compressedData.empty())
+		return level < _compressedData.size() && !_compressedData[level].empty();
+
+	// the coarser levels can be computed as long as the first one is there
+	return level == 0 || _mipData.empty()
+		? !_data.empty()
+		: level <= _mipData.size() && !_mipData[level - 1].empty();
+}
+
+void
+Texture::restoreData()
+{
+	if (_dataSource)
+		_dataSource(*this);
+}
+
+void
+Texture::disposeResidentData()
+{
+	if (!_dataSource || _residentMipLevel >= numMipLevels())
+		return;
+
+	if (!_compressedData.empty())
+	{
+		for (uint level = 0; level <= _residentMipLevel && level < _compressedData.size(); ++level)
+		{
+			_compressedData[level].clear();
+			_compressedData[level].shrink_to_fit();
+		}
+
+		return;
+	}
+
+	// coarser levels are needed to evict without reloading: compute them while level 0 is there
+	if (_mipData.empty() && !_data.empty() && _residentMipLevel + 1 < numMipLevels())
+		computeMipData();
+
+	PixelBufferPool::release(_data);
+	for (uint level = 1; level <= _residentMipLevel && level <= _mipData.size(); ++level)
+	{
+		_mipData[level - 1].clear();
+		_mipData[level - 1].shrink_to_fit();
+	}
+}
+
+uint
+Texture::dataMemory() const
+{
+	uint size = _data.size();
+
+	for (auto& level : _mipData)
+		size += level.size();
+	for (auto& level : _compressedData)
+		size += level.size();
+
+	return size;
+}
+
+const unsigned char*
+Texture::mipLevelData(uint level)
+{
+	if (level >= numMipLevels())
+		throw std::invalid_argument("level");
+
+	if (!hasMipData(level))
+		restoreData();
+	if (!hasMipData(level) || !_compressedData.empty())
+		throw std::invalid_argument("level");
+
+	if (level != 0 && _mipData.empty())
+		computeMipData();
+
+	return mipData(level);
+}
+
+const unsigned char*
+Texture::mipData(uint level) const
+{
+	return level == 0 ? &_data.front() : &_mipData[level - 1].front();
+}
+
 void
 Texture::uploadMipLevel(uint			level,
 						unsigned char*	data)
@@ -131,6 +461,8 @@ Texture::dispose()
 	    _id = -1;
     }
 
+	_residentMipLevel = numMipLevels();
+
 	disposeData();
 }
 
@@ -139,4 +471,8 @@ Texture::disposeData()
 {
 	_data.clear();
 	_data.shrink_to_fit();
+	_mipData.clear();
+	_mipData.shrink_to_fit();
+	_compressedData.clear();
+	_compressedData.shrink_to_fit();
 }
\ No newline at end of file
@@ -0,0 +1,517 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/render/TextureCompression.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+namespace
+{
+	// ETC1 intensity modifiers (a, b): pixel indices 0 to 3 select +a, +b, -a and -b
+	const int ETC1_MODIFIERS[8][2] = {
+		{ 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+	};
+
+	inline
+	int
+	clampColor(int value)
+	{
+		return value < 0 ? 0 : (value > 255 ? 255 : value);
+	}
+
+	inline
+	int
+	etc1Modifier(uint table, uint index)
+	{
+		const int modifier = ETC1_MODIFIERS[table][index & 1];
+
+		return index & 2 ? -modifier : modifier;
+	}
+
+	inline
+	unsigned short
+	packRGB565(const int* color)
+	{
+		return (unsigned short)(((color[0] * 31 + 127) / 255) << 11 | ((color[1] * 63 + 127) / 255) << 5 | ((color[2] * 31 + 127) / 255));
+	}
+
+	inline
+	void
+	unpackRGB565(unsigned short value, int* color)
+	{
+		const int r = (value >> 11) & 31;
+		const int g = (value >> 5) & 63;
+		const int b = value & 31;
+
+		color[0] = (r << 3) | (r >> 2);
+		color[1] = (g << 2) | (g >> 4);
+		color[2] = (b << 3) | (b >> 2);
+	}
+
+	inline
+	int
+	colorDistance(const unsigned char* pixel, const int* color)
+	{
+		const int r = pixel[0] - color[0];
+		const int g = pixel[1] - color[1];
+		const int b = pixel[2] - color[2];
+
+		return r * r + g * g + b * b;
+	}
+}
+
+bool
+TextureCompression::isCompressed(TextureFormat format)
+{
+	return format != TextureFormat::RGB && format != TextureFormat::RGBA;
+}
+
+bool
+TextureCompression::hasAlpha(TextureFormat format)
+{
+	return format == TextureFormat::RGBA
+		|| format == TextureFormat::RGBA_DXT5
+		|| format == TextureFormat::RGBA_PVRTC1_4BPP;
+}
+
+uint
+TextureCompression::dataSize(TextureFormat format, uint width, uint height)
+{
+	const uint numBlocks = std::max(1u, (width + 3) / 4) * std::max(1u, (height + 3) / 4);
+
+	switch (format)
+	{
+	case TextureFormat::RGB:
+		return width * height * 3;
+	case TextureFormat::RGBA:
+		return width * height * 4;
+	case TextureFormat::RGB_DXT1:
+	case TextureFormat::RGB_ETC1:
+		return numBlocks * 8;
+	case TextureFormat::RGBA_DXT5:
+		return numBlocks * 16;
+	case TextureFormat::RGB_PVRTC1_4BPP:
+	case TextureFormat::RGBA_PVRTC1_4BPP:
+		// 4 bits per pixel, 8x8 pixels at least
+		return std::max(width, 8u) * std::max(height, 8u) / 2;
+	default:
+		throw std::invalid_argument("format");
+	}
+}
+
+void
+TextureCompression::compress(TextureFormat					format,
+							 uint							width,
+							 uint							height,
+							 const unsigned char*			rgba,
+							 std::vector<unsigned char>&	out)
+{
+	if (!isCompressed(format))
+		throw std::invalid_argument("format");
+	if (format == TextureFormat::RGB_PVRTC1_4BPP || format == TextureFormat::RGBA_PVRTC1_4BPP)
+		throw std::logic_error("PVRTC textures cannot be compressed in software.");
+
+	const uint	blockSize	= format == TextureFormat::RGBA_DXT5 ? 16 : 8;
+	uint		offset		= 0;
+
+	out.resize(dataSize(format, width, height));
+
+	for (uint blockY = 0; blockY < std::max(1u, (height + 3) / 4); ++blockY)
+		for (uint blockX = 0; blockX < std::max(1u, (width + 3) / 4); ++blockX)
+		{
+			unsigned char pixels[64];
+
+			// the borders of the blocks that overflow the image repeat its last row and column
+			for (uint y = 0; y < 4; ++y)
+				for (uint x = 0; x < 4; ++x)
+				{
+					const uint srcX = std::min(blockX * 4 + x, width - 1);
+					const uint srcY = std::min(blockY * 4 + y, height - 1);
+
+					std::memcpy(pixels + (y * 4 + x) * 4, rgba + (srcY * width + srcX) * 4, 4);
+				}
+
+			if (format == TextureFormat::RGB_ETC1)
+				compressETC1Block(pixels, &out[offset]);
+			else if (format == TextureFormat::RGBA_DXT5)
+			{
+				compressDXT5AlphaBlock(pixels, &out[offset]);
+				compressDXT1Block(pixels, &out[offset + 8]);
+			}
+			else
+				compressDXT1Block(pixels, &out[offset]);
+
+			offset += blockSize;
+		}
+}
+
+void
+TextureCompression::decompress(TextureFormat				format,
+							   uint							width,
+							   uint							height,
+							   const unsigned char*			data,
+							   std::vector<unsigned char>&	rgba)
+{
+	if (!isCompressed(format))
+		throw std::invalid_argument("format");
+	if (format == TextureFormat::RGB_PVRTC1_4BPP || format == TextureFormat::RGBA_PVRTC1_4BPP)
+		throw std::logic_error("PVRTC textures cannot be decompressed in software.");
+
+	const uint	blockSize	= format == TextureFormat::RGBA_DXT5 ? 16 : 8;
+	uint		offset		= 0;
+
+	rgba.resize(width * height * 4);
+
+	for (uint blockY = 0; blockY < std::max(1u, (height + 3) / 4); ++blockY)
+		for (uint blockX = 0; blockX < std::max(1u, (width + 3) / 4); ++blockX)
+		{
+			unsigned char pixels[64];
+
+			if (format == TextureFormat::RGB_ETC1)
+				decompressETC1Block(data + offset, pixels);
+			else if (format == TextureFormat::RGBA_DXT5)
+			{
+				decompressDXTColorBlock(data + offset + 8, true, pixels);
+				decompressDXT5AlphaBlock(data + offset, pixels);
+			}
+			else
+				decompressDXTColorBlock(data + offset, false, pixels);
+
+			for (uint y = 0; y < 4 && blockY * 4 + y < height; ++y)
+				for (uint x = 0; x < 4 && blockX * 4 + x < width; ++x)
+					std::memcpy(&rgba[((blockY * 4 + y) * width + blockX * 4 + x) * 4], pixels + (y * 4 + x) * 4, 4);
+
+			offset += blockSize;
+		}
+}
+
+void
+TextureCompression::compressDXT1Block(const unsigned char* pixels, unsigned char* block)
+{
+	int min[3] = { 255, 255, 255 };
+	int max[3] = { 0, 0, 0 };
+
+	for (uint i = 0; i < 16; ++i)
+		for (uint c = 0; c < 3; ++c)
+		{
+			min[c] = std::min(min[c], (int)pixels[i * 4 + c]);
+			max[c] = std::max(max[c], (int)pixels[i * 4 + c]);
+		}
+
+	// insetting the bounding box reduces the error of the interpolated colors
+	for (uint c = 0; c < 3; ++c)
+	{
+		const int inset = (max[c] - min[c]) >> 4;
+
+		min[c] += inset;
+		max[c] -= inset;
+	}
+
+	unsigned short	color0	= packRGB565(max);
+	unsigned short	color1	= packRGB565(min);
+	uint			indices	= 0;
+
+	if (color0 < color1)
+		std::swap(color0, color1);
+
+	if (color0 != color1)
+	{
+		int palette[4][3];
+
+		unpackRGB565(color0, palette[0]);
+		unpackRGB565(color1, palette[1]);
+		for (uint c = 0; c < 3; ++c)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+
+		for (uint i = 0; i < 16; ++i)
+		{
+			uint	bestIndex		= 0;
+			int		bestDistance	= colorDistance(pixels + i * 4, palette[0]);
+
+			for (uint index = 1; index < 4; ++index)
+			{
+				const int distance = colorDistance(pixels + i * 4, palette[index]);
+
+				if (distance < bestDistance)
+				{
+					bestIndex = index;
+					bestDistance = distance;
+				}
+			}
+
+			indices |= bestIndex << (i * 2);
+		}
+	}
+
+	block[0] = color0 & 0xff;
+	block[1] = color0 >> 8;
+	block[2] = color1 & 0xff;
+	block[3] = color1 >> 8;
+	for (uint i = 0; i < 4; ++i)
+		block[4 + i] = (indices >> (i * 8)) & 0xff;
+}
+
+void
+TextureCompression::compressDXT5AlphaBlock(const unsigned char* pixels, unsigned char* block)
+{
+	int			alpha0	= 0;
+	int			alpha1	= 255;
+	uint64_t	indices	= 0;
+
+	for (uint i = 0; i < 16; ++i)
+	{
+		alpha0 = std::max(alpha0, (int)pixels[i * 4 + 3]);
+		alpha1 = std::min(alpha1, (int)pixels[i * 4 + 3]);
+	}
+
+	if (alpha0 != alpha1)
+	{
+		int palette[8] = { alpha0, alpha1 };
+
+		for (uint index = 2; index < 8; ++index)
+			palette[index] = ((8 - index) * alpha0 + (index - 1) * alpha1) / 7;
+
+		for (uint i = 0; i < 16; ++i)
+		{
+			uint bestIndex = 0;
+
+			for (uint index = 1; index < 8; ++index)
+				if (std::abs(palette[index] - pixels[i * 4 + 3]) < std::abs(palette[bestIndex] - pixels[i * 4 + 3]))
+					bestIndex = index;
+
+			indices |= (uint64_t)bestIndex << (i * 3);
+		}
+	}
+
+	block[0] = alpha0;
+	block[1] = alpha1;
+	for (uint i = 0; i < 6; ++i)
+		block[2 + i] = (indices >> (i * 8)) & 0xff;
+}
+
+void
+TextureCompression::compressETC1Block(const unsigned char* pixels, unsigned char* block)
+{
+	int		bestError	= std::numeric_limits<int>::max();
+	uint	bestFlip	= 0;
+	int		bestBase[2][3];
+	uint	bestTable[2];
+	uint	bestIndices[16];
+
+	// individual mode: each half of the block gets a 4 bits per channel base color and a modifier table
+	for (uint flip = 0; flip < 2; ++flip)
+	{
+		int		error = 0;
+		int		base[2][3];
+		uint	table[2];
+		uint	indices[16];
+
+		for (uint subBlock = 0; subBlock < 2; ++subBlock)
+		{
+			uint	subPixels[8];
+			int		sum[3]	= { 0, 0, 0 };
+
+			for (uint i = 0, j = 0; i < 16; ++i)
+			{
+				const uint x = i % 4;
+				const uint y = i / 4;
+
+				if ((flip ? y / 2 : x / 2) == subBlock)
+				{
+					subPixels[j++] = i;
+					for (uint c = 0; c < 3; ++c)
+						sum[c] += pixels[i * 4 + c];
+				}
+			}
+
+			for (uint c = 0; c < 3; ++c)
+				base[subBlock][c] = ((sum[c] / 8) * 15 + 127) / 255 * 17;
+
+			int subBlockError = std::numeric_limits<int>::max();
+
+			for (uint t = 0; t < 8; ++t)
+			{
+				int		tableError = 0;
+				uint	tableIndices[8];
+
+				for (uint j = 0; j < 8; ++j)
+				{
+					int bestDistance = std::numeric_limits<int>::max();
+
+					for (uint index = 0; index < 4; ++index)
+					{
+						const int modifier	= etc1Modifier(t, index);
+						const int color[3]	= {
+							clampColor(base[subBlock][0] + modifier),
+							clampColor(base[subBlock][1] + modifier),
+							clampColor(base[subBlock][2] + modifier)
+						};
+						const int distance	= colorDistance(pixels + subPixels[j] * 4, color);
+
+						if (distance < bestDistance)
+						{
+							bestDistance = distance;
+							tableIndices[j] = index;
+						}
+					}
+
+					tableError += bestDistance;
+				}
+
+				if (tableError < subBlockError)
+				{
+					subBlockError = tableError;
+					table[subBlock] = t;
+					for (uint j = 0; j < 8; ++j)
+						indices[subPixels[j]] = tableIndices[j];
+				}
+			}
+
+			error += subBlockError;
+		}
+
+		if (error < bestError)
+		{
+			bestError = error;
+			bestFlip = flip;
+			std::memcpy(bestBase, base, sizeof(base));
+			std::memcpy(bestTable, table, sizeof(table));
+			std::memcpy(bestIndices, indices, sizeof(indices));
+		}
+	}
+
+	uint bits = 0;
+
+	for (uint i = 0; i < 16; ++i)
+	{
+		// pixels are numbered column by column
+		const uint j = (i % 4) * 4 + i / 4;
+
+		bits |= (bestIndices[i] >> 1) << (16 + j);
+		bits |= (bestIndices[i] & 1) << j;
+	}
+
+	for (uint c = 0; c < 3; ++c)
+		block[c] = (bestBase[0][c] / 17) << 4 | (bestBase[1][c] / 17);
+	block[3] = bestTable[0] << 5 | bestTable[1] << 2 | bestFlip;
+	for (uint i = 0; i < 4; ++i)
+		block[4 + i] = (bits >> (24 - i * 8)) & 0xff;
+}
+
+void
+TextureCompression::decompressDXTColorBlock(const unsigned char* block, bool opaque, unsigned char* pixels)
+{
+	const unsigned short	color0	= block[0] | block[1] << 8;
+	const unsigned short	color1	= block[2] | block[3] << 8;
+	const uint				indices	= block[4] | block[5] << 8 | block[6] << 16 | (uint)block[7] << 24;
+	int						palette[4][4];
+
+	unpackRGB565(color0, palette[0]);
+	unpackRGB565(color1, palette[1]);
+	palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+
+	// DXT1 switches to 3 colors and transparent black when the endpoints are in ascending order
+	if (color0 > color1 || opaque)
+		for (uint c = 0; c < 3; ++c)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+	else
+		for (uint c = 0; c < 4; ++c)
+		{
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			palette[3][c] = 0;
+		}
+
+	for (uint i = 0; i < 16; ++i)
+		for (uint c = 0; c < 4; ++c)
+			pixels[i * 4 + c] = palette[(indices >> (i * 2)) & 3][c];
+}
+
+void
+TextureCompression::decompressDXT5AlphaBlock(const unsigned char* block, unsigned char* pixels)
+{
+	int			palette[8]	= { block[0], block[1] };
+	uint64_t	indices		= 0;
+
+	for (uint i = 0; i < 6; ++i)
+		indices |= (uint64_t)block[2 + i] << (i * 8);
+
+	if (palette[0] > palette[1])
+		for (uint index = 2; index < 8; ++index)
+			palette[index] = ((8 - index) * palette[0] + (index - 1) * palette[1]) / 7;
+	else
+	{
+		for (uint index = 2; index < 6; ++index)
+			palette[index] = ((6 - index) * palette[0] + (index - 1) * palette[1]) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	for (uint i = 0; i < 16; ++i)
+		pixels[i * 4 + 3] = palette[(indices >> (i * 3)) & 7];
+}
+
+void
+TextureCompression::decompressETC1Block(const unsigned char* block, unsigned char* pixels)
+{
+	const bool	differential	= (block[3] & 2) != 0;
+	const bool	flip			= (block[3] & 1) != 0;
+	const uint	table[2]		= { (uint)block[3] >> 5, ((uint)block[3] >> 2) & 7 };
+	const uint	bits			= (uint)block[4] << 24 | block[5] << 16 | block[6] << 8 | block[7];
+	int			base[2][3];
+
+	for (uint c = 0; c < 3; ++c)
+	{
+		if (differential)
+		{
+			const int color0 = block[c] >> 3;
+			const int delta = (block[c] & 7) >= 4 ? (block[c] & 7) - 8 : (block[c] & 7);
+			const int color1 = color0 + delta;
+
+			base[0][c] = (color0 << 3) | (color0 >> 2);
+			base[1][c] = (color1 << 3) | (color1 >> 2);
+		}
+		else
+		{
+			base[0][c] = (block[c] >> 4) * 17;
+			base[1][c] = (block[c] & 15) * 17;
+		}
+	}
+
+	for (uint i = 0; i < 16; ++i)
+	{
+		const uint x		= i % 4;
+		const uint y		= i / 4;
+		const uint j		= x * 4 + y;
+		const uint subBlock	= flip ? y / 2 : x / 2;
+		const uint index	= ((bits >> (16 + j)) & 1) << 1 | ((bits >> j) & 1);
+		const int modifier	= etc1Modifier(table[subBlock], index);
+
+		for (uint c = 0; c < 3; ++c)
+			pixels[i * 4 + c] = clampColor(base[subBlock][c] + modifier);
+		pixels[i * 4 + 3] = 255;
+	}
+}
@@ -34,7 +34,8 @@ VertexBuffer::VertexBuffer(std::shared_ptr<AbstractContext> context) :
 	std::enable_shared_from_this<VertexBuffer>(),
 	_data(),
 	_vertexSize(0),
-	_vertexSizeChanged(Signal<Ptr, int>::create())
+	_vertexSizeChanged(Signal<Ptr, int>::create()),
+	_dataChanged(Signal<Ptr>::create())
 {
 }
 
@@ -45,7 +46,8 @@ VertexBuffer::VertexBuffer(std::shared_ptr<AbstractContext>	context,
 	AbstractResource(context),
 	_data(data + offset, data + offset + size),
 	_vertexSize(0),
-	_vertexSizeChanged(Signal<Ptr, int>::create())
+	_vertexSizeChanged(Signal<Ptr, int>::create()),
+	_dataChanged(Signal<Ptr>::create())
 {
 	upload();
 }
@@ -56,7 +58,8 @@ VertexBuffer::VertexBuffer(std::shared_ptr<AbstractContext>		context,
 	AbstractResource(context),
 	_data(begin, end),
 	_vertexSize(0),
-	_vertexSizeChanged(Signal<Ptr, int>::create())
+	_vertexSizeChanged(Signal<Ptr, int>::create()),
+	_dataChanged(Signal<Ptr>::create())
 {
 	upload();
 }
@@ -65,7 +68,8 @@ VertexBuffer::VertexBuffer(std::shared_ptr<AbstractContext> context, float* begi
 	AbstractResource(context),
 	_data(begin, end),
 	_vertexSize(0),
-	_vertexSizeChanged(Signal<Ptr, int>::create())
+	_vertexSizeChanged(Signal<Ptr, int>::create()),
+	_dataChanged(Signal<Ptr>::create())
 {
 	upload();
 }
@@ -84,6 +88,9 @@ VertexBuffer::upload(uint offset, uint numVertices)
     );
 
 	updatePositionBounds();
+
+	if (_dataChanged->numCallbacks() > 0)
+		_dataChanged->execute(shared_from_this());
 }
 
 void
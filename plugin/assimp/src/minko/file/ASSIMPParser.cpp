@@ -365,6 +365,20 @@ ASSIMPParser::createMeshGeometry(scene::Node::Ptr minkoNode, aiMesh* mesh)
 
 	const auto meshName = std::string(mesh->mName.data);
 
+	if (_options->optimizeGeometry())
+	{
+#ifdef DEBUG
+		const float acmr = geometry->averageCacheMissRatio();
+#endif
+
+		geometry->optimize();
+
+#ifdef DEBUG
+		std::cout << "ASSIMParser: optimized mesh '" << meshName << "', ACMR "
+			<< acmr << " -> " << geometry->averageCacheMissRatio() << std::endl;
+#endif
+	}
+
 	geometry = _options->geometryFunction()(meshName, geometry);
 
 	// save the geometry in the assets library
@@ -55,6 +55,9 @@ namespace minko
 			public:
 				typedef std::shared_ptr<PhysicsWorld>                                   Ptr;
 
+				static const float												        DEFAULT_FIXED_TIME_STEP;
+				static const uint												        DEFAULT_MAX_SUB_STEPS;
+
 			private:
 				typedef std::shared_ptr<LinearIdAllocator>			                    LinearIdAllocatorPtr;
 				typedef std::shared_ptr<AbstractComponent>			                    AbsCtrlPtr;
@@ -105,6 +108,19 @@ namespace minko
                 std::unordered_map<ColliderDataPtr, NodeLayoutsChanged::Slot>           _colliderGroupChangedSlot;
                 std::unordered_map<ColliderDataPtr, ColliderChanged::Slot>              _colliderMaskChangedSlot;
 
+				float											                        _fixedTimeStep;
+				uint											                        _maxSubSteps;
+				bool											                        _interpolate;
+				bool											                        _asynchronous;
+				float											                        _previousTime;
+				float											                        _accumulator;
+				float											                        _interpolationFactor;
+				std::future<void>								                        _stepJob;
+
+				std::vector<Matrix4x4Ptr>						                        _graphicsTransforms;
+				std::vector<ColliderDataPtr>					                        _updatedColliders;
+				std::vector<std::pair<NodePtr, Matrix4x4Ptr>>	                        _worldToParent;
+
 				static const uint								                        _MAX_BODIES;
 				static Matrix4x4Ptr								                        _TMP_MATRIX;
 				static btTransform								                        _TMP_BTTRANSFORM;
@@ -123,8 +139,63 @@ namespace minko
 
 				~PhysicsWorld()
 				{
+					waitForStep();
+				}
+
+				inline
+				float
+				fixedTimeStep() const
+				{
+					return _fixedTimeStep;
+				}
+
+				void
+				fixedTimeStep(float);
+
+				inline
+				uint
+				maxSubSteps() const
+				{
+					return _maxSubSteps;
+				}
+
+				void
+				maxSubSteps(uint);
+
+				/*
+				** When enabled (default), the rendered transforms are interpolated between the last
+				** two fixed steps instead of snapping to the last one. The graphics lag up to one
+				** step behind the simulation.
+				*/
+				inline
+				bool
+				interpolate() const
+				{
+					return _interpolate;
+				}
+
+				inline
+				void
+				interpolate(bool value)
+				{
+					_interpolate = value;
 				}
 
+				/*
+				** When enabled, the fixed steps of a frame run on a worker thread while the frame
+				** is rendered and are written back at the beginning of the next frame, which adds
+				** one frame of latency. Every call touching the simulation waits for that step.
+				*/
+				inline
+				bool
+				asynchronous() const
+				{
+					return _asynchronous;
+				}
+
+				void
+				asynchronous(bool);
+
 				bool
 				hasCollider(ColliderDataPtr) const;
 
@@ -137,8 +208,12 @@ namespace minko
 				void
 				setGravity(Vector3Ptr);
 
+				/*
+				** Steps the simulation once by timeStep (in seconds) regardless of the fixed time step,
+				** then writes back the transforms of the awake colliders.
+				*/
 				void 
-				update(float timeStep = 1.0f/60.0f);
+				update(float timeStep = DEFAULT_FIXED_TIME_STEP);
 
 				void
 				synchronizePhysicsWithGraphics(ColliderDataPtr, Matrix4x4Ptr);
@@ -174,7 +249,16 @@ namespace minko
 				frameEndHandler(std::shared_ptr<SceneManager> sceneManager);
 
 				void
-				updateColliders();
+				step(uint numSteps);
+
+				void
+				waitForStep();
+
+				void
+				updateColliders(float interpolationFactor);
+
+				Matrix4x4Ptr
+				worldToParent(NodePtr, uint& numParents);
 
 				void
 				notifyCollisions();
@@ -224,6 +308,9 @@ namespace minko
 					btMotionStatePtr		_bulletMotionState;
 					btCollisionObjectPtr	_bulletCollisionObject;
 
+					btTransformPtr			_previousWorldTransform;
+					bool					_active;
+
 				public:
 					static
 					BulletColliderPtr
@@ -235,6 +322,12 @@ namespace minko
 					void 
 					setWorldTransform(Matrix4x4Ptr);
 
+					void
+					storeWorldTransform();
+
+					bool
+					updatedWorldTransform(float interpolationFactor, btTransform&);
+
 					void
 					setLinearVelocity(Vector3Ptr);
 
@@ -37,7 +37,9 @@ using namespace minko::component;
 bullet::PhysicsWorld::BulletCollider::BulletCollider():
 	_bulletCollisionShape(nullptr),
 	_bulletMotionState(nullptr),
-	_bulletCollisionObject(nullptr)
+	_bulletCollisionObject(nullptr),
+	_previousWorldTransform(new btTransform()),
+	_active(true)
 {
 }
 
@@ -212,6 +214,8 @@ bullet::PhysicsWorld::BulletCollider::initializeCollisionObject(ColliderData::Pt
 	_bulletCollisionShape	= bulletCollisionShape;
 	_bulletMotionState		= bulletMotionState;
 	_bulletCollisionObject	= bulletRigidBody;
+
+	storeWorldTransform();
 }
 
 void
@@ -252,6 +256,44 @@ bullet::PhysicsWorld::BulletCollider::setWorldTransform(Matrix4x4::Ptr physicsNo
 	}
 }
 
+void
+bullet::PhysicsWorld::BulletCollider::storeWorldTransform()
+{
+	*_previousWorldTransform = _bulletCollisionObject->getWorldTransform();
+}
+
+bool
+bullet::PhysicsWorld::BulletCollider::updatedWorldTransform(float			interpolationFactor, 
+															btTransform&	output)
+{
+	const btTransform& worldTransform = _bulletCollisionObject->getWorldTransform();
+
+	if (!_bulletCollisionObject->isActive())
+	{
+		// sleeping bodies do not move: write them back once, at their resting state
+		if (!_active)
+			return false;
+
+		_active						= false;
+		*_previousWorldTransform	= worldTransform;
+		output						= worldTransform;
+
+		return true;
+	}
+
+	_active = true;
+
+	if (interpolationFactor >= 1.0f)
+		output = worldTransform;
+	else
+	{
+		output.setOrigin(_previousWorldTransform->getOrigin().lerp(worldTransform.getOrigin(), interpolationFactor));
+		output.setRotation(_previousWorldTransform->getRotation().slerp(worldTransform.getRotation(), interpolationFactor));
+	}
+
+	return true;
+}
+
 void
 bullet::PhysicsWorld::BulletCollider::applyRelativeImpulse(Vector3::Ptr relativeImpulse)
 {
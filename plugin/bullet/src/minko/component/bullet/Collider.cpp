@@ -44,7 +44,6 @@ bullet::Collider::Collider(ColliderData::Ptr data):
 	_targetRemovedSlot(nullptr),
 	_addedSlot(nullptr),
 	_removedSlot(nullptr),
-	_graphicsTransformChangedSlot(nullptr),
 	_collisionStartedHandlerSlot(nullptr),
 	_collisionEndedHandlerSlot(nullptr)
 {
@@ -68,13 +67,6 @@ bullet::Collider::initialize()
 		std::placeholders::_1,
 		std::placeholders::_2
 		));
-
-	_graphicsTransformChangedSlot	= _colliderData->graphicsWorldTransformChanged()->connect(std::bind(
-		&bullet::Collider::graphicsWorldTransformChangedHandler,
-		shared_from_this(),
-		std::placeholders::_1,
-		std::placeholders::_2
-		));
 }
 
 void
@@ -231,23 +223,4 @@ bullet::Collider::synchronizePhysicsWithGraphics()
 #endif // DEBUG_PHYSICS
 
 	_physicsWorld->synchronizePhysicsWithGraphics(_colliderData, _TMP_MATRIX);
-}
-
-void
-bullet::Collider::graphicsWorldTransformChangedHandler(ColliderData::Ptr collider, 
-													   Matrix4x4::Ptr graphicsTransform)
-{
-	if (_targetTransform == nullptr)
-		return;
-
-	// get the world-to-parent matrix in order to update the target's Transform
-	_TMP_MATRIX
-		->copyFrom(_targetTransform->modelToWorldMatrix(true))
-		->invert()
-		->append(_targetTransform->matrix());
-	// _TMP_MATRIX = worldToParent
-
-	_targetTransform->matrix()
-		->copyFrom(graphicsTransform)
-		->append(_TMP_MATRIX);
 }
\ No newline at end of file
@@ -25,6 +25,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include <minko/scene/NodeSet.hpp>
 #include <minko/component/SceneManager.hpp>
 #include <minko/component/Renderer.hpp>
+#include <minko/component/Transform.hpp>
 #include <minko/component/bullet/LinearIdAllocator.hpp>
 #include <minko/component/bullet/ColliderData.hpp>
 #include <minko/component/bullet/AbstractPhysicsShape.hpp>
@@ -34,6 +35,10 @@ using namespace minko::math;
 using namespace minko::scene;
 using namespace minko::component;
 
+/*static*/
+const float		bullet::PhysicsWorld::DEFAULT_FIXED_TIME_STEP	= 1.0f / 60.0f;
+/*static*/
+const uint		bullet::PhysicsWorld::DEFAULT_MAX_SUB_STEPS		= 4;
 /*static*/
 const uint		bullet::PhysicsWorld::_MAX_BODIES	= 2048;
 /*static*/
@@ -59,7 +64,18 @@ bullet::PhysicsWorld::PhysicsWorld():
 	_componentAddedOrRemovedSlot(nullptr),
 	_addedOrRemovedSlot(nullptr),
     _colliderGroupChangedSlot(),
-    _colliderMaskChangedSlot()
+    _colliderMaskChangedSlot(),
+	_fixedTimeStep(DEFAULT_FIXED_TIME_STEP),
+	_maxSubSteps(DEFAULT_MAX_SUB_STEPS),
+	_interpolate(true),
+	_asynchronous(false),
+	_previousTime(-1.0f),
+	_accumulator(0.0f),
+	_interpolationFactor(1.0f),
+	_stepJob(),
+	_graphicsTransforms(),
+	_updatedColliders(),
+	_worldToParent()
 {
 }
 
@@ -109,6 +125,8 @@ void
 bullet::PhysicsWorld::targetRemovedHandler(AbstractComponent::Ptr	controller, 
 										   Node::Ptr				target)
 {
+	waitForStep();
+
 	_sceneManager = nullptr;
 	_frameEndSlot = nullptr;
 	_addedOrRemovedSlot = nullptr;
@@ -118,6 +136,9 @@ bullet::PhysicsWorld::targetRemovedHandler(AbstractComponent::Ptr	controller,
 	_colliderMap.clear();
 	_colliderReverseMap.clear();
 	_uidToCollider.clear();
+
+	_previousTime	= -1.0f;
+	_accumulator	= 0.0f;
 }
 
 void
@@ -165,6 +186,8 @@ bullet::PhysicsWorld::addChild(ColliderData::Ptr data)
 	if (hasCollider(data))
 		throw new std::logic_error("The same data cannot be added twice.");
 
+	waitForStep();
+
 	data->uid(_uidAllocator->allocate());
 
 	_uidToCollider.insert(std::pair<uint, ColliderData::Ptr>(data->uid(), data));
@@ -194,6 +217,8 @@ bullet::PhysicsWorld::addChild(ColliderData::Ptr data)
 void
 bullet::PhysicsWorld::updateCollisionFilter(ColliderData::Ptr data)
 {
+    waitForStep();
+
     auto foundColliderIt = _colliderMap.find(data);
     if (foundColliderIt != _colliderMap.end())
     {
@@ -208,6 +233,8 @@ bullet::PhysicsWorld::updateCollisionFilter(ColliderData::Ptr data)
 void
 bullet::PhysicsWorld::removeChild(ColliderData::Ptr data)
 {
+    waitForStep();
+
     if (_colliderGroupChangedSlot.count(data))
         _colliderGroupChangedSlot.erase(data);
 
@@ -254,48 +281,207 @@ bullet::PhysicsWorld::hasCollider(ColliderData::Ptr data) const
 void
 bullet::PhysicsWorld::setGravity(Vector3::Ptr gravity)
 {
+	waitForStep();
+
 	_bulletDynamicsWorld->setGravity(btVector3(gravity->x(), gravity->y(), gravity->z()));
 }
 
+void
+bullet::PhysicsWorld::fixedTimeStep(float value)
+{
+	if (value <= 0.0f)
+		throw std::invalid_argument("value");
+
+	_fixedTimeStep = value;
+}
+
+void
+bullet::PhysicsWorld::maxSubSteps(uint value)
+{
+	if (value == 0)
+		throw std::invalid_argument("value");
+
+	_maxSubSteps = value;
+}
+
+void
+bullet::PhysicsWorld::asynchronous(bool value)
+{
+#if defined(EMSCRIPTEN)
+	value = false;
+#endif
+
+	if (!value)
+		waitForStep();
+
+	_asynchronous = value;
+}
+
 void
 bullet::PhysicsWorld::frameEndHandler(std::shared_ptr<SceneManager> sceneManager)
 {
-	update();
+	const float time		= sceneManager->time();
+	const float deltaTime	= _previousTime < 0.0f ? 0.0f : (time - _previousTime) * 0.001f; // in seconds
+
+	_previousTime = time;
+
+	// steps that ran on the worker thread while the previous frame was rendered
+	const bool	steppedAsynchronously		= _stepJob.valid();
+	const float	previousInterpolationFactor	= _interpolationFactor;
+
+	waitForStep();
+
+	_accumulator += deltaTime;
+
+	auto numSteps = uint(_accumulator / _fixedTimeStep);
+
+	_accumulator -= numSteps * _fixedTimeStep;
+	// drop the time the simulation cannot catch up with instead of spiraling down
+	numSteps = std::min(numSteps, _maxSubSteps);
+
+	_interpolationFactor = _interpolate ? _accumulator / _fixedTimeStep : 1.0f;
+
+#if !defined(EMSCRIPTEN)
+	if (_asynchronous && numSteps > 0)
+	{
+		// show the last completed state while the next one is computed
+		updateColliders(previousInterpolationFactor);
+		if (steppedAsynchronously)
+			notifyCollisions();
+
+		_stepJob = std::async(std::launch::async, [this, numSteps]()
+		{
+			step(numSteps);
+		});
+
+		return;
+	}
+#endif
+
+	step(numSteps);
+	updateColliders(_interpolationFactor);
+	if (numSteps > 0 || steppedAsynchronously)
+		notifyCollisions();
 }
 
 void
 bullet::PhysicsWorld::update(float timeStep)
 {
-	_bulletDynamicsWorld->stepSimulation(timeStep);
-	updateColliders();
+	waitForStep();
+
+	for (auto& colliderAndBulletCollider : _colliderMap)
+		colliderAndBulletCollider.second->storeWorldTransform();
+
+	_bulletDynamicsWorld->stepSimulation(timeStep, 0);
+	updateColliders(1.0f);
 	notifyCollisions();
 }
 
 void
-bullet::PhysicsWorld::updateColliders()
+bullet::PhysicsWorld::step(uint numSteps)
+{
+	for (uint i = 0; i < numSteps; ++i)
+	{
+		// only the state before the last step is needed for interpolation
+		if (i == numSteps - 1)
+			for (auto& colliderAndBulletCollider : _colliderMap)
+				if (!colliderAndBulletCollider.first->isStatic())
+					colliderAndBulletCollider.second->storeWorldTransform();
+
+		_bulletDynamicsWorld->stepSimulation(_fixedTimeStep, 0);
+	}
+}
+
+void
+bullet::PhysicsWorld::waitForStep()
+{
+#if !defined(EMSCRIPTEN)
+	if (_stepJob.valid())
+		_stepJob.get();
+#endif
+}
+
+void
+bullet::PhysicsWorld::updateColliders(float interpolationFactor)
 {
-	for (ColliderMap::iterator it = _colliderMap.begin(); it != _colliderMap.end(); ++it)
+	uint numUpdatedColliders	= 0;
+	uint numParents				= 0;
+
+	// write back the transforms of the awake bodies first, notify once they are all up to date
+	for (auto& colliderAndBulletCollider : _colliderMap)
 	{
-		ColliderData::Ptr	collider(it->first);
-		if (collider->isStatic())
+		auto& collider = colliderAndBulletCollider.first;
+
+		if (collider->isStatic()
+			|| !colliderAndBulletCollider.second->updatedWorldTransform(interpolationFactor, _TMP_BTTRANSFORM))
 			continue;
 
-		fromBulletTransform(
-			it->second->rigidBody()->getWorldTransform(),
-			_TMP_MATRIX
-		);
-		// _TMP_MATRIX = physicsTransform
+		if (numUpdatedColliders == _graphicsTransforms.size())
+		{
+			_graphicsTransforms.push_back(Matrix4x4::create());
+			_updatedColliders.push_back(nullptr);
+		}
+
+		auto graphicsTransform = _graphicsTransforms[numUpdatedColliders];
 
-		_TMP_MATRIX
+		_updatedColliders[numUpdatedColliders++] = collider;
+
+		fromBulletTransform(_TMP_BTTRANSFORM, graphicsTransform)
 			->prepend(collider->shape()->deltaTransformInverse())
 			->prepend(collider->correction());
-		// _TMP_MATRIX = graphicsTransform = physicsTransform * deltaInverse * correction
+		// graphicsTransform = physicsTransform * deltaInverse * correction
+
+		auto node = collider->node();
 
-		collider->graphicsWorldTransformChanged()
-			->execute(collider, _TMP_MATRIX);
+		if (node == nullptr || !node->hasComponent<Transform>())
+			continue;
+
+		auto localTransform	= node->component<Transform>()->matrix()->copyFrom(graphicsTransform);
+		auto worldToParent	= this->worldToParent(node->parent(), numParents);
+
+		if (worldToParent != nullptr)
+			localTransform->append(worldToParent);
+	}
+
+	for (uint i = 0; i < numParents; ++i)
+		_worldToParent[i].first = nullptr;
+
+	for (uint i = 0; i < numUpdatedColliders; ++i)
+	{
+		auto collider = _updatedColliders[i];
+
+		_updatedColliders[i] = nullptr;
+		collider->graphicsWorldTransformChanged()->execute(collider, _graphicsTransforms[i]);
 	}
 }
 
+Matrix4x4::Ptr
+bullet::PhysicsWorld::worldToParent(Node::Ptr parent, uint& numParents)
+{
+	// the first ancestor with a Transform defines the parent space
+	while (parent != nullptr && !parent->hasComponent<Transform>())
+		parent = parent->parent();
+
+	if (parent == nullptr)
+		return nullptr;
+
+	// bodies usually share a handful of parents: resolve each of them once per batch
+	for (uint i = 0; i < numParents; ++i)
+		if (_worldToParent[i].first == parent)
+			return _worldToParent[i].second;
+
+	if (numParents == _worldToParent.size())
+		_worldToParent.push_back(std::make_pair(nullptr, Matrix4x4::create()));
+
+	auto& parentAndWorldToParent = _worldToParent[numParents++];
+
+	parentAndWorldToParent.first = parent;
+
+	return parentAndWorldToParent.second
+		->copyFrom(parent->component<Transform>()->modelToWorldMatrix(true))
+		->invert();
+}
+
 void
 bullet::PhysicsWorld::notifyCollisions()
 {
@@ -374,6 +560,8 @@ void
 bullet::PhysicsWorld::synchronizePhysicsWithGraphics(ColliderDataPtr collider, 
 													 Matrix4x4::Ptr graphicsNoScaleTransform)
 {
+	waitForStep();
+
 	auto it	= _colliderMap.find(collider);
 	if (it == _colliderMap.end())
 		return;
@@ -409,6 +597,8 @@ bullet::PhysicsWorld::synchronizePhysicsWithGraphics(ColliderDataPtr collider,
 	// synchronize bullet
 	bulletMotionState->getWorldTransform(_TMP_BTTRANSFORM);
 	it->second->rigidBody()->setWorldTransform(_TMP_BTTRANSFORM);
+	// do not interpolate from the state prior to this teleport
+	it->second->storeWorldTransform();
 
 #ifdef DEBUG_PHYSICS
 	std::cout << "[" << it->first->name() << "] synchro graphics -> physics" << std::endl;
@@ -71,6 +71,8 @@ DevILParser::parse(const std::string&                 filename,
 
 	auto texture = render::Texture::create(options->context(), ilGetInteger(IL_IMAGE_WIDTH), ilGetInteger(IL_IMAGE_HEIGHT), options->generateMipmaps());
 
+	texture->streamed(options->streamTextures());
+
 	texture->data(bmpData, format == IL_RGBA ? minko::render::TextureFormat::RGBA : minko::render::TextureFormat::RGB);
 	texture->upload();
 
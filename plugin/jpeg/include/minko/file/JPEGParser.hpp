@@ -21,7 +21,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 
 #include "minko/Common.hpp"
 
-#include "minko/file/AbstractParser.hpp"
+#include "minko/file/AbstractImageParser.hpp"
 #include "minko/render/AbstractContext.hpp"
 
 namespace minko
@@ -29,7 +29,7 @@ namespace minko
 	namespace file
 	{
 		class JPEGParser :
-			public AbstractParser
+			public AbstractImageParser
 		{
 		public:
 			typedef std::shared_ptr<JPEGParser> Ptr;
@@ -42,15 +42,20 @@ namespace minko
 				return std::shared_ptr<JPEGParser>(new JPEGParser());
 			}
 
-			void
-			parse(const std::string&				filename,
-				  const std::string&                resolvedFilename,
-                  std::shared_ptr<Options>          options,
-				  const std::vector<unsigned char>&	data,
-				  std::shared_ptr<AssetLibrary>	AssetLibrary);
+			/**
+			 * Decodes a JPEG file to RGBA in a buffer taken from the PixelBufferPool. Thread-safe.
+			 */
+			static
+			bool
+			decode(const unsigned char*			data,
+				   std::size_t					size,
+				   uint&						width,
+				   uint&						height,
+				   std::vector<unsigned char>&	rgba);
 
 		private:
-			JPEGParser()
+			JPEGParser() :
+				AbstractImageParser("JPEG", &JPEGParser::decode)
 			{
 			}
 		};
@@ -19,68 +19,59 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 
 #include "JPEGParser.hpp"
 
-#include "minko/file/Options.hpp"
-#include "minko/file/AssetLibrary.hpp"
-#include "minko/render/Texture.hpp"
-#include "minko/render/CubeTexture.hpp"
+#include "minko/render/PixelBufferPool.hpp"
 
 #include "jpgd.h"
 
 using namespace minko;
 using namespace minko::file;
 
-void
-JPEGParser::parse(const std::string&				filename,
-				  const std::string&                resolvedFilename,
-                  std::shared_ptr<Options>          options,
-				  const std::vector<unsigned char>&	data,
-				  std::shared_ptr<AssetLibrary>	AssetLibrary)
+bool
+JPEGParser::decode(const unsigned char*			data,
+				   std::size_t					size,
+				   uint&						width,
+				   uint&						height,
+				   std::vector<unsigned char>&	rgba)
 {
-	int width;
-	int height;
-	int comps;
-
-	// Loads a JPEG image from a memory buffer.
-	// req_comps can be 1 (grayscale), 3 (RGB), or 4 (RGBA).
-	// On return, width/height will be set to the image's dimensions, and actual_comps will be set 
-	// to either 1 (grayscale) or 3 (RGB).
-	auto bmpData = jpgd::decompress_jpeg_image_from_memory(
-		(const unsigned char*)&data[0], data.size(), &width, &height, &comps, 3
-	);
-
-	auto format = render::TextureFormat::RGBA;
-	if (comps == 3 || comps == 1)
-		format	= render::TextureFormat::RGB;
-
-	render::AbstractTexture::Ptr texture = nullptr;
-
-	if (!options->isCubeTexture())
-		texture	= render::Texture::create(
-			options->context(), 
-			width, 
-			height, 
-			options->generateMipmaps(), 
-			false, 
-			options->resizeSmoothly(), 
-			filename
-		);
-	else
-		texture = render::CubeTexture::create(
-			options->context(), 
-			width, 
-			height, 
-			options->generateMipmaps(), 
-			false, 
-			options->resizeSmoothly(), 
-			filename
-		);
-
-	texture->data(bmpData, format);
-	texture->upload();
-
-	AssetLibrary->texture(filename, texture);
-
-	free(bmpData);
-
-	complete()->execute(shared_from_this());
+	if (data == nullptr)
+		return false;
+
+	jpgd::jpeg_decoder_mem_stream	stream(data, (uint)size);
+	jpgd::jpeg_decoder				decoder(&stream);
+
+	if (decoder.get_error_code() != jpgd::JPGD_SUCCESS || decoder.begin_decoding() != jpgd::JPGD_SUCCESS)
+		return false;
+
+	const auto numComponents = decoder.get_num_components();
+
+	width	= decoder.get_width();
+	height	= decoder.get_height();
+	rgba	= render::PixelBufferPool::acquire(width * height * sizeof(int));
+
+	for (uint y = 0; y < height; ++y)
+	{
+		const unsigned char*	scanLine;
+		uint					scanLineSize;
+
+		if (decoder.decode((const void**)&scanLine, &scanLineSize) != jpgd::JPGD_SUCCESS)
+		{
+			render::PixelBufferPool::release(rgba);
+
+			return false;
+		}
+
+		auto dst = &rgba[y * width * sizeof(int)];
+
+		// color scan lines are already RGBA, grayscale ones hold one luma byte per pixel
+		if (numComponents == 3)
+			std::memcpy(dst, scanLine, width * sizeof(int));
+		else
+			for (uint x = 0; x < width; ++x, dst += 4)
+			{
+				dst[0] = dst[1] = dst[2] = scanLine[x];
+				dst[3] = std::numeric_limits<unsigned char>::max();
+			}
+	}
+
+	return true;
 }
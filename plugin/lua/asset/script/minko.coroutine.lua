@@ -44,7 +44,7 @@ function mc.wait(secondsOrSignal, ...)
             end
             mc.WAITING_ON_SIGNAL[co] = nil
 
-            coroutine.resume(co, table.unpack({...}))
+            coroutine.resume(co, (table.unpack or unpack)({...}))
         end
 
         for _, signal in ipairs({secondsOrSignal, ...}) do
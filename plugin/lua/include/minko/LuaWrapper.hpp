@@ -23,6 +23,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/Signal.hpp"
 
 #include "LuaGlue/LuaGlue.h"
+#include "minko/math/LuaMathValue.hpp"
 
 #define MINKO_LUAGLUE_BIND_SIGNAL(state, ...) \
     { \
@@ -24,7 +24,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/component/AbstractScript.hpp"
 
 class LuaGlue;
-class LuaGlueClassBase;
+template<typename _Class>
+class LuaGlueClass;
 
 namespace minko
 {
@@ -54,7 +55,8 @@ namespace minko
             };
 
         private:
-            typedef std::shared_ptr<scene::Node>    NodePtr;
+            typedef std::shared_ptr<scene::Node>        NodePtr;
+            typedef std::shared_ptr<AbstractComponent>  AbsCmpPtr;
 
 
         private:
@@ -62,11 +64,23 @@ namespace minko
             std::string                             _script;
 
             LuaGlue*                                _state;
-            LuaGlueClassBase*                       _class;
-            std::unordered_map<NodePtr, LuaStub*>   _targetToStub;
-            bool                                    _hasStartMethod;
-            bool                                    _hasUpdateMethod;
-            bool                                    _hasStopMethod;
+            LuaGlueClass<LuaStub>*                  _class;
+
+            // references, in the Lua registry, to the methods of the script class looked up once
+            // when the script is loaded and to the function updating all the started targets
+            int                                     _startRef;
+            int                                     _updateRef;
+            int                                     _stopRef;
+            int                                     _updateAllRef;
+
+            // started targets and their stubs, in the order of the Lua tables referenced by
+            // _nodesRef and _stubsRef so that they are pushed only once
+            std::vector<NodePtr>                    _nodes;
+            std::vector<LuaStub*>                   _stubs;
+            std::unordered_map<NodePtr, uint>       _targetToIndex;
+            int                                     _nodesRef;
+            int                                     _stubsRef;
+            bool                                    _batchUpdates;
 
         public:
             static inline
@@ -80,6 +94,24 @@ namespace minko
                 return s;
             }
 
+            /**
+             * Whether the update method is called for all the targets in a single call to Lua,
+             * the default, or with one call per target.
+             */
+            inline
+            bool
+            batchUpdates() const
+            {
+                return _batchUpdates;
+            }
+
+            inline
+            void
+            batchUpdates(bool value)
+            {
+                _batchUpdates = value;
+            }
+
         protected:
             virtual
 			void
@@ -89,6 +121,13 @@ namespace minko
 			void
 			update(NodePtr target);
 
+            /**
+             * Crosses the C++/Lua boundary once for all the started targets.
+             */
+            virtual
+            void
+            updateAll(const std::vector<NodePtr>& targets);
+
             virtual
             void
             stop(NodePtr target);
@@ -97,9 +136,27 @@ namespace minko
             bool
             ready(NodePtr target);
 
+            void
+            targetRemovedHandler(AbsCmpPtr cmp, NodePtr target);
+
         private:
             LuaScript(const std::string& name, const std::string& script);
 
+            void
+            loadScript(NodePtr target);
+
+            int
+            methodReference(const std::string& methodName);
+
+            void
+            addTarget(NodePtr target);
+
+            void
+            removeTarget(NodePtr target);
+
+            void
+            invoke(int methodRef, uint index);
+
             static
             void
             initializeLuaBindings();
@@ -0,0 +1,269 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/math/Vector2.hpp"
+#include "minko/math/Vector3.hpp"
+#include "minko/math/Vector4.hpp"
+#include "minko/math/Quaternion.hpp"
+#include "minko/math/Matrix4x4.hpp"
+
+#include "LuaGlue/LuaGlue.h"
+
+namespace minko
+{
+	namespace math
+	{
+		/*
+		** Describes how a math type is stored inline in a Lua value userdata: its number of
+		** floats, the name of its global table (and of its LuaGlue class if it has one) and
+		** how to copy it from and to the shared framework objects.
+		*/
+		template <typename T>
+		struct LuaMathValueTraits;
+
+		template <>
+		struct LuaMathValueTraits<Vector2>
+		{
+			static const uint size = 2;
+
+			static const char* name() { return "Vector2"; }
+			static const char* components() { return "xy"; }
+
+			static void load(Vector2& v, float* data) { data[0] = v.x(); data[1] = v.y(); }
+			static void store(const float* data, Vector2& v) { v.setTo(data[0], data[1]); }
+			static std::shared_ptr<Vector2> create() { return Vector2::create(); }
+		};
+
+		template <>
+		struct LuaMathValueTraits<Vector3>
+		{
+			static const uint size = 3;
+
+			static const char* name() { return "Vector3"; }
+			static const char* components() { return "xyz"; }
+
+			static void load(Vector3& v, float* data) { data[0] = v.x(); data[1] = v.y(); data[2] = v.z(); }
+			static void store(const float* data, Vector3& v) { v.setTo(data[0], data[1], data[2]); }
+			static std::shared_ptr<Vector3> create() { return Vector3::create(); }
+		};
+
+		template <>
+		struct LuaMathValueTraits<Vector4>
+		{
+			static const uint size = 4;
+
+			static const char* name() { return "Vector4"; }
+			static const char* components() { return "xyzw"; }
+
+			static void load(Vector4& v, float* data) { data[0] = v.x(); data[1] = v.y(); data[2] = v.z(); data[3] = v.w(); }
+			static void store(const float* data, Vector4& v) { v.setTo(data[0], data[1], data[2], data[3]); }
+			static std::shared_ptr<Vector4> create() { return Vector4::create(); }
+		};
+
+		template <>
+		struct LuaMathValueTraits<Quaternion>
+		{
+			static const uint size = 4;
+
+			static const char* name() { return "Quaternion"; }
+			static const char* components() { return "ijkr"; }
+
+			static void load(Quaternion& q, float* data) { data[0] = q.i(); data[1] = q.j(); data[2] = q.k(); data[3] = q.r(); }
+			static void store(const float* data, Quaternion& q) { q.setTo(data[0], data[1], data[2], data[3]); }
+			static std::shared_ptr<Quaternion> create() { return Quaternion::create(); }
+		};
+
+		template <>
+		struct LuaMathValueTraits<Matrix4x4>
+		{
+			static const uint size = 16;
+
+			static const char* name() { return "Matrix4x4"; }
+			static const char* components() { return ""; }
+
+			static void load(Matrix4x4& m, float* data) { std::copy(m.data().begin(), m.data().end(), data); }
+			static void store(const float* data, Matrix4x4& m) { std::copy(data, data + size, m.data().begin()); }
+			static std::shared_ptr<Matrix4x4> create() { return Matrix4x4::create(); }
+		};
+
+		/*
+		** Value semantics math types for Lua. A value is a userdata holding its floats inline,
+		** so creating one is a single Lua allocation and the in-place methods (setTo, add,
+		** scaleBy, appendRotationY...) never allocate. Values are copied into the shared
+		** framework objects only when they cross into a C++ API taking a shared_ptr, such as
+		** Provider::set. Shared objects returned by C++ (a transform matrix, a light color...)
+		** are still pushed as LuaGlue references so that modifying them modifies the original.
+		*/
+		class LuaMathValue
+		{
+		private:
+			static const uint NUM_SHARED_OBJECTS = 8;
+
+		public:
+			static
+			void
+			bind(lua_State* state);
+
+			template <typename T>
+			static
+			float*
+			push(lua_State* state)
+			{
+				auto data = static_cast<float*>(lua_newuserdata(state, LuaMathValueTraits<T>::size * sizeof(float)));
+
+				lua_pushlightuserdata(state, key<T>());
+				lua_rawget(state, LUA_REGISTRYINDEX);
+				lua_setmetatable(state, -2);
+
+				return data;
+			}
+
+			template <typename T>
+			static
+			float*
+			toValue(lua_State* state, int index)
+			{
+				if (lua_type(state, index) != LUA_TUSERDATA || !lua_getmetatable(state, index))
+					return nullptr;
+
+				lua_pushlightuserdata(state, key<T>());
+				lua_rawget(state, LUA_REGISTRYINDEX);
+
+				auto isValue = lua_rawequal(state, -1, -2) != 0;
+
+				lua_pop(state, 2);
+
+				return isValue ? static_cast<float*>(lua_touserdata(state, index)) : nullptr;
+			}
+
+			template <typename T>
+			static
+			T*
+			toReference(lua_State* state, int index)
+			{
+				if (lua_type(state, index) != LUA_TUSERDATA || !lua_getmetatable(state, index))
+					return nullptr;
+
+				luaL_getmetatable(state, LuaMathValueTraits<T>::name());
+
+				auto isReference = lua_rawequal(state, -1, -2) != 0;
+
+				lua_pop(state, 2);
+
+				return isReference
+					? static_cast<LuaGlueObject<std::shared_ptr<T>>*>(lua_touserdata(state, index))->ptr()
+					: nullptr;
+			}
+
+			/*
+			** Copies a value into a shared framework object. The objects are recycled as soon as
+			** nothing but this pool holds them anymore, so passing a value to a C++ method that
+			** does not keep it does not allocate. Lua scripts run on the main thread only.
+			*/
+			template <typename T>
+			static
+			std::shared_ptr<T>
+			toShared(const float* data)
+			{
+				static std::shared_ptr<T>	objects[NUM_SHARED_OBJECTS];
+				static uint					next = 0;
+
+				for (auto& object : objects)
+					if (object && object.use_count() == 1)
+					{
+						LuaMathValueTraits<T>::store(data, *object);
+
+						return object;
+					}
+
+				auto& object = objects[next];
+
+				next = (next + 1) % NUM_SHARED_OBJECTS;
+				object = LuaMathValueTraits<T>::create();
+				LuaMathValueTraits<T>::store(data, *object);
+
+				return object;
+			}
+
+			template <typename T>
+			static
+			void*
+			key()
+			{
+				static char key;
+
+				return &key;
+			}
+
+		private:
+			LuaMathValue();
+		};
+
+		template <typename T>
+		struct LuaMathValueStack
+		{
+			static
+			std::shared_ptr<T>
+			get(LuaGlueBase* g, lua_State* s, int idx)
+			{
+				if (auto value = LuaMathValue::toValue<T>(s, idx))
+					return LuaMathValue::toShared<T>(value);
+
+				if (lua_isnoneornil(s, idx))
+					return nullptr;
+
+				return **static_cast<LuaGlueObject<std::shared_ptr<T>>*>(lua_touserdata(s, idx));
+			}
+
+			static
+			void
+			put(LuaGlueBase* g, lua_State* s, std::shared_ptr<T> v)
+			{
+				auto lgc = static_cast<LuaGlueClass<T>*>(g->lookupClass(typeid(LuaGlueClass<T>).name(), true));
+
+				if (v == nullptr)
+					lua_pushnil(s);
+				else if (lgc)
+					lgc->pushInstance(s, v);
+				else
+					LuaMathValueTraits<T>::load(*v, LuaMathValue::push<T>(s));
+			}
+		};
+	}
+}
+
+template <>
+struct stack<std::shared_ptr<minko::math::Vector2>> : public minko::math::LuaMathValueStack<minko::math::Vector2> {};
+
+template <>
+struct stack<std::shared_ptr<minko::math::Vector3>> : public minko::math::LuaMathValueStack<minko::math::Vector3> {};
+
+template <>
+struct stack<std::shared_ptr<minko::math::Vector4>> : public minko::math::LuaMathValueStack<minko::math::Vector4> {};
+
+template <>
+struct stack<std::shared_ptr<minko::math::Quaternion>> : public minko::math::LuaMathValueStack<minko::math::Quaternion> {};
+
+template <>
+struct stack<std::shared_ptr<minko::math::Matrix4x4>> : public minko::math::LuaMathValueStack<minko::math::Matrix4x4> {};
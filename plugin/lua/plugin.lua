@@ -30,10 +30,39 @@ function minko.plugin.lua:enable()
 
 	includedirs {
 		minko.plugin.path("lua") .. "/include",
-		minko.plugin.path("lua") .. "/lib/lua/include",
 		minko.plugin.path("lua") .. "/lib/LuaGlue/include",
 	}
 
+	if _OPTIONS['with-luajit'] then
+		-- LuaJIT 2.0 is not bundled: its headers and libraries are expected in lib/luajit,
+		-- or installed on the system on Linux and OS X
+		includedirs { minko.plugin.path("lua") .. "/lib/luajit/include" }
+
+		configuration { "windows32" }
+			links { "lua51" }
+			libdirs { minko.plugin.path("lua") .. "/lib/luajit/lib/windows32" }
+
+		configuration { "windows64" }
+			links { "lua51" }
+			libdirs { minko.plugin.path("lua") .. "/lib/luajit/lib/windows64" }
+
+		configuration { "linux32 or linux64 or osx64" }
+			links { "luajit-5.1" }
+			libdirs { minko.plugin.path("lua") .. "/lib/luajit/lib" }
+			includedirs {
+				"/usr/include/luajit-2.0",
+				"/usr/local/include/luajit-2.0"
+			}
+
+		configuration { "osx64" }
+			-- required by LuaJIT on 64 bits OS X
+			linkoptions { "-pagezero_size 10000", "-image_base 100000000" }
+
+		configuration { }
+	else
+		includedirs { minko.plugin.path("lua") .. "/lib/lua/include" }
+	end
+
 	postbuildcommands {
 		minko.action.copy(minko.plugin.path("lua") .. "/asset"),
 	}
@@ -56,3 +85,8 @@ newoption {
 	trigger		= "with-lua",
 	description	= "Enable the Minko Lua plugin."
 }
+
+newoption {
+	trigger		= "with-luajit",
+	description	= "Build the Minko Lua plugin with LuaJIT instead of the bundled Lua 5.2 interpreter."
+}
@@ -10,10 +10,23 @@ minko.project.library("minko-plugin-" .. PROJECT_NAME)
 	includedirs { "lib/LuaGlue/include" }
 	files { "lib/LuaGlue/include/**.h" }
 
-	-- lua
-	files { "lib/lua/src/**.c", "lib/lua/include/**.h" }
-	includedirs { "lib/lua/include" }
-	excludes { "lib/lua/src/luac.c" }
+	if _OPTIONS['with-luajit'] then
+		-- luajit, built separately: see plugin.lua
+		includedirs { "lib/luajit/include" }
+
+		configuration { "linux32 or linux64 or osx64" }
+			includedirs {
+				"/usr/include/luajit-2.0",
+				"/usr/local/include/luajit-2.0"
+			}
+
+		configuration { }
+	else
+		-- lua
+		files { "lib/lua/src/**.c", "lib/lua/include/**.h" }
+		includedirs { "lib/lua/include" }
+		excludes { "lib/lua/src/luac.c" }
+	end
 
 	configuration { "debug" }
 		defines { "LUA_USE_APICHECK" }
@@ -27,12 +27,53 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 using namespace minko;
 using namespace minko::component;
 
+namespace
+{
+    // one call per frame and per script class: the loop runs in the virtual machine and is
+    // compiled by LuaJIT when it is used. An update can remove targets: the last ones then take
+    // the place of the removed ones and the slots past the end are nil, so the targets moved to
+    // a slot that was already visited skip this frame. As with invoke(), an error only stops
+    // the update of its own target
+    const char* UPDATE_ALL_SOURCE =
+        "local update, stubs, nodes = ...\n"
+        "local pcall, print, tostring = pcall, print, tostring\n"
+        "return function(numTargets)\n"
+        "    for i = 1, numTargets do\n"
+        "        local stub = stubs[i]\n"
+        "        if stub == nil then\n"
+        "            return\n"
+        "        end\n"
+        "        local ok, message = pcall(update, stub, nodes[i])\n"
+        "        if not ok then\n"
+        "            print(\"err: \" .. tostring(message))\n"
+        "        end\n"
+        "    end\n"
+        "end\n";
+
+    // Lua errors must not unwind through the C++ frames: they are reported and the frame goes on
+    void
+    protectedCall(lua_State* state, int numArguments)
+    {
+        if (lua_pcall(state, numArguments, 0, 0) != 0)
+        {
+            printf("err: %s\n", lua_tostring(state, -1));
+            lua_pop(state, 1);
+        }
+    }
+}
+
 LuaScript::LuaScript(const std::string& name, const std::string& script) :
     _scriptName(name),
     _script(script),
-    _hasStartMethod(false),
-    _hasUpdateMethod(false),
-    _hasStopMethod(false)
+    _state(nullptr),
+    _class(nullptr),
+    _startRef(LUA_NOREF),
+    _updateRef(LUA_NOREF),
+    _stopRef(LUA_NOREF),
+    _updateAllRef(LUA_NOREF),
+    _nodesRef(LUA_NOREF),
+    _stubsRef(LUA_NOREF),
+    _batchUpdates(true)
 {
 }
 
@@ -43,55 +84,207 @@ LuaScript::ready(scene::Node::Ptr target)
 }
 
 void
-LuaScript::start(scene::Node::Ptr node)
+LuaScript::loadScript(scene::Node::Ptr node)
 {
-    if (!_script.empty())
+    _state = &(node->root()->component<LuaScriptManager>()->_state);
+
+    auto name = _scriptName.c_str();
+    auto state = _state->state();
+
+    _state->Class<LuaStub>(name)
+        .property("running", &LuaStub::running);
+    _class = dynamic_cast<LuaGlueClass<LuaScript::LuaStub>*>(_state->lookupClass(name));
+    _class->glue(_state);
+
+    if(!_state->doString(_script))
+        printf("err: %s\n", _state->lastError().c_str());
+    _script.clear();
+
+    _startRef = methodReference("start");
+    _updateRef = methodReference("update");
+    _stopRef = methodReference("stop");
+
+    lua_createtable(state, 0, 0);
+    lua_pushvalue(state, -1);
+    _stubsRef = luaL_ref(state, LUA_REGISTRYINDEX);
+    lua_createtable(state, 0, 0);
+    lua_pushvalue(state, -1);
+    _nodesRef = luaL_ref(state, LUA_REGISTRYINDEX);
+
+    if (_updateRef != LUA_NOREF)
+    {
+        luaL_loadstring(state, UPDATE_ALL_SOURCE);
+        lua_rawgeti(state, LUA_REGISTRYINDEX, _updateRef);
+        lua_pushvalue(state, -4);
+        lua_pushvalue(state, -4);
+        lua_call(state, 3, 1);
+        _updateAllRef = luaL_ref(state, LUA_REGISTRYINDEX);
+    }
+
+    lua_pop(state, 2);
+}
+
+int
+LuaScript::methodReference(const std::string& methodName)
+{
+    auto state = _state->state();
+
+    lua_getglobal(state, _scriptName.c_str());
+    if (!lua_istable(state, -1))
+    {
+        lua_pop(state, 1);
+
+        return LUA_NOREF;
+    }
+
+    lua_getfield(state, -1, methodName.c_str());
+    lua_remove(state, -2);
+
+    if (!lua_isfunction(state, -1))
     {
-        _state = &(node->root()->component<LuaScriptManager>()->_state);
+        lua_pop(state, 1);
+
+        return LUA_NOREF;
+    }
+
+    return luaL_ref(state, LUA_REGISTRYINDEX);
+}
+
+void
+LuaScript::addTarget(scene::Node::Ptr node)
+{
+    auto state = _state->state();
+    auto stub = new LuaStub();
+    auto index = (int)_nodes.size() + 1;
+
+    _targetToIndex[node] = _nodes.size();
+    _nodes.push_back(node);
+    _stubs.push_back(stub);
 
-        auto name = _scriptName.c_str();
+    lua_rawgeti(state, LUA_REGISTRYINDEX, _stubsRef);
+    _class->pushInstance(state, stub);
+    lua_rawseti(state, -2, index);
+    lua_rawgeti(state, LUA_REGISTRYINDEX, _nodesRef);
+    stack<scene::Node::Ptr>::put(_state, state, node);
+    lua_rawseti(state, -2, index);
+    lua_pop(state, 2);
+}
 
-        _state->Class<LuaStub>(name)
-            .property("running", &LuaStub::running);
-        _class = _state->lookupClass(name);
-        _class->glue(_state);
+void
+LuaScript::removeTarget(scene::Node::Ptr node)
+{
+    auto state = _state->state();
+    auto index = _targetToIndex[node];
+    auto last = (uint)_nodes.size() - 1;
 
-        if(!_state->doString(_script))
-            printf("err: %s\n", _state->lastError().c_str());
-        _script.clear();
+    _stubs[index]->_running = false;
+    delete _stubs[index];
 
-        auto c = dynamic_cast<LuaGlueClass<LuaScript::LuaStub>*>(_class);
-        _hasStartMethod = c->hasMethod("start");
-        _hasUpdateMethod = c->hasMethod("update");
-        _hasStopMethod = c->hasMethod("stop");
+    // the last target takes the place of the removed one, in both C++ and Lua
+    if (index != last)
+    {
+        _nodes[index] = _nodes[last];
+        _stubs[index] = _stubs[last];
+        _targetToIndex[_nodes[index]] = index;
     }
+    _nodes.pop_back();
+    _stubs.pop_back();
+    _targetToIndex.erase(node);
+
+    for (auto tableRef : { _stubsRef, _nodesRef })
+    {
+        lua_rawgeti(state, LUA_REGISTRYINDEX, tableRef);
+        if (index != last)
+        {
+            lua_rawgeti(state, -1, last + 1);
+            lua_rawseti(state, -2, index + 1);
+        }
+        lua_pushnil(state);
+        lua_rawseti(state, -2, last + 1);
+        lua_pop(state, 1);
+    }
+}
+
+void
+LuaScript::invoke(int methodRef, uint index)
+{
+    auto state = _state->state();
+
+    lua_rawgeti(state, LUA_REGISTRYINDEX, methodRef);
+    lua_rawgeti(state, LUA_REGISTRYINDEX, _stubsRef);
+    lua_rawgeti(state, -1, index + 1);
+    lua_remove(state, -2);
+    lua_rawgeti(state, LUA_REGISTRYINDEX, _nodesRef);
+    lua_rawgeti(state, -1, index + 1);
+    lua_remove(state, -2);
+    protectedCall(state, 2);
+}
+
+void
+LuaScript::start(scene::Node::Ptr node)
+{
+    if (!_script.empty())
+        loadScript(node);
 
-    auto stub = _targetToStub.count(node) == 0
-        ? _targetToStub[node] = new LuaStub()
-        : _targetToStub[node];
+    if (_targetToIndex.count(node) == 0)
+        addTarget(node);
 
-    if (_hasStartMethod)
-        dynamic_cast<LuaGlueClass<LuaScript::LuaStub>*>(_class)->invokeVoidMethod("start", stub, node);
+    if (_startRef != LUA_NOREF)
+        invoke(_startRef, _targetToIndex[node]);
 }
 
 void
 LuaScript::update(scene::Node::Ptr node)
 {
-    auto stub = _targetToStub[node];
+    if (_updateRef == LUA_NOREF)
+        return;
+
+    auto indexIt = _targetToIndex.find(node);
 
-    if (_hasUpdateMethod)
-        dynamic_cast<LuaGlueClass<LuaScript::LuaStub>*>(_class)->invokeVoidMethod("update", stub, node);
+    if (indexIt != _targetToIndex.end())
+        invoke(_updateRef, indexIt->second);
+}
+
+void
+LuaScript::updateAll(const std::vector<scene::Node::Ptr>& targets)
+{
+    if (_updateRef == LUA_NOREF)
+        return;
+
+    // every started target is running: when all of them are, the Lua tables are the batch
+    if (!_batchUpdates || targets.size() != _nodes.size())
+    {
+        AbstractScript::updateAll(targets);
+
+        return;
+    }
+
+    auto state = _state->state();
+
+    lua_rawgeti(state, LUA_REGISTRYINDEX, _updateAllRef);
+    lua_pushinteger(state, _nodes.size());
+    protectedCall(state, 1);
 }
 
 void
 LuaScript::stop(scene::Node::Ptr node)
 {
-    auto stub = _targetToStub[node];
+    if (_targetToIndex.count(node) == 0)
+        return;
+
+    _stubs[_targetToIndex[node]]->_running = false;
 
-    _targetToStub[node]->_running = false;
+    if (_stopRef != LUA_NOREF)
+        invoke(_stopRef, _targetToIndex[node]);
 
-    if (_hasStopMethod)
-        dynamic_cast<LuaGlueClass<LuaScript::LuaStub>*>(_class)->invokeVoidMethod("stop", stub, node);
+    removeTarget(node);
+}
+
+void
+LuaScript::targetRemovedHandler(AbsCmpPtr cmp, scene::Node::Ptr target)
+{
+    AbstractScript::targetRemovedHandler(cmp, target);
 
-    delete stub;
+    if (_targetToIndex.count(target) != 0)
+        removeTarget(target);
 }
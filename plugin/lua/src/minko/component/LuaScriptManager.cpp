@@ -76,6 +76,8 @@ LuaScriptManager::initialize()
 		.func("getOption", &LuaContext::getOption);
 
 	_state.open().glue();
+
+	math::LuaMathValue::bind(_state.state());
 }
 
 void
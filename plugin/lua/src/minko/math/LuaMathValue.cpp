@@ -0,0 +1,1162 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/math/LuaMathValue.hpp"
+
+using namespace minko;
+using namespace minko::math;
+
+namespace
+{
+	template <typename T>
+	float
+	defaultComponent(uint i)
+	{
+		return 0.f;
+	}
+
+	template <>
+	float
+	defaultComponent<Vector4>(uint i)
+	{
+		return i == 3 ? 1.f : 0.f;
+	}
+
+	template <>
+	float
+	defaultComponent<Quaternion>(uint i)
+	{
+		return i == 3 ? 1.f : 0.f;
+	}
+
+	// Lua errors are raised with longjmp: arguments are checked before any C++ object is created
+	template <typename T>
+	float*
+	checkValue(lua_State* state, int index)
+	{
+		auto value = LuaMathValue::toValue<T>(state, index);
+
+		if (value == nullptr)
+		{
+			lua_pushfstring(state, "%s value expected", LuaMathValueTraits<T>::name());
+			luaL_argerror(state, index, lua_tostring(state, -1));
+		}
+
+		return value;
+	}
+
+	template <typename T>
+	void
+	checkArgument(lua_State* state, int index)
+	{
+		if (LuaMathValue::toValue<T>(state, index) == nullptr
+			&& LuaMathValue::toReference<T>(state, index) == nullptr)
+		{
+			lua_pushfstring(state, "%s expected", LuaMathValueTraits<T>::name());
+			luaL_argerror(state, index, lua_tostring(state, -1));
+		}
+	}
+
+	// reads a value or a reference, the reference being copied into buffer
+	template <typename T>
+	const float*
+	read(lua_State* state, int index, float* buffer)
+	{
+		checkArgument<T>(state, index);
+
+		if (auto value = LuaMathValue::toValue<T>(state, index))
+			return value;
+
+		LuaMathValueTraits<T>::load(*LuaMathValue::toReference<T>(state, index), buffer);
+
+		return buffer;
+	}
+
+	template <typename T>
+	std::shared_ptr<T>
+	argument(lua_State* state, int index)
+	{
+		if (auto value = LuaMathValue::toValue<T>(state, index))
+			return LuaMathValue::toShared<T>(value);
+
+		return **static_cast<LuaGlueObject<std::shared_ptr<T>>*>(lua_touserdata(state, index));
+	}
+
+	template <typename T>
+	float*
+	copy(lua_State* state, const float* data)
+	{
+		auto value = LuaMathValue::push<T>(state);
+
+		std::copy(data, data + LuaMathValueTraits<T>::size, value);
+
+		return value;
+	}
+
+	// pushes the optional output argument at index, or a new value when it is missing
+	template <typename T>
+	float*
+	pushOutput(lua_State* state, int index)
+	{
+		if (lua_isnoneornil(state, index))
+			return LuaMathValue::push<T>(state);
+
+		auto output = checkValue<T>(state, index);
+
+		lua_pushvalue(state, index);
+
+		return output;
+	}
+
+	// framework object the Matrix4x4 and Quaternion values are loaded into to reuse its math
+	template <typename T>
+	const std::shared_ptr<T>&
+	scratch(const float* data)
+	{
+		static auto object = LuaMathValueTraits<T>::create();
+
+		LuaMathValueTraits<T>::store(data, *object);
+
+		return object;
+	}
+
+	int
+	self(lua_State* state)
+	{
+		lua_settop(state, 1);
+
+		return 1;
+	}
+
+	void
+	setFunctions(lua_State* state, int table, const luaL_Reg* functions)
+	{
+		for (; functions->name != nullptr; ++functions)
+		{
+			lua_pushstring(state, functions->name);
+			lua_pushcfunction(state, functions->func);
+			lua_rawset(state, table);
+		}
+	}
+
+	template <typename T>
+	int
+	component(const char* key, size_t length)
+	{
+		auto components = LuaMathValueTraits<T>::components();
+
+		if (length != 1 || key[0] == 0)
+			return -1;
+
+		auto c = std::strchr(components, key[0]);
+
+		return c != nullptr ? static_cast<int>(c - components) : -1;
+	}
+
+	template <typename T>
+	int
+	index(lua_State* state)
+	{
+		auto	data	= static_cast<float*>(lua_touserdata(state, 1));
+		size_t	length	= 0;
+
+		if (lua_type(state, 2) == LUA_TSTRING)
+		{
+			auto key	= lua_tolstring(state, 2, &length);
+			auto c		= component<T>(key, length);
+
+			if (c >= 0)
+			{
+				lua_pushnumber(state, data[c]);
+
+				return 1;
+			}
+		}
+
+		lua_pushvalue(state, 2);
+		lua_rawget(state, lua_upvalueindex(1));
+
+		return 1;
+	}
+
+	template <typename T>
+	int
+	newIndex(lua_State* state)
+	{
+		auto	data	= static_cast<float*>(lua_touserdata(state, 1));
+		size_t	length	= 0;
+		auto	key		= lua_type(state, 2) == LUA_TSTRING ? lua_tolstring(state, 2, &length) : nullptr;
+		auto	c		= key != nullptr ? component<T>(key, length) : -1;
+
+		if (c < 0)
+			return luaL_argerror(state, 2, "unknown component");
+
+		data[c] = static_cast<float>(luaL_checknumber(state, 3));
+
+		return 0;
+	}
+
+	template <typename T>
+	int
+	create(lua_State* state)
+	{
+		float value[LuaMathValueTraits<T>::size];
+
+		for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+			value[i] = static_cast<float>(luaL_optnumber(state, i + 1, defaultComponent<T>(i)));
+
+		copy<T>(state, value);
+
+		return 1;
+	}
+
+	template <typename T>
+	int
+	constant(lua_State* state)
+	{
+		auto value = LuaMathValue::push<T>(state);
+
+		for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+			value[i] = static_cast<float>(lua_tonumber(state, lua_upvalueindex(i + 1)));
+
+		return 1;
+	}
+
+	template <typename T>
+	void
+	setConstant(lua_State* state, int table, const char* name, std::initializer_list<float> values)
+	{
+		lua_pushstring(state, name);
+		for (auto value : values)
+			lua_pushnumber(state, value);
+		lua_pushcclosure(state, &constant<T>, static_cast<int>(values.size()));
+		lua_rawset(state, table);
+	}
+
+	template <typename T>
+	int
+	setTo(lua_State* state)
+	{
+		auto data = checkValue<T>(state, 1);
+
+		for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+			data[i] = static_cast<float>(luaL_checknumber(state, i + 2));
+
+		return self(state);
+	}
+
+	template <typename T>
+	int
+	copyFrom(lua_State* state)
+	{
+		float	buffer[LuaMathValueTraits<T>::size];
+		auto	data	= checkValue<T>(state, 1);
+		auto	source	= read<T>(state, 2, buffer);
+
+		std::copy(source, source + LuaMathValueTraits<T>::size, data);
+
+		return self(state);
+	}
+
+	template <typename T>
+	int
+	clone(lua_State* state)
+	{
+		copy<T>(state, checkValue<T>(state, 1));
+
+		return 1;
+	}
+
+	template <typename T>
+	int
+	equals(lua_State* state)
+	{
+		float	buffer1[LuaMathValueTraits<T>::size];
+		float	buffer2[LuaMathValueTraits<T>::size];
+		auto	a		= read<T>(state, 1, buffer1);
+		auto	b		= read<T>(state, 2, buffer2);
+
+		lua_pushboolean(state, std::equal(a, a + LuaMathValueTraits<T>::size, b));
+
+		return 1;
+	}
+
+	template <typename T>
+	int
+	toString(lua_State* state)
+	{
+		auto				data	= checkValue<T>(state, 1);
+		std::stringstream	stream;
+
+		stream << "(";
+		for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+			stream << (i != 0 ? ", " : "") << data[i];
+		stream << ")";
+
+		lua_pushstring(state, stream.str().c_str());
+
+		return 1;
+	}
+
+	// vectors
+
+	template <typename T>
+	int
+	add(lua_State* state)
+	{
+		float	buffer[LuaMathValueTraits<T>::size];
+		auto	data	= checkValue<T>(state, 1);
+
+		if (lua_type(state, 2) == LUA_TNUMBER)
+			for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+				data[i] += static_cast<float>(luaL_optnumber(state, i + 2, 0.));
+		else
+		{
+			auto value = read<T>(state, 2, buffer);
+
+			for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+				data[i] += value[i];
+		}
+
+		return self(state);
+	}
+
+	template <typename T>
+	int
+	subtract(lua_State* state)
+	{
+		float	buffer[LuaMathValueTraits<T>::size];
+		auto	data	= checkValue<T>(state, 1);
+
+		if (lua_type(state, 2) == LUA_TNUMBER)
+			for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+				data[i] -= static_cast<float>(luaL_optnumber(state, i + 2, 0.));
+		else
+		{
+			auto value = read<T>(state, 2, buffer);
+
+			for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+				data[i] -= value[i];
+		}
+
+		return self(state);
+	}
+
+	template <typename T>
+	int
+	scaleBy(lua_State* state)
+	{
+		auto data	= checkValue<T>(state, 1);
+		auto scale	= static_cast<float>(luaL_checknumber(state, 2));
+
+		for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+			data[i] *= scale;
+
+		return self(state);
+	}
+
+	template <typename T>
+	float
+	lengthSquared(const float* data)
+	{
+		auto sum = 0.f;
+
+		for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+			sum += data[i] * data[i];
+
+		return sum;
+	}
+
+	template <typename T>
+	int
+	lengthSquared(lua_State* state)
+	{
+		lua_pushnumber(state, lengthSquared<T>(checkValue<T>(state, 1)));
+
+		return 1;
+	}
+
+	template <typename T>
+	int
+	length(lua_State* state)
+	{
+		lua_pushnumber(state, sqrtf(lengthSquared<T>(checkValue<T>(state, 1))));
+
+		return 1;
+	}
+
+	template <typename T>
+	int
+	normalize(lua_State* state)
+	{
+		auto data	= checkValue<T>(state, 1);
+		auto l		= sqrtf(lengthSquared<T>(data));
+
+		if (l != 0.)
+			for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+				data[i] /= l;
+
+		return self(state);
+	}
+
+	template <typename T>
+	int
+	dot(lua_State* state)
+	{
+		float	buffer[LuaMathValueTraits<T>::size];
+		auto	data	= checkValue<T>(state, 1);
+		auto	value	= read<T>(state, 2, buffer);
+		auto	sum		= 0.f;
+
+		for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+			sum += data[i] * value[i];
+		lua_pushnumber(state, sum);
+
+		return 1;
+	}
+
+	template <typename T>
+	int
+	lerp(lua_State* state)
+	{
+		float	buffer[LuaMathValueTraits<T>::size];
+		auto	data	= checkValue<T>(state, 1);
+		auto	target	= read<T>(state, 2, buffer);
+		auto	ratio	= static_cast<float>(luaL_checknumber(state, 3));
+
+		for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+			data[i] = data[i] + (target[i] - data[i]) * ratio;
+
+		return self(state);
+	}
+
+	int
+	cross(lua_State* state)
+	{
+		float	buffer[3];
+		auto	data	= checkValue<Vector3>(state, 1);
+		auto	value	= read<Vector3>(state, 2, buffer);
+		auto	x		= data[1] * value[2] - data[2] * value[1];
+		auto	y		= data[2] * value[0] - data[0] * value[2];
+		auto	z		= data[0] * value[1] - data[1] * value[0];
+
+		data[0] = x;
+		data[1] = y;
+		data[2] = z;
+
+		return self(state);
+	}
+
+	// operators return a new value, their in-place counterparts do not allocate
+
+	template <typename T>
+	int
+	addOperator(lua_State* state)
+	{
+		float	buffer1[LuaMathValueTraits<T>::size];
+		float	buffer2[LuaMathValueTraits<T>::size];
+		auto	a		= read<T>(state, 1, buffer1);
+		auto	b		= read<T>(state, 2, buffer2);
+		auto	result	= LuaMathValue::push<T>(state);
+
+		for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+			result[i] = a[i] + b[i];
+
+		return 1;
+	}
+
+	template <typename T>
+	int
+	subtractOperator(lua_State* state)
+	{
+		float	buffer1[LuaMathValueTraits<T>::size];
+		float	buffer2[LuaMathValueTraits<T>::size];
+		auto	a		= read<T>(state, 1, buffer1);
+		auto	b		= read<T>(state, 2, buffer2);
+		auto	result	= LuaMathValue::push<T>(state);
+
+		for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+			result[i] = a[i] - b[i];
+
+		return 1;
+	}
+
+	// vector * number, number * vector or component-wise product
+	template <typename T>
+	int
+	multiplyOperator(lua_State* state)
+	{
+		float	buffer1[LuaMathValueTraits<T>::size];
+		float	buffer2[LuaMathValueTraits<T>::size];
+
+		auto scalarA	= lua_type(state, 1) == LUA_TNUMBER;
+		auto scalarB	= lua_type(state, 2) == LUA_TNUMBER;
+		auto a			= scalarA ? nullptr : read<T>(state, 1, buffer1);
+		auto b			= scalarB ? nullptr : read<T>(state, 2, buffer2);
+		auto result		= LuaMathValue::push<T>(state);
+
+		for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+			result[i] = (scalarA ? static_cast<float>(lua_tonumber(state, 1)) : a[i])
+				* (scalarB ? static_cast<float>(lua_tonumber(state, 2)) : b[i]);
+
+		return 1;
+	}
+
+	template <typename T>
+	int
+	divideOperator(lua_State* state)
+	{
+		float	buffer[LuaMathValueTraits<T>::size];
+		auto	a		= read<T>(state, 1, buffer);
+		auto	divisor	= static_cast<float>(luaL_checknumber(state, 2));
+		auto	result	= LuaMathValue::push<T>(state);
+
+		for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+			result[i] = a[i] / divisor;
+
+		return 1;
+	}
+
+	template <typename T>
+	int
+	negateOperator(lua_State* state)
+	{
+		auto a		= checkValue<T>(state, 1);
+		auto result	= LuaMathValue::push<T>(state);
+
+		for (uint i = 0; i < LuaMathValueTraits<T>::size; ++i)
+			result[i] = -a[i];
+
+		return 1;
+	}
+
+	// quaternions
+
+	int
+	quaternionIdentity(lua_State* state)
+	{
+		auto data = checkValue<Quaternion>(state, 1);
+
+		LuaMathValueTraits<Quaternion>::load(*scratch<Quaternion>(data)->identity(), data);
+
+		return self(state);
+	}
+
+	int
+	quaternionInitialize(lua_State* state)
+	{
+		auto data		= checkValue<Quaternion>(state, 1);
+		auto radians	= static_cast<float>(luaL_checknumber(state, 2));
+
+		checkArgument<Vector3>(state, 3);
+		LuaMathValueTraits<Quaternion>::load(
+			*scratch<Quaternion>(data)->initialize(radians, argument<Vector3>(state, 3)),
+			data
+		);
+
+		return self(state);
+	}
+
+	int
+	quaternionInvert(lua_State* state)
+	{
+		auto data = checkValue<Quaternion>(state, 1);
+
+		LuaMathValueTraits<Quaternion>::load(*scratch<Quaternion>(data)->invert(), data);
+
+		return self(state);
+	}
+
+	int
+	quaternionNormalize(lua_State* state)
+	{
+		auto data = checkValue<Quaternion>(state, 1);
+
+		LuaMathValueTraits<Quaternion>::load(*scratch<Quaternion>(data)->normalize(), data);
+
+		return self(state);
+	}
+
+	int
+	quaternionLength(lua_State* state)
+	{
+		lua_pushnumber(state, scratch<Quaternion>(checkValue<Quaternion>(state, 1))->length());
+
+		return 1;
+	}
+
+	int
+	quaternionSlerp(lua_State* state)
+	{
+		auto data	= checkValue<Quaternion>(state, 1);
+		auto target	= checkValue<Quaternion>(state, 2);
+		auto ratio	= static_cast<float>(luaL_checknumber(state, 3));
+
+		LuaMathValueTraits<Quaternion>::load(
+			*scratch<Quaternion>(data)->slerp(LuaMathValue::toShared<Quaternion>(target), ratio),
+			data
+		);
+
+		return self(state);
+	}
+
+	int
+	quaternionFromMatrix(lua_State* state)
+	{
+		auto data = checkValue<Quaternion>(state, 1);
+
+		checkArgument<Matrix4x4>(state, 2);
+		LuaMathValueTraits<Quaternion>::load(
+			*scratch<Quaternion>(data)->fromMatrix(argument<Matrix4x4>(state, 2)),
+			data
+		);
+
+		return self(state);
+	}
+
+	// writes into the matrix value passed as second argument or into a new one
+	int
+	quaternionToMatrix(lua_State* state)
+	{
+		static auto matrix = Matrix4x4::create();
+
+		auto data	= checkValue<Quaternion>(state, 1);
+		auto output	= pushOutput<Matrix4x4>(state, 2);
+
+		LuaMathValueTraits<Matrix4x4>::load(*scratch<Quaternion>(data)->toMatrix(matrix), output);
+
+		return 1;
+	}
+
+	// matrices
+
+	typedef Matrix4x4::Ptr (Matrix4x4::*MatrixMethod)();
+	typedef Matrix4x4::Ptr (Matrix4x4::*MatrixScalarMethod)(float);
+	typedef Matrix4x4::Ptr (Matrix4x4::*MatrixVectorMethod)(float, float, float);
+
+	template <MatrixMethod Method>
+	int
+	matrixMethod(lua_State* state)
+	{
+		auto data = checkValue<Matrix4x4>(state, 1);
+
+		LuaMathValueTraits<Matrix4x4>::load(*(scratch<Matrix4x4>(data).get()->*Method)(), data);
+
+		return self(state);
+	}
+
+	template <MatrixScalarMethod Method>
+	int
+	matrixScalarMethod(lua_State* state)
+	{
+		auto data	= checkValue<Matrix4x4>(state, 1);
+		auto value	= static_cast<float>(luaL_checknumber(state, 2));
+
+		LuaMathValueTraits<Matrix4x4>::load(*(scratch<Matrix4x4>(data).get()->*Method)(value), data);
+
+		return self(state);
+	}
+
+	// accepts (x, y, z) or a vector
+	template <MatrixVectorMethod Method>
+	int
+	matrixVectorMethod(lua_State* state)
+	{
+		float	buffer[3];
+		auto	data	= checkValue<Matrix4x4>(state, 1);
+		auto	xyz		= buffer;
+
+		if (lua_type(state, 2) == LUA_TNUMBER)
+		{
+			buffer[0] = static_cast<float>(luaL_checknumber(state, 2));
+			buffer[1] = static_cast<float>(luaL_optnumber(state, 3, 0.));
+			buffer[2] = static_cast<float>(luaL_optnumber(state, 4, 0.));
+		}
+		else
+			xyz = const_cast<float*>(read<Vector3>(state, 2, buffer));
+
+		LuaMathValueTraits<Matrix4x4>::load(
+			*(scratch<Matrix4x4>(data).get()->*Method)(xyz[0], xyz[1], xyz[2]),
+			data
+		);
+
+		return self(state);
+	}
+
+	// the rotation matrix of a quaternion value or a matrix, without allocating
+	const std::shared_ptr<Matrix4x4>&
+	matrixArgument(lua_State* state, int index)
+	{
+		static auto matrix = Matrix4x4::create();
+
+		float buffer[16];
+
+		if (auto quaternion = LuaMathValue::toValue<Quaternion>(state, index))
+			scratch<Quaternion>(quaternion)->toMatrix(matrix);
+		else
+			LuaMathValueTraits<Matrix4x4>::store(read<Matrix4x4>(state, index, buffer), *matrix);
+
+		return matrix;
+	}
+
+	int
+	matrixAppend(lua_State* state)
+	{
+		auto data = checkValue<Matrix4x4>(state, 1);
+
+		if (LuaMathValue::toValue<Quaternion>(state, 2) == nullptr)
+			checkArgument<Matrix4x4>(state, 2);
+		LuaMathValueTraits<Matrix4x4>::load(*scratch<Matrix4x4>(data)->append(matrixArgument(state, 2)), data);
+
+		return self(state);
+	}
+
+	int
+	matrixPrepend(lua_State* state)
+	{
+		auto data = checkValue<Matrix4x4>(state, 1);
+
+		if (LuaMathValue::toValue<Quaternion>(state, 2) == nullptr)
+			checkArgument<Matrix4x4>(state, 2);
+		LuaMathValueTraits<Matrix4x4>::load(*scratch<Matrix4x4>(data)->prepend(matrixArgument(state, 2)), data);
+
+		return self(state);
+	}
+
+	template <bool Append>
+	int
+	matrixRotation(lua_State* state)
+	{
+		static auto rotation	= Quaternion::create();
+		static auto matrix		= Matrix4x4::create();
+
+		auto data		= checkValue<Matrix4x4>(state, 1);
+		auto radians	= static_cast<float>(luaL_checknumber(state, 2));
+
+		checkArgument<Vector3>(state, 3);
+		rotation->initialize(radians, argument<Vector3>(state, 3))->toMatrix(matrix);
+
+		auto& m = scratch<Matrix4x4>(data);
+
+		LuaMathValueTraits<Matrix4x4>::load(*(Append ? m->append(matrix) : m->prepend(matrix)), data);
+
+		return self(state);
+	}
+
+	int
+	matrixInitialize(lua_State* state)
+	{
+		auto data = checkValue<Matrix4x4>(state, 1);
+
+		for (uint i = 0; i < 16; ++i)
+			data[i] = static_cast<float>(luaL_checknumber(state, i + 2));
+
+		return self(state);
+	}
+
+	int
+	matrixCreate(lua_State* state)
+	{
+		float data[] = { 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f };
+
+		if (lua_gettop(state) != 0)
+			for (uint i = 0; i < 16; ++i)
+				data[i] = static_cast<float>(luaL_checknumber(state, i + 1));
+
+		copy<Matrix4x4>(state, data);
+
+		return 1;
+	}
+
+	int
+	matrixTranslation(lua_State* state)
+	{
+		float	buffer[3];
+		auto	data	= checkValue<Matrix4x4>(state, 1);
+		auto	xyz		= buffer;
+
+		if (lua_type(state, 2) == LUA_TNUMBER)
+			for (uint i = 0; i < 3; ++i)
+				buffer[i] = static_cast<float>(luaL_checknumber(state, i + 2));
+		else
+			xyz = const_cast<float*>(read<Vector3>(state, 2, buffer));
+
+		data[3]		= xyz[0];
+		data[7]		= xyz[1];
+		data[11]	= xyz[2];
+
+		return self(state);
+	}
+
+	int
+	matrixGetTranslation(lua_State* state)
+	{
+		auto data			= checkValue<Matrix4x4>(state, 1);
+		auto translation	= LuaMathValue::push<Vector3>(state);
+
+		translation[0] = data[3];
+		translation[1] = data[7];
+		translation[2] = data[11];
+
+		return 1;
+	}
+
+	// writes into the vector passed as last argument or into a new one
+	template <bool Delta>
+	int
+	matrixTransform(lua_State* state)
+	{
+		float	buffer[3];
+		auto	m		= checkValue<Matrix4x4>(state, 1);
+		auto	v		= read<Vector3>(state, 2, buffer);
+		auto	t		= Delta ? 0.f : 1.f;
+		auto	x		= v[0] * m[0] + v[1] * m[1] + v[2] * m[2] + m[3] * t;
+		auto	y		= v[0] * m[4] + v[1] * m[5] + v[2] * m[6] + m[7] * t;
+		auto	z		= v[0] * m[8] + v[1] * m[9] + v[2] * m[10] + m[11] * t;
+		auto	output	= pushOutput<Vector3>(state, 3);
+
+		output[0] = x;
+		output[1] = y;
+		output[2] = z;
+
+		return 1;
+	}
+
+	int
+	matrixCopyTranslation(lua_State* state)
+	{
+		auto data		= checkValue<Matrix4x4>(state, 1);
+		auto output		= checkValue<Vector3>(state, 2);
+
+		output[0] = data[3];
+		output[1] = data[7];
+		output[2] = data[11];
+
+		lua_settop(state, 2);
+
+		return 1;
+	}
+
+	int
+	matrixLookAt(lua_State* state)
+	{
+		auto data = checkValue<Matrix4x4>(state, 1);
+
+		checkArgument<Vector3>(state, 2);
+		if (!lua_isnoneornil(state, 3))
+			checkArgument<Vector3>(state, 3);
+		if (!lua_isnoneornil(state, 4))
+			checkArgument<Vector3>(state, 4);
+
+		auto error = false;
+
+		try
+		{
+			auto& m = scratch<Matrix4x4>(data);
+
+			m->lookAt(
+				argument<Vector3>(state, 2),
+				lua_isnoneornil(state, 3) ? nullptr : argument<Vector3>(state, 3),
+				lua_isnoneornil(state, 4) ? nullptr : argument<Vector3>(state, 4)
+			);
+			LuaMathValueTraits<Matrix4x4>::load(*m, data);
+		}
+		catch (const std::invalid_argument& e)
+		{
+			lua_pushstring(state, e.what());
+			error = true;
+		}
+
+		if (error)
+			return lua_error(state);
+
+		return self(state);
+	}
+
+	int
+	matrixLerp(lua_State* state)
+	{
+		float	buffer[16];
+		auto	data	= checkValue<Matrix4x4>(state, 1);
+		auto	target	= read<Matrix4x4>(state, 2, buffer);
+		auto	ratio	= static_cast<float>(luaL_checknumber(state, 3));
+
+		for (uint i = 0; i < 16; ++i)
+			data[i] = data[i] + (target[i] - data[i]) * ratio;
+
+		return self(state);
+	}
+
+	int
+	matrixDeterminant(lua_State* state)
+	{
+		lua_pushnumber(state, scratch<Matrix4x4>(checkValue<Matrix4x4>(state, 1))->determinant());
+
+		return 1;
+	}
+
+	int
+	matrixFromQuaternion(lua_State* state)
+	{
+		auto data		= checkValue<Matrix4x4>(state, 1);
+		auto quaternion	= checkValue<Quaternion>(state, 2);
+
+		LuaMathValueTraits<Matrix4x4>::load(*scratch<Quaternion>(quaternion)->toMatrix(scratch<Matrix4x4>(data)), data);
+
+		return self(state);
+	}
+
+	// writes into the quaternion passed as second argument or into a new one
+	int
+	matrixRotationQuaternion(lua_State* state)
+	{
+		static auto rotation = Quaternion::create();
+
+		auto data	= checkValue<Matrix4x4>(state, 1);
+		auto output	= pushOutput<Quaternion>(state, 2);
+
+		LuaMathValueTraits<Quaternion>::load(*scratch<Matrix4x4>(data)->rotationQuaternion(rotation), output);
+
+		return 1;
+	}
+
+	int
+	matrixToString(lua_State* state)
+	{
+		auto string = scratch<Matrix4x4>(checkValue<Matrix4x4>(state, 1))->toString();
+
+		lua_pushstring(state, string.c_str());
+
+		return 1;
+	}
+
+	// same as the framework operator: a copy of the left operand with the right one prepended
+	int
+	matrixMultiplyOperator(lua_State* state)
+	{
+		float	buffer[16];
+		auto	a		= read<Matrix4x4>(state, 1, buffer);
+
+		checkArgument<Matrix4x4>(state, 2);
+
+		auto	result	= LuaMathValue::push<Matrix4x4>(state);
+
+		LuaMathValueTraits<Matrix4x4>::load(*scratch<Matrix4x4>(a)->prepend(matrixArgument(state, 2)), result);
+
+		return 1;
+	}
+
+	template <typename T>
+	void
+	bindValue(lua_State*		state,
+			  const luaL_Reg*	methods,
+			  const luaL_Reg*	extraMethods,
+			  const luaL_Reg*	metamethods)
+	{
+		lua_pushlightuserdata(state, LuaMathValue::key<T>());
+		lua_newtable(state);
+		setFunctions(state, lua_gettop(state), metamethods);
+
+		lua_pushstring(state, "__index");
+		lua_newtable(state);
+		setFunctions(state, lua_gettop(state), methods);
+		if (extraMethods != nullptr)
+			setFunctions(state, lua_gettop(state), extraMethods);
+		lua_pushcclosure(state, &index<T>, 1);
+		lua_rawset(state, -3);
+
+		lua_pushstring(state, "__newindex");
+		lua_pushcfunction(state, &newIndex<T>);
+		lua_rawset(state, -3);
+
+		lua_rawset(state, LUA_REGISTRYINDEX);
+	}
+
+	// the global table is the one of the LuaGlue class when there is one, fields are set raw
+	// to bypass its metatable
+	template <typename T>
+	int
+	globalTable(lua_State* state)
+	{
+		lua_getglobal(state, LuaMathValueTraits<T>::name());
+
+		if (lua_isnil(state, -1))
+		{
+			lua_pop(state, 1);
+			lua_newtable(state);
+			lua_pushvalue(state, -1);
+			lua_setglobal(state, LuaMathValueTraits<T>::name());
+		}
+
+		return lua_gettop(state);
+	}
+
+	template <typename T>
+	void
+	bindVector(lua_State* state, const luaL_Reg* extraMethods)
+	{
+		const luaL_Reg methods[] = {
+			{ "setTo",			&setTo<T> },
+			{ "copyFrom",		&copyFrom<T> },
+			{ "clone",			&clone<T> },
+			{ "equals",			&equals<T> },
+			{ "toString",		&toString<T> },
+			{ "add",			&add<T> },
+			{ "subtract",		&subtract<T> },
+			{ "scaleBy",		&scaleBy<T> },
+			{ "normalize",		&normalize<T> },
+			{ "length",			&length<T> },
+			{ "lengthSquared",	&lengthSquared<T> },
+			{ "dot",			&dot<T> },
+			{ "lerp",			&lerp<T> },
+			{ nullptr,			nullptr }
+		};
+		const luaL_Reg metamethods[] = {
+			{ "__add",			&addOperator<T> },
+			{ "__sub",			&subtractOperator<T> },
+			{ "__mul",			&multiplyOperator<T> },
+			{ "__div",			&divideOperator<T> },
+			{ "__unm",			&negateOperator<T> },
+			{ "__eq",			&equals<T> },
+			{ "__tostring",		&toString<T> },
+			{ nullptr,			nullptr }
+		};
+
+		bindValue<T>(state, methods, extraMethods, metamethods);
+
+		auto table = globalTable<T>(state);
+
+		lua_pushstring(state, "create");
+		lua_pushcfunction(state, &create<T>);
+		lua_rawset(state, table);
+		lua_pop(state, 1);
+	}
+}
+
+void
+LuaMathValue::bind(lua_State* state)
+{
+	const luaL_Reg vector3Methods[] = {
+		{ "cross",				&cross },
+		{ nullptr,				nullptr }
+	};
+
+	bindVector<Vector2>(state, nullptr);
+	bindVector<Vector3>(state, vector3Methods);
+	bindVector<Vector4>(state, nullptr);
+
+	auto vector3 = globalTable<Vector3>(state);
+	auto maximum = std::numeric_limits<float>::max();
+
+	setConstant<Vector3>(state, vector3, "zero",		{ 0.f, 0.f, 0.f });
+	setConstant<Vector3>(state, vector3, "one",			{ 1.f, 1.f, 1.f });
+	setConstant<Vector3>(state, vector3, "up",			{ 0.f, 1.f, 0.f });
+	setConstant<Vector3>(state, vector3, "forward",		{ 0.f, 0.f, -1.f });
+	setConstant<Vector3>(state, vector3, "xAxis",		{ 1.f, 0.f, 0.f });
+	setConstant<Vector3>(state, vector3, "yAxis",		{ 0.f, 1.f, 0.f });
+	setConstant<Vector3>(state, vector3, "zAxis",		{ 0.f, 0.f, 1.f });
+	setConstant<Vector3>(state, vector3, "min",			{ -maximum, -maximum, -maximum });
+	setConstant<Vector3>(state, vector3, "max",			{ maximum, maximum, maximum });
+	lua_pop(state, 1);
+
+	const luaL_Reg quaternionMethods[] = {
+		{ "setTo",				&setTo<Quaternion> },
+		{ "copyFrom",			&copyFrom<Quaternion> },
+		{ "clone",				&clone<Quaternion> },
+		{ "equals",				&equals<Quaternion> },
+		{ "toString",			&toString<Quaternion> },
+		{ "identity",			&quaternionIdentity },
+		{ "initialize",			&quaternionInitialize },
+		{ "invert",				&quaternionInvert },
+		{ "normalize",			&quaternionNormalize },
+		{ "length",				&quaternionLength },
+		{ "slerp",				&quaternionSlerp },
+		{ "fromMatrix",			&quaternionFromMatrix },
+		{ "toMatrix",			&quaternionToMatrix },
+		{ nullptr,				nullptr }
+	};
+	const luaL_Reg quaternionMetamethods[] = {
+		{ "__eq",				&equals<Quaternion> },
+		{ "__tostring",			&toString<Quaternion> },
+		{ nullptr,				nullptr }
+	};
+
+	bindValue<Quaternion>(state, quaternionMethods, nullptr, quaternionMetamethods);
+
+	auto quaternion = globalTable<Quaternion>(state);
+
+	lua_pushstring(state, "create");
+	lua_pushcfunction(state, &create<Quaternion>);
+	lua_rawset(state, quaternion);
+	lua_pop(state, 1);
+
+	const luaL_Reg matrixMethods[] = {
+		{ "copyFrom",				&copyFrom<Matrix4x4> },
+		{ "clone",					&clone<Matrix4x4> },
+		{ "equals",					&equals<Matrix4x4> },
+		{ "toString",				&matrixToString },
+		{ "initialize",				&matrixInitialize },
+		{ "identity",				&matrixMethod<&Matrix4x4::identity> },
+		{ "invert",					&matrixMethod<&Matrix4x4::invert> },
+		{ "transpose",				&matrixMethod<&Matrix4x4::transpose> },
+		{ "append",					&matrixAppend },
+		{ "prepend",				&matrixPrepend },
+		{ "appendTranslation",		&matrixVectorMethod<&Matrix4x4::appendTranslation> },
+		{ "prependTranslation",		&matrixVectorMethod<&Matrix4x4::prependTranslation> },
+		{ "appendScale",			&matrixVectorMethod<&Matrix4x4::appendScale> },
+		{ "prependScale",			&matrixVectorMethod<&Matrix4x4::prependScale> },
+		{ "appendUniformScale",		&matrixScalarMethod<&Matrix4x4::appendScale> },
+		{ "prependUniformScale",	&matrixScalarMethod<&Matrix4x4::prependScale> },
+		{ "appendRotationX",		&matrixScalarMethod<&Matrix4x4::appendRotationX> },
+		{ "appendRotationY",		&matrixScalarMethod<&Matrix4x4::appendRotationY> },
+		{ "appendRotationZ",		&matrixScalarMethod<&Matrix4x4::appendRotationZ> },
+		{ "prependRotationX",		&matrixScalarMethod<&Matrix4x4::prependRotationX> },
+		{ "prependRotationY",		&matrixScalarMethod<&Matrix4x4::prependRotationY> },
+		{ "prependRotationZ",		&matrixScalarMethod<&Matrix4x4::prependRotationZ> },
+		{ "appendRotation",			&matrixRotation<true> },
+		{ "prependRotation",		&matrixRotation<false> },
+		{ "translation",			&matrixTranslation },
+		{ "getTranslation",			&matrixGetTranslation },
+		{ "copyTranslation",		&matrixCopyTranslation },
+		{ "transform",				&matrixTransform<false> },
+		{ "deltaTransform",			&matrixTransform<true> },
+		{ "lookAt",					&matrixLookAt },
+		{ "lerp",					&matrixLerp },
+		{ "determinant",			&matrixDeterminant },
+		{ "fromQuaternion",			&matrixFromQuaternion },
+		{ "rotationQuaternion",		&matrixRotationQuaternion },
+		{ nullptr,					nullptr }
+	};
+	const luaL_Reg matrixMetamethods[] = {
+		{ "__mul",					&matrixMultiplyOperator },
+		{ "__eq",					&equals<Matrix4x4> },
+		{ "__tostring",				&matrixToString },
+		{ nullptr,					nullptr }
+	};
+
+	bindValue<Matrix4x4>(state, matrixMethods, nullptr, matrixMetamethods);
+
+	auto matrix = globalTable<Matrix4x4>(state);
+
+	lua_pushstring(state, "create");
+	lua_pushcfunction(state, &matrixCreate);
+	lua_rawset(state, matrix);
+	lua_pop(state, 1);
+}
@@ -36,7 +36,6 @@ namespace minko
 			bind(LuaGlue& state)
 			{
 				state.Class<Matrix4x4>("Matrix4x4")
-		            .method("create",               static_cast<Matrix4x4::Ptr (*)()>(&Matrix4x4::create))
 					.method("copyFrom",				&Matrix4x4::copyFrom)
 		            .method("lookAt",               &Matrix4x4::lookAt)
 		            .method("identity",             &Matrix4x4::identity)
@@ -60,7 +59,8 @@ namespace minko
 		            .method("prependRotation",      &Matrix4x4::prependRotation)
 		            .method("prependTranslation",   static_cast<Matrix4x4::Ptr(Matrix4x4::*)(float, float, float)>(&Matrix4x4::prependTranslation))
 		            .method("prependTranslation",   static_cast<Matrix4x4::Ptr(Matrix4x4::*)(Vector3::Ptr)>(&Matrix4x4::prependTranslation))
-					.method("getTranslation",		static_cast<Vector3::Ptr(Matrix4x4::*)(void) const>(&Matrix4x4::translation));
+					.method("getTranslation",		static_cast<Vector3::Ptr(Matrix4x4::*)(void) const>(&Matrix4x4::translation))
+					.method("fromQuaternion",		&Matrix4x4::fromQuaternion);
 			}
 		};
 	}
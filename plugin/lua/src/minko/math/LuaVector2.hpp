@@ -38,7 +38,6 @@ namespace minko
 			bind(LuaGlue& state)
 			{
 				state.Class<Vector2>("Vector2")
-		            .method("create",   static_cast<Vector2::Ptr (*)(float, float)>(&Vector2::create))
 		            .method("toString", &Vector2::toString)
 		            .method("setTo",	&Vector2::setTo)
 		            .method("scaleBy",	&Vector2::scaleBy)
@@ -38,20 +38,15 @@ namespace minko
 			bind(LuaGlue& state)
 			{
 		        state.Class<Vector3>("Vector3")
-		            .method("create",		static_cast<Vector3::Ptr (*)(float, float, float)>(&Vector3::create))
 		            .method("toString",		&Vector3::toString)
 		            .method("setTo",		&Vector3::setTo)
 		            .method("copyFrom",		static_cast<Vector3::Ptr (Vector3::*)(Vector3::Ptr)>(&Vector3::copyFrom))
 		            .method("scaleBy",		&Vector3::scaleBy)
-		            .method("zero",			&Vector3::zero)
-		            .method("one",			&Vector3::one)
-		            .method("up",			&Vector3::up)
-		            .method("forward",		&Vector3::forward)
-		            .method("xAxis",		&Vector3::xAxis)
-		            .method("yAxis",		&Vector3::yAxis)
-		            .method("zAxis",		&Vector3::zAxis)
-		            .method("max",     		&Vector3::max)
-		            .method("min",     		&Vector3::min)
+		            .method("add",			static_cast<Vector3::Ptr (Vector3::*)(Vector3::Ptr)>(&Vector3::add))
+		            .method("subtract",		&Vector3::subtract)
+		            .method("cross",		&Vector3::cross)
+		            .method("dot",			&Vector3::dot)
+		            .method("lerp",			&Vector3::lerp)
 					.method("length",		&Vector3::length)
 					.method("normalize",	&Vector3::normalize)
 		            .property("x",			static_cast<float (Vector3::*)(void)>(&Vector3::x), static_cast<void (Vector3::*)(float)>(&Vector3::x))
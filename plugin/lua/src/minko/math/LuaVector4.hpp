@@ -38,7 +38,6 @@ namespace minko
 			bind(LuaGlue& state)
 			{
 				state.Class<Vector4>("Vector4")
-		            .method("create",   static_cast<Vector4::Ptr (*)(float, float, float, float)>(&Vector4::create))
 		            .method("toString", &Vector4::toString)
 		            .method("setTo",	&Vector4::setTo)
 		            .method("scaleBy",	&Vector4::scaleBy)
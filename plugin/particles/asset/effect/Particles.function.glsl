@@ -31,4 +31,13 @@ particles_linearlyInterpolateFloat3(float 	t,
 								    vec3 	upperValue)
 {
 	return lowerValue + particles_normalize(t, lower, upper) * (upperValue - lowerValue);
-}
\ No newline at end of file
+}
+
+vec3
+particles_statelessPosition(vec3	startPosition,
+							vec3	velocity,
+							vec3	acceleration,
+							float	age)
+{
+	return startPosition + age * (velocity + 0.5 * age * acceleration);
+}
@@ -10,6 +10,10 @@ attribute float	time;
 attribute vec3	oldPosition;
 attribute float	rotation;
 attribute float	spriteIndex;
+attribute float	angularVelocity;
+attribute vec3	startVelocity;
+attribute vec3	startForce;
+attribute vec2	birth; // spawn time, lifetime
 
 uniform mat4	modelToWorldMatrix;
 uniform mat4	viewMatrix;
@@ -17,6 +21,9 @@ uniform mat4	projectionMatrix;
 uniform vec2	spritesheetSize;
 
 uniform float 	timeStep;
+uniform float	systemTime;
+uniform vec3	statelessVelocity;
+uniform vec3	statelessAcceleration;
 uniform vec4	sizeOverTime;
 uniform	vec4	sizeBySpeed;
 
@@ -33,19 +40,42 @@ void main(void)
 	float	particleTime 		= 0.0;
 	float 	particleVelocity 	= 0.0;
 	vec3	particleColor		= vec3(1.0);
+	vec3	particlePosition	= position;
+	float	particleAge			= 0.0;
+	float	particleAlive		= 1.0;
 
 
-	#if defined(PARTICLE_TIME)
+	#if defined(STATELESS_PARTICLES)
 
-		particleTime = time;
+		// position holds the spawn position, everything else is a function of the particle's age
+		vec3 velocity		= startVelocity + statelessVelocity;
+		vec3 acceleration	= startForce + statelessAcceleration;
 
-	#endif // defined(PARTICLE_TIME)
+		particleAge			= systemTime - birth.x;
+		particleAlive		= step(0.0, particleAge) * step(particleAge, birth.y);
+		particleTime		= particleAge / max(1e-6, birth.y);
+		particlePosition	= particles_statelessPosition(position, velocity, acceleration, particleAge);
+		particleVelocity	= particles_velocity(
+			particlePosition,
+			particles_statelessPosition(position, velocity, acceleration, particleAge - timeStep),
+			timeStep
+		);
+
+	#else
+
+		#if defined(PARTICLE_TIME)
+
+			particleTime = time;
+
+		#endif // defined(PARTICLE_TIME)
+
+		#if defined(PARTICLE_OLD_POSITION)
 
-	#if defined(PARTICLE_OLD_POSITION)
+			particleVelocity = particles_velocity(position, oldPosition, timeStep);
 
-		particleVelocity = particles_velocity(position, oldPosition, timeStep);
+		#endif // defined(PARTICLE_OLD_POSITION)
 
-	#endif // defined(PARTICLE_OLD_POSITION)
+	#endif // defined(STATELESS_PARTICLES)
 
 	#if defined(PARTICLE_COLOR)
 
@@ -72,7 +102,7 @@ void main(void)
 	#endif // defined(SPRITE_SHEET)
 
 
-	vec4 pos = vec4(position, 1.0);
+	vec4 pos = vec4(particlePosition, 1.0);
 
 	#if !defined(WORLDSPACE_PARTICLES) && defined(MODEL_TO_WORLD)
 
@@ -87,7 +117,15 @@ void main(void)
 
 	#if defined(PARTICLE_ROTATION)
 
-		vec4 offXY_cos_sin = vec4(particleOffset.x, particleOffset.y, cos(rotation), sin(rotation)); // less temp registers !
+		float particleRotation = rotation;
+
+		#if defined(STATELESS_PARTICLES) && defined(PARTICLE_ANGULAR_VELOCITY)
+
+			particleRotation += angularVelocity * particleAge;
+
+		#endif // defined(STATELESS_PARTICLES) && defined(PARTICLE_ANGULAR_VELOCITY)
+
+		vec4 offXY_cos_sin = vec4(particleOffset.x, particleOffset.y, cos(particleRotation), sin(particleRotation)); // less temp registers !
 
 		particleOffset.xy = vec2(
 			offXY_cos_sin.z * offXY_cos_sin.x - offXY_cos_sin.w * offXY_cos_sin.y, // cos * x - sin * y
@@ -127,6 +165,8 @@ void main(void)
 
 	#endif // defined(SIZE_BY_SPEED)
 
+	particleOffset *= particleAlive; // dead stateless particles collapse to a degenerate quad
+
 	vUV 		= particleUV;
 	vTime 		= particleTime;
 	vVelocity	= particleVelocity;
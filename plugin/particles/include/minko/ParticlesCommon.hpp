@@ -46,6 +46,8 @@ namespace minko
 	namespace particle
 	{
 		struct ParticleData;
+		class ParticleStore;
+		class DepthSorter;
 		enum class StartDirection;
 
 		namespace modifier
@@ -25,6 +25,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/component/AbstractComponent.hpp"
 #include "minko/geometry/ParticlesGeometry.hpp"
 #include "minko/particle/ParticleData.hpp"
+#include "minko/particle/ParticleStore.hpp"
+#include "minko/particle/DepthSorter.hpp"
 
 namespace minko
 {
@@ -59,21 +61,6 @@ namespace minko
 			typedef std::shared_ptr<particle::modifier::IParticleUpdater>		IUpdaterPtr;
 			typedef std::shared_ptr<particle::modifier::IParticleModifier>		ModifierPtr;
 
-		private:
-			class ParticleDistanceToCameraComparison
-			{
-			public:
-				component::ParticleSystem*	system;
-
-				inline
-				bool
-				operator() (unsigned int p1Index, unsigned int p2Index)
-				{
-					return system->getParticleSquaredDistanceToCamera(p1Index)
-						 > system->getParticleSquaredDistanceToCamera(p2Index);
-				};
-			};
-
 		private:
 			static const unsigned int 								    COUNT_LIMIT;
 
@@ -90,17 +77,29 @@ namespace minko
 			unsigned int								                _previousLiveCount;
 			std::vector<IInitializerPtr> 				                _initializers;
 			std::vector<IUpdaterPtr> 					                _updaters;
-			std::vector<particle::ParticleData>			                _particles;
+			particle::ParticleStore						                _particles;
+			particle::ParticleData						                _newParticle;
 			std::vector<unsigned int>					                _particleOrder;
-			std::vector<float>							                _particleDistanceToCamera;
+			particle::DepthSorter						                _sorter;
+			bool										                _isZSortAsync;
+			float										                _zSortTime;
+#if !defined(EMSCRIPTEN)
+			std::future<void>							                _sortJob;
+#endif
 
 			bool										                _isInWorldSpace;
 			float 										                _localToWorld[16];
 			bool										                _isZSorted;
 			float 										                _cameraCoords[3];
-			ParticleDistanceToCameraComparison			                _comparisonObject;
 			bool										                _useOldPosition;
 
+			bool										                _isStateless;
+			bool										                _statelessActive;
+			float										                _statelessTime;
+			unsigned int								                _nextSlot;
+			unsigned int								                _firstDirtySlot;
+			unsigned int								                _numDirtySlots;
+
 			float										                _rate;
 			FloatSamplerPtr								                _lifetime;
 			ShapePtr									                _shape;
@@ -300,9 +299,43 @@ namespace minko
 			Ptr
 			isZSorted(bool);
 
+			/**
+			 * Sorts particles on a worker thread: each frame renders with the order computed from
+			 * the previous frame's depths while the current depths are being sorted.
+			 */
+			Ptr
+			isZSortAsync(bool);
+
+			/**
+			 * Duration of the last particles depth sort, in milliseconds.
+			 */
+			inline
+			float
+			zSortTime() const
+			{
+				return _zSortTime;
+			};
+
 			Ptr
 			useOldPosition(bool);
 
+			/**
+			 * Requests the stateless mode: each particle is written once to the vertex buffer when it
+			 * is spawned and its position, color and size are evaluated in the vertex shader from its
+			 * age, making the CPU cost proportional to the spawn rate instead of the particles count.
+			 * The system silently keeps simulating on the CPU while it is z-sorted or one of its
+			 * updaters is not time-analytic (see IParticleUpdater::isTimeAnalytic()).
+			 */
+			Ptr
+			isStateless(bool);
+
+			inline
+			bool
+			isStateless() const
+			{
+				return _statelessActive;
+			};
+
         /**
 			inline
 			void
@@ -341,7 +374,9 @@ namespace minko
 			float
 			getParticleSquaredDistanceToCamera(unsigned int particleIndex)
 			{
-				return _particleDistanceToCamera[particleIndex];
+				waitForSort();
+
+				return _sorter.depths()[particleIndex];
 			};
 
 			void
@@ -371,17 +406,30 @@ namespace minko
 			};
 
 			inline
-			std::vector<particle::ParticleData>&
+			particle::ParticleStore&
 			getParticles()
 			{
 				return _particles;
 			};
 
+			// particles only live on the GPU in stateless mode, where this is always 0
+			inline
+			unsigned int
+			liveParticlesCount() const
+			{
+				return _particles.liveCount();
+			};
+
 			void
 			createParticle(unsigned int 						particleIndex,
 						   const particle::shape::EmitterShape&	emitter,
 						   float								timeLived);
 
+			void
+			initializeParticle(particle::ParticleData&				particle,
+							   const particle::shape::EmitterShape&	emitter,
+							   float								timeLived);
+
 			//void
 			//killParticle(unsigned int							particleIndex);
 
@@ -400,9 +448,35 @@ namespace minko
 			void
 			resizeParticlesVector();
 
+			void
+			sortParticles(unsigned int liveCount);
+
+			void
+			waitForSort();
+
 			void
 			addComponents(unsigned int components, bool blockVSInit = false);
 
+			void
+			updateVertexLayout();
+
+			void
+			updateStatelessMode();
+
+			void
+			updateStatelessSystem(float	timeStep,
+								  bool	emit);
+
+			void
+			writeStatelessParticle(unsigned int						slot,
+								   const particle::ParticleData&	particle);
+
+			void
+			clearStatelessParticles();
+
+			void
+			uploadStatelessParticles();
+
 			inline
 			void
 			setInVertexBuffer(float* ptr, unsigned int offset, float value)
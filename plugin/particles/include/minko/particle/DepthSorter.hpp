@@ -0,0 +1,108 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/ParticlesCommon.hpp"
+
+namespace minko
+{
+	namespace particle
+	{
+		/**
+		 * Back-to-front ordering of particles by squared distance to the camera. The order of the
+		 * previous sort is kept and refined with an insertion sort, which is close to linear when
+		 * particles move coherently from one frame to the next. When the insertion sort exceeds its
+		 * budget, the order is rebuilt with a radix sort on quantized depths.
+		 */
+		class DepthSorter
+		{
+		private:
+			static const unsigned int	INSERTION_BUDGET;
+
+			std::vector<unsigned int>	_order;
+			std::vector<float>			_depths;
+			std::vector<unsigned int>	_keys;
+			std::vector<unsigned int>	_swapOrder;
+			std::vector<unsigned int>	_swapKeys;
+
+			float						_sortTime;
+			bool						_usedRadixSort;
+
+		public:
+			DepthSorter();
+
+			inline
+			const std::vector<unsigned int>&
+			order() const
+			{
+				return _order;
+			}
+
+			inline
+			float*
+			depths()
+			{
+				return _depths.empty() ? nullptr : &_depths[0];
+			}
+
+			inline
+			const float*
+			depths() const
+			{
+				return _depths.empty() ? nullptr : &_depths[0];
+			}
+
+			/**
+			 * Duration of the last sort, in milliseconds.
+			 */
+			inline
+			float
+			sortTime() const
+			{
+				return _sortTime;
+			}
+
+			inline
+			bool
+			usedRadixSort() const
+			{
+				return _usedRadixSort;
+			}
+
+			/**
+			 * Sets the number of sorted particles. The previous order is kept for the indices that
+			 * are still valid and new indices are appended at the end (i.e. nearest to the camera).
+			 */
+			void
+			resize(unsigned int numParticles);
+
+			void
+			sort();
+
+		private:
+			bool
+			insertionSort();
+
+			void
+			radixSort();
+		};
+	}
+}
@@ -0,0 +1,138 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/ParticlesCommon.hpp"
+
+namespace minko
+{
+	namespace particle
+	{
+		/**
+		 * Structure-of-arrays particle storage. Live particles are always packed in [0, liveCount()):
+		 * killing a particle moves the last live one into its slot, so updaters only ever walk live
+		 * particles and can process each stream as a contiguous float array.
+		 */
+		class ParticleStore
+		{
+		public:
+			enum Stream
+			{
+				X,
+				Y,
+				Z,
+				OLD_X,
+				OLD_Y,
+				OLD_Z,
+				START_VX,
+				START_VY,
+				START_VZ,
+				START_FX,
+				START_FY,
+				START_FZ,
+				R,
+				G,
+				B,
+				SIZE,
+				ROTATION,
+				START_ANGULAR_VELOCITY,
+				LIFETIME,
+				TIME_LIVED,
+				SPRITE_INDEX,
+
+				NUM_STREAMS
+			};
+
+		private:
+			std::vector<float>	_data;
+			unsigned int		_capacity;
+			unsigned int		_liveCount;
+
+		public:
+			ParticleStore();
+
+			inline
+			unsigned int
+			capacity() const
+			{
+				return _capacity;
+			}
+
+			inline
+			unsigned int
+			liveCount() const
+			{
+				return _liveCount;
+			}
+
+			inline
+			float*
+			stream(Stream s)
+			{
+				return _capacity ? &_data[s * _capacity] : nullptr;
+			}
+
+			inline
+			const float*
+			stream(Stream s) const
+			{
+				return _capacity ? &_data[s * _capacity] : nullptr;
+			}
+
+			/**
+			 * Changes the capacity, keeping the first live particles that still fit.
+			 */
+			void
+			resize(unsigned int capacity);
+
+			inline
+			void
+			clear()
+			{
+				_liveCount = 0;
+			}
+
+			/**
+			 * Appends a particle at the end of the live range and returns its index.
+			 */
+			unsigned int
+			spawn();
+
+			/**
+			 * Removes a live particle by moving the last live particle into its slot.
+			 */
+			void
+			kill(unsigned int particleIndex);
+
+			/**
+			 * Kills every particle whose time lived reached its lifetime and returns how many were removed.
+			 */
+			unsigned int
+			killExpired();
+
+			void
+			get(unsigned int particleIndex, ParticleData& particle) const;
+
+			void
+			set(unsigned int particleIndex, const ParticleData& particle);
+		};
+	}
+}
@@ -57,7 +57,14 @@ namespace minko
 
 
 				void
-				update(std::vector<ParticleData>&, float) const;
+				update(ParticleStore&, float) const;
+
+				inline
+				bool
+				isTimeAnalytic() const
+				{
+					return true;
+				};
 
 				unsigned int
 				getNeededComponents() const;
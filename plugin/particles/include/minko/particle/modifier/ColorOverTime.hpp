@@ -55,7 +55,14 @@ namespace minko
 				};
 
 				void
-				update(std::vector<ParticleData>&, float timeStep) const;
+				update(ParticleStore&, float timeStep) const;
+
+				inline
+				bool
+				isTimeAnalytic() const
+				{
+					return true;
+				};
 
 				unsigned int
 				getNeededComponents() const;
@@ -52,7 +52,13 @@ namespace minko
 				};
 
 				void
-				update(std::vector<ParticleData>&, float) const;
+				update(ParticleStore&, float) const;
+
+				bool
+				isTimeAnalytic() const;
+
+				void
+				addAnalyticMotion(float* velocity, float* acceleration) const;
 
 				unsigned int
 				getNeededComponents() const;
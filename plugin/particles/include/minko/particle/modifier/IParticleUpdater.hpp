@@ -36,7 +36,28 @@ namespace minko
 			public:
 				virtual
 				void
-				update(std::vector<ParticleData>&, float timeStep) const = 0;
+				update(ParticleStore&, float timeStep) const = 0;
+
+				/**
+				 * Whether the updater's effect at any age can be computed from spawn-time data only,
+				 * which allows ParticleSystem to evaluate it in the vertex shader (stateless mode).
+				 */
+				virtual
+				bool
+				isTimeAnalytic() const
+				{
+					return false;
+				};
+
+				/**
+				 * Adds the updater's constant contribution to the velocity and acceleration the
+				 * stateless particles vertex shader integrates. Only called on time-analytic updaters.
+				 */
+				virtual
+				void
+				addAnalyticMotion(float* velocity, float* acceleration) const
+				{
+				};
 			};
 		}
 	}
@@ -31,7 +31,9 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/render/ParticleVertexBuffer.hpp"
 #include "minko/render/ParticleIndexBuffer.hpp"
 #include "minko/math/Matrix4x4.hpp"
+#include "minko/math/Vector3.hpp"
 #include "minko/particle/ParticleData.hpp"
+#include "minko/particle/ParticleStore.hpp"
 #include "minko/particle/StartDirection.hpp"
 #include "minko/particle/modifier/IParticleModifier.hpp"
 #include "minko/particle/modifier/IParticleInitializer.hpp"
@@ -40,6 +42,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/particle/sampler/Sampler.hpp"
 #include "minko/particle/sampler/Constant.hpp"
 #include "minko/particle/tools/VertexComponentFlags.hpp"
+#include "minko/particle/tools/kernels.hpp"
 
 using namespace minko;
 using namespace minko::component;
@@ -62,9 +65,18 @@ ParticleSystem::ParticleSystem(AssetLibraryPtr		assets,
 	_maxCount			(0),
 	_previousLiveCount	(0),
 	_particles			(),
+	_newParticle		(),
 	_isInWorldSpace		(false),
 	_isZSorted			(false),
+	_isZSortAsync		(false),
+	_zSortTime			(0.f),
 	_useOldPosition		(false),
+	_isStateless		(false),
+	_statelessActive	(false),
+	_statelessTime		(0.0f),
+	_nextSlot			(0),
+	_firstDirtySlot		(0),
+	_numDirtySlots		(0),
 	_rate				(1.0f / rate),
 	_lifetime			(lifetime			? lifetime			: sampler::Constant<float>::create(1.0f)),
 	_shape				(shape				? shape				: shape::Sphere::create(10)),
@@ -87,8 +99,6 @@ ParticleSystem::ParticleSystem(AssetLibraryPtr		assets,
 		_effect
 	);
 
-	_comparisonObject.system = (this);
-
 	updateMaxParticlesCount();
 }
 
@@ -203,23 +213,27 @@ ParticleSystem::frameBeginHandler(SceneManager::Ptr sceneManager, float time, fl
 ParticleSystem::Ptr
 ParticleSystem::add(ModifierPtr	modifier)
 {
-	addComponents(modifier->getNeededComponents());
-
 	modifier->setProperties(_material);
 	
 	IInitializerPtr i = std::dynamic_pointer_cast<modifier::IParticleInitializer> (modifier);
 
 	if (i != 0)
-	{
 		_initializers.push_back(i);
+	else
+	{
+		IUpdaterPtr u = std::dynamic_pointer_cast<modifier::IParticleUpdater> (modifier);
 
-		return shared_from_this();	
+		if (u != 0)
+			_updaters.push_back(u);
 	}
 
-	IUpdaterPtr u = std::dynamic_pointer_cast<modifier::IParticleUpdater> (modifier);
+	if (_isStateless)
+		updateStatelessMode();
 
-	if (u != 0)
-		_updaters.push_back(u);
+	if (_statelessActive)
+		updateVertexFormat();
+	else
+		addComponents(modifier->getNeededComponents());
 
     return shared_from_this();	
 }
@@ -258,6 +272,9 @@ ParticleSystem::remove(ModifierPtr	modifier)
 				modifier->unsetProperties(_material);
 				updateVertexFormat();
 
+				if (_isStateless)
+					updateStatelessMode();
+
 				return shared_from_this();
 			}
 		}
@@ -327,58 +344,215 @@ ParticleSystem::updateSystem(float timeStep, bool emit)
 	if (emit && _createTimer < _rate)
 		_createTimer += timeStep;
 
-	for (unsigned particleIndex = 0; particleIndex < _particles.size(); ++particleIndex)
+	if (_statelessActive)
 	{
-		ParticleData& particle = _particles[particleIndex];
+		updateStatelessSystem(timeStep, emit);
 
-		if (particle.alive())
-		{
-			particle.timeLived  += timeStep;
+		return;
+	}
 
-			particle.oldx       = particle.x;
-			particle.oldy       = particle.y;
-			particle.oldz       = particle.z;
+	unsigned int liveCount = _particles.liveCount();
 
-			//if (part)
-			//if (!(particle.timeLived < particle.lifetime))
-			//	killParticle(particleIndex);
-		}
-	}
+	kernel::add(_particles.stream(ParticleStore::TIME_LIVED), timeStep, liveCount);
+
+	// dead particles are swapped out of the live range so that nothing below ever visits them
+	_particles.killExpired();
+	liveCount = _particles.liveCount();
+
+	std::copy(_particles.stream(ParticleStore::X), _particles.stream(ParticleStore::X) + liveCount, _particles.stream(ParticleStore::OLD_X));
+	std::copy(_particles.stream(ParticleStore::Y), _particles.stream(ParticleStore::Y) + liveCount, _particles.stream(ParticleStore::OLD_Y));
+	std::copy(_particles.stream(ParticleStore::Z), _particles.stream(ParticleStore::Z) + liveCount, _particles.stream(ParticleStore::OLD_Z));
 
 	for (auto& updater : _updaters)
 		updater->update(_particles, timeStep);
 
-	for (unsigned particleIndex = 0; particleIndex < _particles.size(); ++particleIndex)
+	while (emit && !(_createTimer < _rate) && _particles.liveCount() < _maxCount)
 	{
-		ParticleData& particle = _particles[particleIndex];
-		
-		if (!particle.alive() && emit && !(_createTimer < _rate))
-		{
-			_createTimer -= _rate;
+		_createTimer -= _rate;
+
+		createParticle(_particles.spawn(), *_shape, _createTimer);
+	}
 
-			createParticle(particleIndex, *_shape, _createTimer);
+	liveCount = _particles.liveCount();
 
-			particle.lifetime = _lifetime->value();
-		}
-		
-		particle.rotation   += particle.startAngularVelocity * timeStep;
+	kernel::multiplyAdd(_particles.stream(ParticleStore::ROTATION), _particles.stream(ParticleStore::START_ANGULAR_VELOCITY), timeStep, liveCount);
+
+	kernel::multiplyAdd(_particles.stream(ParticleStore::START_VX), _particles.stream(ParticleStore::START_FX), timeStep, liveCount);
+	kernel::multiplyAdd(_particles.stream(ParticleStore::START_VY), _particles.stream(ParticleStore::START_FY), timeStep, liveCount);
+	kernel::multiplyAdd(_particles.stream(ParticleStore::START_VZ), _particles.stream(ParticleStore::START_FZ), timeStep, liveCount);
+
+	kernel::multiplyAdd(_particles.stream(ParticleStore::X), _particles.stream(ParticleStore::START_VX), timeStep, liveCount);
+	kernel::multiplyAdd(_particles.stream(ParticleStore::Y), _particles.stream(ParticleStore::START_VY), timeStep, liveCount);
+	kernel::multiplyAdd(_particles.stream(ParticleStore::Z), _particles.stream(ParticleStore::START_VZ), timeStep, liveCount);
+}
 
-		particle.startvx    += particle.startfx * timeStep;
-		particle.startvy    += particle.startfy * timeStep;
-		particle.startvz    += particle.startfz * timeStep;
+void
+ParticleSystem::updateStatelessSystem(float timeStep, bool emit)
+{
+	_statelessTime += timeStep;
+	_material->set<float>("particles.time", _statelessTime);
+
+	if (_maxCount == 0)
+		return;
+
+	while (emit && !(_createTimer < _rate))
+	{
+		_createTimer -= _rate;
+
+		// the ring holds maxParticlesCount() slots, so the oldest slot always holds a dead particle
+		initializeParticle(_newParticle, *_shape, _createTimer);
+		writeStatelessParticle(_nextSlot, _newParticle);
 
-		particle.x          += particle.startvx * timeStep;
-		particle.y          += particle.startvy * timeStep;
-		particle.z          += particle.startvz * timeStep;
+		if (_numDirtySlots == 0)
+			_firstDirtySlot = _nextSlot;
+		_numDirtySlots = std::min(_numDirtySlots + 1, _maxCount);
+		_nextSlot = (_nextSlot + 1) % _maxCount;
 	}
 }
 
+void
+ParticleSystem::writeStatelessParticle(unsigned int slot, const ParticleData& particle)
+{
+	float*			vertexIterator	= &_geometry->particleVertices()->data()[4 * slot * _geometry->vertexSize()];
+	unsigned int	i				= 5;
+
+	setInVertexBuffer(vertexIterator, 2, particle.x);
+	setInVertexBuffer(vertexIterator, 3, particle.y);
+	setInVertexBuffer(vertexIterator, 4, particle.z);
+
+	if (_format & VertexComponentFlags::SIZE)
+		setInVertexBuffer(vertexIterator, i++, particle.size);
+
+	if (_format & VertexComponentFlags::COLOR)
+	{
+		setInVertexBuffer(vertexIterator, i++, particle.r);
+		setInVertexBuffer(vertexIterator, i++, particle.g);
+		setInVertexBuffer(vertexIterator, i++, particle.b);
+	}
+
+	if (_format & VertexComponentFlags::ROTATION)
+		setInVertexBuffer(vertexIterator, i++, particle.rotation);
+
+	if (_format & VertexComponentFlags::SPRITE_INDEX)
+		setInVertexBuffer(vertexIterator, i++, particle.spriteIndex);
+
+	if (_format & VertexComponentFlags::ANG_VELOCITY)
+		setInVertexBuffer(vertexIterator, i++, particle.startAngularVelocity);
+
+	setInVertexBuffer(vertexIterator, i++, particle.startvx);
+	setInVertexBuffer(vertexIterator, i++, particle.startvy);
+	setInVertexBuffer(vertexIterator, i++, particle.startvz);
+
+	setInVertexBuffer(vertexIterator, i++, particle.startfx);
+	setInVertexBuffer(vertexIterator, i++, particle.startfy);
+	setInVertexBuffer(vertexIterator, i++, particle.startfz);
+
+	setInVertexBuffer(vertexIterator, i++, _statelessTime - particle.timeLived);
+	setInVertexBuffer(vertexIterator, i++, particle.lifetime);
+}
+
+void
+ParticleSystem::clearStatelessParticles()
+{
+	if (_maxCount == 0)
+		return;
+
+	// a negative lifetime keeps a slot hidden until a particle is spawned in it
+	ParticleData particle;
+
+	particle.lifetime	= -1.0f;
+	particle.timeLived	= _statelessTime;
+
+	for (unsigned int slot = 0; slot < _maxCount; ++slot)
+		writeStatelessParticle(slot, particle);
+
+	_nextSlot		= 0;
+	_firstDirtySlot	= 0;
+	_numDirtySlots	= _maxCount;
+}
+
+void
+ParticleSystem::uploadStatelessParticles()
+{
+	auto vertexBuffer = _geometry->particleVertices();
+
+	if (_numDirtySlots != 0)
+	{
+		const unsigned int numSlots = std::min(_numDirtySlots, _maxCount - _firstDirtySlot);
+
+		vertexBuffer->upload(_firstDirtySlot << 2, numSlots << 2);
+		if (numSlots < _numDirtySlots)
+			vertexBuffer->upload(0, (_numDirtySlots - numSlots) << 2);
+
+		_numDirtySlots = 0;
+	}
+
+	if (_previousLiveCount != _maxCount)
+	{
+        auto particleIndices    = std::static_pointer_cast<render::ParticleIndexBuffer>(_geometry->indices());
+		particleIndices->upload(0, _maxCount << 2);
+		_previousLiveCount = _maxCount;
+	}
+}
+
+void
+ParticleSystem::updateStatelessMode()
+{
+	bool active = _isStateless && !_isZSorted;
+
+	for (auto& updater : _updaters)
+		active = active && updater->isTimeAnalytic();
+
+	if (active)
+	{
+		float velocity[3]		= { 0.0f, 0.0f, 0.0f };
+		float acceleration[3]	= { 0.0f, 0.0f, 0.0f };
+
+		for (auto& updater : _updaters)
+			updater->addAnalyticMotion(velocity, acceleration);
+
+		_material->set<math::Vector3::Ptr>("particles.statelessVelocity", math::Vector3::create(velocity[0], velocity[1], velocity[2]));
+		_material->set<math::Vector3::Ptr>("particles.statelessAcceleration", math::Vector3::create(acceleration[0], acceleration[1], acceleration[2]));
+	}
+
+	if (active == _statelessActive)
+		return;
+
+	_statelessActive = active;
+
+	if (_statelessActive)
+	{
+		_material->set<float>("particles.time", _statelessTime);
+		_material->set<bool>("particles.stateless", true);
+	}
+	else
+	{
+		_material->unset("particles.stateless");
+		_material->unset("particles.time");
+		_material->unset("particles.statelessVelocity");
+		_material->unset("particles.statelessAcceleration");
+	}
+
+	updateVertexFormat();
+	reset();
+}
+
 void
 ParticleSystem::createParticle(unsigned int 				particleIndex,
 							   const shape::EmitterShape&	shape,
 							   float						timeLived)
 {
-	ParticleData& particle = _particles[particleIndex];
+	initializeParticle(_newParticle, shape, timeLived);
+
+	_particles.set(particleIndex, _newParticle);
+}
+
+void
+ParticleSystem::initializeParticle(ParticleData&				particle,
+								   const shape::EmitterShape&	shape,
+								   float						timeLived)
+{
+	particle = ParticleData();
 
 	if (_emissionDirection == StartDirection::NONE)
 	{
@@ -464,6 +638,8 @@ ParticleSystem::createParticle(unsigned int 				particleIndex,
 	
 //	++_liveCount;
 
+	particle.lifetime				= _lifetime->value();
+
 	for (auto& initializer : _initializers)
 		initializer->initialize(particle, timeLived);
 }
@@ -486,131 +662,159 @@ ParticleSystem::updateMaxParticlesCount()
 
 	_maxCount = value;
 
-	uint liveCount = 0;
-	for (auto& particle : _particles)
-		if (particle.alive())
-		{
-			if (liveCount == _maxCount || !( particle.timeLived < _lifetime->max()) )
-				particle.kill();
-			else
-			{
-				if (particle.lifetime < _lifetime->min() || particle.lifetime > _lifetime->max())
-					particle.lifetime = _lifetime->value();
+	const float*	timeLived	= _particles.stream(ParticleStore::TIME_LIVED);
+	float*			lifetime	= _particles.stream(ParticleStore::LIFETIME);
+	unsigned int	i			= 0;
 
-				if (particle.alive())
-					++liveCount;
-			}
+	while (i < _particles.liveCount())
+	{
+		if (i >= _maxCount || !(timeLived[i] < _lifetime->max()))
+			_particles.kill(i);
+		else
+		{
+			if (lifetime[i] < _lifetime->min() || lifetime[i] > _lifetime->max())
+				lifetime[i] = _lifetime->value();
+			++i;
 		}
+	}
 
-
- //   //std::cout << "lifetime in [" << _lifetime->min() << " " << _lifetime->max() << "]" << std::endl;
-
-	//for (unsigned int i = 0; i < _particles.size(); ++i)
-	//{
-	//	if (_particles[i].alive())
-	//	{
-	//		if (liveCount == _maxCount ||
-	//			!(_particles[i].timeLived < _lifetime->max()))
-	//			_particles[i].kill();
-	//			//!(_particles[i].timeLived < _lifetime->max()))
-	//			//;//				_particles[i].alive = false;
-	//		else
-	//		{
-	//			//++_liveCount;
-	//			if (_particles[i].lifetime > _lifetime->max() || _particles[i].lifetime < _lifetime->min())
-	//				_particles[i].lifetime = _lifetime->value();
-
-	//			liveCount += _particles[i].alive() ? 1 : 0;
-	//			//if (!(_particles[i].timeLived < _particles[i].lifetime))
-	//				//;// _particles[i].alive = false;
- //               //else
- //                   //++_liveCount;
-	//		}
-	//	}
-	//}
 	resizeParticlesVector();
 	_geometry->initStreams(_maxCount);
+
+	if (_statelessActive)
+		clearStatelessParticles();
 }
 
 void
 ParticleSystem::resizeParticlesVector()
 {
+	waitForSort();
+
 	_particles.resize(_maxCount);
-	if (_isZSorted)
+	_sorter.resize(_isZSorted ? std::min(_particles.liveCount(), _maxCount) : 0);
+	_particleOrder.reserve(_isZSorted ? _maxCount : 0);
+}
+
+void
+ParticleSystem::sortParticles(unsigned int liveCount)
+{
+#if !defined(EMSCRIPTEN)
+	if (_isZSortAsync)
 	{
-		_particleDistanceToCamera.resize(_maxCount);
-		_particleOrder.resize(_maxCount);
-		for (unsigned int i = 0; i < _particleOrder.size(); ++i)
-			_particleOrder[i] = i;
+		waitForSort();
+
+		// the order was computed one frame behind: spawned particles are appended, killed ones dropped
+		_sorter.resize(liveCount);
+		_particleOrder.assign(_sorter.order().begin(), _sorter.order().end());
+
+		updateParticleDistancesToCamera();
+
+		auto sorter = &_sorter;
+
+		_sortJob = std::async(std::launch::async, [sorter]()
+		{
+			sorter->sort();
+		});
+
+		return;
 	}
-	else
+#endif
+
+	_sorter.resize(liveCount);
+	updateParticleDistancesToCamera();
+	_sorter.sort();
+	_zSortTime = _sorter.sortTime();
+	_particleOrder.assign(_sorter.order().begin(), _sorter.order().end());
+}
+
+void
+ParticleSystem::waitForSort()
+{
+#if !defined(EMSCRIPTEN)
+	if (_sortJob.valid())
 	{
-		_particleDistanceToCamera.resize(0);
-		_particleOrder.resize(0);
+		_sortJob.get();
+		_zSortTime = _sorter.sortTime();
 	}
+#endif
 }
 
 void
 ParticleSystem::updateParticleDistancesToCamera()
 {
-	for (unsigned int i = 0; i < _particleDistanceToCamera.size(); ++i)
-	{
-		const ParticleData& particle = _particles[i];
+	const unsigned int	liveCount	= _particles.liveCount();
+	const float*		px			= _particles.stream(ParticleStore::X);
+	const float*		py			= _particles.stream(ParticleStore::Y);
+	const float*		pz			= _particles.stream(ParticleStore::Z);
+	float*				distances	= _sorter.depths();
 
-		float x = particle.x;
-		float y = particle.y;
-		float z = particle.z;
+	for (unsigned int i = 0; i < liveCount; ++i)
+	{
+		float x = px[i];
+		float y = py[i];
+		float z = pz[i];
 		
 		if (!_isInWorldSpace)
 		{
-			x = _localToWorld[0] * x + _localToWorld[4] * y + _localToWorld[8] * z + _localToWorld[12];
-			y = _localToWorld[1] * x + _localToWorld[5] * y + _localToWorld[9] * z + _localToWorld[13];
-			z = _localToWorld[2] * x + _localToWorld[6] * y + _localToWorld[10] * z + _localToWorld[14];
+			const float lx = x;
+			const float ly = y;
+			const float lz = z;
+
+			x = _localToWorld[0] * lx + _localToWorld[4] * ly + _localToWorld[8] * lz + _localToWorld[12];
+			y = _localToWorld[1] * lx + _localToWorld[5] * ly + _localToWorld[9] * lz + _localToWorld[13];
+			z = _localToWorld[2] * lx + _localToWorld[6] * ly + _localToWorld[10] * lz + _localToWorld[14];
 		}
 
 		float deltaX = _cameraCoords[0] - x;
 		float deltaY = _cameraCoords[1] - y;
 		float deltaZ = _cameraCoords[2] - z;
 
-		_particleDistanceToCamera[i] = deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ;
+		distances[i] = deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ;
 	}
 }
 
 void
 ParticleSystem::reset()
 {
-	for (auto& particle : _particles)
-		particle.kill();
-
-	//if (_liveCount == 0)
-	//	return;
+	_particles.clear();
 
-	//_liveCount = 0;
-
-//	for (auto& particle : _particles)
-//        particle.alive = false;
+	if (_statelessActive)
+		clearStatelessParticles();
 }
 
 
 void
 ParticleSystem::addComponents(unsigned int components, bool blockVSInit)
 {
-    typedef std::tuple<std::string, VertexComponentFlags, unsigned int> ComponentInfo;
-    static const std::array<ComponentInfo, 6> OPTIONAL_COMPONENTS = 
-    {
-        std::make_tuple("size",          VertexComponentFlags::SIZE,            1),
-        std::make_tuple("color",         VertexComponentFlags::COLOR,           3),
-        std::make_tuple("time",          VertexComponentFlags::TIME,            1),
-        std::make_tuple("oldPosition",   VertexComponentFlags::OLD_POSITION,    3),
-        std::make_tuple("rotation",      VertexComponentFlags::ROTATION,        1),
-        std::make_tuple("spriteIndex",   VertexComponentFlags::SPRITE_INDEX,    1)
-    };
-    
-	if (_format == components)
+	if ((components & ~_format) == 0)
 		return;
 
 	_format |= components;
 
+	updateVertexLayout();
+
+	if (!blockVSInit)
+		_geometry->initStreams(_maxCount);
+}
+
+void
+ParticleSystem::updateVertexLayout()
+{
+    typedef std::tuple<std::string, VertexComponentFlags, unsigned int> ComponentInfo;
+    static const std::array<ComponentInfo, 10> OPTIONAL_COMPONENTS = 
+    {
+        std::make_tuple("size",             VertexComponentFlags::SIZE,             1),
+        std::make_tuple("color",            VertexComponentFlags::COLOR,            3),
+        std::make_tuple("time",             VertexComponentFlags::TIME,             1),
+        std::make_tuple("oldPosition",      VertexComponentFlags::OLD_POSITION,     3),
+        std::make_tuple("rotation",         VertexComponentFlags::ROTATION,         1),
+        std::make_tuple("spriteIndex",      VertexComponentFlags::SPRITE_INDEX,     1),
+        std::make_tuple("angularVelocity",  VertexComponentFlags::ANG_VELOCITY,     1),
+        std::make_tuple("startVelocity",    VertexComponentFlags::START_VELOCITY,   3),
+        std::make_tuple("startForce",       VertexComponentFlags::START_FORCE,      3),
+        std::make_tuple("birth",            VertexComponentFlags::BIRTH,            2)
+    };
+
     // FIXME: should be made fully dynamic
 	auto vertexBuffer = _geometry->particleVertices();
 
@@ -641,112 +845,117 @@ ParticleSystem::addComponents(unsigned int components, bool blockVSInit)
     }
 
     _geometry->addVertexBuffer(vertexBuffer);
-
-	if (!blockVSInit)
-		_geometry->initStreams(_maxCount);
 }
 
 unsigned int
 ParticleSystem::updateVertexFormat()
 {
-	_format = VertexComponentFlags::DEFAULT;
-	
-	/*
-	auto vb = _geometry->vertices();
-	if (!vb->hasAttribute("offset"))
-		vb->addAttribute("offset", 2, 0);
-	if (!vb->hasAttribute("position"))
-		vb->addAttribute("position", 3, 2);
-	*/
+	unsigned int components = VertexComponentFlags::DEFAULT;
 
-	for (auto it = _initializers.begin();
-		 it != _initializers.end();
-		 ++it)
-	{
-		addComponents((*it)->getNeededComponents(), true);
-	}
+	for (auto& initializer : _initializers)
+		components |= initializer->getNeededComponents();
 
-	for (auto it = _updaters.begin();
-		 it != _updaters.end();
-		 ++it)
+	for (auto& updater : _updaters)
+		components |= updater->getNeededComponents();
+
+	if (_useOldPosition)
+		components |= VertexComponentFlags::OLD_POSITION;
+
+	if (_statelessActive)
 	{
-		addComponents((*it)->getNeededComponents(), true);
+		// age and previous position are derived from the birth attribute in the vertex shader
+		components &= ~(VertexComponentFlags::TIME | VertexComponentFlags::OLD_POSITION);
+		components |= VertexComponentFlags::START_VELOCITY
+			| VertexComponentFlags::START_FORCE
+			| VertexComponentFlags::BIRTH;
+
+		if (components & VertexComponentFlags::ROTATION)
+			components |= VertexComponentFlags::ANG_VELOCITY;
 	}
 
-	if (_useOldPosition)
-		addComponents(VertexComponentFlags::OLD_POSITION, true);
-	
+	_format = components;
+
+	updateVertexLayout();
 	_geometry->initStreams(_maxCount);
 
+	if (_statelessActive)
+		clearStatelessParticles();
+
 	return _format;
 }
 
 void
 ParticleSystem::updateVertexBuffer()
 {
-	//if (_liveCount == 0)
-	//	return;
-
-	if (_isZSorted)
+	if (_statelessActive)
 	{
-		updateParticleDistancesToCamera();
-		std::sort(_particleOrder.begin(), _particleOrder.end(), _comparisonObject);
+		uploadStatelessParticles();
+
+		return;
 	}
+
+	const unsigned int liveCount = _particles.liveCount();
+
+	if (_isZSorted)
+		sortParticles(liveCount);
 	
 	std::vector<float>&	vsData			= _geometry->particleVertices()->data();
 	float*				vertexIterator	= &(*vsData.begin());
 
-    unsigned int liveCount = 0;
-
-	for (unsigned int particleIndex = 0; particleIndex < _maxCount; ++particleIndex)
+	const float*		x				= _particles.stream(ParticleStore::X);
+	const float*		y				= _particles.stream(ParticleStore::Y);
+	const float*		z				= _particles.stream(ParticleStore::Z);
+	const float*		oldx			= _particles.stream(ParticleStore::OLD_X);
+	const float*		oldy			= _particles.stream(ParticleStore::OLD_Y);
+	const float*		oldz			= _particles.stream(ParticleStore::OLD_Z);
+	const float*		r				= _particles.stream(ParticleStore::R);
+	const float*		g				= _particles.stream(ParticleStore::G);
+	const float*		b				= _particles.stream(ParticleStore::B);
+	const float*		size			= _particles.stream(ParticleStore::SIZE);
+	const float*		rotation		= _particles.stream(ParticleStore::ROTATION);
+	const float*		lifetime		= _particles.stream(ParticleStore::LIFETIME);
+	const float*		timeLived		= _particles.stream(ParticleStore::TIME_LIVED);
+	const float*		spriteIndex		= _particles.stream(ParticleStore::SPRITE_INDEX);
+
+	for (unsigned int particleIndex = 0; particleIndex < liveCount; ++particleIndex)
 	{
-		ParticleData* particle;
-
-		if (_isZSorted)
-			particle = &_particles[_particleOrder[particleIndex]];
-		else
-			particle = &_particles[particleIndex];
+		const unsigned int p = _isZSorted ? _particleOrder[particleIndex] : particleIndex;
 
 		unsigned int i = 5;
 
-		if (particle->alive())
-		{
-			setInVertexBuffer(vertexIterator, 2, particle->x);
-			setInVertexBuffer(vertexIterator, 3, particle->y);
-			setInVertexBuffer(vertexIterator, 4, particle->z);
+		setInVertexBuffer(vertexIterator, 2, x[p]);
+		setInVertexBuffer(vertexIterator, 3, y[p]);
+		setInVertexBuffer(vertexIterator, 4, z[p]);
 
-			if (_format & VertexComponentFlags::SIZE)
-				setInVertexBuffer(vertexIterator, i++, particle->size);
+		if (_format & VertexComponentFlags::SIZE)
+			setInVertexBuffer(vertexIterator, i++, size[p]);
 
-			if (_format & VertexComponentFlags::COLOR)
-			{
-				setInVertexBuffer(vertexIterator, i++, particle->r);
-				setInVertexBuffer(vertexIterator, i++, particle->g);
-				setInVertexBuffer(vertexIterator, i++, particle->b);
-			}
+		if (_format & VertexComponentFlags::COLOR)
+		{
+			setInVertexBuffer(vertexIterator, i++, r[p]);
+			setInVertexBuffer(vertexIterator, i++, g[p]);
+			setInVertexBuffer(vertexIterator, i++, b[p]);
+		}
 
-			if (_format & VertexComponentFlags::TIME)
-				setInVertexBuffer(vertexIterator, i++, particle->timeLived / particle->lifetime);
+		if (_format & VertexComponentFlags::TIME)
+			setInVertexBuffer(vertexIterator, i++, timeLived[p] / lifetime[p]);
 
-			if (_format & VertexComponentFlags::OLD_POSITION)
-			{
-				setInVertexBuffer(vertexIterator, i++, particle->oldx);
-				setInVertexBuffer(vertexIterator, i++, particle->oldy);
-				setInVertexBuffer(vertexIterator, i++, particle->oldz);
-			}
+		if (_format & VertexComponentFlags::OLD_POSITION)
+		{
+			setInVertexBuffer(vertexIterator, i++, oldx[p]);
+			setInVertexBuffer(vertexIterator, i++, oldy[p]);
+			setInVertexBuffer(vertexIterator, i++, oldz[p]);
+		}
 
-			if (_format & VertexComponentFlags::ROTATION)
-				setInVertexBuffer(vertexIterator, i++, particle->rotation);
+		if (_format & VertexComponentFlags::ROTATION)
+			setInVertexBuffer(vertexIterator, i++, rotation[p]);
 
-			if (_format & VertexComponentFlags::SPRITE_INDEX)
-				setInVertexBuffer(vertexIterator, i++, particle->spriteIndex);
+		if (_format & VertexComponentFlags::SPRITE_INDEX)
+			setInVertexBuffer(vertexIterator, i++, spriteIndex[p]);
 
-			vertexIterator += 4 * _geometry->vertexSize();
-            ++liveCount;
-		}
+		vertexIterator += 4 * _geometry->vertexSize();
 	}
 
-//    std::cout << "liveCount = " << _liveCount << " " << liveCount << std::endl;
 	_geometry->particleVertices()->upload(0, liveCount << 2);
 
 	if (liveCount != _previousLiveCount)
@@ -774,6 +983,9 @@ ParticleSystem::isZSorted(bool value)
 
 	resizeParticlesVector();
 
+	if (_isStateless)
+		updateStatelessMode();
+
     return std::static_pointer_cast<ParticleSystem>(shared_from_this());
 };
 
@@ -787,4 +999,25 @@ ParticleSystem::useOldPosition(bool value)
     }
 
     return std::static_pointer_cast<ParticleSystem>(shared_from_this());
-};
\ No newline at end of file
+};
+
+ParticleSystem::Ptr
+ParticleSystem::isStateless(bool value)
+{
+	_isStateless = value;
+
+	updateStatelessMode();
+
+    return std::static_pointer_cast<ParticleSystem>(shared_from_this());
+}
+
+ParticleSystem::Ptr
+ParticleSystem::isZSortAsync(bool value)
+{
+	if (!value)
+		waitForSort();
+
+	_isZSortAsync = value;
+
+    return std::static_pointer_cast<ParticleSystem>(shared_from_this());
+}
@@ -0,0 +1,154 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/particle/DepthSorter.hpp"
+
+using namespace minko;
+using namespace minko::particle;
+
+/*static*/ const unsigned int DepthSorter::INSERTION_BUDGET = 8;
+
+DepthSorter::DepthSorter() :
+	_order(),
+	_depths(),
+	_keys(),
+	_swapOrder(),
+	_swapKeys(),
+	_sortTime(0.0f),
+	_usedRadixSort(false)
+{
+}
+
+void
+DepthSorter::resize(unsigned int numParticles)
+{
+	const unsigned int previousSize = _order.size();
+
+	if (numParticles < previousSize)
+		_order.erase(
+			std::remove_if(_order.begin(), _order.end(), [=](unsigned int i) { return i >= numParticles; }),
+			_order.end()
+		);
+	else
+		for (unsigned int i = previousSize; i < numParticles; ++i)
+			_order.push_back(i);
+
+	_depths.resize(numParticles);
+}
+
+void
+DepthSorter::sort()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	_usedRadixSort = !insertionSort();
+	if (_usedRadixSort)
+		radixSort();
+
+	_sortTime = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::high_resolution_clock::now() - start
+	).count() * 1e-3f;
+}
+
+bool
+DepthSorter::insertionSort()
+{
+	const unsigned int	numParticles	= _order.size();
+	const float*		distances		= depths();
+	unsigned int*		order			= numParticles ? &_order[0] : nullptr;
+	unsigned int		budget			= INSERTION_BUDGET * numParticles;
+
+	for (unsigned int i = 1; i < numParticles; ++i)
+	{
+		const unsigned int	index	= order[i];
+		const float			depth	= distances[index];
+		unsigned int		j		= i;
+
+		while (j > 0 && distances[order[j - 1]] < depth)
+		{
+			order[j] = order[j - 1];
+			--j;
+		}
+		order[j] = index;
+
+		// order stays a valid permutation, so the radix sort can take over from here
+		if (i - j > budget)
+			return false;
+		budget -= i - j;
+	}
+
+	return true;
+}
+
+void
+DepthSorter::radixSort()
+{
+	const unsigned int numParticles = _order.size();
+
+	if (numParticles < 2)
+		return;
+
+	float minDepth = std::numeric_limits<float>::max();
+	float maxDepth = 0.0f;
+
+	for (unsigned int i = 0; i < numParticles; ++i)
+	{
+		minDepth = std::min(minDepth, _depths[i]);
+		maxDepth = std::max(maxDepth, _depths[i]);
+	}
+
+	// 16 bits keys, inverted so that an ascending sort puts the farthest particles first
+	const float scale = maxDepth > minDepth ? 65535.0f / (maxDepth - minDepth) : 0.0f;
+
+	_keys.resize(numParticles);
+	_swapKeys.resize(numParticles);
+	_swapOrder.resize(numParticles);
+
+	for (unsigned int i = 0; i < numParticles; ++i)
+		_keys[i] = 65535u - (unsigned int)((_depths[_order[i]] - minDepth) * scale);
+
+	for (unsigned int shift = 0; shift < 16; shift += 8)
+	{
+		unsigned int offsets[256] = { 0 };
+
+		for (unsigned int i = 0; i < numParticles; ++i)
+			++offsets[(_keys[i] >> shift) & 0xff];
+
+		unsigned int sum = 0;
+		for (unsigned int bucket = 0; bucket < 256; ++bucket)
+		{
+			const unsigned int count = offsets[bucket];
+
+			offsets[bucket] = sum;
+			sum += count;
+		}
+
+		for (unsigned int i = 0; i < numParticles; ++i)
+		{
+			const unsigned int position = offsets[(_keys[i] >> shift) & 0xff]++;
+
+			_swapKeys[position]		= _keys[i];
+			_swapOrder[position]	= _order[i];
+		}
+
+		_keys.swap(_swapKeys);
+		_order.swap(_swapOrder);
+	}
+}
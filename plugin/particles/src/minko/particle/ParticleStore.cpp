@@ -0,0 +1,149 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/particle/ParticleStore.hpp"
+#include "minko/particle/ParticleData.hpp"
+
+using namespace minko;
+using namespace minko::particle;
+
+ParticleStore::ParticleStore() :
+	_data(),
+	_capacity(0),
+	_liveCount(0)
+{
+}
+
+void
+ParticleStore::resize(unsigned int capacity)
+{
+	if (capacity == _capacity)
+		return;
+
+	std::vector<float>	data(NUM_STREAMS * capacity, 0.0f);
+	const unsigned int	liveCount = std::min(_liveCount, capacity);
+
+	if (liveCount)
+		for (unsigned int s = 0; s < NUM_STREAMS; ++s)
+			std::copy(
+				_data.begin() + s * _capacity,
+				_data.begin() + s * _capacity + liveCount,
+				data.begin() + s * capacity
+			);
+
+	_data.swap(data);
+	_capacity	= capacity;
+	_liveCount	= liveCount;
+}
+
+unsigned int
+ParticleStore::spawn()
+{
+	assert(_liveCount < _capacity);
+
+	return _liveCount++;
+}
+
+void
+ParticleStore::kill(unsigned int particleIndex)
+{
+	assert(particleIndex < _liveCount);
+
+	const unsigned int lastIndex = --_liveCount;
+
+	if (particleIndex != lastIndex)
+		for (unsigned int s = 0; s < NUM_STREAMS; ++s)
+		{
+			float* values = &_data[s * _capacity];
+
+			values[particleIndex] = values[lastIndex];
+		}
+}
+
+unsigned int
+ParticleStore::killExpired()
+{
+	const float*		lifetime	= stream(LIFETIME);
+	const float*		timeLived	= stream(TIME_LIVED);
+	const unsigned int	liveCount	= _liveCount;
+	unsigned int		i			= 0;
+
+	while (i < _liveCount)
+	{
+		if (timeLived[i] < lifetime[i])
+			++i;
+		else
+			kill(i); // the swapped-in particle must be tested too
+	}
+
+	return liveCount - _liveCount;
+}
+
+void
+ParticleStore::get(unsigned int particleIndex, ParticleData& particle) const
+{
+	particle.x						= stream(X)[particleIndex];
+	particle.y						= stream(Y)[particleIndex];
+	particle.z						= stream(Z)[particleIndex];
+	particle.oldx					= stream(OLD_X)[particleIndex];
+	particle.oldy					= stream(OLD_Y)[particleIndex];
+	particle.oldz					= stream(OLD_Z)[particleIndex];
+	particle.startvx				= stream(START_VX)[particleIndex];
+	particle.startvy				= stream(START_VY)[particleIndex];
+	particle.startvz				= stream(START_VZ)[particleIndex];
+	particle.startfx				= stream(START_FX)[particleIndex];
+	particle.startfy				= stream(START_FY)[particleIndex];
+	particle.startfz				= stream(START_FZ)[particleIndex];
+	particle.r						= stream(R)[particleIndex];
+	particle.g						= stream(G)[particleIndex];
+	particle.b						= stream(B)[particleIndex];
+	particle.size					= stream(SIZE)[particleIndex];
+	particle.rotation				= stream(ROTATION)[particleIndex];
+	particle.startAngularVelocity	= stream(START_ANGULAR_VELOCITY)[particleIndex];
+	particle.lifetime				= stream(LIFETIME)[particleIndex];
+	particle.timeLived				= stream(TIME_LIVED)[particleIndex];
+	particle.spriteIndex			= stream(SPRITE_INDEX)[particleIndex];
+}
+
+void
+ParticleStore::set(unsigned int particleIndex, const ParticleData& particle)
+{
+	stream(X)[particleIndex]						= particle.x;
+	stream(Y)[particleIndex]						= particle.y;
+	stream(Z)[particleIndex]						= particle.z;
+	stream(OLD_X)[particleIndex]					= particle.oldx;
+	stream(OLD_Y)[particleIndex]					= particle.oldy;
+	stream(OLD_Z)[particleIndex]					= particle.oldz;
+	stream(START_VX)[particleIndex]					= particle.startvx;
+	stream(START_VY)[particleIndex]					= particle.startvy;
+	stream(START_VZ)[particleIndex]					= particle.startvz;
+	stream(START_FX)[particleIndex]					= particle.startfx;
+	stream(START_FY)[particleIndex]					= particle.startfy;
+	stream(START_FZ)[particleIndex]					= particle.startfz;
+	stream(R)[particleIndex]						= particle.r;
+	stream(G)[particleIndex]						= particle.g;
+	stream(B)[particleIndex]						= particle.b;
+	stream(SIZE)[particleIndex]						= particle.size;
+	stream(ROTATION)[particleIndex]					= particle.rotation;
+	stream(START_ANGULAR_VELOCITY)[particleIndex]	= particle.startAngularVelocity;
+	stream(LIFETIME)[particleIndex]					= particle.lifetime;
+	stream(TIME_LIVED)[particleIndex]				= particle.timeLived;
+	stream(SPRITE_INDEX)[particleIndex]				= particle.spriteIndex;
+}
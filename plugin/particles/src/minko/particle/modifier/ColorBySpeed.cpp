@@ -20,7 +20,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/data/ParticlesProvider.hpp"
 #include "minko/math/Vector4.hpp"
 #include "minko/particle/modifier/ColorBySpeed.hpp"
-#include "minko/particle/ParticleData.hpp"
+#include "minko/particle/ParticleStore.hpp"
 #include "minko/particle/sampler/LinearlyInterpolatedValue.hpp"
 #include "minko/particle/tools/VertexComponentFlags.hpp"
 
@@ -44,9 +44,9 @@ ColorBySpeed::ColorBySpeed(LinearlyInterpolatedValue<math::Vector3>::Ptr color):
 }
 
 void
-ColorBySpeed::update(std::vector<ParticleData>&, float) const
+ColorBySpeed::update(ParticleStore&, float) const
 {
-
+    // evaluated in the particles vertex shader
 }
 
 unsigned int
@@ -18,9 +18,11 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 */
 
 #include "minko/particle/modifier/ForceOverTime.hpp"
-#include "minko/particle/ParticleData.hpp"
+#include "minko/particle/ParticleStore.hpp"
 #include "minko/particle/sampler/Sampler.hpp"
+#include "minko/particle/sampler/Constant.hpp"
 #include "minko/particle/tools/VertexComponentFlags.hpp"
+#include "minko/particle/tools/kernels.hpp"
 
 using namespace minko;
 using namespace minko::particle;
@@ -36,24 +38,15 @@ ForceOverTime::ForceOverTime(SamplerPtr fx,
 }
 
 void
-ForceOverTime::update(std::vector<ParticleData>& 	particles,
-		 		   	  float							timeStep) const
+ForceOverTime::update(ParticleStore&	particles,
+		 		   	  float				timeStep) const
 {
-	float sqTime = timeStep * timeStep;
-
-	for (auto& particle : particles)
-        if (particle.alive())
-		    {
-                const float t = particle.lifetime > 0.0f 
-                    ? particle.timeLived / particle.lifetime
-                    : 0.0f;
-
-			    particle.x += _x->value(t) * sqTime;
-			    particle.y += _y->value(t) * sqTime;
-			    particle.z += _z->value(t) * sqTime;
-		    }
-}
+	const float sqTime = timeStep * timeStep;
 
+	kernel::addSampled(_x, particles.stream(ParticleStore::X), particles, sqTime);
+	kernel::addSampled(_y, particles.stream(ParticleStore::Y), particles, sqTime);
+	kernel::addSampled(_z, particles.stream(ParticleStore::Z), particles, sqTime);
+}
 
 unsigned int
 ForceOverTime::getNeededComponents() const
@@ -61,3 +54,18 @@ ForceOverTime::getNeededComponents() const
 	return VertexComponentFlags::DEFAULT;
 }
 
+bool
+ForceOverTime::isTimeAnalytic() const
+{
+	return std::dynamic_pointer_cast<sampler::Constant<float>>(_x)
+		&& std::dynamic_pointer_cast<sampler::Constant<float>>(_y)
+		&& std::dynamic_pointer_cast<sampler::Constant<float>>(_z);
+}
+
+void
+ForceOverTime::addAnalyticMotion(float* velocity, float* acceleration) const
+{
+	acceleration[0] += _x->value(0.f);
+	acceleration[1] += _y->value(0.f);
+	acceleration[2] += _z->value(0.f);
+}
@@ -18,9 +18,11 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 */
 
 #include "minko/particle/modifier/VelocityOverTime.hpp"
-#include "minko/particle/ParticleData.hpp"
+#include "minko/particle/ParticleStore.hpp"
 #include "minko/particle/sampler/Sampler.hpp"
+#include "minko/particle/sampler/Constant.hpp"
 #include "minko/particle/tools/VertexComponentFlags.hpp"
+#include "minko/particle/tools/kernels.hpp"
 
 using namespace minko;
 using namespace minko::particle;
@@ -36,30 +38,32 @@ VelocityOverTime::VelocityOverTime(SamplerPtr vx,
 }
 
 void
-VelocityOverTime::update(std::vector<ParticleData>& particles,
-		 		   		 float                      timeStep) const
+VelocityOverTime::update(ParticleStore&	particles,
+		 		   		 float			timeStep) const
 {
-	for (auto& particle : particles)
-    	if (particle.alive())
-	    	{
-                const float t = particle.lifetime > 0.0f
-                    ? particle.timeLived / particle.lifetime
-                    : 0.0f;
-
-                const float dx = _x->value(t) * timeStep;
-                const float dy = _y->value(t) * timeStep;
-                const float dz = _z->value(t) * timeStep;
-
-		    	particle.x += dx;
-			    particle.y += dy;
-			    particle.z += dz;
-		    }
+	kernel::addSampled(_x, particles.stream(ParticleStore::X), particles, timeStep);
+	kernel::addSampled(_y, particles.stream(ParticleStore::Y), particles, timeStep);
+	kernel::addSampled(_z, particles.stream(ParticleStore::Z), particles, timeStep);
 }
 
-
 unsigned int
 VelocityOverTime::getNeededComponents() const
 {
 	return VertexComponentFlags::DEFAULT;
 }
 
+bool
+VelocityOverTime::isTimeAnalytic() const
+{
+	return std::dynamic_pointer_cast<sampler::Constant<float>>(_x)
+		&& std::dynamic_pointer_cast<sampler::Constant<float>>(_y)
+		&& std::dynamic_pointer_cast<sampler::Constant<float>>(_z);
+}
+
+void
+VelocityOverTime::addAnalyticMotion(float* velocity, float* acceleration) const
+{
+	velocity[0] += _x->value(0.f);
+	velocity[1] += _y->value(0.f);
+	velocity[2] += _z->value(0.f);
+}
@@ -0,0 +1,164 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/ParticlesCommon.hpp"
+#include "minko/particle/ParticleStore.hpp"
+#include "minko/particle/sampler/Sampler.hpp"
+#include "minko/particle/sampler/Constant.hpp"
+#include "minko/particle/sampler/LinearlyInterpolatedValue.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+# define MINKO_PARTICLES_SSE
+# include <xmmintrin.h>
+#endif
+
+// SIMD kernels working on the contiguous streams of a ParticleStore. The scalar loops are
+// kept trivial so that compilers can auto-vectorize them on targets without SSE (NEON, asm.js).
+namespace minko
+{
+	namespace particle
+	{
+		namespace kernel
+		{
+			// out[i] += value
+			inline
+			void
+			add(float* out, float value, unsigned int n)
+			{
+				unsigned int i = 0;
+#ifdef MINKO_PARTICLES_SSE
+				const __m128 v = _mm_set1_ps(value);
+
+				for (; i + 4 <= n; i += 4)
+					_mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), v));
+#endif
+				for (; i < n; ++i)
+					out[i] += value;
+			}
+
+			// out[i] += in[i] * k
+			inline
+			void
+			multiplyAdd(float* out, const float* in, float k, unsigned int n)
+			{
+				unsigned int i = 0;
+#ifdef MINKO_PARTICLES_SSE
+				const __m128 kk = _mm_set1_ps(k);
+
+				for (; i + 4 <= n; i += 4)
+					_mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(in + i), kk)));
+#endif
+				for (; i < n; ++i)
+					out[i] += in[i] * k;
+			}
+
+			// out[i] += (start + delta * clamp((timeLived[i] / lifetime[i] - startTime) * invDeltaTime, 0, 1)) * k
+			inline
+			void
+			addOverLifetime(float*			out,
+							const float*	timeLived,
+							const float*	lifetime,
+							float			start,
+							float			delta,
+							float			startTime,
+							float			invDeltaTime,
+							float			k,
+							unsigned int	n)
+			{
+				unsigned int i = 0;
+#ifdef MINKO_PARTICLES_SSE
+				const __m128 zero	= _mm_setzero_ps();
+				const __m128 one	= _mm_set1_ps(1.0f);
+				const __m128 eps	= _mm_set1_ps(1e-6f);
+				const __m128 s		= _mm_set1_ps(start * k);
+				const __m128 d		= _mm_set1_ps(delta * k);
+				const __m128 st		= _mm_set1_ps(startTime);
+				const __m128 inv	= _mm_set1_ps(invDeltaTime);
+
+				for (; i + 4 <= n; i += 4)
+				{
+					__m128 t = _mm_div_ps(_mm_loadu_ps(timeLived + i), _mm_max_ps(_mm_loadu_ps(lifetime + i), eps));
+
+					t = _mm_min_ps(one, _mm_max_ps(zero, _mm_mul_ps(_mm_sub_ps(t, st), inv)));
+
+					_mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_add_ps(s, _mm_mul_ps(d, t))));
+				}
+#endif
+				for (; i < n; ++i)
+				{
+					const float t = std::min(1.0f, std::max(0.0f, (timeLived[i] / std::max(lifetime[i], 1e-6f) - startTime) * invDeltaTime));
+
+					out[i] += (start + delta * t) * k;
+				}
+			}
+
+			// out[i] += sampler(timeLived[i] / lifetime[i]) * k, using a SIMD kernel for the samplers that allow it
+			inline
+			void
+			addSampled(const std::shared_ptr<sampler::Sampler<float>>&	sampler,
+					   float*											out,
+					   const ParticleStore&								particles,
+					   float											k)
+			{
+				const unsigned int	n			= particles.liveCount();
+				const float*		timeLived	= particles.stream(ParticleStore::TIME_LIVED);
+				const float*		lifetime	= particles.stream(ParticleStore::LIFETIME);
+
+				if (n == 0 || sampler == nullptr)
+					return;
+
+				if (std::dynamic_pointer_cast<sampler::Constant<float>>(sampler))
+				{
+					add(out, sampler->value() * k, n);
+					return;
+				}
+
+				auto linear = std::dynamic_pointer_cast<sampler::LinearlyInterpolatedValue<float>>(sampler);
+
+				if (linear)
+				{
+					const float startTime	= linear->startTime();
+					const float deltaTime	= linear->endTime() - startTime;
+
+					addOverLifetime(
+						out, timeLived, lifetime,
+						linear->startValue(),
+						linear->endValue() - linear->startValue(),
+						startTime,
+						fabsf(deltaTime) < 1e-3f ? 0.0f : 1.0f / deltaTime,
+						k,
+						n
+					);
+					return;
+				}
+
+				// generic samplers (random values...) need one virtual call per particle
+				for (unsigned int i = 0; i < n; ++i)
+				{
+					const float t = lifetime[i] > 0.0f ? timeLived[i] / lifetime[i] : 0.0f;
+
+					out[i] += sampler->value(t) * k;
+				}
+			}
+		}
+	}
+}
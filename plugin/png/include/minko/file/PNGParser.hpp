@@ -21,14 +21,14 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 
 #include "minko/Common.hpp"
 
-#include "minko/file/AbstractParser.hpp"
+#include "minko/file/AbstractImageParser.hpp"
 
 namespace minko
 {
 	namespace file
 	{
 		class PNGParser :
-			public AbstractParser
+			public AbstractImageParser
 		{
 		public:
 			typedef std::shared_ptr<PNGParser> Ptr;
@@ -41,15 +41,20 @@ namespace minko
 				return std::shared_ptr<PNGParser>(new PNGParser());
 			}
 
-			void
-			parse(const std::string&				filename,
-				  const std::string&                resolvedFilename,
-                  std::shared_ptr<Options>          options,
-				  const std::vector<unsigned char>&	data,
-				  std::shared_ptr<AssetLibrary>	AssetLibrary);
+			/**
+			 * Decodes a PNG file to RGBA in a buffer taken from the PixelBufferPool. Thread-safe.
+			 */
+			static
+			bool
+			decode(const unsigned char*			data,
+				   std::size_t					size,
+				   uint&						width,
+				   uint&						height,
+				   std::vector<unsigned char>&	rgba);
 
 		private:
-			PNGParser()
+			PNGParser() :
+				AbstractImageParser("PNG", &PNGParser::decode)
 			{
 			}
 		};
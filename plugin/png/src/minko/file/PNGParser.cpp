@@ -19,59 +19,35 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 
 #include "minko/file/PNGParser.hpp"
 
-#include "minko/file/Options.hpp"
-#include "minko/file/AssetLibrary.hpp"
-#include "minko/render/Texture.hpp"
-#include "minko/render/CubeTexture.hpp"
+#include "minko/render/PixelBufferPool.hpp"
 
 #include "lodepng.h"
 
 using namespace minko;
 using namespace minko::file;
 
-void
-PNGParser::parse(const std::string&                 filename,
-                 const std::string&                 resolvedFilename,
-                 std::shared_ptr<Options>           options,
-                 const std::vector<unsigned char>&  data,
-                 std::shared_ptr<AssetLibrary>      AssetLibrary)
+bool
+PNGParser::decode(const unsigned char*			data,
+				  std::size_t					size,
+				  uint&							width,
+				  uint&							height,
+				  std::vector<unsigned char>&	rgba)
 {
-	std::vector<unsigned char> out;
-	unsigned int width;
-	unsigned int height;
+	lodepng::State state;
 
-	unsigned error = lodepng::decode(out, width, height, &data[0], data.size());
+	if (data == nullptr || lodepng_inspect(&width, &height, &state, data, size))
+		return false;
 
-	if (error)
-		throw std::invalid_argument("file " + filename + " is not a valid PNG file");
+	// lodepng appends to the vector: reserve the whole image in a recycled buffer
+	rgba = render::PixelBufferPool::acquire(width * height * sizeof(int));
+	rgba.clear();
 
-	render::AbstractTexture::Ptr texture = nullptr;
+	if (lodepng::decode(rgba, width, height, data, size))
+	{
+		render::PixelBufferPool::release(rgba);
 
-	if (!options->isCubeTexture())
-		texture	= render::Texture::create(
-			options->context(), 
-			width, 
-			height, 
-			options->generateMipmaps(), 
-			false, 
-			options->resizeSmoothly(), 
-			filename
-		);
-	else
-		texture = render::CubeTexture::create(
-			options->context(), 
-			width, 
-			height, 
-			options->generateMipmaps(), 
-			false, 
-			options->resizeSmoothly(), 
-			filename
-		);
+		return false;
+	}
 
-	texture->data(&out[0]);
-	texture->upload();
-
-	AssetLibrary->texture(filename, texture);
-
-	complete()->execute(shared_from_this());
+	return true;
 }
@@ -9,4 +9,8 @@
 #include "minko/file/MaterialParser.hpp"
 #include "minko/file/MaterialWriter.hpp"
 
+#include "minko/geometry/MeshSimplifier.hpp"
+
+#include "minko/component/SceneStreaming.hpp"
+
 
@@ -26,6 +26,11 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/file/AbstractWriter.hpp"
 #include "minko/render/AbstractContext.hpp"
 #include "minko/file/Options.hpp"
+#include "minko/file/GeometryWriter.hpp"
+#include "minko/geometry/Geometry.hpp"
+#include "minko/render/IndexBuffer.hpp"
+#include "minko/render/VertexBuffer.hpp"
+#include "minko/serialize/TypeSerializer.hpp"
 
 namespace minko
 {
@@ -78,12 +83,14 @@ namespace minko
 			assetStat(render::AbstractContext::Ptr			context,
 					  std::shared_ptr<file::AssetLibrary>	assets,
 					  std::string 							assetName, 
-					  AssetT								asset)
+					  AssetT								asset,
+					  std::shared_ptr<file::Options>		writerOptions = nullptr)
 			{
 				std::shared_ptr<WriterT>	writer			= WriterT::create();
+				std::string					filename		= "assetStat.tmp";
 				
 				writer->data(asset);
-				writer->write("assetStat.tmp", assets, nullptr);
+				writer->write(filename, assets, writerOptions);
 
 				std::shared_ptr<file::Options> options = file::Options::create(context);
 				std::vector<unsigned char>      _data;
@@ -103,26 +110,91 @@ namespace minko
 
 				std::cout << assetName << std::endl;
 				std::cout << "	Size : " << _data.size() << std::endl;
-				printValidation(asset, assetName, assets);
+				printValidation(asset, assetName, assets, writerOptions);
 				std::cout << std::endl;
 			}
 
+			/**
+			 * Prints, for each vertex attribute, the compression ratio of its stream encoded as
+			 * configured with file::Options::attributeEncoding() and the maximum error of the
+			 * decoded values, then the compression ratio of the indices.
+			 */
+			void
+			attributeStat(std::shared_ptr<geometry::Geometry>	original,
+						  std::shared_ptr<geometry::Geometry>	decoded,
+						  std::shared_ptr<file::Options>		options)
+			{
+				for (auto vertexBuffer : original->vertexBuffers())
+				{
+					for (auto attribute : vertexBuffer->attributes())
+					{
+						const std::string&	name		= std::get<0>(*attribute);
+						const uint			size		= std::get<1>(*attribute);
+						const uint			offset		= std::get<2>(*attribute);
+						auto				encoding	= options != nullptr ? options->attributeEncoding(name) : file::AttributeEncoding::RAW;
+						std::vector<float>	parameters;
+						std::string			stream		= file::GeometryWriter::serializeAttributeStream(
+							vertexBuffer, name, encoding, parameters
+						);
+						const float			rawSize		= float(vertexBuffer->numVertices() * size * sizeof (float));
+						float				maxError	= 0.f;
+
+						if (decoded != nullptr && decoded->hasVertexAttribute(name))
+						{
+							auto		decodedBuffer	= decoded->vertexBuffer(name);
+							const uint	decodedOffset	= std::get<2>(*decodedBuffer->attribute(name));
+
+							for (uint vertexId = 0; vertexId < vertexBuffer->numVertices(); ++vertexId)
+								for (uint i = 0; i < size; ++i)
+									maxError = std::max(maxError, fabsf(
+										vertexBuffer->data()[vertexId * vertexBuffer->vertexSize() + offset + i]
+										- decodedBuffer->data()[vertexId * decodedBuffer->vertexSize() + decodedOffset + i]
+									));
+						}
+
+						std::cout << "	Attribute " << name << std::endl;
+						std::cout << "		Encoding : " << static_cast<int>(encoding) << std::endl;
+						std::cout << "		Ratio : " << rawSize / float(stream.size() + parameters.size() * sizeof (float)) << std::endl;
+						std::cout << "		Max error : " << maxError << std::endl;
+					}
+				}
+
+				const auto& indices = original->indices()->data();
+
+				std::cout << "	Indices" << std::endl;
+				std::cout << "		Ratio : " << float(indices.size() * sizeof (unsigned short))
+					/ float(options != nullptr && options->compressIndices()
+						? serialize::TypeSerializer::serializeDeltaVector(indices).size()
+						: serialize::TypeSerializer::serializeRawVector<unsigned short>(indices).size())
+					<< std::endl;
+			}
+
 		private:
 			template <typename AssetT>
 			void
-			printValidation(AssetT originalAsset, std::string assetName, file::AssetLibrary::Ptr assets)
+			printValidation(AssetT							originalAsset,
+							std::string						assetName,
+							file::AssetLibrary::Ptr			assets,
+							std::shared_ptr<file::Options>	writerOptions)
 			{
 				std::cout << "	Valid : " << "can't compare" << std::endl;
 			}
 
 			void
-			printValidation(std::shared_ptr<geometry::Geometry> originalAsset, std::string assetName, file::AssetLibrary::Ptr assets)
+			printValidation(std::shared_ptr<geometry::Geometry>	originalAsset,
+							std::string							assetName,
+							file::AssetLibrary::Ptr				assets,
+							std::shared_ptr<file::Options>		writerOptions)
 			{
 				std::cout << "	Valid : " << originalAsset->equals(assets->geometry(assetName)) << std::endl;
+				attributeStat(originalAsset, assets->geometry(assetName), writerOptions);
 			}
 
 			void
-				printValidation(std::shared_ptr<material::Material> materialAsset, std::string assetName, file::AssetLibrary::Ptr assets)
+				printValidation(std::shared_ptr<material::Material>	materialAsset,
+								std::string							assetName,
+								file::AssetLibrary::Ptr				assets,
+								std::shared_ptr<file::Options>		writerOptions)
 			{
 				std::cout << "	Valid : ??????" << std::endl;
 			}
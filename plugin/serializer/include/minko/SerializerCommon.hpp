@@ -17,6 +17,16 @@ namespace minko
 		class HalfEdgeCollection;
 	}
 
+	namespace geometry
+	{
+		class MeshSimplifier;
+	}
+
+	namespace component
+	{
+		class SceneStreaming;
+	}
+
 	namespace deserialize
 	{
 		class ComponentDeserializer;
@@ -0,0 +1,325 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+#include "minko/SerializerCommon.hpp"
+
+#include "msgpack.hpp"
+#include "minko/Signal.hpp"
+#include "minko/component/AbstractScript.hpp"
+#include "minko/component/JobManager.hpp"
+
+namespace minko
+{
+	namespace component
+	{
+		/**
+		 * Streams the chunks written by file::SceneWriter::writeChunks() under the target node.
+		 *
+		 * Each frame, the distance between the camera and the bounding box of every chunk is computed
+		 * in the space of the target. The chunks closer than loadDistance() are loaded nearest first as
+		 * long as their estimated memory footprint fits in memoryBudget() (0 for no budget): when it does
+		 * not, loaded chunks farther than the candidate are unloaded to make room. Chunks farther than
+		 * unloadDistance() are unloaded.
+		 *
+		 * Loading is done by a JobManager::Job added to the JobManager of the target (created when
+		 * missing). Each step of the job does a bounded part of the work so that it is spread over the
+		 * frames according to the JobManager budget: the chunk file is read, its dependency table is
+		 * unpacked, its dependencies are loaded in a dedicated AssetLibrary a few at a time, its nodes
+		 * are built and finally added to the scene nodesPerStep() at a time. Unloading a chunk removes
+		 * its nodes and releases its AssetLibrary, hence its GPU resources.
+		 */
+		class SceneStreaming :
+			public AbstractScript
+		{
+		public:
+			typedef std::shared_ptr<SceneStreaming>								Ptr;
+			typedef msgpack::type::tuple<std::string, std::vector<float>, uint>	SerializedChunk;
+
+		private:
+			typedef std::shared_ptr<scene::Node>		NodePtr;
+			typedef std::shared_ptr<AbstractComponent>	AbsCmpPtr;
+			typedef std::shared_ptr<file::AssetLibrary>	AssetLibraryPtr;
+			typedef std::shared_ptr<file::Options>		OptionsPtr;
+			typedef std::shared_ptr<file::SceneParser>	SceneParserPtr;
+			typedef std::shared_ptr<math::Vector3>		Vector3Ptr;
+
+			class ChunkLoadingJob :
+				public JobManager::Job
+			{
+			public:
+				typedef std::shared_ptr<ChunkLoadingJob> Ptr;
+
+			private:
+				std::shared_ptr<SceneStreaming>	_streaming;
+				uint							_chunk;
+				NodePtr							_target;
+				float							_priority;
+				std::vector<unsigned char>		_data;
+				SceneParserPtr					_parser;
+				NodePtr							_root;
+				std::list<NodePtr>				_pendingNodes;
+				bool							_read;
+				bool							_dependenciesLoaded;
+				bool							_cancelled;
+
+			public:
+				static
+				Ptr
+				create(std::shared_ptr<SceneStreaming> streaming, uint chunk, NodePtr target, float priority)
+				{
+					return std::shared_ptr<ChunkLoadingJob>(new ChunkLoadingJob(streaming, chunk, target, priority));
+				}
+
+				void
+				cancel();
+
+				bool
+				complete();
+
+				void
+				beforeFirstStep();
+
+				void
+				step();
+
+				float
+				priority();
+
+				void
+				afterLastStep();
+
+			private:
+				ChunkLoadingJob(std::shared_ptr<SceneStreaming> streaming, uint chunk, NodePtr target, float priority);
+			};
+
+			struct Chunk
+			{
+				std::string				filename;
+				std::vector<float>		bounds;
+				uint					size;
+				AssetLibraryPtr			assetLibrary;
+				NodePtr					root;
+				ChunkLoadingJob::Ptr	job;
+			};
+
+		public:
+			static const uint	DEFAULT_NODES_PER_STEP;
+			static const uint	DEFAULT_LOADING_FRAMERATE;
+
+		private:
+			std::string								_folder;
+			OptionsPtr								_options;
+			NodePtr									_camera;
+			float									_loadDistance;
+			float									_unloadDistance;
+			uint									_memoryBudget;
+			uint									_nodesPerStep;
+
+			std::vector<Chunk>						_chunks;
+			uint									_memorySize;
+			NodePtr									_target;
+			JobManager::Ptr							_jobManager;
+			bool									_ownsJobManager;
+
+			std::shared_ptr<Signal<Ptr, uint>>		_chunkLoaded;
+			std::shared_ptr<Signal<Ptr, uint>>		_chunkUnloaded;
+
+		public:
+			/*
+			** The chunks of the manifest are streamed around the camera. Chunks are unloaded
+			** beyond 1.25 times the load distance unless unloadDistance() says otherwise.
+			*/
+			static
+			Ptr
+			create(const std::string&	filename,
+				   OptionsPtr			options,
+				   NodePtr				camera,
+				   float				loadDistance,
+				   uint					memoryBudget	= 0)
+			{
+				Ptr streaming(new SceneStreaming(options, camera, loadDistance, memoryBudget));
+
+				streaming->initialize();
+				streaming->readManifest(filename);
+
+				return streaming;
+			}
+
+			inline
+			uint
+			numChunks() const
+			{
+				return _chunks.size();
+			}
+
+			inline
+			const std::vector<float>&
+			chunkBounds(uint chunk) const
+			{
+				return _chunks[chunk].bounds;
+			}
+
+			inline
+			uint
+			chunkSize(uint chunk) const
+			{
+				return _chunks[chunk].size;
+			}
+
+			inline
+			bool
+			loaded(uint chunk) const
+			{
+				return _chunks[chunk].assetLibrary != nullptr && _chunks[chunk].job == nullptr;
+			}
+
+			uint
+			numLoadedChunks() const;
+
+			// estimated memory footprint of the chunks loaded or being loaded
+			inline
+			uint
+			memorySize() const
+			{
+				return _memorySize;
+			}
+
+			inline
+			NodePtr
+			camera() const
+			{
+				return _camera;
+			}
+
+			inline
+			void
+			camera(NodePtr value)
+			{
+				_camera = value;
+			}
+
+			inline
+			float
+			loadDistance() const
+			{
+				return _loadDistance;
+			}
+
+			inline
+			void
+			loadDistance(float value)
+			{
+				_loadDistance = value;
+			}
+
+			inline
+			float
+			unloadDistance() const
+			{
+				return _unloadDistance;
+			}
+
+			inline
+			void
+			unloadDistance(float value)
+			{
+				_unloadDistance = value;
+			}
+
+			inline
+			uint
+			memoryBudget() const
+			{
+				return _memoryBudget;
+			}
+
+			inline
+			void
+			memoryBudget(uint value)
+			{
+				_memoryBudget = value;
+			}
+
+			inline
+			uint
+			nodesPerStep() const
+			{
+				return _nodesPerStep;
+			}
+
+			void
+			nodesPerStep(uint value);
+
+			// distance from the camera to the chunk in the space of the target, 0 when inside
+			inline
+			float
+			distance(uint chunk) const
+			{
+				return distance(_chunks[chunk].bounds, cameraPosition());
+			}
+
+			inline
+			std::shared_ptr<Signal<Ptr, uint>>
+			chunkLoaded() const
+			{
+				return _chunkLoaded;
+			}
+
+			inline
+			std::shared_ptr<Signal<Ptr, uint>>
+			chunkUnloaded() const
+			{
+				return _chunkUnloaded;
+			}
+
+		protected:
+			void
+			targetAddedHandler(AbsCmpPtr cmp, NodePtr target);
+
+			void
+			targetRemovedHandler(AbsCmpPtr cmp, NodePtr target);
+
+			void
+			update(NodePtr target);
+
+		private:
+			SceneStreaming(OptionsPtr options, NodePtr camera, float loadDistance, uint memoryBudget);
+
+			void
+			readManifest(const std::string& filename);
+
+			Vector3Ptr
+			cameraPosition() const;
+
+			static
+			float
+			distance(const std::vector<float>& bounds, Vector3Ptr position);
+
+			void
+			unload(uint chunkId);
+
+			void
+			chunkLoadedHandler(uint chunkId);
+		};
+	}
+}
@@ -70,6 +70,8 @@ namespace minko
 				return std::shared_ptr<HalfEdgeCollection>(new HalfEdgeCollection(indexStream));
 			}
 
+			~HalfEdgeCollection();
+
 			inline 
 			std::list<HalfEdgeList> 
 			subMeshesList() const
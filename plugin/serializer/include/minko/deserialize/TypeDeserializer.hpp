@@ -20,6 +20,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #pragma once
 
 #include "minko/SerializerCommon.hpp"
+#include "minko/serialize/TypeSerializer.hpp"
 
 namespace minko
 {
@@ -36,6 +37,21 @@ namespace minko
 				stream.read(reinterpret_cast<char*>(&value), sizeof (ST));
 			}
 
+			template <typename ST>
+			static
+			ST
+			readLittleEndian(const char* source)
+			{
+				ST		value;
+				char*	bytes = reinterpret_cast<char*>(&value);
+
+				std::memcpy(bytes, source, sizeof (ST));
+				if (!serialize::TypeSerializer::isLittleEndian())
+					std::reverse(bytes, bytes + sizeof (ST));
+
+				return value;
+			}
+
 		public :
 
 			template <typename T, typename ST = T>
@@ -55,6 +71,85 @@ namespace minko
 				return result;
 			}
 
+			/**
+			 * Size in bytes of the elements of a vector serialized with
+			 * serialize::TypeSerializer::serializeRawVector(), 0 if the data is too short.
+			 */
+			inline static
+			uint
+			rawVectorElementSize(const char* data, uint size)
+			{
+				return size < serialize::TypeSerializer::RAW_VECTOR_HEADER_SIZE ? 0 : readLittleEndian<uint>(data + 4);
+			}
+
+			/**
+			 * Reads a vector serialized with serialize::TypeSerializer::serializeRawVector() into
+			 * result, with a single copy when no conversion is required.
+			 */
+			template <typename T, typename ST = T>
+			static
+			void
+			deserializeRawVector(const char* data, uint size, std::vector<T>& result)
+			{
+				const uint headerSize = serialize::TypeSerializer::RAW_VECTOR_HEADER_SIZE;
+
+				if (rawVectorElementSize(data, size) != sizeof (ST))
+					throw std::invalid_argument("data");
+
+				const uint numElements = readLittleEndian<uint>(data);
+
+				if (size - headerSize < numElements * sizeof (ST))
+					throw std::invalid_argument("size");
+
+				result.resize(numElements);
+				if (numElements == 0)
+					return;
+
+				if (sizeof (T) == sizeof (ST) && serialize::TypeSerializer::isLittleEndian())
+					std::memcpy(&result[0], data + headerSize, numElements * sizeof (ST));
+				else
+					for (uint i = 0; i < numElements; ++i)
+						result[i] = static_cast<T>(readLittleEndian<ST>(data + headerSize + i * sizeof (ST)));
+			}
+
+			/**
+			 * Reads an index stream written by serialize::TypeSerializer::serializeDeltaVector().
+			 */
+			static
+			void
+			deserializeDeltaVector(const char* data, uint size, std::vector<unsigned short>& result)
+			{
+				const uint headerSize = serialize::TypeSerializer::RAW_VECTOR_HEADER_SIZE;
+
+				if (size < headerSize || readLittleEndian<uint>(data + 4) != 0)
+					throw std::invalid_argument("data");
+
+				const uint	numElements	= readLittleEndian<uint>(data);
+				uint		position	= headerSize;
+				int			previous	= 0;
+
+				result.resize(numElements);
+				for (uint i = 0; i < numElements; ++i)
+				{
+					uint zigzag = 0;
+
+					for (uint shift = 0; ; shift += 7)
+					{
+						if (position >= size || shift > 28)
+							throw std::invalid_argument("size");
+
+						const unsigned char byte = data[position++];
+
+						zigzag |= uint(byte & 0x7f) << shift;
+						if ((byte & 0x80) == 0)
+							break;
+					}
+
+					previous += int(zigzag >> 1) ^ -int(zigzag & 1);
+					result[i] = static_cast<unsigned short>(previous);
+				}
+			}
+
 			static
 			Any
 			deserializeVector4(std::tuple<uint, std::string&>& serializedVector);
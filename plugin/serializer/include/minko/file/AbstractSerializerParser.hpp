@@ -52,6 +52,10 @@ namespace minko
 		private:
 			static std::unordered_map<uint, AssetDeserializeFunction> _assetTypeToFunction;
 
+			msgpack::type::tuple<std::vector<SerializedAsset>, std::string>	_serializedAssets;
+			std::string														_assetFilePath;
+			uint															_numLoadedDependencies;
+
 		public:
 			inline static
 			Ptr
@@ -76,6 +80,29 @@ namespace minko
 								std::shared_ptr<Options>			options,
 								std::string&						assetFilePath);
 
+			/*
+			** Unpacks the dependency table of data without loading any dependency.
+			*/
+			void
+			unpackDependencies(const std::vector<unsigned char>&	data,
+							   const std::string&					assetFilePath);
+
+			/*
+			** Loads at most maxNumDependencies of the unpacked dependencies, returns true once
+			** they are all loaded.
+			*/
+			bool
+			loadDependencies(AssetLibraryPtr			assetLibrary,
+							 std::shared_ptr<Options>	options,
+							 uint						maxNumDependencies);
+
+			inline
+			const std::string&
+			serializedData() const
+			{
+				return _serializedAssets.a1;
+			}
+
 			inline
 			void
 			dependecy(std::shared_ptr<Dependency> dependecies)
@@ -90,7 +117,14 @@ namespace minko
 			deserializedAsset(SerializedAsset					asset,
 							  AssetLibraryPtr					assetLibrary,
 							  std::shared_ptr<Options>			options,
-							  std::string&						assetFilePath);
+							  std::string&						assetFilePath,
+							  const std::vector<unsigned char>&	data);
+
+			static
+			void
+			readAssetData(const SerializedAsset&		asset,
+						  const std::string&			assetFilePath,
+						  std::vector<unsigned char>&	data);
 
 			std::string
 			extractFolderPath(const std::string& filepath);
@@ -68,6 +68,29 @@ namespace minko
 			write(std::string&					filename,
 				  std::shared_ptr<AssetLibrary>	assetLibrary,
 				  std::shared_ptr<Options>		options)
+			{
+				writeFile(filename, assetLibrary, options);
+
+				complete()->execute(this->shared_from_this());
+			}
+
+			virtual
+			std::string
+			embed(std::shared_ptr<AssetLibrary>		assetLibrary,
+				  std::shared_ptr<Options>			options,
+				  Dependency::Ptr					dependencies) = 0;
+			
+		protected:
+			AbstractWriter() :
+				_complete(Signal<Ptr>::create())
+			{
+			}
+
+			// writes the embedded data and its dependencies without notifying completion
+			void
+			writeFile(const std::string&			filename,
+					  std::shared_ptr<AssetLibrary>	assetLibrary,
+					  std::shared_ptr<Options>		options)
 			{
 				std::ofstream file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
 
@@ -87,20 +110,6 @@ namespace minko
 				}
 				else
 					std::cerr << "File " << filename << " can't be opened" << std::endl;
-
-				complete()->execute(this->shared_from_this());
-			}
-
-			virtual
-			std::string
-			embed(std::shared_ptr<AssetLibrary>		assetLibrary,
-				  std::shared_ptr<Options>			options,
-				  Dependency::Ptr					dependencies) = 0;
-			
-		protected:
-			AbstractWriter() :
-				_complete(Signal<Ptr>::create())
-			{
 			}
 		};
 	}
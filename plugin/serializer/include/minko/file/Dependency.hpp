@@ -150,6 +150,12 @@ namespace minko
 					  std::shared_ptr<file::Options>		options);
 
 		private:
+			static
+			bool
+			writeCompressedTexture(AbsTexturePtr				texture,
+								   const std::string&			filename,
+								   std::shared_ptr<Options>		options);
+
 			void
 			copyEffectDependency(std::string effectFile, std::shared_ptr<render::Effect> effect);
 
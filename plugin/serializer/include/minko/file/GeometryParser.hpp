@@ -35,10 +35,27 @@ namespace minko
 		typedef std::shared_ptr<render::IndexBuffer>		IndexBufferPtr;
 		typedef std::shared_ptr<render::VertexBuffer>		VertexBufferPtr;
 
+		// buffers of a geometry and of its levels of detail, decoded but not uploaded yet
+		struct DecodedGeometry
+		{
+			std::string						name;
+			IndexBufferPtr					indices;
+			std::vector<VertexBufferPtr>	vertexBuffers;
+			std::vector<IndexBufferPtr>		levels;
+		};
+
 	private:
 		typedef unsigned char																	uchar;
 		typedef msgpack::type::tuple<std::string, uchar, uchar>									SerializeAttribute;
 		typedef msgpack::type::tuple<uchar, std::string, std::string, std::vector<std::string>> SerializedGeometry;
+		typedef msgpack::type::tuple<uchar, std::string, std::string, std::vector<std::string>, std::vector<std::string>>
+																								SerializedGeometryWithLevels;
+		typedef msgpack::type::tuple<msgpack::type::raw_ref, std::vector<SerializeAttribute>>	SerializedRawVertex;
+		typedef msgpack::type::tuple<uchar, std::vector<float>, msgpack::type::raw_ref>			SerializedAttributeStream;
+		typedef msgpack::type::tuple<msgpack::type::raw_ref, std::vector<SerializeAttribute>, std::vector<SerializedAttributeStream>>
+																								SerializedEncodedVertex;
+		typedef msgpack::type::tuple<uchar, std::string, msgpack::type::raw_ref, std::vector<msgpack::type::raw_ref>, std::vector<msgpack::type::raw_ref>>
+																								SerializedRawGeometry;
 
 	private:
 		static std::function<IndexBufferPtr(std::string&, AbstractContextPtr)>	indexBufferParserFunction;
@@ -59,6 +76,23 @@ namespace minko
 			  const std::vector<unsigned char>&	data,
 			  std::shared_ptr<AssetLibrary>		assetLibrary);
 
+		/*
+		** CPU half of parse() for the geometries written with raw streams and without dependencies:
+		** neither the context nor the asset library are touched, so it can run on any thread.
+		** Returns false when the data must go through parse() instead.
+		*/
+		static
+		bool
+		decode(const std::vector<unsigned char>&	data,
+			   AbstractContextPtr					context,
+			   DecodedGeometry&					geometry);
+
+		// GPU half of parse(): uploads the buffers and adds the geometry and its levels to the library
+		void
+		addGeometry(DecodedGeometry&				geometry,
+					std::shared_ptr<Options>		options,
+					std::shared_ptr<AssetLibrary>	assetLibrary);
+
 		inline
 		static
 		void
@@ -87,6 +121,12 @@ namespace minko
 		void
 		initialize();
 
+		static
+		bool
+		decodeStreams(const std::string&	serializedGeometry,
+					  AbstractContextPtr	context,
+					  DecodedGeometry&		geometry);
+
 		static
 		VertexBufferPtr
 		deserializeVertexBuffer(std::string&		serializedVertexBuffer, 
@@ -97,6 +137,23 @@ namespace minko
 		deserializeIndexBuffer(std::string&			serializedIndexBuffer, 
 							   AbstractContextPtr	context);
 
+		static
+		VertexBufferPtr
+		deserializeRawVertexBuffer(const msgpack::type::raw_ref&	serializedVertexBuffer,
+								   AbstractContextPtr				context);
+
+		static
+		IndexBufferPtr
+		deserializeRawIndexBuffer(const msgpack::type::raw_ref&	serializedIndexBuffer,
+								  AbstractContextPtr				context);
+
+		static
+		void
+		deserializeAttributeStream(const SerializedAttributeStream&	serializedStream,
+								   uint								size,
+								   uint								offset,
+								   VertexBufferPtr					vertexBuffer);
+
 		static
 		IndexBufferPtr
 		deserializeIndexBufferChar(std::string&			serializedIndexBuffer, 
@@ -24,6 +24,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/geometry/Geometry.hpp"
 #include "msgpack.hpp"
 #include "minko/file/AssetLibrary.hpp"
+#include "minko/file/Options.hpp"
 #include "minko/file/Dependency.hpp"
 
 namespace minko
@@ -36,6 +37,8 @@ namespace minko
 		public:
 			typedef std::shared_ptr<GeometryWriter> Ptr;
 
+			typedef ::minko::file::AttributeEncoding AttributeEncoding;
+
 		private :
 			static std::function<std::string(std::shared_ptr<render::IndexBuffer>)>		indexBufferWriterFunction;
 			static std::function<std::string(std::shared_ptr<render::VertexBuffer>)>	vertexBufferWriterFunction;
@@ -54,24 +57,56 @@ namespace minko
 				  Dependency::Ptr					dependency)
 			{
 				geometry::Geometry::Ptr		geometry = data();
-				uint						metaByte = computeMetaByte(geometry);
+				const std::string&			name = assetLibrary->geometryName(geometry);
+				auto						levels = levelsOfDetail(assetLibrary, name, geometry);
+
+				// the written copies are optimized, the geometries of the AssetLibrary are left untouched
+				if (options != nullptr && options->optimizeGeometry())
+					geometry = optimize(name, geometry, levels);
+
+				uint						metaByte = computeMetaByte(geometry, levels, options != nullptr && options->compressIndices());
 				const std::string&			serializedIndexBuffer = indexBufferWriterFunction(geometry->indices());
 				std::vector<std::string>	serializedVertexBuffers;
 				std::stringstream			sbuf;
 
+				// the attribute encodings come with the options: without any, the registered function is used
 				for (std::shared_ptr<render::VertexBuffer> vertexBuffer : geometry->vertexBuffers())
-					serializedVertexBuffers.push_back(vertexBufferWriterFunction(vertexBuffer));
+					serializedVertexBuffers.push_back(hasEncodedAttribute(vertexBuffer, options)
+						? serializeEncodedVertexStream(vertexBuffer, options)
+						: vertexBufferWriterFunction(vertexBuffer));
+
+				std::vector<std::string> serializedLevels;
 
-				msgpack::type::tuple<unsigned char, std::string, std::string, std::vector<std::string>> res(
+				// the levels share the vertex buffers: only their index buffers are appended
+				for (auto& level : levels)
+					serializedLevels.push_back(indexBufferWriterFunction(level->indices()));
+
+				msgpack::type::tuple<unsigned char, std::string, std::string, std::vector<std::string>, std::vector<std::string>> res(
 					metaByte,
-					assetLibrary->geometryName(geometry), 
+					name, 
 					serializedIndexBuffer, 
-					serializedVertexBuffers);
+					serializedVertexBuffers,
+					serializedLevels);
+
 				msgpack::pack(sbuf, res);
 
 				return sbuf.str();
 			}
 
+			/**
+			 * Name under which the given level of detail (> 0) of a geometry is stored in the
+			 * AssetLibrary. The levels registered under these names and sharing all the vertex
+			 * buffers of the geometry (see geometry::MeshSimplifier) are written along with it,
+			 * and registered again under the same names by GeometryParser.
+			 */
+			inline
+			static
+			std::string
+			levelOfDetailName(const std::string& geometryName, uint level)
+			{
+				return geometryName + "_lod" + std::to_string(level);
+			}
+
 			inline
 			static
 			void
@@ -88,13 +123,47 @@ namespace minko
 				vertexBufferWriterFunction = f;
 			}
 
+			/**
+			 * Serialized stream of a single attribute of a vertex buffer, as embedded in the
+			 * geometry when its encoding is not RAW. encoding holds the requested encoding (see
+			 * Options::attributeEncoding()) and receives the one actually used, and parameters
+			 * receives the decoding parameters.
+			 */
+			static
+			std::string
+			serializeAttributeStream(std::shared_ptr<render::VertexBuffer>	vertexBuffer,
+									 const std::string&						attributeName,
+									 AttributeEncoding&						encoding,
+									 std::vector<float>&					parameters);
+
 		private:
 
 			void
 			initialize();
 
 			unsigned char
-			computeMetaByte(std::shared_ptr<geometry::Geometry> geometry);
+			computeMetaByte(std::shared_ptr<geometry::Geometry>					geometry,
+							const std::vector<std::shared_ptr<geometry::Geometry>>&	levels,
+							bool													compressIndices);
+
+			static
+			std::shared_ptr<geometry::Geometry>
+			optimize(const std::string&									name,
+					 std::shared_ptr<geometry::Geometry>					geometry,
+					 std::vector<std::shared_ptr<geometry::Geometry>>&		levels);
+
+			/**
+			 * Copy of the geometry sharing nothing but, unless copyVertices is true, its vertex buffers.
+			 */
+			static
+			std::shared_ptr<geometry::Geometry>
+			copyGeometry(std::shared_ptr<geometry::Geometry> geometry, bool copyVertices);
+
+			static
+			std::vector<std::shared_ptr<geometry::Geometry>>
+			levelsOfDetail(std::shared_ptr<AssetLibrary>		assetLibrary,
+						   const std::string&					name,
+						   std::shared_ptr<geometry::Geometry>	geometry);
 
 			static
 			std::string
@@ -104,10 +173,26 @@ namespace minko
 			std::string
 			serializeIndexStreamChar(std::shared_ptr<render::IndexBuffer> indexBuffer);
 
+			static
+			std::string
+			serializeIndexStreamDelta(std::shared_ptr<render::IndexBuffer> indexBuffer);
+
 			static
 			std::string
 			serializeVertexStream(std::shared_ptr<render::VertexBuffer> vertexBuffer);
 
+			static
+			bool
+			hasEncodedAttribute(std::shared_ptr<render::VertexBuffer> vertexBuffer, std::shared_ptr<Options> options);
+
+			static
+			std::string
+			serializeEncodedVertexStream(std::shared_ptr<render::VertexBuffer> vertexBuffer, std::shared_ptr<Options> options);
+
+			static
+			std::vector<msgpack::type::tuple<std::string, unsigned char, unsigned char>>
+			serializeAttributes(std::shared_ptr<render::VertexBuffer> vertexBuffer);
+
 			GeometryWriter()
 			{
 				initialize();
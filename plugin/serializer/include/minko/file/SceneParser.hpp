@@ -45,6 +45,10 @@ namespace minko
 
 		private:
 			static std::unordered_map<int8_t, ComponentReadFunction> _componentIdToReadFunction;
+
+			std::string					_filename;
+			std::shared_ptr<Options>	_options;
+			AssetLibraryPtr				_assetLibrary;
 		
 			// methods
 		public:
@@ -67,6 +71,25 @@ namespace minko
 				  const std::vector<unsigned char>&	data,
 				  AssetLibraryPtr					assetLibrary);
 
+			/*
+			** Parses the scene over several calls so that it can be spread over several frames:
+			** beginParse() unpacks the dependency table, each parseDependencies() call loads at
+			** most maxNumDependencies of them and returns true once they are all loaded, then
+			** endParse() builds the nodes and registers the scene as a symbol.
+			*/
+			void
+			beginParse(const std::string&					filename,
+					   const std::string&					resolvedFilename,
+					   std::shared_ptr<Options>				options,
+					   const std::vector<unsigned char>&	data,
+					   AssetLibraryPtr						assetLibrary);
+
+			bool
+			parseDependencies(uint maxNumDependencies);
+
+			void
+			endParse();
+
 		private:
 			std::shared_ptr<scene::Node>
 			parseNode(std::vector<SerializedNode>&	nodePack, 
@@ -36,6 +36,7 @@ namespace minko
 		public:
 			typedef std::shared_ptr<SceneWriter>										Ptr;
 			typedef msgpack::type::tuple<std::string, uint, uint, std::vector<uint>>	SerializedNode;
+			typedef msgpack::type::tuple<std::string, std::vector<float>, uint>			SerializedChunk;
 
 		private:
 			typedef std::shared_ptr<file::Dependency> 					DependencyPtr;
@@ -50,6 +51,8 @@ namespace minko
 		private:
 			static std::map<const std::type_info*, NodeWriterFunc> _componentIdToWriteFunction;
 
+			std::vector<NodePtr>	_chunkNodes;
+
 		// methods
 		public:
 
@@ -71,6 +74,21 @@ namespace minko
 					  OptionsPtr		options,
 					  DependencyPtr		dependency);
 
+			/*
+			** Splits the children of the root node into the cells of a regular grid of the given
+			** size according to the center of their bounding box and writes each cell as a
+			** standalone scene with its own dependencies. The file written to filename is the
+			** chunk manifest read by component::SceneStreaming: the file name, bounding box
+			** (relative to the root) and estimated memory footprint of each chunk. Children that
+			** have neither a surface nor a transform are written in a chunk with no bounding
+			** box that is always loaded.
+			*/
+			void
+			writeChunks(const std::string&	filename,
+						AssetLibraryPtr		assetLibrary,
+						OptionsPtr			options,
+						float				chunkSize);
+
 			SerializedNode
 			writeNode(std::shared_ptr<scene::Node>			node,
 					  std::vector<std::string>&				serializedControllerList,
@@ -86,6 +104,16 @@ namespace minko
 				return _data;
 			}
 
+			static
+			bool
+			computeBounds(NodePtr				node,
+						  NodePtr				root,
+						  std::vector<float>&	bounds);
+
+			static
+			uint
+			computeMemorySize(const std::vector<NodePtr>& nodes);
+
 		protected:
 			SceneWriter();
 		};
@@ -0,0 +1,101 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+	namespace geometry
+	{
+		/**
+		 * Reduces the number of triangles of a geometry by collapsing edges in the order of their
+		 * quadric error (Garland & Heckbert).
+		 *
+		 * The topology is read from a data::HalfEdgeCollection. Each collapse moves one vertex onto
+		 * the other end of the edge: no vertex is created, so the simplified geometries share the
+		 * vertex buffers of the source and only differ by their index buffer. Vertices on a border
+		 * of the half-edge structure (including the seams where vertices are split because of their
+		 * normals or texture coordinates) are never moved, which keeps the outline and the seams of
+		 * the mesh intact. Collapses that would flip a triangle or make the mesh non-manifold are
+		 * rejected.
+		 *
+		 * The vertex and index data must still be available on the CPU (see VertexBuffer::data()).
+		 */
+		class MeshSimplifier
+		{
+		public:
+			typedef std::shared_ptr<MeshSimplifier>	Ptr;
+
+		private:
+			typedef std::shared_ptr<Geometry>		GeometryPtr;
+
+		private:
+			float	_maxError;
+
+		public:
+			inline static
+			Ptr
+			create(float maxError = std::numeric_limits<float>::max())
+			{
+				return std::shared_ptr<MeshSimplifier>(new MeshSimplifier(maxError));
+			}
+
+			/**
+			 * Quadric error (squared distance, in model space units) above which edges are not collapsed.
+			 */
+			inline
+			float
+			maxError() const
+			{
+				return _maxError;
+			}
+
+			inline
+			void
+			maxError(float value)
+			{
+				_maxError = value;
+			}
+
+			/**
+			 * Returns a geometry with at most targetNumTriangles triangles, or as close as the
+			 * borders and maxError() allow.
+			 */
+			GeometryPtr
+			simplify(GeometryPtr geometry, uint targetNumTriangles) const;
+
+			/**
+			 * Returns numLevels geometries, each one with ratio times the triangles of the previous
+			 * one, ready to be given to component::LevelOfDetail::addLevels(). The chain stops early
+			 * when a level cannot be simplified any further.
+			 */
+			std::vector<GeometryPtr>
+			simplifyChain(GeometryPtr geometry, uint numLevels, float ratio = .5f) const;
+
+		private:
+			MeshSimplifier(float maxError) :
+				_maxError(maxError)
+			{
+			}
+		};
+	}
+}
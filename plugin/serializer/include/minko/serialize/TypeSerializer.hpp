@@ -35,7 +35,56 @@ namespace minko
 				stream.write(reinterpret_cast<const char*>(&value), sizeof (ST));
 			}
 
+			template <typename ST>
+			static void
+			writeLittleEndian(char* destination, ST value)
+			{
+				char* bytes = reinterpret_cast<char*>(&value);
+
+				if (!isLittleEndian())
+					std::reverse(bytes, bytes + sizeof (ST));
+				std::memcpy(destination, bytes, sizeof (ST));
+			}
+
 		public:
+			static const uint RAW_VECTOR_HEADER_SIZE = 8;
+
+			inline static
+			bool
+			isLittleEndian()
+			{
+				const unsigned short one = 1;
+
+				return *reinterpret_cast<const unsigned char*>(&one) == 1;
+			}
+
+			/**
+			 * Raw, little-endian layout: the number of elements and the size of an element as
+			 * 32 bits unsigned integers, followed by the elements themselves. The header keeps the
+			 * data 4 bytes aligned within the blob, so it can be copied or uploaded as a whole (see
+			 * deserialize::TypeDeserializer::deserializeRawVector()).
+			 */
+			template <typename T, typename ST = T>
+			static
+			std::string
+			serializeRawVector(const std::vector<T>& vect)
+			{
+				std::string result(RAW_VECTOR_HEADER_SIZE + vect.size() * sizeof (ST), 0);
+
+				writeLittleEndian<uint>(&result[0], vect.size());
+				writeLittleEndian<uint>(&result[4], sizeof (ST));
+
+				if (vect.empty())
+					return result;
+
+				if (sizeof (T) == sizeof (ST) && isLittleEndian())
+					std::memcpy(&result[RAW_VECTOR_HEADER_SIZE], &vect[0], vect.size() * sizeof (ST));
+				else
+					for (uint i = 0; i < vect.size(); ++i)
+						writeLittleEndian<ST>(&result[RAW_VECTOR_HEADER_SIZE + i * sizeof (ST)], static_cast<ST>(vect[i]));
+
+				return result;
+			}
 
 			template <typename T, typename ST = T>
 			static
@@ -50,6 +99,39 @@ namespace minko
 				return stream.str();
 			}
 
+			/**
+			 * Lossless compression of an index stream: the same header as serializeRawVector() with
+			 * an element size of 0, followed by the zigzag encoded differences between consecutive
+			 * indices stored as variable length integers (7 bits per byte).
+			 */
+			static
+			std::string
+			serializeDeltaVector(const std::vector<unsigned short>& vect)
+			{
+				std::string result(RAW_VECTOR_HEADER_SIZE, 0);
+				int			previous = 0;
+
+				writeLittleEndian<uint>(&result[0], vect.size());
+				writeLittleEndian<uint>(&result[4], 0);
+
+				for (auto value : vect)
+				{
+					const int	delta	= int(value) - previous;
+					uint		zigzag	= (uint(delta) << 1) ^ uint(delta >> 31);
+
+					while (zigzag >= 0x80)
+					{
+						result.push_back(char((zigzag & 0x7f) | 0x80));
+						zigzag >>= 7;
+					}
+					result.push_back(char(zigzag));
+
+					previous = value;
+				}
+
+				return result;
+			}
+
 			static
 			std::tuple<uint, std::string>
 			serializeVector4(Any value);
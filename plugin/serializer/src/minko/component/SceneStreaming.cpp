@@ -0,0 +1,410 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/component/SceneStreaming.hpp"
+
+#include "minko/scene/Node.hpp"
+#include "minko/component/Transform.hpp"
+#include "minko/file/AssetLibrary.hpp"
+#include "minko/file/Options.hpp"
+#include "minko/file/SceneParser.hpp"
+#include "minko/math/Matrix4x4.hpp"
+#include "minko/math/Vector3.hpp"
+
+#include <fstream>
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::math;
+
+const uint SceneStreaming::DEFAULT_NODES_PER_STEP		= 8;
+const uint SceneStreaming::DEFAULT_LOADING_FRAMERATE	= 30;
+
+SceneStreaming::ChunkLoadingJob::ChunkLoadingJob(std::shared_ptr<SceneStreaming>	streaming,
+												 uint								chunk,
+												 NodePtr							target,
+												 float								priority) :
+	_streaming(streaming),
+	_chunk(chunk),
+	_target(target),
+	_priority(priority),
+	_parser(nullptr),
+	_root(nullptr),
+	_read(false),
+	_dependenciesLoaded(false),
+	_cancelled(false)
+{
+}
+
+void
+SceneStreaming::ChunkLoadingJob::cancel()
+{
+	_cancelled = true;
+	_streaming = nullptr;
+	_data.clear();
+	_parser = nullptr;
+	_pendingNodes.clear();
+
+	if (_root != nullptr && _root->parent() != nullptr)
+		_root->parent()->removeChild(_root);
+	_root = nullptr;
+}
+
+bool
+SceneStreaming::ChunkLoadingJob::complete()
+{
+	return _cancelled || (_root != nullptr && _pendingNodes.empty());
+}
+
+void
+SceneStreaming::ChunkLoadingJob::beforeFirstStep()
+{
+}
+
+void
+SceneStreaming::ChunkLoadingJob::step()
+{
+	if (_cancelled)
+		return;
+
+	auto& chunk = _streaming->_chunks[_chunk];
+	if (!_read)
+	{
+		auto			flags = std::ios::in | std::ios::ate | std::ios::binary;
+		std::fstream	file(_streaming->_folder + chunk.filename, flags);
+
+		if (!file.is_open())
+			throw std::invalid_argument("chunk " + chunk.filename + " cannot be opened");
+
+		_data.resize((unsigned int)file.tellg());
+		file.seekg(0, std::ios::beg);
+		file.read((char*)&_data[0], _data.size());
+		file.close();
+
+		_read = true;
+	}
+	else if (_root == nullptr && _parser == nullptr)
+	{
+		_parser = file::SceneParser::create();
+		_parser->beginParse(chunk.filename, _streaming->_folder + chunk.filename, _streaming->_options, _data, chunk.assetLibrary);
+
+		_data.clear();
+		_data.shrink_to_fit();
+	}
+	else if (!_dependenciesLoaded)
+	{
+		// as many dependencies as there are parsing threads, so that each step keeps them all busy
+		_dependenciesLoaded = _parser->parseDependencies(_streaming->_options->numParsingJobs());
+	}
+	else if (_root == nullptr)
+	{
+		_parser->endParse();
+		_parser = nullptr;
+
+		// the chunk root enters the scene empty, its children follow nodesPerStep() at a time
+		_root = chunk.assetLibrary->symbol(chunk.filename);
+
+		auto children = _root->children();
+
+		for (auto& child : children)
+		{
+			_root->removeChild(child);
+			_pendingNodes.push_back(child);
+		}
+
+		chunk.root = _root;
+		_target->addChild(_root);
+	}
+	else
+	{
+		for (uint i = 0; i < _streaming->_nodesPerStep && !_pendingNodes.empty(); ++i)
+		{
+			_root->addChild(_pendingNodes.front());
+			_pendingNodes.pop_front();
+		}
+	}
+}
+
+float
+SceneStreaming::ChunkLoadingJob::priority()
+{
+	return _priority;
+}
+
+void
+SceneStreaming::ChunkLoadingJob::afterLastStep()
+{
+	if (_cancelled)
+		return;
+
+	auto streaming = _streaming;
+
+	_streaming = nullptr;
+	streaming->chunkLoadedHandler(_chunk);
+}
+
+SceneStreaming::SceneStreaming(OptionsPtr	options,
+							   NodePtr		camera,
+							   float		loadDistance,
+							   uint			memoryBudget) :
+	_options(options),
+	_camera(camera),
+	_loadDistance(loadDistance),
+	_unloadDistance(loadDistance * 1.25f),
+	_memoryBudget(memoryBudget),
+	_nodesPerStep(DEFAULT_NODES_PER_STEP),
+	_memorySize(0),
+	_target(nullptr),
+	_jobManager(nullptr),
+	_ownsJobManager(false),
+	_chunkLoaded(Signal<Ptr, uint>::create()),
+	_chunkUnloaded(Signal<Ptr, uint>::create())
+{
+}
+
+void
+SceneStreaming::readManifest(const std::string& filename)
+{
+	auto			flags = std::ios::in | std::ios::ate | std::ios::binary;
+	std::fstream	file(filename, flags);
+
+	if (!file.is_open())
+		throw std::invalid_argument("filename");
+
+	std::vector<char> data((unsigned int)file.tellg());
+
+	if (data.empty())
+		throw std::invalid_argument("filename");
+
+	file.seekg(0, std::ios::beg);
+	file.read(&data[0], data.size());
+	file.close();
+
+	msgpack::object										deserialized;
+	msgpack::zone										mempool;
+	msgpack::type::tuple<std::vector<SerializedChunk>>	manifest;
+
+	msgpack::unpack(&data[0], data.size(), NULL, &mempool, &deserialized);
+	deserialized.convert(&manifest);
+
+	auto separator = filename.find_last_of("/\\");
+
+	_folder = separator == std::string::npos ? "./" : filename.substr(0, separator + 1);
+
+	for (auto& serializedChunk : manifest.a0)
+	{
+		Chunk chunk;
+
+		chunk.filename	= serializedChunk.a0;
+		chunk.bounds	= serializedChunk.a1;
+		chunk.size		= serializedChunk.a2;
+
+		if (!chunk.bounds.empty() && chunk.bounds.size() != 6)
+			throw std::logic_error("invalid bounds for chunk " + chunk.filename);
+
+		_chunks.push_back(chunk);
+	}
+}
+
+void
+SceneStreaming::nodesPerStep(uint value)
+{
+	if (value == 0)
+		throw std::invalid_argument("value");
+
+	_nodesPerStep = value;
+}
+
+uint
+SceneStreaming::numLoadedChunks() const
+{
+	uint numLoadedChunks = 0;
+
+	for (uint i = 0; i < _chunks.size(); ++i)
+		if (loaded(i))
+			++numLoadedChunks;
+
+	return numLoadedChunks;
+}
+
+void
+SceneStreaming::targetAddedHandler(AbsCmpPtr cmp, NodePtr target)
+{
+	if (targets().size() > 1)
+		throw std::logic_error("SceneStreaming cannot have more than one target.");
+
+	AbstractScript::targetAddedHandler(cmp, target);
+
+	_target = target;
+	_ownsJobManager = !target->hasComponent<JobManager>();
+	_jobManager = _ownsJobManager
+		? JobManager::create(DEFAULT_LOADING_FRAMERATE)
+		: target->component<JobManager>();
+
+	if (_ownsJobManager)
+		target->addComponent(_jobManager);
+}
+
+void
+SceneStreaming::targetRemovedHandler(AbsCmpPtr cmp, NodePtr target)
+{
+	AbstractScript::targetRemovedHandler(cmp, target);
+
+	for (uint i = 0; i < _chunks.size(); ++i)
+		if (_chunks[i].assetLibrary != nullptr)
+			unload(i);
+
+	if (_ownsJobManager)
+		target->removeComponent(_jobManager);
+
+	_target = nullptr;
+	_jobManager = nullptr;
+	_ownsJobManager = false;
+}
+
+void
+SceneStreaming::update(NodePtr target)
+{
+	auto position = cameraPosition();
+
+	if (position == nullptr)
+		return;
+
+	auto				unloadDistance	= std::max(_unloadDistance, _loadDistance);
+	std::vector<float>	distances(_chunks.size());
+	std::vector<uint>	candidates;
+
+	for (uint i = 0; i < _chunks.size(); ++i)
+	{
+		distances[i] = distance(_chunks[i].bounds, position);
+
+		if (_chunks[i].assetLibrary == nullptr)
+		{
+			if (distances[i] <= _loadDistance)
+				candidates.push_back(i);
+		}
+		else if (distances[i] > unloadDistance)
+			unload(i);
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [&](uint a, uint b)
+	{
+		return distances[a] < distances[b];
+	});
+
+	for (auto candidate : candidates)
+	{
+		auto size = _chunks[candidate].size;
+
+		// make room by unloading the farthest chunks that are farther than the candidate
+		while (_memoryBudget != 0 && _memorySize + size > _memoryBudget)
+		{
+			int farthest = -1;
+
+			for (uint i = 0; i < _chunks.size(); ++i)
+				if (_chunks[i].assetLibrary != nullptr && distances[i] > distances[candidate]
+					&& (farthest < 0 || distances[i] > distances[farthest]))
+					farthest = i;
+
+			if (farthest < 0)
+				break;
+
+			unload(farthest);
+		}
+
+		if (_memoryBudget != 0 && _memorySize + size > _memoryBudget)
+			break;
+
+		auto& chunk = _chunks[candidate];
+
+		chunk.assetLibrary = file::AssetLibrary::create(_options->context());
+		// the nearest chunks are loaded first
+		chunk.job = ChunkLoadingJob::create(
+			std::static_pointer_cast<SceneStreaming>(shared_from_this()), candidate, _target, -distances[candidate]
+		);
+		_memorySize += size;
+		_jobManager->pushJob(chunk.job);
+	}
+}
+
+void
+SceneStreaming::unload(uint chunkId)
+{
+	auto&	chunk		= _chunks[chunkId];
+	bool	wasLoaded	= loaded(chunkId);
+
+	if (chunk.job != nullptr)
+		chunk.job->cancel();
+	if (chunk.root != nullptr && chunk.root->parent() != nullptr)
+		chunk.root->parent()->removeChild(chunk.root);
+
+	chunk.job = nullptr;
+	chunk.root = nullptr;
+	chunk.assetLibrary = nullptr;
+	_memorySize -= chunk.size;
+
+	if (wasLoaded)
+		_chunkUnloaded->execute(std::static_pointer_cast<SceneStreaming>(shared_from_this()), chunkId);
+}
+
+void
+SceneStreaming::chunkLoadedHandler(uint chunkId)
+{
+	_chunks[chunkId].job = nullptr;
+	_chunkLoaded->execute(std::static_pointer_cast<SceneStreaming>(shared_from_this()), chunkId);
+}
+
+SceneStreaming::Vector3Ptr
+SceneStreaming::cameraPosition() const
+{
+	if (_camera == nullptr || !_camera->hasComponent<Transform>())
+		return nullptr;
+
+	auto position = _camera->component<Transform>()->modelToWorldMatrix(true)->translation();
+
+	if (_target != nullptr && _target->hasComponent<Transform>())
+		position = Matrix4x4::create()
+			->copyFrom(_target->component<Transform>()->modelToWorldMatrix(true))
+			->invert()
+			->transform(position);
+
+	return position;
+}
+
+float
+SceneStreaming::distance(const std::vector<float>& bounds, Vector3Ptr position)
+{
+	if (position == nullptr)
+		return std::numeric_limits<float>::max();
+	if (bounds.empty())
+		return 0.f;
+
+	const float p[3]		= { position->x(), position->y(), position->z() };
+	float		distance	= 0.f;
+
+	for (uint i = 0; i < 3; ++i)
+	{
+		float delta = std::max(bounds[i] - p[i], std::max(0.f, p[i] - bounds[i + 3]));
+
+		distance += delta * delta;
+	}
+
+	return sqrtf(distance);
+}
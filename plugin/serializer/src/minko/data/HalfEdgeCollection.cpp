@@ -76,13 +76,6 @@ HalfEdgeCollection::initialize()
 		}
 	}
 
-	// debug
-	for (HalfEdgeMap::iterator it = map.begin(); it != map.end(); it++)
-	{
-		std::cout << it->first.first << "  " << it->first.second << std::endl;
-		std::cout << it->second << std::endl;
-	}
-
 	HalfEdgeMap unmarked(map.begin(), map.end());
 	computeList(unmarked);
 }
@@ -95,39 +88,44 @@ HalfEdgeCollection::computeList(HalfEdgeMap unmarked)
 	while (unmarked.begin() != unmarked.end())
 	{
 		HalfEdgeList currentList;
-		_subMeshesList.push_back(currentList);
+
 		queue.push(unmarked.begin()->second);
-		
+		queue.front()->marked(true);
+		unmarked.erase(unmarked.begin());
+
 		do
 		{
-			HalfEdgePtr he = queue.front();
+			HalfEdgePtr		he				= queue.front();
+			HalfEdgePtr		neighbors[3]	= { he->adjacent(), he->next(), he->prec() };
+
 			queue.pop();
 			currentList.push_back(he);
 
-			he->marked(true);		
-			unmarked.erase(std::make_pair(he->startNodeId(), he->endNodeId()));
-
-			if (he->adjacent() != nullptr && he->adjacent()->marked() == false)
-			{
-				HalfEdgeMap::iterator adjIt = unmarked.find(std::make_pair(he->adjacent()->startNodeId(), he->adjacent()->endNodeId()));
-				unmarked.erase(std::make_pair(he->adjacent()->startNodeId(), he->adjacent()->endNodeId()));
-				queue.push(he->adjacent());
-			}
-			if (he->next() != nullptr && he->next()->marked() == false)
+			// mark when queued so that a half-edge reached from several neighbors is listed once
+			for (auto neighbor : neighbors)
 			{
-				HalfEdgeMap::iterator adjIt = unmarked.find(std::make_pair(he->next()->startNodeId(), he->next()->endNodeId()));
-				unmarked.erase(std::make_pair(he->next()->startNodeId(), he->next()->endNodeId()));
-				queue.push(he->next());
-			}
-			if (he->prec() != nullptr && he->prec()->marked() == false)
-			{
-				HalfEdgeMap::iterator adjIt = unmarked.find(std::make_pair(he->prec()->startNodeId(), he->prec()->endNodeId()));
-				unmarked.erase(std::make_pair(he->prec()->startNodeId(), he->prec()->endNodeId()));
-				queue.push(he->prec());
+				if (neighbor == nullptr || neighbor->marked())
+					continue;
+
+				neighbor->marked(true);
+				unmarked.erase(std::make_pair(neighbor->startNodeId(), neighbor->endNodeId()));
+				queue.push(neighbor);
 			}
 		} while (queue.size() > 0);
+
+		_subMeshesList.push_back(currentList);
 	}
+}
 
-	// debug
-	std::cout << "Submeshes : " << _subMeshesList.size() << std::endl;
-}
\ No newline at end of file
+HalfEdgeCollection::~HalfEdgeCollection()
+{
+	// half-edges reference each other: break the cycles so that they can be released
+	for (auto& halfEdges : _subMeshesList)
+		for (auto& he : halfEdges)
+		{
+			he->next(nullptr);
+			he->prec(nullptr);
+			he->adjacent(nullptr);
+			he->face().clear();
+		}
+}
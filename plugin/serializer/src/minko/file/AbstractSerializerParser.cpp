@@ -30,6 +30,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/Types.hpp"
 #include "minko/render/Texture.hpp"
 
+#include <atomic>
+#include <future>
 
 using namespace minko;
 using namespace minko::file;
@@ -55,7 +57,8 @@ AbstractSerializerParser::create()
 	return abstractParser;
 }
 
-AbstractSerializerParser::AbstractSerializerParser()
+AbstractSerializerParser::AbstractSerializerParser() :
+	_numLoadedDependencies(0)
 {
 	_dependencies		= Dependency::create();
 }
@@ -76,48 +79,107 @@ AbstractSerializerParser::extractDependencies(AssetLibraryPtr						assetLibrary,
 											  std::shared_ptr<Options>				options,
 											  std::string&							assetFilePath)
 {
-	msgpack::object			msgpackObject;
-	msgpack::zone			mempool;
-	std::string				str(data.begin(), data.end());
-	msgpack::type::tuple<std::vector<SerializedAsset>, std::string> serilizedAssets;
+	unpackDependencies(data, assetFilePath);
+	loadDependencies(assetLibrary, options, _serializedAssets.a0.size());
 
-	msgpack::unpack(str.data(), str.size(), NULL, &mempool, &msgpackObject);
-	msgpackObject.convert(&serilizedAssets);
+	return _serializedAssets.a1;
+}
+
+void
+AbstractSerializerParser::unpackDependencies(const std::vector<unsigned char>&	data,
+											 const std::string&					assetFilePath)
+{
+	msgpack::object	msgpackObject;
+	msgpack::zone	mempool;
 
-	for (uint index = 0; index < serilizedAssets.a0.size(); ++index)
-		deserializedAsset(serilizedAssets.a0[index], assetLibrary, options, assetFilePath);
+	if (data.empty())
+		throw std::invalid_argument("data");
 
-	return serilizedAssets.a1;
+	msgpack::unpack(reinterpret_cast<const char*>(&data[0]), data.size(), NULL, &mempool, &msgpackObject);
+	msgpackObject.convert(&_serializedAssets);
+
+	_assetFilePath = assetFilePath;
+	_numLoadedDependencies = 0;
 }
 
-void
-AbstractSerializerParser::deserializedAsset(SerializedAsset				asset,
-											AssetLibraryPtr				assetLibrary,
-											std::shared_ptr<Options>	options,
-											std::string&				assetFilePath)
+bool
+AbstractSerializerParser::loadDependencies(AssetLibraryPtr			assetLibrary,
+										   std::shared_ptr<Options>	options,
+										   uint						maxNumDependencies)
 {
+	const auto&														assets		= _serializedAssets.a0;
+	const uint														firstAsset	= _numLoadedDependencies;
+	const uint														numAssets	= std::min<uint>(assets.size() - firstAsset, maxNumDependencies);
+	std::vector<std::vector<unsigned char>>							assetsData(numAssets);
+	std::vector<std::shared_ptr<GeometryParser::DecodedGeometry>>	geometries(numAssets);
+	std::atomic<uint>												nextAsset(0);
+	auto															context		= options->context();
 
-	std::vector<unsigned char>	data;
-	std::string					assetCompletePath	= assetFilePath + "/";
-	std::string					resolvedPath		= "";
-	unsigned char				metaByte			= (asset.a0 & 0xFF00) >> 8;
+	// reading an asset and decoding a geometry only depend on the asset itself: they are spread
+	// over the threads, then everything is registered on this thread in the order of the table
+	auto readAndDecode = [&]()
+	{
+		for (uint index = nextAsset++; index < numAssets; index = nextAsset++)
+		{
+			const uint assetType = assets[firstAsset + index].a0 & 0x00FF;
 
-	asset.a0 = asset.a0 & 0x00FF;
+			readAssetData(assets[firstAsset + index], _assetFilePath, assetsData[index]);
 
-	assetCompletePath += asset.a2;
-	resolvedPath = asset.a2;
+			if (assetType == serialize::AssetType::GEOMETRY_ASSET || assetType == serialize::AssetType::EMBED_GEOMETRY_ASSET)
+			{
+				auto geometry = std::make_shared<GeometryParser::DecodedGeometry>();
+
+				if (GeometryParser::decode(assetsData[index], context, *geometry))
+					geometries[index] = geometry;
+			}
+		}
+	};
+
+	const uint numJobs = std::min(options->numParsingJobs(), numAssets);
+
+	if (numJobs > 1)
+	{
+		std::vector<std::future<void>> jobs;
 
-	if (asset.a0 < 10) // external
+		for (uint i = 0; i < numJobs; ++i)
+			jobs.push_back(std::async(std::launch::async, readAndDecode));
+		for (auto& job : jobs)
+			job.get();
+	}
+	else
+		readAndDecode();
+
+	for (uint index = 0; index < numAssets; ++index)
 	{
-		auto							flags = std::ios::in | std::ios::ate | std::ios::binary;
-		std::fstream					file(assetCompletePath, flags);
+		if (geometries[index] != nullptr)
+		{
+			_geometryParser->dependecy(_dependencies);
+			_geometryParser->addGeometry(*geometries[index], options, assetLibrary);
+			_dependencies->registerReference(assets[firstAsset + index].a1, assetLibrary->geometry(_geometryParser->_lastParsedAssetName));
+		}
+		else
+			deserializedAsset(assets[firstAsset + index], assetLibrary, options, _assetFilePath, assetsData[index]);
+	}
+
+	_numLoadedDependencies += numAssets;
+
+	return _numLoadedDependencies == assets.size();
+}
+
+void
+AbstractSerializerParser::readAssetData(const SerializedAsset&		asset,
+										const std::string&			assetFilePath,
+										std::vector<unsigned char>&	data)
+{
+	if ((asset.a0 & 0x00FF) < 10) // external
+	{
+		auto			flags = std::ios::in | std::ios::ate | std::ios::binary;
+		std::fstream	file(assetFilePath + "/" + asset.a2, flags);
 	
 		if (file.is_open())
 		{
 			unsigned int size = (unsigned int)file.tellg();
 
-			// FIXME: use fixed size buffers and call _progress accordingly
-
 			data.resize(size);
 
 			file.seekg(0, std::ios::beg);
@@ -129,6 +191,23 @@ AbstractSerializerParser::deserializedAsset(SerializedAsset				asset,
 	}
 	else
 		std::copy(asset.a2.begin(), asset.a2.end(), back_inserter(data));
+}
+
+void
+AbstractSerializerParser::deserializedAsset(SerializedAsset						asset,
+											AssetLibraryPtr						assetLibrary,
+											std::shared_ptr<Options>			options,
+											std::string&						assetFilePath,
+											const std::vector<unsigned char>&	data)
+{
+	std::string					assetCompletePath	= assetFilePath + "/";
+	std::string					resolvedPath		= "";
+	unsigned char				metaByte			= (asset.a0 & 0xFF00) >> 8;
+
+	asset.a0 = asset.a0 & 0x00FF;
+
+	assetCompletePath += asset.a2;
+	resolvedPath = asset.a2;
 
 	if (asset.a0 == serialize::AssetType::GEOMETRY_ASSET || asset.a0 == serialize::AssetType::EMBED_GEOMETRY_ASSET) // geometry
 	{
@@ -156,7 +235,15 @@ AbstractSerializerParser::deserializedAsset(SerializedAsset				asset,
 			assetCompletePath += resolvedPath;
 		}
 
-		std::shared_ptr<file::AbstractParser> parser = assetLibrary->getParser("png");
+		auto extension = resolvedPath.substr(resolvedPath.find_last_of('.') + 1);
+
+		std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+		// textures used to be always embedded as PNG files
+		std::shared_ptr<file::AbstractParser> parser = assetLibrary->getParser(extension);
+
+		if (!parser)
+			parser = assetLibrary->getParser("png");
 
 		parser->parse(resolvedPath, assetCompletePath, options, data, assetLibrary);
 		_dependencies->registerReference(asset.a1, assetLibrary->texture(resolvedPath));
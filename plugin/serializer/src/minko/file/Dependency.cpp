@@ -21,6 +21,9 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/file/GeometryWriter.hpp"
 #include "minko/geometry/Geometry.hpp"
 #include "minko/file/MaterialWriter.hpp"
+#include "minko/file/KTXWriter.hpp"
+#include "minko/render/Texture.hpp"
+#include "minko/render/TextureCompression.hpp"
 
 using namespace minko;
 using namespace minko::file;
@@ -210,13 +213,21 @@ Dependency::serialize(std::shared_ptr<file::AssetLibrary>	assetLibrary,
 
 		for (int charIndex = filenameInput.size() - 1; charIndex >= 0 && filenameInput[charIndex] != '/'; --charIndex)
 			filenameOutput.insert(0, filenameInput.substr(charIndex, 1));
-		std::ifstream source(filenameInput, std::ios::binary);
-		std::ofstream dst(filenameOutput, std::ios::binary);
 
-		dst << source.rdbuf();
+		const auto ktxFilename = filenameOutput.substr(0, filenameOutput.find_last_of('.')) + ".ktx";
 
-		source.close();
-		dst.close();
+		if (writeCompressedTexture(itTexture->first, ktxFilename, options))
+			filenameOutput = ktxFilename;
+		else
+		{
+			std::ifstream source(filenameInput, std::ios::binary);
+			std::ofstream dst(filenameOutput, std::ios::binary);
+
+			dst << source.rdbuf();
+
+			source.close();
+			dst.close();
+		}
 
 		msgpack::type::tuple<short, short, std::string> res(2, itTexture->second, filenameOutput);
 		
@@ -252,6 +263,47 @@ Dependency::serialize(std::shared_ptr<file::AssetLibrary>	assetLibrary,
 	return serializedAsset;
 }
 
+bool
+Dependency::writeCompressedTexture(AbsTexturePtr				texture,
+								   const std::string&			filename,
+								   std::shared_ptr<Options>		options)
+{
+	auto texture2d		= std::dynamic_pointer_cast<render::Texture>(texture);
+	auto textureFormat	= options->textureFormat();
+
+	if (!texture2d)
+		return false;
+
+	// textures loaded from compressed files are written back as is
+	if (render::TextureCompression::isCompressed(texture2d->format()))
+	{
+		KTXWriter::create()->write(
+			filename, texture2d->format(), texture2d->width(), texture2d->height(), texture2d->compressedData()
+		);
+
+		return true;
+	}
+
+	if (!render::TextureCompression::isCompressed(textureFormat) || texture2d->data().empty())
+		return false;
+
+	const uint								numLevels	= texture2d->mipMapping() ? texture2d->numMipLevels() : 1;
+	std::vector<std::vector<unsigned char>>	levels(numLevels);
+
+	for (uint level = 0; level < numLevels; ++level)
+		render::TextureCompression::compress(
+			textureFormat,
+			std::max(1u, texture2d->width() >> level),
+			std::max(1u, texture2d->height() >> level),
+			texture2d->mipLevelData(level),
+			levels[level]
+		);
+
+	KTXWriter::create()->write(filename, textureFormat, texture2d->width(), texture2d->height(), levels);
+
+	return true;
+}
+
 void
 Dependency::copyEffectDependency(std::string effectFile, std::shared_ptr<render::Effect> effect)
 {
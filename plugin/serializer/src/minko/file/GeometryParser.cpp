@@ -18,6 +18,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 */
 
 #include "minko/file/GeometryParser.hpp"
+#include "minko/file/GeometryWriter.hpp"
 #include "minko/render/IndexBuffer.hpp"
 #include "minko/render/VertexBuffer.hpp"
 #include "msgpack.hpp"
@@ -32,6 +33,45 @@ using namespace minko::file;
 std::function<std::shared_ptr<render::IndexBuffer>(std::string&, std::shared_ptr<render::AbstractContext>)>		GeometryParser::indexBufferParserFunction;
 std::function<std::shared_ptr<render::VertexBuffer>(std::string&, std::shared_ptr<render::AbstractContext>)>	GeometryParser::vertexBufferParserFunction;
 
+namespace
+{
+	const float MAX_UNORM16 = 65535.f;
+	const float MAX_SNORM16 = 32767.f;
+
+	float
+	halfToFloat(unsigned short value)
+	{
+		const uint	sign		= uint(value & 0x8000) << 16;
+		uint		exponent	= (value >> 10) & 0x1f;
+		uint		mantissa	= value & 0x3ff;
+		uint		bits;
+
+		if (exponent == 0 && mantissa == 0)
+			bits = sign;
+		else if (exponent == 0)
+		{
+			// denormalized half: normalize it
+			exponent = 127 - 15 + 1;
+			while ((mantissa & 0x400) == 0)
+			{
+				mantissa <<= 1;
+				--exponent;
+			}
+			bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+		}
+		else if (exponent == 0x1f)
+			bits = sign | 0x7f800000 | (mantissa << 13);
+		else
+			bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+
+		float result;
+
+		std::memcpy(&result, &bits, sizeof (float));
+
+		return result;
+	}
+}
+
 void
 GeometryParser::initialize()
 {
@@ -82,34 +122,294 @@ GeometryParser::deserializeIndexBufferChar(std::string&								serializedIndexBu
 	return render::IndexBuffer::create(context, vector);
 }
 
+GeometryParser::VertexBufferPtr
+GeometryParser::deserializeRawVertexBuffer(const msgpack::type::raw_ref&	serializedVertexBuffer,
+										   AbstractContextPtr				context)
+{
+	msgpack::object		msgpackObject;
+	msgpack::zone		mempool;
+	SerializedRawVertex	deserializedVertex;
+
+	// the raw references point into the serialized data: the vertices are copied only once
+	msgpack::unpack(serializedVertexBuffer.ptr, serializedVertexBuffer.size, NULL, &mempool, &msgpackObject);
+	msgpackObject.convert(&deserializedVertex);
+
+	auto vertexBuffer = render::VertexBuffer::create(context);
+
+	for (auto& attribute : deserializedVertex.a1)
+		vertexBuffer->addAttribute(attribute.a0, attribute.a1, attribute.a2);
+
+	if (msgpackObject.via.array.size > 2)
+	{
+		// encoded attributes (see GeometryWriter::AttributeEncoding), stored as one stream each
+		SerializedEncodedVertex encodedVertex;
+
+		msgpackObject.convert(&encodedVertex);
+		if (encodedVertex.a2.size() != encodedVertex.a1.size())
+			throw std::invalid_argument("serializedVertexBuffer");
+
+		for (uint attributeId = 0; attributeId < encodedVertex.a2.size(); ++attributeId)
+			deserializeAttributeStream(
+				encodedVertex.a2[attributeId],
+				encodedVertex.a1[attributeId].a1,
+				encodedVertex.a1[attributeId].a2,
+				vertexBuffer
+			);
+	}
+	else
+		deserialize::TypeDeserializer::deserializeRawVector<float>(
+			deserializedVertex.a0.ptr, deserializedVertex.a0.size, vertexBuffer->data()
+		);
+
+	return vertexBuffer;
+}
+
+GeometryParser::IndexBufferPtr
+GeometryParser::deserializeRawIndexBuffer(const msgpack::type::raw_ref&	serializedIndexBuffer,
+										  AbstractContextPtr				context)
+{
+	auto		indexBuffer	= render::IndexBuffer::create(context);
+	const uint	elementSize	= deserialize::TypeDeserializer::rawVectorElementSize(
+		serializedIndexBuffer.ptr, serializedIndexBuffer.size
+	);
+
+	if (elementSize == 0)
+		deserialize::TypeDeserializer::deserializeDeltaVector(
+			serializedIndexBuffer.ptr, serializedIndexBuffer.size, indexBuffer->data()
+		);
+	else if (elementSize == 1)
+		deserialize::TypeDeserializer::deserializeRawVector<unsigned short, unsigned char>(
+			serializedIndexBuffer.ptr, serializedIndexBuffer.size, indexBuffer->data()
+		);
+	else
+		deserialize::TypeDeserializer::deserializeRawVector<unsigned short>(
+			serializedIndexBuffer.ptr, serializedIndexBuffer.size, indexBuffer->data()
+		);
+
+	return indexBuffer;
+}
+
+void
+GeometryParser::deserializeAttributeStream(const SerializedAttributeStream&	serializedStream,
+										   uint								size,
+										   uint								offset,
+										   VertexBufferPtr					vertexBuffer)
+{
+	typedef GeometryWriter::AttributeEncoding AttributeEncoding;
+
+	const auto			encoding	= static_cast<AttributeEncoding>(serializedStream.a0);
+	const auto&			parameters	= serializedStream.a1;
+	const char*			data		= serializedStream.a2.ptr;
+	const uint			dataSize	= serializedStream.a2.size;
+	const uint			vertexSize	= vertexBuffer->vertexSize();
+	auto&				vertices	= vertexBuffer->data();
+	std::vector<float>	values;
+
+	if (encoding == AttributeEncoding::QUANTIZED)
+	{
+		std::vector<unsigned short> quantized;
+
+		deserialize::TypeDeserializer::deserializeRawVector<unsigned short>(data, dataSize, quantized);
+		if (parameters.size() != size * 2)
+			throw std::invalid_argument("serializedStream");
+
+		values.resize(quantized.size());
+		for (uint i = 0; i < quantized.size(); ++i)
+		{
+			const uint component = i % size;
+
+			values[i] = parameters[component]
+				+ float(quantized[i]) / MAX_UNORM16 * (parameters[size + component] - parameters[component]);
+		}
+	}
+	else if (encoding == AttributeEncoding::OCTAHEDRAL)
+	{
+		std::vector<short> octahedral;
+
+		deserialize::TypeDeserializer::deserializeRawVector<short>(data, dataSize, octahedral);
+		if (size != 3)
+			throw std::invalid_argument("serializedStream");
+
+		values.resize(octahedral.size() / 2 * 3);
+		for (uint vertexId = 0; vertexId < octahedral.size() / 2; ++vertexId)
+		{
+			float x = std::max(-1.f, octahedral[vertexId * 2] / MAX_SNORM16);
+			float y = std::max(-1.f, octahedral[vertexId * 2 + 1] / MAX_SNORM16);
+			float z = 1.f - fabsf(x) - fabsf(y);
+
+			if (z < 0.f)
+			{
+				const float unfoldedX = (1.f - fabsf(y)) * (x >= 0.f ? 1.f : -1.f);
+				const float unfoldedY = (1.f - fabsf(x)) * (y >= 0.f ? 1.f : -1.f);
+
+				x = unfoldedX;
+				y = unfoldedY;
+			}
+
+			const float length = sqrtf(x * x + y * y + z * z);
+
+			values[vertexId * 3]		= x / length;
+			values[vertexId * 3 + 1]	= y / length;
+			values[vertexId * 3 + 2]	= z / length;
+		}
+	}
+	else if (encoding == AttributeEncoding::HALF_FLOAT)
+	{
+		std::vector<unsigned short> halfFloats;
+
+		deserialize::TypeDeserializer::deserializeRawVector<unsigned short>(data, dataSize, halfFloats);
+
+		values.resize(halfFloats.size());
+		for (uint i = 0; i < halfFloats.size(); ++i)
+			values[i] = halfToFloat(halfFloats[i]);
+	}
+	else if (encoding == AttributeEncoding::RAW)
+		deserialize::TypeDeserializer::deserializeRawVector<float>(data, dataSize, values);
+	else
+		throw std::invalid_argument("serializedStream");
+
+	const uint numVertices = values.size() / size;
+
+	if (vertices.empty())
+		vertices.resize(numVertices * vertexSize);
+	else if (vertices.size() != numVertices * vertexSize)
+		throw std::invalid_argument("serializedStream");
+
+	for (uint vertexId = 0; vertexId < numVertices; ++vertexId)
+		std::copy(
+			values.begin() + vertexId * size,
+			values.begin() + (vertexId + 1) * size,
+			vertices.begin() + vertexId * vertexSize + offset
+		);
+}
+
 void
 GeometryParser::parse(const std::string&				filename,
 					  const std::string&                resolvedFilename,
 					  std::shared_ptr<Options>          options,
 					  const std::vector<unsigned char>&	data,
 					  std::shared_ptr<AssetLibrary>		assetLibrary)
+{
+	std::string		folderPathName	= extractFolderPath(resolvedFilename);
+	std::string		str				= extractDependencies(assetLibrary, data, options, folderPathName);
+	DecodedGeometry	geometry;
+
+	if (!decodeStreams(str, options->context(), geometry))
+	{
+		msgpack::object		msgpackObject;
+		msgpack::zone		mempool;
+		SerializedGeometry	serializedGeometry;
+
+		msgpack::unpack(str.data(), str.size(), NULL, &mempool, &msgpackObject);
+		msgpackObject.convert(&serializedGeometry);
+		geometry.name = serializedGeometry.a1;
+
+		const uchar metaByte = serializedGeometry.a0;
+
+		computeMetaByte(metaByte);
+
+		geometry.indices = indexBufferParserFunction(serializedGeometry.a2, options->context());
+		for (auto& serializedVertexBuffer : serializedGeometry.a3)
+			geometry.vertexBuffers.push_back(vertexBufferParserFunction(serializedVertexBuffer, options->context()));
+
+		if (metaByte & (1u << 6))
+		{
+			SerializedGeometryWithLevels serializedGeometryWithLevels;
+
+			msgpackObject.convert(&serializedGeometryWithLevels);
+			for (auto& serializedLevel : serializedGeometryWithLevels.a4)
+				geometry.levels.push_back(indexBufferParserFunction(serializedLevel, options->context()));
+		}
+	}
+
+	addGeometry(geometry, options, assetLibrary);
+}
+
+bool
+GeometryParser::decode(const std::vector<unsigned char>&	data,
+					   AbstractContextPtr					context,
+					   DecodedGeometry&						geometry)
+{
+	msgpack::object														msgpackObject;
+	msgpack::zone														mempool;
+	msgpack::type::tuple<std::vector<SerializedAsset>, std::string>	serializedAssets;
+
+	if (data.empty())
+		throw std::invalid_argument("data");
+
+	msgpack::unpack(reinterpret_cast<const char*>(&data[0]), data.size(), NULL, &mempool, &msgpackObject);
+	msgpackObject.convert(&serializedAssets);
+
+	// dependencies are registered by parse()
+	return serializedAssets.a0.empty() && decodeStreams(serializedAssets.a1, context, geometry);
+}
+
+bool
+GeometryParser::decodeStreams(const std::string&	serializedGeometry,
+							  AbstractContextPtr	context,
+							  DecodedGeometry&		geometry)
 {
 	msgpack::object			msgpackObject;
 	msgpack::zone			mempool;
-	std::string				folderPathName = extractFolderPath(resolvedFilename);
-	std::string				str		= extractDependencies(assetLibrary, data, options, folderPathName);
-	geometry::Geometry::Ptr geom	= geometry::Geometry::create();
-	SerializedGeometry		serializedGeometry;
+	SerializedRawGeometry	rawGeometry;
+
+	msgpack::unpack(serializedGeometry.data(), serializedGeometry.size(), NULL, &mempool, &msgpackObject);
+
+	if (msgpackObject.type != msgpack::type::ARRAY || msgpackObject.via.array.size == 0)
+		throw std::invalid_argument("data");
+
+	if (!(msgpackObject.via.array.ptr[0].as<uchar>() & (1u << 5)))
+		return false;
+
+	msgpackObject.convert(&rawGeometry);
+	geometry.name = rawGeometry.a1;
+	geometry.indices = deserializeRawIndexBuffer(rawGeometry.a2, context);
+	for (auto& serializedVertexBuffer : rawGeometry.a3)
+		geometry.vertexBuffers.push_back(deserializeRawVertexBuffer(serializedVertexBuffer, context));
+	for (auto& serializedLevel : rawGeometry.a4)
+		geometry.levels.push_back(deserializeRawIndexBuffer(serializedLevel, context));
+
+	return true;
+}
+
+void
+GeometryParser::addGeometry(DecodedGeometry&				geometry,
+							std::shared_ptr<Options>		options,
+							std::shared_ptr<AssetLibrary>	assetLibrary)
+{
+	auto geom = geometry::Geometry::create();
+
+	// the buffers of the legacy streams are uploaded as soon as they are created
+	if (!geometry.indices->isReady())
+		geometry.indices->upload();
+	for (auto& vertexBuffer : geometry.vertexBuffers)
+		if (!vertexBuffer->isReady())
+			vertexBuffer->upload();
+	for (auto& level : geometry.levels)
+		if (!level->isReady())
+			level->upload();
+
+	geom->indices(geometry.indices);
+	for (auto& vertexBuffer : geometry.vertexBuffers)
+		geom->addVertexBuffer(vertexBuffer);
+
+	// the levels of detail, if any, only store their index buffer and share the vertex buffers
+	for (uint level = 0; level < geometry.levels.size(); ++level)
+	{
+		auto		levelGeometry	= geometry::Geometry::create();
+		const auto	levelName		= GeometryWriter::levelOfDetailName(geometry.name, level + 1);
 
-	msgpack::unpack(str.data(), str.size(), NULL, &mempool, &msgpackObject);
-	msgpackObject.convert(&serializedGeometry);
+		for (auto vertexBuffer : geom->vertexBuffers())
+			levelGeometry->addVertexBuffer(vertexBuffer);
+		levelGeometry->indices(geometry.levels[level]);
 
-	computeMetaByte(serializedGeometry.a0);
+		assetLibrary->geometry(levelName, options->geometryFunction()(levelName, levelGeometry));
+	}
 
-	geom->indices(indexBufferParserFunction(serializedGeometry.a2, options->context()));
-	
-	for (std::string serializedVertexBuffer : serializedGeometry.a3)
-		geom->addVertexBuffer(vertexBufferParserFunction(serializedVertexBuffer, options->context()));
-		
-	geom = options->geometryFunction()(serializedGeometry.a1, geom);
+	geom = options->geometryFunction()(geometry.name, geom);
 
-	assetLibrary->geometry(serializedGeometry.a1, geom);
-	_lastParsedAssetName = serializedGeometry.a1;
+	assetLibrary->geometry(geometry.name, geom);
+	_lastParsedAssetName = geometry.name;
 }
 
 void
@@ -27,6 +27,51 @@ using namespace minko::file;
 std::function<std::string(std::shared_ptr<render::IndexBuffer>)>	GeometryWriter::indexBufferWriterFunction;
 std::function<std::string(std::shared_ptr<render::VertexBuffer>)>	GeometryWriter::vertexBufferWriterFunction;
 
+namespace
+{
+	const float MAX_UNORM16 = 65535.f;
+	const float MAX_SNORM16 = 32767.f;
+
+	unsigned short
+	floatToHalf(float value)
+	{
+		uint bits;
+
+		std::memcpy(&bits, &value, sizeof (float));
+
+		const uint	sign		= (bits >> 16) & 0x8000;
+		const uint	exponent	= (bits >> 23) & 0xff;
+		uint		mantissa	= bits & 0x7fffff;
+		const int	halfExponent = int(exponent) - 127 + 15;
+
+		if (exponent == 0xff)
+			return sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0);
+		if (halfExponent >= 31)
+			return sign | 0x7c00;
+		if (halfExponent <= 0)
+		{
+			// denormalized half, or zero
+			if (halfExponent < -10)
+				return sign;
+
+			const uint shift = 14 - halfExponent;
+
+			mantissa |= 0x800000;
+
+			return sign | ((mantissa >> shift) + ((mantissa >> (shift - 1)) & 1));
+		}
+
+		// rounding to the nearest may carry into the exponent, which is still correct
+		return (sign | (halfExponent << 10) | (mantissa >> 13)) + ((mantissa >> 12) & 1);
+	}
+
+	short
+	snorm16(float value)
+	{
+		return short(roundf(std::max(-1.f, std::min(1.f, value)) * MAX_SNORM16));
+	}
+}
+
 void
 GeometryWriter::initialize()
 {
@@ -37,53 +82,205 @@ GeometryWriter::initialize()
 std::string
 GeometryWriter::serializeIndexStream(std::shared_ptr<render::IndexBuffer> indexBuffer)
 {
-	return serialize::TypeSerializer::serializeVector<unsigned short>(indexBuffer->data());
+	return serialize::TypeSerializer::serializeRawVector<unsigned short>(indexBuffer->data());
 }
 
 std::string
 GeometryWriter::serializeIndexStreamChar(std::shared_ptr<render::IndexBuffer> indexBuffer)
 {
-	return serialize::TypeSerializer::serializeVector<unsigned short, unsigned char>(indexBuffer->data());
+	return serialize::TypeSerializer::serializeRawVector<unsigned short, unsigned char>(indexBuffer->data());
 }
 
 std::string
-GeometryWriter::serializeVertexStream(std::shared_ptr<render::VertexBuffer> vertexBuffer)
+GeometryWriter::serializeIndexStreamDelta(std::shared_ptr<render::IndexBuffer> indexBuffer)
 {
-	std::list<render::VertexBuffer::AttributePtr>									attributes			= vertexBuffer->attributes();
-	std::vector<msgpack::type::tuple<std::string, unsigned char, unsigned char>>	serializedAttributes;
-	
-	auto attributesIt = attributes.begin();
-	
-	while (attributesIt != attributes.end())
+	return serialize::TypeSerializer::serializeDeltaVector(indexBuffer->data());
+}
+
+std::string
+GeometryWriter::serializeAttributeStream(std::shared_ptr<render::VertexBuffer>	vertexBuffer,
+										 const std::string&						attributeName,
+										 AttributeEncoding&						encoding,
+										 std::vector<float>&					parameters)
+{
+	const auto&	attribute	= *vertexBuffer->attribute(attributeName);
+	const uint	size		= std::get<1>(attribute);
+	const uint	offset		= std::get<2>(attribute);
+	const uint	vertexSize	= vertexBuffer->vertexSize();
+	const uint	numVertices	= vertexBuffer->numVertices();
+	const auto&	data		= vertexBuffer->data();
+
+	if (encoding == AttributeEncoding::OCTAHEDRAL && size != 3)
+		encoding = AttributeEncoding::RAW;
+
+	parameters.clear();
+
+	if (encoding == AttributeEncoding::QUANTIZED)
 	{
-		serializedAttributes.push_back(msgpack::type::tuple<std::string, unsigned char, unsigned char>(
-			std::get<0>((**attributesIt)), 
-			std::get<1>((**attributesIt)), 
-			std::get<2>((**attributesIt))));
+		// parameters: the minimum of each component, then their maximum
+		std::vector<unsigned short> quantized(numVertices * size);
 
-		attributesIt++;
+		parameters.resize(size * 2);
+		for (uint i = 0; i < size; ++i)
+		{
+			parameters[i]			= std::numeric_limits<float>::max();
+			parameters[size + i]	= -std::numeric_limits<float>::max();
+		}
+		for (uint vertexId = 0; vertexId < numVertices; ++vertexId)
+			for (uint i = 0; i < size; ++i)
+			{
+				const float value = data[vertexId * vertexSize + offset + i];
+
+				parameters[i]			= std::min(parameters[i], value);
+				parameters[size + i]	= std::max(parameters[size + i], value);
+			}
+
+		for (uint vertexId = 0; vertexId < numVertices; ++vertexId)
+			for (uint i = 0; i < size; ++i)
+			{
+				const float range = parameters[size + i] - parameters[i];
+				const float value = data[vertexId * vertexSize + offset + i];
+
+				quantized[vertexId * size + i] = range > 0.f
+					? (unsigned short)roundf((value - parameters[i]) / range * MAX_UNORM16)
+					: 0;
+			}
+
+		return serialize::TypeSerializer::serializeRawVector<unsigned short>(quantized);
+	}
+	else if (encoding == AttributeEncoding::OCTAHEDRAL)
+	{
+		std::vector<short> octahedral(numVertices * 2);
+
+		for (uint vertexId = 0; vertexId < numVertices; ++vertexId)
+		{
+			const float*	xyz		= &data[vertexId * vertexSize + offset];
+			const float		l1Norm	= fabsf(xyz[0]) + fabsf(xyz[1]) + fabsf(xyz[2]);
+			float			x		= l1Norm > 0.f ? xyz[0] / l1Norm : 0.f;
+			float			y		= l1Norm > 0.f ? xyz[1] / l1Norm : 0.f;
+
+			if (xyz[2] < 0.f)
+			{
+				// fold the lower hemisphere over the diagonals of the square
+				const float foldedX = (1.f - fabsf(y)) * (x >= 0.f ? 1.f : -1.f);
+				const float foldedY = (1.f - fabsf(x)) * (y >= 0.f ? 1.f : -1.f);
+
+				x = foldedX;
+				y = foldedY;
+			}
+
+			octahedral[vertexId * 2]		= snorm16(x);
+			octahedral[vertexId * 2 + 1]	= snorm16(y);
+		}
+
+		return serialize::TypeSerializer::serializeRawVector<short>(octahedral);
+	}
+	else if (encoding == AttributeEncoding::HALF_FLOAT)
+	{
+		std::vector<unsigned short> halfFloats(numVertices * size);
+
+		for (uint vertexId = 0; vertexId < numVertices; ++vertexId)
+			for (uint i = 0; i < size; ++i)
+				halfFloats[vertexId * size + i] = floatToHalf(data[vertexId * vertexSize + offset + i]);
+
+		return serialize::TypeSerializer::serializeRawVector<unsigned short>(halfFloats);
 	}
 
-	std::string serializedVector = serialize::TypeSerializer::serializeVector<float>(vertexBuffer->data());
+	std::vector<float> values(numVertices * size);
+
+	for (uint vertexId = 0; vertexId < numVertices; ++vertexId)
+		for (uint i = 0; i < size; ++i)
+			values[vertexId * size + i] = data[vertexId * vertexSize + offset + i];
+
+	return serialize::TypeSerializer::serializeRawVector<float>(values);
+}
+
+std::string
+GeometryWriter::serializeVertexStream(std::shared_ptr<render::VertexBuffer> vertexBuffer)
+{
+	std::stringstream sbuf;
 
-	std::stringstream			sbuf;
 	msgpack::type::tuple<std::string, std::vector<msgpack::type::tuple<std::string, unsigned char, unsigned char>>> res(
-		serializedVector,
-		serializedAttributes);
+		serialize::TypeSerializer::serializeRawVector<float>(vertexBuffer->data()),
+		serializeAttributes(vertexBuffer));
 
 	msgpack::pack(sbuf, res);
 
 	return sbuf.str();
 }
 
+bool
+GeometryWriter::hasEncodedAttribute(std::shared_ptr<render::VertexBuffer> vertexBuffer, std::shared_ptr<Options> options)
+{
+	if (options == nullptr)
+		return false;
+
+	for (auto& attribute : vertexBuffer->attributes())
+		if (options->attributeEncoding(std::get<0>(*attribute)) != AttributeEncoding::RAW)
+			return true;
+
+	return false;
+}
+
+std::string
+GeometryWriter::serializeEncodedVertexStream(std::shared_ptr<render::VertexBuffer> vertexBuffer, std::shared_ptr<Options> options)
+{
+	// one stream per attribute instead of the interleaved vertices, see GeometryParser::deserializeRawVertexBuffer()
+	std::vector<msgpack::type::tuple<unsigned char, std::vector<float>, std::string>>	serializedStreams;
+	std::stringstream																	sbuf;
+
+	for (auto& attribute : vertexBuffer->attributes())
+	{
+		AttributeEncoding	encoding	= options->attributeEncoding(std::get<0>(*attribute));
+		std::vector<float>	parameters;
+		std::string			stream		= serializeAttributeStream(vertexBuffer, std::get<0>(*attribute), encoding, parameters);
+
+		serializedStreams.push_back(msgpack::type::tuple<unsigned char, std::vector<float>, std::string>(
+			static_cast<unsigned char>(encoding),
+			parameters,
+			stream));
+	}
+
+	msgpack::type::tuple<std::string, std::vector<msgpack::type::tuple<std::string, unsigned char, unsigned char>>,
+		std::vector<msgpack::type::tuple<unsigned char, std::vector<float>, std::string>>> res(
+		serialize::TypeSerializer::serializeRawVector<float>(std::vector<float>()),
+		serializeAttributes(vertexBuffer),
+		serializedStreams);
+
+	msgpack::pack(sbuf, res);
+
+	return sbuf.str();
+}
+
+std::vector<msgpack::type::tuple<std::string, unsigned char, unsigned char>>
+GeometryWriter::serializeAttributes(std::shared_ptr<render::VertexBuffer> vertexBuffer)
+{
+	std::vector<msgpack::type::tuple<std::string, unsigned char, unsigned char>> serializedAttributes;
+
+	for (auto& attribute : vertexBuffer->attributes())
+		serializedAttributes.push_back(msgpack::type::tuple<std::string, unsigned char, unsigned char>(
+			std::get<0>(*attribute),
+			std::get<1>(*attribute),
+			std::get<2>(*attribute)));
+
+	return serializedAttributes;
+}
+
 unsigned char
-GeometryWriter::computeMetaByte(std::shared_ptr<geometry::Geometry> geometry)
+GeometryWriter::computeMetaByte(std::shared_ptr<geometry::Geometry>						geometry,
+								const std::vector<std::shared_ptr<geometry::Geometry>>&	levels,
+								bool													compressIndices)
 {
-	std::vector<unsigned short>::iterator maxIndice = std::max_element(geometry->indices()->data().begin(), geometry->indices()->data().end());
+	unsigned short maxIndice = *std::max_element(geometry->indices()->data().begin(), geometry->indices()->data().end());
+
+	for (auto& level : levels)
+		maxIndice = std::max(maxIndice, *std::max_element(level->indices()->data().begin(), level->indices()->data().end()));
 
 	unsigned char metaByte = 0x00;
 	
-	if (*maxIndice <= 255)
+	if (compressIndices)
+		indexBufferWriterFunction	= std::bind(&GeometryWriter::serializeIndexStreamDelta, std::placeholders::_1);
+	else if (maxIndice <= 255)
 	{
 		metaByte += 1u << 7;
 		indexBufferWriterFunction	= std::bind(&GeometryWriter::serializeIndexStreamChar, std::placeholders::_1);
@@ -91,5 +288,86 @@ GeometryWriter::computeMetaByte(std::shared_ptr<geometry::Geometry> geometry)
 	else
 		indexBufferWriterFunction	= std::bind(&GeometryWriter::serializeIndexStream, std::placeholders::_1);
 
+	if (!levels.empty())
+		metaByte += 1u << 6;
+
+	// raw little-endian streams, see GeometryParser::deserializeRawVertexBuffer()
+	metaByte += 1u << 5;
+
 	return metaByte;
-}
\ No newline at end of file
+}
+
+std::vector<std::shared_ptr<geometry::Geometry>>
+GeometryWriter::levelsOfDetail(std::shared_ptr<AssetLibrary>		assetLibrary,
+							   const std::string&					name,
+							   std::shared_ptr<geometry::Geometry>	geometry)
+{
+	std::vector<std::shared_ptr<geometry::Geometry>> levels;
+
+	for (uint level = 1; ; ++level)
+	{
+		auto levelGeometry = assetLibrary->geometry(levelOfDetailName(name, level));
+
+		if (!levelGeometry || !levelGeometry->indices() || levelGeometry->indices()->data().empty()
+			|| levelGeometry->vertexBuffers() != geometry->vertexBuffers())
+			break;
+
+		levels.push_back(levelGeometry);
+	}
+
+	return levels;
+}
+
+std::shared_ptr<geometry::Geometry>
+GeometryWriter::optimize(const std::string&									name,
+						 std::shared_ptr<geometry::Geometry>					geometry,
+						 std::vector<std::shared_ptr<geometry::Geometry>>&		levels)
+{
+#ifdef DEBUG
+	const float acmr = geometry->averageCacheMissRatio();
+#endif
+
+	// the levels of detail index the same vertex buffers: the vertices cannot be renumbered
+	const bool	reorderVertices	= levels.empty();
+	auto		optimized		= copyGeometry(geometry, reorderVertices);
+
+	optimized->optimize(geometry::Geometry::DEFAULT_VERTEX_CACHE_SIZE, true, reorderVertices);
+	for (auto& level : levels)
+	{
+		level = copyGeometry(level, false);
+		level->optimize(geometry::Geometry::DEFAULT_VERTEX_CACHE_SIZE, true, false);
+	}
+
+#ifdef DEBUG
+	std::cout << "GeometryWriter: optimized geometry '" << name << "', ACMR "
+		<< acmr << " -> " << optimized->averageCacheMissRatio() << std::endl;
+#endif
+
+	return optimized;
+}
+
+std::shared_ptr<geometry::Geometry>
+GeometryWriter::copyGeometry(std::shared_ptr<geometry::Geometry> geometry, bool copyVertices)
+{
+	auto copy = geometry::Geometry::create();
+
+	for (auto& vertexBuffer : geometry->vertexBuffers())
+	{
+		if (!copyVertices)
+		{
+			copy->addVertexBuffer(vertexBuffer);
+			continue;
+		}
+
+		auto vertexBufferCopy = render::VertexBuffer::create(vertexBuffer->context(), vertexBuffer->data());
+
+		for (auto& attribute : vertexBuffer->attributes())
+			vertexBufferCopy->addAttribute(std::get<0>(*attribute), std::get<1>(*attribute), std::get<2>(*attribute));
+		copy->addVertexBuffer(vertexBufferCopy);
+	}
+
+	if (geometry->indices())
+		copy->indices(render::IndexBuffer::create(geometry->indices()->context(), geometry->indices()->data()));
+
+	return copy;
+}
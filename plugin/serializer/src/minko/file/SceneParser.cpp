@@ -35,7 +35,9 @@ using namespace minko::math;
 std::unordered_map<int8_t, SceneParser::ComponentReadFunction> SceneParser::_componentIdToReadFunction;
 
 
-SceneParser::SceneParser()
+SceneParser::SceneParser() :
+	_options(nullptr),
+	_assetLibrary(nullptr)
 {
 	_geometryParser = file::GeometryParser::create();
 	_materialParser = file::MaterialParser::create();
@@ -114,19 +116,57 @@ SceneParser::parse(const std::string&					filename,
 				   std::shared_ptr<Options>				options,
 				   const std::vector<unsigned char>&	data,
 				   AssetLibraryPtr					    assetLibrary)
+{
+	beginParse(filename, resolvedFilename, options, data, assetLibrary);
+	parseDependencies(std::numeric_limits<uint>::max());
+	endParse();
+}
+
+void
+SceneParser::beginParse(const std::string&					filename,
+						const std::string&					resolvedFilename,
+						std::shared_ptr<Options>			options,
+						const std::vector<unsigned char>&	data,
+						AssetLibraryPtr						assetLibrary)
 {
 	_dependencies->options(options);
 
+	_filename = filename;
+	_options = options;
+	_assetLibrary = assetLibrary;
+
+	unpackDependencies(data, extractFolderPath(resolvedFilename));
+}
+
+bool
+SceneParser::parseDependencies(uint maxNumDependencies)
+{
+	if (_assetLibrary == nullptr)
+		throw std::logic_error("beginParse() must be called first");
+
+	return loadDependencies(_assetLibrary, _options, maxNumDependencies);
+}
+
+void
+SceneParser::endParse()
+{
+	if (_assetLibrary == nullptr)
+		throw std::logic_error("beginParse() must be called first");
+
 	msgpack::object		deserialized;
 	msgpack::zone		mempool;
-	std::string 		folderPath = extractFolderPath(resolvedFilename);
-	std::string			str = extractDependencies(assetLibrary, data, options, folderPath);
+	const std::string&	str				= serializedData();
+	auto				assetLibrary	= _assetLibrary;
+	auto				options			= _options;
+
+	_assetLibrary = nullptr;
+	_options = nullptr;
 
 	msgpack::unpack(str.data(), str.size(), NULL, &mempool, &deserialized);
 	msgpack::type::tuple<std::vector<std::string>, std::vector<SerializedNode>> dst;
 	deserialized.convert(&dst);
 
-	assetLibrary->symbol(filename, parseNode(dst.a1, dst.a0, assetLibrary, options));
+	assetLibrary->symbol(_filename, parseNode(dst.a1, dst.a0, assetLibrary, options));
 
 	if (_jobList.size() > 0)
 	{
@@ -135,7 +175,7 @@ SceneParser::parse(const std::string&					filename,
 		for (auto it = _jobList.begin(); it != _jobList.end(); ++it)
 			jobManager->pushJob(*it);
 
-		assetLibrary->symbol(filename)->addComponent(jobManager);
+		assetLibrary->symbol(_filename)->addComponent(jobManager);
 	}
 
 	complete()->execute(shared_from_this());
@@ -30,15 +30,54 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/component/Surface.hpp"
 #include "minko/component/Renderer.hpp"
 #include "minko/file/Dependency.hpp"
+#include "minko/geometry/Geometry.hpp"
+#include "minko/render/IndexBuffer.hpp"
+#include "minko/render/VertexBuffer.hpp"
+#include "minko/math/Matrix4x4.hpp"
+#include "minko/scene/NodeSet.hpp"
 #include "minko/serialize/ComponentSerializer.hpp"
 #include "minko/Types.hpp"
 
 #include <queue>
+#include <set>
 #include <iostream>
 #include <fstream>
 
 using namespace minko;
 using namespace minko::file;
+using namespace minko::math;
+
+namespace
+{
+	// transform of the node relative to the ancestor
+	Matrix4x4::Ptr
+	relativeMatrix(scene::Node::Ptr node, scene::Node::Ptr ancestor)
+	{
+		auto matrix = Matrix4x4::create();
+
+		for (; node != ancestor; node = node->parent())
+			if (node->hasComponent<component::Transform>())
+				matrix->append(node->component<component::Transform>()->matrix());
+
+		return matrix;
+	}
+
+	void
+	addPoint(const std::vector<float>& m, float x, float y, float z, std::vector<float>& bounds)
+	{
+		const float p[3] = {
+			m[0] * x + m[1] * y + m[2] * z + m[3],
+			m[4] * x + m[5] * y + m[6] * z + m[7],
+			m[8] * x + m[9] * y + m[10] * z + m[11]
+		};
+
+		for (uint i = 0; i < 3; ++i)
+		{
+			bounds[i] = std::min(bounds[i], p[i]);
+			bounds[i + 3] = std::max(bounds[i + 3], p[i]);
+		}
+	}
+}
 
 std::map<const std::type_info*, SceneWriter::NodeWriterFunc> SceneWriter::_componentIdToWriteFunction;
 
@@ -127,7 +166,15 @@ SceneWriter::embed(AssetLibraryPtr		assetLibrary,
 	std::vector<std::string>						serializedControllerList;
 	std::map<AbsComponentPtr, int>					controllerMap;
 
-	queue.push(data());
+	if (_chunkNodes.empty())
+		queue.push(data());
+	else
+	{
+		// chunks are written under a component-less copy of the root
+		nodePack.push_back(SerializedNode(data()->name(), data()->layouts(), _chunkNodes.size(), std::vector<uint>()));
+		for (auto& node : _chunkNodes)
+			queue.push(node);
+	}
 
 	while (queue.size() > 0)
 	{
@@ -186,3 +233,184 @@ SceneWriter::writeNode(std::shared_ptr<scene::Node>		node,
 	return res;
 }
 
+
+
+void
+SceneWriter::writeChunks(const std::string&	filename,
+						 AssetLibraryPtr	assetLibrary,
+						 OptionsPtr			options,
+						 float				chunkSize)
+{
+	if (chunkSize <= 0.f)
+		throw std::invalid_argument("chunkSize");
+
+	std::map<std::tuple<int, int, int>, std::vector<NodePtr>>	cells;
+	std::vector<NodePtr>										persistentNodes;
+	auto														children	= data()->children();
+
+	for (auto& child : children)
+	{
+		std::vector<float> bounds;
+
+		if (!computeBounds(child, data(), bounds))
+		{
+			persistentNodes.push_back(child);
+			continue;
+		}
+
+		cells[std::make_tuple(
+			(int)floorf((bounds[0] + bounds[3]) * .5f / chunkSize),
+			(int)floorf((bounds[1] + bounds[4]) * .5f / chunkSize),
+			(int)floorf((bounds[2] + bounds[5]) * .5f / chunkSize)
+		)].push_back(child);
+	}
+
+	std::vector<std::vector<NodePtr>> chunks;
+
+	if (!persistentNodes.empty())
+		chunks.push_back(persistentNodes);
+	for (auto& cell : cells)
+		chunks.push_back(cell.second);
+
+	auto							separator	= filename.find_last_of("/\\");
+	auto							folder		= separator == std::string::npos ? std::string() : filename.substr(0, separator + 1);
+	auto							name		= filename.substr(folder.size());
+	std::vector<SerializedChunk>	manifest;
+
+	name = name.substr(0, name.find_last_of('.'));
+
+	for (uint i = 0; i < chunks.size(); ++i)
+	{
+		std::vector<float>	bounds;
+		std::string			chunkFilename	= name + "_" + std::to_string(i) + ".scene";
+
+		for (auto& node : chunks[i])
+		{
+			std::vector<float> nodeBounds;
+
+			if (!computeBounds(node, data(), nodeBounds))
+				continue;
+
+			if (bounds.empty())
+				bounds = nodeBounds;
+			else
+				for (uint j = 0; j < 3; ++j)
+				{
+					bounds[j] = std::min(bounds[j], nodeBounds[j]);
+					bounds[j + 3] = std::max(bounds[j + 3], nodeBounds[j + 3]);
+				}
+		}
+
+		_chunkNodes = chunks[i];
+		writeFile(folder + chunkFilename, assetLibrary, options);
+		manifest.push_back(SerializedChunk(chunkFilename, bounds, computeMemorySize(chunks[i])));
+	}
+
+	_chunkNodes.clear();
+
+	std::ofstream		file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	std::stringstream	sbuf;
+
+	if (!file)
+		throw std::invalid_argument("filename");
+
+	msgpack::pack(sbuf, msgpack::type::tuple<std::vector<SerializedChunk>>(manifest));
+	file.write(sbuf.str().c_str(), sbuf.str().size());
+	file.close();
+
+	complete()->execute(shared_from_this());
+}
+
+bool
+SceneWriter::computeBounds(NodePtr				node,
+						   NodePtr				root,
+						   std::vector<float>&	bounds)
+{
+	auto descendants = scene::NodeSet::create(node)->descendants(true);
+
+	bounds.assign(6, 0.f);
+	for (uint i = 0; i < 3; ++i)
+	{
+		bounds[i] = std::numeric_limits<float>::max();
+		bounds[i + 3] = -std::numeric_limits<float>::max();
+	}
+
+	bool hasSurface = false;
+
+	for (auto& descendant : descendants->nodes())
+	{
+		for (auto& surface : descendant->components<component::Surface>())
+		{
+			auto geometry = surface->geometry();
+
+			if (!geometry->hasVertexAttribute("position"))
+				continue;
+
+			auto	positions	= geometry->vertexBuffer("position");
+			auto&	data		= positions->data();
+			uint	offset		= std::get<2>(*positions->attribute("position"));
+			float	min[3]		= { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+			float	max[3]		= { -min[0], -min[1], -min[2] };
+
+			if (data.empty())
+				continue;
+
+			for (uint i = offset; i < data.size(); i += positions->vertexSize())
+				for (uint j = 0; j < 3; ++j)
+				{
+					min[j] = std::min(min[j], data[i + j]);
+					max[j] = std::max(max[j], data[i + j]);
+				}
+
+			// the transformed corners of the local box bound the transformed vertices
+			const auto& m = relativeMatrix(descendant, root)->data();
+
+			for (uint corner = 0; corner < 8; ++corner)
+				addPoint(
+					m,
+					corner & 1 ? max[0] : min[0],
+					corner & 2 ? max[1] : min[1],
+					corner & 4 ? max[2] : min[2],
+					bounds
+				);
+
+			hasSurface = true;
+		}
+	}
+
+	if (hasSurface)
+		return true;
+
+	if (!node->hasComponent<component::Transform>())
+		return false;
+
+	addPoint(relativeMatrix(node, root)->data(), 0.f, 0.f, 0.f, bounds);
+
+	return true;
+}
+
+uint
+SceneWriter::computeMemorySize(const std::vector<NodePtr>& nodes)
+{
+	std::set<std::shared_ptr<geometry::Geometry>>	geometries;
+	uint											size	= 0;
+
+	for (auto& node : nodes)
+	{
+		auto descendants = scene::NodeSet::create(node)->descendants(true);
+
+		for (auto& descendant : descendants->nodes())
+			for (auto& surface : descendant->components<component::Surface>())
+				geometries.insert(surface->geometry());
+	}
+
+	for (auto& geometry : geometries)
+	{
+		for (auto& vertexBuffer : geometry->vertexBuffers())
+			size += vertexBuffer->data().size() * sizeof(float);
+		if (geometry->indices())
+			size += geometry->indices()->data().size() * sizeof(unsigned short);
+	}
+
+	return size;
+}
@@ -0,0 +1,359 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/geometry/MeshSimplifier.hpp"
+
+#include "minko/geometry/Geometry.hpp"
+#include "minko/render/IndexBuffer.hpp"
+#include "minko/render/VertexBuffer.hpp"
+#include "minko/data/HalfEdge.hpp"
+#include "minko/data/HalfEdgeCollection.hpp"
+
+using namespace minko;
+using namespace minko::geometry;
+
+namespace
+{
+	// collapses rotating the normal of a remaining triangle by more than ~75 degrees are rejected
+	const float MIN_NORMAL_COSINE = .25f;
+
+	// symmetric 4x4 matrix of the sum of the squared distances to a set of planes
+	struct Quadric
+	{
+		double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+
+		Quadric() :
+			a2(0.), ab(0.), ac(0.), ad(0.), b2(0.), bc(0.), bd(0.), c2(0.), cd(0.), d2(0.)
+		{
+		}
+
+		void
+		addPlane(double a, double b, double c, double d, double weight)
+		{
+			a2 += weight * a * a;	ab += weight * a * b;	ac += weight * a * c;	ad += weight * a * d;
+			b2 += weight * b * b;	bc += weight * b * c;	bd += weight * b * d;
+			c2 += weight * c * c;	cd += weight * c * d;
+			d2 += weight * d * d;
+		}
+
+		Quadric&
+		operator+=(const Quadric& q)
+		{
+			a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+			b2 += q.b2; bc += q.bc; bd += q.bd;
+			c2 += q.c2; cd += q.cd;
+			d2 += q.d2;
+
+			return *this;
+		}
+
+		double
+		error(const float* p) const
+		{
+			const double x = p[0];
+			const double y = p[1];
+			const double z = p[2];
+
+			return a2 * x * x + 2. * ab * x * y + 2. * ac * x * z + 2. * ad * x
+				+ b2 * y * y + 2. * bc * y * z + 2. * bd * y
+				+ c2 * z * z + 2. * cd * z
+				+ d2;
+		}
+	};
+
+	struct Collapse
+	{
+		double			cost;
+		unsigned short	from;
+		unsigned short	to;
+		uint			fromVersion;
+		uint			toVersion;
+
+		bool
+		operator<(const Collapse& other) const
+		{
+			// std::priority_queue pops the largest element first
+			return cost > other.cost;
+		}
+	};
+
+	void
+	normal(const float* p0, const float* p1, const float* p2, float* out)
+	{
+		const float ux = p1[0] - p0[0], uy = p1[1] - p0[1], uz = p1[2] - p0[2];
+		const float vx = p2[0] - p0[0], vy = p2[1] - p0[1], vz = p2[2] - p0[2];
+
+		out[0] = uy * vz - uz * vy;
+		out[1] = uz * vx - ux * vz;
+		out[2] = ux * vy - uy * vx;
+	}
+}
+
+MeshSimplifier::GeometryPtr
+MeshSimplifier::simplify(GeometryPtr geometry, uint targetNumTriangles) const
+{
+	if (!geometry)
+		throw std::invalid_argument("geometry");
+
+	auto indexBuffer	= geometry->indices();
+	auto vertexBuffer	= geometry->hasVertexAttribute("position") ? geometry->vertexBuffer("position") : nullptr;
+
+	if (!indexBuffer || indexBuffer->data().empty() || !vertexBuffer || vertexBuffer->data().empty())
+		throw std::logic_error("The geometry has no index or vertex data to simplify.");
+
+	const auto&					vertexData			= vertexBuffer->data();
+	const uint					vertexSize			= vertexBuffer->vertexSize();
+	const uint					positionOffset		= std::get<2>(*vertexBuffer->attribute("position"));
+	const uint					numVertices			= vertexBuffer->numVertices();
+	std::vector<unsigned short>	triangles			= indexBuffer->data();
+	const uint					numInputTriangles	= triangles.size() / 3;
+	uint						numTriangles		= numInputTriangles;
+
+	auto position = [&](unsigned short vertex) -> const float*
+	{
+		return &vertexData[vertex * vertexSize + positionOffset];
+	};
+
+	std::vector<Quadric>			quadrics(numVertices);
+	std::vector<std::vector<uint>>	vertexTriangles(numVertices);
+	std::vector<bool>				aliveTriangles(numInputTriangles, true);
+	std::vector<bool>				locked(numVertices, false);
+	std::vector<bool>				removed(numVertices, false);
+	std::vector<uint>				versions(numVertices, 0);
+
+	for (uint triangle = 0; triangle < numInputTriangles; ++triangle)
+	{
+		const unsigned short*	t = &triangles[triangle * 3];
+		float					n[3];
+
+		normal(position(t[0]), position(t[1]), position(t[2]), n);
+
+		const double length = sqrt((double)n[0] * n[0] + (double)n[1] * n[1] + (double)n[2] * n[2]);
+
+		if (length == 0. || t[0] == t[1] || t[1] == t[2] || t[2] == t[0])
+		{
+			aliveTriangles[triangle] = false;
+			--numTriangles;
+			continue;
+		}
+
+		const double	a	= n[0] / length;
+		const double	b	= n[1] / length;
+		const double	c	= n[2] / length;
+		const double	d	= -(a * position(t[0])[0] + b * position(t[0])[1] + c * position(t[0])[2]);
+
+		// area weighted, so that slivers do not weigh as much as large faces
+		for (uint i = 0; i < 3; ++i)
+		{
+			quadrics[t[i]].addPlane(a, b, c, d, length * .5);
+			vertexTriangles[t[i]].push_back(triangle);
+		}
+	}
+
+	// borders and edges
+	std::vector<std::pair<unsigned short, unsigned short>> edges;
+	auto halfEdges = data::HalfEdgeCollection::create(indexBuffer);
+
+	for (auto& subMesh : halfEdges->subMeshesList())
+		for (auto& halfEdge : subMesh)
+		{
+			const unsigned short start	= halfEdge->startNodeId();
+			const unsigned short end	= halfEdge->endNodeId();
+
+			if (start == end)
+				continue;
+
+			if (halfEdge->adjacent() == nullptr)
+			{
+				locked[start]	= true;
+				locked[end]		= true;
+			}
+			if (halfEdge->adjacent() == nullptr || start < end)
+				edges.push_back(std::make_pair(start, end));
+		}
+
+	std::priority_queue<Collapse> collapses;
+
+	auto pushCollapse = [&](unsigned short u, unsigned short v)
+	{
+		if (locked[u] && locked[v])
+			return;
+
+		Quadric q = quadrics[u];
+
+		q += quadrics[v];
+
+		const double	uToV	= locked[u] ? std::numeric_limits<double>::max() : q.error(position(v));
+		const double	vToU	= locked[v] ? std::numeric_limits<double>::max() : q.error(position(u));
+		Collapse		collapse;
+
+		collapse.cost			= std::max(0., std::min(uToV, vToU));
+		collapse.from			= uToV <= vToU ? u : v;
+		collapse.to				= uToV <= vToU ? v : u;
+		collapse.fromVersion	= versions[collapse.from];
+		collapse.toVersion		= versions[collapse.to];
+		collapses.push(collapse);
+	};
+
+	auto neighbors = [&](unsigned short vertex, std::vector<unsigned short>& out)
+	{
+		out.clear();
+		for (auto triangle : vertexTriangles[vertex])
+			if (aliveTriangles[triangle])
+				for (uint i = 0; i < 3; ++i)
+				{
+					const unsigned short neighbor = triangles[triangle * 3 + i];
+
+					if (neighbor != vertex && std::find(out.begin(), out.end(), neighbor) == out.end())
+						out.push_back(neighbor);
+				}
+	};
+
+	for (auto& edge : edges)
+		pushCollapse(edge.first, edge.second);
+
+	std::vector<unsigned short> fromNeighbors;
+	std::vector<unsigned short> toNeighbors;
+
+	while (numTriangles > targetNumTriangles && !collapses.empty())
+	{
+		const Collapse collapse = collapses.top();
+
+		collapses.pop();
+
+		if (removed[collapse.from] || removed[collapse.to]
+			|| versions[collapse.from] != collapse.fromVersion || versions[collapse.to] != collapse.toVersion)
+			continue;
+		if (collapse.cost > _maxError)
+			break;
+
+		// link condition: an interior edge shares exactly two neighbors with its ends
+		neighbors(collapse.from, fromNeighbors);
+		neighbors(collapse.to, toNeighbors);
+
+		uint numSharedNeighbors = 0;
+
+		for (auto neighbor : fromNeighbors)
+			if (std::find(toNeighbors.begin(), toNeighbors.end(), neighbor) != toNeighbors.end())
+				++numSharedNeighbors;
+
+		if (numSharedNeighbors > 2)
+			continue;
+
+		// reject collapses that flip or fold one of the remaining triangles
+		bool flips = false;
+
+		for (auto triangle : vertexTriangles[collapse.from])
+		{
+			const unsigned short* t = &triangles[triangle * 3];
+
+			if (!aliveTriangles[triangle] || t[0] == collapse.to || t[1] == collapse.to || t[2] == collapse.to)
+				continue;
+
+			const float*	p[3]	= { position(t[0]), position(t[1]), position(t[2]) };
+			float			before[3];
+			float			after[3];
+
+			normal(p[0], p[1], p[2], before);
+			for (uint i = 0; i < 3; ++i)
+				if (t[i] == collapse.from)
+					p[i] = position(collapse.to);
+			normal(p[0], p[1], p[2], after);
+
+			const float dot		= before[0] * after[0] + before[1] * after[1] + before[2] * after[2];
+			const float lengths	= sqrtf((before[0] * before[0] + before[1] * before[1] + before[2] * before[2])
+				* (after[0] * after[0] + after[1] * after[1] + after[2] * after[2]));
+
+			if (dot <= MIN_NORMAL_COSINE * lengths)
+			{
+				flips = true;
+				break;
+			}
+		}
+
+		if (flips)
+			continue;
+
+		for (auto triangle : vertexTriangles[collapse.from])
+		{
+			unsigned short* t = &triangles[triangle * 3];
+
+			if (!aliveTriangles[triangle])
+				continue;
+
+			if (t[0] == collapse.to || t[1] == collapse.to || t[2] == collapse.to)
+			{
+				aliveTriangles[triangle] = false;
+				--numTriangles;
+				continue;
+			}
+
+			for (uint i = 0; i < 3; ++i)
+				if (t[i] == collapse.from)
+					t[i] = collapse.to;
+			vertexTriangles[collapse.to].push_back(triangle);
+		}
+
+		vertexTriangles[collapse.from].clear();
+		quadrics[collapse.to] += quadrics[collapse.from];
+		removed[collapse.from] = true;
+		++versions[collapse.to];
+
+		neighbors(collapse.to, toNeighbors);
+		for (auto neighbor : toNeighbors)
+			pushCollapse(collapse.to, neighbor);
+	}
+
+	std::vector<unsigned short> indices;
+
+	indices.reserve(numTriangles * 3);
+	for (uint triangle = 0; triangle < numInputTriangles; ++triangle)
+		if (aliveTriangles[triangle])
+			indices.insert(indices.end(), triangles.begin() + triangle * 3, triangles.begin() + triangle * 3 + 3);
+
+	auto simplified = Geometry::create();
+
+	for (auto& sourceVertexBuffer : geometry->vertexBuffers())
+		simplified->addVertexBuffer(sourceVertexBuffer);
+	simplified->indices(render::IndexBuffer::create(indexBuffer->context(), indices));
+
+	return simplified;
+}
+
+std::vector<MeshSimplifier::GeometryPtr>
+MeshSimplifier::simplifyChain(GeometryPtr geometry, uint numLevels, float ratio) const
+{
+	std::vector<GeometryPtr> levels;
+
+	for (uint level = 0; level < numLevels; ++level)
+	{
+		const uint	numTriangles			= geometry && geometry->indices() ? geometry->indices()->data().size() / 3 : 0;
+		auto		simplified				= simplify(geometry, (uint)(numTriangles * ratio));
+		const uint	numSimplifiedTriangles	= simplified->indices()->data().size() / 3;
+
+		if (numSimplifiedTriangles == 0 || numSimplifiedTriangles == numTriangles)
+			break;
+
+		levels.push_back(simplified);
+		geometry = simplified;
+	}
+
+	return levels;
+}
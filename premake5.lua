@@ -18,6 +18,11 @@ newoption {
 	description = 'Disable tests.'
 }
 
+newoption {
+	trigger	= 'no-tool',
+	description = 'Disable tools.'
+}
+
 newoption {
 	trigger = 'dist-dir',
 	description = 'Output folder for the redistributable SDK built with the \'dist\' action.'
@@ -91,6 +96,7 @@ solution "minko"
 	-- example
 	if not _OPTIONS['no-example'] then
 		include 'example/lua-scripts'
+		include 'example/lua-benchmark'
 		include 'example/assimp'
 		include 'example/cube'
 		include 'example/devil'
@@ -103,8 +109,10 @@ solution "minko"
 		include 'example/line-geometry'
 		include 'example/offscreen'
 		include 'example/particles'
+		include 'example/particles-benchmark'
 		include 'example/picking'
 		include 'example/raycasting'
+		include 'example/raycasting-benchmark'
 		include 'example/serializer'
 		include 'example/sky-box'
 		include 'example/stencil'
@@ -116,6 +124,11 @@ solution "minko"
 		include 'example/joystick'
 	end
 
+	-- tool
+	if not _OPTIONS['no-tool'] and not _OPTIONS['no-plugin'] then
+		include 'tool/texture-converter'
+	end
+
 	-- test
 	if not _OPTIONS['no-test'] then
 		include 'test'
@@ -0,0 +1,157 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "AnimationBlenderTest.hpp"
+
+#include "minko/MinkoTests.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::animation;
+using namespace minko::math;
+using namespace minko::scene;
+
+namespace
+{
+	Animation::Ptr
+	createTranslationAnimation(Node::Ptr node, float x1, float x2, uint duration = 100)
+	{
+		std::vector<uint> timetable;
+		std::vector<Matrix4x4::Ptr> matrices;
+
+		timetable.push_back(0);
+		timetable.push_back(duration);
+		matrices.push_back(Matrix4x4::create()->appendTranslation(x1));
+		matrices.push_back(Matrix4x4::create()->appendTranslation(x2));
+
+		auto animation = Animation::create(std::vector<AbstractTimeline::Ptr>(
+			1, Matrix4x4Timeline::create("transform.matrix", duration, timetable, matrices, true)
+		));
+
+		node->addComponent(animation);
+
+		return animation;
+	}
+
+	float
+	translationX(Node::Ptr node)
+	{
+		return node->component<Transform>()->matrix()->values()[3];
+	}
+}
+
+TEST_F(AnimationBlenderTest, PoseComposeDecompose)
+{
+	auto matrix = Matrix4x4::create()
+		->appendScale(2.f, 3.f, 4.f)
+		->appendRotationY(.7f)
+		->appendRotationX(-.3f)
+		->appendTranslation(1.f, 2.f, 3.f);
+
+	float channel[Pose::CHANNEL_SIZE];
+	float m[16];
+
+	Pose::decompose(&matrix->data()[0], channel);
+	Pose::compose(channel, m);
+
+	for (uint i = 0; i < 16; ++i)
+		ASSERT_NEAR(matrix->values()[i], m[i], 1e-4f);
+}
+
+TEST_F(AnimationBlenderTest, CrossFade)
+{
+	auto node		= Node::create()->addComponent(Transform::create());
+	auto blender	= AnimationBlender::create();
+	auto walk		= blender->addLayer(std::vector<Animation::Ptr>(1, createTranslationAnimation(node, 1.f, 1.f)));
+	auto run		= blender->addLayer(std::vector<Animation::Ptr>(1, createTranslationAnimation(node, 3.f, 3.f)), AnimationBlender::BlendMode::OVERRIDE, 0.f);
+
+	blender->evaluate(0.f);
+	blender->apply();
+	ASSERT_NEAR(translationX(node), 1.f, 1e-5f);
+
+	blender->crossFade(run, 100);
+	blender->evaluate(50.f);
+	blender->apply();
+	ASSERT_NEAR(blender->layerWeight(walk), .5f, 1e-5f);
+	ASSERT_NEAR(translationX(node), 2.f, 1e-5f);
+
+	blender->evaluate(50.f);
+	blender->apply();
+	ASSERT_NEAR(blender->layerWeight(run), 1.f, 1e-5f);
+	ASSERT_NEAR(translationX(node), 3.f, 1e-5f);
+}
+
+TEST_F(AnimationBlenderTest, AdditiveLayer)
+{
+	auto node		= Node::create()->addComponent(Transform::create());
+	auto blender	= AnimationBlender::create();
+
+	blender->addLayer(std::vector<Animation::Ptr>(1, createTranslationAnimation(node, 1.f, 1.f)));
+	blender->addLayer(std::vector<Animation::Ptr>(1, createTranslationAnimation(node, 0.f, 2.f, 100)), AnimationBlender::BlendMode::ADDITIVE);
+
+	blender->evaluate(50.f);
+	blender->apply();
+
+	ASSERT_NEAR(translationX(node), 2.f, 1e-5f);
+}
+
+TEST_F(AnimationBlenderTest, LayerMask)
+{
+	auto root		= Node::create()->addComponent(Transform::create());
+	auto arm		= Node::create()->addComponent(Transform::create());
+	auto leg		= Node::create()->addComponent(Transform::create());
+	auto blender	= AnimationBlender::create();
+
+	root->addChild(arm)->addChild(leg);
+
+	std::vector<Animation::Ptr> animations;
+	animations.push_back(createTranslationAnimation(arm, 5.f, 5.f));
+	animations.push_back(createTranslationAnimation(leg, 5.f, 5.f));
+
+	auto layer = blender->addLayer(animations);
+
+	blender->layerMask(layer, leg, 0.f);
+	blender->evaluate(0.f);
+	blender->apply();
+
+	ASSERT_NEAR(translationX(arm), 5.f, 1e-5f);
+	ASSERT_NEAR(translationX(leg), 0.f, 1e-5f);
+}
+
+TEST_F(AnimationBlenderTest, UpdateAll)
+{
+	std::vector<AnimationBlender::Ptr>	blenders;
+	std::vector<Node::Ptr>				nodes;
+
+	for (uint i = 0; i < 16; ++i)
+	{
+		auto node		= Node::create()->addComponent(Transform::create());
+		auto blender	= AnimationBlender::create();
+
+		blender->addLayer(std::vector<Animation::Ptr>(1, createTranslationAnimation(node, 0.f, (float)i)));
+		blenders.push_back(blender);
+		nodes.push_back(node);
+	}
+
+	AnimationBlender::updateAll(blenders, 50.f, 4);
+
+	for (uint i = 0; i < nodes.size(); ++i)
+		ASSERT_NEAR(translationX(nodes[i]), i * .5f, 1e-5f);
+}
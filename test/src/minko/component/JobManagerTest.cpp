@@ -0,0 +1,123 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/component/JobManagerTest.hpp"
+
+using namespace minko;
+using namespace minko::component;
+
+namespace
+{
+	// a job done in a single step, which records its name and can push another job from that step
+	class RecordingJob :
+		public JobManager::Job
+	{
+	public:
+		typedef std::shared_ptr<RecordingJob> Ptr;
+
+	private:
+		std::string					_name;
+		float						_priority;
+		std::vector<std::string>&	_steps;
+		JobManager::Job::Ptr		_pushedJob;
+		bool						_complete;
+
+	public:
+		static
+		Ptr
+		create(const std::string& name, float priority, std::vector<std::string>& steps, JobManager::Job::Ptr pushedJob = nullptr)
+		{
+			return std::shared_ptr<RecordingJob>(new RecordingJob(name, priority, steps, pushedJob));
+		}
+
+		bool
+		complete()
+		{
+			return _complete;
+		}
+
+		void
+		beforeFirstStep()
+		{
+		}
+
+		void
+		step()
+		{
+			_steps.push_back(_name);
+			if (_pushedJob != nullptr)
+				jobManager()->pushJob(_pushedJob);
+			_complete = true;
+		}
+
+		float
+		priority()
+		{
+			return _priority;
+		}
+
+		void
+		afterLastStep()
+		{
+			_steps.push_back(_name + " done");
+		}
+
+	private:
+		RecordingJob(const std::string& name, float priority, std::vector<std::string>& steps, JobManager::Job::Ptr pushedJob) :
+			_name(name),
+			_priority(priority),
+			_steps(steps),
+			_pushedJob(pushedJob),
+			_complete(false)
+		{
+		}
+	};
+}
+
+TEST_F(JobManagerTest, SamePriorityJobsRunInPushOrder)
+{
+	auto						jobManager	= JobManager::create(1);
+	std::vector<std::string>	steps;
+
+	jobManager
+		->pushJob(RecordingJob::create("a", 1.f, steps))
+		->pushJob(RecordingJob::create("b", 1.f, steps))
+		->pushJob(RecordingJob::create("high", 2.f, steps))
+		->pushJob(RecordingJob::create("c", 1.f, steps));
+
+	jobManager->update(nullptr);
+	jobManager->end(nullptr);
+
+	ASSERT_EQ(steps, std::vector<std::string>({ "high", "high done", "a", "a done", "b", "b done", "c", "c done" }));
+}
+
+TEST_F(JobManagerTest, JobPushedDuringStep)
+{
+	auto						jobManager	= JobManager::create(1);
+	std::vector<std::string>	steps;
+
+	// the pushed job has a higher priority and ends up after the current one
+	jobManager->pushJob(RecordingJob::create("a", 1.f, steps, RecordingJob::create("b", 2.f, steps)));
+
+	jobManager->update(nullptr);
+	jobManager->end(nullptr);
+
+	ASSERT_EQ(steps, std::vector<std::string>({ "a", "a done", "b", "b done" }));
+}
@@ -0,0 +1,187 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/component/LevelOfDetailTest.hpp"
+
+#include "minko/MinkoTests.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::math;
+
+namespace
+{
+	scene::Node::Ptr
+	createSurfaceNode()
+	{
+		auto node	= scene::Node::create();
+		auto passes	= std::vector<render::Pass::Ptr>();
+
+		node
+			->addComponent(Transform::create())
+			->addComponent(Surface::create(
+				geometry::Geometry::create(),
+				material::Material::create(),
+				render::Effect::create(passes)
+			))
+			->addComponent(BoundingBox::create(2.f, Vector3::create()));
+
+		return node;
+	}
+
+	scene::Node::Ptr
+	createCameraNode(float z)
+	{
+		auto node		= scene::Node::create();
+		auto renderer	= Renderer::create();
+
+		// levels are selected whether or not the renderer draws
+		renderer->enabled(false);
+		node
+			->addComponent(Transform::create(Matrix4x4::create()->appendTranslation(0.f, 0.f, z)))
+			->addComponent(PerspectiveCamera::create(1.f))
+			->addComponent(renderer);
+
+		return node;
+	}
+
+	std::vector<geometry::Geometry::Ptr>
+	createGeometries(uint numGeometries)
+	{
+		std::vector<geometry::Geometry::Ptr> geometries;
+
+		for (uint i = 0; i < numGeometries; ++i)
+			geometries.push_back(geometry::Geometry::create());
+
+		return geometries;
+	}
+}
+
+TEST_F(LevelOfDetailTest, ScreenSizes)
+{
+	auto lod = LevelOfDetail::create();
+
+	ASSERT_FLOAT_EQ(lod->screenSize(1), .25f);
+	ASSERT_FLOAT_EQ(lod->screenSize(2), .125f);
+
+	lod->screenSizes({ .5f, .2f });
+
+	ASSERT_FLOAT_EQ(lod->screenSize(1), .5f);
+	ASSERT_FLOAT_EQ(lod->screenSize(2), .2f);
+	ASSERT_FLOAT_EQ(lod->screenSize(3), .1f);
+	ASSERT_THROW(lod->screenSizes({ .2f, .5f }), std::invalid_argument);
+}
+
+TEST_F(LevelOfDetailTest, SelectLevelWithHysteresis)
+{
+	auto node	= createSurfaceNode();
+	auto lod	= LevelOfDetail::create(.1f);
+
+	lod->addLevels(node->component<Surface>(), createGeometries(2));
+
+	ASSERT_EQ(lod->numLevels(), 3u);
+	ASSERT_EQ(lod->selectLevel(0, 1.f), 0u);
+	ASSERT_EQ(lod->selectLevel(0, .24f), 0u);
+	ASSERT_EQ(lod->selectLevel(0, .2f), 1u);
+	ASSERT_EQ(lod->selectLevel(1, .26f), 1u);
+	ASSERT_EQ(lod->selectLevel(1, .3f), 0u);
+	ASSERT_EQ(lod->selectLevel(0, .01f), 2u);
+	ASSERT_EQ(lod->selectLevel(2, .13f), 2u);
+	ASSERT_EQ(lod->selectLevel(2, 1.f), 0u);
+}
+
+TEST_F(LevelOfDetailTest, AddLevelsAddsSurfaces)
+{
+	auto node		= createSurfaceNode();
+	auto surface	= node->component<Surface>();
+	auto lod		= LevelOfDetail::create();
+
+	node->addComponent(lod);
+	lod->addLevels(surface, createGeometries(2));
+
+	ASSERT_EQ(node->components<Surface>().size(), 3u);
+	ASSERT_EQ(lod->surface(surface, 0), surface);
+	ASSERT_EQ(lod->surface(surface, 5), lod->surface(surface, 2));
+	ASSERT_EQ(lod->surface(surface, 1)->material(), surface->material());
+	ASSERT_FALSE(lod->surface(surface, 1)->visible());
+
+	lod->removeLevels(surface);
+
+	ASSERT_EQ(node->components<Surface>().size(), 1u);
+	ASSERT_EQ(lod->numLevels(), 1u);
+}
+
+TEST_F(LevelOfDetailTest, LevelPerCamera)
+{
+	auto root			= scene::Node::create("root");
+	auto sceneManager	= SceneManager::create(MinkoTests::context());
+	auto node			= createSurfaceNode();
+	auto surface		= node->component<Surface>();
+	auto lod			= LevelOfDetail::create();
+	auto nearCamera		= createCameraNode(5.f);
+	auto farCamera		= createCameraNode(200.f);
+	auto nearRenderer	= nearCamera->component<Renderer>();
+	auto farRenderer	= farCamera->component<Renderer>();
+
+	lod->addLevels(surface, createGeometries(2));
+	node->addComponent(lod);
+	root->addComponent(sceneManager);
+	root->addChild(node)->addChild(nearCamera)->addChild(farCamera);
+	sceneManager->nextFrame(0.f, 0.f);
+
+	ASSERT_EQ(lod->level(nearRenderer), 0u);
+	ASSERT_EQ(lod->level(farRenderer), 2u);
+	ASSERT_TRUE(surface->visible(nearRenderer));
+	ASSERT_FALSE(lod->surface(surface, 2)->visible(nearRenderer));
+	ASSERT_FALSE(surface->visible(farRenderer));
+	ASSERT_FALSE(lod->surface(surface, 1)->visible(farRenderer));
+	ASSERT_TRUE(lod->surface(surface, 2)->visible(farRenderer));
+
+	root->removeChild(farCamera);
+
+	ASSERT_TRUE(surface->visible(farRenderer));
+	ASSERT_FALSE(lod->surface(surface, 2)->visible(farRenderer));
+}
+
+TEST_F(LevelOfDetailTest, RemoveComponentRestoresSurfaces)
+{
+	auto root			= scene::Node::create("root");
+	auto sceneManager	= SceneManager::create(MinkoTests::context());
+	auto node			= createSurfaceNode();
+	auto surface		= node->component<Surface>();
+	auto lod			= LevelOfDetail::create();
+	auto camera			= createCameraNode(200.f);
+	auto renderer		= camera->component<Renderer>();
+
+	node->addComponent(lod);
+	lod->addLevels(surface, createGeometries(1));
+	root->addComponent(sceneManager);
+	root->addChild(node)->addChild(camera);
+	sceneManager->nextFrame(0.f, 0.f);
+
+	ASSERT_EQ(lod->level(renderer), 1u);
+	ASSERT_FALSE(surface->visible(renderer));
+
+	node->removeComponent(lod);
+
+	ASSERT_EQ(node->components<Surface>().size(), 1u);
+	ASSERT_TRUE(surface->visible(renderer));
+	ASSERT_EQ(lod->level(renderer), 0u);
+}
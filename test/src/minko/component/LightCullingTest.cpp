@@ -0,0 +1,208 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include "minko/component/LightCullingTest.hpp"
+
+#include "minko/MinkoTests.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::math;
+
+namespace
+{
+	scene::Node::Ptr
+	createSurfaceNode(float x, float y, float z)
+	{
+		auto node	= scene::Node::create();
+		auto passes	= std::vector<render::Pass::Ptr>();
+
+		node
+			->addComponent(Transform::create(Matrix4x4::create()->appendTranslation(x, y, z)))
+			->addComponent(Surface::create(
+				geometry::Geometry::create(),
+				material::Material::create(),
+				render::Effect::create(passes)
+			));
+
+		return node;
+	}
+
+	scene::Node::Ptr
+	createPointLightNode(float x, float y, float z, float attenuationRange)
+	{
+		auto node	= scene::Node::create();
+		auto light	= PointLight::create();
+
+		// linear attenuation reaching 0 at attenuationRange
+		light->attenuationCoefficients(attenuationRange, 0.f, 0.f);
+		node
+			->addComponent(Transform::create(Matrix4x4::create()->appendTranslation(x, y, z)))
+			->addComponent(light);
+
+		return node;
+	}
+
+	void
+	nextFrame(SceneManager::Ptr sceneManager)
+	{
+		sceneManager->nextFrame(0.f, 0.f);
+	}
+}
+
+TEST_F(LightCullingTest, AttenuationRange)
+{
+	ASSERT_EQ(AbstractDiscreteLight::attenuationRange(-1.f, -1.f, -1.f), -1.f);
+	ASSERT_EQ(AbstractDiscreteLight::attenuationRange(1.f, 2.f, 0.f), -1.f);
+	ASSERT_FLOAT_EQ(AbstractDiscreteLight::attenuationRange(1.f, 0.f, 0.f), 1.f);
+
+	const float range = AbstractDiscreteLight::attenuationRange(1.f, .09f, .032f);
+
+	ASSERT_NEAR(1.f - range / (1.f + .09f * range + .032f * range * range), 0.f, 1e-5f);
+	ASSERT_GT(1.f - (range * .9f) / (1.f + .09f * range * .9f + .032f * range * range * .81f), 0.f);
+}
+
+TEST_F(LightCullingTest, InfluenceRadius)
+{
+	auto light = PointLight::create();
+
+	light->attenuationCoefficients(6.f, 0.f, 0.f);
+	ASSERT_FLOAT_EQ(light->influenceRadius(), 6.f);
+
+	light->attenuationCoefficients(-1.f, -1.f, -1.f);
+	ASSERT_LT(light->influenceRadius(), 0.f);
+}
+
+TEST_F(LightCullingTest, LightsOutOfRange)
+{
+	auto root			= scene::Node::create("root");
+	auto sceneManager	= SceneManager::create(MinkoTests::context());
+	auto culling		= LightCulling::create(4);
+	auto near			= createSurfaceNode(0.f, 0.f, 0.f);
+	auto far			= createSurfaceNode(100.f, 0.f, 0.f);
+	auto light			= createPointLightNode(1.f, 0.f, 0.f, 5.f);
+
+	root->addComponent(sceneManager);
+	root->addComponent(culling);
+	root->addChild(near)->addChild(far)->addChild(light);
+	nextFrame(sceneManager);
+
+	ASSERT_EQ(culling->numLights(), 1u);
+	ASSERT_EQ(culling->numSurfaceNodes(), 2u);
+	ASSERT_EQ(culling->numLights(near), 1u);
+	ASSERT_EQ(culling->numLights(far), 0u);
+	ASSERT_EQ(culling->numBoundLights(), 1u);
+	ASSERT_FALSE(light->component<PointLight>()->enabled());
+	ASSERT_EQ(near->data()->get<int>("surfaceLights.numLights"), 1);
+	ASSERT_EQ(far->data()->get<int>("surfaceLights.numLights"), 0);
+}
+
+TEST_F(LightCullingTest, BoundedLightList)
+{
+	auto root			= scene::Node::create("root");
+	auto sceneManager	= SceneManager::create(MinkoTests::context());
+	auto culling		= LightCulling::create(4);
+	auto surfaceNode	= createSurfaceNode(0.f, 0.f, 0.f);
+
+	root->addComponent(sceneManager);
+	root->addComponent(culling);
+	root->addChild(surfaceNode);
+
+	// the closest lights have the largest contribution
+	for (uint i = 0; i < 10; ++i)
+		root->addChild(createPointLightNode(1.f + i, 0.f, 0.f, 20.f));
+	nextFrame(sceneManager);
+
+	ASSERT_EQ(culling->numLights(surfaceNode), 4u);
+
+	const auto& positions = surfaceNode->data()->get<data::UniformArrayPtr<float>>("surfaceLights.position");
+
+	ASSERT_EQ(positions->first, 4u);
+	for (uint i = 0; i < 4; ++i)
+		ASSERT_FLOAT_EQ(positions->second[i * 4], 1.f + i);
+}
+
+TEST_F(LightCullingTest, RemoveLight)
+{
+	auto root			= scene::Node::create("root");
+	auto sceneManager	= SceneManager::create(MinkoTests::context());
+	auto culling		= LightCulling::create();
+	auto surfaceNode	= createSurfaceNode(0.f, 0.f, 0.f);
+	auto light			= createPointLightNode(1.f, 0.f, 0.f, 5.f);
+
+	root->addComponent(sceneManager);
+	root->addComponent(culling);
+	root->addChild(surfaceNode)->addChild(light);
+	nextFrame(sceneManager);
+
+	ASSERT_EQ(culling->numLights(surfaceNode), 1u);
+
+	root->removeChild(light);
+	nextFrame(sceneManager);
+
+	ASSERT_EQ(culling->numLights(), 0u);
+	ASSERT_EQ(culling->numLights(surfaceNode), 0u);
+	ASSERT_TRUE(light->component<PointLight>()->enabled());
+}
+
+TEST_F(LightCullingTest, RemoveFromRoot)
+{
+	auto root			= scene::Node::create("root");
+	auto sceneManager	= SceneManager::create(MinkoTests::context());
+	auto culling		= LightCulling::create();
+	auto surfaceNode	= createSurfaceNode(0.f, 0.f, 0.f);
+	auto light			= createPointLightNode(1.f, 0.f, 0.f, 5.f);
+
+	root->addComponent(sceneManager);
+	root->addComponent(culling);
+	root->addChild(surfaceNode)->addChild(light);
+	nextFrame(sceneManager);
+
+	root->removeComponent(culling);
+
+	ASSERT_FALSE(surfaceNode->data()->hasProperty("surfaceLights.numLights"));
+	ASSERT_TRUE(light->component<PointLight>()->enabled());
+}
+
+TEST_F(LightCullingTest, CannotBeCombinedWithClusteredLighting)
+{
+	auto root			= scene::Node::create("root");
+	auto sceneManager	= SceneManager::create(MinkoTests::context());
+	auto camera			= scene::Node::create("camera");
+
+	camera
+		->addComponent(Renderer::create())
+		->addComponent(PerspectiveCamera::create(1.f))
+		->addComponent(ClusteredLighting::create(MinkoTests::context()));
+
+	root->addComponent(sceneManager);
+	root->addChild(camera);
+	root->addComponent(LightCulling::create(4));
+
+	ASSERT_THROW(nextFrame(sceneManager), std::logic_error);
+
+	auto otherRoot = scene::Node::create("otherRoot");
+
+	otherRoot->addComponent(SceneManager::create(MinkoTests::context()));
+	otherRoot->addComponent(LightCulling::create(4));
+
+	ASSERT_THROW(otherRoot->addChild(camera), std::logic_error);
+}
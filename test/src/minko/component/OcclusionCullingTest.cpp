@@ -0,0 +1,92 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/component/OcclusionCullingTest.hpp"
+
+#include "minko/MinkoTests.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::math;
+
+namespace
+{
+	// a box of the given size centered on (0, 0, z), in front of a camera looking down -z
+	scene::Node::Ptr
+	createBox(float size, float depth, float z)
+	{
+		auto passes = std::vector<render::Pass::Ptr>();
+
+		return scene::Node::create()
+			->addComponent(Transform::create(Matrix4x4::create()->appendScale(size, size, depth)->appendTranslation(0.f, 0.f, z)))
+			->addComponent(Surface::create(
+				geometry::CubeGeometry::create(MinkoTests::context()),
+				material::Material::create(),
+				render::Effect::create(passes)
+			))
+			->addComponent(BoundingBox::create());
+	}
+}
+
+TEST_F(OcclusionCullingTest, HidesSurfacesBehindOccluders)
+{
+	auto renderer	= Renderer::create();
+	auto culling	= OcclusionCulling::create(64, 32);
+	auto root		= scene::Node::create("root")->addComponent(SceneManager::create(MinkoTests::context()));
+	auto camera		= scene::Node::create("camera")
+		->addComponent(PerspectiveCamera::create(2.f))
+		->addComponent(renderer);
+	auto wall		= createBox(100.f, 1.f, -10.f);
+	auto hidden		= createBox(1.f, 1.f, -20.f);
+	auto visible	= createBox(1.f, 1.f, -5.f);
+
+	root->addChild(camera)->addChild(wall)->addChild(hidden)->addChild(visible);
+	camera->addComponent(culling);
+	culling->addOccluder(wall);
+
+	root->component<SceneManager>()->nextFrame(0.f, 0.f);
+
+	ASSERT_FALSE(hidden->component<Surface>()->computedVisibility(renderer));
+	ASSERT_TRUE(visible->component<Surface>()->computedVisibility(renderer));
+}
+
+TEST_F(OcclusionCullingTest, OccludersAreNeverOccluded)
+{
+	auto renderer	= Renderer::create();
+	auto culling	= OcclusionCulling::create(64, 32);
+	auto root		= scene::Node::create("root")->addComponent(SceneManager::create(MinkoTests::context()));
+	auto camera		= scene::Node::create("camera")
+		->addComponent(PerspectiveCamera::create(2.f))
+		->addComponent(renderer);
+	auto nearWall	= createBox(100.f, 1.f, -10.f);
+	auto farWall	= createBox(100.f, 1.f, -20.f);
+
+	root->addChild(camera)->addChild(nearWall)->addChild(farWall);
+	camera->addComponent(culling);
+	culling->addOccluder(nearWall);
+	culling->addOccluder(farWall);
+
+	root->component<SceneManager>()->nextFrame(0.f, 0.f);
+
+	// occluders are only frustum tested: the far wall is kept even though the near one covers it
+	ASSERT_TRUE(nearWall->component<Surface>()->computedVisibility(renderer));
+	ASSERT_TRUE(farWall->component<Surface>()->computedVisibility(renderer));
+	ASSERT_EQ(culling->numOccluded(), 0u);
+}
@@ -0,0 +1,184 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/component/RendererTest.hpp"
+
+#include "minko/MinkoTests.hpp"
+#include "minko/render/DrawCall.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::math;
+
+namespace
+{
+	const std::string FRAGMENT_SHADER =
+		"#ifdef GL_ES\n"
+		"	precision mediump float;\n"
+		"#endif\n"
+		"void main(void)\n"
+		"{\n"
+		"	gl_FragColor = vec4(1.0);\n"
+		"}\n";
+
+	// a vertex shader computing worldToScreenMatrix * (modelToWorldMatrix * position), plus extra declarations
+	std::string
+	vertexShader(const std::string& declarations = "", const std::string& offset = "")
+	{
+		return "attribute vec3 position;\n"
+			"uniform mat4 modelToWorldMatrix;\n"
+			"uniform mat4 worldToScreenMatrix;\n"
+			+ declarations +
+			"void main(void)\n"
+			"{\n"
+			"	gl_Position = worldToScreenMatrix * (modelToWorldMatrix * vec4(position" + offset + ", 1.0));\n"
+			"}\n";
+	}
+
+	render::Effect::Ptr
+	createEffect(const std::string& vertexShaderSource, render::AbstractTexture::Ptr target = nullptr)
+	{
+		auto context	= MinkoTests::context();
+		auto program	= render::Program::create(
+			context,
+			render::Shader::create(context, render::Shader::Type::VERTEX_SHADER, vertexShaderSource),
+			render::Shader::create(context, render::Shader::Type::FRAGMENT_SHADER, FRAGMENT_SHADER)
+		);
+
+		data::BindingMap attributeBindings;
+		data::BindingMap uniformBindings;
+
+		attributeBindings["position"]			= data::Binding("geometry[${geometryId}].position", data::BindingSource::TARGET);
+		attributeBindings["boneWeightsB"]		= data::Binding("geometry[${geometryId}].boneWeightsB", data::BindingSource::TARGET);
+		uniformBindings["modelToWorldMatrix"]	= data::Binding("transform.modelToWorldMatrix", data::BindingSource::TARGET);
+		uniformBindings["worldToScreenMatrix"]	= data::Binding("camera.worldToScreenMatrix", data::BindingSource::RENDERER);
+
+		auto passes = std::vector<render::Pass::Ptr>(1, render::Pass::create(
+			"pass",
+			program,
+			attributeBindings,
+			uniformBindings,
+			data::BindingMap(),
+			data::MacroBindingMap(),
+			render::States::create(
+				render::States::SamplerStates(),
+				render::priority::OPAQUE, false,
+				render::Blending::Source::ONE, render::Blending::Destination::ZERO,
+				true, true, render::CompareMode::LESS, render::TriangleCulling::BACK,
+				render::CompareMode::ALWAYS, 0, 0x1,
+				render::StencilOperation::KEEP, render::StencilOperation::KEEP, render::StencilOperation::KEEP,
+				false, render::ScissorBox(),
+				target
+			),
+			""
+		));
+
+		return render::Effect::create(passes);
+	}
+
+	geometry::Geometry::Ptr
+	createGeometry()
+	{
+		auto geometry		= geometry::Geometry::create();
+		auto vertexBuffer	= render::VertexBuffer::create(
+			MinkoTests::context(),
+			std::vector<float>({ 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f })
+		);
+
+		vertexBuffer->addAttribute("position", 3, 0);
+		geometry->addVertexBuffer(vertexBuffer);
+		geometry->indices(render::IndexBuffer::create(MinkoTests::context(), std::vector<unsigned short>({ 0, 1, 2 })));
+
+		return geometry;
+	}
+
+	// the draw call created for a single surface rendered with effect, once a frame has been rendered
+	render::DrawCall::Ptr
+	createDrawCall(render::Effect::Ptr effect)
+	{
+		auto renderer	= Renderer::create();
+		auto root		= scene::Node::create("root")
+			->addComponent(SceneManager::create(MinkoTests::context()))
+			->addComponent(PerspectiveCamera::create(1.f))
+			->addComponent(renderer);
+		auto mesh		= scene::Node::create("mesh")
+			->addComponent(Transform::create(Matrix4x4::create()->appendTranslation(0.f, 0.f, -5.f)))
+			->addComponent(Surface::create(createGeometry(), material::Material::create(), effect));
+
+		root->addChild(mesh);
+		root->component<SceneManager>()->nextFrame(0.f, 0.f);
+
+		return renderer->drawCalls().size() == 1 ? renderer->drawCalls().front() : nullptr;
+	}
+}
+
+TEST_F(RendererTest, OpaqueDrawCallIsDepthPrePassCompatible)
+{
+	auto drawCall = createDrawCall(createEffect(vertexShader()));
+
+	ASSERT_NE(drawCall, nullptr);
+	ASSERT_TRUE(drawCall->depthPrePassCompatible());
+}
+
+TEST_F(RendererTest, DeformedDrawCallIsNotDepthPrePassCompatible)
+{
+	// only the second set of bone weights is used: every deformation input must be checked
+	auto drawCall = createDrawCall(createEffect(vertexShader("attribute vec4 boneWeightsB;\n", " + boneWeightsB.xyz")));
+
+	ASSERT_NE(drawCall, nullptr);
+	ASSERT_FALSE(drawCall->depthPrePassCompatible());
+}
+
+TEST_F(RendererTest, RenderToTextureDrawCallIsNotDepthPrePassCompatible)
+{
+	auto target		= render::Texture::create(MinkoTests::context(), 64, 64, false, true);
+	auto drawCall	= createDrawCall(createEffect(vertexShader(), target));
+
+	ASSERT_NE(drawCall, nullptr);
+	ASSERT_FALSE(drawCall->depthPrePassCompatible());
+}
+
+TEST_F(RendererTest, DepthPrePassRendersEveryDrawCall)
+{
+	auto renderer	= Renderer::create();
+	auto root		= scene::Node::create("root")
+		->addComponent(SceneManager::create(MinkoTests::context()))
+		->addComponent(PerspectiveCamera::create(1.f))
+		->addComponent(renderer);
+
+	renderer->depthPrePass(true);
+	for (uint i = 0; i < 3; ++i)
+		root->addChild(scene::Node::create()
+			->addComponent(Transform::create(Matrix4x4::create()->appendTranslation(0.f, 0.f, -5.f - i)))
+			->addComponent(Surface::create(createGeometry(), material::Material::create(), createEffect(vertexShader()))));
+
+	auto numFrames			= 0;
+	auto numDrawCalls		= 0u;
+	auto renderingEndSlot	= renderer->renderingEnd()->connect([&](Renderer::Ptr r)
+	{
+		++numFrames;
+		numDrawCalls = r->numDrawCalls();
+	});
+
+	root->component<SceneManager>()->nextFrame(0.f, 0.f);
+
+	ASSERT_EQ(numFrames, 1);
+	ASSERT_EQ(numDrawCalls, 3u);
+}
@@ -0,0 +1,276 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/component/StaticBatchingTest.hpp"
+
+#include "minko/MinkoTests.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::math;
+
+namespace
+{
+	// numTriangles triangles facing +z, with positions and normals
+	geometry::Geometry::Ptr
+	createGeometry(uint numTriangles = 1)
+	{
+		std::vector<float>			vertices;
+		std::vector<unsigned short>	indices;
+
+		for (uint i = 0; i < numTriangles * 3; ++i)
+		{
+			vertices.insert(vertices.end(), { (float)(i % 3 == 1), (float)(i % 3 == 2), 0.f, 0.f, 0.f, 1.f });
+			indices.push_back(i);
+		}
+
+		auto geometry		= geometry::Geometry::create();
+		auto vertexBuffer	= render::VertexBuffer::create(MinkoTests::context(), vertices);
+
+		vertexBuffer->addAttribute("position", 3, 0);
+		vertexBuffer->addAttribute("normal", 3, 3);
+		geometry->addVertexBuffer(vertexBuffer);
+		geometry->indices(render::IndexBuffer::create(MinkoTests::context(), indices));
+
+		return geometry;
+	}
+
+	scene::Node::Ptr
+	createSurfaceNode(Matrix4x4::Ptr matrix, material::Material::Ptr material, render::Effect::Ptr effect, uint numTriangles = 1)
+	{
+		return scene::Node::create()
+			->addComponent(Transform::create(matrix))
+			->addComponent(Surface::create(createGeometry(numTriangles), material, effect));
+	}
+
+	render::Effect::Ptr
+	createEffect()
+	{
+		auto passes = std::vector<render::Pass::Ptr>();
+
+		return render::Effect::create(passes);
+	}
+
+	const float*
+	vertex(scene::Node::Ptr batchNode, uint vertexId)
+	{
+		auto vertexBuffer = batchNode->component<Surface>()->geometry()->vertexBuffers().front();
+
+		return &vertexBuffer->data()[vertexId * vertexBuffer->vertexSize()];
+	}
+}
+
+TEST_F(StaticBatchingTest, MergeSurfacesSharingMaterial)
+{
+	auto root		= scene::Node::create("root");
+	auto material	= material::Material::create();
+	auto effect		= createEffect();
+	auto batching	= StaticBatching::create();
+	auto a			= createSurfaceNode(Matrix4x4::create()->appendTranslation(10.f, 0.f, 0.f), material, effect);
+	auto b			= createSurfaceNode(Matrix4x4::create()->appendTranslation(20.f, 0.f, 0.f), material, effect);
+	auto c			= createSurfaceNode(Matrix4x4::create()->appendTranslation(30.f, 0.f, 0.f), material, effect);
+	auto other		= createSurfaceNode(Matrix4x4::create(), material::Material::create(), effect);
+
+	root->addComponent(batching);
+	root->addChild(a)->addChild(b)->addChild(other);
+	a->addChild(c);
+	batching->batch();
+
+	ASSERT_EQ(batching->numSourceSurfaces(), 3u);
+	ASSERT_EQ(batching->numBatches(), 1u);
+	ASSERT_EQ(batching->numSavedDrawCalls(), 2u);
+	ASSERT_FALSE(a->hasComponent<Surface>());
+	ASSERT_FALSE(b->hasComponent<Surface>());
+	ASSERT_FALSE(c->hasComponent<Surface>());
+	ASSERT_TRUE(other->hasComponent<Surface>());
+
+	auto batchNode	= batching->batchNodes()[0];
+	auto geometry	= batchNode->component<Surface>()->geometry();
+
+	ASSERT_EQ(batchNode->parent(), root);
+	ASSERT_TRUE(batchNode->hasComponent<BoundingBox>());
+	ASSERT_EQ(batchNode->component<Surface>()->material(), material);
+	ASSERT_EQ(geometry->indices()->data().size(), 9u);
+	ASSERT_EQ(geometry->vertexBuffers().front()->numVertices(), 9u);
+
+	// the transforms are baked in, c being a child of a
+	std::vector<float> xs;
+
+	for (uint i = 0; i < 9; i += 3)
+		xs.push_back(vertex(batchNode, i)[0]);
+	std::sort(xs.begin(), xs.end());
+
+	ASSERT_FLOAT_EQ(xs[0], 10.f);
+	ASSERT_FLOAT_EQ(xs[1], 20.f);
+	ASSERT_FLOAT_EQ(xs[2], 40.f);
+}
+
+TEST_F(StaticBatchingTest, NormalsAreTransformed)
+{
+	auto root		= scene::Node::create("root");
+	auto material	= material::Material::create();
+	auto effect		= createEffect();
+	auto batching	= StaticBatching::create();
+	auto rotated	= createSurfaceNode(
+		Matrix4x4::create()->appendScale(1.f, 1.f, 4.f)->appendRotationY((float)M_PI * .5f), material, effect
+	);
+
+	root->addComponent(batching);
+	root
+		->addChild(rotated)
+		->addChild(createSurfaceNode(Matrix4x4::create(), material, effect));
+	batching->batch();
+
+	auto batchNode	= batching->batchNodes()[0];
+	auto ranges		= batching->subRanges(batchNode->component<Surface>());
+	auto rotatedId	= ranges[0].node == rotated ? 0 : 3;
+	auto expected	= Matrix4x4::create()->appendRotationY((float)M_PI * .5f)->deltaTransform(Vector3::create(0.f, 0.f, 1.f));
+	const float* v	= vertex(batchNode, rotatedId);
+
+	ASSERT_NEAR(v[3], expected->x(), 1e-5f);
+	ASSERT_NEAR(v[4], expected->y(), 1e-5f);
+	ASSERT_NEAR(v[5], expected->z(), 1e-5f);
+	ASSERT_NEAR(v[3] * v[3] + v[4] * v[4] + v[5] * v[5], 1.f, 1e-5f);
+}
+
+TEST_F(StaticBatchingTest, SubRanges)
+{
+	auto root		= scene::Node::create("root");
+	auto material	= material::Material::create();
+	auto effect		= createEffect();
+	auto batching	= StaticBatching::create();
+	auto a			= createSurfaceNode(Matrix4x4::create(), material, effect, 2);
+	auto b			= createSurfaceNode(Matrix4x4::create(), material, effect, 3);
+
+	root->addComponent(batching);
+	root->addChild(a)->addChild(b);
+	batching->batch();
+
+	auto surface	= batching->batchNodes()[0]->component<Surface>();
+	auto ranges		= batching->subRanges(surface);
+
+	ASSERT_EQ(ranges.size(), 2u);
+	ASSERT_EQ(ranges[0].firstIndex, 0u);
+	ASSERT_EQ(ranges[1].firstIndex, ranges[0].numIndices);
+	ASSERT_EQ(ranges[0].numIndices + ranges[1].numIndices, 15u);
+	ASSERT_EQ(batching->node(surface, 0), ranges[0].node);
+	ASSERT_EQ(batching->node(surface, ranges[0].numIndices / 3 - 1), ranges[0].node);
+	ASSERT_EQ(batching->node(surface, ranges[0].numIndices / 3), ranges[1].node);
+	ASSERT_EQ(batching->node(surface, 4), ranges[1].node);
+	ASSERT_EQ(batching->node(surface, 5), nullptr);
+	ASSERT_THROW(batching->subRanges(a->component<Surface>()), std::invalid_argument);
+}
+
+TEST_F(StaticBatchingTest, CellSize)
+{
+	auto root		= scene::Node::create("root");
+	auto material	= material::Material::create();
+	auto effect		= createEffect();
+	auto batching	= StaticBatching::create(10.f);
+
+	root->addComponent(batching);
+	for (auto x : { 1.f, 2.f, 51.f, 52.f })
+		root->addChild(createSurfaceNode(Matrix4x4::create()->appendTranslation(x, 0.f, 0.f), material, effect));
+	batching->batch();
+
+	ASSERT_EQ(batching->numSourceSurfaces(), 4u);
+	ASSERT_EQ(batching->numBatches(), 2u);
+
+	batching->cellSize(0.f);
+	batching->batch();
+
+	ASSERT_EQ(batching->numBatches(), 1u);
+}
+
+TEST_F(StaticBatchingTest, SplitWhenIndicesOverflow)
+{
+	auto root		= scene::Node::create("root");
+	auto material	= material::Material::create();
+	auto effect		= createEffect();
+	auto batching	= StaticBatching::create();
+
+	root->addComponent(batching);
+	for (uint i = 0; i < 3; ++i)
+		root->addChild(createSurfaceNode(Matrix4x4::create(), material, effect, 10000));
+	batching->batch();
+
+	ASSERT_EQ(batching->numSourceSurfaces(), 3u);
+	ASSERT_EQ(batching->numBatches(), 2u);
+	for (auto& batchNode : batching->batchNodes())
+		ASSERT_LE(batchNode->component<Surface>()->geometry()->vertexBuffers().front()->numVertices(), 65536u);
+}
+
+TEST_F(StaticBatchingTest, Unbatch)
+{
+	auto root		= scene::Node::create("root");
+	auto material	= material::Material::create();
+	auto effect		= createEffect();
+	auto batching	= StaticBatching::create();
+	auto a			= createSurfaceNode(Matrix4x4::create(), material, effect);
+	auto b			= createSurfaceNode(Matrix4x4::create(), material, effect);
+	auto surface	= a->component<Surface>();
+
+	root->addComponent(batching);
+	root->addChild(a)->addChild(b);
+	batching->batch();
+
+	ASSERT_EQ(root->children().size(), 3u);
+
+	root->removeComponent(batching);
+
+	ASSERT_EQ(root->children().size(), 2u);
+	ASSERT_EQ(a->component<Surface>(), surface);
+	ASSERT_TRUE(b->hasComponent<Surface>());
+	ASSERT_EQ(batching->numBatches(), 0u);
+}
+
+TEST_F(StaticBatchingTest, TransformedTarget)
+{
+	auto root		= scene::Node::create("root")->addComponent(SceneManager::create(MinkoTests::context()));
+	auto world		= scene::Node::create("world")
+		->addComponent(Transform::create(Matrix4x4::create()->appendScale(2.f)->appendTranslation(5.f, 0.f, 0.f)));
+	auto material	= material::Material::create();
+	auto effect		= createEffect();
+	auto batching	= StaticBatching::create();
+	auto a			= createSurfaceNode(Matrix4x4::create()->appendTranslation(10.f, 0.f, 0.f), material, effect);
+	auto b			= createSurfaceNode(Matrix4x4::create()->appendTranslation(20.f, 0.f, 0.f), material, effect);
+
+	root->addChild(world);
+	world->addComponent(batching);
+	world->addChild(a)->addChild(b);
+
+	auto expected = a->component<Transform>()->modelToWorldMatrix(true)->transform(Vector3::create(0.f, 0.f, 0.f));
+
+	batching->batch();
+
+	auto batchNode = batching->batchNodes()[0];
+
+	ASSERT_TRUE(batchNode->hasComponent<Transform>());
+
+	// the baked vertices are relative to the target, whose transform still applies
+	auto v		= vertex(batchNode, 0);
+	auto actual	= batchNode->component<Transform>()->modelToWorldMatrix(true)->transform(Vector3::create(v[0], v[1], v[2]));
+
+	ASSERT_FLOAT_EQ(v[0], 10.f);
+	ASSERT_FLOAT_EQ(actual->x(), expected->x());
+	ASSERT_FLOAT_EQ(actual->y(), expected->y());
+	ASSERT_FLOAT_EQ(actual->z(), expected->z());
+	ASSERT_FLOAT_EQ(actual->x(), 25.f);
+}
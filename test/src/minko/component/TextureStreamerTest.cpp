@@ -0,0 +1,217 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/component/TextureStreamerTest.hpp"
+
+using namespace minko;
+using namespace minko::component;
+
+TEST_F(TextureStreamerTest, Requests)
+{
+	auto streamer	= TextureStreamer::create(1024 * 1024);
+	auto texture	= render::Texture::create(nullptr, 64, 64, true);
+
+	texture->streamed(true);
+
+	streamer->request(texture, 2);
+	streamer->request(texture, 4);
+
+	ASSERT_EQ(streamer->numTextures(), 1);
+	ASSERT_EQ(streamer->numPendingTextures(), 1);
+	ASSERT_EQ(streamer->requiredMemory(), texture->mipLevelsMemory(2));
+	ASSERT_EQ(streamer->residentMemory(), 0);
+
+	streamer->clearRequests();
+
+	ASSERT_EQ(streamer->numPendingTextures(), 0);
+	ASSERT_EQ(streamer->requiredMemory(), 0);
+
+	streamer->remove(texture);
+
+	ASSERT_EQ(streamer->numTextures(), 0);
+}
+
+TEST_F(TextureStreamerTest, UploadsOneLevelPerFrame)
+{
+	auto sceneManager	= SceneManager::create(MinkoTests::context());
+	auto streamer		= TextureStreamer::create(1024 * 1024);
+	auto root			= scene::Node::create()->addComponent(sceneManager)->addComponent(streamer);
+	auto texture		= createStreamedTexture(256);
+
+	// only the 32x32 level and the coarser ones are uploaded at first
+	ASSERT_EQ(texture->residentMipLevel(), 3);
+
+	for (uint level = 2; level != (uint)-1; --level)
+	{
+		streamer->request(texture, 0);
+		sceneManager->nextFrame(0.f, 0.f);
+
+		ASSERT_EQ(texture->residentMipLevel(), level);
+		ASSERT_EQ(streamer->numUploads(), 1);
+	}
+
+	ASSERT_EQ(streamer->residentMemory(), texture->mipLevelsMemory(0));
+	ASSERT_EQ(streamer->numPendingTextures(), 0);
+}
+
+TEST_F(TextureStreamerTest, RequestsLastOneFrame)
+{
+	auto sceneManager	= SceneManager::create(MinkoTests::context());
+	auto streamer		= TextureStreamer::create(1024 * 1024);
+	auto root			= scene::Node::create()->addComponent(sceneManager)->addComponent(streamer);
+	auto texture		= createStreamedTexture(64);
+
+	streamer->request(texture, 0);
+	streamer->request(texture, 1);
+	sceneManager->nextFrame(0.f, 0.f);
+
+	ASSERT_EQ(streamer->requiredMemory(), texture->mipLevelsMemory(0));
+
+	// the first request of the next frame replaces the previous one instead of being merged
+	streamer->request(texture, 1);
+	sceneManager->nextFrame(0.f, 0.f);
+
+	ASSERT_EQ(streamer->requiredMemory(), texture->mipLevelsMemory(1));
+
+	sceneManager->nextFrame(0.f, 0.f);
+
+	ASSERT_EQ(streamer->requiredMemory(), 0);
+	ASSERT_EQ(streamer->numTextures(), 1);
+}
+
+TEST_F(TextureStreamerTest, EvictsUnrequiredLevels)
+{
+	auto sceneManager	= SceneManager::create(MinkoTests::context());
+	auto streamer		= TextureStreamer::create(1024 * 1024);
+	auto root			= scene::Node::create()->addComponent(sceneManager)->addComponent(streamer);
+	auto near			= createStreamedTexture(64);
+	auto far			= createStreamedTexture(64);
+
+	for (uint i = 0; i < 2; ++i)
+	{
+		streamer->request(near, 0);
+		sceneManager->nextFrame(0.f, 0.f);
+	}
+
+	ASSERT_EQ(near->residentMipLevel(), 0);
+
+	// room for a single 64x64 chain: the texture that is not needed anymore gives its levels back
+	streamer->budget(near->mipLevelsMemory(0) + far->mipLevelsMemory(2));
+
+	for (uint i = 0; i < 2; ++i)
+	{
+		streamer->request(near, 2);
+		streamer->request(far, 0);
+		sceneManager->nextFrame(0.f, 0.f);
+
+		ASSERT_EQ(streamer->numEvictions(), i == 0 ? 1 : 0);
+	}
+
+	ASSERT_EQ(near->residentMipLevel(), 2);
+	ASSERT_EQ(far->residentMipLevel(), 0);
+	ASSERT_LE(streamer->residentMemory(), streamer->budget());
+}
+
+TEST_F(TextureStreamerTest, UploadWaitsForBudget)
+{
+	auto sceneManager	= SceneManager::create(MinkoTests::context());
+	auto streamer		= TextureStreamer::create(0);
+	auto root			= scene::Node::create()->addComponent(sceneManager)->addComponent(streamer);
+	auto texture		= createStreamedTexture(64);
+
+	streamer->budget(texture->mipLevelsMemory(1));
+
+	for (uint i = 0; i < 3; ++i)
+	{
+		streamer->request(texture, 0);
+		sceneManager->nextFrame(0.f, 0.f);
+	}
+
+	ASSERT_EQ(texture->residentMipLevel(), 1);
+	ASSERT_EQ(streamer->numPendingTextures(), 1);
+	ASSERT_EQ(streamer->numUploads(), 0);
+}
+
+TEST_F(TextureStreamerTest, DestroyedTexturesAreForgotten)
+{
+	auto sceneManager	= SceneManager::create(MinkoTests::context());
+	auto streamer		= TextureStreamer::create(1024 * 1024);
+	auto root			= scene::Node::create()->addComponent(sceneManager)->addComponent(streamer);
+	auto texture		= createStreamedTexture(64);
+	auto weakTexture	= std::weak_ptr<render::Texture>(texture);
+
+	streamer->request(texture, 0);
+	sceneManager->nextFrame(0.f, 0.f);
+	texture = nullptr;
+
+	// the streamer does not keep the texture alive
+	ASSERT_TRUE(weakTexture.expired());
+
+	sceneManager->nextFrame(0.f, 0.f);
+
+	ASSERT_EQ(streamer->numTextures(), 0);
+	ASSERT_EQ(streamer->residentMemory(), 0);
+}
+
+TEST_F(TextureStreamerTest, ReleasesDataOnceResident)
+{
+	auto sceneManager	= SceneManager::create(MinkoTests::context());
+	auto streamer		= TextureStreamer::create(1024 * 1024);
+	auto root			= scene::Node::create()->addComponent(sceneManager)->addComponent(streamer);
+	auto texture		= createStreamedTexture(64);
+	auto other			= createStreamedTexture(64);
+	auto numReloads		= 0;
+
+	texture->dataSource([&](render::Texture& streamedTexture)
+	{
+		++numReloads;
+		streamedTexture.data(std::vector<unsigned char>(64 * 64 * sizeof(int), 255));
+	});
+
+	streamer->request(texture, 1);
+	sceneManager->nextFrame(0.f, 0.f);
+
+	// only the levels coarser than the resident one stay on the CPU
+	ASSERT_EQ(texture->residentMipLevel(), 1);
+	ASSERT_TRUE(texture->data().empty());
+	ASSERT_EQ(texture->dataMemory(), texture->mipLevelsMemory(2));
+
+	// a finer level is decoded again from the source
+	streamer->request(texture, 0);
+	sceneManager->nextFrame(0.f, 0.f);
+
+	ASSERT_EQ(texture->residentMipLevel(), 0);
+	ASSERT_EQ(numReloads, 1);
+	ASSERT_EQ(texture->dataMemory(), texture->mipLevelsMemory(1));
+
+	// evicting only needs the coarser levels
+	streamer->budget(texture->mipLevelsMemory(2) + other->mipLevelsMemory(0));
+	streamer->request(texture, 2);
+	streamer->request(other, 0);
+	sceneManager->nextFrame(0.f, 0.f);
+
+	ASSERT_EQ(streamer->numEvictions(), 1);
+	ASSERT_EQ(texture->residentMipLevel(), 2);
+	ASSERT_EQ(other->residentMipLevel(), 0);
+	ASSERT_EQ(numReloads, 1);
+
+	// without a source, the whole chain stays on the CPU
+	ASSERT_FALSE(other->data().empty());
+}
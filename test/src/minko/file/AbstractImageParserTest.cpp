@@ -0,0 +1,207 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/file/AbstractImageParserTest.hpp"
+
+#include "minko/AbstractCanvas.hpp"
+#include "minko/async/Worker.hpp"
+
+using namespace minko;
+using namespace minko::file;
+
+namespace
+{
+	// a width byte and a height byte followed by the RGBA pixels
+	class RawImageParser :
+		public AbstractImageParser
+	{
+	public:
+		static
+		Ptr
+		create()
+		{
+			return std::shared_ptr<RawImageParser>(new RawImageParser());
+		}
+
+		static
+		bool
+		decode(const unsigned char* data, std::size_t size, uint& width, uint& height, std::vector<unsigned char>& rgba)
+		{
+			if (data == nullptr || size < 2 || size != 2 + data[0] * data[1] * sizeof(int))
+				return false;
+
+			width = data[0];
+			height = data[1];
+			rgba = render::PixelBufferPool::acquire(width * height * sizeof(int));
+			std::copy(data + 2, data + size, rgba.begin());
+
+			return true;
+		}
+
+	private:
+		RawImageParser() :
+			AbstractImageParser("RAW", &RawImageParser::decode)
+		{
+		}
+	};
+
+	// only provides the workers, which are updated by update() as the canvas would every frame
+	class WorkerCanvas :
+		public AbstractCanvas
+	{
+	private:
+		std::list<std::shared_ptr<async::Worker>> _activeWorkers;
+
+	public:
+		uint x() { return 0; }
+		uint y() { return 0; }
+		uint width() { return 0; }
+		uint height() { return 0; }
+		std::shared_ptr<input::Mouse> mouse() { return nullptr; }
+		std::shared_ptr<input::Keyboard> keyboard() { return nullptr; }
+		std::shared_ptr<input::Joystick> joystick(uint id) { return nullptr; }
+		uint numJoysticks() { return 0; }
+		Signal<Ptr, uint, uint>::Ptr resized() { return nullptr; }
+		Signal<Ptr, std::shared_ptr<input::Joystick>>::Ptr joystickAdded() { return nullptr; }
+		Signal<Ptr, std::shared_ptr<input::Joystick>>::Ptr joystickRemoved() { return nullptr; }
+
+		std::shared_ptr<async::Worker>
+		getWorker(const std::string& name)
+		{
+			if (!_workers.count(name))
+				return nullptr;
+
+			auto worker = _workers[name]();
+
+			_activeWorkers.push_back(worker);
+
+			return worker;
+		}
+
+		bool
+		isWorkerRegistered(const std::string& name)
+		{
+			return _workers.count(name) != 0;
+		}
+
+		void
+		update()
+		{
+			for (auto& worker : _activeWorkers)
+				worker->update();
+		}
+	};
+
+	std::vector<unsigned char>
+	createImage(uint width, uint height)
+	{
+		std::vector<unsigned char> data(2 + width * height * sizeof(int));
+
+		data[0] = width;
+		data[1] = height;
+		for (uint i = 2; i < data.size(); ++i)
+			data[i] = i & 0xff;
+
+		return data;
+	}
+
+	// updates the canvas until the parser completes or fails
+	bool
+	parseAsynchronously(const std::vector<unsigned char>& data, AssetLibrary::Ptr assets, bool& failed)
+	{
+		auto canvas		= std::make_shared<WorkerCanvas>();
+		auto options	= Options::create(MinkoTests::context())->loadAsynchronously(true);
+		auto parser		= RawImageParser::create();
+		auto complete	= false;
+
+		failed = false;
+
+		auto completeSlot	= parser->complete()->connect([&](AbstractParser::Ptr) { complete = true; });
+		auto errorSlot		= parser->error()->connect([&](AbstractParser::Ptr, const ParserError&) { failed = true; });
+
+		AbstractCanvas::defaultCanvas(canvas);
+		parser->parse("image.raw", "image.raw", options, data, assets);
+
+		for (uint i = 0; i < 1000 && !complete && !failed; ++i)
+		{
+			canvas->update();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		return complete;
+	}
+}
+
+void
+AbstractImageParserTest::TearDown()
+{
+	AbstractCanvas::defaultCanvas(nullptr);
+}
+
+TEST_F(AbstractImageParserTest, ParseSynchronously)
+{
+	auto assets = AssetLibrary::create(MinkoTests::context());
+
+	RawImageParser::create()->parse("image.raw", "image.raw", Options::create(MinkoTests::context()), createImage(3, 2), assets);
+
+	auto texture = std::dynamic_pointer_cast<render::Texture>(assets->texture("image.raw"));
+
+	ASSERT_TRUE(texture != nullptr);
+	ASSERT_EQ(texture->width(), 4);
+	ASSERT_EQ(texture->height(), 2);
+	ASSERT_EQ(texture->data().size(), 4 * 2 * sizeof(int));
+
+	ASSERT_THROW(
+		RawImageParser::create()->parse("invalid.raw", "invalid.raw", Options::create(MinkoTests::context()), std::vector<unsigned char>(3), assets),
+		std::invalid_argument
+	);
+}
+
+TEST_F(AbstractImageParserTest, ParseAsynchronously)
+{
+	auto	assets	= AssetLibrary::create(MinkoTests::context());
+	bool	failed;
+
+	ASSERT_TRUE(parseAsynchronously(createImage(3, 2), assets, failed));
+	ASSERT_FALSE(failed);
+
+	auto texture = std::dynamic_pointer_cast<render::Texture>(assets->texture("image.raw"));
+
+	ASSERT_TRUE(texture != nullptr);
+	ASSERT_EQ(texture->width(), 4);
+	ASSERT_EQ(texture->height(), 2);
+
+	// the worker resizes the image: the texture gets the same data as when parsed synchronously
+	auto expected = AssetLibrary::create(MinkoTests::context());
+
+	RawImageParser::create()->parse("image.raw", "image.raw", Options::create(MinkoTests::context()), createImage(3, 2), expected);
+
+	ASSERT_EQ(texture->data(), std::dynamic_pointer_cast<render::Texture>(expected->texture("image.raw"))->data());
+}
+
+TEST_F(AbstractImageParserTest, AsynchronousDecodingError)
+{
+	auto	assets	= AssetLibrary::create(MinkoTests::context());
+	bool	failed;
+
+	ASSERT_FALSE(parseAsynchronously(std::vector<unsigned char>(3), assets, failed));
+	ASSERT_TRUE(failed);
+	ASSERT_TRUE(assets->texture("image.raw") == nullptr);
+}
@@ -0,0 +1,195 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/file/KTXParserTest.hpp"
+
+using namespace minko;
+using namespace minko::file;
+using namespace minko::render;
+
+namespace
+{
+	std::vector<std::vector<unsigned char>>
+	createMipLevels(TextureFormat format, uint width, uint height)
+	{
+		std::vector<std::vector<unsigned char>> levels;
+
+		for (uint level = 0; (width >> level) > 0 || (height >> level) > 0; ++level)
+		{
+			const uint					levelWidth	= std::max(1u, width >> level);
+			const uint					levelHeight	= std::max(1u, height >> level);
+			std::vector<unsigned char>	rgba(levelWidth * levelHeight * 4);
+
+			for (uint i = 0; i < rgba.size(); ++i)
+				rgba[i] = (i * 7 + level * 31) & 0xff;
+
+			if (format == TextureFormat::RGBA)
+				levels.push_back(rgba);
+			else
+			{
+				levels.push_back(std::vector<unsigned char>());
+				TextureCompression::compress(format, levelWidth, levelHeight, &rgba[0], levels.back());
+			}
+		}
+
+		return levels;
+	}
+}
+
+TEST_F(KTXParserTest, WriteRead)
+{
+	auto						levels = createMipLevels(TextureFormat::RGB_ETC1, 16, 8);
+	std::vector<unsigned char>	data;
+
+	KTXWriter::write(data, TextureFormat::RGB_ETC1, 16, 8, levels);
+
+	TextureFormat							format;
+	uint									width;
+	uint									height;
+	std::vector<std::vector<unsigned char>>	readLevels;
+
+	ASSERT_TRUE(KTXParser::read(data, format, width, height, readLevels));
+	ASSERT_EQ(format, TextureFormat::RGB_ETC1);
+	ASSERT_EQ(width, 16);
+	ASSERT_EQ(height, 8);
+	ASSERT_EQ(readLevels.size(), 5);
+	ASSERT_EQ(readLevels, levels);
+}
+
+TEST_F(KTXParserTest, ReadBigEndian)
+{
+	auto						levels = createMipLevels(TextureFormat::RGBA, 4, 4);
+	std::vector<unsigned char>	data;
+
+	levels.resize(1);
+	KTXWriter::write(data, TextureFormat::RGBA, 4, 4, levels);
+
+	// swap the 13 header fields and the size of the level
+	for (uint offset = 12; offset < 68; offset += 4)
+	{
+		std::swap(data[offset], data[offset + 3]);
+		std::swap(data[offset + 1], data[offset + 2]);
+	}
+
+	TextureFormat							format;
+	uint									width;
+	uint									height;
+	std::vector<std::vector<unsigned char>>	readLevels;
+
+	ASSERT_TRUE(KTXParser::read(data, format, width, height, readLevels));
+	ASSERT_EQ(format, TextureFormat::RGBA);
+	ASSERT_EQ(width, 4);
+	ASSERT_EQ(readLevels, levels);
+}
+
+TEST_F(KTXParserTest, InvalidData)
+{
+	auto						levels = createMipLevels(TextureFormat::RGBA_DXT5, 8, 8);
+	std::vector<unsigned char>	data;
+	TextureFormat				format;
+	uint						width;
+	uint						height;
+
+	KTXWriter::write(data, TextureFormat::RGBA_DXT5, 8, 8, levels);
+
+	auto truncated = std::vector<unsigned char>(data.begin(), data.end() - 4);
+	auto notKTX = data;
+
+	notKTX[1] = 'X';
+
+	ASSERT_FALSE(KTXParser::read(truncated, format, width, height, levels));
+	ASSERT_FALSE(KTXParser::read(notKTX, format, width, height, levels));
+	ASSERT_THROW(KTXWriter::write(data, TextureFormat::RGB, 8, 8, levels), std::invalid_argument);
+}
+
+TEST_F(KTXParserTest, CompressedTexture)
+{
+	auto						context	= MinkoTests::context();
+	auto						levels	= createMipLevels(TextureFormat::RGB_DXT1, 16, 16);
+	std::vector<unsigned char>	data;
+
+	KTXWriter::write(data, TextureFormat::RGB_DXT1, 16, 16, levels);
+
+	auto assets		= AssetLibrary::create(context);
+	auto options	= Options::create(context);
+
+	options->generateMipmaps(true);
+	assets->getParser("ktx")->parse("texture.ktx", "texture.ktx", options, data, assets);
+
+	auto texture = std::dynamic_pointer_cast<Texture>(assets->texture("texture.ktx"));
+
+	ASSERT_NE(texture, nullptr);
+	ASSERT_EQ(texture->width(), 16);
+	ASSERT_EQ(texture->height(), 16);
+	if (context->supportsTextureFormat(TextureFormat::RGB_DXT1))
+	{
+		ASSERT_EQ(texture->format(), TextureFormat::RGB_DXT1);
+		ASSERT_EQ(texture->compressedData(), levels);
+		ASSERT_TRUE(texture->mipMapping());
+		// 16x16, 8x8, 4x4 and 2 levels smaller than a block
+		ASSERT_EQ(texture->mipLevelsMemory(0), (16 + 4 + 1 + 1 + 1) * 8);
+	}
+	else
+	{
+		// transcoded on load
+		ASSERT_EQ(texture->format(), TextureFormat::RGBA);
+		ASSERT_EQ(texture->data().size(), 16 * 16 * 4);
+	}
+}
+
+TEST_F(KTXParserTest, IncompleteMipChain)
+{
+	auto context	= MinkoTests::context();
+	auto levels		= createMipLevels(TextureFormat::RGB_ETC1, 16, 16);
+
+	levels.resize(2);
+
+	auto texture = Texture::create(context, 16, 16, true);
+
+	texture->compressedData(TextureFormat::RGB_ETC1, levels);
+
+	// compressed levels cannot be generated by the GPU
+	if (context->supportsTextureFormat(TextureFormat::RGB_ETC1))
+		ASSERT_FALSE(texture->mipMapping());
+	else
+		ASSERT_TRUE(texture->mipMapping());
+}
+
+TEST_F(KTXParserTest, PrecomputedMipChain)
+{
+	auto						context	= MinkoTests::context();
+	auto						levels	= createMipLevels(TextureFormat::RGBA, 8, 4);
+	std::vector<unsigned char>	data;
+
+	KTXWriter::write(data, TextureFormat::RGBA, 8, 4, levels);
+
+	auto assets		= AssetLibrary::create(context);
+	auto options	= Options::create(context);
+
+	options->generateMipmaps(true);
+	assets->getParser("ktx")->parse("chain.ktx", "chain.ktx", options, data, assets);
+
+	auto texture = std::dynamic_pointer_cast<Texture>(assets->texture("chain.ktx"));
+
+	ASSERT_EQ(texture->numMipLevels(), levels.size());
+	ASSERT_EQ(texture->data(), levels[0]);
+	for (uint level = 1; level < levels.size(); ++level)
+		ASSERT_TRUE(std::equal(levels[level].begin(), levels[level].end(), texture->mipLevelData(level)));
+}
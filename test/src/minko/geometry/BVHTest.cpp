@@ -0,0 +1,284 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "BVHTest.hpp"
+
+#include "minko/MinkoTests.hpp"
+
+using namespace minko;
+using namespace minko::geometry;
+
+namespace
+{
+	float
+	random(float min, float max)
+	{
+		return min + (max - min) * (float)rand() / RAND_MAX;
+	}
+
+	// two 2x2 quads facing +z, at z = 0 and z = -1
+	void
+	createQuads(std::vector<float>& xyz, std::vector<unsigned short>& indices)
+	{
+		xyz = {
+			-1.f, -1.f, 0.f,	1.f, -1.f, 0.f,		1.f, 1.f, 0.f,		-1.f, 1.f, 0.f,
+			-1.f, -1.f, -1.f,	1.f, -1.f, -1.f,	1.f, 1.f, -1.f,		-1.f, 1.f, -1.f
+		};
+		indices = { 4, 5, 6, 4, 6, 7, 0, 1, 2, 0, 2, 3 };
+	}
+
+	void
+	createTriangleSoup(uint numTriangles, std::vector<float>& xyz, std::vector<unsigned short>& indices)
+	{
+		xyz.clear();
+		indices.clear();
+		for (uint i = 0; i < numTriangles; ++i)
+		{
+			const float center[3] = { random(-10.f, 10.f), random(-10.f, 10.f), random(-10.f, 10.f) };
+
+			for (uint j = 0; j < 3; ++j)
+			{
+				for (uint k = 0; k < 3; ++k)
+					xyz.push_back(center[k] + random(-1.f, 1.f));
+				indices.push_back(i * 3 + j);
+			}
+		}
+	}
+
+	bool
+	bruteForceCast(const std::vector<float>&			xyz,
+				   const std::vector<unsigned short>&	indices,
+				   const float*							origin,
+				   const float*							direction,
+				   float&								distance)
+	{
+		auto hit = false;
+
+		for (uint i = 0; i < indices.size(); i += 3)
+		{
+			auto v0 = math::Vector3::create(xyz[indices[i] * 3], xyz[indices[i] * 3 + 1], xyz[indices[i] * 3 + 2]);
+			auto v1 = math::Vector3::create(xyz[indices[i + 1] * 3], xyz[indices[i + 1] * 3 + 1], xyz[indices[i + 1] * 3 + 2]);
+			auto v2 = math::Vector3::create(xyz[indices[i + 2] * 3], xyz[indices[i + 2] * 3 + 1], xyz[indices[i + 2] * 3 + 2]);
+			auto dir = math::Vector3::create(direction[0], direction[1], direction[2]);
+			auto edge1 = math::Vector3::create(v1)->subtract(v0);
+			auto edge2 = math::Vector3::create(v2)->subtract(v0);
+			auto pvec = math::Vector3::create(dir)->cross(edge2);
+			auto dot = edge1->dot(pvec);
+
+			if (dot == 0.f)
+				continue;
+
+			auto tvec = math::Vector3::create(origin[0], origin[1], origin[2])->subtract(v0);
+			auto u = tvec->dot(pvec) / dot;
+			auto qvec = math::Vector3::create(tvec)->cross(edge1);
+			auto v = dir->dot(qvec) / dot;
+			auto t = edge2->dot(qvec) / dot;
+
+			if (u >= 0.f && v >= 0.f && u + v <= 1.f && t >= 0.f && (!hit || t < distance))
+			{
+				distance = t;
+				hit = true;
+			}
+		}
+
+		return hit;
+	}
+}
+
+TEST_F(BVHTest, CreateEmpty)
+{
+	auto bvh = BVH::create(std::vector<float>(), 3, 0, std::vector<unsigned short>());
+	const float origin[3] = { 0.f, 0.f, 0.f };
+	const float direction[3] = { 0.f, 0.f, -1.f };
+	BVH::Hit hit;
+
+	ASSERT_EQ(bvh->numNodes(), 0);
+	ASSERT_FALSE(bvh->cast(origin, direction, hit));
+	ASSERT_FALSE(bvh->castAny(origin, direction));
+}
+
+TEST_F(BVHTest, CastClosestHit)
+{
+	std::vector<float> xyz;
+	std::vector<unsigned short> indices;
+
+	createQuads(xyz, indices);
+
+	auto bvh = BVH::create(xyz, 3, 0, indices);
+	const float origin[3] = { .5f, -.5f, 5.f };
+	const float direction[3] = { 0.f, 0.f, -1.f };
+	BVH::Hit hit;
+
+	ASSERT_EQ(bvh->numTriangles(), 4);
+	ASSERT_TRUE(bvh->cast(origin, direction, hit));
+	ASSERT_FLOAT_EQ(hit.distance, 5.f);
+	ASSERT_EQ(hit.triangle, 6);
+	ASSERT_FLOAT_EQ(hit.u, .5f);
+	ASSERT_FLOAT_EQ(hit.v, .25f);
+}
+
+TEST_F(BVHTest, CastMiss)
+{
+	std::vector<float> xyz;
+	std::vector<unsigned short> indices;
+
+	createQuads(xyz, indices);
+
+	auto bvh = BVH::create(xyz, 3, 0, indices);
+	const float origin[3] = { 2.f, 0.f, 5.f };
+	const float backward[3] = { 0.f, 0.f, 1.f };
+	const float outside[3] = { 0.f, 0.f, -1.f };
+	BVH::Hit hit;
+
+	ASSERT_FALSE(bvh->cast(origin, outside, hit));
+
+	const float inFront[3] = { 0.f, 0.f, 5.f };
+
+	ASSERT_FALSE(bvh->cast(inFront, backward, hit));
+}
+
+TEST_F(BVHTest, CastAny)
+{
+	std::vector<float> xyz;
+	std::vector<unsigned short> indices;
+
+	createQuads(xyz, indices);
+
+	auto bvh = BVH::create(xyz, 3, 0, indices);
+	const float origin[3] = { 0.f, 0.f, 5.f };
+	const float direction[3] = { 0.f, 0.f, -1.f };
+
+	ASSERT_TRUE(bvh->castAny(origin, direction));
+	ASSERT_TRUE(bvh->castAny(origin, direction, 5.5f));
+	ASSERT_FALSE(bvh->castAny(origin, direction, 4.f));
+}
+
+TEST_F(BVHTest, InterleavedVertices)
+{
+	// position stored after a 2-float uv in a 5-float vertex
+	std::vector<float> xyz;
+	std::vector<unsigned short> indices;
+	std::vector<float> vertices;
+
+	createQuads(xyz, indices);
+	for (uint i = 0; i < xyz.size(); i += 3)
+		vertices.insert(vertices.end(), { 42.f, 42.f, xyz[i], xyz[i + 1], xyz[i + 2] });
+
+	auto bvh = BVH::create(vertices, 5, 2, indices);
+	const float origin[3] = { 0.f, .5f, 3.f };
+	const float direction[3] = { 0.f, 0.f, -1.f };
+	BVH::Hit hit;
+
+	ASSERT_TRUE(bvh->cast(origin, direction, hit));
+	ASSERT_FLOAT_EQ(hit.distance, 3.f);
+	ASSERT_EQ(hit.triangle, 9);
+}
+
+TEST_F(BVHTest, CastMatchesBruteForce)
+{
+	std::vector<float> xyz;
+	std::vector<unsigned short> indices;
+
+	createTriangleSoup(1000, xyz, indices);
+
+	auto bvh = BVH::create(xyz, 3, 0, indices);
+
+	ASSERT_EQ(bvh->numTriangles(), 1000);
+	ASSERT_GT(bvh->numNodes(), 1);
+
+	for (uint i = 0; i < 500; ++i)
+	{
+		const float origin[3] = { random(-15.f, 15.f), random(-15.f, 15.f), 20.f };
+		const float direction[3] = { random(-.5f, .5f), random(-.5f, .5f), -1.f };
+		auto expectedDistance = 0.f;
+		auto expected = bruteForceCast(xyz, indices, origin, direction, expectedDistance);
+		BVH::Hit hit;
+
+		ASSERT_EQ(bvh->cast(origin, direction, hit), expected);
+		ASSERT_EQ(bvh->castAny(origin, direction), expected);
+		if (expected)
+			ASSERT_NEAR(hit.distance, expectedDistance, 1e-3f);
+	}
+}
+
+TEST_F(BVHTest, CastPacket)
+{
+	const uint numRays = 64;
+	std::vector<float> xyz;
+	std::vector<unsigned short> indices;
+	std::vector<float> origins;
+	std::vector<float> directions;
+	std::vector<BVH::Hit> hits(numRays);
+
+	createTriangleSoup(1000, xyz, indices);
+	for (uint i = 0; i < numRays; ++i)
+	{
+		origins.insert(origins.end(), { 0.f, 0.f, 20.f });
+		directions.insert(directions.end(), { (i % 8) / 16.f - .25f, (i / 8) / 16.f - .25f, -1.f });
+	}
+
+	auto bvh = BVH::create(xyz, 3, 0, indices);
+	auto numHits = bvh->castPacket(numRays, &origins[0], &directions[0], &hits[0]);
+	auto expectedNumHits = 0u;
+
+	for (uint i = 0; i < numRays; ++i)
+	{
+		BVH::Hit hit;
+		auto expected = bvh->cast(&origins[i * 3], &directions[i * 3], hit);
+
+		if (expected)
+		{
+			++expectedNumHits;
+			ASSERT_EQ(hits[i].triangle, hit.triangle);
+			ASSERT_FLOAT_EQ(hits[i].distance, hit.distance);
+		}
+		else
+		{
+			ASSERT_EQ(hits[i].triangle, BVH::NO_HIT);
+		}
+	}
+
+	ASSERT_EQ(numHits, expectedNumHits);
+}
+
+TEST_F(BVHTest, NoHierarchyWithoutCpuData)
+{
+	std::vector<float> xyz;
+	std::vector<unsigned short> indices;
+
+	createQuads(xyz, indices);
+
+	auto geometry = Geometry::create();
+	auto xyzBuffer = render::VertexBuffer::create(MinkoTests::context(), xyz);
+
+	xyzBuffer->addAttribute("position", 3, 0);
+	geometry->addVertexBuffer(xyzBuffer);
+	geometry->indices(render::IndexBuffer::create(MinkoTests::context(), indices));
+
+	// the positions are only on the GPU: the geometry cannot be tested against a ray
+	xyzBuffer->data().clear();
+
+	auto ray = math::Ray::create(math::Vector3::create(.5f, -.5f, 5.f), math::Vector3::create(0.f, 0.f, -1.f));
+	auto distance = 0.f;
+	auto triangle = 0u;
+
+	ASSERT_EQ(geometry->bvh(), nullptr);
+	ASSERT_FALSE(geometry->cast(ray, distance, triangle));
+}
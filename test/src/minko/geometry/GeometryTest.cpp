@@ -17,6 +17,8 @@ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
+#include <random>
+
 #include "GeometryTest.hpp"
 
 #include "minko/MinkoTests.hpp"
@@ -24,6 +26,85 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 using namespace minko;
 using namespace minko::geometry;
 
+namespace
+{
+	// size x size quads with their triangles shuffled, the uv stream duplicates the xy positions
+	Geometry::Ptr
+	createShuffledGrid(uint size)
+	{
+		std::vector<float>						xyz;
+		std::vector<float>						uv;
+		std::vector<std::array<unsigned short, 3>>	triangles;
+		std::vector<unsigned short>				indices;
+
+		for (uint y = 0; y <= size; ++y)
+			for (uint x = 0; x <= size; ++x)
+			{
+				xyz.insert(xyz.end(), { (float)x, (float)y, 0.f });
+				uv.insert(uv.end(), { (float)x, (float)y });
+			}
+
+		for (uint y = 0; y < size; ++y)
+			for (uint x = 0; x < size; ++x)
+			{
+				const unsigned short i = y * (size + 1) + x;
+
+				triangles.push_back({ { i, (unsigned short)(i + 1), (unsigned short)(i + size + 2) } });
+				triangles.push_back({ { i, (unsigned short)(i + size + 2), (unsigned short)(i + size + 1) } });
+			}
+
+		std::mt19937 random(42);
+
+		std::shuffle(triangles.begin(), triangles.end(), random);
+		for (auto& triangle : triangles)
+			indices.insert(indices.end(), triangle.begin(), triangle.end());
+
+		auto geometry	= Geometry::create();
+		auto xyzBuffer	= render::VertexBuffer::create(MinkoTests::context(), xyz);
+		auto uvBuffer	= render::VertexBuffer::create(MinkoTests::context(), uv);
+
+		xyzBuffer->addAttribute("position", 3, 0);
+		uvBuffer->addAttribute("uv", 2, 0);
+		geometry->addVertexBuffer(xyzBuffer);
+		geometry->addVertexBuffer(uvBuffer);
+		geometry->indices(render::IndexBuffer::create(MinkoTests::context(), indices));
+
+		return geometry;
+	}
+
+	// triangles as sorted lists of positions, independent from the vertex and triangle orders
+	std::vector<std::vector<float>>
+	sortedTriangles(Geometry::Ptr geometry)
+	{
+		const auto&						xyz		= geometry->vertexBuffer("position")->data();
+		const auto&						indices	= geometry->indices()->data();
+		std::vector<std::vector<float>>	triangles;
+
+		for (uint i = 0; i < indices.size(); i += 3)
+		{
+			std::vector<std::vector<float>> vertices;
+
+			for (uint k = 0; k < 3; ++k)
+				vertices.push_back({ xyz[indices[i + k] * 3], xyz[indices[i + k] * 3 + 1], xyz[indices[i + k] * 3 + 2] });
+
+			// rotate the triangle so that it starts with its smallest vertex, keeping its winding
+			auto first = std::min_element(vertices.begin(), vertices.end());
+
+			std::rotate(vertices.begin(), first, vertices.end());
+
+			std::vector<float> triangle;
+
+			for (auto& vertex : vertices)
+				triangle.insert(triangle.end(), vertex.begin(), vertex.end());
+			triangles.push_back(triangle);
+		}
+
+		std::sort(triangles.begin(), triangles.end());
+
+		return triangles;
+	}
+}
+
 TEST_F(GeometryTest, Create)
 {
 	try
@@ -130,3 +211,78 @@ TEST_F(GeometryTest, VertexBufferRemovedFromData)
 
 	ASSERT_FALSE(g->data()->hasProperty("geometry.vertex.attribute.position"));
 }
+
+TEST_F(GeometryTest, AverageCacheMissRatio)
+{
+	std::vector<unsigned short> indices = { 0, 1, 2, 2, 1, 3 };
+
+	ASSERT_FLOAT_EQ(Geometry::averageCacheMissRatio(indices, 16), 2.f);
+	ASSERT_FLOAT_EQ(Geometry::averageCacheMissRatio(std::vector<unsigned short>(), 16), 0.f);
+
+	// with a 3 entries FIFO cache, vertex 0 is evicted by vertex 3
+	indices.insert(indices.end(), { 3, 1, 0 });
+
+	ASSERT_FLOAT_EQ(Geometry::averageCacheMissRatio(indices, 3), 5.f / 3.f);
+}
+
+TEST_F(GeometryTest, OptimizeReducesCacheMisses)
+{
+	auto geometry	= createShuffledGrid(40);
+	auto before		= geometry->averageCacheMissRatio();
+
+	geometry->optimize();
+
+	auto after = geometry->averageCacheMissRatio();
+
+	ASSERT_GT(before, 2.f);
+	ASSERT_LT(after, 1.f);
+}
+
+TEST_F(GeometryTest, OptimizeKeepsTriangles)
+{
+	auto geometry	= createShuffledGrid(20);
+	auto triangles	= sortedTriangles(geometry);
+
+	geometry->optimize();
+
+	ASSERT_EQ(sortedTriangles(geometry), triangles);
+	ASSERT_EQ(geometry->numVertices(), 21u * 21u);
+}
+
+TEST_F(GeometryTest, OptimizeRemapsAllVertexBuffers)
+{
+	auto geometry = createShuffledGrid(20);
+
+	geometry->optimize();
+
+	const auto& xyz = geometry->vertexBuffer("position")->data();
+	const auto& uv	= geometry->vertexBuffer("uv")->data();
+
+	for (uint i = 0; i < geometry->numVertices(); ++i)
+	{
+		ASSERT_FLOAT_EQ(uv[i * 2], xyz[i * 3]);
+		ASSERT_FLOAT_EQ(uv[i * 2 + 1], xyz[i * 3 + 1]);
+	}
+
+	// the vertices are numbered in their order of first use
+	int maxIndex = -1;
+
+	for (auto index : geometry->indices()->data())
+	{
+		ASSERT_LE(index, maxIndex + 1);
+		maxIndex = std::max(maxIndex, (int)index);
+	}
+}
+
+TEST_F(GeometryTest, OptimizeWithoutReorderingVertices)
+{
+	auto geometry	= createShuffledGrid(20);
+	auto xyz		= geometry->vertexBuffer("position")->data();
+	auto triangles	= sortedTriangles(geometry);
+
+	geometry->optimize(Geometry::DEFAULT_VERTEX_CACHE_SIZE, true, false);
+
+	ASSERT_EQ(geometry->vertexBuffer("position")->data(), xyz);
+	ASSERT_EQ(sortedTriangles(geometry), triangles);
+	ASSERT_LT(geometry->averageCacheMissRatio(), 1.f);
+}
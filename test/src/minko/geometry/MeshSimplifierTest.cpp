@@ -0,0 +1,156 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "MeshSimplifierTest.hpp"
+
+#include "minko/MinkoTests.hpp"
+
+using namespace minko;
+using namespace minko::geometry;
+
+namespace
+{
+	// size x size quads in the xy plane, z given by height(x, y)
+	Geometry::Ptr
+	createGrid(uint size, std::function<float(uint, uint)> height)
+	{
+		std::vector<float>			xyz;
+		std::vector<unsigned short>	indices;
+
+		for (uint y = 0; y <= size; ++y)
+			for (uint x = 0; x <= size; ++x)
+			{
+				xyz.push_back((float)x);
+				xyz.push_back((float)y);
+				xyz.push_back(height(x, y));
+			}
+
+		for (uint y = 0; y < size; ++y)
+			for (uint x = 0; x < size; ++x)
+			{
+				const unsigned short i = y * (size + 1) + x;
+
+				indices.insert(indices.end(), { i, (unsigned short)(i + 1), (unsigned short)(i + size + 2) });
+				indices.insert(indices.end(), { i, (unsigned short)(i + size + 2), (unsigned short)(i + size + 1) });
+			}
+
+		auto geometry		= Geometry::create();
+		auto vertexBuffer	= render::VertexBuffer::create(MinkoTests::context(), xyz);
+
+		vertexBuffer->addAttribute("position", 3, 0);
+		geometry->addVertexBuffer(vertexBuffer);
+		geometry->indices(render::IndexBuffer::create(MinkoTests::context(), indices));
+
+		return geometry;
+	}
+
+	uint
+	numTriangles(Geometry::Ptr geometry)
+	{
+		return geometry->indices()->data().size() / 3;
+	}
+}
+
+TEST_F(MeshSimplifierTest, FlatGridKeepsBorder)
+{
+	const uint	size		= 8;
+	auto		grid		= createGrid(size, [](uint x, uint y) { return 0.f; });
+	auto		simplified	= MeshSimplifier::create()->simplify(grid, 0);
+
+	// only the 4 * size border vertices remain: a polygon triangulated without inner vertex
+	ASSERT_EQ(numTriangles(simplified), 4 * size - 2);
+	for (auto index : simplified->indices()->data())
+	{
+		const uint x = index % (size + 1);
+		const uint y = index / (size + 1);
+
+		ASSERT_TRUE(x == 0 || y == 0 || x == size || y == size);
+	}
+}
+
+TEST_F(MeshSimplifierTest, SharesVertexBuffers)
+{
+	auto grid		= createGrid(4, [](uint x, uint y) { return 0.f; });
+	auto simplified	= MeshSimplifier::create()->simplify(grid, 16);
+
+	ASSERT_EQ(numTriangles(simplified), 16u);
+	ASSERT_EQ(simplified->vertexBuffers().size(), 1u);
+	ASSERT_EQ(simplified->vertexBuffers().front(), grid->vertexBuffers().front());
+	ASSERT_NE(simplified->indices(), grid->indices());
+	ASSERT_EQ(numTriangles(grid), 32u);
+}
+
+TEST_F(MeshSimplifierTest, MaxError)
+{
+	auto bumpy		= createGrid(8, [](uint x, uint y) { return (float)((x * x + y * 3) % 4); });
+	auto flat		= createGrid(8, [](uint x, uint y) { return 0.f; });
+	auto simplifier	= MeshSimplifier::create(1e-3f);
+
+	// a flat grid has no error to stop at, a bumpy one cannot be simplified as far as without bound
+	ASSERT_EQ(numTriangles(simplifier->simplify(flat, 0)), 30u);
+	ASSERT_GT(numTriangles(simplifier->simplify(bumpy, 0)), numTriangles(MeshSimplifier::create()->simplify(bumpy, 0)));
+}
+
+TEST_F(MeshSimplifierTest, NoFlippedTriangles)
+{
+	auto grid		= createGrid(16, [](uint x, uint y) { return sinf(x * .4f) * cosf(y * .3f) * 2.f; });
+	auto simplified	= MeshSimplifier::create()->simplify(grid, numTriangles(grid) / 4);
+	auto vertices	= grid->vertexBuffers().front()->data();
+	auto indices	= simplified->indices()->data();
+
+	ASSERT_LE(numTriangles(simplified), numTriangles(grid) / 4);
+	for (uint i = 0; i < indices.size(); i += 3)
+	{
+		const float* p0 = &vertices[indices[i] * 3];
+		const float* p1 = &vertices[indices[i + 1] * 3];
+		const float* p2 = &vertices[indices[i + 2] * 3];
+
+		// the grid is a height field facing +z: no triangle may end up facing -z
+		ASSERT_GE((p1[0] - p0[0]) * (p2[1] - p0[1]) - (p1[1] - p0[1]) * (p2[0] - p0[0]), 0.f);
+	}
+}
+
+TEST_F(MeshSimplifierTest, SimplifyChain)
+{
+	auto sphere	= SphereGeometry::create(MinkoTests::context(), 32, 32);
+	auto levels	= MeshSimplifier::create()->simplifyChain(sphere, 3);
+
+	ASSERT_EQ(levels.size(), 3u);
+	ASSERT_LE(numTriangles(levels[0]), numTriangles(sphere) / 2);
+	ASSERT_LE(numTriangles(levels[1]), numTriangles(levels[0]) / 2);
+	ASSERT_LE(numTriangles(levels[2]), numTriangles(levels[1]) / 2);
+	ASSERT_GT(numTriangles(levels[2]), 0u);
+}
+
+TEST_F(MeshSimplifierTest, MissingData)
+{
+	auto simplifier	= MeshSimplifier::create();
+	auto noPosition	= Geometry::create();
+	auto normals	= render::VertexBuffer::create(MinkoTests::context(), std::vector<float>(9, 0.f));
+
+	normals->addAttribute("normal", 3, 0);
+	noPosition->addVertexBuffer(normals);
+	noPosition->indices(render::IndexBuffer::create(MinkoTests::context(), std::vector<unsigned short>({ 0, 1, 2 })));
+
+	ASSERT_THROW(simplifier->simplify(nullptr, 0), std::invalid_argument);
+	ASSERT_THROW(simplifier->simplify(Geometry::create(), 0), std::logic_error);
+	ASSERT_THROW(simplifier->simplify(noPosition, 0), std::logic_error);
+	ASSERT_THROW(simplifier->simplifyChain(Geometry::create(), 2), std::logic_error);
+}
@@ -476,6 +476,42 @@ TEST_F(Matrix4x4Test, TransformPrependRotationZRandom)
 	}
 }
 
+TEST_F(Matrix4x4Test, LookAt)
+{
+	auto position	= Vector3::create(3.f, 4.f, 5.f);
+	auto target		= Vector3::create(-1.f, 2.f, 0.f);
+	auto m			= Matrix4x4::create()->lookAt(target, position, Vector3::up());
+	auto origin		= m->transform(Vector3::zero());
+	auto zAxis		= m->deltaTransform(Vector3::zAxis());
+	auto xAxis		= m->deltaTransform(Vector3::xAxis());
+	auto direction	= (position - target)->normalize();
+
+	ASSERT_TRUE(nearEqual(origin->x(), 3.f));
+	ASSERT_TRUE(nearEqual(origin->y(), 4.f));
+	ASSERT_TRUE(nearEqual(origin->z(), 5.f));
+	ASSERT_TRUE(nearEqual(zAxis->x(), direction->x()));
+	ASSERT_TRUE(nearEqual(zAxis->y(), direction->y()));
+	ASSERT_TRUE(nearEqual(zAxis->z(), direction->z()));
+	ASSERT_TRUE(nearEqual(xAxis->y(), 0.f));
+}
+
+TEST_F(Matrix4x4Test, LookAtFromTranslation)
+{
+	auto m		= Matrix4x4::create()->appendTranslation(0.f, 0.f, 5.f);
+	auto view	= Matrix4x4::create()->view(Vector3::create(0.f, 0.f, 5.f), Vector3::zero());
+
+	m->lookAt(Vector3::zero(), nullptr, nullptr);
+
+	ASSERT_TRUE(nearEqual(m, view->invert()));
+}
+
+TEST_F(Matrix4x4Test, ViewAlongUpAxis)
+{
+	auto m = Matrix4x4::create();
+
+	ASSERT_THROW(m->view(Vector3::zero(), Vector3::create(0.f, 5.f, 0.f), Vector3::up()), std::invalid_argument);
+}
+
 TEST_F(Matrix4x4Test, AppendRotationXVsAppendRotation)
 {
 	auto m1 = Matrix4x4::create();
@@ -706,4 +742,27 @@ TEST_F(Matrix4x4Test, DecomposeRecompose)
 
 		ASSERT_TRUE(nearEqual(mat1, mat2, epsilon));
 	}
-}
\ No newline at end of file
+}
+TEST_F(Matrix4x4Test, InitializeBatch)
+{
+	auto	m1			= Matrix4x4::create();
+	auto	m2			= Matrix4x4::create();
+	auto	matrices	= std::vector<Matrix4x4::Ptr> { m1, m2 };
+	auto	values		= std::vector<float>(32);
+	auto	consistent	= true;
+
+	for (uint i = 0; i < 32; ++i)
+		values[i] = (float)i;
+
+	// both matrices must be up to date by the time the first one notifies
+	auto _ = m1->changed()->connect([&](data::Value::Ptr)
+	{
+		consistent = m2->values()[0] == 16.f;
+	});
+
+	Matrix4x4::initialize(matrices, &values[0]);
+
+	ASSERT_TRUE(consistent);
+	ASSERT_EQ(m1->values(), std::vector<float>(values.begin(), values.begin() + 16));
+	ASSERT_EQ(m2->values(), std::vector<float>(values.begin() + 16, values.end()));
+}
@@ -0,0 +1,89 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include "minko/particle/DepthSorterTest.hpp"
+
+using namespace minko;
+using namespace minko::particle;
+
+TEST_F(DepthSorterTest, SortBackToFront)
+{
+	DepthSorter sorter;
+
+	sorter.resize(100);
+	for (unsigned int i = 0; i < 100; ++i)
+		sorter.depths()[i] = float((i * 37) % 100);
+
+	sorter.sort();
+
+	ASSERT_TRUE(isBackToFront(sorter));
+	ASSERT_EQ(sorter.order().front(), 27u);
+	ASSERT_EQ(sorter.order().back(), 0u);
+}
+
+TEST_F(DepthSorterTest, CoherentMotionUsesInsertionSort)
+{
+	DepthSorter sorter;
+
+	sorter.resize(1000);
+	for (unsigned int i = 0; i < 1000; ++i)
+		sorter.depths()[i] = float(i);
+	sorter.sort();
+
+	// neighbours swap places: the previous order is almost right
+	for (unsigned int i = 0; i < 1000; i += 2)
+		std::swap(sorter.depths()[i], sorter.depths()[i + 1]);
+	sorter.sort();
+
+	ASSERT_FALSE(sorter.usedRadixSort());
+	ASSERT_TRUE(isBackToFront(sorter));
+}
+
+TEST_F(DepthSorterTest, ReversedOrderFallsBackToRadixSort)
+{
+	DepthSorter sorter;
+
+	sorter.resize(1000);
+	for (unsigned int i = 0; i < 1000; ++i)
+		sorter.depths()[i] = float(i);
+	sorter.sort();
+
+	for (unsigned int i = 0; i < 1000; ++i)
+		sorter.depths()[i] = float(1000 - i);
+	sorter.sort();
+
+	ASSERT_TRUE(sorter.usedRadixSort());
+	ASSERT_TRUE(isBackToFront(sorter));
+}
+
+TEST_F(DepthSorterTest, ResizeKeepsPreviousOrder)
+{
+	DepthSorter sorter;
+
+	sorter.resize(4);
+	for (unsigned int i = 0; i < 4; ++i)
+		sorter.depths()[i] = float(i);
+	sorter.sort();
+
+	// dropped particles are removed from the order, new ones are appended nearest to the camera
+	sorter.resize(2);
+	ASSERT_EQ(sorter.order(), std::vector<unsigned int>({ 1, 0 }));
+
+	sorter.resize(3);
+	ASSERT_EQ(sorter.order(), std::vector<unsigned int>({ 1, 0, 2 }));
+}
@@ -0,0 +1,180 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "LightClustersTest.hpp"
+
+using namespace minko;
+using namespace minko::render;
+using namespace minko::math;
+
+namespace
+{
+	const float Z_NEAR	= .1f;
+	const float Z_FAR	= 100.f;
+
+	float
+	random(float min, float max)
+	{
+		return min + (max - min) * (float)rand() / RAND_MAX;
+	}
+
+	// cluster of a world-space position, computed the same way as in ClusteredLighting.function.glsl
+	uint
+	clusterAt(LightClusters::Ptr clusters, Matrix4x4::Ptr worldToScreen, float x, float y, float z)
+	{
+		const auto& m = worldToScreen->data();
+		const float clipX = m[0] * x + m[1] * y + m[2] * z + m[3];
+		const float clipY = m[4] * x + m[5] * y + m[6] * z + m[7];
+		const float clipW = m[12] * x + m[13] * y + m[14] * z + m[15];
+
+		const float tileX = std::max(0.f, std::min(clusters->numX() - 1.f, floorf((clipX / clipW * .5f + .5f) * clusters->numX())));
+		const float tileY = std::max(0.f, std::min(clusters->numY() - 1.f, floorf((clipY / clipW * .5f + .5f) * clusters->numY())));
+		const float slice = std::max(0.f, std::min(clusters->numZ() - 1.f, floorf(logf(clipW) * clusters->depthScale() + clusters->depthBias())));
+
+		return clusters->clusterIndex((uint)tileX, (uint)tileY, (uint)slice);
+	}
+
+	bool
+	clusterHasLight(LightClusters::Ptr clusters, uint cluster, uint light)
+	{
+		const auto lights = clusters->lights(cluster);
+
+		return std::find(lights, lights + clusters->numLights(cluster), light) != lights + clusters->numLights(cluster);
+	}
+}
+
+TEST_F(LightClustersTest, SingleLight)
+{
+	auto clusters	= LightClusters::create(16, 8, 24, 8);
+	auto view		= Matrix4x4::create();
+	auto projection	= Matrix4x4::create()->perspective(.785f, 1.f, Z_NEAR, Z_FAR);
+
+	clusters->build({ 0.f, 0.f, -10.f, 1.f }, view, projection, Z_NEAR, Z_FAR);
+
+	const uint center	= clusterAt(clusters, projection, 0.f, 0.f, -10.f);
+	uint numClusters	= 0;
+
+	ASSERT_TRUE(clusterHasLight(clusters, center, 0));
+	ASSERT_FALSE(clusterHasLight(clusters, clusterAt(clusters, projection, 0.f, 0.f, -5.f), 0));
+	ASSERT_FALSE(clusterHasLight(clusters, clusters->clusterIndex(0, 0, 0), 0));
+
+	for (uint i = 0; i < clusters->numClusters(); ++i)
+		numClusters += clusters->numLights(i);
+
+	ASSERT_GT(numClusters, 1u);
+	ASSERT_LT(numClusters, clusters->numClusters() / 10);
+}
+
+TEST_F(LightClustersTest, LightBehindCamera)
+{
+	auto clusters	= LightClusters::create();
+	auto projection	= Matrix4x4::create()->perspective(.785f, 1.f, Z_NEAR, Z_FAR);
+
+	clusters->build({ 0.f, 0.f, 10.f, 1.f }, Matrix4x4::create(), projection, Z_NEAR, Z_FAR);
+
+	for (uint i = 0; i < clusters->numClusters(); ++i)
+		ASSERT_EQ(clusters->numLights(i), 0u);
+}
+
+TEST_F(LightClustersTest, InfiniteRange)
+{
+	auto clusters	= LightClusters::create(4, 4, 4, 8);
+	auto projection	= Matrix4x4::create()->perspective(.785f, 1.f, Z_NEAR, Z_FAR);
+
+	clusters->build({ 0.f, 0.f, 10.f, -1.f }, Matrix4x4::create(), projection, Z_NEAR, Z_FAR);
+
+	for (uint i = 0; i < clusters->numClusters(); ++i)
+		ASSERT_TRUE(clusterHasLight(clusters, i, 0));
+}
+
+TEST_F(LightClustersTest, Conservative)
+{
+	const uint numLights = 256;
+
+	auto clusters		= LightClusters::create(16, 8, 24, 255);
+	auto view			= Matrix4x4::create()->view(Vector3::create(3.f, 2.f, 5.f), Vector3::create(0.f, 0.f, -1.f));
+	auto projection		= Matrix4x4::create()->perspective(.785f, 1.5f, Z_NEAR, Z_FAR);
+	auto worldToScreen	= Matrix4x4::create()->copyFrom(view)->append(projection);
+	std::vector<float> spheres;
+
+	for (uint i = 0; i < numLights; ++i)
+	{
+		spheres.push_back(random(-20.f, 20.f));
+		spheres.push_back(random(-20.f, 20.f));
+		spheres.push_back(random(-40.f, 0.f));
+		spheres.push_back(random(.5f, 5.f));
+	}
+
+	clusters->build(spheres, view, projection, Z_NEAR, Z_FAR);
+
+	uint numPoints = 0;
+
+	// every point inside a light's sphere and inside the frustum must be in a cluster of that light
+	for (uint i = 0; i < numLights; ++i)
+	{
+		const float* sphere = &spheres[i * 4];
+
+		for (uint j = 0; j < 200; ++j)
+		{
+			auto dir = Vector3::create(random(-1.f, 1.f), random(-1.f, 1.f), random(-1.f, 1.f))->normalize();
+			auto r	= random(0.f, sphere[3]);
+			auto p	= Vector3::create(sphere[0] + dir->x() * r, sphere[1] + dir->y() * r, sphere[2] + dir->z() * r);
+			auto v	= view->transform(p);
+			auto q	= projection->transform(v);
+			auto x	= q->x() / -v->z();
+			auto y	= q->y() / -v->z();
+
+			if (x < -1.f || x > 1.f || y < -1.f || y > 1.f || -v->z() < Z_NEAR || -v->z() > Z_FAR)
+				continue;
+
+			ASSERT_TRUE(clusterHasLight(clusters, clusterAt(clusters, worldToScreen, p->x(), p->y(), p->z()), i));
+			++numPoints;
+		}
+	}
+
+	ASSERT_GT(numPoints, 1000u);
+}
+
+TEST_F(LightClustersTest, MultipleJobs)
+{
+	auto clusters1	= LightClusters::create();
+	auto clusters2	= LightClusters::create();
+	auto view		= Matrix4x4::create()->view(Vector3::create(0.f, 5.f, 5.f), Vector3::create(0.f, 0.f, -1.f));
+	auto projection	= Matrix4x4::create()->perspective(.785f, 1.f, Z_NEAR, Z_FAR);
+	std::vector<float> spheres;
+
+	for (uint i = 0; i < 500; ++i)
+	{
+		spheres.push_back(random(-30.f, 30.f));
+		spheres.push_back(random(-30.f, 30.f));
+		spheres.push_back(random(-60.f, 0.f));
+		spheres.push_back(random(1.f, 3.f));
+	}
+
+	clusters1->build(spheres, view, projection, Z_NEAR, Z_FAR, 1);
+	clusters2->build(spheres, view, projection, Z_NEAR, Z_FAR, 4);
+
+	for (uint i = 0; i < clusters1->numClusters(); ++i)
+	{
+		ASSERT_EQ(clusters1->numLights(i), clusters2->numLights(i));
+		for (uint j = 0; j < clusters1->numLights(i); ++j)
+			ASSERT_EQ(clusters1->lights(i)[j], clusters2->lights(i)[j]);
+	}
+}
@@ -0,0 +1,104 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/render/MipMapChainTest.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+TEST_F(MipMapChainTest, ResizeConstantImage)
+{
+	std::vector<unsigned char> rgba(30 * 20 * 4);
+	std::vector<unsigned char> resized;
+
+	for (uint i = 0; i < rgba.size(); i += 4)
+	{
+		rgba[i] = 10;
+		rgba[i + 1] = 100;
+		rgba[i + 2] = 200;
+		rgba[i + 3] = 255;
+	}
+
+	MipMapChain::resize(30, 20, &rgba[0], 32, 16, resized);
+
+	ASSERT_EQ(resized.size(), 32 * 16 * 4);
+	for (uint i = 0; i < resized.size(); i += 4)
+	{
+		ASSERT_EQ(resized[i], 10);
+		ASSERT_EQ(resized[i + 1], 100);
+		ASSERT_EQ(resized[i + 2], 200);
+		ASSERT_EQ(resized[i + 3], 255);
+	}
+}
+
+TEST_F(MipMapChainTest, ResizeSameSize)
+{
+	std::vector<unsigned char> rgba(8 * 8 * 4);
+	std::vector<unsigned char> resized;
+
+	for (uint i = 0; i < rgba.size(); ++i)
+		rgba[i] = i % 4 == 3 ? 255 : (i * 37) & 0xff;
+
+	MipMapChain::resize(8, 8, &rgba[0], 8, 8, resized);
+
+	ASSERT_EQ(resized, rgba);
+}
+
+TEST_F(MipMapChainTest, TransparentTexelsDoNotBleed)
+{
+	// opaque red texels next to transparent green ones
+	std::vector<unsigned char> rgba(4 * 4 * 4, 0);
+	std::vector<unsigned char> resized;
+
+	for (uint i = 0; i < 16; ++i)
+	{
+		const bool opaque = i % 2 == 0;
+
+		rgba[i * 4] = opaque ? 255 : 0;
+		rgba[i * 4 + 1] = opaque ? 0 : 255;
+		rgba[i * 4 + 3] = opaque ? 255 : 0;
+	}
+
+	MipMapChain::resize(4, 4, &rgba[0], 2, 2, resized);
+
+	for (uint i = 0; i < 4; ++i)
+	{
+		ASSERT_EQ(resized[i * 4], 255);
+		ASSERT_EQ(resized[i * 4 + 1], 0);
+		ASSERT_GT(resized[i * 4 + 3], 64);
+		ASSERT_LT(resized[i * 4 + 3], 192);
+	}
+}
+
+TEST_F(MipMapChainTest, BuildChain)
+{
+	std::vector<unsigned char>				rgba(16 * 4 * 4, 255);
+	std::vector<std::vector<unsigned char>>	levels;
+
+	MipMapChain::build(16, 4, &rgba[0], levels);
+
+	ASSERT_EQ(levels.size(), 5);
+	ASSERT_EQ(levels[0], rgba);
+	ASSERT_EQ(levels[1].size(), 8 * 2 * 4);
+	ASSERT_EQ(levels[2].size(), 4 * 1 * 4);
+	ASSERT_EQ(levels[3].size(), 2 * 1 * 4);
+	ASSERT_EQ(levels[4].size(), 1 * 1 * 4);
+	ASSERT_THROW(MipMapChain::build(12, 4, &rgba[0], levels), std::invalid_argument);
+}
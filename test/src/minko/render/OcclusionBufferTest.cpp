@@ -0,0 +1,162 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include "minko/render/OcclusionBufferTest.hpp"
+
+using namespace minko;
+using namespace minko::render;
+using namespace minko::math;
+
+namespace
+{
+	// a quad in the z = 0 plane covering [-size, size]^2
+	const std::vector<float>			QUAD_VERTICES	= { -1.f, -1.f, 0.f, 1.f, -1.f, 0.f, 1.f, 1.f, 0.f, -1.f, 1.f, 0.f };
+	const std::vector<unsigned short>	QUAD_INDICES	= { 0, 1, 2, 0, 2, 3 };
+
+	void
+	addQuad(OcclusionBuffer::Ptr buffer, float size, float z)
+	{
+		auto view			= Matrix4x4::create()->view(Vector3::create(0.f, 0.f, 0.f), Vector3::create(0.f, 0.f, -1.f));
+		auto projection		= Matrix4x4::create()->perspective(.785f, 1.f, .1f, 100.f);
+		auto modelToScreen	= Matrix4x4::create()
+			->appendScale(size, size, 1.f)
+			->appendTranslation(0.f, 0.f, z)
+			->append(view)
+			->append(projection);
+
+		buffer->addOccluder(&QUAD_VERTICES[0], 3, 0, 4, &QUAD_INDICES[0], 6, &modelToScreen->data()[0]);
+	}
+
+	float
+	depth(float z)
+	{
+		auto projection = Matrix4x4::create()->perspective(.785f, 1.f, .1f, 100.f);
+		auto clip		= projection->transform(Vector3::create(0.f, 0.f, z));
+
+		return clip->z() / -z * .5f + .5f;
+	}
+}
+
+TEST_F(OcclusionBufferTest, Empty)
+{
+	auto buffer = OcclusionBuffer::create(64, 32);
+
+	buffer->rasterize();
+
+	ASSERT_EQ(buffer->numLevels(), 7u);
+	ASSERT_FALSE(buffer->occluded(-1.f, -1.f, 1.f, 1.f, .99f));
+	ASSERT_FALSE(buffer->occluded(-.1f, -.1f, .1f, .1f, .5f));
+}
+
+TEST_F(OcclusionBufferTest, FullScreenOccluder)
+{
+	auto buffer = OcclusionBuffer::create(64, 32);
+
+	addQuad(buffer, 100.f, -10.f);
+	buffer->rasterize();
+
+	ASSERT_EQ(buffer->numTriangles(), 2u);
+	ASSERT_NEAR(buffer->depth(10, 10), depth(-10.f), 1e-4f);
+	ASSERT_TRUE(buffer->occluded(-1.f, -1.f, 1.f, 1.f, depth(-20.f)));
+	ASSERT_TRUE(buffer->occluded(-.1f, -.1f, .1f, .1f, depth(-11.f)));
+	ASSERT_FALSE(buffer->occluded(-.1f, -.1f, .1f, .1f, depth(-9.f)));
+}
+
+TEST_F(OcclusionBufferTest, PartialOccluder)
+{
+	auto buffer = OcclusionBuffer::create(128, 128);
+
+	// covers the center of the screen only: [-0.24, 0.24] in NDC
+	addQuad(buffer, 1.f, -10.f);
+	buffer->rasterize();
+
+	ASSERT_TRUE(buffer->occluded(-.1f, -.1f, .1f, .1f, depth(-20.f)));
+	ASSERT_FALSE(buffer->occluded(-.5f, -.1f, .1f, .1f, depth(-20.f)));
+	ASSERT_FALSE(buffer->occluded(.5f, .5f, .6f, .6f, depth(-20.f)));
+	ASSERT_FALSE(buffer->occluded(-1.f, -1.f, 1.f, 1.f, depth(-20.f)));
+}
+
+TEST_F(OcclusionBufferTest, NearPlaneOccluderDropped)
+{
+	auto buffer = OcclusionBuffer::create(64, 64);
+
+	// partly in front of the near plane
+	auto view			= Matrix4x4::create()->view(Vector3::create(0.f, 0.f, 0.f), Vector3::create(0.f, 0.f, -1.f));
+	auto projection		= Matrix4x4::create()->perspective(.785f, 1.f, .1f, 100.f);
+	auto modelToScreen	= Matrix4x4::create()
+		->appendScale(100.f, 100.f, 1.f)
+		->appendRotationX(1.2f)
+		->appendTranslation(0.f, 0.f, -10.f)
+		->append(view)
+		->append(projection);
+
+	buffer->addOccluder(&QUAD_VERTICES[0], 3, 0, 4, &QUAD_INDICES[0], 6, &modelToScreen->data()[0]);
+	buffer->rasterize();
+
+	ASSERT_EQ(buffer->numTriangles(), 0u);
+}
+
+TEST_F(OcclusionBufferTest, MultipleJobs)
+{
+	auto single		= OcclusionBuffer::create(128, 64);
+	auto multiple	= OcclusionBuffer::create(128, 64);
+
+	for (uint i = 0; i < 300; ++i)
+	{
+		const float size	= .1f + (i % 7) * .3f;
+		const float z		= -5.f - (i % 13);
+
+		addQuad(single, size, z);
+		addQuad(multiple, size, z);
+	}
+
+	single->rasterize(1);
+	multiple->rasterize(4);
+
+	for (uint level = 0; level < single->numLevels(); ++level)
+		for (uint y = 0; y < std::max(1u, 64u >> level); ++y)
+			for (uint x = 0; x < std::max(1u, 128u >> level); ++x)
+				ASSERT_EQ(single->depth(x, y, level), multiple->depth(x, y, level));
+}
+
+TEST_F(OcclusionBufferTest, HierarchyIsConservative)
+{
+	auto buffer = OcclusionBuffer::create(100, 60);
+
+	addQuad(buffer, 1.f, -10.f);
+	addQuad(buffer, .5f, -5.f);
+	buffer->rasterize();
+
+	for (uint level = 1; level < buffer->numLevels(); ++level)
+	{
+		const uint finerWidth	= std::max(1u, 100u >> (level - 1));
+		const uint finerHeight	= std::max(1u, 60u >> (level - 1));
+		const uint width		= std::max(1u, 100u >> level);
+		const uint height		= std::max(1u, 60u >> level);
+
+		for (uint y = 0; y < finerHeight; ++y)
+			for (uint x = 0; x < finerWidth; ++x)
+				ASSERT_GE(
+					buffer->depth(std::min(x / 2, width - 1), std::min(y / 2, height - 1), level),
+					buffer->depth(x, y, level - 1)
+				);
+	}
+}
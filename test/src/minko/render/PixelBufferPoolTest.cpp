@@ -0,0 +1,72 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/render/PixelBufferPoolTest.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+TEST_F(PixelBufferPoolTest, RecycleStorage)
+{
+	auto buffer = PixelBufferPool::acquire(1024);
+	auto storage = &buffer[0];
+
+	ASSERT_EQ(buffer.size(), 1024);
+
+	PixelBufferPool::release(buffer);
+
+	ASSERT_TRUE(buffer.empty());
+	ASSERT_EQ(PixelBufferPool::size(), 1024);
+
+	auto smaller = PixelBufferPool::acquire(512);
+
+	ASSERT_EQ(smaller.size(), 512);
+	ASSERT_EQ(&smaller[0], storage);
+	ASSERT_EQ(PixelBufferPool::size(), 0);
+}
+
+TEST_F(PixelBufferPoolTest, SmallestFittingBuffer)
+{
+	auto large = PixelBufferPool::acquire(4096);
+	auto small = PixelBufferPool::acquire(256);
+	auto storage = &small[0];
+
+	PixelBufferPool::release(large);
+	PixelBufferPool::release(small);
+
+	ASSERT_EQ(&PixelBufferPool::acquire(200)[0], storage);
+	ASSERT_EQ(PixelBufferPool::size(), 4096);
+}
+
+TEST_F(PixelBufferPoolTest, MaxSize)
+{
+	auto first = PixelBufferPool::acquire(1024);
+	auto second = PixelBufferPool::acquire(1024);
+
+	PixelBufferPool::maxSize(1500);
+	PixelBufferPool::release(first);
+	PixelBufferPool::release(second);
+
+	ASSERT_EQ(PixelBufferPool::size(), 1024);
+
+	PixelBufferPool::maxSize(0);
+
+	ASSERT_EQ(PixelBufferPool::size(), 0);
+}
@@ -0,0 +1,162 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include "minko/render/RenderGraphTest.hpp"
+
+#include "minko/MinkoTests.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+namespace
+{
+	void
+	noop(RenderGraph::Ptr graph)
+	{
+	}
+}
+
+TEST_F(RenderGraphTest, LinearChainAliasing)
+{
+	auto graph = RenderGraph::create(RenderTargetPool::create(MinkoTests::context()));
+
+	graph
+		->addTarget("scene", 1024, 1024)
+		->addTarget("blurX", 1024, 1024)
+		->addTarget("blurY", 1024, 1024)
+		->addTarget("toneMapping", 1024, 1024)
+		->importTarget("backBuffer", nullptr)
+		->addPass("scene", {}, { "scene" }, noop)
+		->addPass("blurX", { "scene" }, { "blurX" }, noop)
+		->addPass("blurY", { "blurX" }, { "blurY" }, noop)
+		->addPass("toneMapping", { "blurY" }, { "toneMapping" }, noop)
+		->addPass("antiAliasing", { "toneMapping" }, { "backBuffer" }, noop)
+		->output("backBuffer");
+
+	ASSERT_EQ(graph->numCulledPasses(), 0u);
+	ASSERT_EQ(graph->numTransientTargets(), 4u);
+	ASSERT_EQ(graph->numPhysicalTargets(), 2u);
+	ASSERT_EQ(graph->unaliasedMemory(), 4u * RenderTargetPool::memory(1024, 1024));
+	ASSERT_EQ(graph->transientMemory(), 2u * RenderTargetPool::memory(1024, 1024));
+}
+
+TEST_F(RenderGraphTest, OverlappingLifetimes)
+{
+	auto graph = RenderGraph::create(RenderTargetPool::create(MinkoTests::context()));
+
+	// "scene" is still alive when composited with the blurred image
+	graph
+		->addTarget("scene", 1024, 1024)
+		->addTarget("blurX", 1024, 1024)
+		->addTarget("blurY", 1024, 1024)
+		->addTarget("bloom", 1024, 1024)
+		->importTarget("backBuffer", nullptr)
+		->addPass("scene", {}, { "scene" }, noop)
+		->addPass("blurX", { "scene" }, { "blurX" }, noop)
+		->addPass("blurY", { "blurX" }, { "blurY" }, noop)
+		->addPass("bloom", { "scene", "blurY" }, { "bloom" }, noop)
+		->addPass("antiAliasing", { "bloom" }, { "backBuffer" }, noop)
+		->output("backBuffer");
+
+	ASSERT_EQ(graph->numPhysicalTargets(), 3u);
+	ASSERT_EQ(graph->transientMemory(), 3u * RenderTargetPool::memory(1024, 1024));
+}
+
+TEST_F(RenderGraphTest, DifferentSizesNotAliased)
+{
+	auto graph = RenderGraph::create(RenderTargetPool::create(MinkoTests::context()));
+
+	graph
+		->addTarget("scene", 1024, 1024)
+		->addTarget("halfX", 512, 1024)
+		->addTarget("half", 512, 512)
+		->addTarget("upsampled", 1000, 1000)
+		->importTarget("backBuffer", nullptr)
+		->addPass("scene", {}, { "scene" }, noop)
+		->addPass("halfX", { "scene" }, { "halfX" }, noop)
+		->addPass("half", { "halfX" }, { "half" }, noop)
+		->addPass("upsampled", { "half" }, { "upsampled" }, noop)
+		->addPass("present", { "upsampled" }, { "backBuffer" }, noop)
+		->output("backBuffer");
+
+	// "upsampled" has the same GPU size as "scene", which is dead by then
+	ASSERT_EQ(graph->numPhysicalTargets(), 3u);
+}
+
+TEST_F(RenderGraphTest, CullUnusedPasses)
+{
+	auto graph = RenderGraph::create(RenderTargetPool::create(MinkoTests::context()));
+
+	graph
+		->addTarget("scene", 1024, 1024)
+		->addTarget("luminance", 256, 256)
+		->addTarget("histogram", 64, 64)
+		->importTarget("backBuffer", nullptr)
+		->addPass("scene", {}, { "scene" }, noop)
+		->addPass("luminance", { "scene" }, { "luminance" }, noop)
+		->addPass("histogram", { "luminance" }, { "histogram" }, noop)
+		->addPass("present", { "scene" }, { "backBuffer" }, noop)
+		->output("backBuffer");
+
+	ASSERT_EQ(graph->numCulledPasses(), 2u);
+	ASSERT_TRUE(graph->culled("luminance"));
+	ASSERT_TRUE(graph->culled("histogram"));
+	ASSERT_FALSE(graph->culled("scene"));
+	ASSERT_EQ(graph->numPhysicalTargets(), 1u);
+	ASSERT_EQ(graph->unaliasedMemory(), RenderTargetPool::memory(1024, 1024));
+
+	graph->output("histogram");
+
+	ASSERT_EQ(graph->numCulledPasses(), 0u);
+}
+
+TEST_F(RenderGraphTest, ReadBeforeWrite)
+{
+	auto graph = RenderGraph::create(RenderTargetPool::create(MinkoTests::context()));
+
+	graph
+		->addTarget("scene", 1024, 1024)
+		->importTarget("backBuffer", nullptr)
+		->addPass("present", { "scene" }, { "backBuffer" }, noop)
+		->addPass("scene", {}, { "scene" }, noop)
+		->output("backBuffer");
+
+	ASSERT_THROW(graph->compile(), std::logic_error);
+}
+
+TEST_F(RenderGraphTest, ExecuteInOrder)
+{
+	auto					graph	= RenderGraph::create(RenderTargetPool::create(MinkoTests::context()));
+	std::vector<std::string>	passes;
+
+	graph
+		->importTarget("shadowMap", nullptr)
+		->importTarget("backBuffer", nullptr)
+		->addPass("shadows", {}, { "shadowMap" }, [&](RenderGraph::Ptr) { passes.push_back("shadows"); })
+		->addPass("debug", { "shadowMap" }, {}, [&](RenderGraph::Ptr) { passes.push_back("debug"); })
+		->addPass("scene", { "shadowMap" }, { "backBuffer" }, [&](RenderGraph::Ptr) { passes.push_back("scene"); })
+		->output("backBuffer");
+
+	graph->execute();
+	graph->execute();
+
+	ASSERT_EQ(passes, std::vector<std::string>({ "shadows", "scene", "shadows", "scene" }));
+}
@@ -0,0 +1,171 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/render/TextureCompressionTest.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+namespace
+{
+	std::vector<unsigned char>
+	createGradient(uint width, uint height, bool alpha)
+	{
+		std::vector<unsigned char> rgba(width * height * 4);
+
+		for (uint y = 0; y < height; ++y)
+			for (uint x = 0; x < width; ++x)
+			{
+				auto pixel = &rgba[(y * width + x) * 4];
+
+				pixel[0] = x * 255 / std::max(1u, width - 1);
+				pixel[1] = y * 255 / std::max(1u, height - 1);
+				pixel[2] = 128;
+				pixel[3] = alpha ? (x + y) * 255 / std::max(1u, width + height - 2) : 255;
+			}
+
+		return rgba;
+	}
+
+	float
+	averageError(const std::vector<unsigned char>& a, const std::vector<unsigned char>& b, uint channel)
+	{
+		float error = 0.f;
+
+		for (uint i = channel; i < a.size(); i += 4)
+			error += std::abs((int)a[i] - (int)b[i]);
+
+		return error / (a.size() / 4);
+	}
+}
+
+TEST_F(TextureCompressionTest, DataSize)
+{
+	ASSERT_EQ(TextureCompression::dataSize(TextureFormat::RGBA, 16, 8), 16 * 8 * 4);
+	ASSERT_EQ(TextureCompression::dataSize(TextureFormat::RGB_DXT1, 16, 8), 4 * 2 * 8);
+	ASSERT_EQ(TextureCompression::dataSize(TextureFormat::RGB_ETC1, 16, 8), 4 * 2 * 8);
+	ASSERT_EQ(TextureCompression::dataSize(TextureFormat::RGBA_DXT5, 16, 8), 4 * 2 * 16);
+	// blocks are always complete
+	ASSERT_EQ(TextureCompression::dataSize(TextureFormat::RGB_DXT1, 2, 1), 8);
+	ASSERT_EQ(TextureCompression::dataSize(TextureFormat::RGBA_PVRTC1_4BPP, 4, 4), 8 * 8 / 2);
+	ASSERT_EQ(TextureCompression::dataSize(TextureFormat::RGB_PVRTC1_4BPP, 32, 16), 32 * 16 / 2);
+}
+
+TEST_F(TextureCompressionTest, SolidColorDXT1)
+{
+	std::vector<unsigned char> rgba(8 * 8 * 4);
+	std::vector<unsigned char> compressed;
+	std::vector<unsigned char> decompressed;
+
+	for (uint i = 0; i < rgba.size(); i += 4)
+	{
+		rgba[i] = 200;
+		rgba[i + 1] = 100;
+		rgba[i + 2] = 50;
+		rgba[i + 3] = 255;
+	}
+
+	TextureCompression::compress(TextureFormat::RGB_DXT1, 8, 8, &rgba[0], compressed);
+	ASSERT_EQ(compressed.size(), 32);
+
+	TextureCompression::decompress(TextureFormat::RGB_DXT1, 8, 8, &compressed[0], decompressed);
+	ASSERT_EQ(decompressed.size(), rgba.size());
+
+	// 5 and 6 bits endpoints
+	for (uint c = 0; c < 4; ++c)
+		ASSERT_LE(averageError(rgba, decompressed, c), 4.f);
+}
+
+TEST_F(TextureCompressionTest, GradientDXT1)
+{
+	auto						rgba = createGradient(32, 32, false);
+	std::vector<unsigned char>	compressed;
+	std::vector<unsigned char>	decompressed;
+
+	TextureCompression::compress(TextureFormat::RGB_DXT1, 32, 32, &rgba[0], compressed);
+	TextureCompression::decompress(TextureFormat::RGB_DXT1, 32, 32, &compressed[0], decompressed);
+
+	for (uint c = 0; c < 3; ++c)
+		ASSERT_LE(averageError(rgba, decompressed, c), 6.f);
+	ASSERT_EQ(averageError(rgba, decompressed, 3), 0.f);
+}
+
+TEST_F(TextureCompressionTest, GradientDXT5)
+{
+	auto						rgba = createGradient(32, 32, true);
+	std::vector<unsigned char>	compressed;
+	std::vector<unsigned char>	decompressed;
+
+	TextureCompression::compress(TextureFormat::RGBA_DXT5, 32, 32, &rgba[0], compressed);
+	ASSERT_EQ(compressed.size(), 8 * 8 * 16);
+
+	TextureCompression::decompress(TextureFormat::RGBA_DXT5, 32, 32, &compressed[0], decompressed);
+
+	for (uint c = 0; c < 4; ++c)
+		ASSERT_LE(averageError(rgba, decompressed, c), 6.f);
+}
+
+TEST_F(TextureCompressionTest, GradientETC1)
+{
+	auto						rgba = createGradient(32, 32, false);
+	std::vector<unsigned char>	compressed;
+	std::vector<unsigned char>	decompressed;
+
+	TextureCompression::compress(TextureFormat::RGB_ETC1, 32, 32, &rgba[0], compressed);
+	ASSERT_EQ(compressed.size(), 8 * 8 * 8);
+
+	TextureCompression::decompress(TextureFormat::RGB_ETC1, 32, 32, &compressed[0], decompressed);
+
+	for (uint c = 0; c < 3; ++c)
+		ASSERT_LE(averageError(rgba, decompressed, c), 12.f);
+	ASSERT_EQ(averageError(rgba, decompressed, 3), 0.f);
+}
+
+TEST_F(TextureCompressionTest, IncompleteBlocks)
+{
+	auto						rgba = createGradient(2, 1, false);
+	std::vector<unsigned char>	compressed;
+	std::vector<unsigned char>	decompressed;
+
+	TextureCompression::compress(TextureFormat::RGB_ETC1, 2, 1, &rgba[0], compressed);
+	ASSERT_EQ(compressed.size(), 8);
+
+	TextureCompression::decompress(TextureFormat::RGB_ETC1, 2, 1, &compressed[0], decompressed);
+	ASSERT_EQ(decompressed.size(), 2 * 4);
+}
+
+TEST_F(TextureCompressionTest, NoSoftwareCodecForPVRTC)
+{
+	std::vector<unsigned char> rgba(8 * 8 * 4, 255);
+	std::vector<unsigned char> out;
+
+	ASSERT_THROW(
+		TextureCompression::compress(TextureFormat::RGB_PVRTC1_4BPP, 8, 8, &rgba[0], out),
+		std::logic_error
+	);
+	ASSERT_THROW(
+		TextureCompression::decompress(TextureFormat::RGBA_PVRTC1_4BPP, 8, 8, &rgba[0], out),
+		std::logic_error
+	);
+	ASSERT_THROW(
+		TextureCompression::compress(TextureFormat::RGBA, 8, 8, &rgba[0], out),
+		std::invalid_argument
+	);
+}
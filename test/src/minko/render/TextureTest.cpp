@@ -0,0 +1,93 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/render/TextureTest.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+TEST_F(TextureTest, NumMipLevels)
+{
+	ASSERT_EQ(Texture::create(nullptr, 256, 256)->numMipLevels(), 9);
+	ASSERT_EQ(Texture::create(nullptr, 256, 64)->numMipLevels(), 9);
+	ASSERT_EQ(Texture::create(nullptr, 1, 1)->numMipLevels(), 1);
+}
+
+TEST_F(TextureTest, MipLevelsMemory)
+{
+	auto mipMapped		= Texture::create(nullptr, 4, 2, true);
+	auto notMipMapped	= Texture::create(nullptr, 4, 2, false);
+
+	// 4x2, 2x1 and 1x1 RGBA levels
+	ASSERT_EQ(mipMapped->mipLevelsMemory(0), (8 + 2 + 1) * 4);
+	ASSERT_EQ(mipMapped->mipLevelsMemory(1), (2 + 1) * 4);
+	ASSERT_EQ(notMipMapped->mipLevelsMemory(0), 8 * 4);
+	ASSERT_EQ(notMipMapped->mipLevelsMemory(1), 2 * 4);
+}
+
+TEST_F(TextureTest, NotResidentBeforeUpload)
+{
+	auto texture = Texture::create(nullptr, 64, 64, true);
+
+	ASSERT_FALSE(texture->streamed());
+	ASSERT_EQ(texture->residentMipLevel(), texture->numMipLevels());
+}
+
+TEST_F(TextureTest, MipLevelsData)
+{
+	auto									texture = Texture::create(nullptr, 4, 2, true);
+	std::vector<std::vector<unsigned char>>	levels;
+
+	levels.push_back(std::vector<unsigned char>(4 * 2 * 4, 1));
+	levels.push_back(std::vector<unsigned char>(2 * 1 * 4, 2));
+	levels.push_back(std::vector<unsigned char>(1 * 1 * 4, 3));
+
+	texture->mipLevelsData(levels);
+
+	ASSERT_EQ(texture->data(), levels[0]);
+	ASSERT_EQ(texture->mipLevelData(1)[0], 2);
+	ASSERT_EQ(texture->mipLevelData(2)[0], 3);
+
+	levels[1].resize(4);
+	ASSERT_THROW(texture->mipLevelsData(levels), std::invalid_argument);
+	ASSERT_THROW(Texture::create(nullptr, 3, 2, true)->mipLevelsData(levels), std::logic_error);
+}
+
+TEST_F(TextureTest, DataWithoutCopy)
+{
+	auto texture	= Texture::create(nullptr, 4, 2, false);
+	auto rgba		= std::vector<unsigned char>(4 * 2 * 4, 1);
+	auto pixels		= &rgba[0];
+
+	texture->data(std::move(rgba));
+
+	ASSERT_EQ(&texture->data()[0], pixels);
+	ASSERT_THROW(texture->data(std::vector<unsigned char>(3)), std::invalid_argument);
+}
+
+TEST_F(TextureTest, DataResized)
+{
+	auto texture = Texture::create(nullptr, 3, 2, false, false, false);
+
+	texture->data(std::vector<unsigned char>(3 * 2 * 4, 1));
+
+	ASSERT_EQ(texture->data().size(), 4 * 2 * 4);
+	ASSERT_EQ(texture->data()[4 * 2 * 4 - 1], 1);
+}
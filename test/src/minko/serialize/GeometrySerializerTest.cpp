@@ -25,12 +25,68 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/MinkoTests.hpp"
 #include "minko/file/Options.hpp"
 #include "minko/file/Dependency.hpp"
+#include "minko/geometry/MeshSimplifier.hpp"
+#include "minko/file/SceneParser.hpp"
+#include "minko/Types.hpp"
 
 using namespace minko;
 using namespace minko::math;
 using namespace minko::serialize;
 using namespace minko::deserialize;
 
+namespace
+{
+	file::AssetLibrary::Ptr
+	writeAndParse(geometry::Geometry::Ptr	geometry,
+				  const std::string&		name,
+				  unsigned int&				fileSize,
+				  file::Options::Ptr		options = nullptr)
+	{
+		auto assetLibrary		= file::AssetLibrary::create(MinkoTests::context());
+		auto geometryWriter		= file::GeometryWriter::create();
+		auto outputAssetLibrary = file::AssetLibrary::create(MinkoTests::context());
+		auto geometryParser		= file::GeometryParser::create();
+		std::string	filename	= "asset.tmp";
+
+		assetLibrary->geometry(name, geometry);
+		geometryWriter->data(geometry);
+		geometryWriter->write(filename, assetLibrary, options ? options : file::Options::create(MinkoTests::context()));
+
+		std::vector<unsigned char>  data;
+		auto						flags = std::ios::in | std::ios::ate | std::ios::binary;
+		std::fstream				file(filename, flags);
+
+		fileSize = (unsigned int)file.tellg();
+		data.resize(fileSize);
+		file.seekg(0, std::ios::beg);
+		file.read((char*)&data[0], fileSize);
+		file.close();
+
+		geometryParser->parse(filename, filename, file::Options::create(MinkoTests::context()), data, outputAssetLibrary);
+
+		return outputAssetLibrary;
+	}
+
+	float
+	maxAttributeError(geometry::Geometry::Ptr geometry1, geometry::Geometry::Ptr geometry2, const std::string& attributeName)
+	{
+		auto		vertexBuffer1	= geometry1->vertexBuffer(attributeName);
+		auto		vertexBuffer2	= geometry2->vertexBuffer(attributeName);
+		const auto&	attribute1		= *vertexBuffer1->attribute(attributeName);
+		const auto&	attribute2		= *vertexBuffer2->attribute(attributeName);
+		float		maxError		= 0.f;
+
+		for (uint i = 0; i < vertexBuffer1->numVertices(); ++i)
+			for (uint k = 0; k < std::get<1>(attribute1); ++k)
+				maxError = std::max(maxError, fabsf(
+					vertexBuffer1->data()[i * vertexBuffer1->vertexSize() + std::get<2>(attribute1) + k]
+					- vertexBuffer2->data()[i * vertexBuffer2->vertexSize() + std::get<2>(attribute2) + k]
+				));
+
+		return maxError;
+	}
+}
+
 TEST_F(GeometrySerializerTest, CubeGeometrySerialization)
 {
 	auto cubeGeometry		= geometry::CubeGeometry::create(MinkoTests::context());
@@ -88,4 +144,342 @@ TEST_F(GeometrySerializerTest, SphereGeometrySerialization)
 
 	ASSERT_TRUE(outputAssetLibrary->geometry("Sphere") != nullptr);
 	ASSERT_TRUE(sphereGeometry->equals(outputAssetLibrary->geometry("Sphere")));
-}
\ No newline at end of file
+}
+
+TEST_F(GeometrySerializerTest, OptimizedSerializationKeepsSource)
+{
+	auto sphereGeometry		= geometry::SphereGeometry::create(MinkoTests::context(), 20, 20);
+	auto assetLibrary		= file::AssetLibrary::create(MinkoTests::context());
+	auto geometryWriter		= file::GeometryWriter::create();
+	auto outputAssetLibrary = file::AssetLibrary::create(MinkoTests::context());
+	auto geometryParser		= file::GeometryParser::create();
+	auto indices			= sphereGeometry->indices()->data();
+	auto vertices			= sphereGeometry->vertexBuffers().front()->data();
+	std::string	filename	= "asset.tmp";
+
+	assetLibrary->geometry("Sphere", sphereGeometry);
+	geometryWriter->data(sphereGeometry);
+	geometryWriter->write(filename, assetLibrary, file::Options::create(MinkoTests::context())->optimizeGeometry(true));
+
+	// only the written copy is optimized
+	ASSERT_EQ(sphereGeometry->indices()->data(), indices);
+	ASSERT_EQ(sphereGeometry->vertexBuffers().front()->data(), vertices);
+
+	std::vector<unsigned char>  data;
+	auto						flags = std::ios::in | std::ios::ate | std::ios::binary;
+	std::fstream				file(filename, flags);
+	unsigned int				size = (unsigned int)file.tellg();
+
+	data.resize(size);
+	file.seekg(0, std::ios::beg);
+	file.read((char*)&data[0], size);
+	file.close();
+
+	geometryParser->parse(filename, filename, file::Options::create(MinkoTests::context()), data, outputAssetLibrary);
+
+	auto optimized = outputAssetLibrary->geometry("Sphere");
+
+	ASSERT_TRUE(optimized != nullptr);
+	ASSERT_EQ(optimized->indices()->data().size(), indices.size());
+	ASSERT_LE(optimized->averageCacheMissRatio(), sphereGeometry->averageCacheMissRatio());
+}
+
+TEST_F(GeometrySerializerTest, LevelsOfDetailSerialization)
+{
+	auto sphereGeometry		= geometry::SphereGeometry::create(MinkoTests::context(), 20, 20);
+	auto levels				= geometry::MeshSimplifier::create()->simplifyChain(sphereGeometry, 2);
+	auto assetLibrary		= file::AssetLibrary::create(MinkoTests::context());
+	auto geometryWriter		= file::GeometryWriter::create();
+	auto outputAssetLibrary = file::AssetLibrary::create(MinkoTests::context());
+	auto geometryParser		= file::GeometryParser::create();
+	std::string	filename	= "asset.tmp";
+
+	ASSERT_EQ(levels.size(), 2u);
+
+	assetLibrary->geometry("Sphere", sphereGeometry);
+	for (uint level = 0; level < levels.size(); ++level)
+		assetLibrary->geometry(file::GeometryWriter::levelOfDetailName("Sphere", level + 1), levels[level]);
+	geometryWriter->data(sphereGeometry);
+	geometryWriter->write(filename, assetLibrary, file::Options::create(MinkoTests::context()));
+
+	std::vector<unsigned char>  data;
+	auto						flags = std::ios::in | std::ios::ate | std::ios::binary;
+	std::fstream				file(filename, flags);
+	unsigned int				size = (unsigned int)file.tellg();
+
+	data.resize(size);
+	file.seekg(0, std::ios::beg);
+	file.read((char*)&data[0], size);
+	file.close();
+
+	geometryParser->parse(filename, filename, file::Options::create(MinkoTests::context()), data, outputAssetLibrary);
+
+	auto outputGeometry = outputAssetLibrary->geometry("Sphere");
+
+	ASSERT_TRUE(outputGeometry != nullptr);
+	ASSERT_TRUE(sphereGeometry->equals(outputGeometry));
+	for (uint level = 0; level < levels.size(); ++level)
+	{
+		auto outputLevel = outputAssetLibrary->geometry(file::GeometryWriter::levelOfDetailName("Sphere", level + 1));
+
+		ASSERT_TRUE(outputLevel != nullptr);
+		ASSERT_EQ(outputLevel->indices()->data(), levels[level]->indices()->data());
+		ASSERT_EQ(outputLevel->vertexBuffers(), outputGeometry->vertexBuffers());
+	}
+}
+
+TEST_F(GeometrySerializerTest, RawVectorSerialization)
+{
+	std::vector<float>			floats	= { 0.f, 1.5f, -2.25f, 1e+10f };
+	std::vector<unsigned short>	shorts	= { 0, 42, 255 };
+	std::vector<float>			outputFloats;
+	std::vector<unsigned short>	outputShorts;
+
+	auto serializedFloats	= TypeSerializer::serializeRawVector<float>(floats);
+	auto serializedShorts	= TypeSerializer::serializeRawVector<unsigned short, unsigned char>(shorts);
+
+	ASSERT_EQ(serializedFloats.size(), TypeSerializer::RAW_VECTOR_HEADER_SIZE + floats.size() * sizeof(float));
+	ASSERT_EQ(serializedShorts.size(), TypeSerializer::RAW_VECTOR_HEADER_SIZE + shorts.size());
+	// little-endian header: number of elements, then element size
+	ASSERT_EQ(serializedShorts[0], 3);
+	ASSERT_EQ(serializedShorts[4], 1);
+
+	TypeDeserializer::deserializeRawVector<float>(serializedFloats.data(), serializedFloats.size(), outputFloats);
+	TypeDeserializer::deserializeRawVector<unsigned short, unsigned char>(serializedShorts.data(), serializedShorts.size(), outputShorts);
+
+	ASSERT_EQ(outputFloats, floats);
+	ASSERT_EQ(outputShorts, shorts);
+
+	// truncated data and mismatching element sizes are rejected
+	ASSERT_THROW(
+		TypeDeserializer::deserializeRawVector<float>(serializedFloats.data(), serializedFloats.size() - 1, outputFloats),
+		std::invalid_argument
+	);
+	ASSERT_THROW(
+		TypeDeserializer::deserializeRawVector<unsigned short>(serializedShorts.data(), serializedShorts.size(), outputShorts),
+		std::invalid_argument
+	);
+}
+
+TEST_F(GeometrySerializerTest, RawStreamsSerialization)
+{
+	auto sphereGeometry		= geometry::SphereGeometry::create(MinkoTests::context(), 40, 40);
+	auto assetLibrary		= file::AssetLibrary::create(MinkoTests::context());
+	auto geometryWriter		= file::GeometryWriter::create();
+	auto outputAssetLibrary = file::AssetLibrary::create(MinkoTests::context());
+	auto geometryParser		= file::GeometryParser::create();
+	std::string	filename	= "asset.tmp";
+
+	assetLibrary->geometry("Sphere", sphereGeometry);
+	geometryWriter->data(sphereGeometry);
+	geometryWriter->write(filename, assetLibrary, file::Options::create(MinkoTests::context()));
+
+	std::vector<unsigned char>  data;
+	auto						flags = std::ios::in | std::ios::ate | std::ios::binary;
+	std::fstream				file(filename, flags);
+	unsigned int				size = (unsigned int)file.tellg();
+
+	data.resize(size);
+	file.seekg(0, std::ios::beg);
+	file.read((char*)&data[0], size);
+	file.close();
+
+	geometryParser->parse(filename, filename, file::Options::create(MinkoTests::context()), data, outputAssetLibrary);
+
+	auto outputGeometry = outputAssetLibrary->geometry("Sphere");
+
+	ASSERT_TRUE(outputGeometry != nullptr);
+	ASSERT_EQ(outputGeometry->indices()->data(), sphereGeometry->indices()->data());
+	ASSERT_EQ(outputGeometry->vertexBuffers().size(), sphereGeometry->vertexBuffers().size());
+
+	auto outputVertexBufferIt = outputGeometry->vertexBuffers().begin();
+
+	for (auto vertexBuffer : sphereGeometry->vertexBuffers())
+	{
+		auto outputVertexBuffer = *outputVertexBufferIt++;
+
+		ASSERT_EQ(outputVertexBuffer->data(), vertexBuffer->data());
+		ASSERT_EQ(outputVertexBuffer->vertexSize(), vertexBuffer->vertexSize());
+		ASSERT_EQ(outputVertexBuffer->attributes().size(), vertexBuffer->attributes().size());
+	}
+}
+
+TEST_F(GeometrySerializerTest, LegacyStreamsParsing)
+{
+	auto cubeGeometry		= geometry::CubeGeometry::create(MinkoTests::context());
+	auto outputAssetLibrary = file::AssetLibrary::create(MinkoTests::context());
+	auto geometryParser		= file::GeometryParser::create();
+
+	// geometry chunk written by the element-wise serializer, without the raw streams meta bit
+	std::vector<std::string> serializedVertexBuffers;
+
+	for (auto vertexBuffer : cubeGeometry->vertexBuffers())
+	{
+		std::vector<msgpack::type::tuple<std::string, unsigned char, unsigned char>> attributes;
+
+		for (auto attribute : vertexBuffer->attributes())
+			attributes.push_back(msgpack::type::tuple<std::string, unsigned char, unsigned char>(
+				std::get<0>(*attribute), std::get<1>(*attribute), std::get<2>(*attribute)
+			));
+
+		msgpack::type::tuple<std::string, std::vector<msgpack::type::tuple<std::string, unsigned char, unsigned char>>> res(
+			TypeSerializer::serializeVector<float>(vertexBuffer->data()),
+			attributes
+		);
+		std::stringstream sbuf;
+
+		msgpack::pack(sbuf, res);
+		serializedVertexBuffers.push_back(sbuf.str());
+	}
+
+	msgpack::type::tuple<unsigned char, std::string, std::string, std::vector<std::string>> serializedGeometry(
+		0, "cube", TypeSerializer::serializeVector<unsigned short>(cubeGeometry->indices()->data()), serializedVertexBuffers
+	);
+	std::stringstream geometryBuffer;
+
+	msgpack::pack(geometryBuffer, serializedGeometry);
+
+	msgpack::type::tuple<std::vector<file::AbstractSerializerParser::SerializedAsset>, std::string> serializedFile(
+		std::vector<file::AbstractSerializerParser::SerializedAsset>(), geometryBuffer.str()
+	);
+	std::stringstream fileBuffer;
+
+	msgpack::pack(fileBuffer, serializedFile);
+
+	const std::string			str		= fileBuffer.str();
+	std::vector<unsigned char>	data(str.begin(), str.end());
+	std::string					filename = "asset.tmp";
+
+	geometryParser->parse(filename, filename, file::Options::create(MinkoTests::context()), data, outputAssetLibrary);
+
+	auto outputGeometry = outputAssetLibrary->geometry("cube");
+
+	ASSERT_TRUE(outputGeometry != nullptr);
+	ASSERT_EQ(outputGeometry->indices()->data(), cubeGeometry->indices()->data());
+	ASSERT_EQ(outputGeometry->vertexBuffers().front()->data(), cubeGeometry->vertexBuffers().front()->data());
+}
+
+TEST_F(GeometrySerializerTest, DeltaVectorSerialization)
+{
+	std::vector<unsigned short> indices = { 0, 1, 2, 65535, 0, 300, 299, 65534, 65535 };
+	std::vector<unsigned short> outputIndices;
+
+	auto serializedIndices = TypeSerializer::serializeDeltaVector(indices);
+
+	TypeDeserializer::deserializeDeltaVector(serializedIndices.data(), serializedIndices.size(), outputIndices);
+
+	ASSERT_EQ(outputIndices, indices);
+	ASSERT_THROW(
+		TypeDeserializer::deserializeDeltaVector(serializedIndices.data(), serializedIndices.size() - 1, outputIndices),
+		std::invalid_argument
+	);
+}
+
+TEST_F(GeometrySerializerTest, EncodedAttributesSerialization)
+{
+	typedef file::AttributeEncoding AttributeEncoding;
+
+	auto			sphereGeometry	= geometry::SphereGeometry::create(MinkoTests::context(), 40, 40);
+	unsigned int	rawSize			= 0;
+	unsigned int	encodedSize		= 0;
+
+	writeAndParse(sphereGeometry, "Sphere", rawSize);
+
+	auto options = file::Options::create(MinkoTests::context())
+		->attributeEncoding("position", AttributeEncoding::QUANTIZED)
+		->attributeEncoding("normal", AttributeEncoding::OCTAHEDRAL)
+		->attributeEncoding("uv", AttributeEncoding::HALF_FLOAT);
+
+	auto outputGeometry = writeAndParse(sphereGeometry, "Sphere", encodedSize, options)->geometry("Sphere");
+
+	ASSERT_TRUE(outputGeometry != nullptr);
+	ASSERT_EQ(outputGeometry->indices()->data(), sphereGeometry->indices()->data());
+	ASSERT_EQ(outputGeometry->numVertices(), sphereGeometry->numVertices());
+	ASSERT_EQ(outputGeometry->vertexSize(), sphereGeometry->vertexSize());
+	ASSERT_LT(encodedSize, rawSize * 2 / 3);
+
+	// the sphere fits in [-.5, .5]^3
+	ASSERT_LE(maxAttributeError(sphereGeometry, outputGeometry, "position"), 1.f / 65535.f);
+	ASSERT_LE(maxAttributeError(sphereGeometry, outputGeometry, "normal"), 1e-3f);
+	ASSERT_LE(maxAttributeError(sphereGeometry, outputGeometry, "uv"), 1e-3f);
+
+	// the encodings only apply to the writes given these options
+	unsigned int defaultSize = 0;
+
+	writeAndParse(sphereGeometry, "Sphere", defaultSize);
+
+	ASSERT_EQ(defaultSize, rawSize);
+}
+
+TEST_F(GeometrySerializerTest, CompressedIndicesSerialization)
+{
+	auto			sphereGeometry	= geometry::SphereGeometry::create(MinkoTests::context(), 40, 40);
+	unsigned int	rawSize			= 0;
+	unsigned int	compressedSize	= 0;
+
+	writeAndParse(sphereGeometry, "Sphere", rawSize);
+
+	auto options		= file::Options::create(MinkoTests::context())->compressIndices(true);
+	auto outputGeometry	= writeAndParse(sphereGeometry, "Sphere", compressedSize, options)->geometry("Sphere");
+
+	ASSERT_TRUE(outputGeometry != nullptr);
+	ASSERT_EQ(outputGeometry->indices()->data(), sphereGeometry->indices()->data());
+	ASSERT_EQ(outputGeometry->vertexBuffers().front()->data(), sphereGeometry->vertexBuffers().front()->data());
+	ASSERT_LT(compressedSize, rawSize);
+}
+
+TEST_F(GeometrySerializerTest, ParallelDependenciesParsing)
+{
+	typedef file::AbstractSerializerParser::SerializedAsset	SerializedAsset;
+	typedef file::SceneParser::SerializedNode				SerializedNode;
+
+	auto									assetLibrary	= file::AssetLibrary::create(MinkoTests::context());
+	auto									geometryWriter	= file::GeometryWriter::create();
+	std::vector<geometry::Geometry::Ptr>	geometries;
+	std::vector<SerializedAsset>			assets;
+
+	for (uint i = 0; i < 6; ++i)
+	{
+		auto		geometry	= geometry::SphereGeometry::create(MinkoTests::context(), 8 + i, 8 + i);
+		std::string	filename	= "sphere_" + std::to_string(i) + ".tmp";
+
+		assetLibrary->geometry("Sphere" + std::to_string(i), geometry);
+		geometryWriter->data(geometry);
+		geometryWriter->write(filename, assetLibrary, file::Options::create(MinkoTests::context()));
+
+		geometries.push_back(geometry);
+		assets.push_back(SerializedAsset(serialize::AssetType::GEOMETRY_ASSET, i, filename));
+	}
+
+	// a scene made of a single node that only lists the geometries as dependencies
+	std::stringstream sceneBuffer;
+	std::stringstream buffer;
+
+	msgpack::pack(sceneBuffer, msgpack::type::tuple<std::vector<std::string>, std::vector<SerializedNode>>(
+		std::vector<std::string>(), std::vector<SerializedNode>(1, SerializedNode("root", 0, 0, std::vector<uint>()))
+	));
+	msgpack::pack(buffer, msgpack::type::tuple<std::vector<SerializedAsset>, std::string>(assets, sceneBuffer.str()));
+
+	const auto					str		= buffer.str();
+	std::vector<unsigned char>	data(str.begin(), str.end());
+
+	for (uint numJobs : { 1u, 4u })
+	{
+		auto outputAssetLibrary = file::AssetLibrary::create(MinkoTests::context());
+
+		file::SceneParser::create()->parse("scene", "./scene", file::Options::create(MinkoTests::context())->numParsingJobs(numJobs), data, outputAssetLibrary);
+
+		ASSERT_TRUE(outputAssetLibrary->symbol("scene") != nullptr);
+		for (uint i = 0; i < geometries.size(); ++i)
+		{
+			auto outputGeometry = outputAssetLibrary->geometry("Sphere" + std::to_string(i));
+
+			ASSERT_TRUE(outputGeometry != nullptr);
+			ASSERT_TRUE(outputGeometry->indices()->isReady());
+			ASSERT_EQ(outputGeometry->indices()->data(), geometries[i]->indices()->data());
+			ASSERT_EQ(outputGeometry->vertexBuffers().front()->data(), geometries[i]->vertexBuffers().front()->data());
+		}
+	}
+
+	ASSERT_THROW(file::Options::create(MinkoTests::context())->numParsingJobs(0), std::invalid_argument);
+}
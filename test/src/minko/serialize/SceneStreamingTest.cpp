@@ -0,0 +1,200 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/serialize/SceneStreamingTest.hpp"
+#include "minko/component/SceneStreaming.hpp"
+#include "minko/file/SceneWriter.hpp"
+#include "minko/MinkoTests.hpp"
+
+#include <fstream>
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::math;
+using namespace minko::serialize;
+
+namespace
+{
+	scene::Node::Ptr
+	createNode(const std::string& name, float x, float y, float z)
+	{
+		return scene::Node::create(name)
+			->addComponent(Transform::create(Matrix4x4::create()->appendTranslation(x, y, z)));
+	}
+
+	bool
+	hasNode(scene::Node::Ptr root, const std::string& name)
+	{
+		auto nodes = scene::NodeSet::create(root)
+			->descendants(false)
+			->where([&](scene::Node::Ptr node) { return node->name() == name; });
+
+		return !nodes->nodes().empty();
+	}
+
+	void
+	nextFrames(SceneManager::Ptr sceneManager, uint numFrames)
+	{
+		for (uint i = 0; i < numFrames; ++i)
+			sceneManager->nextFrame(0.f, 0.f);
+	}
+
+	// writes one chunk containing a single node and returns its manifest entry
+	SceneStreaming::SerializedChunk
+	writeChunk(const std::string& name, float x, uint size)
+	{
+		auto		root		= scene::Node::create("chunk")->addChild(createNode(name, x, 0.f, 0.f));
+		auto		writer		= file::SceneWriter::create();
+		std::string	filename	= name + ".scene";
+
+		writer->data(root);
+		writer->write(filename, file::AssetLibrary::create(MinkoTests::context()), file::Options::create(MinkoTests::context()));
+
+		return SceneStreaming::SerializedChunk(filename, std::vector<float>{ x, 0.f, 0.f, x, 0.f, 0.f }, size);
+	}
+}
+
+TEST_F(SceneStreamingTest, WriteChunks)
+{
+	auto root	= scene::Node::create("root");
+	auto writer	= file::SceneWriter::create();
+
+	root
+		->addChild(createNode("a", 1.f, 0.f, 1.f))
+		->addChild(createNode("b", 2.f, 3.f, 4.f))
+		->addChild(createNode("c", 25.f, 0.f, 0.f))
+		->addChild(scene::Node::create("persistent"));
+
+	writer->data(root);
+	writer->writeChunks("chunks.tmp", file::AssetLibrary::create(MinkoTests::context()), file::Options::create(MinkoTests::context()), 10.f);
+
+	auto streaming = SceneStreaming::create("chunks.tmp", file::Options::create(MinkoTests::context()), nullptr, 10.f);
+
+	ASSERT_EQ(streaming->numChunks(), 3u);
+	ASSERT_TRUE(streaming->chunkBounds(0).empty());
+	ASSERT_EQ(streaming->chunkBounds(1), std::vector<float>({ 1.f, 0.f, 1.f, 2.f, 3.f, 4.f }));
+	ASSERT_EQ(streaming->chunkBounds(2), std::vector<float>({ 25.f, 0.f, 0.f, 25.f, 0.f, 0.f }));
+	ASSERT_EQ(root->children().size(), 4u);
+	ASSERT_THROW(writer->writeChunks("chunks.tmp", nullptr, nullptr, 0.f), std::invalid_argument);
+}
+
+TEST_F(SceneStreamingTest, StreamChunksAroundCamera)
+{
+	auto root	= scene::Node::create("root");
+	auto writer	= file::SceneWriter::create();
+
+	root
+		->addChild(createNode("a", 1.f, 0.f, 0.f))
+		->addChild(createNode("b", 2.f, 0.f, 0.f))
+		->addChild(createNode("c", 25.f, 0.f, 0.f))
+		->addChild(scene::Node::create("persistent"));
+
+	writer->data(root);
+	writer->writeChunks("chunks.tmp", file::AssetLibrary::create(MinkoTests::context()), file::Options::create(MinkoTests::context()), 10.f);
+
+	auto sceneManager	= SceneManager::create(MinkoTests::context());
+	auto scene			= scene::Node::create("scene")->addComponent(sceneManager);
+	auto camera			= createNode("camera", 0.f, 0.f, 0.f);
+	auto streamed		= scene::Node::create("streamed");
+	auto streaming		= SceneStreaming::create("chunks.tmp", file::Options::create(MinkoTests::context()), camera, 5.f);
+	auto numLoaded		= 0;
+	auto numUnloaded	= 0;
+	auto loadedSlot		= streaming->chunkLoaded()->connect([&](SceneStreaming::Ptr, uint) { ++numLoaded; });
+	auto unloadedSlot	= streaming->chunkUnloaded()->connect([&](SceneStreaming::Ptr, uint) { ++numUnloaded; });
+
+	streaming->nodesPerStep(1);
+	scene->addChild(camera)->addChild(streamed);
+	streamed->addComponent(streaming);
+	ASSERT_TRUE(streamed->hasComponent<JobManager>());
+
+	nextFrames(sceneManager, 10);
+
+	ASSERT_EQ(numLoaded, 2);
+	ASSERT_EQ(streaming->numLoadedChunks(), 2u);
+	ASSERT_TRUE(streaming->loaded(0));
+	ASSERT_TRUE(streaming->loaded(1));
+	ASSERT_FALSE(streaming->loaded(2));
+	ASSERT_TRUE(hasNode(streamed, "a"));
+	ASSERT_TRUE(hasNode(streamed, "b"));
+	ASSERT_TRUE(hasNode(streamed, "persistent"));
+	ASSERT_FALSE(hasNode(streamed, "c"));
+
+	camera->component<Transform>()->matrix()->appendTranslation(24.f, 0.f, 0.f);
+	nextFrames(sceneManager, 10);
+
+	ASSERT_EQ(numUnloaded, 1);
+	ASSERT_TRUE(streaming->loaded(0));
+	ASSERT_FALSE(streaming->loaded(1));
+	ASSERT_TRUE(streaming->loaded(2));
+	ASSERT_FALSE(hasNode(streamed, "a"));
+	ASSERT_TRUE(hasNode(streamed, "c"));
+
+	// chunks are looked up in the space of the target
+	streamed->addComponent(Transform::create(Matrix4x4::create()->appendTranslation(24.f, 0.f, 0.f)));
+	nextFrames(sceneManager, 10);
+
+	ASSERT_TRUE(streaming->loaded(1));
+	ASSERT_FALSE(streaming->loaded(2));
+
+	streamed->removeComponent(streaming);
+
+	ASSERT_EQ(streaming->numLoadedChunks(), 0u);
+	ASSERT_TRUE(streamed->children().empty());
+	ASSERT_FALSE(streamed->hasComponent<JobManager>());
+}
+
+TEST_F(SceneStreamingTest, MemoryBudget)
+{
+	std::vector<SceneStreaming::SerializedChunk> manifest = {
+		writeChunk("near", 1.f, 100),
+		writeChunk("far", 8.f, 100)
+	};
+
+	std::stringstream	sbuf;
+	std::ofstream		file("chunks.tmp", std::ios::out | std::ios::binary | std::ios::trunc);
+
+	msgpack::pack(sbuf, msgpack::type::tuple<std::vector<SceneStreaming::SerializedChunk>>(manifest));
+	file.write(sbuf.str().c_str(), sbuf.str().size());
+	file.close();
+
+	auto sceneManager	= SceneManager::create(MinkoTests::context());
+	auto scene			= scene::Node::create("scene")->addComponent(sceneManager);
+	auto camera			= createNode("camera", 0.f, 0.f, 0.f);
+	auto streamed		= scene::Node::create("streamed");
+	auto streaming		= SceneStreaming::create("chunks.tmp", file::Options::create(MinkoTests::context()), camera, 20.f, 150);
+
+	scene->addChild(camera)->addChild(streamed);
+	streamed->addComponent(streaming);
+	nextFrames(sceneManager, 10);
+
+	ASSERT_TRUE(streaming->loaded(0));
+	ASSERT_FALSE(streaming->loaded(1));
+	ASSERT_EQ(streaming->memorySize(), 100u);
+
+	// the nearest chunk takes the place of the farthest one
+	camera->component<Transform>()->matrix()->appendTranslation(9.f, 0.f, 0.f);
+	nextFrames(sceneManager, 10);
+
+	ASSERT_FALSE(streaming->loaded(0));
+	ASSERT_TRUE(streaming->loaded(1));
+	ASSERT_TRUE(hasNode(streamed, "far"));
+	ASSERT_FALSE(hasNode(streamed, "near"));
+	ASSERT_EQ(streaming->memorySize(), 100u);
+}
@@ -0,0 +1,63 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/serialize/TextureSerializerTest.hpp"
+#include "minko/MinkoTests.hpp"
+#include "minko/file/Dependency.hpp"
+
+using namespace minko;
+using namespace minko::serialize;
+
+TEST_F(TextureSerializerTest, WriteCompressedTexture)
+{
+	auto context	= MinkoTests::context();
+	auto assets		= file::AssetLibrary::create(context);
+	auto options	= file::Options::create(context);
+	auto texture	= render::Texture::create(context, 16, 16, true);
+
+	std::vector<unsigned char> rgba(16 * 16 * 4, 128);
+
+	texture->data(&rgba[0]);
+	assets->texture("compressed.png", texture);
+
+	auto dependency = file::Dependency::create();
+
+	dependency->registerDependency(texture);
+	options->textureFormat(render::TextureFormat::RGB_ETC1);
+
+	auto assetTable = dependency->serialize(assets, options);
+
+	ASSERT_EQ(assetTable.size(), 1);
+	ASSERT_EQ(assetTable[0].a0, 2);
+	ASSERT_EQ(assetTable[0].a2, "compressed.ktx");
+
+	std::ifstream				file("compressed.ktx", std::ios::binary);
+	std::vector<unsigned char>	data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	render::TextureFormat					format;
+	uint									width;
+	uint									height;
+	std::vector<std::vector<unsigned char>>	levels;
+
+	ASSERT_TRUE(file::KTXParser::read(data, format, width, height, levels));
+	ASSERT_EQ(format, render::TextureFormat::RGB_ETC1);
+	ASSERT_EQ(width, 16);
+	ASSERT_EQ(levels.size(), texture->numMipLevels());
+}
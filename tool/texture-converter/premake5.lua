@@ -0,0 +1,23 @@
+PROJECT_NAME = path.getname(os.getcwd())
+
+minko.project.application("minko-tool-" .. PROJECT_NAME)
+
+	kind "ConsoleApp"
+	removeplatforms { "html5", "ios", "android" }
+
+	files {
+		"src/**.cpp",
+		"src/**.hpp"
+	}
+
+	includedirs { "src" }
+
+	-- plugins
+	minko.plugin.enable("png")
+	minko.plugin.enable("jpeg")
+
+	-- the decoders are used directly: no context is needed to convert textures
+	includedirs {
+		minko.plugin.path("png") .. "/lib/lodepng/src",
+		minko.plugin.path("jpeg") .. "/lib/jpeg-compressor/src"
+	}
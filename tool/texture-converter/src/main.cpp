@@ -0,0 +1,228 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/Minko.hpp"
+
+#include "lodepng.h"
+#include "jpgd.h"
+
+using namespace minko;
+using namespace minko::render;
+
+namespace
+{
+	void
+	printUsage()
+	{
+		std::cout << "usage: minko-tool-texture-converter [options] input.(png|jpg)..." << std::endl
+			<< "Converts images to KTX files with their full mip chain, resized to powers of 2." << std::endl
+			<< std::endl
+			<< "  -f, --format rgba|dxt1|dxt5|etc1  storage format (default: rgba)" << std::endl
+			<< "  -o, --output file.ktx             output file, only with a single input" << std::endl
+			<< "                                    (default: the input file with the .ktx extension)" << std::endl
+			<< "  -s, --max-size size               maximum width and height (default: "
+			<< AbstractTexture::MAX_SIZE << ")" << std::endl
+			<< "  --no-mipmaps                      only write the first level" << std::endl;
+	}
+
+	std::string
+	extension(const std::string& filename)
+	{
+		auto ext = filename.substr(filename.find_last_of('.') + 1);
+
+		std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+		return ext;
+	}
+
+	void
+	decode(const std::string&				filename,
+		   std::vector<unsigned char>&		rgba,
+		   uint&							width,
+		   uint&							height)
+	{
+		std::ifstream				file(filename, std::ios::binary);
+		std::vector<unsigned char>	data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		if (!file.is_open() || data.empty())
+			throw std::runtime_error("cannot read file " + filename);
+
+		const auto ext = extension(filename);
+
+		if (ext == "png")
+		{
+			if (lodepng::decode(rgba, width, height, &data[0], data.size()))
+				throw std::invalid_argument("file " + filename + " is not a valid PNG file");
+		}
+		else if (ext == "jpg" || ext == "jpeg")
+		{
+			int		jpegWidth;
+			int		jpegHeight;
+			int		comps;
+			auto	pixels = jpgd::decompress_jpeg_image_from_memory(
+				&data[0], data.size(), &jpegWidth, &jpegHeight, &comps, 4
+			);
+
+			if (!pixels)
+				throw std::invalid_argument("file " + filename + " is not a valid JPEG file");
+
+			width = jpegWidth;
+			height = jpegHeight;
+			rgba.assign(pixels, pixels + width * height * 4);
+			free(pixels);
+		}
+		else
+			throw std::invalid_argument("unsupported file extension: " + filename);
+	}
+
+	void
+	convert(const std::string&	input,
+			const std::string&	output,
+			TextureFormat		format,
+			uint				maxSize,
+			bool				mipMapping)
+	{
+		std::vector<unsigned char>	rgba;
+		uint						width;
+		uint						height;
+
+		decode(input, rgba, width, height);
+
+		// same dimensions as the ones AbstractTexture would pick at runtime
+		const uint widthGPU		= std::min(math::clp2(width), maxSize);
+		const uint heightGPU	= std::min(math::clp2(height), maxSize);
+
+		if (widthGPU != width || heightGPU != height)
+		{
+			std::vector<unsigned char> resized;
+
+			MipMapChain::resize(width, height, &rgba[0], widthGPU, heightGPU, resized);
+			rgba.swap(resized);
+		}
+
+		std::vector<std::vector<unsigned char>> levels;
+
+		if (mipMapping)
+			MipMapChain::build(widthGPU, heightGPU, &rgba[0], levels);
+		else
+			levels.push_back(rgba);
+
+		if (TextureCompression::isCompressed(format))
+			for (uint level = 0; level < levels.size(); ++level)
+			{
+				std::vector<unsigned char> compressed;
+
+				TextureCompression::compress(
+					format,
+					std::max(1u, widthGPU >> level),
+					std::max(1u, heightGPU >> level),
+					&levels[level][0],
+					compressed
+				);
+				levels[level].swap(compressed);
+			}
+
+		file::KTXWriter::create()->write(output, format, widthGPU, heightGPU, levels);
+
+		std::cout << input << " (" << width << "x" << height << ") -> " << output
+			<< " (" << widthGPU << "x" << heightGPU << ", " << levels.size() << " levels)" << std::endl;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<std::string>	inputs;
+	std::string					output;
+	TextureFormat				format		= TextureFormat::RGBA;
+	uint						maxSize		= AbstractTexture::MAX_SIZE;
+	bool						mipMapping	= true;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+
+		if ((arg == "-f" || arg == "--format") && i + 1 < argc)
+		{
+			const std::string value = argv[++i];
+
+			if (value == "rgba")
+				format = TextureFormat::RGBA;
+			else if (value == "dxt1")
+				format = TextureFormat::RGB_DXT1;
+			else if (value == "dxt5")
+				format = TextureFormat::RGBA_DXT5;
+			else if (value == "etc1")
+				format = TextureFormat::RGB_ETC1;
+			else
+			{
+				std::cerr << "unsupported format: " << value << std::endl;
+				return 1;
+			}
+		}
+		else if ((arg == "-o" || arg == "--output") && i + 1 < argc)
+			output = argv[++i];
+		else if ((arg == "-s" || arg == "--max-size") && i + 1 < argc)
+			maxSize = math::clp2(std::max(1, atoi(argv[++i])));
+		else if (arg == "--no-mipmaps")
+			mipMapping = false;
+		else if (arg == "-h" || arg == "--help")
+		{
+			printUsage();
+			return 0;
+		}
+		else if (arg[0] == '-')
+		{
+			std::cerr << "unknown option: " << arg << std::endl;
+			printUsage();
+			return 1;
+		}
+		else
+			inputs.push_back(arg);
+	}
+
+	if (inputs.empty() || (!output.empty() && inputs.size() > 1))
+	{
+		printUsage();
+		return 1;
+	}
+
+	int result = 0;
+
+	for (auto& input : inputs)
+	{
+		try
+		{
+			convert(
+				input,
+				output.empty() ? input.substr(0, input.find_last_of('.')) + ".ktx" : output,
+				format,
+				maxSize,
+				mipMapping
+			);
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << input << ": " << e.what() << std::endl;
+			result = 1;
+		}
+	}
+
+	return result;
+}